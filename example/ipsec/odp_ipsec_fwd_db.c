@@ -37,6 +37,12 @@ void init_fwd_db(void)
 		exit(EXIT_FAILURE);
 	}
 	memset(fwd_db, 0, sizeof(*fwd_db));
+
+	fwd_db->lpm = odph_lpm_create("fwd_db_lpm", MAX_DB, MAX_DB);
+	if (fwd_db->lpm == ODPH_LPM_INVALID) {
+		EXAMPLE_ERR("Error: route table create failed.\n");
+		exit(EXIT_FAILURE);
+	}
 }
 
 int create_fwd_db_entry(char *input, char **if_names, int if_count)
@@ -110,7 +116,15 @@ int create_fwd_db_entry(char *input, char **if_names, int if_count)
 		return -1;
 	}
 
-	/* Add route to the list */
+	/* Add route to the list and the route table. A later route with the
+	 * same subnet replaces the earlier one in lookups. */
+	if (odph_lpm_add(fwd_db->lpm, entry->subnet.addr,
+			 __builtin_popcount(entry->subnet.mask),
+			 fwd_db->index)) {
+		printf("ERROR: route table full\n");
+		free(local);
+		return -1;
+	}
 	fwd_db->index++;
 	entry->next = fwd_db->list;
 	fwd_db->list = entry;
@@ -158,10 +172,10 @@ void dump_fwd_db(void)
 
 fwd_db_entry_t *find_fwd_db_entry(uint32_t dst_ip)
 {
-	fwd_db_entry_t *entry;
+	uint32_t idx;
 
-	for (entry = fwd_db->list; NULL != entry; entry = entry->next)
-		if (entry->subnet.addr == (dst_ip & entry->subnet.mask))
-			break;
-	return entry;
+	if (odph_lpm_lookup(fwd_db->lpm, dst_ip, &idx))
+		return NULL;
+
+	return &fwd_db->array[idx];
 }
@@ -13,6 +13,7 @@ extern "C" {
 
 #include <odp_api.h>
 #include <odp/helper/eth.h>
+#include <odp/helper/lpm.h>
 #include <odp_ipsec_misc.h>
 
 #define OIF_LEN 32
@@ -35,6 +36,7 @@ typedef struct fwd_db_entry_s {
 typedef struct fwd_db_s {
 	uint32_t          index;          /**< Next available entry */
 	fwd_db_entry_t   *list;           /**< List of active routes */
+	odph_lpm_t        lpm;            /**< Route table of array indexes */
 	fwd_db_entry_t    array[MAX_DB];  /**< Entry storage */
 } fwd_db_t;
 
@@ -81,7 +83,7 @@ void dump_fwd_db_entry(fwd_db_entry_t *entry);
 void dump_fwd_db(void);
 
 /**
- * Find a matching forwarding database entry
+ * Find the forwarding database entry with the longest matching subnet
  *
  * @param dst_ip  Destination IPv4 address
  *
@@ -16,7 +16,6 @@
 #include <odp_l3fwd_db_mv.h>
 #include <odp/helper/ip.h>
 #include <protocols/ip.h>
-#include <xxhash.h>
 
 /** Jenkins hash support.
   *
@@ -65,9 +64,9 @@ uint64_t l3fwd_calc_hash(tuple5_t *key)
 #else
 #ifdef _IPV6_ENABLED_
 	int key_size = (key->ip_protocol == ODPH_IPV4) ? IPV4_5TUPLE_KEY_SIZE : IPV6_5TUPLE_KEY_SIZE;
-	return XXH_fast32((void*)key, key_size, 0);
+	return odp_hash_xxh32(key, key_size, 0);
 #else
-	return XXH_fast32((void*)key, IPV4_5TUPLE_KEY_SIZE, 0);
+	return odp_hash_xxh32(key, IPV4_5TUPLE_KEY_SIZE, 0);
 #endif
 #endif
 }
@@ -19,9 +19,9 @@
 #include <odp/helper/ip.h>
 #include <odp/helper/udp.h>
 #include <odp/helper/tcp.h>
+#include <odp/helper/lpm.h>
 
 #include "odp_l3fwd_db_mv.h"
-#include "odp_l3fwd_lpm_mv.h"
 #include "ezxml.h"
 
 
@@ -94,6 +94,7 @@ struct {
 	odph_odpthread_t	l3fwd_workers[MAX_NB_WORKER];
 	struct thread_arg_s	worker_args[MAX_NB_WORKER];
 	odph_ethaddr_t		eth_dest_mac[MAX_NB_PKTIO];
+	odph_lpm_t		lpm;
 
 	/* forward func, hash or lpm */
 	int (*fwd_func)(odp_packet_t pkt, int sif);
@@ -152,18 +153,22 @@ static void setup_fwd_db(void)
 	app_args_t *args;
 
 	args = &global.cmd_args;
-	if (args->hash_mode)
+	if (args->hash_mode) {
 		init_fwd_hash_cache();
-	else
-		fib_tbl_init();
+	} else {
+		global.lpm = odph_lpm_create("l3fwd_lpm", MAX_DB, MAX_DB);
+		if (global.lpm == ODPH_LPM_INVALID)
+			LOG_ABORT("Error: route table create failed\n");
+	}
 
 	for (entry = fwd_db->list; NULL != entry; entry = entry->next) {
 		if_idx = entry->oif_id;
 #ifdef _DST_IP_FRWD_
 		/*LPM mode*/
-		if (!args->hash_mode)
-			fib_tbl_insert(entry->subnet.addr, if_idx,
-				       entry->subnet.depth);
+		if (!args->hash_mode &&
+		    odph_lpm_add(global.lpm, entry->subnet.addr,
+				 entry->subnet.depth, if_idx))
+			LOG_ABORT("Error: route insert failed\n");
 #endif
 		if (args->dest_mac_changed[if_idx])
 			global.eth_dest_mac[if_idx] = entry->dst_mac;
@@ -273,7 +278,7 @@ static inline int l3fwd_pkt_lpm(odp_packet_t pkt, int sif)
 {
 	odph_ipv4hdr_t *ip;
 	odph_ethhdr_t *eth;
-	int dif;
+	uint32_t dif;
 	int ret;
 
 	ip = odp_packet_l3_ptr(pkt, NULL);
@@ -281,7 +286,7 @@ static inline int l3fwd_pkt_lpm(odp_packet_t pkt, int sif)
 	eth = odp_packet_l2_ptr(pkt, NULL);
 
 	/* network byte order maybe different from host */
-	ret = fib_tbl_lookup(odp_be_to_cpu_32(ip->dst_addr), &dif);
+	ret = odph_lpm_lookup(global.lpm, odp_be_to_cpu_32(ip->dst_addr), &dif);
 	if (ret)
 		dif = sif;
 
@@ -1405,6 +1410,11 @@ int main(int argc, char **argv)
 	for (i = 0; i < MAX_NB_ROUTE; i++)
 		free(args->route_str[i]);
 
+	if (!args->hash_mode && odph_lpm_destroy(global.lpm)) {
+		printf("Error: route table destroy\n");
+		exit(EXIT_FAILURE);
+	}
+
 	if (odp_pool_destroy(pool)) {
 		printf("Error: pool destroy\n");
 		exit(EXIT_FAILURE);
@@ -32,7 +32,6 @@
 #include <odp/helper/icmp.h>
 #include <odp_packet_internal.h>
 
-#include "xxhash.h"
 
 /** @def MAX_WORKERS
  * @brief Maximum number of worker threads
@@ -507,7 +506,7 @@ static nat_entry_t* dnat_tbl_add_entry(ipv4_5tuple_t* ipv4_5tuple, uint32_t targ
 	char src_ip_str[MAX_STRING];
 	char dst_ip_str[MAX_STRING];
 
-	hash_index = XXH32((void *)ipv4_5tuple, sizeof(ipv4_5tuple_t), NAT_HASH_SEED) & (NAT_TBL_SIZE - 1);
+	hash_index = odp_hash_xxh32(ipv4_5tuple, sizeof(ipv4_5tuple_t), NAT_HASH_SEED) & (NAT_TBL_SIZE - 1);
 	for (i = 0; i < NAT_TBL_DEPTH; i++) {
 		odp_rwlock_write_lock(&gbl_args->dnat_lock);
 		entry = &gbl_args->dnat_tbl[hash_index][i];
@@ -861,7 +860,7 @@ static int do_snat(odp_packet_t pkt, nat_entry_t tbl[][NAT_TBL_DEPTH])
 			snat_ipv4.dst_port = 0;
 		}
 
-		hash_index = XXH32((void*)&snat_ipv4, sizeof(ipv4_5tuple_t), NAT_HASH_SEED) & (NAT_TBL_SIZE-1);
+		hash_index = odp_hash_xxh32(&snat_ipv4, sizeof(ipv4_5tuple_t), NAT_HASH_SEED) & (NAT_TBL_SIZE-1);
 
 		for (j = 0; j < NAT_TBL_DEPTH; j++) {
 		    odp_rwlock_write_lock(&gbl_args->snat_lock);
@@ -1051,7 +1050,7 @@ static int do_dnat(odp_packet_t pkt, nat_entry_t tbl[][NAT_TBL_DEPTH])
 			ipv4.dst_port = 0;
 		}
 
-		hash_index = XXH32((void*)&ipv4, sizeof(ipv4_5tuple_t), NAT_HASH_SEED) & (NAT_TBL_SIZE - 1);
+		hash_index = odp_hash_xxh32(&ipv4, sizeof(ipv4_5tuple_t), NAT_HASH_SEED) & (NAT_TBL_SIZE - 1);
 
 		for (j = 0; j < NAT_TBL_DEPTH; j++) {
 			if (tbl[hash_index][j].valid) {
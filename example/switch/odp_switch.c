@@ -450,7 +450,11 @@ static inline void broadcast_packet(odp_packet_t pkt, thread_args_t *thr_arg,
 		} else {
 			odp_packet_t pkt_cp;
 
-			pkt_cp = odp_packet_copy(pkt, gbl_args->pool);
+			/* Packets are not modified, other interfaces share
+			 * packet data */
+			pkt_cp = odp_packet_ref_static(pkt);
+			if (pkt_cp == ODP_PACKET_INVALID)
+				pkt_cp = odp_packet_copy(pkt, gbl_args->pool);
 			if (pkt_cp == ODP_PACKET_INVALID) {
 				printf("Error: packet copy failed\n");
 				continue;
@@ -9,6 +9,7 @@
 #define _GNU_SOURCE
 
 #include <unistd.h>
+#include <inttypes.h>
 #include <signal.h>
 #include <sys/resource.h>
 #include <execinfo.h>
@@ -236,9 +237,19 @@ static uint32_t next_rand_byte;
 
 static odp_atomic_u32_t atomic_pkts_into_tm;
 static odp_atomic_u32_t atomic_pkts_from_tm;
+static odp_atomic_u32_t atomic_pkts_sent_in_enq;
+
+/* Latency from odp_tm_enq() to the egress function, in nanoseconds */
+static odp_atomic_u64_t atomic_latency_sum;
+static odp_atomic_u64_t atomic_latency_min;
+static odp_atomic_u64_t atomic_latency_max;
 
 static uint32_t g_num_pkts_to_send = 1000;
 static uint8_t  g_print_tm_stats   = TRUE;
+static uint8_t  g_inline_enq       = FALSE;
+
+/* Set while the traffic generator is inside odp_tm_enq() */
+static __thread uint8_t in_tm_enq;
 
 static void tester_egress_fcn(odp_packet_t odp_pkt);
 
@@ -507,6 +518,7 @@ static int create_and_config_tm(void)
 	requirements.num_levels                 = 3;
 	requirements.tm_queue_shaper_needed     = true;
 	requirements.tm_queue_wred_needed       = true;
+	requirements.inline_enq_needed          = g_inline_enq;
 
 	for (level = 0; level < 3; level++) {
 		per_level = &requirements.per_level[level];
@@ -600,8 +612,21 @@ static odp_packet_t make_odp_packet(uint16_t pkt_len)
 	return odp_pkt;
 }
 
-void tester_egress_fcn(odp_packet_t odp_pkt ODP_UNUSED)
+void tester_egress_fcn(odp_packet_t odp_pkt)
 {
+	uint64_t latency;
+
+	latency = odp_time_to_ns(odp_time_diff(odp_time_local(),
+					       odp_packet_ts(odp_pkt)));
+	odp_atomic_add_u64(&atomic_latency_sum, latency);
+	odp_atomic_min_u64(&atomic_latency_min, latency);
+	odp_atomic_max_u64(&atomic_latency_max, latency);
+
+	/* With inline enqueue, pkts not delayed by the shapers egress before
+	 * odp_tm_enq() returns */
+	if (in_tm_enq)
+		odp_atomic_inc_u32(&atomic_pkts_sent_in_enq);
+
 	odp_atomic_inc_u32(&atomic_pkts_from_tm);
 }
 
@@ -635,7 +660,10 @@ static int traffic_generator(uint32_t pkts_to_send)
 		pkt       = make_odp_packet(pkt_len);
 
 		pkt_cnt++;
+		odp_packet_ts_set(pkt, odp_time_local());
+		in_tm_enq = TRUE;
 		rc = odp_tm_enq(tm_queue, pkt);
+		in_tm_enq = FALSE;
 		if (rc < 0) {
 			odp_tm_enq_errs++;
 			continue;
@@ -696,6 +724,10 @@ static int process_cmd_line_options(uint32_t argc, char *argv[])
 				g_print_tm_stats = FALSE;
 				break;
 
+			case 'i':
+				g_inline_enq = TRUE;
+				break;
+
 			default:
 				printf("Unrecognized cmd line option '%s'\n",
 				       arg);
@@ -744,6 +776,7 @@ int main(int argc, char *argv[])
 	struct sigaction signal_action;
 	struct rlimit    rlimit;
 	uint32_t pkts_into_tm, pkts_from_tm;
+	uint64_t latency_avg;
 	odp_instance_t instance;
 	int rc;
 
@@ -781,6 +814,10 @@ int main(int argc, char *argv[])
 
 	odp_atomic_init_u32(&atomic_pkts_into_tm, 0);
 	odp_atomic_init_u32(&atomic_pkts_from_tm, 0);
+	odp_atomic_init_u32(&atomic_pkts_sent_in_enq, 0);
+	odp_atomic_init_u64(&atomic_latency_sum, 0);
+	odp_atomic_init_u64(&atomic_latency_min, UINT64_MAX);
+	odp_atomic_init_u64(&atomic_latency_max, 0);
 
 	traffic_generator(g_num_pkts_to_send);
 
@@ -788,6 +825,17 @@ int main(int argc, char *argv[])
 	pkts_from_tm = odp_atomic_load_u32(&atomic_pkts_from_tm);
 	printf("pkts_into_tm=%u pkts_from_tm=%u\n", pkts_into_tm, pkts_from_tm);
 
+	if (pkts_from_tm != 0) {
+		latency_avg = odp_atomic_load_u64(&atomic_latency_sum) /
+			      pkts_from_tm;
+		printf("%s enqueue, pkts_sent_in_enq=%u latency_ns "
+		       "min=%" PRIu64 " avg=%" PRIu64 " max=%" PRIu64 "\n",
+		       g_inline_enq ? "inline" : "service thread",
+		       odp_atomic_load_u32(&atomic_pkts_sent_in_enq),
+		       odp_atomic_load_u64(&atomic_latency_min), latency_avg,
+		       odp_atomic_load_u64(&atomic_latency_max));
+	}
+
 	odp_tm_stats_print(odp_tm_test);
 	return 0;
 }
@@ -0,0 +1,679 @@
+/* Copyright (c) 2017, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:   BSD-3-Clause
+ */
+#include <stdio.h>
+#include <string.h>
+
+#include "odph_cuckootable.h"
+#include "odph_debug.h"
+#include <odp_api.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+#define    ODPH_SUCCESS	0
+#define    ODPH_FAIL	-1
+
+/** @magic word, write to the first byte of the memory block
+ *	to indicate this block is used by a cuckoo table structure
+ */
+#define    ODPH_CUCKOO_TABLE_MAGIC_WORD	0xCDCDDCDC
+
+/** @number of entries in one bucket. Signatures of a bucket are compared
+ * with one 128 bit vector operation.
+ */
+#define    CUCKOO_BUCKET_ENTRIES	8
+
+/** @max number of buckets visited when searching a cuckoo path */
+#define    CUCKOO_BFS_MAX		256
+
+/** @seed of the key hash */
+#define    CUCKOO_HASH_SEED		0xFFFFFFFF
+
+/** @key store index of an unused bucket entry. Key store entry 0 is
+ * never allocated.
+ */
+#define    CUCKOO_KEY_IDX_EMPTY		0
+
+/** @bucket: signatures and key store indexes of eight entries */
+typedef struct {
+	/** upper 16 bits of the key hash of each entry */
+	uint16_t sig[CUCKOO_BUCKET_ENTRIES];
+	/** key store index of each entry */
+	uint32_t key_idx[CUCKOO_BUCKET_ENTRIES];
+} odph_cuckoo_bucket ODP_ALIGNED_CACHE;
+
+typedef struct {
+	uint32_t magicword; /**< for check */
+	uint32_t key_size; /**< input param when create,in Bytes */
+	uint32_t value_size; /**< input param when create,in Bytes */
+	uint32_t init_cap; /**< input param when create,in Bytes */
+	/** key + value size, rounded up to 8 bytes */
+	uint32_t entry_size;
+	/** number of buckets - 1, number of buckets is a power of two */
+	uint32_t bucket_mask;
+	/** number of key store entries, valid indexes are 1 ... num_entries */
+	uint32_t num_entries;
+	/** number of indexes in free_slots */
+	uint32_t num_free;
+	/** bucket array */
+	odph_cuckoo_bucket *buckets;
+	/** key store, entry_size bytes per entry (key followed by value) */
+	uint8_t *key_store;
+	/** stack of free key store indexes */
+	uint32_t *free_slots;
+	/** serializes writers */
+	odp_spinlock_t lock;
+	/** incremented by writers before and after relocating, removing or
+	 * overwriting entries. Readers retry when the count changes
+	 * during a lookup.
+	 */
+	odp_atomic_u32_t chng_cnt;
+	char name[ODPH_TABLE_NAME_LEN]; /**< table name */
+} odph_cuckoo_table_imp;
+
+/** @node of the cuckoo path search */
+typedef struct {
+	uint32_t bkt; /**< bucket index */
+	int32_t prev; /**< parent node in the search queue, -1 for root */
+	uint32_t slot; /**< entry of the parent bucket moving to this bucket */
+} odph_cuckoo_path_node;
+
+ODP_STATIC_ASSERT(CUCKOO_BUCKET_ENTRIES == 8,
+		  "Signature compare handles eight entries");
+
+#define CUCKOO_ROUNDUP(x, align) ((((x) + (align) - 1) / (align)) * (align))
+
+static inline uint8_t *cuckoo_kv(const odph_cuckoo_table_imp *tbl,
+				 uint32_t idx)
+{
+	return tbl->key_store + (uint64_t)idx * tbl->entry_size;
+}
+
+static inline void cuckoo_bkts(const odph_cuckoo_table_imp *tbl,
+			       uint32_t hash, uint32_t *prim, uint32_t *sec,
+			       uint16_t *sig)
+{
+	*sig  = hash >> 16;
+	*prim = hash & tbl->bucket_mask;
+	/* Alternative bucket of the alternative is the primary bucket */
+	*sec  = (*prim ^ *sig) & tbl->bucket_mask;
+}
+
+/* Bit 'i' of the result is set when entry 'i' has signature 'sig' */
+static inline uint32_t bucket_sig_match(const odph_cuckoo_bucket *bkt,
+					uint16_t sig)
+{
+#if defined(__SSE2__)
+	__m128i sigs = _mm_loadu_si128((const void *)bkt->sig);
+	__m128i eq = _mm_cmpeq_epi16(sigs, _mm_set1_epi16((short)sig));
+
+	/* 16 bit compare results to one byte each, then to one bit each */
+	eq = _mm_packs_epi16(eq, _mm_setzero_si128());
+	return (uint32_t)_mm_movemask_epi8(eq);
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+	static const uint16_t bit[CUCKOO_BUCKET_ENTRIES] = {
+		1, 2, 4, 8, 16, 32, 64, 128
+	};
+	uint16x8_t eq = vceqq_u16(vld1q_u16(bkt->sig), vdupq_n_u16(sig));
+
+	return vaddvq_u16(vandq_u16(eq, vld1q_u16(bit)));
+#else
+	uint32_t match = 0;
+	int i;
+
+	for (i = 0; i < CUCKOO_BUCKET_ENTRIES; i++)
+		if (bkt->sig[i] == sig)
+			match |= 1 << i;
+
+	return match;
+#endif
+}
+
+/* Returns the entry holding 'key' among signature matches, or -1 */
+static inline int bucket_match_key(const odph_cuckoo_table_imp *tbl,
+				   const odph_cuckoo_bucket *bkt,
+				   uint32_t match, const void *key)
+{
+	while (match) {
+		int i = __builtin_ctz(match);
+		uint32_t idx = bkt->key_idx[i];
+
+		if (idx != CUCKOO_KEY_IDX_EMPTY &&
+		    memcmp(cuckoo_kv(tbl, idx), key, tbl->key_size) == 0)
+			return i;
+
+		match &= match - 1;
+	}
+
+	return -1;
+}
+
+static inline int bucket_find(const odph_cuckoo_table_imp *tbl,
+			      const odph_cuckoo_bucket *bkt, uint16_t sig,
+			      const void *key)
+{
+	return bucket_match_key(tbl, bkt, bucket_sig_match(bkt, sig), key);
+}
+
+static inline int bucket_empty_slot(const odph_cuckoo_bucket *bkt)
+{
+	int i;
+
+	for (i = 0; i < CUCKOO_BUCKET_ENTRIES; i++)
+		if (bkt->key_idx[i] == CUCKOO_KEY_IDX_EMPTY)
+			return i;
+
+	return -1;
+}
+
+static inline uint32_t cuckoo_read_begin(odph_cuckoo_table_imp *tbl)
+{
+	uint32_t cnt;
+
+	/* Odd count: a writer is modifying buckets */
+	while ((cnt = odp_atomic_load_acq_u32(&tbl->chng_cnt)) & 1)
+		odp_cpu_pause();
+
+	return cnt;
+}
+
+static inline int cuckoo_read_retry(odph_cuckoo_table_imp *tbl, uint32_t cnt)
+{
+	odp_mb_acquire();
+	return odp_atomic_load_u32(&tbl->chng_cnt) != cnt;
+}
+
+static inline void cuckoo_write_begin(odph_cuckoo_table_imp *tbl)
+{
+	odp_atomic_inc_u32(&tbl->chng_cnt);
+	odp_mb_full();
+}
+
+static inline void cuckoo_write_end(odph_cuckoo_table_imp *tbl)
+{
+	odp_atomic_store_rel_u32(&tbl->chng_cnt,
+				 odp_atomic_load_u32(&tbl->chng_cnt) + 1);
+}
+
+/* Number of key store entries fitting in 'mem' with 'num_bkt' buckets */
+static uint64_t cuckoo_num_entries(uint64_t mem, uint64_t num_bkt,
+				   uint32_t entry_size)
+{
+	uint64_t used, num;
+
+	used = CUCKOO_ROUNDUP(sizeof(odph_cuckoo_table_imp),
+			      ODP_CACHE_LINE_SIZE) +
+	       num_bkt * sizeof(odph_cuckoo_bucket) +
+	       entry_size + sizeof(uint32_t); /* reserved entry 0 */
+
+	if (used >= mem)
+		return 0;
+
+	num = (mem - used) / (entry_size + sizeof(uint32_t));
+	if (num > num_bkt * CUCKOO_BUCKET_ENTRIES)
+		num = num_bkt * CUCKOO_BUCKET_ENTRIES;
+
+	return num;
+}
+
+odph_table_t odph_cuckoo_table_create(const char *name, uint32_t capacity,
+				      uint32_t key_size,
+				      uint32_t value_size)
+{
+	odph_cuckoo_table_imp *tbl;
+	odp_shm_t shmem;
+	uint64_t mem, num_bkt, best_bkt, num, best_num;
+	uint32_t entry_size, i;
+	uint8_t *base;
+
+	if (name == NULL || strlen(name) >= ODPH_TABLE_NAME_LEN ||
+	    capacity < 1 || capacity >= 0x1000 || key_size == 0 ||
+	    value_size == 0) {
+		ODPH_DBG("create para input error!\n");
+		return NULL;
+	}
+	tbl = (odph_cuckoo_table_imp *)odp_shm_addr(odp_shm_lookup(name));
+	if (tbl != NULL) {
+		ODPH_DBG("name already exist\n");
+		return NULL;
+	}
+
+	mem = (uint64_t)capacity << 20;
+	entry_size = CUCKOO_ROUNDUP(key_size + value_size, 8);
+
+	/* Pick the number of buckets that stores the most keys. On a tie,
+	 * more buckets means a lower load factor and shorter cuckoo paths. */
+	best_bkt = 0;
+	best_num = 0;
+	for (num_bkt = 1; num_bkt <= (1ULL << 31); num_bkt <<= 1) {
+		num = cuckoo_num_entries(mem, num_bkt, entry_size);
+		if (num == 0 && best_num)
+			break;
+		if (num >= best_num) {
+			best_num = num;
+			best_bkt = num_bkt;
+		}
+	}
+
+	if (best_num == 0 || best_num >= UINT32_MAX) {
+		ODPH_DBG("capacity too small\n");
+		return NULL;
+	}
+
+	shmem = odp_shm_reserve(name, mem, ODP_CACHE_LINE_SIZE,
+				ODP_SHM_SW_ONLY);
+	if (shmem == ODP_SHM_INVALID) {
+		ODPH_DBG("shm reserve fail\n");
+		return NULL;
+	}
+	tbl = (odph_cuckoo_table_imp *)odp_shm_addr(shmem);
+	memset(tbl, 0, sizeof(odph_cuckoo_table_imp));
+
+	tbl->init_cap = mem;
+	strncpy(tbl->name, name, ODPH_TABLE_NAME_LEN - 1);
+	tbl->key_size = key_size;
+	tbl->value_size = value_size;
+	tbl->entry_size = entry_size;
+	tbl->bucket_mask = best_bkt - 1;
+	tbl->num_entries = best_num;
+
+	/* header of this mem block is the table control struct,
+	 * then the bucket array, then the key store and
+	 * the last part is the free index stack
+	 */
+	base = (uint8_t *)tbl + CUCKOO_ROUNDUP(sizeof(odph_cuckoo_table_imp),
+					       ODP_CACHE_LINE_SIZE);
+	tbl->buckets = (odph_cuckoo_bucket *)(void *)base;
+	base += best_bkt * sizeof(odph_cuckoo_bucket);
+	tbl->key_store = base;
+	base += (best_num + 1) * entry_size;
+	tbl->free_slots = (uint32_t *)(void *)base;
+
+	memset(tbl->buckets, 0, best_bkt * sizeof(odph_cuckoo_bucket));
+
+	/* Lowest indexes on top of the stack */
+	for (i = 0; i < best_num; i++)
+		tbl->free_slots[i] = best_num - i;
+	tbl->num_free = best_num;
+
+	odp_spinlock_init(&tbl->lock);
+	odp_atomic_init_u32(&tbl->chng_cnt, 0);
+
+	tbl->magicword = ODPH_CUCKOO_TABLE_MAGIC_WORD;
+	return (odph_table_t)tbl;
+}
+
+int odph_cuckoo_table_destroy(odph_table_t table)
+{
+	int ret;
+
+	if (table != NULL) {
+		odph_cuckoo_table_imp *tbl = (odph_cuckoo_table_imp *)table;
+
+		if (tbl->magicword != ODPH_CUCKOO_TABLE_MAGIC_WORD)
+			return ODPH_FAIL;
+
+		tbl->magicword = 0;
+		ret = odp_shm_free(odp_shm_lookup(tbl->name));
+		if (ret != 0) {
+			ODPH_DBG("free fail\n");
+			return ret;
+		}
+		return ODPH_SUCCESS;
+	}
+	return ODPH_FAIL;
+}
+
+odph_table_t odph_cuckoo_table_lookup(const char *name)
+{
+	odph_cuckoo_table_imp *tbl;
+
+	if (name == NULL || strlen(name) >= ODPH_TABLE_NAME_LEN)
+		return NULL;
+
+	tbl = (odph_cuckoo_table_imp *)odp_shm_addr(odp_shm_lookup(name));
+	if (tbl != NULL && tbl->magicword == ODPH_CUCKOO_TABLE_MAGIC_WORD &&
+	    strcmp(tbl->name, name) == 0)
+		return (odph_table_t)tbl;
+	return NULL;
+}
+
+static inline void cuckoo_move(odph_cuckoo_table_imp *tbl,
+			       uint32_t src_bkt, uint32_t src,
+			       uint32_t dst_bkt, uint32_t dst)
+{
+	odph_cuckoo_bucket *s = &tbl->buckets[src_bkt];
+	odph_cuckoo_bucket *d = &tbl->buckets[dst_bkt];
+
+	d->sig[dst] = s->sig[src];
+	d->key_idx[dst] = s->key_idx[src];
+	s->key_idx[src] = CUCKOO_KEY_IDX_EMPTY;
+}
+
+/**
+ * Free an entry in bucket 'prim' or 'sec'
+ *
+ * Breadth first search for a chain of entries, starting from the two
+ * buckets, where each entry can move to its alternative bucket and the
+ * last alternative bucket has a free entry. Entries are then shifted along
+ * the chain, starting from its end. Must be called between
+ * cuckoo_write_begin() and cuckoo_write_end().
+ */
+static int cuckoo_make_space(odph_cuckoo_table_imp *tbl, uint32_t prim,
+			     uint32_t sec, uint32_t *bkt_out,
+			     uint32_t *slot_out)
+{
+	odph_cuckoo_path_node queue[CUCKOO_BFS_MAX];
+	int head = 0, tail = 0;
+
+	queue[tail].bkt = prim;
+	queue[tail].prev = -1;
+	queue[tail++].slot = 0;
+	if (sec != prim) {
+		queue[tail].bkt = sec;
+		queue[tail].prev = -1;
+		queue[tail++].slot = 0;
+	}
+
+	for (; head < tail; head++) {
+		const odph_cuckoo_path_node *node = &queue[head];
+		const odph_cuckoo_bucket *bkt = &tbl->buckets[node->bkt];
+		uint32_t i;
+
+		for (i = 0; i < CUCKOO_BUCKET_ENTRIES; i++) {
+			uint32_t alt = (node->bkt ^ bkt->sig[i]) &
+				       tbl->bucket_mask;
+			uint32_t dst_bkt, dst, src;
+			int free_slot, n;
+
+			if (alt == node->bkt)
+				continue;
+
+			free_slot = bucket_empty_slot(&tbl->buckets[alt]);
+			if (free_slot < 0) {
+				if (tail < CUCKOO_BFS_MAX) {
+					queue[tail].bkt = alt;
+					queue[tail].prev = head;
+					queue[tail++].slot = i;
+				}
+				continue;
+			}
+
+			/* Shift entries from the end of the path */
+			dst_bkt = alt;
+			dst = free_slot;
+			src = i;
+			n = head;
+			while (1) {
+				cuckoo_move(tbl, queue[n].bkt, src, dst_bkt,
+					    dst);
+				dst_bkt = queue[n].bkt;
+				dst = src;
+				if (queue[n].prev < 0)
+					break;
+				src = queue[n].slot;
+				n = queue[n].prev;
+			}
+
+			*bkt_out = dst_bkt;
+			*slot_out = dst;
+			return 0;
+		}
+	}
+
+	return -1;
+}
+
+/* should make sure the input table exists and is available */
+int odph_cuckoo_table_put_value(odph_table_t table, void *key, void *value)
+{
+	odph_cuckoo_table_imp *tbl = (odph_cuckoo_table_imp *)table;
+	odph_cuckoo_bucket *bkt;
+	uint32_t hash, prim, sec, idx, bkt_idx, slot;
+	uint16_t sig;
+	uint8_t *kv;
+	int i, moved = 0;
+
+	if (table == NULL || key == NULL || value == NULL)
+		return ODPH_FAIL;
+
+	hash = odp_hash_crc32c(key, tbl->key_size, CUCKOO_HASH_SEED);
+	cuckoo_bkts(tbl, hash, &prim, &sec, &sig);
+
+	odp_spinlock_lock(&tbl->lock);
+
+	/* First, check if the key already exist */
+	i = bucket_find(tbl, &tbl->buckets[prim], sig, key);
+	bkt = &tbl->buckets[prim];
+	if (i < 0) {
+		i = bucket_find(tbl, &tbl->buckets[sec], sig, key);
+		bkt = &tbl->buckets[sec];
+	}
+	if (i >= 0) {
+		kv = cuckoo_kv(tbl, bkt->key_idx[i]);
+		cuckoo_write_begin(tbl);
+		memcpy(kv + tbl->key_size, value, tbl->value_size);
+		cuckoo_write_end(tbl);
+		odp_spinlock_unlock(&tbl->lock);
+		return ODPH_SUCCESS;
+	}
+
+	/* if the key is a new one, get a free entry from the key store */
+	if (tbl->num_free == 0) {
+		odp_spinlock_unlock(&tbl->lock);
+		return ODPH_FAIL;
+	}
+	idx = tbl->free_slots[--tbl->num_free];
+
+	kv = cuckoo_kv(tbl, idx);
+	memcpy(kv, key, tbl->key_size);
+	memcpy(kv + tbl->key_size, value, tbl->value_size);
+
+	/* A free bucket entry can be filled without disturbing readers */
+	bkt_idx = prim;
+	i = bucket_empty_slot(&tbl->buckets[prim]);
+	if (i < 0) {
+		bkt_idx = sec;
+		i = bucket_empty_slot(&tbl->buckets[sec]);
+	}
+	slot = i;
+
+	if (i < 0) {
+		cuckoo_write_begin(tbl);
+		moved = 1;
+		if (cuckoo_make_space(tbl, prim, sec, &bkt_idx, &slot)) {
+			cuckoo_write_end(tbl);
+			tbl->free_slots[tbl->num_free++] = idx;
+			odp_spinlock_unlock(&tbl->lock);
+			ODPH_DBG("no cuckoo path found\n");
+			return ODPH_FAIL;
+		}
+	}
+
+	bkt = &tbl->buckets[bkt_idx];
+	bkt->sig[slot] = sig;
+	/* key and signature must be visible before the index */
+	odp_mb_release();
+	bkt->key_idx[slot] = idx;
+
+	if (moved)
+		cuckoo_write_end(tbl);
+
+	odp_spinlock_unlock(&tbl->lock);
+	return ODPH_SUCCESS;
+}
+
+/* should make sure the input table exists and is available */
+int odph_cuckoo_table_get_value(odph_table_t table, void *key, void *buffer,
+				uint32_t buffer_size)
+{
+	odph_cuckoo_table_imp *tbl = (odph_cuckoo_table_imp *)table;
+	const odph_cuckoo_bucket *bkt;
+	uint32_t hash, prim, sec, cnt;
+	uint16_t sig;
+	int i, found;
+
+	if (table == NULL || key == NULL || buffer == NULL ||
+	    buffer_size < tbl->value_size)
+		return ODPH_FAIL;
+
+	hash = odp_hash_crc32c(key, tbl->key_size, CUCKOO_HASH_SEED);
+	cuckoo_bkts(tbl, hash, &prim, &sec, &sig);
+
+	do {
+		cnt = cuckoo_read_begin(tbl);
+		found = 0;
+
+		bkt = &tbl->buckets[prim];
+		i = bucket_find(tbl, bkt, sig, key);
+		if (i < 0) {
+			bkt = &tbl->buckets[sec];
+			i = bucket_find(tbl, bkt, sig, key);
+		}
+		if (i >= 0) {
+			memcpy(buffer, cuckoo_kv(tbl, bkt->key_idx[i]) +
+			       tbl->key_size, tbl->value_size);
+			found = 1;
+		}
+	} while (cuckoo_read_retry(tbl, cnt));
+
+	return found ? ODPH_SUCCESS : ODPH_FAIL;
+}
+
+int odph_cuckoo_table_get_value_bulk(odph_table_t table, void *key[],
+				     void *buffer[], uint32_t buffer_size,
+				     int num, uint64_t *hit_mask)
+{
+	odph_cuckoo_table_imp *tbl = (odph_cuckoo_table_imp *)table;
+	const void *keys[ODPH_CUCKOO_TABLE_BULK_MAX];
+	uint32_t hash[ODPH_CUCKOO_TABLE_BULK_MAX];
+	uint32_t prim[ODPH_CUCKOO_TABLE_BULK_MAX];
+	uint32_t sec[ODPH_CUCKOO_TABLE_BULK_MAX];
+	uint32_t prim_match[ODPH_CUCKOO_TABLE_BULK_MAX];
+	uint32_t sec_match[ODPH_CUCKOO_TABLE_BULK_MAX];
+	uint16_t sig[ODPH_CUCKOO_TABLE_BULK_MAX];
+	uint64_t hits;
+	uint32_t cnt;
+	int i, found;
+
+	if (table == NULL || key == NULL || buffer == NULL || num < 0 ||
+	    num > ODPH_CUCKOO_TABLE_BULK_MAX || buffer_size < tbl->value_size)
+		return ODPH_FAIL;
+
+	/* Stage 1: hash all keys and prefetch both buckets */
+	for (i = 0; i < num; i++)
+		keys[i] = key[i];
+
+	odp_hash_crc32c_multi(keys, tbl->key_size, CUCKOO_HASH_SEED, hash,
+			      num);
+
+	for (i = 0; i < num; i++) {
+		cuckoo_bkts(tbl, hash[i], &prim[i], &sec[i], &sig[i]);
+		odp_prefetch(&tbl->buckets[prim[i]]);
+		odp_prefetch(&tbl->buckets[sec[i]]);
+	}
+
+	do {
+		cnt = cuckoo_read_begin(tbl);
+		hits = 0;
+		found = 0;
+
+		/* Stage 2: compare signatures, prefetch the first
+		 * candidate key of each lookup */
+		for (i = 0; i < num; i++) {
+			const odph_cuckoo_bucket *p = &tbl->buckets[prim[i]];
+			const odph_cuckoo_bucket *s = &tbl->buckets[sec[i]];
+			uint32_t first;
+
+			prim_match[i] = bucket_sig_match(p, sig[i]);
+			sec_match[i] = bucket_sig_match(s, sig[i]);
+
+			if (prim_match[i]) {
+				first = __builtin_ctz(prim_match[i]);
+				odp_prefetch(cuckoo_kv(tbl, p->key_idx[first]));
+			} else if (sec_match[i]) {
+				first = __builtin_ctz(sec_match[i]);
+				odp_prefetch(cuckoo_kv(tbl, s->key_idx[first]));
+			}
+		}
+
+		/* Stage 3: compare keys and copy values */
+		for (i = 0; i < num; i++) {
+			const odph_cuckoo_bucket *bkt = &tbl->buckets[prim[i]];
+			int slot;
+
+			slot = bucket_match_key(tbl, bkt, prim_match[i],
+						keys[i]);
+			if (slot < 0) {
+				bkt = &tbl->buckets[sec[i]];
+				slot = bucket_match_key(tbl, bkt, sec_match[i],
+							keys[i]);
+			}
+			if (slot < 0)
+				continue;
+
+			memcpy(buffer[i], cuckoo_kv(tbl, bkt->key_idx[slot]) +
+			       tbl->key_size, tbl->value_size);
+			hits |= 1ULL << i;
+			found++;
+		}
+	} while (cuckoo_read_retry(tbl, cnt));
+
+	if (hit_mask)
+		*hit_mask = hits;
+
+	return found;
+}
+
+/* should make sure the input table exists and is available */
+int odph_cuckoo_table_remove_value(odph_table_t table, void *key)
+{
+	odph_cuckoo_table_imp *tbl = (odph_cuckoo_table_imp *)table;
+	odph_cuckoo_bucket *bkt;
+	uint32_t hash, prim, sec, idx;
+	uint16_t sig;
+	int i;
+
+	if (table == NULL || key == NULL)
+		return ODPH_FAIL;
+
+	hash = odp_hash_crc32c(key, tbl->key_size, CUCKOO_HASH_SEED);
+	cuckoo_bkts(tbl, hash, &prim, &sec, &sig);
+
+	odp_spinlock_lock(&tbl->lock);
+
+	bkt = &tbl->buckets[prim];
+	i = bucket_find(tbl, bkt, sig, key);
+	if (i < 0) {
+		bkt = &tbl->buckets[sec];
+		i = bucket_find(tbl, bkt, sig, key);
+	}
+
+	if (i >= 0) {
+		idx = bkt->key_idx[i];
+		/* readers copying the value retry before the key store
+		 * entry is reused */
+		cuckoo_write_begin(tbl);
+		bkt->key_idx[i] = CUCKOO_KEY_IDX_EMPTY;
+		cuckoo_write_end(tbl);
+		tbl->free_slots[tbl->num_free++] = idx;
+	}
+
+	odp_spinlock_unlock(&tbl->lock);
+
+	return ODPH_SUCCESS;
+}
+
+odph_table_ops_t odph_cuckoo_table_ops = {
+	odph_cuckoo_table_create,
+	odph_cuckoo_table_lookup,
+	odph_cuckoo_table_destroy,
+	odph_cuckoo_table_put_value,
+	odph_cuckoo_table_get_value,
+	odph_cuckoo_table_remove_value};
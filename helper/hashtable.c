@@ -57,6 +57,10 @@ typedef struct {
 	odph_hash_node *hash_node_pool;
 	/** number of element in the hash_node_pool */
 	uint32_t hash_node_num;
+	/** list of unused elements of hash_node_pool */
+	odph_list_head free_list;
+	/** protects free_list */
+	odp_spinlock_t free_lock;
 	char rsv[7]; /**< Reserved,for alignment */
 	char name[ODPH_TABLE_NAME_LEN]; /**< table name */
 } odph_hash_table_imp;
@@ -67,12 +71,17 @@ odph_table_t odph_hash_table_create(const char *name, uint32_t capacity,
 {
 	int i;
 	uint32_t node_num;
+	uint32_t node_size, idx;
 	odph_hash_table_imp *tbl;
 	odp_shm_t shmem;
 	uint32_t node_mem;
 
+	/* the buckets take about 1.3 MB, the rest of capacity is nodes */
 	if (strlen(name) >= ODPH_TABLE_NAME_LEN || capacity < 1 ||
-	    capacity >= 0x1000 || key_size == 0 || value_size == 0) {
+	    capacity >= 0x1000 || key_size == 0 || value_size == 0 ||
+	    (capacity << 20) <= sizeof(odph_hash_table_imp) +
+	    ODPH_MAX_BUCKET_NUM * (sizeof(odph_list_head) +
+				   sizeof(odp_rwlock_t))) {
 		ODPH_DBG("create para input error!\n");
 		return NULL;
 	}
@@ -110,11 +119,23 @@ odph_table_t odph_hash_table_create(const char *name, uint32_t capacity,
 		- ODPH_MAX_BUCKET_NUM * sizeof(odph_list_head)
 		- ODPH_MAX_BUCKET_NUM * sizeof(odp_rwlock_t);
 
-	node_num = node_mem / (sizeof(odph_hash_node) + key_size + value_size);
+	node_size = sizeof(odph_hash_node) + key_size + value_size;
+	node_num = node_mem / node_size;
 	tbl->hash_node_num = node_num;
 	tbl->hash_node_pool = (odph_hash_node *)((char *)tbl->list_head_pool
 				+ ODPH_MAX_BUCKET_NUM * sizeof(odph_list_head));
 
+	/* all elements start on the free list */
+	ODPH_INIT_LIST_HEAD(&tbl->free_list);
+	odp_spinlock_init(&tbl->free_lock);
+	for (idx = 0; idx < node_num; idx++) {
+		odph_hash_node *node;
+
+		node = (odph_hash_node *)(void *)((char *)tbl->hash_node_pool
+						  + idx * node_size);
+		odph_list_add_tail(&node->list_node, &tbl->free_list);
+	}
+
 	/* init every list head and rw lock */
 	for (i = 0; i < ODPH_MAX_BUCKET_NUM; i++) {
 		ODPH_INIT_LIST_HEAD(&tbl->list_head_pool[i]);
@@ -169,9 +190,10 @@ uint16_t odp_key_hash(void *key, uint32_t key_size)
 	register uint32_t hash = 0;
 	uint32_t idx = (key_size == 0 ? 1 : key_size);
 	uint32_t ch;
+	const char *ptr = key;
 
 	while (idx != 0) {
-		ch = (uint32_t)(*(char *)key);
+		ch = (uint32_t)(*ptr++);
 		hash = hash * 131 + ch;
 		idx--;
 	}
@@ -184,25 +206,17 @@ uint16_t odp_key_hash(void *key, uint32_t key_size)
 odph_hash_node *odp_hashnode_take(odph_table_t table)
 {
 	odph_hash_table_imp *tbl = (odph_hash_table_imp *)table;
-	uint32_t idx;
-	odph_hash_node *node;
+	odph_hash_node *node = NULL;
 
-	for (idx = 0; idx < tbl->hash_node_num; idx++) {
-		/** notice: memory of one hash_node is
-		 * not only sizeof(odph_hash_node)
-		 * should add the size of Flexible Array
-		 */
-		node = (odph_hash_node *)((char *)tbl->hash_node_pool
-				+ idx * (sizeof(odph_hash_node)
-						+ tbl->key_size
-						+ tbl->value_size));
-		if (node->list_node.next == NULL &&
-		    node->list_node.prev == NULL) {
-			ODPH_INIT_LIST_HEAD(&node->list_node);
-			return node;
-		}
+	odp_spinlock_lock(&tbl->free_lock);
+	if (!odph_list_empty(&tbl->free_list)) {
+		node = container_of(tbl->free_list.next, odph_hash_node,
+				    list_node);
+		odph_list_del(&node->list_node);
 	}
-	return NULL;
+	odp_spinlock_unlock(&tbl->free_lock);
+
+	return node;
 }
 
 /**
@@ -216,8 +230,10 @@ void odp_hashnode_give(odph_table_t table, odph_hash_node *node)
 		return;
 
 	odph_list_del(&node->list_node);
-	memset(node, 0,
-	       (sizeof(odph_hash_node) + tbl->key_size + tbl->value_size));
+
+	odp_spinlock_lock(&tbl->free_lock);
+	odph_list_add(&node->list_node, &tbl->free_list);
+	odp_spinlock_unlock(&tbl->free_lock);
 }
 
 /* should make sure the input table exists and is available */
@@ -200,6 +200,29 @@ typedef struct ODP_PACKED {
 	uint8_t    filler[6];    /**< Fill out first 8 byte segment */
 } odph_ipv6hdr_ext_t;
 
+/** IPv6 fragment header length */
+#define ODPH_IPV6HDR_FRAG_LEN 8
+
+/** @internal Returns IPv6 fragment offset in bytes */
+#define ODPH_IPV6HDR_FRAG_OFFSET(frag_off) ((frag_off) & 0xfff8)
+
+/** @internal Returns IPv6 more fragments */
+#define ODPH_IPV6HDR_FRAG_MORE(frag_off) ((frag_off) & 0x0001)
+
+/**
+ * IPv6 fragment header
+ */
+typedef struct ODP_PACKED {
+	uint8_t    next_hdr;     /**< Protocol of next header */
+	uint8_t    reserved;     /**< Reserved */
+	odp_u16be_t frag_off;    /**< Fragment offset / More fragments */
+	odp_u32be_t id;          /**< Identification */
+} odph_ipv6hdr_frag_t;
+
+/** @internal Compile time assert */
+ODP_STATIC_ASSERT(sizeof(odph_ipv6hdr_frag_t) == ODPH_IPV6HDR_FRAG_LEN,
+		  "ODPH_IPV6HDR_FRAG_T__SIZE_ERROR");
+
 /** @name
  * IP protocol values (IPv4:'proto' or IPv6:'next_hdr')
  * @{*/
@@ -211,6 +234,7 @@ typedef struct ODP_PACKED {
 #define ODPH_IPPROTO_FRAG    0x2C /**< IPv6 Fragment (44) */
 #define ODPH_IPPROTO_AH      0x33 /**< Authentication Header (51) */
 #define ODPH_IPPROTO_ESP     0x32 /**< Encapsulating Security Payload (50) */
+#define ODPH_IPPROTO_DSTOPTS 0x3C /**< IPv6 Destination options (60) */
 #define ODPH_IPPROTO_INVALID 0xFF /**< Reserved invalid by IANA */
 
 /**@}*/
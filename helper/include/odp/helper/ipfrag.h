@@ -0,0 +1,231 @@
+/* Copyright (c) 2017, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+/**
+ * @file
+ *
+ * ODP IP fragmentation and reassembly helper
+ *
+ * odph_ipfrag_fragment() splits an IPv4 or IPv6 packet into fragments that
+ * fit a target MTU. Fragment payloads are packet references to the original
+ * packet data, so only the headers of each fragment are written.
+ *
+ * Reassembly tables hold the fragments of incomplete datagrams. A table is
+ * a set associative hash of a fixed number of datagrams, each holding up to
+ * a fixed number of fragments, so memory use is bounded by the table
+ * parameters. Tables are either sharded, with a lock per shard, or lockless
+ * for use by a single thread (e.g. with flow affine input queues).
+ * Datagrams that are not completed in time are dropped. Expiry runs on
+ * lookups of the datagram's bucket, and periodically on odp_timer timeouts
+ * when the table is given a timer pool.
+ */
+
+#ifndef ODPH_IPFRAG_H_
+#define ODPH_IPFRAG_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <odp_api.h>
+
+/** @addtogroup odph_ipfrag ODPH IP FRAGMENTATION
+ *  @{
+ */
+
+/** IP fragment reassembly table handle */
+typedef struct odph_ipfrag_tbl_s *odph_ipfrag_tbl_t;
+
+/** Invalid reassembly table handle */
+#define ODPH_IPFRAG_TBL_INVALID NULL
+
+/** Maximum length of a reassembly table name, including the null character */
+#define ODPH_IPFRAG_NAME_LEN 32
+
+/** Maximum number of fragments of a datagram in a reassembly table */
+#define ODPH_IPFRAG_MAX_FRAGS 64
+
+/** Maximum length of headers (L2 and L3) of a fragment */
+#define ODPH_IPFRAG_HDR_MAX 256
+
+/** Reassembly table parameters */
+typedef struct {
+	/** Maximum number of datagrams being reassembled at the same time.
+	 *  The default value is 4096. */
+	uint32_t max_flows;
+
+	/** Maximum number of fragments of a datagram,
+	 *  1 ... ODPH_IPFRAG_MAX_FRAGS. The default value is 8. */
+	uint32_t max_frags;
+
+	/** Number of table shards, each protected by its own lock. Rounded up
+	 *  to a power of two. The default value is 16. */
+	uint32_t num_shards;
+
+	/** Table is used only by a single thread and takes no locks. Expiry
+	 *  and timeouts must then be handled by the same thread.
+	 *  The default value is false. */
+	odp_bool_t lockless;
+
+	/** Datagrams not completed in this time are dropped.
+	 *  The default value is 1 second. */
+	uint64_t timeout_ns;
+
+	/** Timer pool for periodic expiry, or ODP_TIMER_POOL_INVALID to expire
+	 *  only on lookups and odph_ipfrag_expire() calls. The default value
+	 *  is ODP_TIMER_POOL_INVALID. */
+	odp_timer_pool_t timer_pool;
+
+	/** Timeout pool for the expiry timer */
+	odp_pool_t tmo_pool;
+
+	/** Destination queue of expiry timeouts. Timeout events from
+	 *  the queue are passed to odph_ipfrag_timeout(). */
+	odp_queue_t tmo_queue;
+} odph_ipfrag_param_t;
+
+/** Reassembly table statistics */
+typedef struct {
+	uint64_t frags;       /**< Fragments passed to the table */
+	uint64_t reassembled; /**< Datagrams completed */
+	uint64_t expired;     /**< Datagrams dropped on timeout */
+	uint64_t dropped;     /**< Fragments dropped on errors or no space */
+} odph_ipfrag_stats_t;
+
+/**
+ * Fragment an IPv4 or IPv6 packet
+ *
+ * The L3 offset of the packet must point to the IP header. Each fragment
+ * carries a copy of the data in front of the L3 header (e.g. Ethernet
+ * header), an IP header and at most 'mtu' bytes from the IP header onwards.
+ * Fragment payloads reference the packet data instead of copying it, when
+ * the pool supports packet references. Fragments are allocated from the
+ * pool of the packet and have L2 and L3 offsets set.
+ *
+ * IPv4 options that are not copied on fragmentation are included only in
+ * the first fragment. Packets with the don't fragment flag set are not
+ * fragmented. IPv6 packets get a fragment header after the unfragmentable
+ * part (hop-by-hop options and routing headers).
+ *
+ * The packet is consumed on success. A packet that fits the MTU is returned
+ * as is in frag[0]. The packet is not modified on failure.
+ *
+ * @param pkt        Packet to fragment
+ * @param mtu        Maximum IP packet length of the fragments
+ * @param[out] frag  Fragments for output
+ * @param max_frags  Maximum number of fragments to output
+ *
+ * @return Number of fragments
+ * @retval <0 on failure
+ */
+int odph_ipfrag_fragment(odp_packet_t pkt, uint32_t mtu, odp_packet_t frag[],
+			 int max_frags);
+
+/**
+ * Initialize reassembly table parameters to default values
+ *
+ * @param[out] param  Parameters to initialize
+ */
+void odph_ipfrag_param_init(odph_ipfrag_param_t *param);
+
+/**
+ * Create a reassembly table
+ *
+ * The table is stored in a shared memory block with the given name.
+ *
+ * @param name   Table name
+ * @param param  Table parameters
+ *
+ * @return Table handle
+ * @retval ODPH_IPFRAG_TBL_INVALID on failure
+ */
+odph_ipfrag_tbl_t odph_ipfrag_tbl_create(const char *name,
+					 const odph_ipfrag_param_t *param);
+
+/**
+ * Find a reassembly table by name
+ *
+ * @param name  Table name
+ *
+ * @return Table handle
+ * @retval ODPH_IPFRAG_TBL_INVALID if not found
+ */
+odph_ipfrag_tbl_t odph_ipfrag_tbl_find(const char *name);
+
+/**
+ * Destroy a reassembly table
+ *
+ * Frees all held fragments and the expiry timer. Timeout events already
+ * in the timeout queue must be freed by the application without calling
+ * odph_ipfrag_timeout().
+ *
+ * @param tbl  Table handle
+ *
+ * @retval 0 on success
+ * @retval <0 on failure
+ */
+int odph_ipfrag_tbl_destroy(odph_ipfrag_tbl_t tbl);
+
+/**
+ * Reassemble IP fragments
+ *
+ * The L3 offset of the packet must point to the IP header. Packets that
+ * are not IPv4 or IPv6 fragments are left untouched. A fragment is stored
+ * in the table until all fragments of its datagram have been received.
+ * The fragment that completes a datagram is replaced by the reassembled
+ * packet, which has the L2 and first fragment headers and L3 and L4
+ * offsets set.
+ *
+ * @param tbl       Table handle
+ * @param[in,out] pkt  Packet to reassemble. Reassembled packet on return
+ *                     value 0.
+ *
+ * @retval 0  *pkt is a complete datagram
+ * @retval 1  Fragment was stored in the table
+ * @retval <0 Fragment was dropped and freed
+ */
+int odph_ipfrag_reassemble(odph_ipfrag_tbl_t tbl, odp_packet_t *pkt);
+
+/**
+ * Drop expired datagrams
+ *
+ * @param tbl  Table handle
+ *
+ * @return Number of dropped datagrams
+ */
+int odph_ipfrag_expire(odph_ipfrag_tbl_t tbl);
+
+/**
+ * Handle an expiry timeout of a reassembly table
+ *
+ * Drops expired datagrams of the table and restarts the expiry timer with
+ * the timeout event.
+ *
+ * @param ev  Timeout event from the table's timeout queue
+ *
+ * @return Number of dropped datagrams
+ * @retval <0 if the event is not a timeout of a reassembly table. The event
+ *            is not consumed.
+ */
+int odph_ipfrag_timeout(odp_event_t ev);
+
+/**
+ * Read reassembly table statistics
+ *
+ * @param tbl         Table handle
+ * @param[out] stats  Statistics for output
+ */
+void odph_ipfrag_stats(odph_ipfrag_tbl_t tbl, odph_ipfrag_stats_t *stats);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,307 @@
+/* Copyright (c) 2017, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+/**
+ * @file
+ *
+ * ODP longest prefix match helper
+ *
+ * Longest prefix match (LPM) tables for IPv4 and IPv6 routing. IPv4 tables
+ * use the DIR-24-8 layout: a route lookup reads one entry of a 2^24 entry
+ * table indexed by the upper 24 address bits, and for prefixes longer
+ * than 24 bits one more entry of a 256 entry extension group. IPv6 tables
+ * use a 2^16 entry first level followed by up to 14 levels of 256 entry
+ * groups.
+ *
+ * Lookups do not take locks and can run concurrently with route updates.
+ * Each table entry is updated with a single store, so a lookup racing with
+ * an update returns the result from either before or after the update.
+ * Updates are serialized by a per table lock.
+ *
+ * Extension groups released by an update are reused only after a grace
+ * period. Threads that look up routes while other threads update the table
+ * call odph_lpm_reader_online() first and then report quiescent states,
+ * points where they are not inside a lookup, with odph_lpm_quiescent().
+ * An update that needs a released group waits until every online reader
+ * has reported a quiescent state after the release.
+ */
+
+#ifndef ODPH_LPM_H_
+#define ODPH_LPM_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <odp_api.h>
+
+/** @addtogroup odph_lpm ODPH LPM
+ *  @{
+ */
+
+/** LPM table handle */
+typedef struct odph_lpm_s *odph_lpm_t;
+
+/** Invalid LPM table handle */
+#define ODPH_LPM_INVALID NULL
+
+/** Maximum length of an LPM table name, including the null character */
+#define ODPH_LPM_NAME_LEN 32
+
+/** Largest next hop value that can be stored in a table */
+#define ODPH_LPM_NEXT_HOP_MAX 0x3fffff
+
+/** Next hop value set by multi-lookups for addresses without a route */
+#define ODPH_LPM_NEXT_HOP_INVALID 0xffffffff
+
+/** IPv6 address length in bytes */
+#define ODPH_LPM6_ADDR_LEN 16
+
+/**
+ * Create an IPv4 LPM table
+ *
+ * The table is stored in a shared memory block with the given name.
+ *
+ * @param name       Table name
+ * @param max_rules  Maximum number of routes
+ * @param num_tbl8   Number of 256 entry groups for routes longer than
+ *                   24 bits. Each /25 ... /32 route needs a group for its
+ *                   /24, unless another route already allocated it.
+ *
+ * @return Table handle
+ * @retval ODPH_LPM_INVALID on failure
+ */
+odph_lpm_t odph_lpm_create(const char *name, uint32_t max_rules,
+			   uint32_t num_tbl8);
+
+/**
+ * Create an IPv6 LPM table
+ *
+ * @param name       Table name
+ * @param max_rules  Maximum number of routes
+ * @param num_tbl8   Number of 256 entry groups for routes longer than
+ *                   16 bits. A route needs (depth - 9) / 8 groups at most.
+ *
+ * @return Table handle
+ * @retval ODPH_LPM_INVALID on failure
+ */
+odph_lpm_t odph_lpm6_create(const char *name, uint32_t max_rules,
+			    uint32_t num_tbl8);
+
+/**
+ * Find an IPv4 or IPv6 LPM table by name
+ *
+ * @param name  Table name
+ *
+ * @return Table handle
+ * @retval ODPH_LPM_INVALID if not found
+ */
+odph_lpm_t odph_lpm_find(const char *name);
+
+/**
+ * Destroy an IPv4 or IPv6 LPM table
+ *
+ * @param lpm  Table handle
+ *
+ * @retval 0 on success
+ * @retval <0 on failure
+ */
+int odph_lpm_destroy(odph_lpm_t lpm);
+
+/**
+ * Register the calling thread as a reader of a table
+ *
+ * Updates by other threads do not reuse an extension group that the
+ * thread may still see, until the thread calls odph_lpm_quiescent() or
+ * odph_lpm_reader_offline(). An online thread must report quiescent states
+ * regularly, otherwise route updates may stall.
+ *
+ * @param lpm  Table handle
+ *
+ * @retval 0 on success
+ * @retval <0 on failure
+ */
+int odph_lpm_reader_online(odph_lpm_t lpm);
+
+/**
+ * Unregister the calling thread as a reader of a table
+ *
+ * The thread does not look up routes in the table until it calls
+ * odph_lpm_reader_online() again.
+ *
+ * @param lpm  Table handle
+ */
+void odph_lpm_reader_offline(odph_lpm_t lpm);
+
+/**
+ * Report a quiescent state of the calling thread
+ *
+ * The thread has completed all lookups it started before the call, e.g.
+ * once per received packet burst. Groups released before the call may be
+ * reused after all other online readers have done the same.
+ *
+ * @param lpm  Table handle
+ */
+void odph_lpm_quiescent(odph_lpm_t lpm);
+
+/**
+ * Add an IPv4 route
+ *
+ * Replaces the next hop of an existing route with the same prefix.
+ *
+ * @param lpm       IPv4 table handle
+ * @param ip        Route prefix in host byte order
+ * @param depth     Prefix length, 0 ... 32
+ * @param next_hop  Next hop, 0 ... ODPH_LPM_NEXT_HOP_MAX
+ *
+ * @retval 0 on success
+ * @retval <0 on failure
+ */
+int odph_lpm_add(odph_lpm_t lpm, uint32_t ip, uint8_t depth,
+		 uint32_t next_hop);
+
+/**
+ * Delete an IPv4 route
+ *
+ * @param lpm    IPv4 table handle
+ * @param ip     Route prefix in host byte order
+ * @param depth  Prefix length, 0 ... 32
+ *
+ * @retval 0 on success
+ * @retval <0 if the route was not found
+ */
+int odph_lpm_delete(odph_lpm_t lpm, uint32_t ip, uint8_t depth);
+
+/**
+ * Look up an IPv4 address
+ *
+ * @param      lpm       IPv4 table handle
+ * @param      ip        Address in host byte order
+ * @param[out] next_hop  Next hop of the longest matching route
+ *
+ * @retval 0 on success
+ * @retval <0 if no route matches
+ */
+static inline int odph_lpm_lookup(odph_lpm_t lpm, uint32_t ip,
+				  uint32_t *next_hop);
+
+/**
+ * Look up multiple IPv4 addresses
+ *
+ * First level table entries are prefetched a few addresses ahead of
+ * their use.
+ *
+ * @param      lpm       IPv4 table handle
+ * @param      ip        Addresses in host byte order
+ * @param[out] next_hop  Next hops of the longest matching routes.
+ *                       ODPH_LPM_NEXT_HOP_INVALID for addresses with no
+ *                       matching route.
+ * @param      num       Number of addresses
+ *
+ * @return Number of addresses with a matching route
+ */
+int odph_lpm_lookup_multi(odph_lpm_t lpm, const uint32_t ip[],
+			  uint32_t next_hop[], int num);
+
+/**
+ * Add an IPv6 route
+ *
+ * Replaces the next hop of an existing route with the same prefix.
+ *
+ * @param lpm       IPv6 table handle
+ * @param ip        Route prefix in network byte order
+ * @param depth     Prefix length, 0 ... 128
+ * @param next_hop  Next hop, 0 ... ODPH_LPM_NEXT_HOP_MAX
+ *
+ * @retval 0 on success
+ * @retval <0 on failure
+ */
+int odph_lpm6_add(odph_lpm_t lpm, const uint8_t ip[ODPH_LPM6_ADDR_LEN],
+		  uint8_t depth, uint32_t next_hop);
+
+/**
+ * Delete an IPv6 route
+ *
+ * @param lpm    IPv6 table handle
+ * @param ip     Route prefix in network byte order
+ * @param depth  Prefix length, 0 ... 128
+ *
+ * @retval 0 on success
+ * @retval <0 if the route was not found
+ */
+int odph_lpm6_delete(odph_lpm_t lpm, const uint8_t ip[ODPH_LPM6_ADDR_LEN],
+		     uint8_t depth);
+
+/**
+ * Look up an IPv6 address
+ *
+ * @param      lpm       IPv6 table handle
+ * @param      ip        Address in network byte order
+ * @param[out] next_hop  Next hop of the longest matching route
+ *
+ * @retval 0 on success
+ * @retval <0 if no route matches
+ */
+int odph_lpm6_lookup(odph_lpm_t lpm, const uint8_t ip[ODPH_LPM6_ADDR_LEN],
+		     uint32_t *next_hop);
+
+/**
+ * Look up multiple IPv6 addresses
+ *
+ * @param      lpm       IPv6 table handle
+ * @param      ip        Addresses in network byte order
+ * @param[out] next_hop  Next hops of the longest matching routes.
+ *                       ODPH_LPM_NEXT_HOP_INVALID for addresses with no
+ *                       matching route.
+ * @param      num       Number of addresses
+ *
+ * @return Number of addresses with a matching route
+ */
+int odph_lpm6_lookup_multi(odph_lpm_t lpm,
+			   const uint8_t ip[][ODPH_LPM6_ADDR_LEN],
+			   uint32_t next_hop[], int num);
+
+/** @internal LPM table lookup structure, used by inline functions */
+typedef struct {
+	/** @internal First level table */
+	const uint32_t *tbl;
+	/** @internal Extension groups of 256 entries */
+	const uint32_t *tbl8;
+} odph_lpm_lookup_tbl_t;
+
+/** @internal Entry holds a route. Bits 29:22 of a route entry store the
+ * prefix length of the route. */
+#define ODPH_LPM_ENTRY_VALID   0x80000000u
+/** @internal Entry points to an extension group */
+#define ODPH_LPM_ENTRY_EXT     0x40000000u
+/** @internal Next hop or extension group index bits of an entry */
+#define ODPH_LPM_ENTRY_NH_MASK 0x003fffffu
+
+static inline int odph_lpm_lookup(odph_lpm_t lpm, uint32_t ip,
+				  uint32_t *next_hop)
+{
+	const odph_lpm_lookup_tbl_t *t = (const odph_lpm_lookup_tbl_t *)lpm;
+	uint32_t e;
+
+	e = __atomic_load_n(&t->tbl[ip >> 8], __ATOMIC_ACQUIRE);
+	if (e & ODPH_LPM_ENTRY_EXT)
+		e = __atomic_load_n(&t->tbl8[((e & ODPH_LPM_ENTRY_NH_MASK)
+					      << 8) | (ip & 0xff)],
+				    __ATOMIC_RELAXED);
+
+	*next_hop = e & ODPH_LPM_ENTRY_NH_MASK;
+	return (e & ODPH_LPM_ENTRY_VALID) ? 0 : -1;
+}
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,1046 @@
+/* Copyright (c) 2017, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+#include <stddef.h>
+#include <string.h>
+
+#include <odp_api.h>
+#include <odp/helper/chksum.h>
+#include <odp/helper/ip.h>
+#include <odp/helper/ipfrag.h>
+#include "odph_debug.h"
+
+/** @magic word, write to the first word of the table header
+ *	to indicate this block is used by a reassembly table structure
+ */
+#define IPFRAG_MAGIC_WORD  0xB3B3C4C4
+
+/** Datagrams per hash bucket */
+#define IPFRAG_WAYS        4
+
+/** Expiry timer period is the datagram timeout divided by this */
+#define IPFRAG_TMO_DIV     2
+
+/** IPv4 flags */
+#define IPV4_DF            0x4000
+#define IPV4_MF            0x2000
+
+/** IPv4 options */
+#define IPV4_OPT_EOL       0
+#define IPV4_OPT_NOP       1
+#define IPV4_OPT_COPY      0x80
+
+/** Maximum IPv4 header length */
+#define IPV4_HDR_MAX       60
+
+/** Maximum number of IPv6 extension headers walked */
+#define IPV6_EXT_MAX       8
+
+#define IPFRAG_ROUNDUP(x, align) ((((x) + (align) - 1) / (align)) * (align))
+
+/** Datagram identification */
+typedef struct {
+	uint8_t  src[ODPH_IPV6ADDR_LEN]; /**< source address */
+	uint8_t  dst[ODPH_IPV6ADDR_LEN]; /**< destination address */
+	uint32_t id;                     /**< fragment identification */
+	uint8_t  proto;                  /**< IPv4 protocol, 0 for IPv6 */
+	uint8_t  ver;                    /**< IP version */
+	uint8_t  pad[2];
+} ipfrag_key_t;
+
+/** Fragment of a datagram */
+typedef struct {
+	odp_packet_t pkt;   /**< fragment packet */
+	uint32_t off;       /**< payload offset in the datagram */
+	uint32_t len;       /**< payload length */
+	uint32_t hdr_len;   /**< packet bytes in front of the payload */
+	uint32_t nh_off;    /**< IPv6: L3 offset of the next header field
+				 pointing to the fragment header */
+} ipfrag_frag_t;
+
+/** Datagram being reassembled */
+typedef struct {
+	ipfrag_key_t key;    /**< datagram identification */
+	uint64_t start_ns;   /**< arrival time of the first fragment */
+	uint32_t total_len;  /**< payload length, 0 until last fragment */
+	uint32_t recv_len;   /**< payload bytes received */
+	uint32_t num_frags;  /**< number of fragments, 0 for a free entry */
+	uint32_t pad;
+	ipfrag_frag_t frag[]; /**< fragments in arrival order */
+} ipfrag_flow_t;
+
+/** Table shard */
+typedef struct {
+	odp_spinlock_t lock ODP_ALIGNED_CACHE; /**< protects shard buckets */
+	odph_ipfrag_stats_t stats;             /**< shard statistics */
+} ipfrag_shard_t;
+
+/** Parsed fragment */
+typedef struct {
+	ipfrag_key_t key;   /**< datagram identification */
+	ipfrag_frag_t frag; /**< fragment */
+	uint32_t end;       /**< end of the IP packet in the packet */
+	uint32_t ip_hdr;    /**< header bytes counted in the length field of
+				 the reassembled datagram */
+	int more;           /**< more fragments flag */
+} ipfrag_info_t;
+
+/** IPv6 extension header chain */
+typedef struct {
+	uint32_t frag_hdr;  /**< L3 offset of fragment header, 0 if none */
+	uint32_t unfrag;    /**< length of the unfragmentable part */
+	uint32_t nh_off;    /**< L3 offset of the next header field pointing
+				 to the fragmentable part */
+} ipv6_chain_t;
+
+struct odph_ipfrag_tbl_s {
+	uint32_t magicword;         /**< for check */
+	uint32_t max_frags;         /**< input param when create */
+	uint32_t bucket_mask;       /**< number of buckets - 1 */
+	uint32_t shard_mask;        /**< number of shards - 1 */
+	uint32_t flow_size;         /**< size of a datagram entry */
+	odp_bool_t lockless;        /**< input param when create */
+	uint64_t timeout_ns;        /**< input param when create */
+	uint64_t tmo_ticks;         /**< expiry timer period */
+	odp_timer_t timer;          /**< expiry timer */
+	ipfrag_shard_t *shard;      /**< table shards */
+	uint8_t *flows;             /**< datagram entries */
+	char name[ODPH_IPFRAG_NAME_LEN]; /**< table name */
+};
+
+static __thread uint32_t ipv6_frag_id;
+
+static inline void shard_lock(odph_ipfrag_tbl_t tbl, ipfrag_shard_t *shard)
+{
+	if (!tbl->lockless)
+		odp_spinlock_lock(&shard->lock);
+}
+
+static inline void shard_unlock(odph_ipfrag_tbl_t tbl, ipfrag_shard_t *shard)
+{
+	if (!tbl->lockless)
+		odp_spinlock_unlock(&shard->lock);
+}
+
+static inline ipfrag_flow_t *flow_ptr(odph_ipfrag_tbl_t tbl, uint32_t bucket,
+				      uint32_t way)
+{
+	return (ipfrag_flow_t *)(void *)(tbl->flows + (uint64_t)tbl->flow_size *
+					 (bucket * IPFRAG_WAYS + way));
+}
+
+static inline uint64_t time_now_ns(void)
+{
+	return odp_time_to_ns(odp_time_global());
+}
+
+/* IPv4 header checksum of a header that may not be 16-bit aligned */
+static odp_u16sum_t ipv4_csum(const uint8_t *ip, uint32_t hl)
+{
+	uint16_t w[IPV4_HDR_MAX / 2];
+
+	memcpy(w, ip, hl);
+	return odph_chksum(w, hl);
+}
+
+static void ipv4_hdr_update(uint8_t *ip, uint32_t hl, uint32_t tot_len,
+			    uint16_t frag_offset)
+{
+	odph_ipv4hdr_t *ipv4 = (odph_ipv4hdr_t *)(void *)ip;
+
+	ipv4->tot_len = odp_cpu_to_be_16(tot_len);
+	ipv4->frag_offset = odp_cpu_to_be_16(frag_offset);
+	ipv4->chksum = 0;
+	ipv4->chksum = ipv4_csum(ip, hl);
+}
+
+/* Walk IPv6 extension headers up to the fragment header or the first
+ * header of the fragmentable part */
+static int ipv6_chain(odp_packet_t pkt, uint32_t l3_off,
+		      const odph_ipv6hdr_t *ip, ipv6_chain_t *chain)
+{
+	odph_ipv6hdr_ext_t ext;
+	uint32_t pos = ODPH_IPV6HDR_LEN;
+	uint32_t nh_pos = offsetof(odph_ipv6hdr_t, next_hdr);
+	uint32_t end = ODPH_IPV6HDR_LEN + odp_be_to_cpu_16(ip->payload_len);
+	uint8_t nh = ip->next_hdr;
+	int i;
+
+	chain->frag_hdr = 0;
+	chain->unfrag = ODPH_IPV6HDR_LEN;
+	chain->nh_off = nh_pos;
+
+	for (i = 0; i < IPV6_EXT_MAX; i++) {
+		if (nh == ODPH_IPPROTO_FRAG) {
+			chain->frag_hdr = pos;
+			chain->nh_off = nh_pos;
+			return 0;
+		}
+
+		if (nh != ODPH_IPPROTO_HOPOPTS && nh != ODPH_IPPROTO_ROUTE &&
+		    nh != ODPH_IPPROTO_DSTOPTS)
+			return 0;
+
+		if (pos + 2 > end ||
+		    odp_packet_copy_to_mem(pkt, l3_off + pos, 2, &ext))
+			return -1;
+
+		/* Destination options are unfragmentable only when followed
+		 * by a routing header */
+		nh_pos = pos;
+		pos += (ext.ext_len + 1) * 8;
+		if (nh != ODPH_IPPROTO_DSTOPTS) {
+			chain->unfrag = pos;
+			chain->nh_off = nh_pos;
+		}
+		nh = ext.next_hdr;
+	}
+
+	return -1;
+}
+
+/* Allocate a fragment with the given headers and payload of the packet */
+static odp_packet_t frag_alloc(odp_packet_t pkt, const uint8_t *hdr,
+			       uint32_t hdr_len, uint32_t offset, uint32_t len)
+{
+	odp_packet_t frag, ref;
+	uint32_t tail = odp_packet_len(pkt) - offset - len;
+
+	frag = odp_packet_alloc(odp_packet_pool(pkt), hdr_len);
+	if (frag == ODP_PACKET_INVALID)
+		return ODP_PACKET_INVALID;
+
+	if (odp_packet_copy_from_mem(frag, 0, hdr_len, hdr))
+		goto error;
+
+	ref = odp_packet_ref_pkt(pkt, offset, frag);
+	if (ref != ODP_PACKET_INVALID) {
+		frag = ref;
+		if (tail && odp_packet_trunc_tail(&frag, tail, NULL, NULL) < 0)
+			goto error;
+	} else {
+		/* No reference support, copy the payload */
+		if (odp_packet_extend_tail(&frag, len, NULL, NULL) < 0 ||
+		    odp_packet_copy_from_pkt(frag, hdr_len, pkt, offset, len))
+			goto error;
+	}
+
+	if (odp_packet_has_l2(pkt))
+		odp_packet_l2_offset_set(frag, odp_packet_l2_offset(pkt));
+	odp_packet_l3_offset_set(frag, odp_packet_l3_offset(pkt));
+	odp_packet_has_ipfrag_set(frag, 1);
+	return frag;
+
+error:
+	odp_packet_free(frag);
+	return ODP_PACKET_INVALID;
+}
+
+static void frag_free(odp_packet_t frag[], int num)
+{
+	if (num > 0)
+		odp_packet_free_multi(frag, num);
+}
+
+/* Copy IPv4 header options that are copied on fragmentation */
+static int ipv4_copied_opts(const uint8_t *ip, uint32_t hl, uint8_t *dst)
+{
+	uint32_t i = ODPH_IPV4HDR_LEN;
+	uint32_t len = ODPH_IPV4HDR_LEN;
+	uint32_t opt_len;
+
+	while (i < hl) {
+		if (ip[i] == IPV4_OPT_EOL)
+			break;
+		if (ip[i] == IPV4_OPT_NOP) {
+			i++;
+			continue;
+		}
+		if (i + 1 >= hl)
+			return -1;
+		opt_len = ip[i + 1];
+		if (opt_len < 2 || i + opt_len > hl)
+			return -1;
+		if (ip[i] & IPV4_OPT_COPY) {
+			memcpy(&dst[len], &ip[i], opt_len);
+			len += opt_len;
+		}
+		i += opt_len;
+	}
+
+	while (len % 4)
+		dst[len++] = IPV4_OPT_EOL;
+
+	return len;
+}
+
+static int ipv4_fragment(odp_packet_t pkt, uint32_t l3_off, uint32_t mtu,
+			 odp_packet_t frag[], int max_frags)
+{
+	uint8_t hdr[ODPH_IPFRAG_HDR_MAX];
+	uint8_t hdr2[ODPH_IPFRAG_HDR_MAX];
+	odph_ipv4hdr_t *ip = (odph_ipv4hdr_t *)(void *)&hdr[l3_off];
+	uint32_t hl, hl2, tot_len, payload, size, size2, off, len;
+	uint32_t base_off, num;
+	uint16_t fo, mf;
+	int ret, i;
+
+	if (l3_off + ODPH_IPV4HDR_LEN > ODPH_IPFRAG_HDR_MAX ||
+	    odp_packet_copy_to_mem(pkt, 0, l3_off + ODPH_IPV4HDR_LEN, hdr))
+		return -1;
+
+	hl = ODPH_IPV4HDR_IHL(ip->ver_ihl) * 4;
+	tot_len = odp_be_to_cpu_16(ip->tot_len);
+	fo = odp_be_to_cpu_16(ip->frag_offset);
+
+	if (hl < ODPH_IPV4HDR_LEN || tot_len < hl ||
+	    l3_off + tot_len > odp_packet_len(pkt))
+		return -1;
+
+	if (tot_len <= mtu) {
+		frag[0] = pkt;
+		return 1;
+	}
+
+	if ((fo & IPV4_DF) || l3_off + hl > ODPH_IPFRAG_HDR_MAX ||
+	    odp_packet_copy_to_mem(pkt, l3_off + ODPH_IPV4HDR_LEN,
+				   hl - ODPH_IPV4HDR_LEN,
+				   &hdr[l3_off + ODPH_IPV4HDR_LEN]))
+		return -1;
+
+	/* Headers of the second and later fragments */
+	memcpy(hdr2, hdr, l3_off + ODPH_IPV4HDR_LEN);
+	ret = ipv4_copied_opts(&hdr[l3_off], hl, &hdr2[l3_off]);
+	if (ret < 0)
+		return -1;
+	hl2 = ret;
+	hdr2[l3_off] = (ODPH_IPV4 << 4) | (hl2 / 4);
+
+	if (mtu < hl + 8)
+		return -1;
+
+	payload = tot_len - hl;
+	size = (mtu - hl) & ~7u;
+	size2 = (mtu - hl2) & ~7u;
+	num = 1 + (payload - size + size2 - 1) / size2;
+	if (num > (uint32_t)max_frags)
+		return -1;
+
+	base_off = ODPH_IPV4HDR_FRAG_OFFSET(fo) * 8;
+	mf = fo & IPV4_MF;
+
+	for (i = 0, off = 0; off < payload; i++, off += len) {
+		uint8_t *h = i ? hdr2 : hdr;
+		uint32_t h_len = i ? hl2 : hl;
+
+		len = payload - off;
+		if (len > (i ? size2 : size))
+			len = i ? size2 : size;
+
+		ipv4_hdr_update(&h[l3_off], h_len, h_len + len,
+				((base_off + off) >> 3) |
+				(off + len < payload ? IPV4_MF : mf));
+
+		frag[i] = frag_alloc(pkt, h, l3_off + h_len,
+				     l3_off + hl + off, len);
+		if (frag[i] == ODP_PACKET_INVALID) {
+			frag_free(frag, i);
+			return -1;
+		}
+		odp_packet_has_ipv4_set(frag[i], 1);
+	}
+
+	odp_packet_free(pkt);
+	return i;
+}
+
+static int ipv6_fragment(odp_packet_t pkt, uint32_t l3_off, uint32_t mtu,
+			 odp_packet_t frag[], int max_frags)
+{
+	uint8_t hdr[ODPH_IPFRAG_HDR_MAX];
+	odph_ipv6hdr_t ip;
+	odph_ipv6hdr_frag_t *fh;
+	ipv6_chain_t chain;
+	uint32_t tot_len, unfrag, hdr_len, payload, size, off, len, num;
+	uint32_t id;
+	int i;
+
+	if (odp_packet_copy_to_mem(pkt, l3_off, ODPH_IPV6HDR_LEN, &ip))
+		return -1;
+
+	/* Jumbograms are not fragmented */
+	tot_len = ODPH_IPV6HDR_LEN + odp_be_to_cpu_16(ip.payload_len);
+	if (tot_len == ODPH_IPV6HDR_LEN ||
+	    l3_off + tot_len > odp_packet_len(pkt))
+		return -1;
+
+	if (tot_len <= mtu) {
+		frag[0] = pkt;
+		return 1;
+	}
+
+	if (ipv6_chain(pkt, l3_off, &ip, &chain) || chain.frag_hdr)
+		return -1;
+
+	unfrag = chain.unfrag;
+	hdr_len = l3_off + unfrag + ODPH_IPV6HDR_FRAG_LEN;
+	if (hdr_len > ODPH_IPFRAG_HDR_MAX || unfrag >= tot_len ||
+	    mtu < unfrag + ODPH_IPV6HDR_FRAG_LEN + 8 ||
+	    odp_packet_copy_to_mem(pkt, 0, l3_off + unfrag, hdr))
+		return -1;
+
+	payload = tot_len - unfrag;
+	size = (mtu - unfrag - ODPH_IPV6HDR_FRAG_LEN) & ~7u;
+	num = (payload + size - 1) / size;
+	if (num > (uint32_t)max_frags)
+		return -1;
+
+	id = ipv6_frag_id++ ^ ((uint32_t)odp_thread_id() << 24);
+
+	fh = (odph_ipv6hdr_frag_t *)(void *)&hdr[l3_off + unfrag];
+	fh->next_hdr = hdr[l3_off + chain.nh_off];
+	fh->reserved = 0;
+	fh->id = odp_cpu_to_be_32(id);
+	hdr[l3_off + chain.nh_off] = ODPH_IPPROTO_FRAG;
+
+	for (i = 0, off = 0; off < payload; i++, off += len) {
+		odph_ipv6hdr_t *ipv6 = (odph_ipv6hdr_t *)(void *)&hdr[l3_off];
+
+		len = payload - off;
+		if (len > size)
+			len = size;
+
+		ipv6->payload_len = odp_cpu_to_be_16(unfrag - ODPH_IPV6HDR_LEN +
+						     ODPH_IPV6HDR_FRAG_LEN +
+						     len);
+		fh->frag_off = odp_cpu_to_be_16(off |
+						(off + len < payload ? 1 : 0));
+
+		frag[i] = frag_alloc(pkt, hdr, hdr_len, l3_off + unfrag + off,
+				     len);
+		if (frag[i] == ODP_PACKET_INVALID) {
+			frag_free(frag, i);
+			return -1;
+		}
+		odp_packet_has_ipv6_set(frag[i], 1);
+	}
+
+	odp_packet_free(pkt);
+	return i;
+}
+
+int odph_ipfrag_fragment(odp_packet_t pkt, uint32_t mtu, odp_packet_t frag[],
+			 int max_frags)
+{
+	uint32_t l3_off = odp_packet_l3_offset(pkt);
+	uint8_t ver_ihl;
+
+	if (l3_off == ODP_PACKET_OFFSET_INVALID || max_frags < 1 ||
+	    odp_packet_copy_to_mem(pkt, l3_off, 1, &ver_ihl))
+		return -1;
+
+	if (ODPH_IPV4HDR_VER(ver_ihl) == ODPH_IPV4)
+		return ipv4_fragment(pkt, l3_off, mtu, frag, max_frags);
+	if (ODPH_IPV4HDR_VER(ver_ihl) == ODPH_IPV6)
+		return ipv6_fragment(pkt, l3_off, mtu, frag, max_frags);
+
+	return -1;
+}
+
+void odph_ipfrag_param_init(odph_ipfrag_param_t *param)
+{
+	memset(param, 0, sizeof(odph_ipfrag_param_t));
+	param->max_flows = 4096;
+	param->max_frags = 8;
+	param->num_shards = 16;
+	param->timeout_ns = ODP_TIME_SEC_IN_NS;
+	param->timer_pool = ODP_TIMER_POOL_INVALID;
+	param->tmo_pool = ODP_POOL_INVALID;
+	param->tmo_queue = ODP_QUEUE_INVALID;
+}
+
+static uint32_t roundup_pow2(uint32_t x)
+{
+	uint32_t n = 1;
+
+	while (n < x)
+		n <<= 1;
+
+	return n;
+}
+
+odph_ipfrag_tbl_t odph_ipfrag_tbl_create(const char *name,
+					 const odph_ipfrag_param_t *param)
+{
+	odph_ipfrag_tbl_t tbl;
+	odp_shm_t shm;
+	odp_timeout_t tmo;
+	odp_event_t ev;
+	uint64_t hdr_size, shard_size, flow_size;
+	uint32_t num_buckets, num_shards, i;
+
+	if (name == NULL || strlen(name) >= ODPH_IPFRAG_NAME_LEN ||
+	    param->max_flows == 0 || param->max_flows > (1u << 24) ||
+	    param->max_frags == 0 ||
+	    param->max_frags > ODPH_IPFRAG_MAX_FRAGS ||
+	    param->timeout_ns == 0) {
+		ODPH_DBG("create para input error!\n");
+		return ODPH_IPFRAG_TBL_INVALID;
+	}
+
+	if (odp_shm_lookup(name) != ODP_SHM_INVALID) {
+		ODPH_DBG("name already exist\n");
+		return ODPH_IPFRAG_TBL_INVALID;
+	}
+
+	num_buckets = roundup_pow2((param->max_flows + IPFRAG_WAYS - 1) /
+				   IPFRAG_WAYS);
+	num_shards = param->lockless ? 1 : roundup_pow2(param->num_shards);
+	if (num_shards > num_buckets)
+		num_shards = num_buckets;
+
+	hdr_size = IPFRAG_ROUNDUP(sizeof(struct odph_ipfrag_tbl_s),
+				  ODP_CACHE_LINE_SIZE);
+	shard_size = num_shards * sizeof(ipfrag_shard_t);
+	flow_size = IPFRAG_ROUNDUP(sizeof(ipfrag_flow_t) +
+				   param->max_frags * sizeof(ipfrag_frag_t),
+				   sizeof(uint64_t));
+
+	shm = odp_shm_reserve(name, hdr_size + shard_size + flow_size *
+			      num_buckets * IPFRAG_WAYS, ODP_CACHE_LINE_SIZE,
+			      ODP_SHM_SW_ONLY);
+	if (shm == ODP_SHM_INVALID) {
+		ODPH_DBG("shm reserve fail\n");
+		return ODPH_IPFRAG_TBL_INVALID;
+	}
+
+	tbl = odp_shm_addr(shm);
+	memset(tbl, 0, hdr_size + shard_size);
+
+	/* header of this mem block is the table control struct, then the
+	 * shards and the last part is the datagram entries of the buckets
+	 */
+	tbl->shard = (ipfrag_shard_t *)(void *)((uint8_t *)tbl + hdr_size);
+	tbl->flows = (uint8_t *)tbl + hdr_size + shard_size;
+	tbl->max_frags = param->max_frags;
+	tbl->bucket_mask = num_buckets - 1;
+	tbl->shard_mask = num_shards - 1;
+	tbl->flow_size = flow_size;
+	tbl->lockless = param->lockless;
+	tbl->timeout_ns = param->timeout_ns;
+	tbl->timer = ODP_TIMER_INVALID;
+	strncpy(tbl->name, name, ODPH_IPFRAG_NAME_LEN - 1);
+
+	for (i = 0; i < num_shards; i++)
+		odp_spinlock_init(&tbl->shard[i].lock);
+
+	for (i = 0; i < num_buckets * IPFRAG_WAYS; i++)
+		flow_ptr(tbl, 0, i)->num_frags = 0;
+
+	tbl->magicword = IPFRAG_MAGIC_WORD;
+
+	if (param->timer_pool == ODP_TIMER_POOL_INVALID)
+		return tbl;
+
+	tbl->tmo_ticks = odp_timer_ns_to_tick(param->timer_pool,
+					      param->timeout_ns /
+					      IPFRAG_TMO_DIV);
+	if (tbl->tmo_ticks == 0)
+		tbl->tmo_ticks = 1;
+
+	tmo = odp_timeout_alloc(param->tmo_pool);
+	if (tmo == ODP_TIMEOUT_INVALID) {
+		ODPH_DBG("timeout alloc fail\n");
+		goto error;
+	}
+	ev = odp_timeout_to_event(tmo);
+
+	tbl->timer = odp_timer_alloc(param->timer_pool, param->tmo_queue, tbl);
+	if (tbl->timer == ODP_TIMER_INVALID) {
+		ODPH_DBG("timer alloc fail\n");
+		odp_event_free(ev);
+		goto error;
+	}
+
+	if (odp_timer_set_rel(tbl->timer, tbl->tmo_ticks, &ev) !=
+	    ODP_TIMER_SUCCESS) {
+		ODPH_DBG("timer set fail\n");
+		odp_event_free(ev);
+		goto error;
+	}
+
+	return tbl;
+
+error:
+	(void)odph_ipfrag_tbl_destroy(tbl);
+	return ODPH_IPFRAG_TBL_INVALID;
+}
+
+odph_ipfrag_tbl_t odph_ipfrag_tbl_find(const char *name)
+{
+	odph_ipfrag_tbl_t tbl;
+
+	if (name == NULL || strlen(name) >= ODPH_IPFRAG_NAME_LEN)
+		return ODPH_IPFRAG_TBL_INVALID;
+
+	tbl = odp_shm_addr(odp_shm_lookup(name));
+	if (tbl != NULL && tbl->magicword == IPFRAG_MAGIC_WORD &&
+	    strcmp(tbl->name, name) == 0)
+		return tbl;
+
+	return ODPH_IPFRAG_TBL_INVALID;
+}
+
+/* Move fragments out of a datagram entry and free the entry */
+static uint32_t flow_detach(ipfrag_flow_t *flow, ipfrag_frag_t frag[])
+{
+	uint32_t num = flow->num_frags;
+
+	memcpy(frag, flow->frag, num * sizeof(ipfrag_frag_t));
+	flow->num_frags = 0;
+	return num;
+}
+
+static void flow_free(ipfrag_flow_t *flow)
+{
+	uint32_t i;
+
+	for (i = 0; i < flow->num_frags; i++)
+		odp_packet_free(flow->frag[i].pkt);
+
+	flow->num_frags = 0;
+}
+
+int odph_ipfrag_tbl_destroy(odph_ipfrag_tbl_t tbl)
+{
+	odp_event_t ev;
+	uint32_t i;
+
+	if (tbl == ODPH_IPFRAG_TBL_INVALID ||
+	    tbl->magicword != IPFRAG_MAGIC_WORD)
+		return -1;
+
+	if (tbl->timer != ODP_TIMER_INVALID) {
+		if (odp_timer_cancel(tbl->timer, &ev) == 0)
+			odp_event_free(ev);
+		ev = odp_timer_free(tbl->timer);
+		if (ev != ODP_EVENT_INVALID)
+			odp_event_free(ev);
+	}
+
+	for (i = 0; i < (tbl->bucket_mask + 1) * IPFRAG_WAYS; i++)
+		flow_free(flow_ptr(tbl, 0, i));
+
+	tbl->magicword = 0;
+	if (odp_shm_free(odp_shm_lookup(tbl->name))) {
+		ODPH_DBG("free fail\n");
+		return -1;
+	}
+
+	return 0;
+}
+
+static int ipv4_frag_parse(odp_packet_t pkt, uint32_t l3_off,
+			   ipfrag_info_t *info)
+{
+	odph_ipv4hdr_t ip;
+	uint32_t hl, tot_len;
+	uint16_t fo;
+
+	if (odp_packet_copy_to_mem(pkt, l3_off, ODPH_IPV4HDR_LEN, &ip))
+		return 0;
+
+	fo = odp_be_to_cpu_16(ip.frag_offset);
+	if (!ODPH_IPV4HDR_IS_FRAGMENT(fo))
+		return 0;
+
+	hl = ODPH_IPV4HDR_IHL(ip.ver_ihl) * 4;
+	tot_len = odp_be_to_cpu_16(ip.tot_len);
+	if (hl < ODPH_IPV4HDR_LEN || tot_len <= hl ||
+	    l3_off + tot_len > odp_packet_len(pkt) ||
+	    l3_off + hl > ODPH_IPFRAG_HDR_MAX)
+		return -1;
+
+	info->frag.off = ODPH_IPV4HDR_FRAG_OFFSET(fo) * 8;
+	info->frag.len = tot_len - hl;
+	info->frag.hdr_len = l3_off + hl;
+	info->frag.nh_off = 0;
+	info->end = l3_off + tot_len;
+	info->ip_hdr = hl;
+	info->more = ODPH_IPV4HDR_FLAGS_MORE_FRAGS(fo) != 0;
+
+	memset(&info->key, 0, sizeof(ipfrag_key_t));
+	memcpy(info->key.src, &ip.src_addr, ODPH_IPV4ADDR_LEN);
+	memcpy(info->key.dst, &ip.dst_addr, ODPH_IPV4ADDR_LEN);
+	info->key.id = ip.id;
+	info->key.proto = ip.proto;
+	info->key.ver = ODPH_IPV4;
+	return 1;
+}
+
+static int ipv6_frag_parse(odp_packet_t pkt, uint32_t l3_off,
+			   ipfrag_info_t *info)
+{
+	odph_ipv6hdr_t ip;
+	odph_ipv6hdr_frag_t fh;
+	ipv6_chain_t chain;
+	uint32_t tot_len;
+	uint16_t fo;
+
+	if (odp_packet_copy_to_mem(pkt, l3_off, ODPH_IPV6HDR_LEN, &ip) ||
+	    ip.next_hdr == ODPH_IPPROTO_TCP || ip.next_hdr == ODPH_IPPROTO_UDP)
+		return 0;
+
+	if (ipv6_chain(pkt, l3_off, &ip, &chain))
+		return -1;
+
+	if (chain.frag_hdr == 0)
+		return 0;
+
+	tot_len = ODPH_IPV6HDR_LEN + odp_be_to_cpu_16(ip.payload_len);
+	if (l3_off + tot_len > odp_packet_len(pkt) ||
+	    chain.frag_hdr + ODPH_IPV6HDR_FRAG_LEN >= tot_len ||
+	    l3_off + chain.frag_hdr > ODPH_IPFRAG_HDR_MAX ||
+	    odp_packet_copy_to_mem(pkt, l3_off + chain.frag_hdr,
+				   ODPH_IPV6HDR_FRAG_LEN, &fh))
+		return -1;
+
+	fo = odp_be_to_cpu_16(fh.frag_off);
+	info->frag.off = ODPH_IPV6HDR_FRAG_OFFSET(fo);
+	info->frag.len = tot_len - chain.frag_hdr - ODPH_IPV6HDR_FRAG_LEN;
+	info->frag.hdr_len = l3_off + chain.frag_hdr + ODPH_IPV6HDR_FRAG_LEN;
+	info->frag.nh_off = chain.nh_off;
+	info->end = l3_off + tot_len;
+	info->ip_hdr = chain.frag_hdr - ODPH_IPV6HDR_LEN;
+	info->more = ODPH_IPV6HDR_FRAG_MORE(fo) != 0;
+
+	memcpy(info->key.src, ip.src_addr, ODPH_IPV6ADDR_LEN);
+	memcpy(info->key.dst, ip.dst_addr, ODPH_IPV6ADDR_LEN);
+	info->key.id = fh.id;
+	info->key.proto = 0;
+	info->key.ver = ODPH_IPV6;
+	info->key.pad[0] = 0;
+	info->key.pad[1] = 0;
+	return 1;
+}
+
+/* Parse a fragment. Returns 1 for a fragment, 0 for a non-fragment and <0
+ * for a malformed fragment. */
+static int frag_parse(odp_packet_t pkt, ipfrag_info_t *info)
+{
+	uint32_t l3_off = odp_packet_l3_offset(pkt);
+	uint8_t ver_ihl;
+	int ret;
+
+	if (l3_off == ODP_PACKET_OFFSET_INVALID ||
+	    odp_packet_copy_to_mem(pkt, l3_off, 1, &ver_ihl))
+		return 0;
+
+	if (ODPH_IPV4HDR_VER(ver_ihl) == ODPH_IPV4)
+		ret = ipv4_frag_parse(pkt, l3_off, info);
+	else if (ODPH_IPV4HDR_VER(ver_ihl) == ODPH_IPV6)
+		ret = ipv6_frag_parse(pkt, l3_off, info);
+	else
+		return 0;
+
+	if (ret <= 0)
+		return ret;
+
+	if (info->more && info->frag.len % 8)
+		return -1;
+
+	return 1;
+}
+
+/* Find the datagram entry of a key, or allocate a new one. Expired
+ * datagrams of the bucket are dropped on the way. */
+static ipfrag_flow_t *flow_lookup(odph_ipfrag_tbl_t tbl,
+				  ipfrag_shard_t *shard, uint32_t bucket,
+				  const ipfrag_key_t *key, uint64_t now)
+{
+	ipfrag_flow_t *flow, *free_flow = NULL;
+	uint32_t i;
+
+	for (i = 0; i < IPFRAG_WAYS; i++) {
+		flow = flow_ptr(tbl, bucket, i);
+
+		if (flow->num_frags &&
+		    now - flow->start_ns > tbl->timeout_ns) {
+			flow_free(flow);
+			shard->stats.expired++;
+		}
+
+		if (flow->num_frags == 0) {
+			if (free_flow == NULL)
+				free_flow = flow;
+			continue;
+		}
+
+		if (memcmp(&flow->key, key, sizeof(ipfrag_key_t)) == 0)
+			return flow;
+	}
+
+	if (free_flow) {
+		free_flow->key = *key;
+		free_flow->start_ns = now;
+		free_flow->total_len = 0;
+		free_flow->recv_len = 0;
+	}
+
+	return free_flow;
+}
+
+/* Add a fragment to a datagram. Returns 0 when the datagram is complete,
+ * 1 when more fragments are needed and <0 when the datagram is broken. */
+static int flow_add(odph_ipfrag_tbl_t tbl, ipfrag_flow_t *flow,
+		    const ipfrag_info_t *info, odp_packet_t pkt)
+{
+	uint32_t off = info->frag.off;
+	uint32_t end = off + info->frag.len;
+	uint32_t total_len = info->more ? flow->total_len : end;
+	uint32_t i;
+
+	/* The length field of the reassembled datagram is 16 bits */
+	if (flow->num_frags == tbl->max_frags ||
+	    info->ip_hdr + end > 0xffff ||
+	    (!info->more && flow->total_len) ||
+	    (total_len && end > total_len))
+		return -1;
+
+	/* Overlapping fragments drop the datagram (RFC 5722) */
+	for (i = 0; i < flow->num_frags; i++) {
+		const ipfrag_frag_t *frag = &flow->frag[i];
+
+		if (off < frag->off + frag->len && frag->off < end)
+			return -1;
+		if (total_len && frag->off + frag->len > total_len)
+			return -1;
+	}
+
+	flow->frag[flow->num_frags] = info->frag;
+	flow->frag[flow->num_frags].pkt = pkt;
+	flow->num_frags++;
+	flow->total_len = total_len;
+	flow->recv_len += info->frag.len;
+
+	return (total_len && flow->recv_len == total_len) ? 0 : 1;
+}
+
+/* Concatenate fragments and rewrite the IP header of the first one */
+static int frag_join(ipfrag_frag_t frag[], uint32_t num, uint32_t total_len,
+		     odp_packet_t *out)
+{
+	uint8_t hdr[ODPH_IPFRAG_HDR_MAX];
+	ipfrag_frag_t tmp;
+	odp_packet_t pkt;
+	uint32_t l3_off, hdr_len, expected, i, j;
+
+	/* Fragments usually arrive in order */
+	for (i = 1; i < num; i++) {
+		tmp = frag[i];
+		for (j = i; j > 0 && frag[j - 1].off > tmp.off; j--)
+			frag[j] = frag[j - 1];
+		frag[j] = tmp;
+	}
+
+	pkt = frag[0].pkt;
+	l3_off = odp_packet_l3_offset(pkt);
+	hdr_len = frag[0].hdr_len;
+	expected = frag[0].len;
+
+	for (i = 1; i < num; i++) {
+		if (frag[i].off != expected ||
+		    odp_packet_trunc_head(&frag[i].pkt, frag[i].hdr_len,
+					  NULL, NULL) < 0 ||
+		    odp_packet_concat(&pkt, frag[i].pkt) < 0)
+			goto error;
+		expected += frag[i].len;
+	}
+
+	if (frag[0].nh_off == 0) {
+		uint32_t hl = hdr_len - l3_off;
+		uint16_t fo;
+
+		if (hl + total_len > 0xffff ||
+		    odp_packet_copy_to_mem(pkt, l3_off, hl, hdr))
+			goto drop;
+		fo = odp_be_to_cpu_16(((odph_ipv4hdr_t *)(void *)hdr)->
+				      frag_offset);
+		ipv4_hdr_update(hdr, hl, hl + total_len, fo & IPV4_DF);
+		if (odp_packet_copy_from_mem(pkt, l3_off, hl, hdr))
+			goto drop;
+		odp_packet_l4_offset_set(pkt, hdr_len);
+	} else {
+		/* Remove the fragment header */
+		odph_ipv6hdr_t *ip = (odph_ipv6hdr_t *)(void *)&hdr[l3_off];
+		uint32_t len = hdr_len - ODPH_IPV6HDR_FRAG_LEN;
+
+		if (len - l3_off - ODPH_IPV6HDR_LEN + total_len > 0xffff ||
+		    odp_packet_copy_to_mem(pkt, 0, len + 1, hdr))
+			goto drop;
+		hdr[l3_off + frag[0].nh_off] = hdr[len];
+		ip->payload_len = odp_cpu_to_be_16(len - l3_off -
+						   ODPH_IPV6HDR_LEN +
+						   total_len);
+		if (odp_packet_trunc_head(&pkt, ODPH_IPV6HDR_FRAG_LEN,
+					  NULL, NULL) < 0 ||
+		    odp_packet_copy_from_mem(pkt, 0, len, hdr))
+			goto drop;
+		odp_packet_l3_offset_set(pkt, l3_off);
+		odp_packet_l4_offset_set(pkt, len);
+	}
+
+	odp_packet_has_ipfrag_set(pkt, 0);
+	*out = pkt;
+	return 0;
+
+error:
+	for (j = i; j < num; j++)
+		odp_packet_free(frag[j].pkt);
+drop:
+	odp_packet_free(pkt);
+	return -1;
+}
+
+int odph_ipfrag_reassemble(odph_ipfrag_tbl_t tbl, odp_packet_t *pkt)
+{
+	ipfrag_frag_t frag[ODPH_IPFRAG_MAX_FRAGS];
+	ipfrag_info_t info;
+	ipfrag_shard_t *shard;
+	ipfrag_flow_t *flow;
+	uint32_t bucket, pkt_len, total_len = 0, num = 0;
+	int ret;
+
+	ret = frag_parse(*pkt, &info);
+	if (ret == 0)
+		return 0;
+
+	pkt_len = odp_packet_len(*pkt);
+	if (ret > 0 && pkt_len > info.end &&
+	    odp_packet_trunc_tail(pkt, pkt_len - info.end, NULL, NULL) < 0)
+		ret = -1;
+
+	/* Malformed fragments are accounted to the first shard */
+	bucket = ret > 0 ? odp_hash_crc32c(&info.key, sizeof(ipfrag_key_t),
+					   0) & tbl->bucket_mask : 0;
+	shard = &tbl->shard[bucket & tbl->shard_mask];
+
+	shard_lock(tbl, shard);
+	shard->stats.frags++;
+
+	if (ret > 0) {
+		flow = flow_lookup(tbl, shard, bucket, &info.key,
+				   time_now_ns());
+		if (flow == NULL) {
+			ret = -1;
+		} else {
+			ret = flow_add(tbl, flow, &info, *pkt);
+			total_len = flow->total_len;
+			if (ret <= 0)
+				num = flow_detach(flow, frag);
+		}
+	}
+
+	if (ret < 0)
+		shard->stats.dropped += num + 1;
+	else if (ret == 0)
+		shard->stats.reassembled++;
+
+	shard_unlock(tbl, shard);
+
+	if (ret > 0)
+		return 1;
+
+	if (ret < 0) {
+		for (; num; num--)
+			odp_packet_free(frag[num - 1].pkt);
+		odp_packet_free(*pkt);
+		return -1;
+	}
+
+	if (frag_join(frag, num, total_len, pkt) == 0)
+		return 0;
+
+	shard_lock(tbl, shard);
+	shard->stats.reassembled--;
+	shard->stats.dropped += num;
+	shard_unlock(tbl, shard);
+	return -1;
+}
+
+int odph_ipfrag_expire(odph_ipfrag_tbl_t tbl)
+{
+	uint64_t now = time_now_ns();
+	ipfrag_shard_t *shard;
+	ipfrag_flow_t *flow;
+	uint32_t s, b, i;
+	int num = 0;
+
+	for (s = 0; s <= tbl->shard_mask; s++) {
+		shard = &tbl->shard[s];
+		shard_lock(tbl, shard);
+
+		for (b = s; b <= tbl->bucket_mask; b += tbl->shard_mask + 1) {
+			for (i = 0; i < IPFRAG_WAYS; i++) {
+				flow = flow_ptr(tbl, b, i);
+				if (flow->num_frags &&
+				    now - flow->start_ns > tbl->timeout_ns) {
+					flow_free(flow);
+					shard->stats.expired++;
+					num++;
+				}
+			}
+		}
+
+		shard_unlock(tbl, shard);
+	}
+
+	return num;
+}
+
+int odph_ipfrag_timeout(odp_event_t ev)
+{
+	odph_ipfrag_tbl_t tbl;
+	odp_timeout_t tmo;
+	int num;
+
+	if (odp_event_type(ev) != ODP_EVENT_TIMEOUT)
+		return -1;
+
+	tmo = odp_timeout_from_event(ev);
+	tbl = odp_timeout_user_ptr(tmo);
+	if (tbl == NULL || tbl->magicword != IPFRAG_MAGIC_WORD ||
+	    tbl->timer != odp_timeout_timer(tmo))
+		return -1;
+
+	num = odph_ipfrag_expire(tbl);
+
+	if (odp_timer_set_rel(tbl->timer, tbl->tmo_ticks, &ev) !=
+	    ODP_TIMER_SUCCESS) {
+		ODPH_ERR("timer restart fail, table %s\n", tbl->name);
+		odp_event_free(ev);
+	}
+
+	return num;
+}
+
+void odph_ipfrag_stats(odph_ipfrag_tbl_t tbl, odph_ipfrag_stats_t *stats)
+{
+	ipfrag_shard_t *shard;
+	uint32_t s;
+
+	memset(stats, 0, sizeof(odph_ipfrag_stats_t));
+
+	for (s = 0; s <= tbl->shard_mask; s++) {
+		shard = &tbl->shard[s];
+		shard_lock(tbl, shard);
+		stats->frags += shard->stats.frags;
+		stats->reassembled += shard->stats.reassembled;
+		stats->expired += shard->stats.expired;
+		stats->dropped += shard->stats.dropped;
+		shard_unlock(tbl, shard);
+	}
+}
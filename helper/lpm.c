@@ -0,0 +1,783 @@
+/* Copyright (c) 2017, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+#include <string.h>
+
+#include <odp_api.h>
+#include <odp/helper/lpm.h>
+#include "odph_debug.h"
+
+/** @magic word, write to the first word of the table header
+ *	to indicate this block is used by a LPM table structure
+ */
+#define LPM_MAGIC_WORD     0xB1B1C2C2
+
+/** Bits of the first level index of IPv4 and IPv6 tables */
+#define LPM4_FIRST_BITS    24
+#define LPM6_FIRST_BITS    16
+
+/** Entries in an extension group, indexed by one address byte */
+#define LPM_TBL8_ENTRIES   256
+
+/** Position of the prefix length in a route entry */
+#define LPM_DEPTH_SHIFT    22
+
+/** Multi-lookups prefetch first level entries this many addresses ahead */
+#define LPM_PREFETCH_DIST  8
+
+/** Maximum number of extension group levels of a route */
+#define LPM_MAX_LEVELS     ((128 - LPM6_FIRST_BITS) / 8 + 1)
+
+/** Quiescent state of a reader thread, indexed by ODP thread id */
+typedef struct {
+	/** Grace period counter seen at the last quiescent state, or 0 while
+	 * the thread is offline */
+	uint64_t seq;
+} ODP_ALIGNED_CACHE lpm_reader_t;
+
+/** Route storage, needed for finding covering routes on delete */
+typedef struct {
+	uint8_t  ip[ODPH_LPM6_ADDR_LEN]; /**< prefix, host bits cleared */
+	uint8_t  depth;                  /**< prefix length */
+	uint8_t  used;                   /**< slot holds a route */
+	uint8_t  pad[2];
+	uint32_t next_hop;               /**< next hop of the route */
+} lpm_rule_t;
+
+struct odph_lpm_s {
+	/** tables read by lookups, must be the first member */
+	odph_lpm_lookup_tbl_t lookup;
+	uint32_t *tbl;         /**< first level table */
+	uint32_t *tbl8;        /**< extension groups */
+	lpm_rule_t *rules;     /**< open addressing hash of routes */
+	uint32_t *tbl8_free;   /**< FIFO of free extension groups */
+	uint64_t *tbl8_seq;    /**< grace period of each tbl8_free slot */
+	uint32_t magicword;    /**< for check */
+	uint32_t addr_len;     /**< 4 for IPv4, 16 for IPv6 */
+	uint32_t first_bits;   /**< first level index bits */
+	uint32_t max_rules;    /**< input param when create */
+	uint32_t num_rules;    /**< number of routes */
+	uint32_t rule_mask;    /**< number of rule slots - 1 */
+	uint32_t num_tbl8;     /**< input param when create */
+	uint32_t free_head;    /**< first group in tbl8_free */
+	uint32_t free_num;     /**< number of groups in tbl8_free */
+	odp_spinlock_t lock;   /**< serializes updates */
+	char name[ODPH_LPM_NAME_LEN]; /**< table name */
+	uint64_t gp_seq;       /**< grace period counter */
+	uint64_t safe_seq;     /**< groups released before this are unused */
+	lpm_reader_t reader[ODP_THREAD_COUNT_MAX]; /**< reader states */
+};
+
+#define LPM_ROUNDUP(x, align) ((((x) + (align) - 1) / (align)) * (align))
+
+static inline uint32_t entry_depth(uint32_t e)
+{
+	return (e >> LPM_DEPTH_SHIFT) & 0xff;
+}
+
+static inline uint32_t entry_route(uint32_t depth, uint32_t next_hop)
+{
+	return ODPH_LPM_ENTRY_VALID | (depth << LPM_DEPTH_SHIFT) | next_hop;
+}
+
+static inline uint32_t *entry_group(odph_lpm_t lpm, uint32_t e)
+{
+	return &lpm->tbl8[(e & ODPH_LPM_ENTRY_NH_MASK) * LPM_TBL8_ENTRIES];
+}
+
+static inline uint32_t entry_load(const uint32_t *p)
+{
+	return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+}
+
+static inline void entry_store(uint32_t *p, uint32_t e)
+{
+	__atomic_store_n(p, e, __ATOMIC_RELEASE);
+}
+
+/* First address bit indexing level 'level' */
+static inline uint32_t level_pos(odph_lpm_t lpm, int level)
+{
+	return level ? lpm->first_bits + 8 * (level - 1) : 0;
+}
+
+/* Bits of 'ip' indexing level 'level' */
+static inline uint32_t level_index(odph_lpm_t lpm, const uint8_t *ip,
+				   int level)
+{
+	if (level)
+		return ip[lpm->first_bits / 8 + level - 1];
+
+	if (lpm->first_bits == LPM4_FIRST_BITS)
+		return (ip[0] << 16) | (ip[1] << 8) | ip[2];
+
+	return (ip[0] << 8) | ip[1];
+}
+
+static void prefix_mask(uint8_t *dst, const uint8_t *ip, uint32_t len,
+			uint32_t depth)
+{
+	uint32_t i;
+
+	for (i = 0; i < len; i++) {
+		if (depth >= 8)
+			dst[i] = ip[i];
+		else if (depth)
+			dst[i] = ip[i] & (uint8_t)(0xff00 >> depth);
+		else
+			dst[i] = 0;
+		depth = depth >= 8 ? depth - 8 : 0;
+	}
+}
+
+static void ipv4_to_bytes(uint8_t *dst, uint32_t ip)
+{
+	dst[0] = ip >> 24;
+	dst[1] = ip >> 16;
+	dst[2] = ip >> 8;
+	dst[3] = ip;
+}
+
+static inline uint32_t rule_home(odph_lpm_t lpm, const uint8_t *ip,
+				 uint32_t depth)
+{
+	return odp_hash_crc32c(ip, lpm->addr_len, depth) & lpm->rule_mask;
+}
+
+static lpm_rule_t *rule_find(odph_lpm_t lpm, const uint8_t *ip,
+			     uint32_t depth)
+{
+	uint32_t i = rule_home(lpm, ip, depth);
+
+	while (lpm->rules[i].used) {
+		lpm_rule_t *rule = &lpm->rules[i];
+
+		if (rule->depth == depth &&
+		    memcmp(rule->ip, ip, lpm->addr_len) == 0)
+			return rule;
+		i = (i + 1) & lpm->rule_mask;
+	}
+
+	return NULL;
+}
+
+static lpm_rule_t *rule_insert(odph_lpm_t lpm, const uint8_t *ip,
+			       uint32_t depth, uint32_t next_hop)
+{
+	uint32_t i;
+
+	if (lpm->num_rules >= lpm->max_rules)
+		return NULL;
+
+	i = rule_home(lpm, ip, depth);
+	while (lpm->rules[i].used)
+		i = (i + 1) & lpm->rule_mask;
+
+	memcpy(lpm->rules[i].ip, ip, lpm->addr_len);
+	lpm->rules[i].depth = depth;
+	lpm->rules[i].next_hop = next_hop;
+	lpm->rules[i].used = 1;
+	lpm->num_rules++;
+
+	return &lpm->rules[i];
+}
+
+/* Linear probing delete: move following rules back into the hole when
+ * the hole is between their home slot and current slot. */
+static void rule_remove(odph_lpm_t lpm, lpm_rule_t *rule)
+{
+	uint32_t mask = lpm->rule_mask;
+	uint32_t i = rule - lpm->rules;
+	uint32_t j = i;
+	uint32_t home;
+
+	while (1) {
+		j = (j + 1) & mask;
+		if (!lpm->rules[j].used)
+			break;
+
+		home = rule_home(lpm, lpm->rules[j].ip, lpm->rules[j].depth);
+		if (((j - home) & mask) >= ((j - i) & mask)) {
+			lpm->rules[i] = lpm->rules[j];
+			i = j;
+		}
+	}
+
+	lpm->rules[i].used = 0;
+	lpm->num_rules--;
+}
+
+/* Longest route shorter than 'depth' covering 'ip' */
+static lpm_rule_t *rule_cover(odph_lpm_t lpm, const uint8_t *ip,
+			      uint32_t depth)
+{
+	uint8_t prefix[ODPH_LPM6_ADDR_LEN];
+	lpm_rule_t *rule;
+
+	while (depth-- > 0) {
+		prefix_mask(prefix, ip, lpm->addr_len, depth);
+		rule = rule_find(lpm, prefix, depth);
+		if (rule)
+			return rule;
+	}
+
+	return NULL;
+}
+
+/* Recompute the oldest grace period still seen by an online reader. The
+ * calling thread is not inside a lookup while it updates the table. */
+static void tbl8_update_safe(odph_lpm_t lpm)
+{
+	uint64_t safe = __atomic_load_n(&lpm->gp_seq, __ATOMIC_SEQ_CST);
+	uint64_t seq;
+	int self = odp_thread_id();
+	int i;
+
+	for (i = 0; i < ODP_THREAD_COUNT_MAX; i++) {
+		if (i == self)
+			continue;
+
+		seq = __atomic_load_n(&lpm->reader[i].seq, __ATOMIC_SEQ_CST);
+		if (seq && seq < safe)
+			safe = seq;
+	}
+
+	lpm->safe_seq = safe;
+}
+
+/* Groups are reused in FIFO order, which is also the order of their grace
+ * periods. A released group is reused only after every online reader has
+ * passed a quiescent state, so no lookup can still follow the extension
+ * entry that pointed to it. */
+static int tbl8_alloc(odph_lpm_t lpm, uint32_t *group)
+{
+	uint32_t head = lpm->free_head;
+
+	if (lpm->free_num == 0)
+		return -1;
+
+	while (lpm->tbl8_seq[head] >= lpm->safe_seq) {
+		tbl8_update_safe(lpm);
+		if (lpm->tbl8_seq[head] >= lpm->safe_seq)
+			odp_cpu_pause();
+	}
+
+	*group = lpm->tbl8_free[head];
+	lpm->free_head = (head + 1) % lpm->num_tbl8;
+	lpm->free_num--;
+	return 0;
+}
+
+/* Called after the last entry pointing to the group has been replaced */
+static void tbl8_release(odph_lpm_t lpm, uint32_t group)
+{
+	uint32_t tail = (lpm->free_head + lpm->free_num) % lpm->num_tbl8;
+
+	lpm->tbl8_free[tail] = group;
+	lpm->tbl8_seq[tail] = __atomic_fetch_add(&lpm->gp_seq, 1,
+						 __ATOMIC_SEQ_CST);
+	lpm->free_num++;
+}
+
+/* Replace an extension entry by the common value of its group, when all
+ * group entries are equal routes or equally empty */
+static void tbl8_try_collapse(odph_lpm_t lpm, uint32_t *p)
+{
+	uint32_t e = *p;
+	uint32_t *grp;
+	uint32_t i;
+
+	if (!(e & ODPH_LPM_ENTRY_EXT))
+		return;
+
+	grp = entry_group(lpm, e);
+	if (grp[0] & ODPH_LPM_ENTRY_EXT)
+		return;
+
+	for (i = 1; i < LPM_TBL8_ENTRIES; i++)
+		if (grp[i] != grp[0])
+			return;
+
+	entry_store(p, grp[0]);
+	tbl8_release(lpm, e & ODPH_LPM_ENTRY_NH_MASK);
+}
+
+/* Store route 'route' of length 'depth' in entry 'p' and in all entries
+ * below it, except where a longer route is stored */
+static void entry_add(odph_lpm_t lpm, uint32_t *p, uint32_t depth,
+		      uint32_t route)
+{
+	uint32_t e = *p;
+	uint32_t *grp;
+	int i;
+
+	if (e & ODPH_LPM_ENTRY_EXT) {
+		grp = entry_group(lpm, e);
+		for (i = 0; i < LPM_TBL8_ENTRIES; i++)
+			entry_add(lpm, &grp[i], depth, route);
+		return;
+	}
+
+	if (!(e & ODPH_LPM_ENTRY_VALID) || entry_depth(e) <= depth)
+		entry_store(p, route);
+}
+
+/* Replace entries of the deleted route of length 'depth' by 'cover' */
+static void entry_del(odph_lpm_t lpm, uint32_t *p, uint32_t depth,
+		      uint32_t cover)
+{
+	uint32_t e = *p;
+	uint32_t *grp;
+	int i;
+
+	if (e & ODPH_LPM_ENTRY_EXT) {
+		grp = entry_group(lpm, e);
+		for (i = 0; i < LPM_TBL8_ENTRIES; i++)
+			entry_del(lpm, &grp[i], depth, cover);
+		tbl8_try_collapse(lpm, p);
+		return;
+	}
+
+	if ((e & ODPH_LPM_ENTRY_VALID) && entry_depth(e) == depth)
+		entry_store(p, cover);
+}
+
+/* Store a route in the entries covered by the prefix. Extension groups are
+ * added on the path to prefixes that end below the first level. */
+static int lpm_tbl_add(odph_lpm_t lpm, const uint8_t *ip, uint32_t depth,
+		       uint32_t route)
+{
+	uint32_t *path[LPM_MAX_LEVELS];
+	uint32_t *tbl = lpm->tbl;
+	uint32_t idx, end, num, e, group, i;
+	uint32_t *grp;
+	int level;
+
+	for (level = 0; ; level++) {
+		end = level_pos(lpm, level + 1);
+		idx = level_index(lpm, ip, level);
+
+		if (depth <= end) {
+			num = 1 << (end - depth);
+			for (i = idx; i < idx + num; i++)
+				entry_add(lpm, &tbl[i], depth, route);
+			return 0;
+		}
+
+		e = tbl[idx];
+		if (!(e & ODPH_LPM_ENTRY_EXT)) {
+			if (tbl8_alloc(lpm, &group)) {
+				/* Groups added above only copy the shorter
+				 * route. Release them, deepest first. */
+				while (level-- > 0)
+					tbl8_try_collapse(lpm, path[level]);
+				return -1;
+			}
+
+			/* Group inherits the shorter route, if any. Fill it
+			 * before linking it to the table. */
+			grp = &lpm->tbl8[group * LPM_TBL8_ENTRIES];
+			for (i = 0; i < LPM_TBL8_ENTRIES; i++)
+				grp[i] = (e & ODPH_LPM_ENTRY_VALID) ? e : 0;
+
+			e = ODPH_LPM_ENTRY_EXT | group;
+			entry_store(&tbl[idx], e);
+		}
+
+		path[level] = &tbl[idx];
+		tbl = entry_group(lpm, e);
+	}
+}
+
+static void lpm_tbl_del(odph_lpm_t lpm, const uint8_t *ip, uint32_t depth,
+			uint32_t cover)
+{
+	uint32_t *path[LPM_MAX_LEVELS];
+	uint32_t *tbl = lpm->tbl;
+	uint32_t idx, end, num, e, i;
+	int level;
+
+	for (level = 0; ; level++) {
+		end = level_pos(lpm, level + 1);
+		idx = level_index(lpm, ip, level);
+
+		if (depth <= end) {
+			num = 1 << (end - depth);
+			for (i = idx; i < idx + num; i++)
+				entry_del(lpm, &tbl[i], depth, cover);
+			break;
+		}
+
+		e = tbl[idx];
+		if (!(e & ODPH_LPM_ENTRY_EXT))
+			break;
+
+		path[level] = &tbl[idx];
+		tbl = entry_group(lpm, e);
+	}
+
+	/* Release groups that became uniform, deepest first */
+	while (level-- > 0)
+		tbl8_try_collapse(lpm, path[level]);
+}
+
+static odph_lpm_t lpm_create(const char *name, uint32_t max_rules,
+			     uint32_t num_tbl8, uint32_t addr_len,
+			     uint32_t first_bits)
+{
+	odph_lpm_t lpm;
+	odp_shm_t shm;
+	uint64_t hdr_size, tbl_size, tbl8_size, free_size, seq_size;
+	uint64_t rule_size;
+	uint32_t num_slots, i;
+	uint8_t *base;
+
+	if (name == NULL || strlen(name) >= ODPH_LPM_NAME_LEN ||
+	    max_rules == 0 || max_rules > (1u << 30) ||
+	    num_tbl8 > ODPH_LPM_NEXT_HOP_MAX + 1) {
+		ODPH_DBG("create para input error!\n");
+		return ODPH_LPM_INVALID;
+	}
+
+	if (odp_shm_lookup(name) != ODP_SHM_INVALID) {
+		ODPH_DBG("name already exist\n");
+		return ODPH_LPM_INVALID;
+	}
+
+	/* Keep the rule hash at most half full */
+	num_slots = 16;
+	while (num_slots < 2 * max_rules)
+		num_slots <<= 1;
+
+	hdr_size  = LPM_ROUNDUP(sizeof(struct odph_lpm_s),
+				ODP_CACHE_LINE_SIZE);
+	tbl_size  = sizeof(uint32_t) << first_bits;
+	tbl8_size = (uint64_t)num_tbl8 * LPM_TBL8_ENTRIES * sizeof(uint32_t);
+	free_size = LPM_ROUNDUP((uint64_t)num_tbl8 * sizeof(uint32_t),
+				ODP_CACHE_LINE_SIZE);
+	seq_size  = LPM_ROUNDUP((uint64_t)num_tbl8 * sizeof(uint64_t),
+				ODP_CACHE_LINE_SIZE);
+	rule_size = (uint64_t)num_slots * sizeof(lpm_rule_t);
+
+	shm = odp_shm_reserve(name, hdr_size + tbl_size + tbl8_size +
+			      free_size + seq_size + rule_size,
+			      ODP_CACHE_LINE_SIZE, ODP_SHM_SW_ONLY);
+	if (shm == ODP_SHM_INVALID) {
+		ODPH_DBG("shm reserve fail\n");
+		return ODPH_LPM_INVALID;
+	}
+
+	lpm = odp_shm_addr(shm);
+	memset(lpm, 0, sizeof(struct odph_lpm_s));
+
+	/* header of this mem block is the table control struct, then the
+	 * first level table, extension groups, free group FIFO with the
+	 * grace periods of its groups and the last part is the rule hash
+	 */
+	base = (uint8_t *)lpm + hdr_size;
+	lpm->tbl = (uint32_t *)(void *)base;
+	base += tbl_size;
+	lpm->tbl8 = (uint32_t *)(void *)base;
+	base += tbl8_size;
+	lpm->tbl8_free = (uint32_t *)(void *)base;
+	base += free_size;
+	lpm->tbl8_seq = (uint64_t *)(void *)base;
+	base += seq_size;
+	lpm->rules = (lpm_rule_t *)(void *)base;
+
+	lpm->lookup.tbl = lpm->tbl;
+	lpm->lookup.tbl8 = lpm->tbl8;
+	lpm->addr_len = addr_len;
+	lpm->first_bits = first_bits;
+	lpm->max_rules = max_rules;
+	lpm->rule_mask = num_slots - 1;
+	lpm->num_tbl8 = num_tbl8;
+	lpm->free_num = num_tbl8;
+	lpm->gp_seq = 1;
+	lpm->safe_seq = 1;
+	strncpy(lpm->name, name, ODPH_LPM_NAME_LEN - 1);
+	odp_spinlock_init(&lpm->lock);
+
+	memset(lpm->tbl, 0, tbl_size);
+	memset(lpm->rules, 0, rule_size);
+	for (i = 0; i < num_tbl8; i++) {
+		lpm->tbl8_free[i] = i;
+		lpm->tbl8_seq[i] = 0;
+	}
+
+	lpm->magicword = LPM_MAGIC_WORD;
+	return lpm;
+}
+
+odph_lpm_t odph_lpm_create(const char *name, uint32_t max_rules,
+			   uint32_t num_tbl8)
+{
+	return lpm_create(name, max_rules, num_tbl8, 4, LPM4_FIRST_BITS);
+}
+
+odph_lpm_t odph_lpm6_create(const char *name, uint32_t max_rules,
+			    uint32_t num_tbl8)
+{
+	return lpm_create(name, max_rules, num_tbl8, ODPH_LPM6_ADDR_LEN,
+			  LPM6_FIRST_BITS);
+}
+
+odph_lpm_t odph_lpm_find(const char *name)
+{
+	odph_lpm_t lpm;
+
+	if (name == NULL || strlen(name) >= ODPH_LPM_NAME_LEN)
+		return ODPH_LPM_INVALID;
+
+	lpm = odp_shm_addr(odp_shm_lookup(name));
+	if (lpm != NULL && lpm->magicword == LPM_MAGIC_WORD &&
+	    strcmp(lpm->name, name) == 0)
+		return lpm;
+
+	return ODPH_LPM_INVALID;
+}
+
+int odph_lpm_destroy(odph_lpm_t lpm)
+{
+	if (lpm == ODPH_LPM_INVALID || lpm->magicword != LPM_MAGIC_WORD)
+		return -1;
+
+	lpm->magicword = 0;
+	if (odp_shm_free(odp_shm_lookup(lpm->name))) {
+		ODPH_DBG("free fail\n");
+		return -1;
+	}
+
+	return 0;
+}
+
+static int lpm_add(odph_lpm_t lpm, const uint8_t *ip, uint32_t depth,
+		   uint32_t next_hop)
+{
+	uint8_t prefix[ODPH_LPM6_ADDR_LEN];
+	lpm_rule_t *rule;
+	int new_rule = 0;
+
+	if (depth > lpm->addr_len * 8 || next_hop > ODPH_LPM_NEXT_HOP_MAX)
+		return -1;
+
+	prefix_mask(prefix, ip, lpm->addr_len, depth);
+
+	odp_spinlock_lock(&lpm->lock);
+
+	rule = rule_find(lpm, prefix, depth);
+	if (rule == NULL) {
+		rule = rule_insert(lpm, prefix, depth, next_hop);
+		if (rule == NULL) {
+			odp_spinlock_unlock(&lpm->lock);
+			ODPH_DBG("rule table full\n");
+			return -1;
+		}
+		new_rule = 1;
+	}
+
+	/* Fails only while adding groups on the path to the prefix. Those
+	 * groups copy the shorter route, so lookup results are unchanged,
+	 * and are released again. */
+	if (lpm_tbl_add(lpm, prefix, depth, entry_route(depth, next_hop))) {
+		if (new_rule)
+			rule_remove(lpm, rule);
+		odp_spinlock_unlock(&lpm->lock);
+		ODPH_DBG("out of tbl8 groups\n");
+		return -1;
+	}
+
+	rule->next_hop = next_hop;
+
+	odp_spinlock_unlock(&lpm->lock);
+	return 0;
+}
+
+static int lpm_delete(odph_lpm_t lpm, const uint8_t *ip, uint32_t depth)
+{
+	uint8_t prefix[ODPH_LPM6_ADDR_LEN];
+	lpm_rule_t *rule;
+	uint32_t cover = 0;
+
+	if (depth > lpm->addr_len * 8)
+		return -1;
+
+	prefix_mask(prefix, ip, lpm->addr_len, depth);
+
+	odp_spinlock_lock(&lpm->lock);
+
+	rule = rule_find(lpm, prefix, depth);
+	if (rule == NULL) {
+		odp_spinlock_unlock(&lpm->lock);
+		return -1;
+	}
+	rule_remove(lpm, rule);
+
+	rule = rule_cover(lpm, prefix, depth);
+	if (rule)
+		cover = entry_route(rule->depth, rule->next_hop);
+
+	lpm_tbl_del(lpm, prefix, depth, cover);
+
+	odp_spinlock_unlock(&lpm->lock);
+	return 0;
+}
+
+int odph_lpm_reader_online(odph_lpm_t lpm)
+{
+	int thr = odp_thread_id();
+
+	if (lpm == ODPH_LPM_INVALID || thr < 0 || thr >= ODP_THREAD_COUNT_MAX)
+		return -1;
+
+	__atomic_store_n(&lpm->reader[thr].seq,
+			 __atomic_load_n(&lpm->gp_seq, __ATOMIC_SEQ_CST),
+			 __ATOMIC_SEQ_CST);
+	return 0;
+}
+
+void odph_lpm_reader_offline(odph_lpm_t lpm)
+{
+	__atomic_store_n(&lpm->reader[odp_thread_id()].seq, 0,
+			 __ATOMIC_RELEASE);
+}
+
+void odph_lpm_quiescent(odph_lpm_t lpm)
+{
+	lpm_reader_t *reader = &lpm->reader[odp_thread_id()];
+
+	/* Lookups before this point are done, lookups after it see all
+	 * updates of the grace periods before the loaded value */
+	__atomic_store_n(&reader->seq,
+			 __atomic_load_n(&lpm->gp_seq, __ATOMIC_ACQUIRE),
+			 __ATOMIC_RELEASE);
+}
+
+int odph_lpm_add(odph_lpm_t lpm, uint32_t ip, uint8_t depth,
+		 uint32_t next_hop)
+{
+	uint8_t addr[4];
+
+	if (lpm == ODPH_LPM_INVALID || lpm->addr_len != 4)
+		return -1;
+
+	ipv4_to_bytes(addr, ip);
+	return lpm_add(lpm, addr, depth, next_hop);
+}
+
+int odph_lpm_delete(odph_lpm_t lpm, uint32_t ip, uint8_t depth)
+{
+	uint8_t addr[4];
+
+	if (lpm == ODPH_LPM_INVALID || lpm->addr_len != 4)
+		return -1;
+
+	ipv4_to_bytes(addr, ip);
+	return lpm_delete(lpm, addr, depth);
+}
+
+int odph_lpm_lookup_multi(odph_lpm_t lpm, const uint32_t ip[],
+			  uint32_t next_hop[], int num)
+{
+	const uint32_t *tbl = lpm->lookup.tbl;
+	const uint32_t *tbl8 = lpm->lookup.tbl8;
+	int i, found = 0;
+	uint32_t e;
+
+	for (i = 0; i < num && i < LPM_PREFETCH_DIST; i++)
+		odp_prefetch(&tbl[ip[i] >> 8]);
+
+	for (i = 0; i < num; i++) {
+		if (i + LPM_PREFETCH_DIST < num)
+			odp_prefetch(&tbl[ip[i + LPM_PREFETCH_DIST] >> 8]);
+
+		e = entry_load(&tbl[ip[i] >> 8]);
+		if (e & ODPH_LPM_ENTRY_EXT)
+			e = entry_load(&tbl8[((e & ODPH_LPM_ENTRY_NH_MASK) << 8)
+					     | (ip[i] & 0xff)]);
+
+		if (e & ODPH_LPM_ENTRY_VALID) {
+			next_hop[i] = e & ODPH_LPM_ENTRY_NH_MASK;
+			found++;
+		} else {
+			next_hop[i] = ODPH_LPM_NEXT_HOP_INVALID;
+		}
+	}
+
+	return found;
+}
+
+int odph_lpm6_add(odph_lpm_t lpm, const uint8_t ip[ODPH_LPM6_ADDR_LEN],
+		  uint8_t depth, uint32_t next_hop)
+{
+	if (lpm == ODPH_LPM_INVALID || lpm->addr_len != ODPH_LPM6_ADDR_LEN)
+		return -1;
+
+	return lpm_add(lpm, ip, depth, next_hop);
+}
+
+int odph_lpm6_delete(odph_lpm_t lpm, const uint8_t ip[ODPH_LPM6_ADDR_LEN],
+		     uint8_t depth)
+{
+	if (lpm == ODPH_LPM_INVALID || lpm->addr_len != ODPH_LPM6_ADDR_LEN)
+		return -1;
+
+	return lpm_delete(lpm, ip, depth);
+}
+
+static inline uint32_t lpm6_walk(odph_lpm_t lpm, const uint8_t *ip,
+				 uint32_t e)
+{
+	const uint8_t *byte = ip + LPM6_FIRST_BITS / 8;
+
+	while (e & ODPH_LPM_ENTRY_EXT)
+		e = entry_load(&lpm->lookup.tbl8[((e & ODPH_LPM_ENTRY_NH_MASK)
+						  << 8) | *byte++]);
+
+	return e;
+}
+
+int odph_lpm6_lookup(odph_lpm_t lpm, const uint8_t ip[ODPH_LPM6_ADDR_LEN],
+		     uint32_t *next_hop)
+{
+	uint32_t e;
+
+	e = entry_load(&lpm->lookup.tbl[(ip[0] << 8) | ip[1]]);
+	e = lpm6_walk(lpm, ip, e);
+
+	*next_hop = e & ODPH_LPM_ENTRY_NH_MASK;
+	return (e & ODPH_LPM_ENTRY_VALID) ? 0 : -1;
+}
+
+int odph_lpm6_lookup_multi(odph_lpm_t lpm,
+			   const uint8_t ip[][ODPH_LPM6_ADDR_LEN],
+			   uint32_t next_hop[], int num)
+{
+	const uint32_t *tbl = lpm->lookup.tbl;
+	int i, found = 0;
+	uint32_t e;
+
+	for (i = 0; i < num && i < LPM_PREFETCH_DIST; i++)
+		odp_prefetch(&tbl[(ip[i][0] << 8) | ip[i][1]]);
+
+	for (i = 0; i < num; i++) {
+		if (i + LPM_PREFETCH_DIST < num)
+			odp_prefetch(&tbl[(ip[i + LPM_PREFETCH_DIST][0] << 8) |
+					  ip[i + LPM_PREFETCH_DIST][1]]);
+
+		e = entry_load(&tbl[(ip[i][0] << 8) | ip[i][1]]);
+		e = lpm6_walk(lpm, ip[i], e);
+
+		if (e & ODPH_LPM_ENTRY_VALID) {
+			next_hop[i] = e & ODPH_LPM_ENTRY_NH_MASK;
+			found++;
+		} else {
+			next_hop[i] = ODPH_LPM_NEXT_HOP_INVALID;
+		}
+	}
+
+	return found;
+}
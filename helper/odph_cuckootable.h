@@ -0,0 +1,70 @@
+/* Copyright (c) 2017, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+/**
+ * @file
+ *
+ * ODP Cuckoo Hash Table
+ *
+ * Bucketized cuckoo hash table. Every key has two candidate buckets of
+ * eight entries each. Lookups do not take locks: readers check a table
+ * change counter and retry if a writer relocated or removed entries
+ * meanwhile. Writers are serialized by a table lock.
+ */
+
+#ifndef ODPH_CUCKOO_TABLE_H_
+#define ODPH_CUCKOO_TABLE_H_
+
+#include <stdint.h>
+#include <odp/helper/table.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Maximum number of keys in one odph_cuckoo_table_get_value_bulk() call */
+#define ODPH_CUCKOO_TABLE_BULK_MAX 64
+
+odph_table_t odph_cuckoo_table_create(const char *name,
+				      uint32_t capacity,
+				      uint32_t key_size,
+				      uint32_t value_size);
+odph_table_t odph_cuckoo_table_lookup(const char *name);
+int odph_cuckoo_table_destroy(odph_table_t table);
+int odph_cuckoo_table_put_value(odph_table_t table, void *key, void *value);
+int odph_cuckoo_table_get_value(odph_table_t table, void *key, void *buffer,
+				uint32_t buffer_size);
+int odph_cuckoo_table_remove_value(odph_table_t table, void *key);
+
+/**
+ * Lookup multiple keys
+ *
+ * Looks up 'num' keys and copies the values of found keys into the
+ * corresponding buffers. Hash calculation, bucket and key prefetches are
+ * done for all keys before any key is compared.
+ *
+ * @param      table        Table handle
+ * @param      key          Array of 'num' key pointers
+ * @param[out] buffer       Array of 'num' value buffer pointers
+ * @param      buffer_size  Size of each buffer, at least value_size
+ * @param      num          Number of keys (max ODPH_CUCKOO_TABLE_BULK_MAX)
+ * @param[out] hit_mask     Bit 'i' is set when key[i] was found.
+ *                          May be NULL.
+ *
+ * @return Number of keys found
+ * @retval <0 on failure
+ */
+int odph_cuckoo_table_get_value_bulk(odph_table_t table, void *key[],
+				     void *buffer[], uint32_t buffer_size,
+				     int num, uint64_t *hit_mask);
+
+extern odph_table_ops_t odph_cuckoo_table_ops;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
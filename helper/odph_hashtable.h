@@ -30,6 +30,9 @@ int odph_hash_get_value(odph_table_t table, void *key, void *buffer,
 			uint32_t buffer_size);
 int odph_hash_remove_value(odph_table_t table, void *key);
 
+/** Bucket index of a key, hashes all key_size bytes */
+uint16_t odp_key_hash(void *key, uint32_t key_size);
+
 extern odph_table_ops_t odph_hash_table_ops;
 
 #ifdef __cplusplus
@@ -0,0 +1,444 @@
+/* Copyright (c) 2017, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:BSD-3-Clause
+ */
+
+#include <inttypes.h>
+
+#include <test_debug.h>
+#include <../odph_cuckootable.h>
+#include <odp_api.h>
+#include <odp/helper/linux.h>
+
+/** Keys inserted by the load and lookup tests */
+#define NUM_KEYS   20000
+
+/** Keys per odph_cuckoo_table_get_value_bulk() call */
+#define BULK_SIZE  32
+
+/** Keys looked up by the reader thread while the writer runs */
+#define NUM_STABLE 1000
+
+/** Minimum fill and drain rounds of the writer thread */
+#define WRITE_ROUNDS 8
+
+/** Minimum lookup passes of the reader thread over the stable keys */
+#define READ_PASSES  16
+
+/** Flow table entry: IPv4 5-tuple key, 64 bit value */
+typedef struct {
+	uint32_t src_ip;
+	uint32_t dst_ip;
+	uint16_t src_port;
+	uint16_t dst_port;
+	uint8_t  proto;
+	uint8_t  pad[3];
+} flow_key_t;
+
+/** Value of the concurrent test, both words carry the same tag */
+typedef struct {
+	uint64_t tag[2];
+} flow_value_t;
+
+static flow_key_t keys[NUM_KEYS];
+
+static odp_instance_t instance;
+
+static void make_key(flow_key_t *key, uint32_t i)
+{
+	memset(key, 0, sizeof(flow_key_t));
+	key->src_ip = 0x0a000000 | i;
+	key->dst_ip = 0xc0a80000 | (i * 7);
+	key->src_port = i & 0xffff;
+	key->dst_port = 80;
+	key->proto = 17;
+}
+
+static int test_basic(odph_table_ops_t *test_ops)
+{
+	odph_table_t table;
+	char tmp[32];
+	char ip_addr1[] = "12345678";
+	char ip_addr2[] = "11223344";
+	char mac_addr1[16] = "0A1122334401";
+	char mac_addr2[16] = "0A1122334402";
+	char mac_addr4[16] = "0B4433221102";
+
+	table = test_ops->f_create("cuckoo_test", 1, 4, 16);
+	if (table == NULL) {
+		printf("table create fail\n");
+		return -1;
+	}
+
+	if (test_ops->f_create("cuckoo_test", 1, 4, 16) != NULL) {
+		printf("duplicate table create did not fail\n");
+		return -1;
+	}
+
+	if (test_ops->f_put(table, &ip_addr1, mac_addr1) ||
+	    test_ops->f_put(table, &ip_addr2, mac_addr2)) {
+		printf("put value fail\n");
+		return -1;
+	}
+
+	if (test_ops->f_get(table, &ip_addr1, &tmp, 32) ||
+	    strcmp(tmp, mac_addr1) != 0) {
+		printf("get value fail\n");
+		return -1;
+	}
+	printf("\t1  get '1234' tmp = %s,\n", tmp);
+
+	if (test_ops->f_put(table, &ip_addr1, mac_addr4) ||
+	    test_ops->f_get(table, &ip_addr1, &tmp, 32) ||
+	    strcmp(tmp, mac_addr4) != 0) {
+		printf("repeat put value fail\n");
+		return -1;
+	}
+	printf("\t2  repeat get '1234' value = %s\n", tmp);
+
+	if (test_ops->f_get(table, &ip_addr1, &tmp, 8) == 0) {
+		printf("short buffer get did not fail\n");
+		return -1;
+	}
+
+	if (test_ops->f_remove(table, &ip_addr1) ||
+	    test_ops->f_get(table, &ip_addr1, tmp, 32) == 0) {
+		printf("remove value fail\n");
+		return -1;
+	}
+	if (test_ops->f_get(table, &ip_addr2, &tmp, 32) ||
+	    strcmp(tmp, mac_addr2) != 0) {
+		printf("get value fail after remove\n");
+		return -1;
+	}
+	printf("\t3  remove success!\n");
+
+	if (test_ops->f_lookup("cuckoo_test") != table) {
+		printf("lookup table fail!!!\n");
+		return -1;
+	}
+	printf("\t4  lookup table success!\n");
+
+	if (test_ops->f_des(table)) {
+		printf("destroy table fail!!!\n");
+		return -1;
+	}
+	if (test_ops->f_lookup("cuckoo_test") != NULL) {
+		printf("lookup destroyed table did not fail\n");
+		return -1;
+	}
+	printf("\t5  destroy table success!\n");
+
+	return 0;
+}
+
+static int test_load(void)
+{
+	odph_table_t table;
+	flow_key_t key;
+	uint64_t value;
+	uint32_t i, num;
+
+	table = odph_cuckoo_table_create("cuckoo_load", 1, sizeof(flow_key_t),
+					 sizeof(uint64_t));
+	if (table == NULL) {
+		printf("table create fail\n");
+		return -1;
+	}
+
+	/* Fill until the key store or cuckoo paths are exhausted */
+	for (num = 0; ; num++) {
+		make_key(&key, num);
+		value = num;
+		if (odph_cuckoo_table_put_value(table, &key, &value))
+			break;
+	}
+
+	for (i = 0; i < num; i++) {
+		make_key(&key, i);
+		if (odph_cuckoo_table_get_value(table, &key, &value,
+						sizeof(value)) ||
+		    value != i) {
+			printf("key %" PRIu32 " lost at full load\n", i);
+			return -1;
+		}
+	}
+
+	/* Every removed entry must be reusable */
+	for (i = 0; i < num; i += 2) {
+		make_key(&key, i);
+		if (odph_cuckoo_table_remove_value(table, &key)) {
+			printf("remove fail\n");
+			return -1;
+		}
+	}
+	for (i = 0; i < num; i += 2) {
+		make_key(&key, i);
+		value = i;
+		if (odph_cuckoo_table_put_value(table, &key, &value)) {
+			printf("re-insert fail\n");
+			return -1;
+		}
+	}
+
+	printf("\t6  %" PRIu32 " keys of %" PRIu32 " bytes in 1 MB\n", num,
+	       (uint32_t)sizeof(flow_key_t));
+
+	return odph_cuckoo_table_destroy(table);
+}
+
+static int test_bulk(void)
+{
+	odph_table_t table;
+	void *key[BULK_SIZE];
+	void *buf[BULK_SIZE];
+	uint64_t value[BULK_SIZE];
+	uint64_t hit_mask, val;
+	flow_key_t miss;
+	uint32_t i;
+	int j, found;
+
+	table = odph_cuckoo_table_create("cuckoo_bulk", 4, sizeof(flow_key_t),
+					 sizeof(uint64_t));
+	if (table == NULL) {
+		printf("table create fail\n");
+		return -1;
+	}
+
+	for (i = 0; i < NUM_KEYS; i++) {
+		make_key(&keys[i], i);
+		val = i;
+		if (odph_cuckoo_table_put_value(table, &keys[i], &val)) {
+			printf("put value fail\n");
+			return -1;
+		}
+	}
+
+	/* Every other key of the call misses */
+	make_key(&miss, NUM_KEYS + 1);
+	for (j = 0; j < BULK_SIZE; j++) {
+		key[j] = (j & 1) ? (void *)&miss : (void *)&keys[j];
+		buf[j] = &value[j];
+	}
+	found = odph_cuckoo_table_get_value_bulk(table, key, buf,
+						 sizeof(uint64_t), BULK_SIZE,
+						 &hit_mask);
+	if (found != BULK_SIZE / 2 ||
+	    hit_mask != (0x5555555555555555ULL >> (64 - BULK_SIZE))) {
+		printf("bulk lookup with misses fail\n");
+		return -1;
+	}
+	for (j = 0; j < BULK_SIZE; j += 2) {
+		if (value[j] != (uint64_t)j) {
+			printf("bulk lookup value fail\n");
+			return -1;
+		}
+	}
+
+	for (i = 0; i + BULK_SIZE <= NUM_KEYS; i += BULK_SIZE) {
+		for (j = 0; j < BULK_SIZE; j++)
+			key[j] = &keys[i + j];
+
+		found = odph_cuckoo_table_get_value_bulk(table, key, buf,
+							 sizeof(val),
+							 BULK_SIZE, &hit_mask);
+		if (found != BULK_SIZE || hit_mask != (1ULL << BULK_SIZE) - 1) {
+			printf("bulk lookup fail\n");
+			return -1;
+		}
+		for (j = 0; j < BULK_SIZE; j++) {
+			if (value[j] != i + j) {
+				printf("bulk lookup value fail\n");
+				return -1;
+			}
+		}
+	}
+	printf("\t7  bulk lookup of %d keys success!\n", NUM_KEYS);
+
+	return odph_cuckoo_table_destroy(table);
+}
+
+/* Set by the writer when done, read by the reader */
+static odp_atomic_u32_t writer_done;
+
+/* Lookup passes the reader has completed */
+static odp_atomic_u32_t read_passes;
+
+/* Lookups of stable keys that returned a wrong or torn value */
+static odp_atomic_u32_t read_errors;
+
+static int check_value(const flow_value_t *val, uint32_t i)
+{
+	return val->tag[0] != val->tag[1] || (uint32_t)val->tag[0] != i;
+}
+
+static int reader_thread(void *arg)
+{
+	odph_table_t table = arg;
+	void *key[BULK_SIZE];
+	void *buf[BULK_SIZE];
+	flow_value_t value[BULK_SIZE];
+	flow_value_t val;
+	uint64_t hit_mask;
+	uint32_t i, errors = 0;
+	int j;
+
+	for (j = 0; j < BULK_SIZE; j++)
+		buf[j] = &value[j];
+
+	while (!odp_atomic_load_u32(&writer_done)) {
+		for (i = 0; i < NUM_STABLE; i++) {
+			if (odph_cuckoo_table_get_value(table, &keys[i], &val,
+							sizeof(val)) ||
+			    check_value(&val, i))
+				errors++;
+		}
+
+		for (i = 0; i + BULK_SIZE <= NUM_STABLE; i += BULK_SIZE) {
+			for (j = 0; j < BULK_SIZE; j++)
+				key[j] = &keys[i + j];
+
+			if (odph_cuckoo_table_get_value_bulk(table, key, buf,
+							     sizeof(val),
+							     BULK_SIZE,
+							     &hit_mask) !=
+			    BULK_SIZE) {
+				errors++;
+				continue;
+			}
+			for (j = 0; j < BULK_SIZE; j++)
+				errors += check_value(&value[j], i + j);
+		}
+		odp_atomic_inc_u32(&read_passes);
+	}
+
+	odp_atomic_store_u32(&read_errors, errors);
+	return 0;
+}
+
+/* The writer fills the table to the limit, which relocates stable
+ * keys, and overwrites stable values while a reader looks them up
+ * without locking */
+static int test_concurrent(void)
+{
+	odph_odpthread_t thread_tbl[1];
+	odph_odpthread_params_t thr_params;
+	odp_cpumask_t cpumask;
+	odph_table_t table;
+	flow_value_t val;
+	uint32_t i, r, num;
+	int ret = 0;
+
+	table = odph_cuckoo_table_create("cuckoo_rw", 1, sizeof(flow_key_t),
+					 sizeof(flow_value_t));
+	if (table == NULL) {
+		printf("table create fail\n");
+		return -1;
+	}
+
+	for (i = 0; i < NUM_KEYS; i++)
+		make_key(&keys[i], i);
+
+	for (i = 0; i < NUM_STABLE; i++) {
+		val.tag[0] = i;
+		val.tag[1] = i;
+		if (odph_cuckoo_table_put_value(table, &keys[i], &val)) {
+			printf("put value fail\n");
+			return -1;
+		}
+	}
+
+	odp_atomic_init_u32(&writer_done, 0);
+	odp_atomic_init_u32(&read_passes, 0);
+	odp_atomic_init_u32(&read_errors, 0);
+	odp_cpumask_default_worker(&cpumask, 1);
+
+	memset(&thr_params, 0, sizeof(thr_params));
+	thr_params.start = reader_thread;
+	thr_params.arg = table;
+	thr_params.thr_type = ODP_THREAD_WORKER;
+	thr_params.instance = instance;
+
+	if (odph_odpthreads_create(thread_tbl, &cpumask, &thr_params) != 1) {
+		odph_cuckoo_table_destroy(table);
+		return -1;
+	}
+
+	/* Keep writing until the reader has overlapped several rounds */
+	for (r = 0; r < WRITE_ROUNDS ||
+	     odp_atomic_load_u32(&read_passes) < READ_PASSES; r++) {
+		for (num = NUM_STABLE; num < NUM_KEYS; num++) {
+			val.tag[0] = num;
+			val.tag[1] = num;
+			if (odph_cuckoo_table_put_value(table, &keys[num],
+							&val))
+				break;
+		}
+
+		for (i = 0; i < NUM_STABLE; i++) {
+			val.tag[0] = ((uint64_t)(r + 1) << 32) | i;
+			val.tag[1] = val.tag[0];
+			if (odph_cuckoo_table_put_value(table, &keys[i],
+							&val))
+				ret = -1;
+		}
+
+		for (i = NUM_STABLE; i < num; i++) {
+			if (odph_cuckoo_table_remove_value(table, &keys[i]))
+				ret = -1;
+		}
+	}
+
+	odp_atomic_store_u32(&writer_done, 1);
+	odph_odpthreads_join(thread_tbl);
+
+	if (ret || odp_atomic_load_u32(&read_errors)) {
+		printf("concurrent lookup fail, %" PRIu32 " errors\n",
+		       odp_atomic_load_u32(&read_errors));
+		ret = -1;
+	} else {
+		printf("\t8  concurrent lookup success!\n");
+	}
+
+	if (odph_cuckoo_table_destroy(table))
+		ret = -1;
+
+	return ret;
+}
+
+int main(int argc TEST_UNUSED, char *argv[] TEST_UNUSED)
+{
+	int ret = 0;
+
+	ret = odp_init_global(&instance, NULL, NULL);
+	if (ret != 0) {
+		LOG_ERR("odp_shm_init_global fail\n");
+		exit(EXIT_FAILURE);
+	}
+	ret = odp_init_local(instance, ODP_THREAD_WORKER);
+	if (ret != 0) {
+		LOG_ERR("odp_shm_init_local fail\n");
+		exit(EXIT_FAILURE);
+	}
+
+	printf("test cuckoo table:\n");
+
+	if (test_basic(&odph_cuckoo_table_ops) || test_load() || test_bulk() ||
+	    test_concurrent())
+		exit(EXIT_FAILURE);
+
+	printf("all test finished success!!\n");
+
+	if (odp_term_local()) {
+		LOG_ERR("Error: ODP local term failed.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	if (odp_term_global(instance)) {
+		LOG_ERR("Error: ODP global term failed.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	return 0;
+}
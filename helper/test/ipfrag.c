@@ -0,0 +1,433 @@
+/* Copyright (c) 2017, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:BSD-3-Clause
+ */
+
+#include <string.h>
+
+#include <test_debug.h>
+#include <odp_api.h>
+#include <odp/helper/eth.h>
+#include <odp/helper/ip.h>
+#include <odp/helper/ipfrag.h>
+
+/** Largest test datagram */
+#define MAX_PKT_LEN 9000
+
+/** Fragment MTU of the tests */
+#define TEST_MTU 1500
+
+#define MAX_FRAGS 16
+
+static uint8_t orig[MAX_PKT_LEN];
+
+static odp_packet_t build_ipv4(odp_pool_t pool, uint32_t len, uint32_t hl,
+			       uint16_t id)
+{
+	odp_packet_t pkt;
+	odph_ipv4hdr_t *ip = (odph_ipv4hdr_t *)(void *)&orig[ODPH_ETHHDR_LEN];
+	uint32_t i;
+
+	for (i = 0; i < len; i++)
+		orig[i] = i * 7;
+
+	orig[12] = 0x08;
+	orig[13] = 0x00;
+	memset(ip, 0, hl);
+	ip->ver_ihl = (ODPH_IPV4 << 4) | (hl / 4);
+	ip->tot_len = odp_cpu_to_be_16(len - ODPH_ETHHDR_LEN);
+	ip->id = odp_cpu_to_be_16(id);
+	ip->ttl = 64;
+	ip->proto = ODPH_IPPROTO_UDP;
+	ip->src_addr = odp_cpu_to_be_32(0x0a000001);
+	ip->dst_addr = odp_cpu_to_be_32(0x0a000002);
+
+	/* Security option (copied) and record route option (not copied) */
+	if (hl == 32) {
+		uint8_t *opt = (uint8_t *)ip + ODPH_IPV4HDR_LEN;
+
+		opt[0] = 0x82;
+		opt[1] = 4;
+		opt[4] = 0x07;
+		opt[5] = 7;
+		opt[6] = 4;
+		opt[11] = 0;
+	}
+	ip->chksum = 0;
+	ip->chksum = odph_chksum(ip, hl);
+
+	pkt = odp_packet_alloc(pool, len);
+	if (pkt == ODP_PACKET_INVALID)
+		return pkt;
+
+	odp_packet_copy_from_mem(pkt, 0, len, orig);
+	odp_packet_l2_offset_set(pkt, 0);
+	odp_packet_l3_offset_set(pkt, ODPH_ETHHDR_LEN);
+	return pkt;
+}
+
+static odp_packet_t build_ipv6(odp_pool_t pool, uint32_t len)
+{
+	odp_packet_t pkt;
+	odph_ipv6hdr_t *ip = (odph_ipv6hdr_t *)(void *)&orig[ODPH_ETHHDR_LEN];
+	uint8_t *hop = (uint8_t *)ip + ODPH_IPV6HDR_LEN;
+	uint32_t i;
+
+	for (i = 0; i < len; i++)
+		orig[i] = i * 3;
+
+	orig[12] = 0x86;
+	orig[13] = 0xdd;
+	memset(ip, 0, ODPH_IPV6HDR_LEN);
+	ip->ver_tc_flow = odp_cpu_to_be_32(ODPH_IPV6 <<
+					   ODPH_IPV6HDR_VERSION_SHIFT);
+	ip->payload_len = odp_cpu_to_be_16(len - ODPH_ETHHDR_LEN -
+					   ODPH_IPV6HDR_LEN);
+	ip->next_hdr = ODPH_IPPROTO_HOPOPTS;
+	ip->hop_limit = 64;
+	ip->src_addr[15] = 1;
+	ip->dst_addr[15] = 2;
+
+	/* Hop-by-hop options stay in front of the fragment header */
+	hop[0] = ODPH_IPPROTO_UDP;
+	hop[1] = 0;
+
+	pkt = odp_packet_alloc(pool, len);
+	if (pkt == ODP_PACKET_INVALID)
+		return pkt;
+
+	odp_packet_copy_from_mem(pkt, 0, len, orig);
+	odp_packet_l2_offset_set(pkt, 0);
+	odp_packet_l3_offset_set(pkt, ODPH_ETHHDR_LEN);
+	return pkt;
+}
+
+static int check_pkt(odp_packet_t pkt, uint32_t len)
+{
+	uint8_t data[MAX_PKT_LEN];
+
+	if (odp_packet_len(pkt) != len ||
+	    odp_packet_copy_to_mem(pkt, 0, len, data) ||
+	    memcmp(data, orig, len))
+		return -1;
+
+	return 0;
+}
+
+/* Fragment, reassemble in reverse order and compare to the original */
+static int test_frag_reass(odph_ipfrag_tbl_t tbl, odp_packet_t pkt,
+			   uint32_t len, int min_frags)
+{
+	odp_packet_t frag[MAX_FRAGS];
+	uint32_t l3_off;
+	int num, i, ret = 1;
+
+	num = odph_ipfrag_fragment(pkt, TEST_MTU, frag, MAX_FRAGS);
+	if (num < min_frags) {
+		printf("fragment fail: %d\n", num);
+		return -1;
+	}
+
+	for (i = 0; i < num; i++) {
+		l3_off = odp_packet_l3_offset(frag[i]);
+		if (l3_off != ODPH_ETHHDR_LEN ||
+		    odp_packet_len(frag[i]) > l3_off + TEST_MTU ||
+		    !odp_packet_has_ipfrag(frag[i])) {
+			printf("bad fragment %d\n", i);
+			return -1;
+		}
+	}
+
+	for (i = num - 1; i >= 0; i--) {
+		ret = odph_ipfrag_reassemble(tbl, &frag[i]);
+		if ((i > 0 && ret != 1) || (i == 0 && ret != 0)) {
+			printf("reassemble fail: frag %d ret %d\n", i, ret);
+			return -1;
+		}
+	}
+
+	ret = check_pkt(frag[0], len);
+	odp_packet_free(frag[0]);
+	return ret;
+}
+
+static int test_overlap(odph_ipfrag_tbl_t tbl, odp_pool_t pool)
+{
+	odp_packet_t frag[MAX_FRAGS];
+	odp_packet_t dup;
+	int num, i;
+
+	num = odph_ipfrag_fragment(build_ipv4(pool, 4000, ODPH_IPV4HDR_LEN, 3),
+				   TEST_MTU, frag, MAX_FRAGS);
+	if (num < 3)
+		return -1;
+
+	dup = odp_packet_copy(frag[0], pool);
+	if (dup == ODP_PACKET_INVALID)
+		return -1;
+	odp_packet_l3_offset_set(dup, ODPH_ETHHDR_LEN);
+
+	if (odph_ipfrag_reassemble(tbl, &frag[0]) != 1 ||
+	    odph_ipfrag_reassemble(tbl, &dup) >= 0)
+		return -1;
+
+	/* The datagram was dropped: remaining fragments start a new one */
+	for (i = 1; i < num; i++)
+		if (odph_ipfrag_reassemble(tbl, &frag[i]) != 1)
+			return -1;
+
+	return 0;
+}
+
+/* The last fragment ends within 64 kB, but the reassembled datagram
+ * including the IP header does not fit in the 16 bit length field */
+static int test_oversize(odph_ipfrag_tbl_t tbl, odp_pool_t pool)
+{
+	odp_packet_t frag[MAX_FRAGS];
+	uint32_t len;
+	uint16_t fo;
+	int num, i;
+
+	num = odph_ipfrag_fragment(build_ipv4(pool, 4000, ODPH_IPV4HDR_LEN, 5),
+				   TEST_MTU, frag, MAX_FRAGS);
+	if (num < 3)
+		return -1;
+
+	len = odp_packet_len(frag[num - 1]) - ODPH_ETHHDR_LEN -
+	      ODPH_IPV4HDR_LEN;
+	fo = odp_cpu_to_be_16((0xffff - len) / 8);
+	if (len + ((0xffff - len) & ~7u) + ODPH_IPV4HDR_LEN <= 0xffff ||
+	    odp_packet_copy_from_mem(frag[num - 1], ODPH_ETHHDR_LEN + 6,
+				     sizeof(fo), &fo))
+		return -1;
+
+	if (odph_ipfrag_reassemble(tbl, &frag[0]) != 1 ||
+	    odph_ipfrag_reassemble(tbl, &frag[num - 1]) >= 0)
+		return -1;
+
+	/* The datagram was dropped: remaining fragments start a new one */
+	for (i = 1; i < num - 1; i++)
+		if (odph_ipfrag_reassemble(tbl, &frag[i]) != 1)
+			return -1;
+
+	return 0;
+}
+
+static int test_expire(odp_pool_t pool)
+{
+	odph_ipfrag_param_t param;
+	odph_ipfrag_stats_t stats;
+	odph_ipfrag_tbl_t tbl;
+	odp_packet_t frag[MAX_FRAGS];
+	int num;
+
+	odph_ipfrag_param_init(&param);
+	param.max_flows = 16;
+	param.lockless = 1;
+	param.timeout_ns = ODP_TIME_MSEC_IN_NS;
+
+	tbl = odph_ipfrag_tbl_create("ipfrag_expire", &param);
+	if (tbl == ODPH_IPFRAG_TBL_INVALID)
+		return -1;
+
+	num = odph_ipfrag_fragment(build_ipv4(pool, 4000, ODPH_IPV4HDR_LEN, 4),
+				   TEST_MTU, frag, MAX_FRAGS);
+	if (num < 3 || odph_ipfrag_reassemble(tbl, &frag[0]) != 1)
+		return -1;
+
+	odp_time_wait_ns(2 * ODP_TIME_MSEC_IN_NS);
+
+	if (odph_ipfrag_expire(tbl) != 1)
+		return -1;
+
+	odph_ipfrag_stats(tbl, &stats);
+	if (stats.frags != 1 || stats.expired != 1)
+		return -1;
+
+	odp_packet_free_multi(&frag[1], num - 1);
+	return odph_ipfrag_tbl_destroy(tbl);
+}
+
+static int test_timer(odp_pool_t pool)
+{
+	odp_timer_pool_param_t tp_param;
+	odp_pool_param_t pool_param;
+	odph_ipfrag_param_t param;
+	odph_ipfrag_stats_t stats;
+	odph_ipfrag_tbl_t tbl;
+	odp_timer_pool_t tp;
+	odp_pool_t tmo_pool;
+	odp_queue_t queue;
+	odp_packet_t frag[MAX_FRAGS];
+	odp_event_t ev;
+	odp_time_t end;
+	int num;
+
+	odp_pool_param_init(&pool_param);
+	pool_param.type = ODP_POOL_TIMEOUT;
+	pool_param.tmo.num = 4;
+	tmo_pool = odp_pool_create("ipfrag_tmo", &pool_param);
+
+	memset(&tp_param, 0, sizeof(tp_param));
+	tp_param.res_ns = 10 * ODP_TIME_MSEC_IN_NS;
+	tp_param.min_tmo = 10 * ODP_TIME_MSEC_IN_NS;
+	tp_param.max_tmo = ODP_TIME_SEC_IN_NS;
+	tp_param.num_timers = 4;
+	tp_param.priv = 0;
+	tp_param.clk_src = ODP_CLOCK_CPU;
+	tp = odp_timer_pool_create("ipfrag_tp", &tp_param);
+	queue = odp_queue_create("ipfrag_tmo", NULL);
+	if (tmo_pool == ODP_POOL_INVALID || tp == ODP_TIMER_POOL_INVALID ||
+	    queue == ODP_QUEUE_INVALID)
+		return -1;
+	odp_timer_pool_start();
+
+	odph_ipfrag_param_init(&param);
+	param.max_flows = 16;
+	param.timeout_ns = 100 * ODP_TIME_MSEC_IN_NS;
+	param.timer_pool = tp;
+	param.tmo_pool = tmo_pool;
+	param.tmo_queue = queue;
+
+	tbl = odph_ipfrag_tbl_create("ipfrag_timer", &param);
+	if (tbl == ODPH_IPFRAG_TBL_INVALID)
+		return -1;
+
+	num = odph_ipfrag_fragment(build_ipv4(pool, 4000, ODPH_IPV4HDR_LEN, 5),
+				   TEST_MTU, frag, MAX_FRAGS);
+	if (num < 3 || odph_ipfrag_reassemble(tbl, &frag[0]) != 1)
+		return -1;
+	odp_packet_free_multi(&frag[1], num - 1);
+
+	end = odp_time_sum(odp_time_local(),
+			   odp_time_local_from_ns(2 * ODP_TIME_SEC_IN_NS));
+	do {
+		ev = odp_queue_deq(queue);
+		if (ev != ODP_EVENT_INVALID &&
+		    odph_ipfrag_timeout(ev) < 0)
+			return -1;
+		odph_ipfrag_stats(tbl, &stats);
+	} while (stats.expired == 0 &&
+		 odp_time_cmp(end, odp_time_local()) > 0);
+
+	if (stats.expired != 1 || odph_ipfrag_tbl_destroy(tbl))
+		return -1;
+
+	while ((ev = odp_queue_deq(queue)) != ODP_EVENT_INVALID)
+		odp_event_free(ev);
+
+	odp_timer_pool_destroy(tp);
+	if (odp_queue_destroy(queue) || odp_pool_destroy(tmo_pool))
+		return -1;
+
+	return 0;
+}
+
+int main(int argc TEST_UNUSED, char *argv[] TEST_UNUSED)
+{
+	odp_instance_t instance;
+	odp_pool_param_t params;
+	odph_ipfrag_param_t param;
+	odph_ipfrag_tbl_t tbl;
+	odp_pool_t pool;
+	odp_packet_t pkt;
+	int ret;
+
+	ret = odp_init_global(&instance, NULL, NULL);
+	if (ret != 0) {
+		LOG_ERR("odp_shm_init_global fail\n");
+		exit(EXIT_FAILURE);
+	}
+	ret = odp_init_local(instance, ODP_THREAD_WORKER);
+	if (ret != 0) {
+		LOG_ERR("odp_shm_init_local fail\n");
+		exit(EXIT_FAILURE);
+	}
+
+	printf("test ipfrag:\n");
+
+	odp_pool_param_init(&params);
+	params.type = ODP_POOL_PACKET;
+	params.pkt.len = MAX_PKT_LEN;
+	params.pkt.num = 256;
+	pool = odp_pool_create("ipfrag_pool", &params);
+
+	odph_ipfrag_param_init(&param);
+	param.max_flows = 64;
+	param.max_frags = MAX_FRAGS;
+	tbl = odph_ipfrag_tbl_create("ipfrag", &param);
+	if (pool == ODP_POOL_INVALID || tbl == ODPH_IPFRAG_TBL_INVALID ||
+	    odph_ipfrag_tbl_find("ipfrag") != tbl ||
+	    odph_ipfrag_tbl_create("ipfrag", &param) !=
+	    ODPH_IPFRAG_TBL_INVALID) {
+		printf("create fail\n");
+		exit(EXIT_FAILURE);
+	}
+
+	pkt = build_ipv4(pool, 1000, ODPH_IPV4HDR_LEN, 1);
+	if (odph_ipfrag_reassemble(tbl, &pkt) != 0 || check_pkt(pkt, 1000) ||
+	    odph_ipfrag_fragment(pkt, TEST_MTU, &pkt, 1) != 1 ||
+	    check_pkt(pkt, 1000)) {
+		printf("non-fragment fail\n");
+		exit(EXIT_FAILURE);
+	}
+	odp_packet_free(pkt);
+	printf("\t1  non-fragment success!\n");
+
+	if (test_frag_reass(tbl, build_ipv4(pool, MAX_PKT_LEN,
+					    ODPH_IPV4HDR_LEN, 1),
+			    MAX_PKT_LEN, 7) ||
+	    test_frag_reass(tbl, build_ipv4(pool, 3001, 32, 2), 3001, 3)) {
+		printf("IPv4 fragment fail\n");
+		exit(EXIT_FAILURE);
+	}
+	printf("\t2  IPv4 fragment and reassemble success!\n");
+
+	if (test_frag_reass(tbl, build_ipv6(pool, MAX_PKT_LEN), MAX_PKT_LEN,
+			    7) ||
+	    test_frag_reass(tbl, build_ipv6(pool, 1601), 1601, 2)) {
+		printf("IPv6 fragment fail\n");
+		exit(EXIT_FAILURE);
+	}
+	printf("\t3  IPv6 fragment and reassemble success!\n");
+
+	if (test_overlap(tbl, pool)) {
+		printf("overlap fail\n");
+		exit(EXIT_FAILURE);
+	}
+	printf("\t4  overlapping fragments success!\n");
+
+	if (test_oversize(tbl, pool)) {
+		printf("oversize fail\n");
+		exit(EXIT_FAILURE);
+	}
+	printf("\t5  oversized datagram success!\n");
+
+	if (test_expire(pool) || test_timer(pool)) {
+		printf("expire fail\n");
+		exit(EXIT_FAILURE);
+	}
+	printf("\t6  expiry success!\n");
+
+	if (odph_ipfrag_tbl_destroy(tbl) ||
+	    odph_ipfrag_tbl_find("ipfrag") != ODPH_IPFRAG_TBL_INVALID ||
+	    odp_pool_destroy(pool)) {
+		printf("destroy fail\n");
+		exit(EXIT_FAILURE);
+	}
+
+	printf("all test finished success!!\n");
+
+	if (odp_term_local()) {
+		LOG_ERR("Error: ODP local term failed.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	if (odp_term_global(instance)) {
+		LOG_ERR("Error: ODP global term failed.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	return 0;
+}
@@ -0,0 +1,484 @@
+/* Copyright (c) 2017, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:BSD-3-Clause
+ */
+
+#include <inttypes.h>
+
+#include <test_debug.h>
+#include <odp_api.h>
+#include <odp/helper/lpm.h>
+#include <odp/helper/linux.h>
+
+/** Routes in the random tests */
+#define NUM_ROUTES 500
+
+/** Addresses looked up after each update phase */
+#define NUM_LOOKUPS 20000
+
+/** Extension groups of the test tables */
+#define NUM_TBL8 64
+
+typedef struct {
+	uint8_t ip[ODPH_LPM6_ADDR_LEN];
+	uint8_t depth;
+	uint8_t active;
+	uint32_t next_hop;
+} route_t;
+
+static route_t routes[NUM_ROUTES];
+
+static uint32_t rnd_state = 12345;
+
+static odp_instance_t instance;
+
+static uint32_t rnd(void)
+{
+	rnd_state = rnd_state * 1103515245 + 12345;
+	return rnd_state >> 8;
+}
+
+static int prefix_match(const uint8_t *ip, const uint8_t *prefix,
+			uint32_t depth)
+{
+	uint32_t i;
+
+	for (i = 0; depth; i++) {
+		uint8_t mask = depth >= 8 ? 0xff : (uint8_t)(0xff00 >> depth);
+
+		if ((ip[i] ^ prefix[i]) & mask)
+			return 0;
+		depth = depth >= 8 ? depth - 8 : 0;
+	}
+
+	return 1;
+}
+
+/* Longest prefix match by walking all routes */
+static int ref_lookup(const uint8_t *ip, uint32_t *next_hop)
+{
+	int i, best = -1;
+
+	for (i = 0; i < NUM_ROUTES; i++) {
+		if (!routes[i].active ||
+		    !prefix_match(ip, routes[i].ip, routes[i].depth))
+			continue;
+		if (best < 0 || routes[i].depth > routes[best].depth)
+			best = i;
+	}
+
+	if (best < 0)
+		return -1;
+
+	*next_hop = routes[best].next_hop;
+	return 0;
+}
+
+static uint32_t ipv4(const uint8_t *ip)
+{
+	return ((uint32_t)ip[0] << 24) | (ip[1] << 16) | (ip[2] << 8) | ip[3];
+}
+
+/* Random address, usually inside one of the routes */
+static void random_addr(uint8_t *ip, uint32_t len)
+{
+	const route_t *r = &routes[rnd() % NUM_ROUTES];
+	uint32_t i;
+
+	for (i = 0; i < len; i++)
+		ip[i] = rnd();
+
+	if (rnd() % 8 == 0)
+		return;
+
+	for (i = 0; i < r->depth / 8; i++)
+		ip[i] = r->ip[i];
+	if (r->depth % 8)
+		ip[i] = (r->ip[i] & (0xff00 >> (r->depth % 8))) |
+			(ip[i] & (0xff >> (r->depth % 8)));
+}
+
+/* Clustered prefixes so that routes nest and share extension groups */
+static void random_route(route_t *r, uint32_t len)
+{
+	uint32_t i;
+
+	memset(r->ip, 0, sizeof(r->ip));
+	for (i = 0; i < len; i++)
+		r->ip[i] = (i < len / 2) ? (rnd() % 2) : rnd();
+
+	/* Short IPv4 prefixes expand to many first level entries */
+	if (len == 4)
+		r->depth = (rnd() % 2) ? 20 + rnd() % 13 : 8 + rnd() % 25;
+	else
+		r->depth = rnd() % (len * 8 + 1);
+	r->next_hop = rnd() & ODPH_LPM_NEXT_HOP_MAX;
+}
+
+static int check_lookups(odph_lpm_t lpm, uint32_t len)
+{
+	uint8_t ip[ODPH_LPM6_ADDR_LEN];
+	uint8_t ip6[8][ODPH_LPM6_ADDR_LEN];
+	uint32_t ip4[8], nh_multi[8];
+	uint32_t nh, ref_nh;
+	int i, j, ret, ref;
+
+	for (i = 0; i < NUM_LOOKUPS; i += 8) {
+		for (j = 0; j < 8; j++) {
+			random_addr(ip, len);
+			memcpy(ip6[j], ip, ODPH_LPM6_ADDR_LEN);
+			ip4[j] = ipv4(ip);
+		}
+
+		if (len == 4)
+			odph_lpm_lookup_multi(lpm, ip4, nh_multi, 8);
+		else
+			odph_lpm6_lookup_multi(lpm, (const uint8_t (*)[16])ip6,
+					       nh_multi, 8);
+
+		for (j = 0; j < 8; j++) {
+			if (len == 4)
+				ret = odph_lpm_lookup(lpm, ip4[j], &nh);
+			else
+				ret = odph_lpm6_lookup(lpm, ip6[j], &nh);
+
+			ref_nh = 0;
+			ref = ref_lookup(ip6[j], &ref_nh);
+
+			if (ret != ref || (ref == 0 && nh != ref_nh)) {
+				printf("lookup mismatch: ret %i ref %i nh %"
+				       PRIu32 " ref_nh %" PRIu32 "\n", ret, ref,
+				       nh, ref_nh);
+				return -1;
+			}
+
+			if ((ref == 0 && nh_multi[j] != ref_nh) ||
+			    (ref != 0 &&
+			     nh_multi[j] != ODPH_LPM_NEXT_HOP_INVALID)) {
+				printf("multi lookup mismatch\n");
+				return -1;
+			}
+		}
+	}
+
+	return 0;
+}
+
+static int route_add(odph_lpm_t lpm, uint32_t len, route_t *r)
+{
+	if (len == 4)
+		return odph_lpm_add(lpm, ipv4(r->ip), r->depth, r->next_hop);
+
+	return odph_lpm6_add(lpm, r->ip, r->depth, r->next_hop);
+}
+
+static int route_del(odph_lpm_t lpm, uint32_t len, route_t *r)
+{
+	if (len == 4)
+		return odph_lpm_delete(lpm, ipv4(r->ip), r->depth);
+
+	return odph_lpm6_delete(lpm, r->ip, r->depth);
+}
+
+static void mask_route(route_t *r, uint32_t len)
+{
+	uint32_t i, depth = r->depth;
+
+	for (i = 0; i < len; i++) {
+		if (depth < 8)
+			r->ip[i] &= (uint8_t)(0xff00 >> depth);
+		depth = depth >= 8 ? depth - 8 : 0;
+	}
+}
+
+static int test_random(odph_lpm_t lpm, uint32_t len)
+{
+	int i, j, round;
+
+	memset(routes, 0, sizeof(routes));
+
+	for (round = 0; round < 4; round++) {
+		/* Add routes. Table may run out of groups. */
+		for (i = 0; i < NUM_ROUTES; i++) {
+			route_t *r = &routes[i];
+
+			if (r->active)
+				continue;
+
+			random_route(r, len);
+			mask_route(r, len);
+
+			/* Same prefix as an active route replaces it */
+			for (j = 0; j < NUM_ROUTES; j++) {
+				if (j != i && routes[j].active &&
+				    routes[j].depth == r->depth &&
+				    !memcmp(routes[j].ip, r->ip, len))
+					routes[j].active = 0;
+			}
+
+			r->active = route_add(lpm, len, r) == 0;
+		}
+
+		if (check_lookups(lpm, len))
+			return -1;
+
+		/* Delete about half of the routes */
+		for (i = 0; i < NUM_ROUTES; i++) {
+			if (!routes[i].active || rnd() % 2)
+				continue;
+
+			if (route_del(lpm, len, &routes[i])) {
+				printf("delete fail\n");
+				return -1;
+			}
+			routes[i].active = 0;
+
+			if (route_del(lpm, len, &routes[i]) == 0) {
+				printf("delete of a deleted route did not fail\n");
+				return -1;
+			}
+		}
+
+		if (check_lookups(lpm, len))
+			return -1;
+	}
+
+	/* All groups must be returned when the table is emptied. Then
+	 * routes that need all groups are added. */
+	for (i = 0; i < NUM_ROUTES; i++) {
+		if (routes[i].active && route_del(lpm, len, &routes[i])) {
+			printf("delete fail\n");
+			return -1;
+		}
+		routes[i].active = 0;
+	}
+
+	for (i = 0; i < NUM_TBL8; i++) {
+		route_t *r = &routes[i];
+
+		memset(r->ip, 0, sizeof(r->ip));
+		r->ip[0] = i;
+		r->depth = len * 8;
+		r->next_hop = i;
+		r->active = 1;
+		if (route_add(lpm, len, r)) {
+			printf("extension groups lost\n");
+			return -1;
+		}
+	}
+
+	return check_lookups(lpm, len);
+}
+
+/* Routes of the group reuse test, 20XX:db8::/depth */
+static int route6_add(odph_lpm_t lpm, uint8_t byte, uint8_t depth)
+{
+	uint8_t ip[ODPH_LPM6_ADDR_LEN] = {0x20, 0x00, 0x0d, 0xb8};
+
+	ip[1] = byte;
+	return odph_lpm6_add(lpm, ip, depth, byte);
+}
+
+static int route6_del(odph_lpm_t lpm, uint8_t byte, uint8_t depth)
+{
+	uint8_t ip[ODPH_LPM6_ADDR_LEN] = {0x20, 0x00, 0x0d, 0xb8};
+
+	ip[1] = byte;
+	return odph_lpm6_delete(lpm, ip, depth);
+}
+
+/* Steps of the grace period test */
+static odp_atomic_u32_t reader_step;
+
+#define STEP_ONLINE    1
+#define STEP_RELEASED  2
+#define STEP_QUIESCENT 3
+
+static int reader_thread(void *arg)
+{
+	odph_lpm_t lpm = arg;
+
+	if (odph_lpm_reader_online(lpm))
+		return -1;
+	odp_atomic_store_u32(&reader_step, STEP_ONLINE);
+
+	while (odp_atomic_load_u32(&reader_step) != STEP_RELEASED)
+		odp_cpu_pause();
+
+	/* The updater must not reuse the released group meanwhile */
+	odp_time_wait_ns(50 * ODP_TIME_MSEC_IN_NS);
+
+	odp_atomic_store_u32(&reader_step, STEP_QUIESCENT);
+	odph_lpm_quiescent(lpm);
+	odph_lpm_reader_offline(lpm);
+	return 0;
+}
+
+/* A route needs one group per 8 bits below /16 */
+static int test_tbl8_reuse(void)
+{
+	odph_odpthread_t thread_tbl[1];
+	odph_odpthread_params_t thr_params;
+	odp_cpumask_t cpumask;
+	odph_lpm_t lpm;
+	int ret = 0;
+
+	lpm = odph_lpm6_create("lpm6_reuse", 16, 2);
+	if (lpm == ODPH_LPM_INVALID)
+		return -1;
+
+	/* Needs three groups, the two allocated ones are released */
+	if (route6_add(lpm, 1, 40) == 0 || route6_add(lpm, 1, 32) ||
+	    route6_del(lpm, 1, 32)) {
+		printf("groups of a failed add lost\n");
+		ret = -1;
+		goto destroy;
+	}
+
+	if (route6_add(lpm, 2, 24)) {
+		ret = -1;
+		goto destroy;
+	}
+
+	odp_atomic_init_u32(&reader_step, 0);
+	odp_cpumask_default_worker(&cpumask, 1);
+
+	memset(&thr_params, 0, sizeof(thr_params));
+	thr_params.start = reader_thread;
+	thr_params.arg = lpm;
+	thr_params.thr_type = ODP_THREAD_WORKER;
+	thr_params.instance = instance;
+
+	if (odph_odpthreads_create(thread_tbl, &cpumask, &thr_params) != 1) {
+		ret = -1;
+		goto destroy;
+	}
+
+	while (odp_atomic_load_u32(&reader_step) != STEP_ONLINE)
+		odp_cpu_pause();
+
+	/* Releases one group, the other one is still free. The second add
+	 * needs both. */
+	if (route6_del(lpm, 2, 24)) {
+		ret = -1;
+	} else {
+		odp_atomic_store_u32(&reader_step, STEP_RELEASED);
+		if (route6_add(lpm, 3, 32) ||
+		    odp_atomic_load_u32(&reader_step) != STEP_QUIESCENT) {
+			printf("group reused before a grace period\n");
+			ret = -1;
+		}
+	}
+
+	odph_odpthreads_join(thread_tbl);
+
+destroy:
+	odph_lpm_destroy(lpm);
+	return ret;
+}
+
+int main(int argc TEST_UNUSED, char *argv[] TEST_UNUSED)
+{
+	odph_lpm_t lpm;
+	uint32_t nh;
+	int ret;
+
+	ret = odp_init_global(&instance, NULL, NULL);
+	if (ret != 0) {
+		LOG_ERR("odp_shm_init_global fail\n");
+		exit(EXIT_FAILURE);
+	}
+	ret = odp_init_local(instance, ODP_THREAD_WORKER);
+	if (ret != 0) {
+		LOG_ERR("odp_shm_init_local fail\n");
+		exit(EXIT_FAILURE);
+	}
+
+	printf("test lpm:\n");
+
+	lpm = odph_lpm_create("lpm4", NUM_ROUTES, NUM_TBL8);
+	if (lpm == ODPH_LPM_INVALID || odph_lpm_find("lpm4") != lpm ||
+	    odph_lpm_create("lpm4", NUM_ROUTES, NUM_TBL8) != ODPH_LPM_INVALID) {
+		printf("create fail\n");
+		exit(EXIT_FAILURE);
+	}
+
+	/* 10.0.0.0/8 -> 1, 10.1.1.0/24 -> 2, 10.1.1.128/25 -> 3 */
+	if (odph_lpm_add(lpm, 0x0a000000, 8, 1) ||
+	    odph_lpm_add(lpm, 0x0a010100, 24, 2) ||
+	    odph_lpm_add(lpm, 0x0a010180, 25, 3) ||
+	    odph_lpm_add(lpm, 0x0a010180, 25, ODPH_LPM_NEXT_HOP_MAX + 1) == 0 ||
+	    odph_lpm6_add(lpm, routes[0].ip, 8, 1) == 0) {
+		printf("add fail\n");
+		exit(EXIT_FAILURE);
+	}
+	if (odph_lpm_lookup(lpm, 0x0a020304, &nh) || nh != 1 ||
+	    odph_lpm_lookup(lpm, 0x0a010105, &nh) || nh != 2 ||
+	    odph_lpm_lookup(lpm, 0x0a0101f0, &nh) || nh != 3 ||
+	    odph_lpm_lookup(lpm, 0x0b000000, &nh) == 0) {
+		printf("lookup fail\n");
+		exit(EXIT_FAILURE);
+	}
+	if (odph_lpm_delete(lpm, 0x0a010100, 24) ||
+	    odph_lpm_lookup(lpm, 0x0a010105, &nh) || nh != 1 ||
+	    odph_lpm_lookup(lpm, 0x0a0101f0, &nh) || nh != 3) {
+		printf("delete fail\n");
+		exit(EXIT_FAILURE);
+	}
+	if (odph_lpm_add(lpm, 0, 0, 9) ||
+	    odph_lpm_lookup(lpm, 0x0b000000, &nh) || nh != 9 ||
+	    odph_lpm_lookup(lpm, 0x0a0101f0, &nh) || nh != 3 ||
+	    odph_lpm_delete(lpm, 0, 0) ||
+	    odph_lpm_lookup(lpm, 0x0b000000, &nh) == 0) {
+		printf("default route fail\n");
+		exit(EXIT_FAILURE);
+	}
+	printf("\t1  basic IPv4 routes success!\n");
+
+	if (odph_lpm_delete(lpm, 0x0a000000, 8) ||
+	    odph_lpm_delete(lpm, 0x0a010180, 25) ||
+	    test_random(lpm, 4)) {
+		printf("random IPv4 routes fail\n");
+		exit(EXIT_FAILURE);
+	}
+	printf("\t2  random IPv4 routes success!\n");
+
+	if (odph_lpm_destroy(lpm) ||
+	    odph_lpm_find("lpm4") != ODPH_LPM_INVALID) {
+		printf("destroy fail\n");
+		exit(EXIT_FAILURE);
+	}
+
+	lpm = odph_lpm6_create("lpm6", NUM_ROUTES, NUM_TBL8 * 16);
+	if (lpm == ODPH_LPM_INVALID || test_random(lpm, ODPH_LPM6_ADDR_LEN)) {
+		printf("random IPv6 routes fail\n");
+		exit(EXIT_FAILURE);
+	}
+	printf("\t3  random IPv6 routes success!\n");
+
+	if (odph_lpm_destroy(lpm)) {
+		printf("destroy fail\n");
+		exit(EXIT_FAILURE);
+	}
+
+	if (test_tbl8_reuse()) {
+		printf("extension group reuse fail\n");
+		exit(EXIT_FAILURE);
+	}
+	printf("\t4  extension group reuse success!\n");
+
+	printf("all test finished success!!\n");
+
+	if (odp_term_local()) {
+		LOG_ERR("Error: ODP local term failed.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	if (odp_term_global(instance)) {
+		LOG_ERR("Error: ODP global term failed.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	return 0;
+}
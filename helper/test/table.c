@@ -4,6 +4,8 @@
  * SPDX-License-Identifier:BSD-3-Clause
  */
 
+#include <inttypes.h>
+
 #include <test_debug.h>
 #include <../odph_hashtable.h>
 #include <../odph_lineartable.h>
@@ -25,6 +27,95 @@
  * value (data): MAC address of the next hop station (6 bytes).
  */
 
+/* Keys that differ only after the first byte must spread over buckets */
+static int test_key_hash(void)
+{
+	uint8_t key[4] = {'1', '2', '3', 0};
+	uint16_t hash[256];
+	int i, j;
+
+	for (i = 0; i < 256; i++) {
+		key[3] = i;
+		hash[i] = odp_key_hash(key, sizeof(key));
+		for (j = 0; j < i; j++) {
+			if (hash[j] == hash[i]) {
+				printf("keys %d and %d share a bucket\n", j, i);
+				return -1;
+			}
+		}
+	}
+	printf("\t6  key hash success!\n");
+
+	return 0;
+}
+
+/* Removed nodes return to the free list and are reused, updates of
+ * existing keys do not take nodes */
+static int test_free_list(void)
+{
+	odph_table_t table;
+	uint32_t key, num, i;
+	uint64_t value[2];
+
+	table = odph_hash_table_create("test_free", 2, sizeof(key),
+				       sizeof(value));
+	if (table == NULL) {
+		printf("table create fail\n");
+		return -1;
+	}
+
+	for (num = 0; ; num++) {
+		key = num;
+		value[0] = num;
+		value[1] = num;
+		if (odph_hash_put_value(table, &key, value))
+			break;
+	}
+
+	key = 0;
+	value[0] = 1;
+	if (num == 0 || odph_hash_put_value(table, &key, value)) {
+		printf("update of a full table fail\n");
+		return -1;
+	}
+
+	for (i = 0; i < num; i++) {
+		key = i;
+		if (odph_hash_remove_value(table, &key)) {
+			printf("remove value fail\n");
+			return -1;
+		}
+	}
+
+	/* Every node is free again, exactly once */
+	for (i = 0; i < num; i++) {
+		key = num + i;
+		value[0] = i;
+		value[1] = i;
+		if (odph_hash_put_value(table, &key, value)) {
+			printf("put of a freed node fail\n");
+			return -1;
+		}
+	}
+	key = 2 * num;
+	if (odph_hash_put_value(table, &key, value) == 0) {
+		printf("put beyond capacity did not fail\n");
+		return -1;
+	}
+
+	for (i = 0; i < num; i++) {
+		key = num + i;
+		if (odph_hash_get_value(table, &key, value, sizeof(value)) ||
+		    value[0] != i || value[1] != i) {
+			printf("get value fail\n");
+			return -1;
+		}
+	}
+	printf("\t7  %" PRIu32 " nodes reused success!\n", num);
+
+	return odph_hash_table_destroy(table);
+}
+
 int main(int argc TEST_UNUSED, char *argv[] TEST_UNUSED)
 {
 	odp_instance_t instance;
@@ -36,10 +127,10 @@ int main(int argc TEST_UNUSED, char *argv[] TEST_UNUSED)
 	char ip_addr1[] = "12345678";
 	char ip_addr2[] = "11223344";
 	char ip_addr3[] = "55667788";
-	char mac_addr1[] = "0A1122334401";
-	char mac_addr2[] = "0A1122334402";
-	char mac_addr3[] = "0B4433221101";
-	char mac_addr4[] = "0B4433221102";
+	char mac_addr1[16] = "0A1122334401";
+	char mac_addr2[16] = "0A1122334402";
+	char mac_addr3[16] = "0B4433221101";
+	char mac_addr4[16] = "0B4433221102";
 
 	ret = odp_init_global(&instance, NULL, NULL);
 	if (ret != 0) {
@@ -118,6 +209,9 @@ int main(int argc TEST_UNUSED, char *argv[] TEST_UNUSED)
 	}
 	printf("\t5  destroy table success!\n");
 
+	if (test_key_hash() || test_free_list())
+		exit(EXIT_FAILURE);
+
 	printf("all test finished success!!\n");
 
 	if (odp_term_local()) {
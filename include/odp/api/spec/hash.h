@@ -53,6 +53,103 @@ uint32_t odp_hash_crc32(const void *data, uint32_t data_len, uint32_t init_val);
 uint32_t odp_hash_crc32c(const void *data, uint32_t data_len,
 			 uint32_t init_val);
 
+/**
+* Calculate CRC-32C for multiple keys
+*
+* Calculates CRC-32C over 'num' keys of equal length. The result for each
+* key is the same as returned by odp_hash_crc32c(), but the implementation
+* may process keys in parallel. Use this to hash a burst of lookup keys.
+*
+* @param      data       Array of 'num' pointers to key data
+* @param      data_len   Length of each key in bytes
+* @param      init_val   CRC generator initialization value
+* @param[out] hash       Array of 'num' CRC32C values for output
+* @param      num        Number of keys
+*/
+void odp_hash_crc32c_multi(const void *data[], uint32_t data_len,
+			   uint32_t init_val, uint32_t hash[], int num);
+
+/** Length of the default Toeplitz (RSS) hash key in bytes */
+#define ODP_HASH_TOEPLITZ_KEY_LEN 40
+
+/**
+* Calculate Toeplitz hash
+*
+* Calculates the Toeplitz hash used by NICs for receive side scaling (RSS).
+* When 'data' contains the fields in the order NICs use (source address,
+* destination address, source port, destination port, all in network byte
+* order), the result matches the hash value computed by NIC hardware that
+* is configured with the same key. Key bits beyond 'key_len' are treated as
+* zero, so the key should be at least 'data_len' + 4 bytes long.
+*
+* @param data       Pointer to data
+* @param data_len   Data length in bytes
+* @param key        Hash key, or NULL to use the default RSS key
+*                   (ODP_HASH_TOEPLITZ_KEY_LEN bytes)
+* @param key_len    Key length in bytes. Ignored when 'key' is NULL.
+*
+* @return Toeplitz hash value
+*/
+uint32_t odp_hash_toeplitz(const void *data, uint32_t data_len,
+			   const uint8_t *key, uint32_t key_len);
+
+/**
+* Calculate 32-bit xxHash
+*
+* Calculates the XXH32 hash over the data. This is a fast,
+* non-cryptographic hash suitable for hash table lookups.
+*
+* @param data       Pointer to data
+* @param data_len   Data length in bytes
+* @param seed       Hash seed
+*
+* @return XXH32 hash value
+*/
+uint32_t odp_hash_xxh32(const void *data, uint32_t data_len, uint32_t seed);
+
+/**
+* Calculate 32-bit xxHash for multiple keys
+*
+* Calculates XXH32 over 'num' keys of equal length. The result for each key
+* is the same as returned by odp_hash_xxh32(), but the implementation may
+* process multiple keys in parallel (e.g. in SIMD lanes).
+*
+* @param      data       Array of 'num' pointers to key data
+* @param      data_len   Length of each key in bytes
+* @param      seed       Hash seed
+* @param[out] hash       Array of 'num' hash values for output
+* @param      num        Number of keys
+*/
+void odp_hash_xxh32_multi(const void *data[], uint32_t data_len,
+			  uint32_t seed, uint32_t hash[], int num);
+
+/**
+* Calculate 64-bit xxHash
+*
+* Calculates the XXH64 hash over the data.
+*
+* @param data       Pointer to data
+* @param data_len   Data length in bytes
+* @param seed       Hash seed
+*
+* @return XXH64 hash value
+*/
+uint64_t odp_hash_xxh64(const void *data, uint32_t data_len, uint64_t seed);
+
+/**
+* Calculate Jenkins hash
+*
+* Calculates Bob Jenkins' lookup3 hash (hashlittle()) over the data.
+*
+* @param data       Pointer to data
+* @param data_len   Data length in bytes
+* @param init_val   Hash initialization value
+*
+* @return Jenkins hash value
+*/
+uint32_t odp_hash_jhash(const void *data, uint32_t data_len,
+			uint32_t init_val);
+
 /**
 * CRC parameters
 *
@@ -854,6 +854,94 @@ int odp_packet_concat(odp_packet_t *dst, odp_packet_t src);
  */
 int odp_packet_split(odp_packet_t *pkt, uint32_t len, odp_packet_t *tail);
 
+/*
+ *
+ * References
+ * ********************************************************
+ *
+ */
+
+/**
+ * Create a static reference to a packet
+ *
+ * A static reference is a new packet handle that shares all data of
+ * the packet, including headroom and tailroom. Metadata of the packet is
+ * copied to the reference. It is intended for sending the same packet
+ * multiple times, e.g. to all ports of a broadcast domain or for
+ * retransmission, without copying packet data.
+ *
+ * Neither the packet nor the reference may be modified as long as both
+ * exist. Packet memory is released when the last of them is freed.
+ *
+ * @param pkt    Packet handle
+ *
+ * @return Static reference to the packet
+ * @retval ODP_PACKET_INVALID on failure
+ */
+odp_packet_t odp_packet_ref_static(odp_packet_t pkt);
+
+/**
+ * Create a reference to a packet
+ *
+ * Create a new packet that shares packet data starting from 'offset' with
+ * the packet. The new packet has its own metadata, which is initialized with
+ * default values, and its own headroom. Packet head manipulation functions
+ * (e.g. odp_packet_push_head() and odp_packet_extend_head()) may be used to
+ * add unique headers in front of the shared data.
+ *
+ * The shared data is read only. Packet data modification functions (e.g.
+ * odp_packet_copy_from_mem()) and tail manipulation functions copy the
+ * shared data they modify (copy-on-write). Shared data must not be modified
+ * through data pointers. The packet 'pkt' may itself be a reference.
+ *
+ * The packet is not modified on failure.
+ *
+ * @param pkt    Packet handle
+ * @param offset Byte offset into the packet where the shared data begins.
+ *               Must be less than odp_packet_len(pkt).
+ *
+ * @return New reference to the packet
+ * @retval ODP_PACKET_INVALID on failure
+ */
+odp_packet_t odp_packet_ref(odp_packet_t pkt, uint32_t offset);
+
+/**
+ * Create a reference to a packet with a header packet
+ *
+ * As odp_packet_ref(), but data of the 'hdr' packet is prepended to
+ * the shared data. The new reference has metadata of the header packet.
+ * Both packets must be allocated from the same pool, and the header packet
+ * must not share data with other packets.
+ *
+ * The header packet is consumed on success, and its handle must not be used
+ * after that. The packets are not modified on failure.
+ *
+ * @param pkt    Packet handle
+ * @param offset Byte offset into the packet where the shared data begins.
+ *               Must be less than odp_packet_len(pkt).
+ * @param hdr    Header packet handle
+ *
+ * @return New reference to the packet
+ * @retval ODP_PACKET_INVALID on failure
+ */
+odp_packet_t odp_packet_ref_pkt(odp_packet_t pkt, uint32_t offset,
+				odp_packet_t hdr);
+
+/**
+ * Test if packet shares data with other packets
+ *
+ * Both the packet and its references share data after a successful
+ * odp_packet_ref_static(), odp_packet_ref() or odp_packet_ref_pkt() call.
+ * A packet shares data until other packets sharing the data have been
+ * freed, or all shared data has been copied on write.
+ *
+ * @param pkt    Packet handle
+ *
+ * @retval 0  Packet does not share data with other packets
+ * @retval 1  Packet shares data with other packets
+ */
+int odp_packet_has_ref(odp_packet_t pkt);
+
 /*
  *
  * Copy
@@ -1269,6 +1357,32 @@ uint32_t odp_packet_flow_hash(odp_packet_t pkt);
  */
 void odp_packet_flow_hash_set(odp_packet_t pkt, uint32_t flow_hash);
 
+/**
+ * Calculate flow hash for multiple packets
+ *
+ * Calculates a Toeplitz (RSS compatible) hash for each packet and stores it
+ * as with odp_packet_flow_hash_set(). The hash input is the IPv4 or IPv6
+ * source and destination address followed by the TCP or UDP source and
+ * destination port. Ports are left out for other L4 protocols and for IP
+ * fragments. With the same key the result matches the RSS hash of NICs
+ * that hash the same fields.
+ *
+ * Header locations are taken from the packet parse results (packet input
+ * parsing, or layer offsets and flags set by the application). Packets
+ * without an IPv4 or IPv6 header are not modified.
+ *
+ * @param pkt      Array of packet handles
+ * @param num      Number of packets
+ * @param key      Toeplitz hash key, or NULL to use the default RSS key
+ * @param key_len  Key length in bytes. Ignored when 'key' is NULL.
+ *
+ * @return Number of packets for which flow hash was set
+ *
+ * @see odp_hash_toeplitz()
+ */
+int odp_packet_flow_hash_calc_multi(const odp_packet_t pkt[], int num,
+				    const uint8_t *key, uint32_t key_len);
+
 /**
  * Packet timestamp
  *
@@ -297,6 +297,27 @@ typedef union odp_pktin_config_opt_t {
 		/** Drop packets with a SCTP error on packet input */
 		uint64_t drop_sctp_err : 1;
 
+		/** Coalesce TCP segments on packet input
+		  *
+		  * Consecutive in-order segments of the same TCP connection
+		  * received in the same burst are merged into a single packet
+		  * with updated IP and TCP headers and checksums. Segments
+		  * with other flags than ACK and PSH set are not merged. */
+		uint64_t tcp_coalesce  : 1;
+
+		/** Timestamp a packet input burst with a single time read
+		  *
+		  * With ts_all or ts_ptp, packets received by the same call
+		  * share one timestamp instead of reading time per packet. */
+		uint64_t ts_batch      : 1;
+
+		/** Interpolate batch timestamps
+		  *
+		  * With ts_batch, timestamps of a burst are spread around the
+		  * single time read by the packet arrival times recorded by
+		  * the interface, instead of all packets sharing one value. */
+		uint64_t ts_interp     : 1;
+
 	} bit;
 
 	/** All bits of the bit field structure
@@ -335,6 +356,24 @@ typedef union odp_pktout_config_opt_t {
 		/** Insert SCTP checksum on packet output */
 		uint64_t sctp_chksum  : 1;
 
+		/** Segment TCP packets on packet output
+		  *
+		  * A TCP packet whose IP packet does not fit into the interface
+		  * MTU is split into multiple TCP segments. Each segment
+		  * carries a copy of the L2, IP and TCP headers, with IP
+		  * length, IPv4 ID, TCP sequence number, TCP flags and
+		  * checksums updated. Packet metadata must provide valid L3
+		  * and L4 offsets, or the packet must be parseable from L2. */
+		uint64_t tcp_seg      : 1;
+
+		/** Segment UDP packets on packet output
+		  *
+		  * A UDP packet whose IP packet does not fit into the interface
+		  * MTU is split into multiple UDP datagrams, each one with a
+		  * copy of the L2, IP and UDP headers and updated lengths and
+		  * checksums. */
+		uint64_t udp_seg      : 1;
+
 	} bit;
 
 	/** All bits of the bit field structure
@@ -344,6 +383,29 @@ typedef union odp_pktout_config_opt_t {
 	uint64_t all_bits;
 } odp_pktout_config_opt_t;
 
+/**
+ * Packet input parse depth
+ *
+ * Protocol layers that are parsed on packet input. Packet metadata of deeper
+ * layers (e.g. odp_packet_l4_offset() or odp_packet_has_udp()) is still
+ * available: the packet is parsed on demand when the application asks for it.
+ * Applications that do not look at packet headers, or look only at some
+ * packets, save the cost of parsing on input.
+ */
+typedef enum odp_pktio_parse_depth_t {
+	/** No parsing on packet input */
+	ODP_PKTIO_PARSE_NONE = 0,
+
+	/** Parse layer 2 headers (e.g. Ethernet and VLAN) */
+	ODP_PKTIO_PARSE_L2,
+
+	/** Parse layer 2 and 3 headers (e.g. IPv4 and IPv6) */
+	ODP_PKTIO_PARSE_L3,
+
+	/** Parse layer 2, 3 and 4 headers (e.g. TCP and UDP) */
+	ODP_PKTIO_PARSE_L4
+} odp_pktio_parse_depth_t;
+
 /**
  * Packet IO configuration options
  *
@@ -362,6 +424,23 @@ typedef struct odp_pktio_config_t {
 	 *  Default value for all bits is zero. */
 	odp_pktout_config_opt_t pktout;
 
+	/** Maximum payload length of segments created on packet output
+	 *
+	 *  Limits the L4 payload length of each segment when TCP or UDP
+	 *  segmentation is enabled. Zero selects the largest payload that
+	 *  fits into the interface MTU, larger values are limited to that.
+	 *  Default value is zero. */
+	uint32_t pktout_seg_len;
+
+	/** Packet input parse depth
+	 *
+	 *  Protocol layers parsed on packet input. Classification may parse
+	 *  deeper layers when its rules need them. In capabilities, the
+	 *  deepest layer supported. Default value is ODP_PKTIO_PARSE_L2,
+	 *  applications that use deeper layers of most packets opt in to
+	 *  parsing them on input. */
+	odp_pktio_parse_depth_t parse_depth;
+
 	/** Interface loopback mode
 	 *
 	 * In this mode the packets sent out through the interface is
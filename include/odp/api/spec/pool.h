@@ -39,6 +39,34 @@ extern "C" {
 /** Maximum queue name length in chars */
 #define ODP_POOL_NAME_LEN  32
 
+/**
+ * Pool statistics counters
+ *
+ * Selects pool statistics counters in pool capability and parameters.
+ */
+typedef union odp_pool_stats_opt_t {
+	/** Counter bits */
+	struct {
+		/** @see odp_pool_stats_t::available */
+		uint64_t available      : 1;
+
+		/** @see odp_pool_stats_t::alloc_fails */
+		uint64_t alloc_fails    : 1;
+
+		/** @see odp_pool_stats_t::recycle_hits */
+		uint64_t recycle_hits   : 1;
+
+		/** @see odp_pool_stats_t::recycle_misses */
+		uint64_t recycle_misses : 1;
+	} bit;
+
+	/** All bits of the bit field structure
+	 *
+	 *  This field can be used to set/clear all bits, or bitwise
+	 *  operations over the entire structure. */
+	uint64_t all;
+} odp_pool_stats_opt_t;
+
 /**
  * Pool capabilities
  */
@@ -139,6 +167,9 @@ typedef struct odp_pool_capability_t {
 		uint32_t max_num;
 	} tmo;
 
+	/** Supported pool statistics counters */
+	odp_pool_stats_opt_t stats;
+
 } odp_pool_capability_t;
 
 /**
@@ -208,6 +239,13 @@ typedef struct odp_pool_param_t {
 			uint32_t num;
 		} tmo;
 	};
+
+	/** Statistics counters to enable
+	 *
+	 *  Only counters supported by pool capability 'stats' can be
+	 *  enabled. Other counters are ignored. The default value is zero,
+	 *  no counters. */
+	odp_pool_stats_opt_t stats;
 } odp_pool_param_t;
 
 /** Packet pool*/
@@ -297,6 +335,55 @@ int odp_pool_info(odp_pool_t pool, odp_pool_info_t *info);
  */
 void odp_pool_print(odp_pool_t pool);
 
+/**
+ * Pool statistics
+ *
+ * Only the counters enabled in pool parameters are valid.
+ */
+typedef struct odp_pool_stats_t {
+	/** Number of buffers available for allocation
+	 *
+	 *  Buffers in thread local caches may not be included. */
+	uint64_t available;
+
+	/** Number of times an allocation found the pool empty */
+	uint64_t alloc_fails;
+
+	/** Packet input allocations served from buffers that packet
+	 *  output freed for reuse by the same interface */
+	uint64_t recycle_hits;
+
+	/** Packet input allocations served by the pool */
+	uint64_t recycle_misses;
+} odp_pool_stats_t;
+
+/**
+ * Read pool statistics
+ *
+ * Reads the counters enabled in pool parameters. Other fields of 'stats'
+ * are set to zero.
+ *
+ * @param pool         Pool handle
+ * @param[out] stats   Receives the current statistics of the pool
+ *
+ * @retval 0 Success
+ * @retval <0 Failure
+ */
+int odp_pool_stats(odp_pool_t pool, odp_pool_stats_t *stats);
+
+/**
+ * Reset pool statistics
+ *
+ * Sets the enabled event counters of the pool to zero. The 'available'
+ * counter reflects the pool state and is not affected.
+ *
+ * @param pool         Pool handle
+ *
+ * @retval 0 Success
+ * @retval <0 Failure
+ */
+int odp_pool_stats_reset(odp_pool_t pool);
+
 /**
  * Get printable value for an odp_pool_t
  *
@@ -443,6 +443,21 @@ typedef struct {
 	 * more of the marking API's. */
 	odp_bool_t marking_colors_needed[ODP_NUM_PACKET_COLORS];
 
+	/** busy_poll_needed indicates that the ODP application needs the
+	 * lowest possible latency from the TM system, even at the cost of
+	 * dedicating a CPU to continuously poll it.  When false, the
+	 * implementation may let its processing resources sleep while no
+	 * packet is queued and no shaper delay is about to expire. */
+	odp_bool_t busy_poll_needed;
+
+	/** inline_enq_needed indicates that the ODP application wants the
+	 * thread calling odp_tm_enq() to process the packet through the TM
+	 * system itself (run-to-completion), instead of handing it over to
+	 * the processing resources of the TM system.  Packets that the
+	 * shapers do not delay are then sent out before odp_tm_enq()
+	 * returns.  The implementation may ignore this requirement. */
+	odp_bool_t inline_enq_needed;
+
 	/** The per_level array specifies the TM system requirements that
 	 * can vary based upon the tm_node level. */
 	odp_tm_level_requirements_t per_level[ODP_TM_MAX_LEVELS];
@@ -1614,6 +1629,21 @@ int odp_tm_enq(odp_tm_queue_t tm_queue, odp_packet_t pkt);
  */
 int odp_tm_enq_with_cnt(odp_tm_queue_t tm_queue, odp_packet_t pkt);
 
+/** The odp_tm_enq_multi() function enqueues a burst of packets to the same
+ * tm_queue, like calling odp_tm_enq() for each of them in order, except that
+ * it stops at the first packet that is not enqueued (e.g. due to WRED drop).
+ * The packets from that one on remain owned by the application.
+ *
+ * @param[in] tm_queue  Specifies the tm_queue (and indirectly the TM system).
+ * @param[in] packets   Array of packet handles.
+ * @param[in] num       Number of packets in the array.
+ * @return              Returns the number of packets enqueued (1 ... num)
+ *                      from the beginning of the array, < 0 when the first
+ *                      packet was not enqueued.
+ */
+int odp_tm_enq_multi(odp_tm_queue_t tm_queue, const odp_packet_t packets[],
+		     int num);
+
 /* Dynamic state query functions */
 
 /** The odp_tm_node_info_t record type  is used to return various bits of
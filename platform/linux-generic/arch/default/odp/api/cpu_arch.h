@@ -11,6 +11,8 @@
 extern "C" {
 #endif
 
+#include <odp/api/std_types.h>
+
 #define _ODP_CACHE_LINE_SIZE 64
 
 static inline void odp_cpu_pause(void)
@@ -19,6 +21,23 @@ static inline void odp_cpu_pause(void)
 
 #define __arch_prefetch(_p)	__asm__ volatile("prfm pldl1keep, %a0\n" : : "p" (_p))
 
+#ifdef __aarch64__
+/** @internal CPU counter for odp_time, the generic timer virtual count */
+#define _ODP_CPU_GLOBAL_TIME 1
+
+/* The read is ordered after earlier instructions, like in clock_gettime(),
+ * so that a time read after seeing a time of another CPU is not earlier */
+static inline uint64_t _odp_cpu_global_time(void)
+{
+	uint64_t cnt;
+
+	__asm__ __volatile__ ("isb\n\tmrs %0, cntvct_el0" : "=r" (cnt) : :
+			      "memory");
+
+	return cnt;
+}
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -13,15 +13,65 @@
 #include <odp/api/hints.h>
 #include <odp/api/system_info.h>
 #include <odp_debug_internal.h>
+#include <odp_internal.h>
 
 #define GIGA 1000000000
 
+#ifdef _ODP_CPU_GLOBAL_TIME
+/* CPU cycles per counter tick, scaled by 2 ^ cycles_shift. Zero until the
+ * CPU frequency is known. */
+static uint64_t cycles_mult;
+static uint32_t cycles_shift;
+
+static uint64_t counter_freq(void)
+{
+	uint64_t freq;
+
+	__asm__ __volatile__ ("mrs %0, cntfrq_el0" : "=r" (freq));
+
+	return freq;
+}
+
+static int cycles_scale_init(void)
+{
+	uint64_t hz = odp_cpu_hz_max();
+	uint64_t freq = counter_freq();
+	uint32_t shift = 32;
+
+	if (hz < freq || freq == 0)
+		return -1;
+
+	while (shift && (hz > (UINT64_MAX >> shift) ||
+			 (hz << shift) / freq > UINT32_MAX))
+		shift--;
+
+	/* Threads racing here store the same values. Shift is visible
+	 * before mult. */
+	cycles_shift = shift;
+	__atomic_store_n(&cycles_mult, (hz << shift) / freq, __ATOMIC_RELEASE);
+
+	return 0;
+}
+#endif
+
 uint64_t odp_cpu_cycles(void)
 {
 	struct timespec time;
 	uint64_t sec, ns, hz, cycles;
 	int ret;
 
+#ifdef _ODP_CPU_GLOBAL_TIME
+	uint64_t mult = __atomic_load_n(&cycles_mult, __ATOMIC_ACQUIRE);
+
+	if (odp_likely(mult) || !cycles_scale_init()) {
+		uint64_t cnt = _odp_cpu_global_time();
+
+		mult = cycles_mult;
+		return (((cnt >> 32) * mult) << (32 - cycles_shift)) +
+		       (((cnt & 0xffffffff) * mult) >> cycles_shift);
+	}
+#endif
+
 	ret = clock_gettime(CLOCK_MONOTONIC_RAW, &time);
 
 	if (ret != 0)
@@ -44,5 +94,22 @@ uint64_t odp_cpu_cycles_max(void)
 
 uint64_t odp_cpu_cycles_resolution(void)
 {
+#ifdef _ODP_CPU_GLOBAL_TIME
+	if (__atomic_load_n(&cycles_mult, __ATOMIC_ACQUIRE) ||
+	    !cycles_scale_init()) {
+		if (cycles_mult >> cycles_shift)
+			return cycles_mult >> cycles_shift;
+	}
+#endif
 	return 1;
 }
+
+uint64_t _odp_cpu_global_time_freq(void)
+{
+#ifdef _ODP_CPU_GLOBAL_TIME
+	return counter_freq();
+#else
+	/* No counter for odp_time, it uses clock_gettime() */
+	return 0;
+#endif
+}
@@ -7,6 +7,7 @@
 #include <odp/api/cpu.h>
 #include <odp/api/hints.h>
 #include <odp/api/system_info.h>
+#include <odp_internal.h>
 
 uint64_t odp_cpu_cycles(void)
 {
@@ -29,3 +30,9 @@ uint64_t odp_cpu_cycles_resolution(void)
 {
 	return 1;
 }
+
+uint64_t _odp_cpu_global_time_freq(void)
+{
+	/* No counter for odp_time, it uses clock_gettime() */
+	return 0;
+}
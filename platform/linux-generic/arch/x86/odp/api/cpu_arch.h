@@ -11,6 +11,8 @@
 extern "C" {
 #endif
 
+#include <odp/api/std_types.h>
+
 #define _ODP_CACHE_LINE_SIZE 64
 
 static inline void odp_cpu_pause(void)
@@ -22,6 +24,21 @@ static inline void odp_cpu_pause(void)
 #endif
 }
 
+/** @internal CPU counter for odp_time, the time stamp counter */
+#define _ODP_CPU_GLOBAL_TIME 1
+
+/* The read is ordered after earlier loads, like in clock_gettime(), so that
+ * a time read after seeing a time of another CPU is not earlier than it */
+static inline uint64_t _odp_cpu_global_time(void)
+{
+	uint32_t lo, hi;
+
+	__asm__ __volatile__ ("lfence\n\trdtsc" : "=a" (lo), "=d" (hi) : :
+			      "memory");
+
+	return ((uint64_t)hi << 32) | lo;
+}
+
 #ifdef __cplusplus
 }
 #endif
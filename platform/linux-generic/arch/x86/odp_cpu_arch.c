@@ -3,7 +3,19 @@
  *
  * SPDX-License-Identifier:     BSD-3-Clause
  */
+
+#include <odp_posix_extensions.h>
+
+#include <time.h>
+#include <cpuid.h>
+
 #include <odp/api/cpu.h>
+#include <odp_internal.h>
+
+#define GIGA 1000000000
+
+/* Time stamp counter calibration period */
+#define TSC_CALIB_NS 10000000
 
 uint64_t odp_cpu_cycles(void)
 {
@@ -31,3 +43,41 @@ uint64_t odp_cpu_cycles_resolution(void)
 {
 	return 1;
 }
+
+/* Invariant TSC runs at a constant rate in all C, P and T states */
+static int tsc_invariant(void)
+{
+	unsigned int eax, ebx, ecx, edx;
+
+	if (!__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx))
+		return 0;
+
+	return (edx >> 8) & 1;
+}
+
+uint64_t _odp_cpu_global_time_freq(void)
+{
+	struct timespec t1, t2;
+	uint64_t c1, c2, ns;
+
+	if (!tsc_invariant())
+		return 0;
+
+	/* Count TSC ticks over a period of CLOCK_MONOTONIC_RAW. Both counter
+	 * reads follow a clock read, so that their delays cancel out. */
+	if (clock_gettime(CLOCK_MONOTONIC_RAW, &t1))
+		return 0;
+	c1 = _odp_cpu_global_time();
+
+	do {
+		if (clock_gettime(CLOCK_MONOTONIC_RAW, &t2))
+			return 0;
+
+		ns = (uint64_t)(t2.tv_sec - t1.tv_sec) * GIGA +
+		     t2.tv_nsec - t1.tv_nsec;
+	} while (ns < TSC_CALIB_NS);
+
+	c2 = _odp_cpu_global_time();
+
+	return (c2 - c1) * GIGA / ns;
+}
@@ -0,0 +1,122 @@
+/* Copyright (c) 2017, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+/**
+ * @file
+ *
+ * ODP time inlines
+ */
+
+#ifndef ODP_PLAT_TIME_INLINES_H_
+#define ODP_PLAT_TIME_INLINES_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <odp/api/cpu_arch.h>
+#include <odp/api/hints.h>
+
+/** @internal Time source, set up by odp_time_init_global() */
+typedef struct {
+	/** Counter value at init */
+	uint64_t hw_start;
+	/** Nanoseconds per counter tick, multiplied by 2 ^ hw_shift */
+	uint64_t hw_mult;
+	/** Scale of hw_mult, hw_mult fits in 32 bits */
+	uint32_t hw_shift;
+	/** Time is read from the CPU counter of the architecture */
+	int use_hw;
+} _odp_time_global_t;
+
+/** @internal Time source */
+extern _odp_time_global_t _odp_time_glob;
+
+/** @internal Time from clock_gettime(), when there is no usable counter */
+odp_time_t _odp_time_sys(void);
+
+#ifdef _ODP_CPU_GLOBAL_TIME
+/** @internal Time from the CPU counter */
+static inline odp_time_t _odp_time_hw(void)
+{
+	uint64_t count = _odp_cpu_global_time() - _odp_time_glob.hw_start;
+	uint64_t mult = _odp_time_glob.hw_mult;
+	uint32_t shift = _odp_time_glob.hw_shift;
+	odp_time_t time;
+
+	/* count * mult >> shift in 64 bit arithmetic, the product of the
+	 * low half fits as mult is below 2 ^ 32 */
+	time.nsec = (((count >> 32) * mult) << (32 - shift)) +
+		    (((count & 0xffffffff) * mult) >> shift);
+
+	return time;
+}
+#endif
+
+_STATIC odp_time_t odp_time_local(void)
+{
+#ifdef _ODP_CPU_GLOBAL_TIME
+	if (odp_likely(_odp_time_glob.use_hw))
+		return _odp_time_hw();
+#endif
+	return _odp_time_sys();
+}
+
+_STATIC odp_time_t odp_time_global(void)
+{
+	return odp_time_local();
+}
+
+_STATIC odp_time_t odp_time_diff(odp_time_t t2, odp_time_t t1)
+{
+	odp_time_t time;
+
+	time.nsec = t2.nsec - t1.nsec;
+
+	return time;
+}
+
+_STATIC uint64_t odp_time_to_ns(odp_time_t time)
+{
+	return time.nsec;
+}
+
+_STATIC odp_time_t odp_time_local_from_ns(uint64_t ns)
+{
+	odp_time_t time;
+
+	time.nsec = ns;
+
+	return time;
+}
+
+_STATIC odp_time_t odp_time_global_from_ns(uint64_t ns)
+{
+	return odp_time_local_from_ns(ns);
+}
+
+_STATIC int odp_time_cmp(odp_time_t t2, odp_time_t t1)
+{
+	if (t2.nsec < t1.nsec)
+		return -1;
+
+	return t2.nsec > t1.nsec;
+}
+
+_STATIC odp_time_t odp_time_sum(odp_time_t t1, odp_time_t t2)
+{
+	odp_time_t time;
+
+	time.nsec = t1.nsec + t2.nsec;
+
+	return time;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
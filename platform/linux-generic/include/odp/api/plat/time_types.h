@@ -23,14 +23,14 @@ extern "C" {
 
 /**
  * @internal Time structure used to isolate odp-linux implementation from
- * the linux timespec structure, which is dependent on POSIX extension level.
+ * the time source. Time is kept in nanoseconds since odp_time_init_global(),
+ * whether it is read from a CPU counter or from clock_gettime().
  */
 typedef struct odp_time_t {
-	int64_t tv_sec;      /**< @internal Seconds */
-	int64_t tv_nsec;     /**< @internal Nanoseconds */
+	uint64_t nsec;       /**< @internal Nanoseconds */
 } odp_time_t;
 
-#define ODP_TIME_NULL ((odp_time_t){0, 0})
+#define ODP_TIME_NULL ((odp_time_t){0})
 
 /**
  * @}
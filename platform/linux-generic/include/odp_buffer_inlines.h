@@ -51,7 +51,7 @@ static inline odp_buffer_hdr_t *odp_buf_to_hdr(odp_buffer_t buf)
 {
 	odp_buffer_bits_t handle;
 	uint32_t pool_id;
-	uint32_t index;
+	uintptr_t index;
 	struct pool_entry_s *pool;
 
 	handle.handle = buf;
@@ -89,16 +89,20 @@ static inline odp_buffer_hdr_t *validate_buf(odp_buffer_t buf)
 	if (pool->s.pool_shm == ODP_SHM_INVALID)
 		return NULL;
 
+	uintptr_t index = handle.index;
 	uint32_t buf_stride = pool->s.buf_stride / ODP_CACHE_LINE_SIZE;
 
 	/* A valid buffer index must be on stride, and must be in range */
-	if ((handle.index % buf_stride != 0) ||
-	    ((uint32_t)(handle.index / buf_stride) >= pool->s.params.buf.num))
+	if ((index % buf_stride != 0) ||
+	    (index / buf_stride >= pool->s.buf_num))
 		return NULL;
 
 	buf_hdr = (odp_buffer_hdr_t *)(void *)
-		(pool->s.pool_mdata_addr +
-		 (handle.index * ODP_CACHE_LINE_SIZE));
+		(pool->s.pool_mdata_addr + (index * ODP_CACHE_LINE_SIZE));
+
+	/* Header of a buffer never allocated is not initialized */
+	if ((uint8_t *)buf_hdr >= pool->s.buf_lazy)
+		return NULL;
 
 	/* Handle is valid, so buffer is valid if it is allocated */
 	return buf_hdr->allocator == ODP_FREEBUF ? NULL : buf_hdr;
@@ -67,12 +67,26 @@ ODP_STATIC_ASSERT((ODP_CONFIG_PACKET_BUF_LEN_MAX %
 /* We can optimize storage of small raw buffers within metadata area */
 #define ODP_MAX_INLINE_BUF     ((sizeof(void *)) * (ODP_BUFFER_MAX_SEG - 1))
 
+/* Buffer handles are as wide as pointers. On 64-bit targets the header
+ * index has enough bits for any pool that fits in memory. The index is
+ * kept in the most significant bits, so that handles of pools within the
+ * old 32-bit limit keep fitting in the low 32 bits. */
+#if defined(__SIZEOF_POINTER__) && __SIZEOF_POINTER__ == 8
+#define ODP_BUFFER_HANDLE_BITS 64
+typedef uint64_t odp_buffer_bits_word_t;
+#else
+#define ODP_BUFFER_HANDLE_BITS 32
+typedef uint32_t odp_buffer_bits_word_t;
+#endif
+
 #define ODP_BUFFER_POOL_BITS   ODP_BITSIZE(ODP_CONFIG_POOLS)
 #define ODP_BUFFER_SEG_BITS    ODP_BITSIZE(ODP_BUFFER_MAX_SEG)
-#define ODP_BUFFER_INDEX_BITS  (32 - ODP_BUFFER_POOL_BITS - ODP_BUFFER_SEG_BITS)
+#define ODP_BUFFER_INDEX_BITS  (ODP_BUFFER_HANDLE_BITS - \
+				ODP_BUFFER_POOL_BITS - ODP_BUFFER_SEG_BITS)
 #define ODP_BUFFER_PREFIX_BITS (ODP_BUFFER_POOL_BITS + ODP_BUFFER_INDEX_BITS)
 #define ODP_BUFFER_MAX_POOLS   (1 << ODP_BUFFER_POOL_BITS)
-#define ODP_BUFFER_MAX_BUFFERS (1 << ODP_BUFFER_INDEX_BITS)
+#define ODP_BUFFER_MAX_BUFFERS ((odp_buffer_bits_word_t)1 << \
+				ODP_BUFFER_INDEX_BITS)
 
 #define ODP_BUFFER_MAX_INDEX     (ODP_BUFFER_MAX_BUFFERS - 2)
 #define ODP_BUFFER_INVALID_INDEX (ODP_BUFFER_MAX_BUFFERS - 1)
@@ -80,26 +94,26 @@ ODP_STATIC_ASSERT((ODP_CONFIG_PACKET_BUF_LEN_MAX %
 typedef union odp_buffer_bits_t {
 	odp_buffer_t handle;
 	union {
-		uint32_t     u32;
+		odp_buffer_bits_word_t word;
 		struct {
 #if ODP_BYTE_ORDER == ODP_BIG_ENDIAN
-			uint32_t pool_id:ODP_BUFFER_POOL_BITS;
-			uint32_t index:ODP_BUFFER_INDEX_BITS;
-			uint32_t seg:ODP_BUFFER_SEG_BITS;
+			odp_buffer_bits_word_t index:ODP_BUFFER_INDEX_BITS;
+			odp_buffer_bits_word_t pool_id:ODP_BUFFER_POOL_BITS;
+			odp_buffer_bits_word_t seg:ODP_BUFFER_SEG_BITS;
 #else
-			uint32_t seg:ODP_BUFFER_SEG_BITS;
-			uint32_t index:ODP_BUFFER_INDEX_BITS;
-			uint32_t pool_id:ODP_BUFFER_POOL_BITS;
+			odp_buffer_bits_word_t seg:ODP_BUFFER_SEG_BITS;
+			odp_buffer_bits_word_t pool_id:ODP_BUFFER_POOL_BITS;
+			odp_buffer_bits_word_t index:ODP_BUFFER_INDEX_BITS;
 #endif
 		};
 
 		struct {
 #if ODP_BYTE_ORDER == ODP_BIG_ENDIAN
-			uint32_t prefix:ODP_BUFFER_PREFIX_BITS;
-			uint32_t pfxseg:ODP_BUFFER_SEG_BITS;
+			odp_buffer_bits_word_t prefix:ODP_BUFFER_PREFIX_BITS;
+			odp_buffer_bits_word_t pfxseg:ODP_BUFFER_SEG_BITS;
 #else
-			uint32_t pfxseg:ODP_BUFFER_SEG_BITS;
-			uint32_t prefix:ODP_BUFFER_PREFIX_BITS;
+			odp_buffer_bits_word_t pfxseg:ODP_BUFFER_SEG_BITS;
+			odp_buffer_bits_word_t prefix:ODP_BUFFER_PREFIX_BITS;
 #endif
 		};
 	};
@@ -136,6 +150,7 @@ struct odp_buffer_hdr_t {
 		struct {
 			uint32_t hdrdata:1;  /* Data is in buffer hdr */
 			uint32_t sustain:1;  /* Sustain order */
+			uint32_t sharedseg:1; /* Segments may be shared */
 		};
 	} flags;
 #ifdef MV_NETMAP_BUF_ZERO_COPY
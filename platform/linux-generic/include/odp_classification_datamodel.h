@@ -104,6 +104,7 @@ struct pmr_s {
 	uint32_t valid;			/* Validity Flag */
 	odp_atomic_u32_t count;		/* num of packets matching this rule */
 	uint32_t num_pmr;		/* num of PMR Term Values*/
+	layer_t layer;			/* Parse depth needed by the terms */
 	odp_spinlock_t lock;		/* pmr lock*/
 	cos_t *src_cos;			/* source CoS where PMR is attached */
 	pmr_term_value_t  pmr_term_value[ODP_PMRTERM_MAX];
@@ -147,6 +148,7 @@ typedef struct classifier {
 	cos_t *error_cos;		/* Associated Error CoS */
 	cos_t *default_cos;		/* Associated Default CoS */
 	uint32_t l3_precedence;		/* L3 QoS precedence */
+	layer_t qos_layer;		/* Parse depth needed by QoS tables */
 	pmr_l2_cos_t l2_cos_table;	/* L2 QoS-CoS table map */
 	pmr_l3_cos_t l3_cos_table;	/* L3 Qos-CoS table map */
 	odp_cos_flow_set_t flow_set;	/* Flow Set to be calculated
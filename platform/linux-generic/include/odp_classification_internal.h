@@ -68,8 +68,8 @@ This function gets called recursively to check the chained PMR Term value
 with the packet.
 
 **/
-cos_t *match_pmr_cos(cos_t *cos, const uint8_t *pkt_addr, pmr_t *pmr,
-		     odp_packet_hdr_t *hdr);
+cos_t *match_pmr_cos(cos_t *cos, const uint8_t *pkt_addr, uint32_t seg_len,
+		     pmr_t *pmr, odp_packet_hdr_t *hdr);
 /**
 @internal
 CoS associated with L3 QoS value
@@ -134,9 +134,10 @@ Verify PMR with a Packet
 
 This function goes through each PMR_TERM value in pmr_t structure and
 calls verification function for each term.Returns 1 if PMR matches or 0
-Otherwise.
+Otherwise. The packet is parsed further when the terms need deeper layers.
 **/
-int verify_pmr(pmr_t *pmr, const uint8_t *pkt_addr, odp_packet_hdr_t *pkt_hdr);
+int verify_pmr(pmr_t *pmr, const uint8_t *pkt_addr, uint32_t seg_len,
+	       odp_packet_hdr_t *pkt_hdr);
 
 #ifdef __cplusplus
 }
@@ -53,6 +53,7 @@ enum init_stage {
 	CPUMASK_INIT,
 	TIME_INIT,
 	SYSINFO_INIT,
+	HASH_INIT,
 	SHM_INIT,
 	THREAD_INIT,
 	POOL_INIT,
@@ -78,6 +79,9 @@ int odp_cpumask_term_global(void);
 int odp_system_info_init(void);
 int odp_system_info_term(void);
 
+int odp_hash_init_global(void);
+int odp_hash_term_global(void);
+
 int odp_thread_init_global(void);
 int odp_thread_init_local(odp_thread_type_t type);
 int odp_thread_term_local(void);
@@ -112,6 +116,9 @@ int odp_timer_disarm_all(void);
 int odp_time_init_global(void);
 int odp_time_term_global(void);
 
+/* Frequency of _odp_cpu_global_time(), 0 when odp_time can not use it */
+uint64_t _odp_cpu_global_time_freq(void);
+
 int odp_tm_init_global(void);
 int odp_tm_term_global(void);
 
@@ -49,6 +49,8 @@ typedef union {
 typedef struct {
 	odp_pool_t pool;		  /**< pool to alloc packets from */
 	struct rte_mempool *pkt_pool;	  /**< DPDK packet pool */
+	/** ODP packet pool as a DPDK mempool, NULL when copying packets */
+	struct rte_mempool *zc_pool;
 	odp_pktio_capability_t	capa;	  /**< interface capabilities */
 	uint32_t data_room;		  /**< maximum packet length */
 	uint16_t mtu;			  /**< maximum transmission unit */
@@ -162,6 +162,11 @@ typedef struct {
 
 } packet_parser_t;
 
+#ifdef ODP_DPDK_ZERO_COPY
+/** Size of the DPDK mbuf at the end of packet headers */
+#define PKT_EXTRA_LEN 128
+#endif
+
 /**
  * Internal Packet header
  *
@@ -189,6 +194,11 @@ typedef struct {
 	odp_time_t timestamp;    /**< Timestamp value */
 
 	odp_crypto_generic_op_result_t op_result;  /**< Result for crypto */
+
+#ifdef ODP_DPDK_ZERO_COPY
+	/** DPDK mbuf describing the packet to DPDK pktio */
+	uint8_t extra[PKT_EXTRA_LEN] ODP_ALIGNED_CACHE;
+#endif
 } odp_packet_hdr_t;
 
 typedef struct odp_packet_hdr_stride {
@@ -352,6 +362,18 @@ int _odp_packet_copy_md_to_packet(odp_packet_t srcpkt, odp_packet_t dstpkt);
 int packet_alloc_multi(odp_pool_t pool_hdl, uint32_t len,
 		       odp_packet_t pkt[], int max_num);
 
+/* Packet alloc of pktios, from the recycle cache first */
+int packet_alloc_recycle(pool_recycle_t *rc, odp_pool_t pool_hdl,
+			 uint32_t len, odp_packet_t pkt[], int max_num);
+
+/* Free of transmitted packets into the recycle cache. Packets of other
+ * pools, with shared segments, or not fitting into the cache are freed. */
+void packet_free_recycle(pool_recycle_t *rc, odp_pool_t pool_hdl,
+			 const odp_packet_t pkt[], int num);
+
+/* Return all buffers of a recycle cache to their pool */
+void packet_recycle_flush(pool_recycle_t *rc);
+
 /* Fill in parser metadata for L2 */
 void packet_parse_l2(packet_parser_t *prs, uint32_t frame_len);
 
@@ -361,6 +383,10 @@ int packet_parse_layer(odp_packet_hdr_t *pkt_hdr, layer_t layer);
 /* Reset parser metadata for a new parse */
 void packet_parse_reset(odp_packet_hdr_t *pkt_hdr);
 
+/* Parse a burst of received packets up to a given protocol layer. Parser
+ * metadata of the packets must be reset before the call. */
+void packet_parse_multi(const odp_packet_t pkt[], int num, layer_t layer);
+
 /* Convert a packet handle to a buffer handle */
 odp_buffer_t _odp_packet_to_buffer(odp_packet_t pkt);
 
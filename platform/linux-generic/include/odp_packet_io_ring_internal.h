@@ -81,6 +81,10 @@
  * - Lockless implementation.
  * - Multi- or single-consumer dequeue.
  * - Multi- or single-producer enqueue.
+ * - Head/tail sync (HTS) multi-producer or multi-consumer mode, which
+ *   serializes producers (consumers) instead of making them wait for each
+ *   other's tail update. This behaves better on overcommitted cores where
+ *   a preempted thread would otherwise stall every thread behind it.
  * - Bulk dequeue.
  * - Bulk enqueue.
  *
@@ -112,6 +116,18 @@ enum _ring_queue_behavior {
 
 #define _RING_NAMESIZE 32 /**< The maximum length of a ring name. */
 
+/**
+ * Head and tail of one side of the ring, accessible as a single 64 bit word.
+ * Used by the head/tail sync mode to move both indexes atomically.
+ */
+typedef union {
+	struct {
+		uint32_t head;
+		uint32_t tail;
+	};
+	uint64_t raw;
+} _ring_ht_t;
+
 /**
  * An ODP ring structure.
  *
@@ -121,6 +137,11 @@ enum _ring_queue_behavior {
  * field. Thanks to this assumption, we can do subtractions between 2 index
  * values in a modulo-32bit base: that's why the overflow of the indexes is not
  * a problem.
+ *
+ * A single producer keeps a private copy of the consumer tail (and a single
+ * consumer a copy of the producer tail) in its own cache line. The remote
+ * index is read only when the cached value makes the ring look full (empty),
+ * so in steady state the two sides do not bounce each other's cache lines.
  */
 typedef struct _ring {
 	/** @private Next in list. */
@@ -135,19 +156,33 @@ typedef struct _ring {
 	struct _prod {
 		uint32_t watermark;      /* Maximum items */
 		uint32_t sp_enqueue;     /* True, if single producer. */
+		uint32_t hts_enqueue;    /* True, if head/tail sync producer. */
 		uint32_t size;           /* Size of ring. */
 		uint32_t mask;           /* Mask (size-1) of ring. */
-		volatile uint32_t head;  /* Producer head. */
-		volatile uint32_t tail;  /* Producer tail. */
+		union {
+			struct {
+				volatile uint32_t head;  /* Producer head. */
+				volatile uint32_t tail;  /* Producer tail. */
+			};
+			uint64_t ht;     /* Head and tail, HTS mode. */
+		} ODP_ALIGNED(sizeof(uint64_t));
+		uint32_t cons_tail;      /* Cached consumer tail, SP only. */
 	} prod ODP_ALIGNED_CACHE;
 
 	/** @private Consumer */
 	struct _cons {
 		uint32_t sc_dequeue;     /* True, if single consumer. */
+		uint32_t hts_dequeue;    /* True, if head/tail sync consumer. */
 		uint32_t size;           /* Size of the ring. */
 		uint32_t mask;           /* Mask (size-1) of ring. */
-		volatile uint32_t head;  /* Consumer head. */
-		volatile uint32_t tail;  /* Consumer tail. */
+		union {
+			struct {
+				volatile uint32_t head;  /* Consumer head. */
+				volatile uint32_t tail;  /* Consumer tail. */
+			};
+			uint64_t ht;     /* Head and tail, HTS mode. */
+		} ODP_ALIGNED(sizeof(uint64_t));
+		uint32_t prod_tail;      /* Cached producer tail, SC only. */
 	} cons ODP_ALIGNED_CACHE;
 
 	/** @private Memory space of ring starts here. */
@@ -163,6 +198,10 @@ typedef struct _ring {
 #define _RING_SHM_PROC (1 << 2)
  /* Do not link ring to linked list. */
 #define _RING_NO_LIST  (1 << 3)
+/* The default enqueue is "multi-producer head/tail sync". */
+#define _RING_F_MP_HTS_ENQ (1 << 4)
+/* The default dequeue is "multi-consumer head/tail sync". */
+#define _RING_F_MC_HTS_DEQ (1 << 5)
 /* Quota exceed for burst ops */
 #define _RING_QUOT_EXCEED (1 << 31)
 /* Ring size mask */
@@ -188,6 +227,10 @@ typedef struct _ring {
  *    - RING_F_SC_DEQ: If this flag is set, the default behavior when
  *      using ``odph_ring_dequeue()`` or ``odph_ring_dequeue_bulk()``
  *      is "single-consumer". Otherwise, it is "multi-consumers".
+ *    - RING_F_MP_HTS_ENQ: Default enqueue is "multi-producer head/tail
+ *      sync". Cannot be combined with RING_F_SP_ENQ.
+ *    - RING_F_MC_HTS_DEQ: Default dequeue is "multi-consumer head/tail
+ *      sync". Cannot be combined with RING_F_SC_DEQ.
  * @return
  *   On success, the pointer to the new allocated ring. NULL on error with
  *    odp_errno set appropriately. Possible errno values include:
@@ -344,6 +387,52 @@ int ___ring_sc_do_dequeue(_ring_t *r, void **obj_table,
 			  unsigned n,
 			  enum _ring_queue_behavior behavior);
 
+/**
+ * Enqueue several objects on the ring (multi-producers safe, head/tail
+ * sync mode).
+ *
+ * Producers move the head only when no other enqueue is in progress, so the
+ * tail can be updated without waiting for preceding producers. All producers
+ * of the ring must use this mode.
+ *
+ * @param r
+ *   A pointer to the ring structure.
+ * @param obj_table
+ *   A pointer to a table of void * pointers (objects).
+ * @param n
+ *   The number of objects to add in the ring from the obj_table.
+ * @param behavior
+ *   ODPH_RING_QUEUE_FIXED:    Enqueue a fixed number of items from a ring
+ *   ODPH_RING_QUEUE_VARIABLE: Enqueue as many items a possible from ring
+ * @return
+ *   Same as ___ring_mp_do_enqueue()
+ */
+int ___ring_hts_do_enqueue(_ring_t *r, void * const *obj_table,
+			   unsigned n,
+			   enum _ring_queue_behavior behavior);
+
+/**
+ * Dequeue several objects from a ring (multi-consumers safe, head/tail
+ * sync mode).
+ *
+ * All consumers of the ring must use this mode.
+ *
+ * @param r
+ *   A pointer to the ring structure.
+ * @param obj_table
+ *   A pointer to a table of void * pointers (objects) that will be filled.
+ * @param n
+ *   The number of objects to dequeue from the ring to the obj_table.
+ * @param behavior
+ *   ODPH_RING_QUEUE_FIXED:    Dequeue a fixed number of items from a ring
+ *   ODPH_RING_QUEUE_VARIABLE: Dequeue as many items a possible from ring
+ * @return
+ *   Same as ___ring_mc_do_dequeue()
+ */
+int ___ring_hts_do_dequeue(_ring_t *r, void **obj_table,
+			   unsigned n,
+			   enum _ring_queue_behavior behavior);
+
 /**
  * Enqueue several objects on the ring (multi-producers safe).
  *
@@ -419,6 +508,81 @@ int _ring_mc_dequeue_bulk(_ring_t *r, void **obj_table, unsigned n);
  */
 int _ring_sc_dequeue_bulk(_ring_t *r, void **obj_table, unsigned n);
 
+/**
+ * Enqueue several objects on the ring (head/tail sync mode).
+ *
+ * @param r
+ *   A pointer to the ring structure.
+ * @param obj_table
+ *   A pointer to a table of void * pointers (objects).
+ * @param n
+ *   The number of objects to add in the ring from the obj_table.
+ * @return
+ *   - 0: Success; objects enqueued.
+ *   - -EDQUOT: Quota exceeded. The objects have been enqueued, but the
+ *     high water mark is exceeded.
+ *   - -ENOBUFS: Not enough room in the ring to enqueue; no object is enqueued.
+ */
+int _ring_hts_enqueue_bulk(_ring_t *r, void * const *obj_table,
+			   unsigned n);
+
+/**
+ * Dequeue several objects from a ring (head/tail sync mode).
+ *
+ * @param r
+ *   A pointer to the ring structure.
+ * @param obj_table
+ *   A pointer to a table of void * pointers (objects) that will be filled.
+ * @param n
+ *   The number of objects to dequeue from the ring to the obj_table.
+ * @return
+ *   - 0: Success; objects dequeued.
+ *   - -ENOENT: Not enough entries in the ring to dequeue; no object is
+ *     dequeued.
+ */
+int _ring_hts_dequeue_bulk(_ring_t *r, void **obj_table, unsigned n);
+
+/**
+ * Enqueue several objects on a ring.
+ *
+ * This function calls the single-producer, head/tail sync or
+ * multi-producer version depending on the default behavior that was
+ * specified at ring creation time (see flags).
+ *
+ * @param r
+ *   A pointer to the ring structure.
+ * @param obj_table
+ *   A pointer to a table of void * pointers (objects).
+ * @param n
+ *   The number of objects to add in the ring from the obj_table.
+ * @return
+ *   - 0: Success; objects enqueued.
+ *   - -EDQUOT: Quota exceeded. The objects have been enqueued, but the
+ *     high water mark is exceeded.
+ *   - -ENOBUFS: Not enough room in the ring to enqueue; no object is enqueued.
+ */
+int _ring_enqueue_bulk(_ring_t *r, void * const *obj_table, unsigned n);
+
+/**
+ * Dequeue several objects from a ring.
+ *
+ * This function calls the single-consumer, head/tail sync or
+ * multi-consumer version depending on the default behavior that was
+ * specified at ring creation time (see flags).
+ *
+ * @param r
+ *   A pointer to the ring structure.
+ * @param obj_table
+ *   A pointer to a table of void * pointers (objects) that will be filled.
+ * @param n
+ *   The number of objects to dequeue from the ring to the obj_table.
+ * @return
+ *   - 0: Success; objects dequeued.
+ *   - -ENOENT: Not enough entries in the ring to dequeue; no object is
+ *     dequeued.
+ */
+int _ring_dequeue_bulk(_ring_t *r, void **obj_table, unsigned n);
+
 /**
  * Test if a ring is full.
  *
@@ -500,6 +664,22 @@ int _ring_mp_enqueue_burst(_ring_t *r, void * const *obj_table,
  */
 int _ring_sp_enqueue_burst(_ring_t *r, void * const *obj_table,
 			   unsigned n);
+
+/**
+ * Enqueue several objects on a ring (head/tail sync mode).
+ *
+ * @param r
+ *   A pointer to the ring structure.
+ * @param obj_table
+ *   A pointer to a table of void * pointers (objects).
+ * @param n
+ *   The number of objects to add in the ring from the obj_table.
+ * @return
+ *   - n: Actual number of objects enqueued.
+ */
+int _ring_hts_enqueue_burst(_ring_t *r, void * const *obj_table,
+			    unsigned n);
+
 /**
  * Enqueue several objects on a ring.
  *
@@ -554,6 +734,22 @@ int _ring_mc_dequeue_burst(_ring_t *r, void **obj_table, unsigned n);
  */
 int _ring_sc_dequeue_burst(_ring_t *r, void **obj_table, unsigned n);
 
+/**
+ * Dequeue several objects from a ring (head/tail sync mode). When the
+ * request objects are more than the available objects, only dequeue the
+ * actual number of objects
+ *
+ * @param r
+ *   A pointer to the ring structure.
+ * @param obj_table
+ *   A pointer to a table of void * pointers (objects) that will be filled.
+ * @param n
+ *   The number of objects to dequeue from the ring to the obj_table.
+ * @return
+ *   - n: Actual number of objects dequeued, 0 if ring is empty
+ */
+int _ring_hts_dequeue_burst(_ring_t *r, void **obj_table, unsigned n);
+
 /**
  * Dequeue multiple objects from a ring up to a maximum number.
  *
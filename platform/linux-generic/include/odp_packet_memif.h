@@ -0,0 +1,94 @@
+/* Copyright (c) 2017, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+#ifndef ODP_PACKET_MEMIF_H_
+#define ODP_PACKET_MEMIF_H_
+
+#include <odp/api/atomic.h>
+#include <odp/api/pool.h>
+#include <odp/api/ticketlock.h>
+#include <odp/api/time.h>
+#include <odp_align_internal.h>
+#include <protocols/memif.h>
+
+#include <linux/if_ether.h>
+#include <sys/un.h>
+
+/** Maximum number of memif rings per direction */
+#define MEMIF_MAX_QUEUES 16
+
+/** Maximum number of shared memory regions from the slave */
+#define MEMIF_MAX_REGIONS 8
+
+/** Ring owned by one pktin or pktout queue */
+struct memif_ring_t {
+	_odp_memif_ring_t *ring;	/**< ring in a shared region */
+	uint8_t *buf;			/**< buffers of the ring (slave) */
+	uint16_t mask;			/**< ring size - 1 */
+	uint16_t last;			/**< next descriptor to read on input,
+					     last tail seen on slave output */
+	int int_fd;			/**< interrupt eventfd */
+};
+
+typedef union {
+	struct memif_ring_t s;
+	uint8_t pad[ODP_CACHE_LINE_SIZE_ROUNDUP(sizeof(struct memif_ring_t))];
+} memif_ring_t ODP_ALIGNED_CACHE;
+
+/** pktin or pktout queue */
+struct memif_queue_t {
+	odp_ticketlock_t lock;		/**< queue lock */
+	uint32_t ctrl_poll;		/**< calls since last control poll */
+	uint64_t octets;		/**< received/sent octets */
+	uint64_t pkts;			/**< received/sent packets */
+	uint64_t discards;		/**< dropped packets */
+	uint64_t errors;		/**< bad descriptors */
+};
+
+typedef union {
+	struct memif_queue_t s;
+	uint8_t pad[ODP_CACHE_LINE_SIZE_ROUNDUP(sizeof(struct memif_queue_t))];
+} memif_queue_t ODP_ALIGNED_CACHE;
+
+/** Shared memory region */
+typedef struct {
+	uint8_t *addr;			/**< local mapping */
+	uint64_t size;			/**< region size */
+	int fd;				/**< region memory fd (slave) */
+} memif_region_t;
+
+/** Shared memory packet interface */
+typedef struct {
+	odp_pool_t pool;		/**< pool to alloc packets from */
+	odp_bool_t is_master;		/**< master or slave role */
+	odp_bool_t irq;			/**< block on eventfd in recv_tmo */
+	uint32_t id;			/**< interface id on the socket */
+	char socket[sizeof(((struct sockaddr_un *)0)->sun_path)];
+					/**< control socket path */
+	uint8_t secret[_ODP_MEMIF_SECRET_LEN]; /**< interface secret */
+	uint8_t log2_ring_size;		/**< log2 of ring size (slave) */
+	uint32_t buffer_size;		/**< buffer size (slave) */
+	uint32_t mtu;			/**< maximum frame length */
+	unsigned char if_mac[ETH_ALEN];	/**< MAC address of the interface */
+	int listen_fd;			/**< listening socket (master) */
+	int ctrl_fd;			/**< control connection */
+	odp_atomic_u32_t state;		/**< connection state */
+	uint32_t step;			/**< handshake messages acked (slave) */
+	odp_time_t next_connect;	/**< connect retry time (slave) */
+	uint16_t peer_max_s2m;		/**< ring limits from hello (slave) */
+	uint16_t peer_max_m2s;
+	unsigned num_s2m;		/**< slave to master rings */
+	unsigned num_m2s;		/**< master to slave rings */
+	unsigned num_region;		/**< regions added */
+	memif_region_t region[MEMIF_MAX_REGIONS]; /**< shared regions */
+	char peer_name[_ODP_MEMIF_NAME_LEN + 1]; /**< peer application */
+	memif_ring_t rx_ring[MEMIF_MAX_QUEUES]; /**< rings of pktin queues */
+	memif_ring_t tx_ring[MEMIF_MAX_QUEUES]; /**< rings of pktout queues */
+	memif_queue_t rxq[MEMIF_MAX_QUEUES];	/**< pktin queues */
+	memif_queue_t txq[MEMIF_MAX_QUEUES];	/**< pktout queues */
+} pkt_memif_t;
+
+#endif
@@ -0,0 +1,80 @@
+/* Copyright (c) 2017, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+#ifndef ODP_PACKET_MPCAP_H_
+#define ODP_PACKET_MPCAP_H_
+
+#include <odp/api/align.h>
+#include <odp/api/pool.h>
+#include <odp/api/ticketlock.h>
+#include <odp/api/time.h>
+#include <odp_align_internal.h>
+
+/** Maximum number of pktin queues (file shards) */
+#define MPCAP_MAX_QUEUES 8
+
+/** Capture record of the input file */
+typedef struct {
+	uint64_t offset;	/**< offset of packet data in file */
+	uint64_t ts_ns;		/**< capture timestamp in nanoseconds */
+	uint32_t caplen;	/**< captured length */
+} mpcap_rec_t;
+
+/** Pktin queue replaying a shard of the input file */
+struct mpcap_rx_queue_t {
+	uint32_t first;		/**< first record of the shard */
+	uint32_t end;		/**< one past last record of the shard */
+	uint32_t cur;		/**< next record to replay */
+	uint32_t loop_cnt;	/**< number of loops completed */
+	odp_time_t start;	/**< start time for rate control */
+	int64_t ts_delta;	/**< replay time minus capture time in ns */
+	uint64_t pkts;		/**< packets replayed since start */
+	uint64_t bytes;		/**< bytes replayed since start */
+	uint64_t in_octets;	/**< received octets */
+	uint64_t in_ucast_pkts;	/**< received packets */
+	uint64_t in_discards;	/**< packets dropped on allocation failure */
+	odp_ticketlock_t lock;	/**< queue lock */
+};
+
+typedef union {
+	struct mpcap_rx_queue_t s;
+	uint8_t pad[ODP_CACHE_LINE_SIZE_ROUNDUP(
+		    sizeof(struct mpcap_rx_queue_t))];
+} mpcap_rx_queue_t ODP_ALIGNED_CACHE;
+
+/** Memory-mapped pcap/pcapng file pktio */
+typedef struct {
+	odp_pool_t pool;		/**< rx pool */
+	char *fname_rx;			/**< name of input file */
+	char *fname_tx;			/**< name of output file */
+	const uint8_t *map;		/**< input file mapping */
+	uint64_t map_len;		/**< length of input file mapping */
+	mpcap_rec_t *rec;		/**< index of input records */
+	uint32_t num_rec;		/**< number of input records */
+	uint32_t max_rec;		/**< size of record index */
+	uint64_t idx_offset;		/**< next pcap record to index */
+	odp_bool_t idx_swap;		/**< pcap file in other byte order */
+	odp_bool_t idx_nsec;		/**< pcap file has nsec timestamps */
+	unsigned num_rx_queues;		/**< number of pktin queues */
+	int loops;			/**< number of times to loop input */
+	uint64_t pps;			/**< replay rate in packets/s */
+	uint64_t bps;			/**< replay rate in bits/s */
+	odp_bool_t realtime;		/**< replay at original timestamps */
+	odp_bool_t rewrite;		/**< rewrite IPv4 source per loop */
+	odp_bool_t follow;		/**< index appended packets */
+	odp_bool_t direct;		/**< O_DIRECT output */
+	odp_bool_t sync_tx;		/**< write out every send burst */
+	odp_bool_t promisc;		/**< promiscuous mode state */
+	odp_bool_t lockless_rx;		/**< no locking for rx */
+	int fd_tx;			/**< output file descriptor */
+	uint8_t *wbuf;			/**< output buffer */
+	uint32_t wbuf_size;		/**< output buffer size */
+	uint32_t wbuf_len;		/**< bytes in output buffer */
+	/** pktin queues */
+	mpcap_rx_queue_t rxq[MPCAP_MAX_QUEUES];
+} pkt_mpcap_t;
+
+#endif
@@ -7,15 +7,28 @@
 #ifndef ODP_PACKET_TAP_H_
 #define ODP_PACKET_TAP_H_
 
+#include <odp/api/packet.h>
 #include <odp/api/pool.h>
+#include <odp/api/ticketlock.h>
+
+/** Maximum number of tap queues (file descriptors) per pktio */
+#define TAP_MAX_QUEUES 16
 
 typedef struct {
-	int fd;				/**< file descriptor for tap interface*/
+	int fd[TAP_MAX_QUEUES];		/**< file descriptors of tap queues */
+	unsigned num_fds;		/**< number of open tap queues */
+	odp_bool_t multi_queue;		/**< tap device has IFF_MULTI_QUEUE */
+	odp_bool_t lockless_rx;		/**< no locking for rx */
+	odp_bool_t lockless_tx;		/**< no locking for tx */
+	odp_ticketlock_t rx_lock[TAP_MAX_QUEUES]; /**< pktin queue locks */
+	odp_ticketlock_t tx_lock[TAP_MAX_QUEUES]; /**< pktout queue locks */
 	int skfd;			/**< socket descriptor */
 	uint32_t mtu;			/**< cached mtu */
 	unsigned char if_mac[ETH_ALEN];	/**< MAC address of pktio side (not a
 					     MAC address of kernel interface)*/
 	odp_pool_t pool;		/**< pool to alloc packets from */
+	/** Unused packet of the last poll of each pktin queue */
+	odp_packet_t rx_spare[TAP_MAX_QUEUES];
 } pkt_tap_t;
 
 #endif
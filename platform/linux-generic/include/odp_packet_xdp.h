@@ -0,0 +1,90 @@
+/* Copyright (c) 2017, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+#ifndef ODP_PACKET_XDP_H_
+#define ODP_PACKET_XDP_H_
+
+#include <odp/api/align.h>
+#include <odp/api/packet.h>
+#include <odp/api/pool.h>
+#include <odp/api/shared_memory.h>
+#include <odp/api/ticketlock.h>
+#include <odp_align_internal.h>
+
+#include <linux/if_ether.h>
+#include <net/if.h>
+
+/** Ring shared with the kernel */
+typedef struct {
+	uint32_t *producer;	/**< producer index in the ring mapping */
+	uint32_t *consumer;	/**< consumer index in the ring mapping */
+	uint32_t *flags;	/**< ring flags (need wakeup) */
+	void *desc;		/**< descriptor array */
+	uint32_t mask;		/**< ring size - 1 */
+	void *map;		/**< ring mapping */
+	size_t map_len;		/**< length of ring mapping */
+} xdp_ring_t;
+
+/** AF_XDP socket serving one pktin and/or pktout queue */
+struct xdp_xsk_t {
+	int fd;			/**< AF_XDP socket */
+	xdp_ring_t rx;		/**< received frames */
+	xdp_ring_t fill;	/**< free frames given to the kernel */
+	uint32_t fill_cnt;	/**< packets in the fill and rx rings */
+	odp_ticketlock_t rx_lock; /**< rx and fill ring lock */
+	uint64_t in_octets;	/**< received octets */
+	uint64_t in_ucast_pkts;	/**< received packets */
+	uint64_t in_discards;	/**< packets dropped on input */
+
+	xdp_ring_t tx ODP_ALIGNED_CACHE; /**< frames to transmit */
+	xdp_ring_t comp;	/**< transmitted frames */
+	uint32_t tx_cnt;	/**< packets in the tx and completion rings */
+	odp_ticketlock_t tx_lock; /**< tx and completion ring lock */
+	uint64_t out_octets;	/**< transmitted octets */
+	uint64_t out_ucast_pkts; /**< transmitted packets */
+	uint64_t kernel_discards; /**< kernel drop counter at stats reset */
+};
+
+typedef union {
+	struct xdp_xsk_t s;
+	uint8_t pad[ODP_CACHE_LINE_SIZE_ROUNDUP(sizeof(struct xdp_xsk_t))];
+} xdp_xsk_t ODP_ALIGNED_CACHE;
+
+/** AF_XDP pktio with UMEM on packet pool memory */
+typedef struct {
+	odp_pool_t pool;		/**< pool to alloc packets from */
+	odp_pool_t umem_pool;		/**< pool of the UMEM memory */
+	uint8_t *umem;			/**< UMEM start (pool block memory) */
+	uint64_t umem_len;		/**< UMEM length */
+	uint32_t seg_size;		/**< pool segment (block) size */
+	uint32_t chunk_size;		/**< UMEM chunk size */
+	uint32_t umem_headroom;		/**< UMEM headroom */
+	uint32_t frame_len;		/**< max frame length in a UMEM chunk */
+	int64_t fill_offset;		/**< fill address relative to block */
+	uint32_t fill_num;		/**< fill ring depth per socket */
+	uint32_t mtu;			/**< maximum transmission unit */
+	odp_packet_t *slot;		/**< packets in kernel rings by block */
+	uint32_t num_slot;		/**< number of pool blocks */
+	odp_shm_t slot_shm;		/**< slot table memory */
+	int sockfd;			/**< control socket */
+	int map_fd;			/**< XSKMAP of the XDP program */
+	int prog_fd;			/**< XDP program */
+	int link_fd;			/**< XDP program attachment */
+	uint32_t xdp_flags;		/**< XDP attach mode flags */
+	uint16_t bind_flags;		/**< AF_XDP bind flags */
+	uint16_t steer_type;		/**< ethertype steered to ODP, or 0 */
+	odp_bool_t builtin_prog;	/**< attach built-in XDP program */
+	odp_bool_t lockless_rx;		/**< no locking for rx */
+	odp_bool_t lockless_tx;		/**< no locking for tx */
+	unsigned num_xsk;		/**< number of open sockets */
+	unsigned max_queues;		/**< number of device queues */
+	int if_index;			/**< interface index */
+	char if_name[IF_NAMESIZE];	/**< interface name */
+	unsigned char if_mac[ETH_ALEN];	/**< eth mac address */
+	xdp_xsk_t xsk[PKTIO_MAX_QUEUES]; /**< socket per queue */
+} pkt_xdp_t;
+
+#endif
@@ -73,6 +73,22 @@ typedef struct local_cache_t {
 	};
 } local_cache_t;
 
+#define POOL_RECYCLE_BUFS     (CONFIG_BURST_SIZE / 4)
+
+/* Buffers transmitted on a pktio, to be reused for packet input of the same
+ * pktio by the same thread. Recycled buffers remain allocated from the pool,
+ * so that both the free and the alloc path of the pool are skipped. */
+struct pool_recycle_s {
+	uint32_t num_buf;
+	odp_buffer_hdr_t *buf[POOL_RECYCLE_BUFS];
+};
+
+typedef union pool_recycle_t {
+	struct pool_recycle_s s;
+
+	uint8_t pad[ODP_CACHE_LINE_SIZE_ROUNDUP(sizeof(struct pool_recycle_s))];
+} pool_recycle_t;
+
 #include <odp/api/plat/ticketlock_inlines.h>
 #define POOL_LOCK(a)      _odp_ticketlock_lock(a)
 #define POOL_UNLOCK(a)    _odp_ticketlock_unlock(a)
@@ -92,6 +108,8 @@ typedef struct {
 	odp_atomic_u64_t buf_low_wm_count;  /**< Count of low buf wm conditions */
 	odp_atomic_u64_t blk_high_wm_count;  /**< Count of high blk wm conditions */
 	odp_atomic_u64_t blk_low_wm_count;   /**< Count of low blk wm conditions */
+	odp_atomic_u64_t recycle_hits;  /**< Count of allocs from recycle */
+	odp_atomic_u64_t recycle_misses; /**< Count of allocs bypassing recycle */
 } _odp_pool_stats_t;
 
 struct pool_entry_s {
@@ -120,11 +138,16 @@ struct pool_entry_s {
 	uint32_t                blk_low_wm_assert;
 	uint8_t                *pool_base_addr;
 	uint8_t                *pool_mdata_addr;
+	odp_atomic_u32_t       *blk_ref;
 	size_t                  pool_size;
 	uint32_t                buf_align;
 	uint32_t                buf_stride;
 	odp_buffer_hdr_t       *buf_freelist;
 	void                   *blk_freelist;
+	uint8_t                *buf_lazy;      /* Next never allocated hdr */
+	uint8_t                *buf_lazy_end;
+	uint8_t                *blk_lazy;      /* Next never allocated blk */
+	uint8_t                *blk_lazy_end;
 	odp_atomic_u32_t        bufcount;
 	odp_atomic_u32_t        blkcount;
 	_odp_pool_stats_t       poolstats;
@@ -166,12 +189,19 @@ static inline void *get_blk(struct pool_entry_s *pool)
 
 	myhead = pool->blk_freelist;
 
+	if (odp_likely(myhead != NULL)) {
+		pool->blk_freelist = ((odp_buf_blk_t *)myhead)->next;
+	} else if (pool->blk_lazy < pool->blk_lazy_end) {
+		/* Blocks never allocated before are not in the freelist */
+		myhead = pool->blk_lazy;
+		pool->blk_lazy += pool->seg_size;
+	}
+
+	POOL_UNLOCK(&pool->blk_lock);
+
 	if (odp_unlikely(myhead == NULL)) {
-		POOL_UNLOCK(&pool->blk_lock);
 		odp_atomic_inc_u64(&pool->poolstats.blkempty);
 	} else {
-		pool->blk_freelist = ((odp_buf_blk_t *)myhead)->next;
-		POOL_UNLOCK(&pool->blk_lock);
 		blkcount = odp_atomic_fetch_sub_u32(&pool->blkcount, 1) - 1;
 
 		/* Check for low watermark condition */
@@ -208,6 +238,63 @@ static inline void ret_blk(struct pool_entry_s *pool, void *block)
 	odp_atomic_inc_u64(&pool->poolstats.blkfrees);
 }
 
+/* Packet references share segments. A shared block has a reference count
+ * of the other holders of the block, and segments of references may start in
+ * the middle of a block. Blocks of packet pools only are counted. */
+static inline uint32_t seg_blk_index(struct pool_entry_s *pool, void *addr)
+{
+	return ((uint8_t *)addr - pool->pool_base_addr) / pool->seg_size;
+}
+
+static inline int seg_is_pool_blk(struct pool_entry_s *pool, void *addr)
+{
+	return pool->blk_ref != NULL &&
+	       (uint8_t *)addr >= pool->pool_base_addr &&
+	       (uint8_t *)addr < pool->pool_mdata_addr;
+}
+
+/* Segment data may be accessed also through other packets */
+static inline int seg_is_shared(struct pool_entry_s *pool, void *addr)
+{
+	uint32_t idx;
+
+	if (!seg_is_pool_blk(pool, addr))
+		return 0;
+
+	idx = seg_blk_index(pool, addr);
+	return odp_atomic_load_u32(&pool->blk_ref[idx]) != 0 ||
+	       (uint8_t *)addr != pool->pool_base_addr + idx * pool->seg_size;
+}
+
+static inline void ref_seg(struct pool_entry_s *pool, void *addr)
+{
+	odp_atomic_inc_u32(&pool->blk_ref[seg_blk_index(pool, addr)]);
+}
+
+/* Return a segment. Shared blocks are returned by the last holder. */
+static inline void ret_seg(struct pool_entry_s *pool, void *addr)
+{
+	odp_atomic_u32_t *ref;
+	uint32_t idx;
+
+	if (seg_is_pool_blk(pool, addr)) {
+		idx = seg_blk_index(pool, addr);
+		ref = &pool->blk_ref[idx];
+
+		if (odp_atomic_load_u32(ref) != 0) {
+			if (odp_atomic_fetch_dec_u32(ref) != 0)
+				return;
+
+			/* Other holders freed the block meanwhile */
+			odp_atomic_store_u32(ref, 0);
+		}
+
+		addr = pool->pool_base_addr + idx * pool->seg_size;
+	}
+
+	ret_blk(pool, addr);
+}
+
 static inline odp_pool_t pool_index_to_handle(uint32_t pool_id)
 {
 	return _odp_cast_scalar(odp_pool_t, pool_id);
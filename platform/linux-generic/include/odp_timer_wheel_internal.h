@@ -56,6 +56,13 @@ uint64_t _odp_timer_wheel_next_expired(_odp_timer_wheel_t timer_wheel);
  */
 uint32_t _odp_timer_wheel_count(_odp_timer_wheel_t timer_wheel);
 
+/* Returns the earliest time at which _odp_timer_wheel_curr_time_update() can
+ * expire a timer or move timers from a higher level wheel.  Until then the
+ * timer wheel need not be serviced.  Returns 0 when expired timers are
+ * waiting to be retrieved and UINT64_MAX when there are no timers.
+ */
+uint64_t _odp_timer_wheel_next_time(_odp_timer_wheel_t timer_wheel);
+
 void _odp_timer_wheel_stats_print(_odp_timer_wheel_t timer_wheel);
 
 void _odp_timer_wheel_destroy(_odp_timer_wheel_t timer_wheel);
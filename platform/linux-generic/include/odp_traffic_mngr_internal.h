@@ -143,6 +143,16 @@ struct tm_wred_node_s {
 	odp_ticketlock_t       tm_wred_node_lock;
 };
 
+/* The profiles and queue counts of a tm_wred_node, loaded once per enqueued
+ * burst of pkts.  The counts are advanced by the pkts of the burst, which
+ * are accepted. */
+typedef struct {
+	tm_queue_thresholds_t *threshold_params;
+	tm_wred_params_t      *wred_params[ODP_NUM_PACKET_COLORS];
+	uint64_t               pkt_cnt;
+	uint64_t               byte_cnt;
+} tm_wred_snapshot_t;
+
 typedef struct { /* 64-bits long. */
 	union {
 		uint64_t word;
@@ -324,11 +334,6 @@ typedef struct {
 	input_work_item_t work_ring[INPUT_WORK_RING_SIZE];
 } input_work_queue_t;
 
-typedef struct {
-	uint32_t next_random_byte;
-	uint8_t  buf[256];
-} tm_random_data_t;
-
 typedef struct {
 	tm_queue_thresholds_t *threshold_params;
 	tm_queue_cnts_t        queue_cnts;
@@ -367,6 +372,9 @@ struct tm_system_s {
 	_odp_tm_group_t odp_tm_group;
 
 	odp_ticketlock_t tm_system_lock;
+	/* In inline mode, the thread holding inline_lock owns the packet
+	 * processing state of the tm_system. */
+	odp_ticketlock_t inline_lock;
 	odp_barrier_t    tm_system_barrier;
 	odp_barrier_t    tm_system_destroy_barrier;
 	odp_atomic_u64_t destroying;
@@ -395,12 +403,12 @@ struct tm_system_s {
 	tm_queue_info_t total_info;
 	tm_queue_info_t priority_info[ODP_TM_MAX_PRIORITIES];
 
-	tm_random_data_t tm_random_data;
 	odp_pktout_queue_t pktout;
 	uint64_t   current_time;
 	uint8_t    tm_idx;
 	uint8_t    first_enq;
 	odp_bool_t is_idle;
+	odp_bool_t inline_enq;
 
 	uint64_t shaper_green_cnt;
 	uint64_t shaper_yellow_cnt;
@@ -420,6 +428,21 @@ struct tm_system_group_s {
 	uint32_t       num_tm_systems;
 	pthread_t      thread;
 	pthread_attr_t attr;
+
+	/* Unless busy_poll is set, the service thread sleeps on wakeup_cond
+	 * while no tm_system in the group has work, and until the earliest
+	 * timer wheel expiry.  Enqueues and configuration requests signal
+	 * the thread when sleeping is set. */
+	odp_bool_t       busy_poll;
+	odp_atomic_u32_t sleeping;
+	pthread_mutex_t  wakeup_lock;
+	pthread_cond_t   wakeup_cond;
+
+	/* Enqueueing threads of inline tm_systems report here shaper timers,
+	 * which expire before sleep_until_ns.  inline_wakeup_ns is reset at
+	 * the start of each round of the service thread. */
+	odp_atomic_u64_t sleep_until_ns;
+	odp_atomic_u64_t inline_wakeup_ns;
 };
 
 #ifdef __cplusplus
@@ -0,0 +1,180 @@
+/* Copyright (c) 2017, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+/**
+ * @file
+ *
+ * Shared memory packet interface (memif) protocol, version 2.0
+ *
+ * Control messages are exchanged over a SOCK_SEQPACKET unix socket. The slave
+ * connects to the socket of the master, creates the shared memory regions and
+ * rings, and passes their file descriptors to the master. Fields are in host
+ * byte order, both ends run on the same host.
+ */
+
+#ifndef ODP_MEMIF_H_
+#define ODP_MEMIF_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <odp_api.h>
+
+/** @addtogroup odp_header ODP HEADER
+ *  @{
+ */
+
+/** Ring cookie, written by the slave */
+#define _ODP_MEMIF_COOKIE 0x3E31F20
+
+/** Protocol version */
+#define _ODP_MEMIF_VERSION_MAJOR 2
+#define _ODP_MEMIF_VERSION_MINOR 0
+#define _ODP_MEMIF_VERSION ((_ODP_MEMIF_VERSION_MAJOR << 8) | \
+			    _ODP_MEMIF_VERSION_MINOR)
+
+/** Cache line size assumed by the ring layout */
+#define _ODP_MEMIF_CACHELINE_SIZE 64
+
+/** Length of names in control messages */
+#define _ODP_MEMIF_NAME_LEN 32
+
+/** Length of the interface secret */
+#define _ODP_MEMIF_SECRET_LEN 24
+
+/** Length of the disconnect reason string */
+#define _ODP_MEMIF_ERR_LEN 96
+
+/** Control message types */
+#define _ODP_MEMIF_MSG_NONE       0
+#define _ODP_MEMIF_MSG_ACK        1
+#define _ODP_MEMIF_MSG_HELLO      2
+#define _ODP_MEMIF_MSG_INIT       3
+#define _ODP_MEMIF_MSG_ADD_REGION 4
+#define _ODP_MEMIF_MSG_ADD_RING   5
+#define _ODP_MEMIF_MSG_CONNECT    6
+#define _ODP_MEMIF_MSG_CONNECTED  7
+#define _ODP_MEMIF_MSG_DISCONNECT 8
+
+/** Interface mode in the init message */
+#define _ODP_MEMIF_MODE_ETHERNET 0
+
+/** Add ring flag: slave to master ring */
+#define _ODP_MEMIF_RING_FLAG_S2M 0x1
+
+/** Hello message, master to slave */
+typedef struct ODP_PACKED {
+	uint8_t name[_ODP_MEMIF_NAME_LEN]; /**< Master application name */
+	uint16_t min_version;		/**< Oldest supported version */
+	uint16_t max_version;		/**< Newest supported version */
+	uint16_t max_region;		/**< Largest region index */
+	uint16_t max_m2s_ring;		/**< Largest master to slave ring index */
+	uint16_t max_s2m_ring;		/**< Largest slave to master ring index */
+	uint8_t max_log2_ring_size;	/**< Largest log2 of ring size */
+} _odp_memif_msg_hello_t;
+
+/** Init message, slave to master */
+typedef struct ODP_PACKED {
+	uint16_t version;		/**< Protocol version */
+	uint32_t id;			/**< Interface id */
+	uint8_t mode;			/**< Interface mode */
+	uint8_t secret[_ODP_MEMIF_SECRET_LEN]; /**< Interface secret */
+	uint8_t name[_ODP_MEMIF_NAME_LEN]; /**< Slave application name */
+} _odp_memif_msg_init_t;
+
+/** Add region message, slave to master. Carries the region fd. */
+typedef struct ODP_PACKED {
+	uint16_t index;			/**< Region index */
+	uint64_t size;			/**< Region size */
+} _odp_memif_msg_add_region_t;
+
+/** Add ring message, slave to master. Carries the interrupt eventfd. */
+typedef struct ODP_PACKED {
+	uint16_t flags;			/**< _ODP_MEMIF_RING_FLAG_S2M */
+	uint16_t index;			/**< Ring index */
+	uint16_t region;		/**< Region of the ring */
+	uint32_t offset;		/**< Ring offset in the region */
+	uint8_t log2_ring_size;		/**< log2 of ring size */
+	uint16_t private_hdr_size;	/**< Metadata size, unused */
+} _odp_memif_msg_add_ring_t;
+
+/** Connect and connected messages */
+typedef struct ODP_PACKED {
+	uint8_t if_name[_ODP_MEMIF_NAME_LEN]; /**< Interface name */
+} _odp_memif_msg_connect_t;
+
+/** Disconnect message */
+typedef struct ODP_PACKED {
+	uint32_t code;			/**< Reason code */
+	uint8_t string[_ODP_MEMIF_ERR_LEN]; /**< Reason */
+} _odp_memif_msg_disconnect_t;
+
+/** Control message */
+typedef struct ODP_PACKED {
+	uint16_t type;			/**< Message type */
+	union {
+		_odp_memif_msg_hello_t hello;
+		_odp_memif_msg_init_t init;
+		_odp_memif_msg_add_region_t add_region;
+		_odp_memif_msg_add_ring_t add_ring;
+		_odp_memif_msg_connect_t connect;
+		_odp_memif_msg_connect_t connected;
+		_odp_memif_msg_disconnect_t disconnect;
+		uint8_t pad[126];
+	};
+} _odp_memif_msg_t;
+
+/** Descriptor flag: packet continues in the next descriptor */
+#define _ODP_MEMIF_DESC_FLAG_NEXT 0x1
+
+/** Ring descriptor */
+typedef struct ODP_PACKED {
+	uint16_t flags;			/**< _ODP_MEMIF_DESC_FLAG_NEXT */
+	uint16_t region;		/**< Region of the buffer */
+	uint32_t length;		/**< Data length, or buffer size */
+	uint32_t offset;		/**< Buffer offset in the region */
+	uint32_t metadata;		/**< Unused */
+} _odp_memif_desc_t;
+
+/** Ring flag: receiver polls, do not signal the interrupt eventfd */
+#define _ODP_MEMIF_RING_FLAG_MASK_INT 0x1
+
+/**
+ * Ring in a shared region
+ *
+ * The slave produces into slave to master rings by advancing head, the master
+ * consumes by advancing tail. On master to slave rings the slave posts empty
+ * buffers by advancing head, and the master fills them and advances tail.
+ */
+typedef struct {
+	uint32_t cookie;		/**< _ODP_MEMIF_COOKIE */
+	uint16_t flags;			/**< _ODP_MEMIF_RING_FLAG_MASK_INT */
+	uint16_t head;			/**< Written by the slave */
+	uint8_t pad0[_ODP_MEMIF_CACHELINE_SIZE - 8];
+	uint16_t tail;			/**< Written by the consumer/master */
+	uint8_t pad1[_ODP_MEMIF_CACHELINE_SIZE - 2];
+	_odp_memif_desc_t desc[];	/**< Descriptors */
+} _odp_memif_ring_t;
+
+/** @internal Compile time assert */
+ODP_STATIC_ASSERT(sizeof(_odp_memif_msg_t) == 128,
+		  "_ODP_MEMIF_MSG_T__SIZE_ERROR");
+ODP_STATIC_ASSERT(sizeof(_odp_memif_desc_t) == 16,
+		  "_ODP_MEMIF_DESC_T__SIZE_ERROR");
+ODP_STATIC_ASSERT(sizeof(_odp_memif_ring_t) ==
+		  2 * _ODP_MEMIF_CACHELINE_SIZE,
+		  "_ODP_MEMIF_RING_T__SIZE_ERROR");
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
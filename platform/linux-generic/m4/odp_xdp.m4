@@ -0,0 +1,37 @@
+##########################################################################
+# Enable AF_XDP pktio support
+##########################################################################
+pktio_xdp_support=yes
+AC_ARG_ENABLE([xdp_support],
+    [  --disable-xdp-support  exclude AF_XDP IO support],
+    [if test x$enableval = xno; then
+        pktio_xdp_support=no
+    fi])
+
+##########################################################################
+# Check for AF_XDP availability (unaligned UMEM chunks, need wakeup and
+# XDP program attachment through BPF links)
+##########################################################################
+if test x$pktio_xdp_support = xyes
+then
+    AC_MSG_CHECKING([for AF_XDP support])
+    AC_COMPILE_IFELSE(
+        [AC_LANG_PROGRAM([[
+            #include <linux/bpf.h>
+            #include <linux/if_link.h>
+            #include <linux/if_xdp.h>
+        ]], [[
+            union bpf_attr attr;
+            struct xdp_umem_reg umem;
+
+            attr.map_type = BPF_MAP_TYPE_XSKMAP;
+            attr.link_create.attach_type = BPF_XDP;
+            umem.flags = XDP_UMEM_UNALIGNED_CHUNK_FLAG;
+            return attr.map_type + umem.flags + XDP_USE_NEED_WAKEUP +
+                   XDP_FLAGS_SKB_MODE;
+        ]])],
+        [AC_MSG_RESULT([yes])
+         ODP_CFLAGS="$ODP_CFLAGS -DODP_PKTIO_XDP"],
+        [AC_MSG_RESULT([no])
+         pktio_xdp_support=no])
+fi
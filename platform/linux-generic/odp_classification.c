@@ -397,6 +397,9 @@ int odp_cos_with_l2_priority(odp_pktio_t pktio_in,
 	}
 	l2_cos = &entry->s.cls.l2_cos_table;
 
+	if (entry->s.cls.qos_layer < LAYER_L2)
+		entry->s.cls.qos_layer = LAYER_L2;
+
 	LOCK(&l2_cos->lock);
 	/* Update the L2 QoS table*/
 	for (i = 0; i < num_qos; i++) {
@@ -428,6 +431,7 @@ int odp_cos_with_l3_qos(odp_pktio_t pktio_in,
 	}
 
 	entry->s.cls.l3_precedence = l3_preference;
+	entry->s.cls.qos_layer = LAYER_L3;
 	l3_cos = &entry->s.cls.l3_cos_table;
 
 	LOCK(&l3_cos->lock);
@@ -498,6 +502,34 @@ no_rule:
 	return 0;
 }
 
+static layer_t pmr_term_layer(odp_cls_pmr_term_t term)
+{
+	switch (term) {
+	case ODP_PMR_ETHTYPE_0:
+	case ODP_PMR_ETHTYPE_X:
+	case ODP_PMR_VLAN_ID_0:
+	case ODP_PMR_VLAN_ID_X:
+	case ODP_PMR_DMAC:
+		return LAYER_L2;
+	case ODP_PMR_IPPROTO:
+	case ODP_PMR_SIP_ADDR:
+	case ODP_PMR_DIP_ADDR:
+	case ODP_PMR_SIP6_ADDR:
+	case ODP_PMR_DIP6_ADDR:
+		return LAYER_L3;
+	case ODP_PMR_UDP_DPORT:
+	case ODP_PMR_TCP_DPORT:
+	case ODP_PMR_UDP_SPORT:
+	case ODP_PMR_TCP_SPORT:
+	case ODP_PMR_IPSEC_SPI:
+	case ODP_PMR_LD_VNI:
+		return LAYER_L4;
+	default:
+		/* Packet length and raw frame data */
+		return LAYER_NONE;
+	}
+}
+
 odp_pmr_t odp_cls_pmr_create(const odp_pmr_param_t *terms, int num_terms,
 			     odp_cos_t src_cos, odp_cos_t dst_cos)
 {
@@ -528,6 +560,7 @@ odp_pmr_t odp_cls_pmr_create(const odp_pmr_param_t *terms, int num_terms,
 		return id;
 
 	pmr->s.num_pmr = num_terms;
+	pmr->s.layer = LAYER_NONE;
 	for (i = 0; i < num_terms; i++) {
 		val_sz = terms[i].val_sz;
 		if (val_sz > ODP_PMR_TERM_BYTES_MAX) {
@@ -539,6 +572,8 @@ odp_pmr_t odp_cls_pmr_create(const odp_pmr_param_t *terms, int num_terms,
 			UNLOCK(&pmr->s.lock);
 			return ODP_PMR_INVAL;
 		}
+		if (pmr_term_layer(terms[i].term) > pmr->s.layer)
+			pmr->s.layer = pmr_term_layer(terms[i].term);
 	}
 
 	loc = odp_atomic_fetch_inc_u32(&cos_src->s.num_rule);
@@ -584,7 +619,8 @@ odp_pool_t odp_cls_cos_pool(odp_cos_t cos_id)
 	return cos->s.pool->s.pool_hdl;
 }
 
-int verify_pmr(pmr_t *pmr, const uint8_t *pkt_addr, odp_packet_hdr_t *pkt_hdr)
+int verify_pmr(pmr_t *pmr, const uint8_t *pkt_addr, uint32_t seg_len,
+	       odp_packet_hdr_t *pkt_hdr)
 {
 	int pmr_failure = 0;
 	int num_pmr;
@@ -598,6 +634,11 @@ int verify_pmr(pmr_t *pmr, const uint8_t *pkt_addr, odp_packet_hdr_t *pkt_hdr)
 		return 0;
 	num_pmr = pmr->s.num_pmr;
 
+	/* Parse only as deep as the terms need */
+	if (pkt_hdr->p.parsed_layers < pmr->s.layer)
+		packet_parse_common(&pkt_hdr->p, pkt_addr, pkt_hdr->frame_len,
+				    seg_len, pmr->s.layer);
+
 	/* Iterate through list of PMR Term values in a pmr_t */
 	for (i = 0; i < num_pmr; i++) {
 		term_value = &pmr->s.pmr_term_value[i];
@@ -702,8 +743,8 @@ int verify_pmr(pmr_t *pmr, const uint8_t *pkt_addr, odp_packet_hdr_t *pkt_hdr)
 	return true;
 }
 
-cos_t *match_pmr_cos(cos_t *cos, const uint8_t *pkt_addr, pmr_t *pmr,
-		     odp_packet_hdr_t *hdr)
+cos_t *match_pmr_cos(cos_t *cos, const uint8_t *pkt_addr, uint32_t seg_len,
+		     pmr_t *pmr, odp_packet_hdr_t *hdr)
 {
 	cos_t *retcos;
 	uint32_t i;
@@ -716,7 +757,7 @@ cos_t *match_pmr_cos(cos_t *cos, const uint8_t *pkt_addr, pmr_t *pmr,
 	if (!cos->s.valid)
 		return NULL;
 
-	if (verify_pmr(pmr, pkt_addr, hdr)) {
+	if (verify_pmr(pmr, pkt_addr, seg_len, hdr)) {
 		/** This gets called recursively to check all the PMRs in
 		 * a PMR chain */
 		if (0 == odp_atomic_load_u32(&cos->s.num_rule))
@@ -724,7 +765,7 @@ cos_t *match_pmr_cos(cos_t *cos, const uint8_t *pkt_addr, pmr_t *pmr,
 
 		for (i = 0; i < odp_atomic_load_u32(&cos->s.num_rule); i++) {
 			retcos = match_pmr_cos(cos->s.linked_cos[i], pkt_addr,
-					       cos->s.pmr[i], hdr);
+					       seg_len, cos->s.pmr[i], hdr);
 			if (!retcos)
 				return cos;
 		}
@@ -743,6 +784,7 @@ int pktio_classifier_init(pktio_entry_t *entry)
 	cls->flow_set = 0;
 	cls->error_cos = NULL;
 	cls->default_cos = NULL;
+	cls->qos_layer = LAYER_NONE;
 	cls->headroom = 0;
 	cls->skip = 0;
 
@@ -758,14 +800,14 @@ This function will check PMR, L2 and L3 QoS COS object associated
 with the PKTIO interface.
 
 Returns the default cos if the packet does not match any PMR
-Returns the error_cos if the packet has an error
+Returns the error_cos if the packet has an error in the parsed layers
 **/
 static inline cos_t *cls_select_cos(pktio_entry_t *entry,
-				    const uint8_t *pkt_addr,
+				    const uint8_t *pkt_addr, uint32_t seg_len,
 				    odp_packet_hdr_t *pkt_hdr)
 {
 	pmr_t *pmr;
-	cos_t *cos;
+	cos_t *cos = NULL;
 	cos_t *default_cos;
 	uint32_t i;
 	classifier_t *cls;
@@ -773,10 +815,6 @@ static inline cos_t *cls_select_cos(pktio_entry_t *entry,
 	cls = &entry->s.cls;
 	default_cos = cls->default_cos;
 
-	/* Check for lazy parse needed */
-	if (packet_parse_not_complete(pkt_hdr))
-		packet_parse_layer(pkt_hdr, LAYER_ALL);
-
 	/* Return error cos for error packet */
 	if (pkt_hdr->p.error_flags.all)
 		return cls->error_cos;
@@ -784,12 +822,23 @@ static inline cos_t *cls_select_cos(pktio_entry_t *entry,
 	for (i = 0; i < odp_atomic_load_u32(&default_cos->s.num_rule); i++) {
 		pmr = default_cos->s.pmr[i];
 		cos = default_cos->s.linked_cos[i];
-		cos = match_pmr_cos(cos, pkt_addr, pmr, pkt_hdr);
+		cos = match_pmr_cos(cos, pkt_addr, seg_len, pmr, pkt_hdr);
 		if (cos)
-			return cos;
+			break;
+	}
+
+	if (cos == NULL) {
+		if (pkt_hdr->p.parsed_layers < cls->qos_layer)
+			packet_parse_common(&pkt_hdr->p, pkt_addr,
+					    pkt_hdr->frame_len, seg_len,
+					    cls->qos_layer);
+		cos = match_qos_cos(entry, pkt_addr, pkt_hdr);
 	}
 
-	cos = match_qos_cos(entry, pkt_addr, pkt_hdr);
+	/* Errors in layers parsed for the rules */
+	if (pkt_hdr->p.error_flags.all)
+		return cls->error_cos;
+
 	if (cos)
 		return cos;
 
@@ -821,8 +870,9 @@ int cls_classify_packet(pktio_entry_t *entry, const uint8_t *base,
 	packet_parse_reset(pkt_hdr);
 	packet_set_len(pkt_hdr, pkt_len);
 
-	packet_parse_common(&pkt_hdr->p, base, pkt_len, seg_len, LAYER_ALL);
-	cos = cls_select_cos(entry, base, pkt_hdr);
+	packet_parse_common(&pkt_hdr->p, base, pkt_len, seg_len,
+			    entry->s.parse_layer);
+	cos = cls_select_cos(entry, base, seg_len, pkt_hdr);
 
 	if (cos == NULL)
 		return -EINVAL;
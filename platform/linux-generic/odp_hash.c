@@ -39,8 +39,13 @@
 
 #include <odp/api/hash.h>
 #include <odp/api/std_types.h>
+#include <odp/api/byteorder.h>
+#include <odp/api/hints.h>
+#include <odp_internal.h>
+#include <odp_debug_internal.h>
 
 #include <stddef.h>
+#include <string.h>
 
 static const uint32_t crc32c_tables[8][256] = {{
 	0x00000000, 0xF26B8303, 0xE13B70F7, 0x1350F3F4, 0xC79A971F, 0x35F1141C,
@@ -444,8 +449,8 @@ static inline uint32_t crc32c_u64(uint64_t data, uint32_t init_val)
 	return crc;
 }
 
-uint32_t odp_hash_crc32c(const void *data, uint32_t data_len,
-			 uint32_t init_val)
+static uint32_t crc32c_sw(const void *data, uint32_t data_len,
+			  uint32_t init_val)
 {
 	size_t i;
 	uint64_t temp = 0;
@@ -487,3 +492,730 @@ uint32_t odp_hash_crc32c(const void *data, uint32_t data_len,
 
 	return init_val;
 }
+
+static void crc32c_multi_sw(const void *data[], uint32_t data_len,
+			    uint32_t init_val, uint32_t hash[], int num)
+{
+	int i;
+
+	for (i = 0; i < num; i++)
+		hash[i] = crc32c_sw(data[i], data_len, init_val);
+}
+
+/*
+ * Hardware CRC32C. Both SSE4.2 'crc32' and ARMv8 'crc32c' compute the same
+ * reflected, non-inverted CRC as the tables above, so results are identical
+ * to the software path. The functions are compiled for the CRC capable
+ * target and selected at global init when the CPU reports the feature.
+ */
+#if defined(__x86_64__)
+
+#include <nmmintrin.h>
+
+#define CRC32C_HW 1
+#define CRC32C_HW_TARGET __attribute__((target("sse4.2")))
+#define CRC32C_HW_NAME "sse4.2"
+
+#define crc32c_hw_u64(crc, data) ((uint32_t)_mm_crc32_u64((crc), (data)))
+#define crc32c_hw_u32(crc, data) _mm_crc32_u32((crc), (data))
+#define crc32c_hw_u8(crc, data)  _mm_crc32_u8((crc), (data))
+
+static int crc32c_hw_supported(void)
+{
+	return __builtin_cpu_supports("sse4.2");
+}
+
+#elif defined(__aarch64__)
+
+#include <arm_acle.h>
+#include <sys/auxv.h>
+
+#ifndef HWCAP_CRC32
+#define HWCAP_CRC32 (1 << 7)
+#endif
+
+#define CRC32C_HW 1
+#ifdef __ARM_FEATURE_CRC32
+#define CRC32C_HW_TARGET
+#else
+#define CRC32C_HW_TARGET __attribute__((target("+crc")))
+#endif
+#define CRC32C_HW_NAME "armv8 crc"
+
+#define crc32c_hw_u64(crc, data) __crc32cd((crc), (data))
+#define crc32c_hw_u32(crc, data) __crc32cw((crc), (data))
+#define crc32c_hw_u8(crc, data)  __crc32cb((crc), (data))
+
+static int crc32c_hw_supported(void)
+{
+#ifdef __ARM_FEATURE_CRC32
+	return 1;
+#else
+	return !!(getauxval(AT_HWCAP) & HWCAP_CRC32);
+#endif
+}
+
+#endif
+
+#ifdef CRC32C_HW
+
+/* Block lengths (in bytes) of the three-way interleaved loops. Each must be
+ * a multiple of 8. */
+#define CRC32C_LONG  8192
+#define CRC32C_SHORT 256
+
+/* Tables for shifting a CRC over CRC32C_LONG and CRC32C_SHORT zero bytes */
+static uint32_t crc32c_long[4][256];
+static uint32_t crc32c_short[4][256];
+
+/* Multiply a GF(2) 32x32 matrix by a vector */
+static uint32_t gf2_matrix_times(const uint32_t *mat, uint32_t vec)
+{
+	uint32_t sum = 0;
+
+	while (vec) {
+		if (vec & 1)
+			sum ^= *mat;
+		vec >>= 1;
+		mat++;
+	}
+
+	return sum;
+}
+
+static void gf2_matrix_square(uint32_t *square, const uint32_t *mat)
+{
+	int n;
+
+	for (n = 0; n < 32; n++)
+		square[n] = gf2_matrix_times(mat, mat[n]);
+}
+
+/* Build the operator that appends len (power of two) zero bytes to a CRC */
+static void crc32c_zeros_op(uint32_t *even, uint32_t len)
+{
+	uint32_t odd[32];
+	uint32_t row = 1;
+	int n;
+
+	/* Operator for one zero bit */
+	odd[0] = 0x82F63B78;
+	for (n = 1; n < 32; n++) {
+		odd[n] = row;
+		row <<= 1;
+	}
+
+	/* Two and four zero bits */
+	gf2_matrix_square(even, odd);
+	gf2_matrix_square(odd, even);
+
+	/* Square until the operator covers len bytes. The first square
+	 * produces the one byte operator. */
+	do {
+		gf2_matrix_square(even, odd);
+		len >>= 1;
+		if (len == 0)
+			return;
+		gf2_matrix_square(odd, even);
+		len >>= 1;
+	} while (len);
+
+	for (n = 0; n < 32; n++)
+		even[n] = odd[n];
+}
+
+static void crc32c_zeros(uint32_t zeros[][256], uint32_t len)
+{
+	uint32_t op[32];
+	uint32_t n;
+
+	crc32c_zeros_op(op, len);
+
+	for (n = 0; n < 256; n++) {
+		zeros[0][n] = gf2_matrix_times(op, n);
+		zeros[1][n] = gf2_matrix_times(op, n << 8);
+		zeros[2][n] = gf2_matrix_times(op, n << 16);
+		zeros[3][n] = gf2_matrix_times(op, n << 24);
+	}
+}
+
+static inline uint32_t crc32c_shift(uint32_t zeros[][256], uint32_t crc)
+{
+	return zeros[0][crc & 0xff] ^ zeros[1][(crc >> 8) & 0xff] ^
+	       zeros[2][(crc >> 16) & 0xff] ^ zeros[3][crc >> 24];
+}
+
+static inline CRC32C_HW_TARGET
+uint32_t crc32c_hw_tail(const uint8_t *pd, uint32_t data_len, uint32_t crc)
+{
+	while (data_len >= 8) {
+		crc = crc32c_hw_u64(crc, *(const uint64_t *)pd);
+		pd += 8;
+		data_len -= 8;
+	}
+
+	if (data_len & 4) {
+		crc = crc32c_hw_u32(crc, *(const uint32_t *)pd);
+		pd += 4;
+	}
+
+	if (data_len & 2) {
+		crc = crc32c_hw_u8(crc, pd[0]);
+		crc = crc32c_hw_u8(crc, pd[1]);
+		pd += 2;
+	}
+
+	if (data_len & 1)
+		crc = crc32c_hw_u8(crc, pd[0]);
+
+	return crc;
+}
+
+/*
+ * The CRC instruction has a latency of several cycles but can issue every
+ * cycle. Long buffers are split into three blocks which are processed as
+ * independent streams, and the block CRCs are then combined by shifting
+ * them over the following block length (the raw CRC is linear, so
+ * crc(A|B, init) == shift(crc(A, init), len(B)) ^ crc(B, 0)).
+ */
+#define CRC32C_HW_3WAY(block, zeros) \
+	while (data_len >= 3 * (block)) { \
+		uint32_t crc1 = 0, crc2 = 0; \
+		const uint8_t *end = pd + (block); \
+		do { \
+			crc = crc32c_hw_u64(crc, *(const uint64_t *)pd); \
+			crc1 = crc32c_hw_u64(crc1, \
+				*(const uint64_t *)(pd + (block))); \
+			crc2 = crc32c_hw_u64(crc2, \
+				*(const uint64_t *)(pd + 2 * (block))); \
+			pd += 8; \
+		} while (pd < end); \
+		crc = crc32c_shift(zeros, crc) ^ crc1; \
+		crc = crc32c_shift(zeros, crc) ^ crc2; \
+		pd += 2 * (block); \
+		data_len -= 3 * (block); \
+	}
+
+static CRC32C_HW_TARGET
+uint32_t crc32c_hw(const void *data, uint32_t data_len, uint32_t init_val)
+{
+	const uint8_t *pd = data;
+	uint32_t crc = init_val;
+
+	CRC32C_HW_3WAY(CRC32C_LONG, crc32c_long);
+	CRC32C_HW_3WAY(CRC32C_SHORT, crc32c_short);
+
+	return crc32c_hw_tail(pd, data_len, crc);
+}
+
+/* Hash four keys at a time to keep the CRC unit busy with independent
+ * dependency chains. Keys are typically short, so no block splitting. */
+static CRC32C_HW_TARGET
+void crc32c_multi_hw(const void *data[], uint32_t data_len,
+		     uint32_t init_val, uint32_t hash[], int num)
+{
+	int i;
+
+	for (i = 0; i + 4 <= num; i += 4) {
+		const uint8_t *p0 = data[i];
+		const uint8_t *p1 = data[i + 1];
+		const uint8_t *p2 = data[i + 2];
+		const uint8_t *p3 = data[i + 3];
+		uint32_t c0 = init_val, c1 = init_val;
+		uint32_t c2 = init_val, c3 = init_val;
+		uint32_t len = data_len;
+
+		while (len >= 8) {
+			c0 = crc32c_hw_u64(c0, *(const uint64_t *)p0);
+			c1 = crc32c_hw_u64(c1, *(const uint64_t *)p1);
+			c2 = crc32c_hw_u64(c2, *(const uint64_t *)p2);
+			c3 = crc32c_hw_u64(c3, *(const uint64_t *)p3);
+			p0 += 8;
+			p1 += 8;
+			p2 += 8;
+			p3 += 8;
+			len -= 8;
+		}
+
+		hash[i]     = crc32c_hw_tail(p0, len, c0);
+		hash[i + 1] = crc32c_hw_tail(p1, len, c1);
+		hash[i + 2] = crc32c_hw_tail(p2, len, c2);
+		hash[i + 3] = crc32c_hw_tail(p3, len, c3);
+	}
+
+	for (; i < num; i++)
+		hash[i] = crc32c_hw(data[i], data_len, init_val);
+}
+
+#endif /* CRC32C_HW */
+
+static uint32_t (*crc32c_fn)(const void *data, uint32_t data_len,
+			     uint32_t init_val) = crc32c_sw;
+
+static void (*crc32c_multi_fn)(const void *data[], uint32_t data_len,
+			       uint32_t init_val, uint32_t hash[],
+			       int num) = crc32c_multi_sw;
+
+/*
+ * Toeplitz hash as used for NIC receive side scaling (RSS). Each set bit of
+ * the input XORs in the 32 key bits that start at the same bit position.
+ * Key bits beyond key_len are zero.
+ */
+
+/* Default RSS key (Microsoft RSS verification suite) */
+static const uint8_t toeplitz_default_key[ODP_HASH_TOEPLITZ_KEY_LEN] = {
+	0x6d, 0x5a, 0x56, 0xda, 0x25, 0x5b, 0x0e, 0xc2,
+	0x41, 0x67, 0x25, 0x3d, 0x43, 0xa3, 0x8f, 0xb0,
+	0xd0, 0xca, 0x2b, 0xcb, 0xae, 0x7b, 0x30, 0xb4,
+	0x77, 0xcb, 0x2d, 0xa3, 0x80, 0x30, 0xf2, 0x0c,
+	0x6a, 0x42, 0xb7, 0x3b, 0xbe, 0xac, 0x01, 0xfa
+};
+
+/* Per input nibble lookup tables for the default key. Input beyond the
+ * key length does not contribute to the hash. */
+static uint32_t toeplitz_default_tbl[2 * ODP_HASH_TOEPLITZ_KEY_LEN][16];
+static int toeplitz_default_tbl_ready;
+
+static inline uint8_t toeplitz_key_byte(const uint8_t *key, uint32_t key_len,
+					uint32_t i)
+{
+	return i < key_len ? key[i] : 0;
+}
+
+static uint32_t toeplitz_bits(const uint8_t *pd, uint32_t data_len,
+			      const uint8_t *key, uint32_t key_len)
+{
+	uint64_t window = 0;
+	uint32_t hash = 0;
+	uint32_t i;
+
+	/* Window holds key bits [8 * i, 8 * i + 64) */
+	for (i = 0; i < 8; i++)
+		window = (window << 8) | toeplitz_key_byte(key, key_len, i);
+
+	for (i = 0; i < data_len; i++) {
+		uint32_t byte = pd[i];
+
+		while (byte) {
+			int bit = __builtin_clz(byte) - 24;
+
+			hash ^= (uint32_t)(window >> (32 - bit));
+			byte &= ~(0x80u >> bit);
+		}
+
+		window = (window << 8) |
+			 toeplitz_key_byte(key, key_len, i + 8);
+	}
+
+	return hash;
+}
+
+static void toeplitz_default_tbl_init(void)
+{
+	uint32_t i, n;
+	uint8_t byte;
+
+	for (i = 0; i < 2 * ODP_HASH_TOEPLITZ_KEY_LEN; i++) {
+		const uint8_t *key = &toeplitz_default_key[i / 2];
+		uint32_t key_len = ODP_HASH_TOEPLITZ_KEY_LEN - i / 2;
+
+		for (n = 0; n < 16; n++) {
+			/* Nibble 'i' of the input set to 'n', others zero */
+			byte = (i & 1) ? n : n << 4;
+			toeplitz_default_tbl[i][n] =
+				toeplitz_bits(&byte, 1, key, key_len);
+		}
+	}
+
+	toeplitz_default_tbl_ready = 1;
+}
+
+static inline uint32_t toeplitz_tbl(const uint8_t *pd, uint32_t data_len)
+{
+	uint32_t hash = 0;
+	uint32_t i;
+
+	if (data_len > ODP_HASH_TOEPLITZ_KEY_LEN)
+		data_len = ODP_HASH_TOEPLITZ_KEY_LEN;
+
+	for (i = 0; i < data_len; i++)
+		hash ^= toeplitz_default_tbl[2 * i][pd[i] >> 4] ^
+			toeplitz_default_tbl[2 * i + 1][pd[i] & 0xf];
+
+	return hash;
+}
+
+/*
+ * xxHash (32 and 64 bit), Copyright (C) 2012-2016, Yann Collet.
+ * BSD 2-Clause License.
+ */
+#define XXH_PRIME32_1 2654435761U
+#define XXH_PRIME32_2 2246822519U
+#define XXH_PRIME32_3 3266489917U
+#define XXH_PRIME32_4  668265263U
+#define XXH_PRIME32_5  374761393U
+
+#define XXH_PRIME64_1 11400714785074694791ULL
+#define XXH_PRIME64_2 14029467366897019727ULL
+#define XXH_PRIME64_3  1609587929392839161ULL
+#define XXH_PRIME64_4  9650029242287828579ULL
+#define XXH_PRIME64_5  2870177450012600261ULL
+
+static inline uint32_t rotl32(uint32_t x, int r)
+{
+	return (x << r) | (x >> (32 - r));
+}
+
+static inline uint64_t rotl64(uint64_t x, int r)
+{
+	return (x << r) | (x >> (64 - r));
+}
+
+static inline uint32_t read_le32(const uint8_t *p)
+{
+	odp_u32le_t v;
+
+	memcpy(&v, p, sizeof(v));
+	return odp_le_to_cpu_32(v);
+}
+
+static inline uint64_t read_le64(const uint8_t *p)
+{
+	odp_u64le_t v;
+
+	memcpy(&v, p, sizeof(v));
+	return odp_le_to_cpu_64(v);
+}
+
+static inline uint32_t xxh32_round(uint32_t acc, uint32_t input)
+{
+	acc += input * XXH_PRIME32_2;
+	acc  = rotl32(acc, 13);
+	return acc * XXH_PRIME32_1;
+}
+
+static inline uint32_t xxh32_finalize(uint32_t h32, const uint8_t *p,
+				      uint32_t len)
+{
+	while (len >= 4) {
+		h32 += read_le32(p) * XXH_PRIME32_3;
+		h32  = rotl32(h32, 17) * XXH_PRIME32_4;
+		p   += 4;
+		len -= 4;
+	}
+
+	while (len) {
+		h32 += (*p) * XXH_PRIME32_5;
+		h32  = rotl32(h32, 11) * XXH_PRIME32_1;
+		p++;
+		len--;
+	}
+
+	h32 ^= h32 >> 15;
+	h32 *= XXH_PRIME32_2;
+	h32 ^= h32 >> 13;
+	h32 *= XXH_PRIME32_3;
+	h32 ^= h32 >> 16;
+
+	return h32;
+}
+
+static inline uint64_t xxh64_round(uint64_t acc, uint64_t input)
+{
+	acc += input * XXH_PRIME64_2;
+	acc  = rotl64(acc, 31);
+	return acc * XXH_PRIME64_1;
+}
+
+static inline uint64_t xxh64_merge(uint64_t acc, uint64_t val)
+{
+	acc ^= xxh64_round(0, val);
+	return acc * XXH_PRIME64_1 + XXH_PRIME64_4;
+}
+
+/*
+ * Short keys (< 16 bytes) are a single serial chain of multiplies, so four
+ * keys are hashed in the lanes of a 128 bit vector (SSE / NEON via GCC
+ * vector extensions). All keys have the same length, so the lanes follow
+ * the same control flow. Longer keys already have four independent
+ * accumulators per key and are hashed one at a time.
+ */
+#define XXH_MULTI_MAX_LEN 16
+
+typedef uint32_t xxh_u32x4_t __attribute__((vector_size(16)));
+
+#define XXH_VROTL(x, r) (((x) << (r)) | ((x) >> (32 - (r))))
+
+#define XXH_VLOAD(p, off) \
+	((xxh_u32x4_t){ read_le32((p)[0] + (off)), read_le32((p)[1] + (off)), \
+			read_le32((p)[2] + (off)), read_le32((p)[3] + (off)) })
+
+static void xxh32_short_x4(const uint8_t *p[4], uint32_t len, uint32_t seed,
+			   uint32_t hash[4])
+{
+	xxh_u32x4_t h32 = { 0, 0, 0, 0 };
+	uint32_t off = 0;
+	int i;
+
+	h32 += seed + XXH_PRIME32_5 + len;
+
+	while (off + 4 <= len) {
+		h32 += XXH_VLOAD(p, off) * XXH_PRIME32_3;
+		h32  = XXH_VROTL(h32, 17) * XXH_PRIME32_4;
+		off += 4;
+	}
+
+	for (i = 0; i < 4; i++)
+		hash[i] = xxh32_finalize(h32[i], p[i] + off, len - off);
+}
+
+/* Jenkins lookup3 hashlittle(), Bob Jenkins 2006, public domain */
+#define JHASH_MIX(a, b, c) \
+do { \
+	a -= c; a ^= rotl32(c, 4);  c += b; \
+	b -= a; b ^= rotl32(a, 6);  a += c; \
+	c -= b; c ^= rotl32(b, 8);  b += a; \
+	a -= c; a ^= rotl32(c, 16); c += b; \
+	b -= a; b ^= rotl32(a, 19); a += c; \
+	c -= b; c ^= rotl32(b, 4);  b += a; \
+} while (0)
+
+#define JHASH_FINAL(a, b, c) \
+do { \
+	c ^= b; c -= rotl32(b, 14); \
+	a ^= c; a -= rotl32(c, 11); \
+	b ^= a; b -= rotl32(a, 25); \
+	c ^= b; c -= rotl32(b, 16); \
+	a ^= c; a -= rotl32(c, 4);  \
+	b ^= a; b -= rotl32(a, 14); \
+	c ^= b; c -= rotl32(b, 24); \
+} while (0)
+
+int odp_hash_init_global(void)
+{
+	toeplitz_default_tbl_init();
+
+#ifdef CRC32C_HW
+	if (crc32c_hw_supported()) {
+		crc32c_zeros(crc32c_long, CRC32C_LONG);
+		crc32c_zeros(crc32c_short, CRC32C_SHORT);
+		crc32c_fn = crc32c_hw;
+		crc32c_multi_fn = crc32c_multi_hw;
+		ODP_DBG("CRC32C: using %s instructions\n", CRC32C_HW_NAME);
+		return 0;
+	}
+#endif
+	crc32c_fn = crc32c_sw;
+	crc32c_multi_fn = crc32c_multi_sw;
+	ODP_DBG("CRC32C: using lookup tables\n");
+
+	return 0;
+}
+
+int odp_hash_term_global(void)
+{
+	crc32c_fn = crc32c_sw;
+	crc32c_multi_fn = crc32c_multi_sw;
+
+	return 0;
+}
+
+uint32_t odp_hash_crc32c(const void *data, uint32_t data_len,
+			 uint32_t init_val)
+{
+	return crc32c_fn(data, data_len, init_val);
+}
+
+void odp_hash_crc32c_multi(const void *data[], uint32_t data_len,
+			   uint32_t init_val, uint32_t hash[], int num)
+{
+	crc32c_multi_fn(data, data_len, init_val, hash, num);
+}
+
+uint32_t odp_hash_toeplitz(const void *data, uint32_t data_len,
+			   const uint8_t *key, uint32_t key_len)
+{
+	if (key == NULL) {
+		if (odp_likely(toeplitz_default_tbl_ready))
+			return toeplitz_tbl(data, data_len);
+
+		key = toeplitz_default_key;
+		key_len = ODP_HASH_TOEPLITZ_KEY_LEN;
+	}
+
+	return toeplitz_bits(data, data_len, key, key_len);
+}
+
+uint32_t odp_hash_xxh32(const void *data, uint32_t data_len, uint32_t seed)
+{
+	const uint8_t *p = data;
+	uint32_t len = data_len;
+	uint32_t h32;
+
+	if (len >= 16) {
+		uint32_t v1 = seed + XXH_PRIME32_1 + XXH_PRIME32_2;
+		uint32_t v2 = seed + XXH_PRIME32_2;
+		uint32_t v3 = seed;
+		uint32_t v4 = seed - XXH_PRIME32_1;
+
+		do {
+			v1 = xxh32_round(v1, read_le32(p));
+			v2 = xxh32_round(v2, read_le32(p + 4));
+			v3 = xxh32_round(v3, read_le32(p + 8));
+			v4 = xxh32_round(v4, read_le32(p + 12));
+			p   += 16;
+			len -= 16;
+		} while (len >= 16);
+
+		h32 = rotl32(v1, 1) + rotl32(v2, 7) +
+		      rotl32(v3, 12) + rotl32(v4, 18);
+	} else {
+		h32 = seed + XXH_PRIME32_5;
+	}
+
+	return xxh32_finalize(h32 + data_len, p, len);
+}
+
+void odp_hash_xxh32_multi(const void *data[], uint32_t data_len,
+			  uint32_t seed, uint32_t hash[], int num)
+{
+	int i = 0;
+
+	if (data_len < XXH_MULTI_MAX_LEN) {
+		for (; i + 4 <= num; i += 4)
+			xxh32_short_x4((const uint8_t **)&data[i], data_len,
+				       seed, &hash[i]);
+	}
+
+	for (; i < num; i++)
+		hash[i] = odp_hash_xxh32(data[i], data_len, seed);
+}
+
+uint64_t odp_hash_xxh64(const void *data, uint32_t data_len, uint64_t seed)
+{
+	const uint8_t *p = data;
+	uint32_t len = data_len;
+	uint64_t h64;
+
+	if (len >= 32) {
+		uint64_t v1 = seed + XXH_PRIME64_1 + XXH_PRIME64_2;
+		uint64_t v2 = seed + XXH_PRIME64_2;
+		uint64_t v3 = seed;
+		uint64_t v4 = seed - XXH_PRIME64_1;
+
+		do {
+			v1 = xxh64_round(v1, read_le64(p));
+			v2 = xxh64_round(v2, read_le64(p + 8));
+			v3 = xxh64_round(v3, read_le64(p + 16));
+			v4 = xxh64_round(v4, read_le64(p + 24));
+			p   += 32;
+			len -= 32;
+		} while (len >= 32);
+
+		h64 = rotl64(v1, 1) + rotl64(v2, 7) +
+		      rotl64(v3, 12) + rotl64(v4, 18);
+		h64 = xxh64_merge(h64, v1);
+		h64 = xxh64_merge(h64, v2);
+		h64 = xxh64_merge(h64, v3);
+		h64 = xxh64_merge(h64, v4);
+	} else {
+		h64 = seed + XXH_PRIME64_5;
+	}
+
+	h64 += data_len;
+
+	while (len >= 8) {
+		h64 ^= xxh64_round(0, read_le64(p));
+		h64  = rotl64(h64, 27) * XXH_PRIME64_1 + XXH_PRIME64_4;
+		p   += 8;
+		len -= 8;
+	}
+
+	if (len >= 4) {
+		h64 ^= (uint64_t)read_le32(p) * XXH_PRIME64_1;
+		h64  = rotl64(h64, 23) * XXH_PRIME64_2 + XXH_PRIME64_3;
+		p   += 4;
+		len -= 4;
+	}
+
+	while (len) {
+		h64 ^= (*p) * XXH_PRIME64_5;
+		h64  = rotl64(h64, 11) * XXH_PRIME64_1;
+		p++;
+		len--;
+	}
+
+	h64 ^= h64 >> 33;
+	h64 *= XXH_PRIME64_2;
+	h64 ^= h64 >> 29;
+	h64 *= XXH_PRIME64_3;
+	h64 ^= h64 >> 32;
+
+	return h64;
+}
+
+uint32_t odp_hash_jhash(const void *data, uint32_t data_len,
+			uint32_t init_val)
+{
+	const uint8_t *k = data;
+	uint32_t len = data_len;
+	uint32_t a, b, c;
+
+	a = 0xdeadbeef + data_len + init_val;
+	b = a;
+	c = a;
+
+	while (len > 12) {
+		a += read_le32(k);
+		b += read_le32(k + 4);
+		c += read_le32(k + 8);
+		JHASH_MIX(a, b, c);
+		len -= 12;
+		k   += 12;
+	}
+
+	switch (len) {
+	case 12:
+		c += (uint32_t)k[11] << 24;
+		/* Fallthrough */
+	case 11:
+		c += (uint32_t)k[10] << 16;
+		/* Fallthrough */
+	case 10:
+		c += (uint32_t)k[9] << 8;
+		/* Fallthrough */
+	case 9:
+		c += k[8];
+		/* Fallthrough */
+	case 8:
+		b += (uint32_t)k[7] << 24;
+		/* Fallthrough */
+	case 7:
+		b += (uint32_t)k[6] << 16;
+		/* Fallthrough */
+	case 6:
+		b += (uint32_t)k[5] << 8;
+		/* Fallthrough */
+	case 5:
+		b += k[4];
+		/* Fallthrough */
+	case 4:
+		a += (uint32_t)k[3] << 24;
+		/* Fallthrough */
+	case 3:
+		a += (uint32_t)k[2] << 16;
+		/* Fallthrough */
+	case 2:
+		a += (uint32_t)k[1] << 8;
+		/* Fallthrough */
+	case 1:
+		a += k[0];
+		break;
+	default:
+		return c;
+	}
+
+	JHASH_FINAL(a, b, c);
+
+	return c;
+}
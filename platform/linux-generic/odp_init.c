@@ -51,6 +51,12 @@ int odp_init_global(odp_instance_t *instance,
 	}
 	stage = SYSINFO_INIT;
 
+	if (odp_hash_init_global()) {
+		ODP_ERR("ODP hash init failed.\n");
+		goto init_failed;
+	}
+	stage = HASH_INIT;
+
 	if (odp_shm_init_global()) {
 		ODP_ERR("ODP shm init failed.\n");
 		goto init_failed;
@@ -217,6 +223,13 @@ int _odp_term_global(enum init_stage stage)
 		}
 		/* Fall through */
 
+	case HASH_INIT:
+		if (odp_hash_term_global()) {
+			ODP_ERR("ODP hash term failed.\n");
+			rc = -1;
+		}
+		/* Fall through */
+
 	case SYSINFO_INIT:
 		if (odp_system_info_term()) {
 			ODP_ERR("ODP system info term failed.\n");
@@ -9,6 +9,7 @@
 #include <odp_debug_internal.h>
 #include <odp/api/hints.h>
 #include <odp/api/byteorder.h>
+#include <odp/api/hash.h>
 
 #include <protocols/eth.h>
 #include <protocols/ip.h>
@@ -17,6 +18,7 @@
 
 #include <ctype.h>	/* isprint() */
 #include <errno.h>
+#include <stddef.h>
 #include <string.h>
 #include <stdio.h>
 #include <inttypes.h>
@@ -80,6 +82,71 @@ static void packet_init(pool_entry_t *pool, odp_packet_hdr_t *pkt_hdr,
 	pkt_hdr->input = ODP_PKTIO_INVALID;
 }
 
+/**
+ * Copy on write
+ *
+ * Replace segments that share data with other packets, between buffer
+ * offsets 'start' and 'end', with private copies of the data.
+ */
+static int packet_unshare(odp_packet_hdr_t *pkt_hdr, uint32_t start,
+			  uint32_t end)
+{
+	odp_buffer_hdr_t *buf_hdr = &pkt_hdr->buf_hdr;
+	pool_entry_t *pool;
+	uint32_t segsize = buf_hdr->segsize;
+	uint32_t data_start = pkt_hdr->headroom;
+	uint32_t data_end = pkt_hdr->headroom + pkt_hdr->frame_len;
+	uint32_t seg, seg_start, lo, hi;
+	uint8_t *blk;
+
+	if (odp_likely(!buf_hdr->flags.sharedseg))
+		return 0;
+
+	pool = odp_buf_to_pool(buf_hdr);
+
+	if (end > buf_hdr->size)
+		end = buf_hdr->size;
+
+	if (start >= end)
+		return 0;
+
+	for (seg = start / segsize; seg * segsize < end; seg++) {
+		if (!seg_is_shared(&pool->s, buf_hdr->addr[seg]))
+			continue;
+
+		blk = get_blk(&pool->s);
+		if (blk == NULL)
+			return -1;
+
+		seg_start = seg * segsize;
+		lo = data_start > seg_start ? data_start : seg_start;
+		hi = data_end < seg_start + segsize ?
+		     data_end : seg_start + segsize;
+		if (lo < hi)
+			memcpy(blk + lo - seg_start,
+			       (uint8_t *)buf_hdr->addr[seg] + lo - seg_start,
+			       hi - lo);
+
+		ret_seg(&pool->s, buf_hdr->addr[seg]);
+		buf_hdr->addr[seg] = blk;
+
+		/* A shared last segment may have less tailroom than
+		 * the segment size implies */
+		if (seg == buf_hdr->segcount - 1)
+			pkt_hdr->tailroom = buf_hdr->size - data_end;
+	}
+
+	if (start == 0 && end == buf_hdr->size)
+		buf_hdr->flags.sharedseg = 0;
+
+	return 0;
+}
+
+static inline int packet_unshare_all(odp_packet_hdr_t *pkt_hdr)
+{
+	return packet_unshare(pkt_hdr, 0, pkt_hdr->buf_hdr.size);
+}
+
 int packet_alloc_multi(odp_pool_t pool_hdl, uint32_t len,
 		       odp_packet_t pkt[], int max_num)
 {
@@ -100,6 +167,98 @@ int packet_alloc_multi(odp_pool_t pool_hdl, uint32_t len,
 	return num;
 }
 
+int packet_alloc_recycle(pool_recycle_t *rc, odp_pool_t pool_hdl,
+			 uint32_t len, odp_packet_t pkt[], int max_num)
+{
+	pool_entry_t *pool = odp_pool_to_entry(pool_hdl);
+	uint32_t totsize = pool->s.headroom + len + pool->s.tailroom;
+	uint32_t num_buf = rc->s.num_buf;
+	odp_packet_hdr_t *pkt_hdr;
+	int num = 0;
+	int hits, ret;
+
+	while (num < max_num && num_buf) {
+		pkt_hdr = (odp_packet_hdr_t *)rc->s.buf[--num_buf];
+
+		/* Buffer lost segments while in use, return it to the pool */
+		if (odp_unlikely(pkt_hdr->buf_hdr.size < totsize)) {
+			odp_packet_free(_odp_packet_from_buffer(
+				odp_hdr_to_buf(&pkt_hdr->buf_hdr)));
+			continue;
+		}
+
+		pkt_hdr->buf_hdr.origin_qe = NULL;
+		packet_init(pool, pkt_hdr, len, 1 /* do parse */);
+
+		if (pkt_hdr->tailroom >= pkt_hdr->buf_hdr.segsize)
+			pull_tail_seg(pkt_hdr);
+
+		pkt[num++] = _odp_packet_from_buffer(
+			odp_hdr_to_buf(&pkt_hdr->buf_hdr));
+	}
+
+	rc->s.num_buf = num_buf;
+	hits = num;
+
+	if (odp_unlikely(num < max_num)) {
+		if (pool->s.params.stats.bit.recycle_misses)
+			odp_atomic_add_u64(&pool->s.poolstats.recycle_misses,
+					   max_num - num);
+
+		ret = packet_alloc_multi(pool_hdl, len, &pkt[num],
+					 max_num - num);
+		if (ret > 0)
+			num += ret;
+	}
+
+	if (hits && pool->s.params.stats.bit.recycle_hits)
+		odp_atomic_add_u64(&pool->s.poolstats.recycle_hits, hits);
+
+	return num;
+}
+
+void packet_free_recycle(pool_recycle_t *rc, odp_pool_t pool_hdl,
+			 const odp_packet_t pkt[], int num)
+{
+	odp_packet_t rest[num > 0 ? num : 1];
+	int num_rest = 0;
+	int i;
+
+	for (i = 0; i < num; i++) {
+		odp_packet_hdr_t *pkt_hdr = odp_packet_hdr(pkt[i]);
+		odp_buffer_hdr_t *buf_hdr = &pkt_hdr->buf_hdr;
+
+		/* Only private buffers of the pktio input pool */
+		if (odp_likely(buf_hdr->pool_hdl == pool_hdl &&
+			       !buf_hdr->flags.sharedseg &&
+#ifdef MV_NETMAP_BUF_ZERO_COPY
+			       !is_ext_buffer(buf_hdr) &&
+#endif
+			       rc->s.num_buf < POOL_RECYCLE_BUFS))
+			rc->s.buf[rc->s.num_buf++] = buf_hdr;
+		else
+			rest[num_rest++] = pkt[i];
+	}
+
+	if (num_rest)
+		odp_packet_free_multi(rest, num_rest);
+}
+
+void packet_recycle_flush(pool_recycle_t *rc)
+{
+	odp_packet_t pkt[POOL_RECYCLE_BUFS];
+	uint32_t i, num = rc->s.num_buf;
+
+	for (i = 0; i < num; i++)
+		pkt[i] = _odp_packet_from_buffer(
+			odp_hdr_to_buf(rc->s.buf[i]));
+
+	rc->s.num_buf = 0;
+
+	if (num)
+		odp_packet_free_multi(pkt, num);
+}
+
 odp_packet_t odp_packet_alloc(odp_pool_t pool_hdl, uint32_t len)
 {
 	pool_entry_t *pool = odp_pool_to_entry(pool_hdl);
@@ -176,7 +335,7 @@ int odp_packet_reset(odp_packet_t pkt, uint32_t len)
 	pool_entry_t *pool = odp_buf_to_pool(&pkt_hdr->buf_hdr);
 	uint32_t totsize = pool->s.headroom + len + pool->s.tailroom;
 
-	if (totsize > pkt_hdr->buf_hdr.size)
+	if (totsize > pkt_hdr->buf_hdr.size || packet_unshare_all(pkt_hdr))
 		return -1;
 
 	packet_init(pool, pkt_hdr, len, 0);
@@ -268,7 +427,8 @@ void *odp_packet_push_head(odp_packet_t pkt, uint32_t len)
 {
 	odp_packet_hdr_t *pkt_hdr = odp_packet_hdr(pkt);
 
-	if (len > pkt_hdr->headroom)
+	if (len > pkt_hdr->headroom ||
+	    packet_unshare(pkt_hdr, pkt_hdr->headroom - len, pkt_hdr->headroom))
 		return NULL;
 
 	push_head(pkt_hdr, len);
@@ -280,7 +440,8 @@ int odp_packet_extend_head(odp_packet_t *pkt, uint32_t len,
 {
 	odp_packet_hdr_t *pkt_hdr = odp_packet_hdr(*pkt);
 
-	if (len > pkt_hdr->headroom && push_head_seg(pkt_hdr, len))
+	if ((len > pkt_hdr->headroom && push_head_seg(pkt_hdr, len)) ||
+	    packet_unshare(pkt_hdr, pkt_hdr->headroom - len, pkt_hdr->headroom))
 		return -1;
 
 	push_head(pkt_hdr, len);
@@ -322,8 +483,9 @@ void *odp_packet_push_tail(odp_packet_t pkt, uint32_t len)
 {
 	odp_packet_hdr_t *pkt_hdr = odp_packet_hdr(pkt);
 	uint32_t origin = pkt_hdr->frame_len;
+	uint32_t end = pkt_hdr->headroom + origin;
 
-	if (len > pkt_hdr->tailroom)
+	if (len > pkt_hdr->tailroom || packet_unshare(pkt_hdr, end, end + len))
 		return NULL;
 
 	push_tail(pkt_hdr, len);
@@ -335,8 +497,11 @@ int odp_packet_extend_tail(odp_packet_t *pkt, uint32_t len,
 {
 	odp_packet_hdr_t *pkt_hdr = odp_packet_hdr(*pkt);
 	uint32_t origin = pkt_hdr->frame_len;
+	uint32_t end = pkt_hdr->headroom + origin;
 
-	if (len > pkt_hdr->tailroom && push_tail_seg(pkt_hdr, len))
+	/* Copy a shared last segment first, its tailroom may grow */
+	if (packet_unshare(pkt_hdr, end, end + len) ||
+	    (len > pkt_hdr->tailroom && push_tail_seg(pkt_hdr, len)))
 		return -1;
 
 	push_tail(pkt_hdr, len);
@@ -440,6 +605,9 @@ void *odp_packet_l2_ptr(odp_packet_t pkt, uint32_t *len)
 {
 	odp_packet_hdr_t *pkt_hdr = odp_packet_hdr(pkt);
 
+	if (packet_parse_l2_not_done(&pkt_hdr->p))
+		packet_parse_l2(&pkt_hdr->p, pkt_hdr->frame_len);
+
 	if (!packet_hdr_has_l2(pkt_hdr))
 		return NULL;
 	return packet_map(pkt_hdr, pkt_hdr->p.l2_offset, len);
@@ -449,6 +617,9 @@ uint32_t odp_packet_l2_offset(odp_packet_t pkt)
 {
 	odp_packet_hdr_t *pkt_hdr = odp_packet_hdr(pkt);
 
+	if (packet_parse_l2_not_done(&pkt_hdr->p))
+		packet_parse_l2(&pkt_hdr->p, pkt_hdr->frame_len);
+
 	if (!packet_hdr_has_l2(pkt_hdr))
 		return ODP_PACKET_OFFSET_INVALID;
 	return pkt_hdr->p.l2_offset;
@@ -461,6 +632,9 @@ int odp_packet_l2_offset_set(odp_packet_t pkt, uint32_t offset)
 	if (offset >= pkt_hdr->frame_len)
 		return -1;
 
+	if (packet_parse_l2_not_done(&pkt_hdr->p))
+		packet_parse_l2(&pkt_hdr->p, pkt_hdr->frame_len);
+
 	packet_hdr_has_l2_set(pkt_hdr, 1);
 	pkt_hdr->p.l2_offset = offset;
 	return 0;
@@ -543,6 +717,77 @@ void odp_packet_flow_hash_set(odp_packet_t pkt, uint32_t flow_hash)
 	pkt_hdr->p.input_flags.flow_hash = 1;
 }
 
+/* Copy 'len' bytes of header data at 'offset' into 'dst' */
+static inline int flow_hash_copy(odp_packet_t pkt, odp_packet_hdr_t *pkt_hdr,
+				 uint32_t offset, uint8_t *dst, uint32_t len)
+{
+	uint32_t seglen = 0;
+	uint8_t *src;
+
+	if (offset + len > packet_len(pkt_hdr))
+		return -1;
+
+	src = packet_map(pkt_hdr, offset, &seglen);
+
+	if (odp_likely(src != NULL && seglen >= len)) {
+		memcpy(dst, src, len);
+		return 0;
+	}
+
+	return odp_packet_copy_to_mem(pkt, offset, len, dst);
+}
+
+int odp_packet_flow_hash_calc_multi(const odp_packet_t pkt[], int num,
+				    const uint8_t *key, uint32_t key_len)
+{
+	/* IPv6 addresses + ports */
+	uint8_t tuple[2 * _ODP_IPV6ADDR_LEN + 4];
+	int i, done = 0;
+
+	for (i = 0; i < num; i++) {
+		odp_packet_hdr_t *pkt_hdr = odp_packet_hdr(pkt[i]);
+		packet_parser_t *prs = &pkt_hdr->p;
+		uint32_t addr_offset, addr_len;
+		uint32_t len;
+
+		if (packet_parse_not_complete(pkt_hdr))
+			packet_parse_layer(pkt_hdr, LAYER_ALL);
+
+		if (prs->input_flags.ipv4) {
+			addr_offset = prs->l3_offset +
+				      offsetof(_odp_ipv4hdr_t, src_addr);
+			addr_len = 2 * _ODP_IPV4ADDR_LEN;
+		} else if (prs->input_flags.ipv6) {
+			addr_offset = prs->l3_offset +
+				      offsetof(_odp_ipv6hdr_t, src_addr);
+			addr_len = 2 * _ODP_IPV6ADDR_LEN;
+		} else {
+			continue;
+		}
+
+		if (flow_hash_copy(pkt[i], pkt_hdr, addr_offset, tuple,
+				   addr_len))
+			continue;
+
+		len = addr_len;
+
+		/* Source and destination ports are at the same offset in
+		 * TCP and UDP headers */
+		if ((prs->input_flags.tcp || prs->input_flags.udp) &&
+		    !prs->input_flags.ipfrag &&
+		    flow_hash_copy(pkt[i], pkt_hdr, prs->l4_offset,
+				   &tuple[addr_len], 4) == 0)
+			len += 4;
+
+		pkt_hdr->flow_hash = odp_hash_toeplitz(tuple, len, key,
+						       key_len);
+		prs->input_flags.flow_hash = 1;
+		done++;
+	}
+
+	return done;
+}
+
 odp_time_t odp_packet_ts(odp_packet_t pkt)
 {
 	odp_packet_hdr_t *pkt_hdr = odp_packet_hdr(pkt);
@@ -624,16 +869,124 @@ uint32_t odp_packet_seg_data_len(odp_packet_t pkt, odp_packet_seg_t seg)
  *
  */
 
-int odp_packet_add_data(odp_packet_t *pkt_ptr, uint32_t offset, uint32_t len)
+/* Move packet data within a packet. Overlapping areas are handled in both
+ * directions, without a temporary copy. */
+static void packet_move(odp_packet_hdr_t *pkt_hdr, uint32_t dst_offset,
+			uint32_t src_offset, uint32_t len)
+{
+	uint32_t segsize = pkt_hdr->buf_hdr.segsize;
+	uint32_t dst_seglen = 0; /* GCC */
+	uint32_t src_seglen = 0; /* GCC */
+	uint32_t dst_pos, src_pos, cpylen;
+	uint8_t *dst_map;
+	uint8_t *src_map;
+
+	if (dst_offset <= src_offset) {
+		while (len > 0) {
+			dst_map = packet_map(pkt_hdr, dst_offset, &dst_seglen);
+			src_map = packet_map(pkt_hdr, src_offset, &src_seglen);
+
+			cpylen = dst_seglen > src_seglen ?
+				 src_seglen : dst_seglen;
+			cpylen = len > cpylen ? cpylen : len;
+			memmove(dst_map, src_map, cpylen);
+
+			dst_offset += cpylen;
+			src_offset += cpylen;
+			len        -= cpylen;
+		}
+		return;
+	}
+
+	/* Copy backwards from the end of the area. Map the last byte of both
+	 * areas, and copy what precedes it in both segments. */
+	dst_pos = pkt_hdr->headroom + dst_offset + len;
+	src_pos = pkt_hdr->headroom + src_offset + len;
+
+	while (len > 0) {
+		dst_map = buffer_map(&pkt_hdr->buf_hdr, dst_pos - 1, NULL, 0);
+		src_map = buffer_map(&pkt_hdr->buf_hdr, src_pos - 1, NULL, 0);
+		dst_seglen = (dst_pos - 1) % segsize + 1;
+		src_seglen = (src_pos - 1) % segsize + 1;
+
+		cpylen = dst_seglen > src_seglen ? src_seglen : dst_seglen;
+		cpylen = len > cpylen ? cpylen : len;
+		memmove(dst_map + 1 - cpylen, src_map + 1 - cpylen, cpylen);
+
+		dst_pos -= cpylen;
+		src_pos -= cpylen;
+		len     -= cpylen;
+	}
+}
+
+/* Segments of both packets may be moved between the packet headers */
+static inline int packet_seg_relink_ok(odp_packet_hdr_t *dst_hdr,
+				       odp_packet_hdr_t *src_hdr)
+{
+	if (dst_hdr->buf_hdr.pool_hdl != src_hdr->buf_hdr.pool_hdl)
+		return 0;
+
+#ifdef MV_NETMAP_BUF_ZERO_COPY
+	if (is_ext_buffer(&dst_hdr->buf_hdr) ||
+	    is_ext_buffer(&src_hdr->buf_hdr))
+		return 0;
+#endif
+	return 1;
+}
+
+static inline void packet_set_seg_count(odp_packet_hdr_t *pkt_hdr,
+					uint32_t segcount)
+{
+	pkt_hdr->buf_hdr.segcount = segcount;
+	pkt_hdr->buf_hdr.size     = segcount * pkt_hdr->buf_hdr.segsize;
+	pkt_hdr->tailroom         = pkt_hdr->buf_hdr.size -
+				    pkt_hdr->headroom - pkt_hdr->frame_len;
+}
+
+/* Swap data segments, and the data layout within them, of two packets of
+ * the same pool. Metadata stays with the packet header. */
+static void packet_swap_data(odp_packet_hdr_t *a, odp_packet_hdr_t *b)
+{
+	uint32_t num = a->buf_hdr.segcount > b->buf_hdr.segcount ?
+		       a->buf_hdr.segcount : b->buf_hdr.segcount;
+	uint32_t i, tmp;
+	void *addr;
+
+	for (i = 0; i < num; i++) {
+		addr = a->buf_hdr.addr[i];
+		a->buf_hdr.addr[i] = b->buf_hdr.addr[i];
+		b->buf_hdr.addr[i] = addr;
+	}
+
+	tmp = a->buf_hdr.segcount;
+	a->buf_hdr.segcount = b->buf_hdr.segcount;
+	b->buf_hdr.segcount = tmp;
+
+	tmp = a->buf_hdr.size;
+	a->buf_hdr.size = b->buf_hdr.size;
+	b->buf_hdr.size = tmp;
+
+	tmp = a->headroom;
+	a->headroom = b->headroom;
+	b->headroom = tmp;
+
+	tmp = a->tailroom;
+	a->tailroom = b->tailroom;
+	b->tailroom = tmp;
+
+	tmp = a->frame_len;
+	a->frame_len = b->frame_len;
+	b->frame_len = tmp;
+}
+
+static int packet_add_data_copy(odp_packet_t *pkt_ptr, uint32_t offset,
+				uint32_t len)
 {
 	odp_packet_t pkt = *pkt_ptr;
 	odp_packet_hdr_t *pkt_hdr = odp_packet_hdr(pkt);
 	uint32_t pktlen = pkt_hdr->frame_len;
 	odp_packet_t newpkt;
 
-	if (offset > pktlen)
-		return -1;
-
 	newpkt = odp_packet_alloc(pkt_hdr->buf_hdr.pool_hdl, pktlen + len);
 
 	if (newpkt == ODP_PACKET_INVALID)
@@ -653,35 +1006,77 @@ int odp_packet_add_data(odp_packet_t *pkt_ptr, uint32_t offset, uint32_t len)
 	return 1;
 }
 
-int odp_packet_rem_data(odp_packet_t *pkt_ptr, uint32_t offset, uint32_t len)
+int odp_packet_add_data(odp_packet_t *pkt_ptr, uint32_t offset, uint32_t len)
 {
-	odp_packet_t pkt = *pkt_ptr;
-	odp_packet_hdr_t *pkt_hdr = odp_packet_hdr(pkt);
+	odp_packet_hdr_t *pkt_hdr = odp_packet_hdr(*pkt_ptr);
 	uint32_t pktlen = pkt_hdr->frame_len;
-	odp_packet_t newpkt;
+	int ext = 0;
 
-	if (offset > pktlen || offset + len > pktlen)
+	if (offset > pktlen || packet_unshare_all(pkt_hdr))
 		return -1;
 
-	newpkt = odp_packet_alloc(pkt_hdr->buf_hdr.pool_hdl, pktlen - len);
-
-	if (newpkt == ODP_PACKET_INVALID)
-		return -1;
+#ifdef MV_NETMAP_BUF_ZERO_COPY
+	ext = is_packet_buf_ext(*pkt_ptr);
+#endif
+
+	/* Open the gap by moving the shorter part of the packet into
+	 * headroom or tailroom. Segments are added to the head or tail when
+	 * there is not enough room, the rest of the packet is not copied. */
+	if (offset <= pktlen - offset) {
+		if (len > pkt_hdr->headroom) {
+			if (ext)
+				return packet_add_data_copy(pkt_ptr, offset,
+							    len);
+			if (push_head_seg(pkt_hdr, len))
+				return -1;
+		}
 
-	if (odp_packet_copy_from_pkt(newpkt, 0, pkt, 0, offset) != 0 ||
-	    odp_packet_copy_from_pkt(newpkt, offset, pkt, offset + len,
-				     pktlen - offset - len) != 0) {
-		odp_packet_free(newpkt);
-		return -1;
+		push_head(pkt_hdr, len);
+		packet_move(pkt_hdr, 0, len, offset);
+		return offset ? 1 : 0;
 	}
 
-	_odp_packet_copy_md_to_packet(pkt, newpkt);
-	odp_packet_free(pkt);
-	*pkt_ptr = newpkt;
+	if (len > pkt_hdr->tailroom) {
+		if (ext)
+			return packet_add_data_copy(pkt_ptr, offset, len);
+		if (push_tail_seg(pkt_hdr, len))
+			return -1;
+	}
 
+	push_tail(pkt_hdr, len);
+	packet_move(pkt_hdr, offset + len, offset, pktlen - offset);
 	return 1;
 }
 
+int odp_packet_rem_data(odp_packet_t *pkt_ptr, uint32_t offset, uint32_t len)
+{
+	odp_packet_hdr_t *pkt_hdr = odp_packet_hdr(*pkt_ptr);
+	uint32_t pktlen = pkt_hdr->frame_len;
+	uint32_t tail_len;
+
+	if (offset > pktlen || len > pktlen - offset ||
+	    packet_unshare_all(pkt_hdr))
+		return -1;
+
+	/* Close the gap by moving the shorter part of the packet. Segments
+	 * left with no data are released. */
+	tail_len = pktlen - offset - len;
+
+	if (offset <= tail_len) {
+		packet_move(pkt_hdr, len, 0, offset);
+		pull_head(pkt_hdr, len);
+		if (pkt_hdr->headroom >= pkt_hdr->buf_hdr.segsize)
+			pull_head_seg(pkt_hdr);
+		return offset ? 1 : 0;
+	}
+
+	packet_move(pkt_hdr, offset, offset + len, tail_len);
+	pull_tail(pkt_hdr, len);
+	if (pkt_hdr->tailroom >= pkt_hdr->buf_hdr.segsize)
+		pull_tail_seg(pkt_hdr);
+	return tail_len ? 1 : 0;
+}
+
 int odp_packet_align(odp_packet_t *pkt, uint32_t offset, uint32_t len,
 		     uint32_t align)
 {
@@ -724,10 +1119,86 @@ int odp_packet_align(odp_packet_t *pkt, uint32_t offset, uint32_t len,
 	return 1;
 }
 
+/* Append source segments to the destination, when the source data starts
+ * at the same offset within a segment as where the destination data ends.
+ * Only the part of the source that shares a segment with the destination
+ * tail is copied. */
+static int packet_concat_relink(odp_packet_hdr_t *dst_hdr,
+				odp_packet_hdr_t *src_hdr)
+{
+	uint32_t segsize = dst_hdr->buf_hdr.segsize;
+	uint32_t dst_end = dst_hdr->headroom + dst_hdr->frame_len;
+	uint32_t src_start = src_hdr->headroom;
+	uint32_t in_seg = dst_end % segsize;
+	uint32_t dst_segs = (dst_end + segsize - 1) / segsize;
+	uint32_t first = (src_start + segsize - 1) / segsize;
+	uint32_t num = src_hdr->buf_hdr.segcount - first;
+	uint32_t i;
+
+	if (dst_segs + num > ODP_BUFFER_MAX_SEG)
+		return -1;
+
+	if (in_seg)
+		memcpy(buffer_map(&dst_hdr->buf_hdr, dst_end, NULL, 0),
+		       buffer_map(&src_hdr->buf_hdr, src_start, NULL, 0),
+		       segsize - in_seg);
+
+	if (dst_hdr->buf_hdr.segcount > dst_segs)
+		seg_free_tail(&dst_hdr->buf_hdr,
+			      dst_hdr->buf_hdr.segcount - dst_segs);
+
+	for (i = 0; i < num; i++)
+		dst_hdr->buf_hdr.addr[dst_segs + i] =
+			src_hdr->buf_hdr.addr[first + i];
+
+	dst_hdr->frame_len += src_hdr->frame_len;
+	packet_set_seg_count(dst_hdr, dst_segs + num);
+
+	/* Source keeps only the segments that were not moved */
+	src_hdr->frame_len = 0;
+	src_hdr->headroom  = 0;
+	packet_set_seg_count(src_hdr, first);
+	return 0;
+}
+
 int odp_packet_concat(odp_packet_t *dst, odp_packet_t src)
 {
-	uint32_t dst_len = odp_packet_len(*dst);
-	uint32_t src_len = odp_packet_len(src);
+	odp_packet_hdr_t *dst_hdr = odp_packet_hdr(*dst);
+	odp_packet_hdr_t *src_hdr = odp_packet_hdr(src);
+	uint32_t dst_len = dst_hdr->frame_len;
+	uint32_t src_len = src_hdr->frame_len;
+	uint32_t segsize = dst_hdr->buf_hdr.segsize;
+
+	if (packet_unshare_all(dst_hdr) || packet_unshare_all(src_hdr))
+		return -1;
+
+	if (src != *dst && packet_seg_relink_ok(dst_hdr, src_hdr)) {
+		uint32_t dst_end = dst_hdr->headroom + dst_len;
+
+		uint32_t in_seg = dst_end % segsize;
+
+		/* Segment aligned source, which does not fit into the last
+		 * destination data segment */
+		if (in_seg == src_hdr->headroom % segsize &&
+		    (in_seg == 0 || src_len > segsize - in_seg) &&
+		    packet_concat_relink(dst_hdr, src_hdr) == 0) {
+			odp_packet_free(src);
+			return 0;
+		}
+
+		/* Copy the shorter destination in front of the source data
+		 * and swap data segments between the packets */
+		if (dst_len < src_len &&
+		    (dst_len <= src_hdr->headroom ||
+		     push_head_seg(src_hdr, dst_len) == 0)) {
+			push_head(src_hdr, dst_len);
+			(void)odp_packet_copy_from_pkt(src, 0, *dst, 0,
+						       dst_len);
+			packet_swap_data(dst_hdr, src_hdr);
+			odp_packet_free(src);
+			return 1;
+		}
+	}
 
 	if (odp_packet_extend_tail(dst, src_len, NULL, NULL) >= 0) {
 		(void)odp_packet_copy_from_pkt(*dst, dst_len,
@@ -742,18 +1213,254 @@ int odp_packet_concat(odp_packet_t *dst, odp_packet_t src)
 
 int odp_packet_split(odp_packet_t *pkt, uint32_t len, odp_packet_t *tail)
 {
-	uint32_t pktlen = odp_packet_len(*pkt);
+	odp_packet_hdr_t *pkt_hdr = odp_packet_hdr(*pkt);
+	odp_packet_hdr_t *tail_hdr;
+	uint32_t pktlen = pkt_hdr->frame_len;
+	uint32_t segsize = pkt_hdr->buf_hdr.segsize;
+	uint32_t pos, in_seg, first, num, i;
 
-	if (len >= pktlen || tail == NULL)
+	if (len >= pktlen || tail == NULL || packet_unshare_all(pkt_hdr))
 		return -1;
 
-	*tail = odp_packet_copy_part(*pkt, len, pktlen - len,
-				     odp_packet_pool(*pkt));
+	pos    = pkt_hdr->headroom + len;
+	in_seg = pos % segsize;
 
+	/* Tail within one segment is copied into a new packet. A longer
+	 * tail takes over the segments after the split point, and only the
+	 * data sharing the split point segment is copied. The tail packet
+	 * headroom is then the split offset within that segment. */
+	if (len == 0 || pktlen - len <= segsize - in_seg ||
+	    !packet_seg_relink_ok(pkt_hdr, pkt_hdr)) {
+		*tail = odp_packet_copy_part(*pkt, len, pktlen - len,
+					     odp_packet_pool(*pkt));
+
+		if (*tail == ODP_PACKET_INVALID)
+			return -1;
+
+		return odp_packet_trunc_tail(pkt, pktlen - len, NULL, NULL);
+	}
+
+	*tail = odp_packet_alloc(pkt_hdr->buf_hdr.pool_hdl, 1);
 	if (*tail == ODP_PACKET_INVALID)
 		return -1;
 
-	return odp_packet_trunc_tail(pkt, pktlen - len, NULL, NULL);
+	tail_hdr = odp_packet_hdr(*tail);
+	first = pos / segsize;
+
+	if (in_seg) {
+		memcpy(buffer_map(&tail_hdr->buf_hdr, in_seg, NULL, 0),
+		       buffer_map(&pkt_hdr->buf_hdr, pos, NULL, 0),
+		       segsize - in_seg);
+		num = 1;
+		first++;
+	} else {
+		num = 0;
+	}
+
+	/* Keep the first segment only, when the split point is not at a
+	 * segment boundary */
+	seg_free_tail(&tail_hdr->buf_hdr, tail_hdr->buf_hdr.segcount - num);
+
+	for (i = first; i < pkt_hdr->buf_hdr.segcount; i++)
+		tail_hdr->buf_hdr.addr[num++] = pkt_hdr->buf_hdr.addr[i];
+
+	tail_hdr->headroom  = in_seg;
+	tail_hdr->frame_len = pktlen - len;
+	packet_set_seg_count(tail_hdr, num);
+
+	pkt_hdr->frame_len = len;
+	packet_set_seg_count(pkt_hdr, first);
+	return 0;
+}
+
+/*
+ *
+ * References
+ * ********************************************************
+ *
+ */
+
+static inline int packet_ref_ok(odp_packet_hdr_t *pkt_hdr)
+{
+	if (odp_buf_to_pool(&pkt_hdr->buf_hdr)->s.blk_ref == NULL)
+		return 0;
+
+#ifdef MV_NETMAP_BUF_ZERO_COPY
+	if (is_ext_buffer(&pkt_hdr->buf_hdr))
+		return 0;
+#endif
+	return 1;
+}
+
+/* Append segments 'first' ... 'last' of a packet to a reference, the first
+ * one starting at 'in_seg' bytes into the segment */
+static void packet_ref_segs(odp_packet_hdr_t *ref_hdr,
+			    odp_packet_hdr_t *pkt_hdr,
+			    uint32_t first, uint32_t last, uint32_t in_seg)
+{
+	pool_entry_t *pool = odp_buf_to_pool(&pkt_hdr->buf_hdr);
+	uint32_t num = ref_hdr->buf_hdr.segcount;
+	uint8_t *addr;
+	uint32_t i;
+
+	for (i = first; i <= last; i++) {
+		addr = pkt_hdr->buf_hdr.addr[i];
+		ref_seg(&pool->s, addr);
+
+		if (i == first)
+			addr += in_seg;
+
+		ref_hdr->buf_hdr.addr[num++] = addr;
+	}
+
+	ref_hdr->buf_hdr.segcount = num;
+	ref_hdr->buf_hdr.size     = num * ref_hdr->buf_hdr.segsize;
+
+	ref_hdr->buf_hdr.flags.sharedseg = 1;
+	pkt_hdr->buf_hdr.flags.sharedseg = 1;
+}
+
+odp_packet_t odp_packet_ref_static(odp_packet_t pkt)
+{
+	odp_packet_hdr_t *pkt_hdr = odp_packet_hdr(pkt);
+	odp_packet_hdr_t *ref_hdr;
+	odp_packet_t ref;
+
+	if (!packet_ref_ok(pkt_hdr) || pkt_hdr->buf_hdr.segcount == 0)
+		return ODP_PACKET_INVALID;
+
+	ref = odp_packet_alloc(pkt_hdr->buf_hdr.pool_hdl, 1);
+	if (ref == ODP_PACKET_INVALID)
+		return ODP_PACKET_INVALID;
+
+	ref_hdr = odp_packet_hdr(ref);
+	seg_free_tail(&ref_hdr->buf_hdr, ref_hdr->buf_hdr.segcount);
+
+	packet_ref_segs(ref_hdr, pkt_hdr, 0, pkt_hdr->buf_hdr.segcount - 1, 0);
+	ref_hdr->headroom  = pkt_hdr->headroom;
+	ref_hdr->frame_len = pkt_hdr->frame_len;
+	ref_hdr->tailroom  = pkt_hdr->tailroom;
+
+	_odp_packet_copy_md_to_packet(pkt, ref);
+	copy_packet_cls_metadata(pkt_hdr, ref_hdr);
+	return ref;
+}
+
+odp_packet_t odp_packet_ref(odp_packet_t pkt, uint32_t offset)
+{
+	odp_packet_t hdr, ref;
+
+	if (offset >= odp_packet_hdr(pkt)->frame_len)
+		return ODP_PACKET_INVALID;
+
+	hdr = odp_packet_alloc(odp_packet_pool(pkt), 1);
+	if (hdr == ODP_PACKET_INVALID)
+		return ODP_PACKET_INVALID;
+
+	pull_tail(odp_packet_hdr(hdr), 1);
+
+	ref = odp_packet_ref_pkt(pkt, offset, hdr);
+	if (ref == ODP_PACKET_INVALID)
+		odp_packet_free(hdr);
+
+	return ref;
+}
+
+odp_packet_t odp_packet_ref_pkt(odp_packet_t pkt, uint32_t offset,
+				odp_packet_t hdr)
+{
+	odp_packet_hdr_t *pkt_hdr = odp_packet_hdr(pkt);
+	odp_packet_hdr_t *hdr_hdr = odp_packet_hdr(hdr);
+	uint32_t segsize = pkt_hdr->buf_hdr.segsize;
+	uint32_t pos = pkt_hdr->headroom + offset;
+	uint32_t pkt_end = pkt_hdr->headroom + pkt_hdr->frame_len;
+	uint32_t in_seg = pos % segsize;
+	uint32_t first = pos / segsize;
+	uint32_t last = (pkt_end - 1) / segsize;
+	uint32_t copy_len = 0;
+	uint32_t num = last - first + 1;
+	uint32_t hdr_len, hdr_end, shift, head_segs, tailroom;
+
+	if (offset >= pkt_hdr->frame_len || pkt == hdr ||
+	    hdr_hdr->buf_hdr.pool_hdl != pkt_hdr->buf_hdr.pool_hdl ||
+	    !packet_ref_ok(pkt_hdr) || !packet_ref_ok(hdr_hdr) ||
+	    packet_unshare_all(hdr_hdr))
+		return ODP_PACKET_INVALID;
+
+	/* Shared data is referenced as is when it starts at a segment
+	 * boundary or fits into one segment. Otherwise data up to the next
+	 * segment boundary is copied to the header. */
+	if (in_seg && num > 1) {
+		copy_len = segsize - in_seg;
+		in_seg = 0;
+		first++;
+		num--;
+	}
+
+	hdr_len = hdr_hdr->frame_len + copy_len;
+	hdr_end = hdr_hdr->headroom + hdr_len;
+
+	if ((hdr_len + segsize - 1) / segsize + num > ODP_BUFFER_MAX_SEG)
+		return ODP_PACKET_INVALID;
+
+	if (copy_len) {
+		if (odp_packet_extend_tail(&hdr, copy_len, NULL, NULL) < 0)
+			return ODP_PACKET_INVALID;
+
+		(void)odp_packet_copy_from_pkt(hdr, hdr_len - copy_len,
+					       pkt, offset, copy_len);
+	}
+
+	/* Header data ends at a segment boundary, followed by the shared
+	 * segments */
+	shift = (segsize - hdr_end % segsize) % segsize;
+	if (shift) {
+		push_tail(hdr_hdr, shift);
+		packet_move(hdr_hdr, shift, 0, hdr_len);
+		pull_head(hdr_hdr, shift);
+	}
+
+	if (hdr_hdr->tailroom >= segsize)
+		pull_tail_seg(hdr_hdr);
+
+	/* Headroom is reduced only when segments run out */
+	if (hdr_hdr->buf_hdr.segcount + num > ODP_BUFFER_MAX_SEG) {
+		head_segs = hdr_hdr->headroom / segsize;
+		seg_free_head(&hdr_hdr->buf_hdr, head_segs);
+		hdr_hdr->headroom -= head_segs * segsize;
+	}
+
+	packet_ref_segs(hdr_hdr, pkt_hdr, first, last, in_seg);
+	hdr_hdr->frame_len += pkt_hdr->frame_len - offset - copy_len;
+
+	/* Tailroom in the last shared segment. It may be less than
+	 * the segment size implies, when the segment is a part of a block. */
+	tailroom = (last + 1) * segsize - pkt_end;
+	hdr_hdr->tailroom = pkt_hdr->tailroom < tailroom ?
+			    pkt_hdr->tailroom : tailroom;
+
+	return hdr;
+}
+
+int odp_packet_has_ref(odp_packet_t pkt)
+{
+	odp_buffer_hdr_t *buf_hdr = &odp_packet_hdr(pkt)->buf_hdr;
+	pool_entry_t *pool;
+	uint32_t i;
+
+	if (!buf_hdr->flags.sharedseg)
+		return 0;
+
+	pool = odp_buf_to_pool(buf_hdr);
+
+	for (i = 0; i < buf_hdr->segcount; i++) {
+		if (seg_is_pool_blk(&pool->s, buf_hdr->addr[i]) &&
+		    odp_atomic_load_u32(&pool->s.blk_ref[
+			seg_blk_index(&pool->s, buf_hdr->addr[i])]) != 0)
+			return 1;
+	}
+
+	return 0;
 }
 
 /*
@@ -829,7 +1536,9 @@ int odp_packet_copy_from_mem(odp_packet_t pkt, uint32_t offset,
 	const uint8_t *srcaddr = (const uint8_t *)src;
 	odp_packet_hdr_t *pkt_hdr = odp_packet_hdr(pkt);
 
-	if (offset + len > pkt_hdr->frame_len)
+	if (offset + len > pkt_hdr->frame_len ||
+	    packet_unshare(pkt_hdr, pkt_hdr->headroom + offset,
+			   pkt_hdr->headroom + offset + len))
 		return -1;
 
 	while (len > 0) {
@@ -858,7 +1567,9 @@ int odp_packet_copy_from_pkt(odp_packet_t dst, uint32_t dst_offset,
 	int overlap;
 
 	if (dst_offset + len > dst_hdr->frame_len ||
-	    src_offset + len > src_hdr->frame_len)
+	    src_offset + len > src_hdr->frame_len ||
+	    packet_unshare(dst_hdr, dst_hdr->headroom + dst_offset,
+			   dst_hdr->headroom + dst_offset + len))
 		return -1;
 
 	overlap = (dst_hdr == src_hdr &&
@@ -867,14 +1578,8 @@ int odp_packet_copy_from_pkt(odp_packet_t dst, uint32_t dst_offset,
 		    (src_offset <= dst_offset &&
 		     src_offset + len >= dst_offset)));
 
-	if (overlap && src_offset < dst_offset) {
-		odp_packet_t temp =
-			odp_packet_copy_part(src, src_offset, len,
-					     odp_packet_pool(src));
-		if (temp == ODP_PACKET_INVALID)
-			return -1;
-		odp_packet_copy_from_pkt(dst, dst_offset, temp, 0, len);
-		odp_packet_free(temp);
+	if (overlap) {
+		packet_move(dst_hdr, dst_offset, src_offset, len);
 		return 0;
 	}
 
@@ -885,10 +1590,7 @@ int odp_packet_copy_from_pkt(odp_packet_t dst, uint32_t dst_offset,
 		minseg = dst_seglen > src_seglen ? src_seglen : dst_seglen;
 		cpylen = len > minseg ? minseg : len;
 
-		if (overlap)
-			memmove(dst_map, src_map, cpylen);
-		else
-			memcpy(dst_map, src_map, cpylen);
+		memcpy(dst_map, src_map, cpylen);
 
 		dst_offset += cpylen;
 		src_offset += cpylen;
@@ -1191,11 +1893,15 @@ int packet_parse_common(packet_parser_t *prs, const uint8_t *ptr,
 	uint32_t offset;
 	const uint8_t *parseptr;
 
+	if (prs->parsed_layers >= layer)
+		return prs->error_flags.all != 0;
+
+	/* Resume parsing from the layer after the last parsed one */
 	switch (prs->parsed_layers) {
 	case LAYER_NONE:
 	/* Fall through */
 
-	case LAYER_L2:
+	case LAYER_L1:
 	{
 		const _odp_ethhdr_t *eth;
 		uint16_t macaddr0, macaddr2, macaddr4;
@@ -1234,6 +1940,7 @@ int packet_parse_common(packet_parser_t *prs, const uint8_t *ptr,
 			prs->input_flags.snap = 1;
 			if (prs->ethtype > frame_len - offset) {
 				prs->error_flags.snap_len = 1;
+				prs->parsed_layers = LAYER_ALL;
 				goto parse_exit;
 			}
 			prs->ethtype = odp_be_to_cpu_16(*((const uint16_t *)
@@ -1269,7 +1976,7 @@ int packet_parse_common(packet_parser_t *prs, const uint8_t *ptr,
 	}
 	/* Fall through */
 
-	case LAYER_L3:
+	case LAYER_L2:
 	{
 		offset = prs->l3_offset;
 		parseptr = (const uint8_t *)(ptr + offset);
@@ -1309,7 +2016,7 @@ int packet_parse_common(packet_parser_t *prs, const uint8_t *ptr,
 	}
 	/* Fall through */
 
-	case LAYER_L4:
+	case LAYER_L3:
 	{
 		offset = prs->l4_offset;
 		parseptr = (const uint8_t *)(ptr + offset);
@@ -1359,6 +2066,7 @@ int packet_parse_common(packet_parser_t *prs, const uint8_t *ptr,
 		break;
 	}
 
+	case LAYER_L4:
 	case LAYER_ALL:
 		break;
 
@@ -1384,3 +2092,236 @@ int packet_parse_layer(odp_packet_hdr_t *pkt_hdr, layer_t layer)
 	return packet_parse_common(&pkt_hdr->p, base, pkt_hdr->frame_len,
 				   seg_len, layer);
 }
+
+/*
+ * Burst parser
+ *
+ * Most received packets are Ethernet, with at most one VLAN tag, carrying
+ * TCP or UDP over IPv4 without options or over IPv6 without extension
+ * headers. Ethertype, VLAN, IP version, header length and protocol of four
+ * packets are checked for this common case together in the lanes of 128 bit
+ * vectors (SSE / NEON via GCC vector extensions). Parser metadata of the
+ * matching packets is filled in directly from the vector lanes, all other
+ * packets are parsed by packet_parse_common().
+ */
+#define PARSE_MULTI_LANES 4
+
+/* Bytes read for the vector checks: Ethernet and VLAN headers, and the
+ * first three words of an IPv4 or IPv6 header */
+#define PARSE_MULTI_LOAD_LEN (_ODP_ETHHDR_LEN + _ODP_VLANHDR_LEN + 12)
+
+typedef uint32_t parse_u32x4_t __attribute__((vector_size(16)));
+
+/* Lane wise compares, all ones in lanes where true */
+#define PARSE_VEQ(a, b) ((parse_u32x4_t)((a) == (b)))
+#define PARSE_VLE(a, b) ((parse_u32x4_t)((a) <= (b)))
+
+/* Placeholder data of lanes that are not checked */
+static const uint8_t parse_multi_none[PARSE_MULTI_LOAD_LEN];
+
+static inline uint32_t parse_be16(const uint8_t *p)
+{
+	return ((uint32_t)p[0] << 8) | p[1];
+}
+
+static inline uint32_t parse_be32(const uint8_t *p)
+{
+	return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) |
+	       ((uint32_t)p[2] << 8) | p[3];
+}
+
+/* Metadata of a packet that passed the vector checks */
+typedef struct {
+	uint32_t vlan;
+	uint32_t ethtype;
+	uint32_t ipv4;
+	uint32_t ip_proto;
+	uint32_t l3_offset;
+	uint32_t l3_len;
+	uint32_t l4_offset;
+} parse_lane_t;
+
+/* Fill in parser metadata as packet_parse_common() would */
+static inline void parse_multi_fill(packet_parser_t *prs, const uint8_t *ptr,
+				    uint32_t frame_len, const parse_lane_t *ln)
+{
+	const uint8_t *l3 = ptr + ln->l3_offset;
+	const uint8_t *l4 = ptr + ln->l4_offset;
+	uint32_t macaddr0 = parse_be16(ptr);
+
+	packet_parse_l2(prs, frame_len);
+
+	prs->input_flags.eth_mcast = (macaddr0 & 0x0100) == 0x0100;
+	prs->input_flags.eth_bcast = macaddr0 == 0xffff &&
+				     parse_be32(ptr + 2) == 0xffffffff;
+	prs->input_flags.vlan = ln->vlan != 0;
+	prs->input_flags.l3 = 1;
+
+	if (ln->ipv4) {
+		uint32_t dstaddr = parse_be32(l3 + 16);
+
+		prs->input_flags.ipv4 = 1;
+		prs->input_flags.ip_bcast = (dstaddr == 0xffffffff);
+		prs->input_flags.ip_mcast = (dstaddr >> 28) == 0xd;
+	} else {
+		prs->input_flags.ipv6 = 1;
+		prs->input_flags.ip_mcast = l3[24] == 0xff;
+		prs->input_flags.ip_bcast = 0;
+	}
+
+	prs->ethtype   = ln->ethtype;
+	prs->ip_proto  = ln->ip_proto;
+	prs->l3_offset = ln->l3_offset;
+	prs->l3_len    = ln->l3_len;
+	prs->l4_offset = ln->l4_offset;
+	prs->input_flags.l4 = 1;
+
+	if (ln->ip_proto == _ODP_IPPROTO_TCP) {
+		uint32_t hl = l4[12] >> 4;
+
+		prs->input_flags.tcp = 1;
+		if (hl < _ODP_TCPHDR_LEN / 4)
+			prs->error_flags.tcp_err = 1;
+		else if (hl > _ODP_TCPHDR_LEN / 4)
+			prs->input_flags.tcpopt = 1;
+
+		prs->l4_len = ln->l3_len + ln->l3_offset - ln->l4_offset;
+	} else {
+		uint32_t udplen = parse_be16(l4 + 4);
+
+		prs->input_flags.udp = 1;
+		if (udplen < _ODP_UDPHDR_LEN ||
+		    udplen > ln->l3_len + ln->l4_offset - ln->l3_offset)
+			prs->error_flags.udp_err = 1;
+
+		prs->l4_len = udplen;
+	}
+
+	prs->parsed_layers = LAYER_ALL;
+}
+
+static void parse_multi_x4(odp_packet_hdr_t *pkt_hdr[PARSE_MULTI_LANES],
+			   layer_t layer)
+{
+	const uint8_t *ptr[PARSE_MULTI_LANES];
+	parse_u32x4_t seg_len, frame_len;
+	parse_u32x4_t type, inner_type, w0, w1, w2;
+	parse_u32x4_t vlan, ethtype, l3_offset, ipv4, ipv6, ip_proto;
+	parse_u32x4_t l3_len, l4_offset, tcp, udp, l4_end, fast;
+	parse_lane_t ln;
+	int i;
+
+	for (i = 0; i < PARSE_MULTI_LANES; i++) {
+		uint32_t len = 0;
+
+		ptr[i] = parse_multi_none;
+		seg_len[i] = 0;
+		frame_len[i] = 0;
+
+		if (pkt_hdr[i] == NULL ||
+		    pkt_hdr[i]->p.parsed_layers != LAYER_NONE)
+			continue;
+
+		ptr[i] = packet_map(pkt_hdr[i], 0, &len);
+		seg_len[i] = len;
+		frame_len[i] = pkt_hdr[i]->frame_len;
+
+		/* Too short for the checks, left to packet_parse_common() */
+		if (odp_unlikely(len < PARSE_MULTI_LOAD_LEN)) {
+			ptr[i] = parse_multi_none;
+			seg_len[i] = 0;
+		}
+	}
+
+	/* Ethertype, and the inner one when there is a VLAN tag */
+	for (i = 0; i < PARSE_MULTI_LANES; i++) {
+		type[i] = parse_be16(ptr[i] + 12);
+		inner_type[i] = parse_be16(ptr[i] + 16);
+	}
+
+	vlan = PARSE_VEQ(type, _ODP_ETHTYPE_VLAN);
+	ethtype = (inner_type & vlan) | (type & ~vlan);
+	l3_offset = _ODP_ETHHDR_LEN + (vlan & _ODP_VLANHDR_LEN);
+
+	for (i = 0; i < PARSE_MULTI_LANES; i++) {
+		const uint8_t *l3 = ptr[i] + l3_offset[i];
+
+		w0[i] = parse_be32(l3);
+		w1[i] = parse_be32(l3 + 4);
+		w2[i] = parse_be32(l3 + 8);
+	}
+
+	/* IPv4 version and IHL 5, not a fragment. IPv6 version 6. */
+	ipv4 = PARSE_VEQ(ethtype, _ODP_ETHTYPE_IPV4) &
+	       PARSE_VEQ(w0 >> 24, 0x45) &
+	       PARSE_VEQ(w1 & 0x3fff, 0);
+	ipv6 = PARSE_VEQ(ethtype, _ODP_ETHTYPE_IPV6) &
+	       PARSE_VEQ(w0 >> 28, 6);
+
+	ip_proto = (((w2 >> 16) & 0xff) & ipv4) | (((w1 >> 8) & 0xff) & ipv6);
+	l3_len = ((w0 & 0xffff) & ipv4) |
+		 (((w1 >> 16) + _ODP_IPV6HDR_LEN) & ipv6);
+	l4_offset = l3_offset + (ipv4 & _ODP_IPV4HDR_LEN) +
+		    (ipv6 & _ODP_IPV6HDR_LEN);
+
+	tcp = PARSE_VEQ(ip_proto, _ODP_IPPROTO_TCP);
+	udp = PARSE_VEQ(ip_proto, _ODP_IPPROTO_UDP);
+	l4_end = l4_offset + (tcp & _ODP_TCPHDR_LEN) + (udp & _ODP_UDPHDR_LEN);
+
+	/* Whole L3 packet in the frame, L3 and L4 headers in the segment */
+	fast = (ipv4 | ipv6) & (tcp | udp) &
+	       PARSE_VLE(l3_len, frame_len - l3_offset) &
+	       PARSE_VLE(l4_end, seg_len);
+
+	for (i = 0; i < PARSE_MULTI_LANES; i++) {
+		uint32_t len;
+		void *base;
+
+		if (pkt_hdr[i] == NULL)
+			continue;
+
+		if (odp_likely(fast[i])) {
+			ln.vlan      = vlan[i];
+			ln.ethtype   = ethtype[i];
+			ln.ipv4      = ipv4[i];
+			ln.ip_proto  = ip_proto[i];
+			ln.l3_offset = l3_offset[i];
+			ln.l3_len    = l3_len[i];
+			ln.l4_offset = l4_offset[i];
+			parse_multi_fill(&pkt_hdr[i]->p, ptr[i], frame_len[i],
+					 &ln);
+			continue;
+		}
+
+		base = packet_map(pkt_hdr[i], 0, &len);
+		packet_parse_common(&pkt_hdr[i]->p, base,
+				    pkt_hdr[i]->frame_len, len, layer);
+	}
+}
+
+/**
+ * Parse a burst of received packets
+ */
+void packet_parse_multi(const odp_packet_t pkt[], int num, layer_t layer)
+{
+	odp_packet_hdr_t *pkt_hdr[PARSE_MULTI_LANES];
+	int i, j;
+
+	if (layer == LAYER_NONE)
+		return;
+
+	/* Ethernet header only, upper layers are parsed on demand */
+	if (layer < LAYER_L3) {
+		for (i = 0; i < num; i++)
+			packet_parse_layer(odp_packet_hdr(pkt[i]), layer);
+		return;
+	}
+
+	for (i = 0; i < num; i += PARSE_MULTI_LANES) {
+		for (j = 0; j < PARSE_MULTI_LANES; j++)
+			pkt_hdr[j] = i + j < num ?
+				     odp_packet_hdr(pkt[i + j]) : NULL;
+
+		parse_multi_x4(pkt_hdr, layer);
+	}
+}
@@ -36,14 +36,19 @@ int odp_packet_has_l2(odp_packet_t pkt)
 {
 	odp_packet_hdr_t *pkt_hdr = odp_packet_hdr(pkt);
 
+	if (packet_parse_l2_not_done(&pkt_hdr->p))
+		packet_parse_l2(&pkt_hdr->p, pkt_hdr->frame_len);
+
 	return pkt_hdr->p.input_flags.l2;
 }
 
 int odp_packet_has_l2_error(odp_packet_t pkt)
 {
 	odp_packet_hdr_t *pkt_hdr = odp_packet_hdr(pkt);
-	/* L2 parsing is always done by default and hence
-	no additional check is required */
+
+	if (pkt_hdr->p.parsed_layers < LAYER_L2)
+		packet_parse_layer(pkt_hdr, LAYER_L2);
+
 	return pkt_hdr->p.error_flags.frame_len
 		| pkt_hdr->p.error_flags.snap_len
 		| pkt_hdr->p.error_flags.l2_chksum;
@@ -83,6 +88,9 @@ int odp_packet_has_eth(odp_packet_t pkt)
 {
 	odp_packet_hdr_t *pkt_hdr = odp_packet_hdr(pkt);
 
+	if (packet_parse_l2_not_done(&pkt_hdr->p))
+		packet_parse_l2(&pkt_hdr->p, pkt_hdr->frame_len);
+
 	return pkt_hdr->p.input_flags.eth;
 }
 
@@ -100,6 +108,9 @@ int odp_packet_has_jumbo(odp_packet_t pkt)
 {
 	odp_packet_hdr_t *pkt_hdr = odp_packet_hdr(pkt);
 
+	if (packet_parse_l2_not_done(&pkt_hdr->p))
+		packet_parse_l2(&pkt_hdr->p, pkt_hdr->frame_len);
+
 	return pkt_hdr->p.input_flags.jumbo;
 }
 
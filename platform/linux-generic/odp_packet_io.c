@@ -21,6 +21,9 @@
 #include <odp_classification_internal.h>
 #include <odp_debug_internal.h>
 #include <odp_packet_io_ipc_internal.h>
+#include <protocols/eth.h>
+#include <protocols/ip.h>
+#include <protocols/udp.h>
 #include <odp/api/time.h>
 
 #include <string.h>
@@ -142,10 +145,28 @@ static void init_out_queues(pktio_entry_t *entry)
 	}
 }
 
+/* Parser layer of a packet input parse depth */
+static layer_t parse_depth_layer(odp_pktio_parse_depth_t depth)
+{
+	switch (depth) {
+	case ODP_PKTIO_PARSE_NONE:
+		return LAYER_NONE;
+	case ODP_PKTIO_PARSE_L2:
+		return LAYER_L2;
+	case ODP_PKTIO_PARSE_L3:
+		return LAYER_L3;
+	default:
+		return LAYER_ALL;
+	}
+}
+
 static void init_pktio_entry(pktio_entry_t *entry)
 {
 	pktio_cls_enabled_set(entry, 0);
 
+	odp_pktio_config_init(&entry->s.config);
+	entry->s.parse_layer = parse_depth_layer(entry->s.config.parse_depth);
+
 	init_in_queues(entry);
 	init_out_queues(entry);
 
@@ -275,7 +296,7 @@ odp_pktio_t odp_pktio_open(const char *name, odp_pool_t pool,
 
 static int _pktio_close(pktio_entry_t *entry)
 {
-	int ret;
+	int ret, i;
 	int state = entry->s.state;
 
 	if (state != PKTIO_STATE_OPENED &&
@@ -287,6 +308,10 @@ static int _pktio_close(pktio_entry_t *entry)
 	if (ret)
 		return -1;
 
+	/* Return recycled buffers to the pool of every thread */
+	for (i = 0; i < ODP_THREAD_COUNT_MAX; i++)
+		packet_recycle_flush(&entry->s.recycle[i]);
+
 	if (state == PKTIO_STATE_STOP_PENDING)
 		entry->s.state = PKTIO_STATE_CLOSE_PENDING;
 	else
@@ -416,6 +441,11 @@ int odp_pktio_config(odp_pktio_t hdl, const odp_pktio_config_t *config)
 		return -1;
 	}
 
+	if (config->parse_depth > capa.config.parse_depth) {
+		ODP_ERR("Unsupported parse depth\n");
+		return -1;
+	}
+
 	lock_entry(entry);
 	if (entry->s.state == PKTIO_STATE_STARTED) {
 		unlock_entry(entry);
@@ -424,6 +454,25 @@ int odp_pktio_config(odp_pktio_t hdl, const odp_pktio_config_t *config)
 	}
 
 	entry->s.config = *config;
+	entry->s.parse_layer = parse_depth_layer(config->parse_depth);
+
+	if (config->pktout.bit.tcp_seg || config->pktout.bit.udp_seg) {
+		uint32_t min_len = UINT32_MAX;
+
+		entry->s.seg_mtu = entry->s.ops->mtu_get ?
+				   entry->s.ops->mtu_get(entry) : 0;
+
+		/* Packets up to this length are sent without parsing */
+		if (entry->s.seg_mtu)
+			min_len = entry->s.seg_mtu + _ODP_ETHHDR_LEN;
+		if (config->pktout_seg_len &&
+		    config->pktout_seg_len < min_len - _ODP_ETHHDR_LEN -
+		    _ODP_IPV4HDR_LEN - _ODP_UDPHDR_LEN)
+			min_len = config->pktout_seg_len + _ODP_ETHHDR_LEN +
+				  _ODP_IPV4HDR_LEN + _ODP_UDPHDR_LEN;
+
+		entry->s.seg_min_len = min_len;
+	}
 
 	if (entry->s.ops->config)
 		res = entry->s.ops->config(entry, config);
@@ -924,6 +973,7 @@ void odp_pktout_queue_param_init(odp_pktout_queue_param_t *param)
 void odp_pktio_config_init(odp_pktio_config_t *config)
 {
 	memset(config, 0, sizeof(odp_pktio_config_t));
+	config->parse_depth = ODP_PKTIO_PARSE_L2;
 }
 
 int odp_pktio_info(odp_pktio_t hdl, odp_pktio_info_t *info)
@@ -1535,7 +1585,12 @@ int odp_pktin_recv(odp_pktin_queue_t queue, odp_packet_t packets[], int num)
 		return -1;
 	}
 
-	return entry->s.ops->recv(entry, queue.index, packets, num);
+	num = entry->s.ops->recv(entry, queue.index, packets, num);
+
+	if (odp_unlikely(entry->s.config.pktin.bit.tcp_coalesce) && num > 1)
+		num = pktin_tcp_coalesce(entry, packets, num);
+
+	return num;
 }
 
 int odp_pktin_recv_tmo(odp_pktin_queue_t queue, odp_packet_t packets[], int num,
@@ -1545,6 +1600,21 @@ int odp_pktin_recv_tmo(odp_pktin_queue_t queue, odp_packet_t packets[], int num,
 	odp_time_t t1, t2;
 	struct timespec ts;
 	int started = 0;
+	pktio_entry_t *entry = get_pktio_entry(queue.pktio);
+
+	/* Interfaces with receive interrupts sleep on them instead */
+	if (entry != NULL && entry->s.ops->recv_tmo && wait != 0) {
+		ret = entry->s.ops->recv_tmo(entry, queue.index, packets, num,
+					     wait == ODP_PKTIN_WAIT ?
+					     ODP_PKTIN_WAIT :
+					     wait * SLEEP_NSEC);
+
+		if (odp_unlikely(entry->s.config.pktin.bit.tcp_coalesce) &&
+		    ret > 1)
+			ret = pktin_tcp_coalesce(entry, packets, ret);
+
+		return ret;
+	}
 
 	ts.tv_sec  = 0;
 	ts.tv_nsec = SLEEP_NSEC;
@@ -1657,6 +1727,10 @@ int odp_pktout_send(odp_pktout_queue_t queue, const odp_packet_t packets[],
 		return -1;
 	}
 
+	if (odp_unlikely(entry->s.config.pktout.bit.tcp_seg ||
+			 entry->s.config.pktout.bit.udp_seg))
+		return pktout_seg_send(entry, queue.index, packets, num);
+
 	return entry->s.ops->send(entry, queue.index, packets, num);
 }
 
@@ -1666,6 +1740,7 @@ int single_capability(odp_pktio_capability_t *capa)
 	capa->max_input_queues  = 1;
 	capa->max_output_queues = 1;
 	capa->set_op.op.promisc_mode = 1;
+	capa->config.parse_depth = ODP_PKTIO_PARSE_L4;
 
 	return 0;
 }
@@ -281,12 +281,18 @@ int _odp_pkt_queue_append(_odp_int_queue_pool_t queue_pool,
 	else
 		tail_blk = blk_idx_to_queue_blk(pool, tail_blk_idx);
 
-	/* Find first empty slot and insert pkt there. */
-	for (idx = 0; idx < NUM_PKTS; idx++) {
-		if (tail_blk->pkts[idx] == ODP_PACKET_INVALID) {
-			tail_blk->pkts[idx] = pkt;
-			return 0;
-		}
+	/* Insert pkt right after the last pkt of the tail_blk.  The slots in
+	 * front of the first pkt may have been emptied by removes, but must
+	 * not be reused, since that would reorder the queue and make
+	 * _odp_pkt_queue_remove() free the blk with pkts still in it. */
+	for (idx = NUM_PKTS; idx > 0; idx--) {
+		if (tail_blk->pkts[idx - 1] != ODP_PACKET_INVALID)
+			break;
+	}
+
+	if (idx < NUM_PKTS) {
+		tail_blk->pkts[idx] = pkt;
+		return 0;
 	}
 
        /* If we reach here, the tai_blk was full, so we need to allocate a new
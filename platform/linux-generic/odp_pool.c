@@ -71,6 +71,32 @@ int (*ext_buf_free_cb)(odp_buffer_t buf) = NULL;
 
 static void flush_cache(local_cache_t *buf_cache, struct pool_entry_s *pool);
 
+/* Pool statistics counters maintained by the implementation */
+static const odp_pool_stats_opt_t pool_stats_supported = {
+	.bit = {
+		.available = 1,
+		.alloc_fails = 1,
+		.recycle_hits = 1,
+		.recycle_misses = 1
+	}
+};
+
+/* Pool entry of a created pool, NULL for an invalid handle */
+static pool_entry_t *pool_entry_from_hdl(odp_pool_t pool_hdl)
+{
+	uint32_t pool_id = pool_handle_to_index(pool_hdl);
+	pool_entry_t *pool;
+
+	if (pool_hdl == ODP_POOL_INVALID || pool_id >= ODP_CONFIG_POOLS)
+		return NULL;
+
+	pool = get_pool_entry(pool_id);
+	if (pool->s.pool_shm == ODP_SHM_INVALID)
+		return NULL;
+
+	return pool;
+}
+
 int odp_pool_init_global(void)
 {
 	uint32_t i;
@@ -110,6 +136,8 @@ int odp_pool_init_global(void)
 		odp_atomic_init_u64(&pool->s.poolstats.buf_low_wm_count, 0);
 		odp_atomic_init_u64(&pool->s.poolstats.blk_high_wm_count, 0);
 		odp_atomic_init_u64(&pool->s.poolstats.blk_low_wm_count, 0);
+		odp_atomic_init_u64(&pool->s.poolstats.recycle_hits, 0);
+		odp_atomic_init_u64(&pool->s.poolstats.recycle_misses, 0);
 	}
 
 	ODP_DBG("\nPool init global\n");
@@ -206,24 +234,74 @@ int odp_pool_capability(odp_pool_capability_t *capa)
 	capa->tmo.max_pools = ODP_CONFIG_POOLS;
 	capa->tmo.max_num   = 0;
 
+	capa->stats = pool_stats_supported;
+
 	return 0;
 }
 
+/* Initialize a buffer header on its first allocation */
+static void init_buf_hdr(struct pool_entry_s *pool, odp_buffer_hdr_t *tmp)
+{
+	uint32_t idx = ((uint8_t *)tmp - pool->pool_mdata_addr) /
+		       pool->buf_stride;
+	uint32_t udata_stride = ODP_ALIGN_ROUNDUP(pool->udata_size,
+						  sizeof(uint64_t));
+	uint32_t blk_size = pool->blk_size;
+
+	tmp->allocator = ODP_FREEBUF;
+	tmp->flags.all = 0;
+	tmp->size = 0;
+	tmp->type = pool->params.type;
+	tmp->event_type = pool->params.type;
+	tmp->pool_hdl = pool->pool_hdl;
+	tmp->uarea_addr = udata_stride == 0 ? NULL :
+			  pool->buf_lazy_end + idx * udata_stride;
+	tmp->uarea_size = pool->udata_size;
+	tmp->segcount = 0;
+	tmp->segsize = pool->seg_size;
+	tmp->handle.handle = odp_buffer_encode_handle(tmp);
+
+	/* Set 1st seg addr for zero-len buffers */
+	tmp->addr[0] = NULL;
+
+	/* Special case for short buffer data */
+	if (blk_size <= ODP_MAX_INLINE_BUF) {
+		tmp->flags.hdrdata = 1;
+		if (blk_size > 0) {
+			tmp->segcount = 1;
+			tmp->addr[0] = &tmp->addr[1];
+			tmp->size = blk_size;
+		}
+	}
+}
+
 static inline odp_buffer_hdr_t *get_buf(struct pool_entry_s *pool)
 {
 	odp_buffer_hdr_t *myhead;
+	uint8_t *lazy = NULL;
 
 	POOL_LOCK(&pool->buf_lock);
 
 	myhead = pool->buf_freelist;
 
+	if (odp_likely(myhead != NULL)) {
+		pool->buf_freelist = myhead->next;
+	} else if (pool->buf_lazy < pool->buf_lazy_end) {
+		/* Headers never allocated before are not in the freelist */
+		lazy = pool->buf_lazy;
+		pool->buf_lazy += pool->buf_stride;
+	}
+
+	POOL_UNLOCK(&pool->buf_lock);
+
+	if (odp_unlikely(lazy != NULL)) {
+		myhead = (odp_buffer_hdr_t *)(void *)lazy;
+		init_buf_hdr(pool, myhead);
+	}
+
 	if (odp_unlikely(myhead == NULL)) {
-		POOL_UNLOCK(&pool->buf_lock);
 		odp_atomic_inc_u64(&pool->poolstats.bufempty);
 	} else {
-		pool->buf_freelist = myhead->next;
-		POOL_UNLOCK(&pool->buf_lock);
-
 		odp_atomic_fetch_sub_u32(&pool->bufcount, 1);
 		odp_atomic_inc_u64(&pool->poolstats.bufallocs);
 	}
@@ -354,9 +432,9 @@ odp_pool_t _pool_create(const char *name,
 	/* Validate requested number of buffers against addressable limits */
 	if (buf_num >
 	    (ODP_BUFFER_MAX_BUFFERS / (buf_stride / ODP_CACHE_LINE_SIZE))) {
-		ODP_ERR("buf_num %d > then expected %d\n",
-			buf_num, ODP_BUFFER_MAX_BUFFERS /
-			(buf_stride / ODP_CACHE_LINE_SIZE));
+		ODP_ERR("buf_num %" PRIu32 " > then expected %" PRIu64 "\n",
+			buf_num, (uint64_t)(ODP_BUFFER_MAX_BUFFERS /
+			(buf_stride / ODP_CACHE_LINE_SIZE)));
 		return ODP_POOL_INVALID;
 	}
 
@@ -372,6 +450,7 @@ odp_pool_t _pool_create(const char *name,
 
 		/* found free pool */
 		size_t block_size, pad_size, mdata_size, udata_size;
+		size_t ref_size;
 
 		pool->s.flags.all = 0;
 
@@ -385,6 +464,7 @@ odp_pool_t _pool_create(const char *name,
 		}
 
 		pool->s.params = *params;
+		pool->s.params.stats.all &= pool_stats_supported.all;
 		pool->s.buf_align = buf_align;
 
 		/* Optimize for short buffers: Data stored in buffer hdr */
@@ -392,19 +472,26 @@ odp_pool_t _pool_create(const char *name,
 			block_size = 0;
 			pool->s.buf_align = blk_size == 0 ? 0 : sizeof(void *);
 		} else {
-			block_size = buf_num * blk_size;
+			block_size = (size_t)buf_num * blk_size;
 			pool->s.buf_align = buf_align;
 		}
 
 		pad_size = ODP_CACHE_LINE_SIZE_ROUNDUP(block_size) - block_size;
-		mdata_size = buf_num * buf_stride;
-		udata_size = buf_num * udata_stride;
+		mdata_size = (size_t)buf_num * buf_stride;
+		udata_size = (size_t)buf_num * udata_stride;
+
+		/* Reference counts of packet segment blocks */
+		ref_size = 0;
+		if (params->type == ODP_POOL_PACKET && block_size)
+			ref_size = (block_size / seg_len) *
+				   sizeof(odp_atomic_u32_t);
 
 		pool->s.buf_num   = buf_num;
 		pool->s.pool_size = ODP_PAGE_SIZE_ROUNDUP(block_size +
 							  pad_size +
 							  mdata_size +
-							  udata_size);
+							  udata_size +
+							  ref_size);
 
 		shm = odp_shm_reserve(pool->s.name,
 				      pool->s.pool_size,
@@ -432,66 +519,33 @@ odp_pool_t _pool_create(const char *name,
 		pool->s.pool_mdata_addr = mdata_base_addr;
 		pool->s.udata_size = p_udata_size;
 
+		/* Shared memory may be reused from a destroyed pool, so block
+		 * reference counts are cleared */
+		pool->s.blk_ref = NULL;
+		if (ref_size) {
+			pool->s.blk_ref = (odp_atomic_u32_t *)(void *)
+				(udata_base_addr + udata_size);
+			memset(pool->s.blk_ref, 0, ref_size);
+		}
+
 		pool->s.buf_stride = buf_stride;
 		pool->s.buf_freelist = NULL;
 		pool->s.blk_freelist = NULL;
 
-		/* Initialization will increment these to their target vals */
-		odp_atomic_store_u32(&pool->s.bufcount, 0);
-		odp_atomic_store_u32(&pool->s.blkcount, 0);
-
-		uint8_t *buf = udata_base_addr - buf_stride;
-		uint8_t *udat = udata_stride == 0 ? NULL :
-			udata_base_addr + udata_size - udata_stride;
-
-		/* Init buffer common header and add to pool buffer freelist */
-		do {
-			odp_buffer_hdr_t *tmp =
-				(odp_buffer_hdr_t *)(void *)buf;
-
-			/* Iniitalize buffer metadata */
-			tmp->allocator = ODP_FREEBUF;
-			tmp->flags.all = 0;
-			tmp->size = 0;
-			tmp->type = params->type;
-			tmp->event_type = params->type;
-			tmp->pool_hdl = pool->s.pool_hdl;
-			tmp->uarea_addr = (void *)udat;
-			tmp->uarea_size = p_udata_size;
-			tmp->segcount = 0;
-			tmp->segsize = pool->s.seg_size;
-			tmp->handle.handle = odp_buffer_encode_handle(tmp);
-
-			/* Set 1st seg addr for zero-len buffers */
-			tmp->addr[0] = NULL;
-
-			/* Special case for short buffer data */
-			if (blk_size <= ODP_MAX_INLINE_BUF) {
-				tmp->flags.hdrdata = 1;
-				if (blk_size > 0) {
-					tmp->segcount = 1;
-					tmp->addr[0] = &tmp->addr[1];
-					tmp->size = blk_size;
-				}
-			}
-
-			/* Push buffer onto pool's freelist */
-			ret_buf(&pool->s, tmp);
-			buf  -= buf_stride;
-			udat -= udata_stride;
-		} while (buf >= mdata_base_addr);
-
-		/* Form block freelist for pool */
-		uint8_t *blk =
-			block_base_addr + block_size - pool->s.seg_size;
-
+		/* Buffer headers are initialized and blocks handed out on
+		 * their first allocation. Pool creation does not touch
+		 * buffer or block memory. */
+		pool->s.buf_lazy = mdata_base_addr;
+		pool->s.buf_lazy_end = udata_base_addr;
+		pool->s.blk_lazy = block_base_addr;
+		pool->s.blk_lazy_end = block_base_addr;
 		if (blk_size > ODP_MAX_INLINE_BUF)
-			do {
-				ret_blk(&pool->s, blk);
-				blk -= pool->s.seg_size;
-			} while (blk >= block_base_addr);
+			pool->s.blk_lazy_end += block_size;
 
-		blk_num = odp_atomic_load_u32(&pool->s.blkcount);
+		blk_num = (pool->s.blk_lazy_end - pool->s.blk_lazy) /
+			  pool->s.seg_size;
+		odp_atomic_store_u32(&pool->s.bufcount, buf_num);
+		odp_atomic_store_u32(&pool->s.blkcount, blk_num);
 
 		/* Initialize pool statistics counters */
 		odp_atomic_store_u64(&pool->s.poolstats.bufallocs, 0);
@@ -504,6 +558,8 @@ odp_pool_t _pool_create(const char *name,
 		odp_atomic_store_u64(&pool->s.poolstats.buf_low_wm_count, 0);
 		odp_atomic_store_u64(&pool->s.poolstats.blk_high_wm_count, 0);
 		odp_atomic_store_u64(&pool->s.poolstats.blk_low_wm_count, 0);
+		odp_atomic_store_u64(&pool->s.poolstats.recycle_hits, 0);
+		odp_atomic_store_u64(&pool->s.poolstats.recycle_misses, 0);
 
 		/* Reset other pool globals to initial state */
 		pool->s.buf_low_wm_assert = 0;
@@ -558,8 +614,7 @@ odp_pool_t odp_pool_lookup(const char *name)
 
 int odp_pool_info(odp_pool_t pool_hdl, odp_pool_info_t *info)
 {
-	uint32_t pool_id = pool_handle_to_index(pool_hdl);
-	pool_entry_t *pool = get_pool_entry(pool_id);
+	pool_entry_t *pool = pool_entry_from_hdl(pool_hdl);
 
 	if (pool == NULL || info == NULL)
 		return -1;
@@ -570,6 +625,46 @@ int odp_pool_info(odp_pool_t pool_hdl, odp_pool_info_t *info)
 	return 0;
 }
 
+int odp_pool_stats(odp_pool_t pool_hdl, odp_pool_stats_t *stats)
+{
+	pool_entry_t *pool = pool_entry_from_hdl(pool_hdl);
+	odp_pool_stats_opt_t opt;
+
+	if (pool == NULL || stats == NULL)
+		return -1;
+
+	opt = pool->s.params.stats;
+	memset(stats, 0, sizeof(odp_pool_stats_t));
+
+	if (opt.bit.available)
+		stats->available = odp_atomic_load_u32(&pool->s.bufcount);
+	if (opt.bit.alloc_fails)
+		stats->alloc_fails =
+			odp_atomic_load_u64(&pool->s.poolstats.bufempty);
+	if (opt.bit.recycle_hits)
+		stats->recycle_hits =
+			odp_atomic_load_u64(&pool->s.poolstats.recycle_hits);
+	if (opt.bit.recycle_misses)
+		stats->recycle_misses =
+			odp_atomic_load_u64(&pool->s.poolstats.recycle_misses);
+
+	return 0;
+}
+
+int odp_pool_stats_reset(odp_pool_t pool_hdl)
+{
+	pool_entry_t *pool = pool_entry_from_hdl(pool_hdl);
+
+	if (pool == NULL)
+		return -1;
+
+	odp_atomic_store_u64(&pool->s.poolstats.bufempty, 0);
+	odp_atomic_store_u64(&pool->s.poolstats.recycle_hits, 0);
+	odp_atomic_store_u64(&pool->s.poolstats.recycle_misses, 0);
+
+	return 0;
+}
+
 static inline void get_local_cache_bufs(local_cache_t *buf_cache, uint32_t idx,
 					odp_buffer_hdr_t *buf_hdr[],
 					uint32_t num)
@@ -679,7 +774,7 @@ void seg_free_head(odp_buffer_hdr_t *buf_hdr, int segcount)
 	int i;
 
 	for (i = 0; i < segcount; i++)
-		ret_blk(&pool->s, buf_hdr->addr[i]);
+		ret_seg(&pool->s, buf_hdr->addr[i]);
 
 	for (i = 0; i < s_cnt - segcount; i++)
 		buf_hdr->addr[i] = buf_hdr->addr[i + segcount];
@@ -717,7 +812,7 @@ void seg_free_tail(odp_buffer_hdr_t *buf_hdr, int segcount)
 	int i;
 
 	for (i = s_cnt - 1; i >= s_cnt - segcount; i--)
-		ret_blk(&pool->s, buf_hdr->addr[i]);
+		ret_seg(&pool->s, buf_hdr->addr[i]);
 
 	buf_hdr->segcount -= segcount;
 	buf_hdr->size      = buf_hdr->segcount * pool->s.seg_size;
@@ -939,6 +1034,19 @@ int odp_buffer_alloc_multi(odp_pool_t pool_hdl, odp_buffer_t buf[], int num)
 	return buffer_alloc_multi(pool_hdl, buf_size, buf, num);
 }
 
+/* Release segments of a buffer that may share them with packet references.
+ * Buffers in local caches keep their segments, which must not be shared. */
+static void release_shared_segs(odp_buffer_hdr_t *buf_hdr)
+{
+	pool_entry_t *pool = odp_buf_to_pool(buf_hdr);
+
+	while (buf_hdr->segcount > 0)
+		ret_seg(&pool->s, buf_hdr->addr[--buf_hdr->segcount]);
+
+	buf_hdr->size = 0;
+	buf_hdr->flags.sharedseg = 0;
+}
+
 static void multi_pool_free(odp_buffer_hdr_t *buf_hdr[], int num_buf)
 {
 	uint32_t pool_id, num;
@@ -991,6 +1099,9 @@ void buffer_free_multi(uint32_t pool_id,
 		buf_hdr[i]->allocator = ODP_FREEBUF;
 		id = pool_handle_to_index(buf_hdr[i]->pool_hdl);
 		multi_pool |= (pool_id != id);
+
+		if (odp_unlikely(buf_hdr[i]->flags.sharedseg))
+			release_shared_segs(buf_hdr[i]);
 	}
 
 	if (odp_unlikely(multi_pool)) {
@@ -1047,6 +1158,9 @@ void buffer_free(uint32_t pool_id, const odp_buffer_t buf)
 	ODP_ASSERT(buf_hdr->allocator != ODP_FREEBUF);
 	buf_hdr->allocator = ODP_FREEBUF;
 
+	if (odp_unlikely(buf_hdr->flags.sharedseg))
+		release_shared_segs(buf_hdr);
+
 	num = buf_cache->s.num_buf;
 
 	if (odp_likely((num + 1) < POOL_MAX_LOCAL_BUFS)) {
@@ -1080,11 +1194,12 @@ void odp_buffer_free_multi(const odp_buffer_t buf[], int num)
 
 void odp_pool_print(odp_pool_t pool_hdl)
 {
-	pool_entry_t *pool;
-	uint32_t pool_id;
+	pool_entry_t *pool = pool_entry_from_hdl(pool_hdl);
 
-	pool_id = pool_handle_to_index(pool_hdl);
-	pool    = get_pool_entry(pool_id);
+	if (pool == NULL) {
+		ODP_ERR("invalid pool handle\n");
+		return;
+	}
 
 	uint32_t bufcount  = odp_atomic_load_u32(&pool->s.bufcount);
 	uint32_t blkcount  = odp_atomic_load_u32(&pool->s.blkcount);
@@ -1102,6 +1217,9 @@ void odp_pool_print(odp_pool_t pool_hdl)
 		odp_atomic_load_u64(&pool->s.poolstats.blk_high_wm_count);
 	uint64_t blklowmct =
 		odp_atomic_load_u64(&pool->s.poolstats.blk_low_wm_count);
+	uint64_t rchits = odp_atomic_load_u64(&pool->s.poolstats.recycle_hits);
+	uint64_t rcmiss =
+		odp_atomic_load_u64(&pool->s.poolstats.recycle_misses);
 
 	ODP_DBG("Pool info\n");
 	ODP_DBG("---------\n");
@@ -1160,6 +1278,9 @@ void odp_pool_print(odp_pool_t pool_hdl)
 	ODP_DBG(" blk high wm count   %lu\n", blkhiwmct);
 	ODP_DBG(" blk low wm value    %lu\n", pool->s.blk_low_wm);
 	ODP_DBG(" blk low wm count    %lu\n", blklowmct);
+	ODP_DBG(" recycle hits        %lu (%lu%%)\n", rchits,
+		rchits + rcmiss ? 100 * rchits / (rchits + rcmiss) : 0);
+	ODP_DBG(" recycle misses      %lu\n", rcmiss);
 }
 
 odp_pool_t odp_buffer_pool(odp_buffer_t buf)
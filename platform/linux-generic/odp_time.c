@@ -7,86 +7,42 @@
 #include <odp_posix_extensions.h>
 
 #include <time.h>
+#include <string.h>
+#include <inttypes.h>
 #include <odp/api/time.h>
 #include <odp/api/hints.h>
 #include <odp_debug_internal.h>
+#include <odp_internal.h>
+#if ODP_ABI_COMPAT == 1
+#include <odp/api/plat/time_inlines.h>
+#endif
 
-static odp_time_t start_time;
+_odp_time_global_t _odp_time_glob;
 
-static inline
-uint64_t time_to_ns(odp_time_t time)
-{
-	uint64_t ns;
-
-	ns = time.tv_sec * ODP_TIME_SEC_IN_NS;
-	ns += time.tv_nsec;
+/* clock_gettime() value at init */
+static uint64_t start_ns;
 
-	return ns;
-}
+/* Frequency of the CPU counter, when in use */
+static uint64_t hw_freq;
 
-static inline odp_time_t time_diff(odp_time_t t2, odp_time_t t1)
-{
-	odp_time_t time;
-
-	time.tv_sec = t2.tv_sec - t1.tv_sec;
-	time.tv_nsec = t2.tv_nsec - t1.tv_nsec;
-
-	if (time.tv_nsec < 0) {
-		time.tv_nsec += ODP_TIME_SEC_IN_NS;
-		--time.tv_sec;
-	}
-
-	return time;
-}
-
-static inline odp_time_t time_local(void)
+static inline uint64_t time_sys_ns(void)
 {
 	int ret;
-	odp_time_t time;
 	struct timespec sys_time;
 
 	ret = clock_gettime(CLOCK_MONOTONIC_RAW, &sys_time);
 	if (odp_unlikely(ret != 0))
 		ODP_ABORT("clock_gettime failed\n");
 
-	time.tv_sec = sys_time.tv_sec;
-	time.tv_nsec = sys_time.tv_nsec;
-
-	return time_diff(time, start_time);
-}
-
-static inline int time_cmp(odp_time_t t2, odp_time_t t1)
-{
-	if (t2.tv_sec < t1.tv_sec)
-		return -1;
-
-	if (t2.tv_sec > t1.tv_sec)
-		return 1;
-
-	return t2.tv_nsec - t1.tv_nsec;
+	return (uint64_t)sys_time.tv_sec * ODP_TIME_SEC_IN_NS +
+	       sys_time.tv_nsec;
 }
 
-static inline odp_time_t time_sum(odp_time_t t1, odp_time_t t2)
+odp_time_t _odp_time_sys(void)
 {
 	odp_time_t time;
 
-	time.tv_sec = t2.tv_sec + t1.tv_sec;
-	time.tv_nsec = t2.tv_nsec + t1.tv_nsec;
-
-	if (time.tv_nsec >= (long)ODP_TIME_SEC_IN_NS) {
-		time.tv_nsec -= ODP_TIME_SEC_IN_NS;
-		++time.tv_sec;
-	}
-
-	return time;
-}
-
-static inline odp_time_t time_local_from_ns(uint64_t ns)
-{
-	odp_time_t time;
-
-	time.tv_sec = ns / ODP_TIME_SEC_IN_NS;
-	time.tv_nsec = ns - time.tv_sec * ODP_TIME_SEC_IN_NS;
+	time.nsec = time_sys_ns() - start_ns;
 
 	return time;
 }
@@ -96,8 +52,8 @@ static inline void time_wait_until(odp_time_t time)
 	odp_time_t cur;
 
 	do {
-		cur = time_local();
-	} while (time_cmp(time, cur) > 0);
+		cur = odp_time_local();
+	} while (odp_time_cmp(time, cur) > 0);
 }
 
 static inline uint64_t time_local_res(void)
@@ -105,6 +61,10 @@ static inline uint64_t time_local_res(void)
 	int ret;
 	struct timespec tres;
 
+	if (_odp_time_glob.use_hw)
+		return hw_freq < ODP_TIME_SEC_IN_NS ?
+		       hw_freq : ODP_TIME_SEC_IN_NS;
+
 	ret = clock_getres(CLOCK_MONOTONIC_RAW, &tres);
 	if (odp_unlikely(ret != 0))
 		ODP_ABORT("clock_getres failed\n");
@@ -112,46 +72,6 @@ static inline uint64_t time_local_res(void)
 	return ODP_TIME_SEC_IN_NS / (uint64_t)tres.tv_nsec;
 }
 
-odp_time_t odp_time_local(void)
-{
-	return time_local();
-}
-
-odp_time_t odp_time_global(void)
-{
-	return time_local();
-}
-
-odp_time_t odp_time_diff(odp_time_t t2, odp_time_t t1)
-{
-	return time_diff(t2, t1);
-}
-
-uint64_t odp_time_to_ns(odp_time_t time)
-{
-	return time_to_ns(time);
-}
-
-odp_time_t odp_time_local_from_ns(uint64_t ns)
-{
-	return time_local_from_ns(ns);
-}
-
-odp_time_t odp_time_global_from_ns(uint64_t ns)
-{
-	return time_local_from_ns(ns);
-}
-
-int odp_time_cmp(odp_time_t t2, odp_time_t t1)
-{
-	return time_cmp(t2, t1);
-}
-
-odp_time_t odp_time_sum(odp_time_t t1, odp_time_t t2)
-{
-	return time_sum(t1, t2);
-}
-
 uint64_t odp_time_local_res(void)
 {
 	return time_local_res();
@@ -164,9 +84,9 @@ uint64_t odp_time_global_res(void)
 
 void odp_time_wait_ns(uint64_t ns)
 {
-	odp_time_t cur = time_local();
-	odp_time_t wait = time_local_from_ns(ns);
-	odp_time_t end_time = time_sum(cur, wait);
+	odp_time_t cur = odp_time_local();
+	odp_time_t wait = odp_time_local_from_ns(ns);
+	odp_time_t end_time = odp_time_sum(cur, wait);
 
 	time_wait_until(end_time);
 }
@@ -178,33 +98,54 @@ void odp_time_wait_until(odp_time_t time)
 
 uint64_t odp_time_to_u64(odp_time_t time)
 {
-	int ret;
-	struct timespec tres;
-	uint64_t resolution;
+	return time.nsec;
+}
 
-	ret = clock_getres(CLOCK_MONOTONIC_RAW, &tres);
-	if (odp_unlikely(ret != 0))
-		ODP_ABORT("clock_getres failed\n");
+#ifdef _ODP_CPU_GLOBAL_TIME
+/* Use the CPU counter, with a ticks to nanoseconds multiplier below 2 ^ 32 */
+static void time_hw_init(uint64_t freq)
+{
+	uint32_t shift = 32;
 
-	resolution = (uint64_t)tres.tv_nsec;
+	while (shift && (ODP_TIME_SEC_IN_NS << shift) / freq > UINT32_MAX)
+		shift--;
 
-	return time_to_ns(time) / resolution;
+	hw_freq = freq;
+	_odp_time_glob.hw_shift = shift;
+	_odp_time_glob.hw_mult = (ODP_TIME_SEC_IN_NS << shift) / freq;
+	_odp_time_glob.hw_start = _odp_cpu_global_time();
+	_odp_time_glob.use_hw = 1;
 }
+#endif
 
 int odp_time_init_global(void)
 {
-	int ret;
 	struct timespec time;
+	uint64_t freq = 0;
+	int ret;
+
+	memset(&_odp_time_glob, 0, sizeof(_odp_time_glob));
 
 	ret = clock_gettime(CLOCK_MONOTONIC_RAW, &time);
 	if (ret) {
-		start_time = ODP_TIME_NULL;
-	} else {
-		start_time.tv_sec = time.tv_sec;
-		start_time.tv_nsec = time.tv_nsec;
+		start_ns = 0;
+		return ret;
 	}
 
-	return ret;
+	start_ns = (uint64_t)time.tv_sec * ODP_TIME_SEC_IN_NS + time.tv_nsec;
+
+#ifdef _ODP_CPU_GLOBAL_TIME
+	freq = _odp_cpu_global_time_freq();
+	if (freq)
+		time_hw_init(freq);
+#endif
+
+	if (freq)
+		ODP_DBG("Time from CPU counter, %" PRIu64 " Hz\n", freq);
+	else
+		ODP_DBG("Time from clock_gettime()\n");
+
+	return 0;
 }
 
 int odp_time_term_global(void)
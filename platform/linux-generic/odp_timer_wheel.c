@@ -162,6 +162,7 @@ typedef struct {
 	uint64_t          total_promote_cnt;
 	uint64_t          promote_fail_cnt;
 	uint64_t          current_ticks;
+	uint64_t          update_ticks;
 	wheel_desc_t      wheel_descs[4];
 	current_wheel_t  *current_wheel;
 	general_wheel_t  *general_wheels[3];
@@ -843,6 +844,7 @@ uint32_t _odp_timer_wheel_curr_time_update(_odp_timer_wheel_t timer_wheel,
 	timer_wheels      = (timer_wheels_t *)(uintptr_t)timer_wheel;
 	new_current_ticks = current_time >> TIME_TO_TICKS_SHIFT;
 	elapsed_ticks     = new_current_ticks - timer_wheels->current_ticks;
+	timer_wheels->update_ticks = new_current_ticks;
 	if (elapsed_ticks == 0)
 		return 0;
 
@@ -932,6 +934,63 @@ uint32_t _odp_timer_wheel_count(_odp_timer_wheel_t timer_wheel)
 		timer_wheels->total_timer_removes;
 }
 
+uint64_t _odp_timer_wheel_next_time(_odp_timer_wheel_t timer_wheel)
+{
+	timer_wheels_t       *timer_wheels;
+	current_wheel_t      *current_wheel;
+	general_wheel_t      *level1_wheel;
+	general_timer_slot_t *level1_slot;
+	wheel_desc_t         *wheel_desc, *level1_desc;
+	uint32_t              num_slots, slot_idx, level1_idx, cnt, ticks;
+
+	timer_wheels = (timer_wheels_t *)(uintptr_t)timer_wheel;
+	if (timer_wheels->expired_timers_ring->count != 0)
+		return 0;
+
+	if (timer_wheels->current_cnt == 0)
+		return UINT64_MAX;
+
+	/* The current wheel advances at most 32 ticks per update, so it may
+	 * still have to catch up with the last update time. */
+	if (timer_wheels->current_ticks < timer_wheels->update_ticks)
+		return 0;
+
+	wheel_desc    = &timer_wheels->wheel_descs[0];
+	level1_desc   = &timer_wheels->wheel_descs[1];
+	current_wheel = timer_wheels->current_wheel;
+	level1_wheel  = timer_wheels->general_wheels[0];
+	num_slots     = wheel_desc->num_slots;
+
+       /* Find the first non-empty current wheel slot ahead, the slot of tick
+	* cnt being processed once the time reaches current_ticks + cnt + 1.
+	*/
+	for (cnt = 0; cnt < num_slots; cnt++) {
+		slot_idx = (wheel_desc->slot_idx + cnt) & (num_slots - 1);
+		if (current_wheel->slots[slot_idx].user_data != 0)
+			break;
+	}
+
+       /* Then walk the gear boundaries before it, each of which processes
+	* the next level 1 slot.  Stop at the first boundary that promotes
+	* timers from the level 1 wheel or advances the level 2 wheel.
+	*/
+	ticks      = (0 - wheel_desc->slot_idx) & wheel_desc->gear_mask;
+	level1_idx = level1_desc->slot_idx;
+	while (ticks < cnt || cnt == num_slots) {
+		level1_slot = &level1_wheel->slots[level1_idx];
+		if ((level1_slot->single_entry.kind != 0) ||
+		    ((level1_idx & level1_desc->gear_mask) == 0)) {
+			cnt = ticks;
+			break;
+		}
+
+		ticks     += wheel_desc->gear_mask + 1;
+		level1_idx = (level1_idx + 1) & (level1_desc->num_slots - 1);
+	}
+
+	return (timer_wheels->current_ticks + cnt + 1) << TIME_TO_TICKS_SHIFT;
+}
+
 static void _odp_int_timer_wheel_desc_print(wheel_desc_t *wheel_desc,
 					    uint32_t      wheel_idx)
 {
@@ -16,8 +16,10 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <sched.h>
+#include <time.h>
 #include <unistd.h>
 #include <pthread.h>
+#include <sys/prctl.h>
 #include <odp/api/std_types.h>
 #include <protocols/eth.h>
 #include <protocols/ip.h>
@@ -37,6 +39,16 @@ static const pkt_desc_t EMPTY_PKT_DESC = { .word = 0 };
 #define MAX_PRIORITIES ODP_TM_MAX_PRIORITIES
 #define NUM_SHAPER_COLORS ODP_NUM_SHAPER_COLORS
 
+/* Unless busy polling, the service thread sleeps when its next work is
+ * further away than TM_SLEEP_MIN_NS, at most TM_SLEEP_MAX_NS at a time and
+ * with a timer slack small compared to the timer wheel tick. */
+#define TM_SLEEP_MIN_NS   (10 * ODP_TIME_USEC_IN_NS)
+#define TM_SLEEP_MAX_NS   (100 * ODP_TIME_MSEC_IN_NS)
+#define TM_SLEEP_SLACK_NS 1000
+
+/* tm_wred_nodes from a tm_queue to a TM egress */
+#define TM_MAX_WRED_NODES (ODP_TM_MAX_LEVELS + 1)
+
 static tm_prop_t basic_prop_tbl[MAX_PRIORITIES][NUM_SHAPER_COLORS] = {
 	[0] = {
 		[ODP_TM_SHAPER_GREEN] = { 0, DECR_BOTH },
@@ -99,6 +111,8 @@ static odp_bool_t tm_demote_pkt_desc(tm_system_t *tm_system,
 				     tm_shaper_obj_t *timer_shaper,
 				     pkt_desc_t *demoted_pkt_desc);
 
+static void tm_inline_process(tm_system_t *tm_system);
+
 static tm_queue_obj_t *get_tm_queue_obj(tm_system_t *tm_system,
 					pkt_desc_t *pkt_desc)
 {
@@ -142,53 +156,32 @@ static odp_bool_t pkt_descs_not_equal(pkt_desc_t *pkt_desc1,
 		return 1;
 }
 
-static void tm_init_random_data(tm_random_data_t *tm_random_data)
-{
-	uint32_t byte_cnt;
+/* Per thread state of the xorshift generator of WRED drop decisions */
+static __thread uint32_t tm_random_state;
 
-       /* Keep calling odp_random_data until we have filled the entire random
-	* data buffer.  Hopefully we don't need to call odp_random_data too
-	* many times to get 256 bytes worth of random data.
-	*/
-	byte_cnt = 0;
-	while (byte_cnt < 256)
-		byte_cnt += odp_random_data(&tm_random_data->buf[byte_cnt],
-					    256 - byte_cnt, 1);
-
-	tm_random_data->next_random_byte = 0;
-}
-
-static uint16_t tm_random16(tm_random_data_t *tm_random_data)
+static inline uint32_t tm_random32(void)
 {
-	uint32_t buf_idx;
-	uint16_t rand8a, rand8b;
-
-	if (255 <= tm_random_data->next_random_byte)
-		tm_init_random_data(tm_random_data);
+	uint32_t x = tm_random_state;
 
-       /* Collect 2 random bytes and return them.  Endianness does NOT matter
-	* here.  This code does assume that next_random_byte is a multiple of
-	* 2.
-	*/
-	buf_idx = tm_random_data->next_random_byte;
-	rand8a = tm_random_data->buf[buf_idx++];
-	rand8b = tm_random_data->buf[buf_idx++];
+	/* Seed the generator on the first use in this thread.  Zero is the
+	 * only state, which the generator never leaves. */
+	while (odp_unlikely(x == 0))
+		(void)odp_random_data((uint8_t *)&x, sizeof(x), 0);
 
-	tm_random_data->next_random_byte = buf_idx;
-	return (rand8b << 8) | rand8a;
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	tm_random_state = x;
+	return x;
 }
 
-static odp_bool_t tm_random_drop(tm_random_data_t *tm_random_data,
-				 odp_tm_percent_t drop_prob)
+static inline odp_bool_t tm_random_drop(odp_tm_percent_t drop_prob)
 {
-	odp_bool_t drop;
-	uint32_t random_int, scaled_random_int;
+	uint32_t scaled_random_int;
 
 	/* Pick a random integer between 0 and 10000. */
-	random_int = tm_random16(tm_random_data);
-	scaled_random_int = (random_int * 10000) >> 16;
-	drop = scaled_random_int < (uint32_t)drop_prob;
-	return drop;
+	scaled_random_int = ((uint64_t)tm_random32() * 10000) >> 32;
+	return scaled_random_int < (uint32_t)drop_prob;
 }
 
 static void *alloc_entry_in_dynamic_tbl(dynamic_tbl_t *dynamic_tbl,
@@ -271,36 +264,47 @@ static void input_work_queue_destroy(input_work_queue_t *input_work_queue)
 	free(input_work_queue);
 }
 
+/* Appends up to num pkts of a tm_queue under a single lock.  Returns the
+ * number of pkts appended, which is less than num when the queue fills. */
 static int input_work_queue_append(tm_system_t *tm_system,
-				   input_work_item_t *work_item)
+				   uint32_t queue_num,
+				   const odp_packet_t pkts[],
+				   int num)
 {
 	input_work_queue_t *input_work_queue;
 	input_work_item_t *entry_ptr;
 	uint32_t queue_cnt, tail_idx;
+	int i;
 
 	input_work_queue = tm_system->input_work_queue;
+	odp_ticketlock_lock(&input_work_queue->lock);
+
+	/* Appenders update queue_cnt while holding the lock, so that it
+	 * does not hide the appends of each other. */
 	queue_cnt = odp_atomic_load_u64(&input_work_queue->queue_cnt);
-	if (INPUT_WORK_RING_SIZE <= queue_cnt) {
+	if ((uint32_t)num > INPUT_WORK_RING_SIZE - queue_cnt) {
+		num = INPUT_WORK_RING_SIZE - queue_cnt;
 		input_work_queue->enqueue_fail_cnt++;
-		return -1;
 	}
 
-	odp_ticketlock_lock(&input_work_queue->lock);
 	tail_idx = input_work_queue->tail_idx;
-	entry_ptr = &input_work_queue->work_ring[tail_idx];
-
-	*entry_ptr = *work_item;
-	tail_idx++;
-	if (INPUT_WORK_RING_SIZE <= tail_idx)
-		tail_idx = 0;
+	for (i = 0; i < num; i++) {
+		entry_ptr = &input_work_queue->work_ring[tail_idx];
+		entry_ptr->pkt = pkts[i];
+		entry_ptr->queue_num = queue_num;
+		tail_idx++;
+		if (INPUT_WORK_RING_SIZE <= tail_idx)
+			tail_idx = 0;
+	}
 
-	input_work_queue->total_enqueues++;
+	input_work_queue->total_enqueues += num;
 	input_work_queue->tail_idx = tail_idx;
+	odp_atomic_add_u64(&input_work_queue->queue_cnt, num);
+	if (input_work_queue->peak_cnt < queue_cnt + num)
+		input_work_queue->peak_cnt = queue_cnt + num;
+
 	odp_ticketlock_unlock(&input_work_queue->lock);
-	odp_atomic_inc_u64(&input_work_queue->queue_cnt);
-	if (input_work_queue->peak_cnt <= queue_cnt)
-		input_work_queue->peak_cnt = queue_cnt + 1;
-	return 0;
+	return num;
 }
 
 static int input_work_queue_remove(input_work_queue_t *input_work_queue,
@@ -1630,15 +1634,15 @@ static odp_bool_t tm_consume_sent_pkt(tm_system_t *tm_system,
 
 static odp_tm_percent_t tm_queue_fullness(tm_wred_params_t      *wred_params,
 					  tm_queue_thresholds_t *thresholds,
-					  tm_queue_cnts_t       *queue_cnts)
+					  tm_wred_snapshot_t    *snapshot)
 {
 	uint64_t current_cnt, max_cnt, fullness;
 
 	if (wred_params->use_byte_fullness) {
-		current_cnt = odp_atomic_load_u64(&queue_cnts->byte_cnt);
+		current_cnt = snapshot->byte_cnt;
 		max_cnt = thresholds->max_bytes;
 	} else {
-		current_cnt = odp_atomic_load_u64(&queue_cnts->pkt_cnt);
+		current_cnt = snapshot->pkt_cnt;
 		max_cnt = thresholds->max_pkts;
 	}
 
@@ -1649,8 +1653,7 @@ static odp_tm_percent_t tm_queue_fullness(tm_wred_params_t      *wred_params,
 	return (odp_tm_percent_t)MIN(fullness, 50000);
 }
 
-static odp_bool_t tm_local_random_drop(tm_system_t      *tm_system,
-				       tm_wred_params_t *wred_params,
+static odp_bool_t tm_local_random_drop(tm_wred_params_t *wred_params,
 				       odp_tm_percent_t  queue_fullness)
 {
 	odp_tm_percent_t min_threshold, med_threshold, first_threshold;
@@ -1698,11 +1701,11 @@ static odp_bool_t tm_local_random_drop(tm_system_t      *tm_system,
 	else if (10000 <= drop_prob)
 		return 1;
 	else
-		return tm_random_drop(&tm_system->tm_random_data, drop_prob);
+		return tm_random_drop(drop_prob);
 }
 
 static odp_bool_t tm_queue_is_full(tm_queue_thresholds_t *thresholds,
-				   tm_queue_cnts_t *queue_cnts)
+				   tm_wred_snapshot_t *snapshot)
 {
 	odp_bool_t queue_is_full;
 	uint64_t max_bytes;
@@ -1712,79 +1715,88 @@ static odp_bool_t tm_queue_is_full(tm_queue_thresholds_t *thresholds,
 	max_pkts = thresholds->max_pkts;
 	queue_is_full = 0;
 	if (max_pkts != 0)
-		queue_is_full =
-			max_pkts <= odp_atomic_load_u64(&queue_cnts->pkt_cnt);
+		queue_is_full = max_pkts <= snapshot->pkt_cnt;
 
 	if (max_bytes != 0)
-		queue_is_full |=
-			max_bytes <= odp_atomic_load_u64(&queue_cnts->byte_cnt);
+		queue_is_full |= max_bytes <= snapshot->byte_cnt;
 
 	return queue_is_full;
 }
 
-static odp_bool_t random_early_discard(tm_system_t *tm_system,
-				       tm_queue_obj_t *tm_queue_obj ODP_UNUSED,
-				       tm_wred_node_t *tm_wred_node,
+/* Load the profiles and queue counts of the tm_wred_nodes from the initial
+ * one to a TM egress.  Returns the number of tm_wred_nodes. */
+static uint32_t tm_wred_snapshot_load(tm_wred_node_t *tm_wred_node,
+				      tm_wred_snapshot_t snapshot[])
+{
+	tm_wred_snapshot_t *node_snapshot;
+	uint32_t num_nodes, color;
+
+	num_nodes = 0;
+	while (tm_wred_node && num_nodes < TM_MAX_WRED_NODES) {
+		node_snapshot = &snapshot[num_nodes++];
+		node_snapshot->threshold_params =
+			tm_wred_node->threshold_params;
+		for (color = 0; color < ODP_NUM_PACKET_COLORS; color++)
+			node_snapshot->wred_params[color] =
+				tm_wred_node->wred_params[color];
+
+		node_snapshot->pkt_cnt =
+			odp_atomic_load_u64(&tm_wred_node->queue_cnts.pkt_cnt);
+		node_snapshot->byte_cnt =
+			odp_atomic_load_u64(&tm_wred_node->queue_cnts.byte_cnt);
+		tm_wred_node = tm_wred_node->next_tm_wred_node;
+	}
+
+	return num_nodes;
+}
+
+/* Random Early Discard and threshold checks of a pkt against the snapshot of
+ * the tm_wred_nodes.  The initial tm_wred_node drops on its thresholds, when
+ * it has no WRED enabled for the pkt color. */
+static odp_bool_t random_early_discard(tm_wred_snapshot_t snapshot[],
+				       uint32_t num_nodes,
 				       odp_packet_color_t pkt_color)
 {
 	tm_queue_thresholds_t *thresholds;
 	tm_wred_params_t      *wred_params;
 	odp_tm_percent_t       fullness;
-	tm_queue_cnts_t       *queue_cnts;
+	uint32_t               idx;
 
-	thresholds = tm_wred_node->threshold_params;
-	if (thresholds) {
-		wred_params = tm_wred_node->wred_params[pkt_color];
-		queue_cnts = &tm_wred_node->queue_cnts;
+	for (idx = 0; idx < num_nodes; idx++) {
+		thresholds = snapshot[idx].threshold_params;
+		if (!thresholds)
+			continue;
+
+		wred_params = snapshot[idx].wred_params[pkt_color];
 		if ((!wred_params) || (wred_params->enable_wred == 0)) {
-			if (tm_queue_is_full(thresholds, queue_cnts))
+			if (idx == 0 &&
+			    tm_queue_is_full(thresholds, &snapshot[idx]))
 				return 1;
 		} else {
 			fullness = tm_queue_fullness(wred_params, thresholds,
-						     queue_cnts);
-			if (tm_local_random_drop(tm_system, wred_params,
-						 fullness))
+						     &snapshot[idx]);
+			if (tm_local_random_drop(wred_params, fullness))
 				return 1;
 		}
 	}
 
-       /* For each tm_wred_node between the initial and a TM egress, do a
-	* Random Early Discard check, if enabled.
-	*/
-	tm_wred_node = tm_wred_node->next_tm_wred_node;
-	while (tm_wred_node) {
-		thresholds = tm_wred_node->threshold_params;
-		if (thresholds) {
-			wred_params = tm_wred_node->wred_params[pkt_color];
-			queue_cnts = &tm_wred_node->queue_cnts;
-			if ((wred_params) && wred_params->enable_wred) {
-				fullness = tm_queue_fullness(wred_params,
-							     thresholds,
-							     queue_cnts);
-				if (tm_local_random_drop(tm_system, wred_params,
-							 fullness))
-					return 1;
-			}
-		}
-
-		tm_wred_node = tm_wred_node->next_tm_wred_node;
-	}
-
 	return 0;
 }
 
-/* Returns the current queue pkt_cnt. */
+/* Adds pkt_cnt pkts of total length frame_len to the counts.  Returns the
+ * current queue pkt_cnt. */
 static uint32_t tm_queue_cnts_increment(tm_system_t *tm_system,
 					tm_wred_node_t *tm_wred_node,
 					uint32_t priority,
-					uint32_t frame_len)
+					uint32_t pkt_cnt,
+					uint64_t frame_len)
 {
 	tm_queue_cnts_t *queue_cnts;
 	uint32_t tm_queue_pkt_cnt;
 
 	odp_ticketlock_lock(&tm_wred_node->tm_wred_node_lock);
 	queue_cnts = &tm_wred_node->queue_cnts;
-	odp_atomic_inc_u64(&queue_cnts->pkt_cnt);
+	odp_atomic_add_u64(&queue_cnts->pkt_cnt, pkt_cnt);
 	odp_atomic_add_u64(&queue_cnts->byte_cnt, frame_len);
 
 	tm_queue_pkt_cnt = (uint32_t)odp_atomic_load_u64(&queue_cnts->pkt_cnt);
@@ -1797,7 +1809,7 @@ static uint32_t tm_queue_cnts_increment(tm_system_t *tm_system,
 	while (tm_wred_node) {
 		odp_ticketlock_lock(&tm_wred_node->tm_wred_node_lock);
 		queue_cnts = &tm_wred_node->queue_cnts;
-		odp_atomic_inc_u64(&queue_cnts->pkt_cnt);
+		odp_atomic_add_u64(&queue_cnts->pkt_cnt, pkt_cnt);
 		odp_atomic_add_u64(&queue_cnts->byte_cnt, frame_len);
 		odp_ticketlock_unlock(&tm_wred_node->tm_wred_node_lock);
 
@@ -1805,11 +1817,11 @@ static uint32_t tm_queue_cnts_increment(tm_system_t *tm_system,
 	}
 
 	queue_cnts = &tm_system->total_info.queue_cnts;
-	odp_atomic_inc_u64(&queue_cnts->pkt_cnt);
+	odp_atomic_add_u64(&queue_cnts->pkt_cnt, pkt_cnt);
 	odp_atomic_add_u64(&queue_cnts->byte_cnt, frame_len);
 
 	queue_cnts = &tm_system->priority_info[priority].queue_cnts;
-	odp_atomic_inc_u64(&queue_cnts->pkt_cnt);
+	odp_atomic_add_u64(&queue_cnts->pkt_cnt, pkt_cnt);
 	odp_atomic_add_u64(&queue_cnts->byte_cnt, frame_len);
 
 	return tm_queue_pkt_cnt;
@@ -1850,51 +1862,130 @@ static void tm_queue_cnts_decrement(tm_system_t *tm_system,
 	odp_atomic_sub_u64(&queue_cnts->byte_cnt, frame_len);
 }
 
-static int tm_enqueue(tm_system_t *tm_system,
-		      tm_queue_obj_t *tm_queue_obj,
-		      odp_packet_t pkt)
+/* Wake up the service thread of a tm_group if it sleeps. The full barrier
+ * pairs with the one in tm_group_sleep(): either the service thread sees the
+ * new work before sleeping, or it is seen sleeping here. */
+static void tm_group_wakeup(tm_system_group_t *tm_group)
 {
-	input_work_item_t work_item;
-	odp_packet_color_t pkt_color;
+	if (tm_group->busy_poll)
+		return;
+
+	odp_mb_full();
+	if (odp_likely(odp_atomic_load_u32(&tm_group->sleeping) == 0))
+		return;
+
+	pthread_mutex_lock(&tm_group->wakeup_lock);
+	pthread_cond_signal(&tm_group->wakeup_cond);
+	pthread_mutex_unlock(&tm_group->wakeup_lock);
+}
+
+static void tm_wakeup_all_groups(void)
+{
+	tm_system_group_t *tm_group = tm_group_list;
+
+	if (tm_group == NULL)
+		return;
+
+	do {
+		tm_group_wakeup(tm_group);
+		tm_group = tm_group->next;
+	} while (tm_group != tm_group_list);
+}
+
+/* Enqueues the leading pkts of a burst, which pass the WRED and threshold
+ * checks and fit into the input work queue.  The profiles and queue counts
+ * are loaded and the counts updated once per burst.  Returns the number of
+ * pkts enqueued, or < 0 when the first pkt is not enqueued. */
+static int tm_enqueue_multi(tm_system_t *tm_system,
+			    tm_queue_obj_t *tm_queue_obj,
+			    const odp_packet_t pkts[],
+			    int num,
+			    uint32_t *pkt_depth)
+{
+	tm_wred_snapshot_t snapshot[TM_MAX_WRED_NODES];
 	tm_wred_node_t *initial_tm_wred_node;
-	odp_bool_t drop_eligible, drop;
-	uint32_t frame_len, pkt_depth;
-	int rc;
-	odp_packet_hdr_t *pkt_hdr = odp_packet_hdr(pkt);
+	odp_packet_t pkt;
+	uint64_t frame_len, burst_len;
+	uint32_t num_nodes, idx, depth;
+	int num_pkts, num_enq, i;
+
+	*pkt_depth = 0;
 
 	/* If we're from an ordered queue and not in order
-	 * record the event and wait until order is resolved
+	 * record the events and wait until order is resolved
 	 */
-	if (queue_tm_reorder(&tm_queue_obj->tm_qentry, &pkt_hdr->buf_hdr))
-		return 0;
+	if (queue_tm_reorder(&tm_queue_obj->tm_qentry,
+			     &odp_packet_hdr(pkts[0])->buf_hdr)) {
+		for (i = 1; i < num; i++) {
+			if (tm_enqueue_multi(tm_system, tm_queue_obj, &pkts[i],
+					     1, &depth) < 0)
+				break;
+		}
+
+		return i;
+	}
 
 	if (tm_system->first_enq == 0) {
 		odp_barrier_wait(&tm_system->tm_system_barrier);
 		tm_system->first_enq = 1;
 	}
 
-	pkt_color = odp_packet_color(pkt);
-	drop_eligible = odp_packet_drop_eligible(pkt);
-
 	initial_tm_wred_node = tm_queue_obj->tm_wred_node;
-	if (drop_eligible) {
-		drop = random_early_discard(tm_system, tm_queue_obj,
-					    initial_tm_wred_node, pkt_color);
-		if (drop)
-			return -1;
+	num_nodes = tm_wred_snapshot_load(initial_tm_wred_node, snapshot);
+
+	/* Each pkt sees the queues filled by the accepted pkts before it */
+	burst_len = 0;
+	for (num_pkts = 0; num_pkts < num; num_pkts++) {
+		pkt = pkts[num_pkts];
+		if (odp_packet_drop_eligible(pkt) &&
+		    random_early_discard(snapshot, num_nodes,
+					 odp_packet_color(pkt)))
+			break;
+
+		frame_len = odp_packet_len(pkt);
+		burst_len += frame_len;
+		for (idx = 0; idx < num_nodes; idx++) {
+			snapshot[idx].pkt_cnt++;
+			snapshot[idx].byte_cnt += frame_len;
+		}
 	}
 
-	work_item.queue_num = tm_queue_obj->queue_num;
-	work_item.pkt = pkt;
-	rc = input_work_queue_append(tm_system, &work_item);
-	if (rc < 0) {
+	if (num_pkts == 0)
+		return -1;
+
+	num_enq = input_work_queue_append(tm_system, tm_queue_obj->queue_num,
+					  pkts, num_pkts);
+	if (num_enq < num_pkts) {
 		ODP_DBG("%s work queue full\n", __func__);
-		return rc;
+		for (i = num_enq; i < num_pkts; i++)
+			burst_len -= odp_packet_len(pkts[i]);
+
+		if (num_enq == 0)
+			return -1;
 	}
 
-	frame_len = odp_packet_len(pkt);
-	pkt_depth = tm_queue_cnts_increment(tm_system, initial_tm_wred_node,
-					    tm_queue_obj->priority, frame_len);
+	if (!tm_system->inline_enq)
+		tm_group_wakeup(GET_TM_GROUP(tm_system->odp_tm_group));
+
+	*pkt_depth = tm_queue_cnts_increment(tm_system, initial_tm_wred_node,
+					     tm_queue_obj->priority, num_enq,
+					     burst_len);
+
+	if (tm_system->inline_enq)
+		tm_inline_process(tm_system);
+
+	return num_enq;
+}
+
+static int tm_enqueue(tm_system_t *tm_system,
+		      tm_queue_obj_t *tm_queue_obj,
+		      odp_packet_t pkt)
+{
+	uint32_t pkt_depth;
+
+	if (tm_enqueue_multi(tm_system, tm_queue_obj, &pkt, 1, &pkt_depth) < 0)
+		return -1;
+
 	return pkt_depth;
 }
 
@@ -2251,6 +2342,7 @@ static void signal_request(void)
 	uint64_t my_request_num, serving_cnt;
 
 	my_request_num = odp_atomic_fetch_inc_u64(&atomic_request_cnt) + 1;
+	tm_wakeup_all_groups();
 
 	serving_cnt = odp_atomic_load_u64(&currently_serving_cnt);
 	while (serving_cnt != my_request_num) {
@@ -2259,7 +2351,27 @@ static void signal_request(void)
 	}
 }
 
-static void check_for_request(void)
+/* Lock or unlock the inline tm_systems of a group, so that no enqueueing
+ * thread processes packets while a configuration request is served. */
+static void tm_group_inline_lock(tm_system_group_t *tm_group, odp_bool_t lock)
+{
+	tm_system_t *tm_system;
+	uint32_t     cnt;
+
+	tm_system = tm_group->first_tm_system;
+	for (cnt = 0; cnt < tm_group->num_tm_systems; cnt++) {
+		if (tm_system->inline_enq) {
+			if (lock)
+				odp_ticketlock_lock(&tm_system->inline_lock);
+			else
+				odp_ticketlock_unlock(&tm_system->inline_lock);
+		}
+
+		tm_system = tm_system->next;
+	}
+}
+
+static void check_for_request(tm_system_group_t *tm_group)
 {
 	uint64_t request_num, serving_cnt, done_cnt;
 
@@ -2268,6 +2380,8 @@ static void check_for_request(void)
 	if (serving_cnt == request_num)
 		return;
 
+	tm_group_inline_lock(tm_group, true);
+
 	/* Signal the other requesting thread to proceed and then
 	 * wait for their done indication */
 	odp_atomic_inc_u64(&currently_serving_cnt);
@@ -2278,6 +2392,8 @@ static void check_for_request(void)
 		busy_wait(100);
 		done_cnt = odp_atomic_load_u64(&atomic_done_cnt);
 	}
+
+	tm_group_inline_lock(tm_group, false);
 }
 
 static void signal_request_done(void)
@@ -2285,6 +2401,75 @@ static void signal_request_done(void)
 	odp_atomic_inc_u64(&atomic_done_cnt);
 }
 
+/* Returns the time of the next work of a tm_system for the service thread,
+ * or 0 when there is work to do now. */
+static uint64_t tm_system_next_work(tm_system_t *tm_system)
+{
+	input_work_queue_t *input_work_queue = tm_system->input_work_queue;
+
+	if ((odp_atomic_load_u64(&input_work_queue->queue_cnt) != 0) ||
+	    (tm_system->egress_pkt_desc.queue_num != 0))
+		return 0;
+
+	return _odp_timer_wheel_next_time(tm_system->_odp_int_timer_wheel);
+}
+
+static odp_bool_t tm_group_has_work(tm_system_group_t *tm_group)
+{
+	tm_system_t *tm_system;
+	uint32_t     cnt;
+
+	if (odp_atomic_load_u64(&atomic_request_cnt) !=
+	    odp_atomic_load_u64(&currently_serving_cnt))
+		return true;
+
+	tm_system = tm_group->first_tm_system;
+	for (cnt = 0; cnt < tm_group->num_tm_systems; cnt++) {
+		if ((odp_atomic_load_u64(&tm_system->destroying) != 0) ||
+		    (odp_atomic_load_u64(
+			&tm_system->input_work_queue->queue_cnt) != 0))
+			return true;
+
+		tm_system = tm_system->next;
+	}
+
+	return false;
+}
+
+/* Sleep until wakeup_ns (in odp_time_local() nanoseconds), or until new work
+ * is signalled by tm_group_wakeup(). Short sleeps are not worth the system
+ * call and the wakeup latency, so then the caller keeps polling. */
+static void tm_group_sleep(tm_system_group_t *tm_group, uint64_t wakeup_ns)
+{
+	struct timespec ts;
+	uint64_t current_ns, sleep_ns;
+
+	current_ns = odp_time_to_ns(odp_time_local());
+	if (wakeup_ns <= current_ns + TM_SLEEP_MIN_NS)
+		return;
+
+	sleep_ns = MIN(wakeup_ns - current_ns, TM_SLEEP_MAX_NS);
+	odp_atomic_store_u64(&tm_group->sleep_until_ns, current_ns + sleep_ns);
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	sleep_ns += ts.tv_nsec;
+	ts.tv_sec += sleep_ns / ODP_TIME_SEC_IN_NS;
+	ts.tv_nsec = sleep_ns % ODP_TIME_SEC_IN_NS;
+
+	pthread_mutex_lock(&tm_group->wakeup_lock);
+	odp_atomic_store_u32(&tm_group->sleeping, 1);
+	odp_mb_full();
+
+	/* Timers reported by inline enqueues may expire before the wakeup */
+	if (!tm_group_has_work(tm_group) &&
+	    odp_atomic_load_u64(&tm_group->inline_wakeup_ns) >=
+	    current_ns + sleep_ns)
+		pthread_cond_timedwait(&tm_group->wakeup_cond,
+				       &tm_group->wakeup_lock, &ts);
+
+	odp_atomic_store_u32(&tm_group->sleeping, 0);
+	pthread_mutex_unlock(&tm_group->wakeup_lock);
+}
+
 static int thread_affinity_get(odp_cpumask_t *odp_cpu_mask)
 {
 	cpu_set_t linux_cpu_set;
@@ -2307,14 +2492,107 @@ static int thread_affinity_get(odp_cpumask_t *odp_cpu_mask)
 	return 0;
 }
 
-static void *tm_system_thread(void *arg)
+/* One service step of a tm_system: expired shaper timers, one item of the
+ * input work queue and one egress.  Run by the service thread, and in inline
+ * mode also by the enqueueing thread holding the inline_lock. */
+static void tm_system_service(tm_system_t *tm_system)
 {
 	_odp_timer_wheel_t _odp_int_timer_wheel;
 	input_work_queue_t *input_work_queue;
+	uint64_t current_ns;
+	uint32_t work_queue_cnt, timer_cnt;
+	int rc;
+
+	_odp_int_timer_wheel = tm_system->_odp_int_timer_wheel;
+	input_work_queue = tm_system->input_work_queue;
+
+	current_ns = odp_time_to_ns(odp_time_local());
+	tm_system->current_time = current_ns;
+	rc = _odp_timer_wheel_curr_time_update(_odp_int_timer_wheel,
+					       current_ns);
+	if (0 < rc) {
+		/* Process a batch of expired timers - each of which
+		 * could cause a pkt to egress the tm system. */
+		timer_cnt = 1;
+		(void)tm_process_expired_timers(tm_system,
+						_odp_int_timer_wheel,
+						current_ns);
+	} else {
+		timer_cnt = _odp_timer_wheel_count(_odp_int_timer_wheel);
+	}
+
+	current_ns = odp_time_to_ns(odp_time_local());
+	tm_system->current_time = current_ns;
+	work_queue_cnt = odp_atomic_load_u64(&input_work_queue->queue_cnt);
+
+	if (work_queue_cnt != 0)
+		tm_process_input_work_queue(tm_system, input_work_queue, 1);
+
+	if (tm_system->egress_pkt_desc.queue_num != 0)
+		tm_send_pkt(tm_system, 1);
+
+	current_ns = odp_time_to_ns(odp_time_local());
+	tm_system->current_time = current_ns;
+	tm_system->is_idle = (timer_cnt == 0) && (work_queue_cnt == 0);
+}
+
+/* Report the next timer expiry of an inline tm_system to the service thread
+ * and wake it up, when it sleeps past the expiry.  The full barrier pairs
+ * with the one in tm_group_sleep(). */
+static void tm_inline_timer_report(tm_system_t *tm_system)
+{
+	tm_system_group_t *tm_group;
+	uint64_t next_ns;
+
+	tm_group = GET_TM_GROUP(tm_system->odp_tm_group);
+	if (tm_group->busy_poll)
+		return;
+
+	next_ns = _odp_timer_wheel_next_time(tm_system->_odp_int_timer_wheel);
+	if (next_ns == UINT64_MAX)
+		return;
+
+	odp_atomic_min_u64(&tm_group->inline_wakeup_ns, next_ns);
+	odp_mb_full();
+	if (odp_likely(odp_atomic_load_u32(&tm_group->sleeping) == 0))
+		return;
+
+	if (next_ns < odp_atomic_load_u64(&tm_group->sleep_until_ns)) {
+		pthread_mutex_lock(&tm_group->wakeup_lock);
+		pthread_cond_signal(&tm_group->wakeup_cond);
+		pthread_mutex_unlock(&tm_group->wakeup_lock);
+	}
+}
+
+/* Inline mode processing by an enqueueing thread.  The first thread to take
+ * the inline_lock processes the input work queue, including the packets that
+ * other threads append meanwhile.  A thread failing the trylock leaves its
+ * packet to the owner, which checks the queue again after unlocking. */
+static void tm_inline_process(tm_system_t *tm_system)
+{
+	input_work_queue_t *input_work_queue = tm_system->input_work_queue;
+
+	do {
+		if (!odp_ticketlock_trylock(&tm_system->inline_lock))
+			return;
+
+		do {
+			tm_system_service(tm_system);
+		} while ((odp_atomic_load_u64(&input_work_queue->queue_cnt) !=
+			  0) || (tm_system->egress_pkt_desc.queue_num != 0));
+
+		tm_inline_timer_report(tm_system);
+		odp_ticketlock_unlock(&tm_system->inline_lock);
+	} while (odp_atomic_load_u64(&input_work_queue->queue_cnt) != 0);
+}
+
+static void *tm_system_thread(void *arg)
+{
+	_odp_timer_wheel_t _odp_int_timer_wheel;
 	tm_system_group_t  *tm_group;
 	tm_system_t *tm_system;
-	uint64_t current_ns;
-	uint32_t destroying, work_queue_cnt, timer_cnt;
+	uint64_t current_ns, wakeup_ns;
+	uint32_t destroying, served_cnt;
 	int rc;
 
 	rc = odp_init_local((odp_instance_t)odp_global_data.main_pid,
@@ -2322,11 +2600,18 @@ static void *tm_system_thread(void *arg)
 	ODP_ASSERT(rc == 0);
 	tm_group = arg;
 
+	/* Sleep no longer than timer wheel expiries need */
+	(void)prctl(PR_SET_TIMERSLACK, TM_SLEEP_SLACK_NS);
+
 	tm_system = tm_group->first_tm_system;
 	_odp_int_timer_wheel = tm_system->_odp_int_timer_wheel;
-	input_work_queue = tm_system->input_work_queue;
 
-	/* Wait here until we have seen the first enqueue operation. */
+	/* Wait here until we have seen the first enqueue operation.  Inline
+	 * enqueues leave their packets to this thread until the timer wheel
+	 * is started. */
+	if (tm_system->inline_enq)
+		odp_ticketlock_lock(&tm_system->inline_lock);
+
 	odp_barrier_wait(&tm_system->tm_system_barrier);
 	main_loop_running = true;
 
@@ -2334,51 +2619,46 @@ static void *tm_system_thread(void *arg)
 
 	current_ns = odp_time_to_ns(odp_time_local());
 	_odp_timer_wheel_start(_odp_int_timer_wheel, current_ns);
+	if (tm_system->inline_enq)
+		odp_ticketlock_unlock(&tm_system->inline_lock);
+
+	wakeup_ns = UINT64_MAX;
+	served_cnt = 0;
 
 	while (destroying == 0) {
 		/* See if another thread wants to make a configuration
 		 * change. */
-		check_for_request();
-
-		current_ns = odp_time_to_ns(odp_time_local());
-		tm_system->current_time = current_ns;
-		rc = _odp_timer_wheel_curr_time_update(_odp_int_timer_wheel,
-						       current_ns);
-		if (0 < rc) {
-			/* Process a batch of expired timers - each of which
-			 * could cause a pkt to egress the tm system. */
-			timer_cnt = 1;
-			(void)tm_process_expired_timers(tm_system,
-							_odp_int_timer_wheel,
-							current_ns);
-		} else {
-			timer_cnt =
-				_odp_timer_wheel_count(_odp_int_timer_wheel);
-		}
+		check_for_request(tm_group);
 
-		current_ns = odp_time_to_ns(odp_time_local());
-		tm_system->current_time = current_ns;
-		work_queue_cnt =
-			odp_atomic_load_u64(&input_work_queue->queue_cnt);
+		/* In inline mode, the service thread takes care of the
+		 * expired timers, while the enqueueing threads are idle. */
+		if (tm_system->inline_enq)
+			odp_ticketlock_lock(&tm_system->inline_lock);
 
-		if (work_queue_cnt != 0) {
-			tm_process_input_work_queue(tm_system,
-						    input_work_queue, 1);
-		}
+		tm_system_service(tm_system);
+		destroying = odp_atomic_load_u64(&tm_system->destroying);
 
-		if (tm_system->egress_pkt_desc.queue_num != 0)
-			tm_send_pkt(tm_system, 1);
+		if (!tm_group->busy_poll)
+			wakeup_ns = MIN(wakeup_ns,
+					tm_system_next_work(tm_system));
 
-		current_ns = odp_time_to_ns(odp_time_local());
-		tm_system->current_time = current_ns;
-		tm_system->is_idle = (timer_cnt == 0) &&
-			(work_queue_cnt == 0);
-		destroying = odp_atomic_load_u64(&tm_system->destroying);
+		if (tm_system->inline_enq)
+			odp_ticketlock_unlock(&tm_system->inline_lock);
 
 		/* Advance to the next tm_system in the tm_system_group. */
 		tm_system = tm_system->next;
-		_odp_int_timer_wheel = tm_system->_odp_int_timer_wheel;
-		input_work_queue = tm_system->input_work_queue;
+
+		/* After a round over all tm_systems, sleep until the earliest
+		 * next work of any of them. */
+		if (++served_cnt < tm_group->num_tm_systems)
+			continue;
+
+		if (!tm_group->busy_poll && destroying == 0)
+			tm_group_sleep(tm_group, wakeup_ns);
+
+		wakeup_ns = UINT64_MAX;
+		served_cnt = 0;
+		odp_atomic_store_u64(&tm_group->inline_wakeup_ns, UINT64_MAX);
 	}
 
 	odp_barrier_wait(&tm_system->tm_system_destroy_barrier);
@@ -2622,10 +2902,20 @@ static int tm_thread_create(tm_system_group_t *tm_group)
 static _odp_tm_group_t _odp_tm_group_create(const char *name ODP_UNUSED)
 {
 	tm_system_group_t *tm_group, *first_tm_group, *second_tm_group;
+	pthread_condattr_t cond_attr;
 
 	tm_group = malloc(sizeof(tm_system_group_t));
 	memset(tm_group, 0, sizeof(tm_system_group_t));
 
+	odp_atomic_init_u32(&tm_group->sleeping, 0);
+	odp_atomic_init_u64(&tm_group->sleep_until_ns, 0);
+	odp_atomic_init_u64(&tm_group->inline_wakeup_ns, UINT64_MAX);
+	pthread_mutex_init(&tm_group->wakeup_lock, NULL);
+	pthread_condattr_init(&cond_attr);
+	pthread_condattr_setclock(&cond_attr, CLOCK_MONOTONIC);
+	pthread_cond_init(&tm_group->wakeup_cond, &cond_attr);
+	pthread_condattr_destroy(&cond_attr);
+
 	/* Add this group to the tm_group_list linked list. */
 	if (tm_group_list == NULL) {
 		tm_group_list  = tm_group;
@@ -2655,6 +2945,8 @@ static void _odp_tm_group_destroy(_odp_tm_group_t odp_tm_group)
 	rc = pthread_join(tm_group->thread, NULL);
 	ODP_ASSERT(rc == 0);
 	pthread_attr_destroy(&tm_group->attr);
+	pthread_cond_destroy(&tm_group->wakeup_cond);
+	pthread_mutex_destroy(&tm_group->wakeup_lock);
 	if (g_tm_cpu_num > 0)
 		g_tm_cpu_num--;
 
@@ -2686,6 +2978,8 @@ static int _odp_tm_group_add(_odp_tm_group_t odp_tm_group, odp_tm_t odp_tm)
 	tm_system = GET_TM_SYSTEM(odp_tm);
 	tm_group->num_tm_systems++;
 	tm_system->odp_tm_group = odp_tm_group;
+	if (tm_system->requirements.busy_poll_needed)
+		tm_group->busy_poll = true;
 
 	/* Link this tm_system into the circular linked list of all tm_systems
 	 * belonging to the same tm_group. */
@@ -2818,6 +3112,7 @@ odp_tm_t odp_tm_create(const char            *name,
 	/* If we are using pktio output (usual case) get the first associated
 	 * pktout_queue for this pktio and fail if there isn't one.
 	 */
+	memset(&pktout, 0, sizeof(odp_pktout_queue_t));
 	if (egress->egress_kind == ODP_TM_EGRESS_PKT_IO &&
 	    odp_pktout_queue(egress->pktio, &pktout, 1) != 1)
 		return ODP_TM_INVALID;
@@ -2838,9 +3133,6 @@ odp_tm_t odp_tm_create(const char            *name,
 		return ODP_TM_INVALID;
 	}
 
-	if (odp_pktout_queue(egress->pktio, &pktout, 1) != 1)
-		return ODP_TM_INVALID;
-
 	tm_system->pktout = pktout;
 	tm_system->name_tbl_id = name_tbl_id;
 	max_tm_queues = requirements->max_tm_queues;
@@ -2856,8 +3148,6 @@ odp_tm_t odp_tm_create(const char            *name,
 	memset(tm_system->queue_num_tbl, 0, malloc_len);
 	tm_system->next_queue_num = 1;
 
-	tm_init_random_data(&tm_system->tm_random_data);
-
 	max_sorted_lists = 2 * max_tm_queues;
 	max_num_queues = max_tm_queues;
 	max_queued_pkts = 16 * max_tm_queues;
@@ -2869,6 +3159,8 @@ odp_tm_t odp_tm_create(const char            *name,
 	tm_system->_odp_int_timer_wheel = _ODP_INT_TIMER_WHEEL_INVALID;
 
 	odp_ticketlock_init(&tm_system->tm_system_lock);
+	odp_ticketlock_init(&tm_system->inline_lock);
+	tm_system->inline_enq = requirements->inline_enq_needed;
 	odp_barrier_init(&tm_system->tm_system_barrier, 2);
 	odp_atomic_init_u64(&tm_system->destroying, 0);
 
@@ -2972,6 +3264,7 @@ int odp_tm_destroy(odp_tm_t odp_tm)
 	 */
 	odp_barrier_init(&tm_system->tm_system_destroy_barrier, 2);
 	odp_atomic_inc_u64(&tm_system->destroying);
+	tm_group_wakeup(GET_TM_GROUP(tm_system->odp_tm_group));
 	odp_barrier_wait(&tm_system->tm_system_destroy_barrier);
 
 	/* Remove ourselves from the group.  If we are the last tm_system in
@@ -4325,6 +4618,28 @@ int odp_tm_enq_with_cnt(odp_tm_queue_t tm_queue, odp_packet_t pkt)
 	return pkt_cnt;
 }
 
+int odp_tm_enq_multi(odp_tm_queue_t tm_queue, const odp_packet_t packets[],
+		     int num)
+{
+	tm_queue_obj_t *tm_queue_obj;
+	tm_system_t *tm_system;
+	uint32_t pkt_depth;
+
+	tm_queue_obj = GET_TM_QUEUE_OBJ(tm_queue);
+	if (!tm_queue_obj || num <= 0)
+		return -1;
+
+	tm_system = odp_tm_systems[tm_queue_obj->tm_idx];
+	if (!tm_system)
+		return -1;
+
+	if (odp_atomic_load_u64(&tm_system->destroying))
+		return -1;
+
+	return tm_enqueue_multi(tm_system, tm_queue_obj, packets, num,
+				&pkt_depth);
+}
+
 int odp_tm_node_info(odp_tm_node_t tm_node, odp_tm_node_info_t *info)
 {
 	tm_queue_thresholds_t *threshold_params;
@@ -23,6 +23,7 @@
 
 #include <rte_config.h>
 #include <rte_mbuf.h>
+#include <rte_mempool.h>
 #include <rte_ethdev.h>
 #include <rte_string_fns.h>
 
@@ -373,6 +374,264 @@ static int dpdk_setup_port(pktio_entry_t *pktio_entry)
 	return 0;
 }
 
+#ifdef ODP_DPDK_ZERO_COPY
+ODP_STATIC_ASSERT(PKT_EXTRA_LEN >= sizeof(struct rte_mbuf),
+		  "DPDK mbuf does not fit into packet header");
+
+/**
+ * ODP packet pool used as a DPDK mempool
+ *
+ * Mempool objects are the mbufs stored in ODP packet headers. PMDs allocate
+ * and free packets through the mempool ops, so received mbufs are ODP
+ * packets and transmitted packets are freed into the ODP pool when the PMD
+ * has completed them.
+ */
+typedef struct {
+	struct rte_mempool *mp;		/**< DPDK mempool */
+	odp_pool_t pool;		/**< ODP packet pool */
+	uint32_t alloc_len;		/**< packet length filling a segment */
+	uint32_t refs;			/**< number of pktios using the pool */
+	uint8_t *base;			/**< pool memory base address */
+	uint64_t phys_base;		/**< physical address of pool memory */
+	/** Pool memory is physically contiguous, starting from phys_base */
+	odp_bool_t phys_contig;
+} zc_pool_t;
+
+static zc_pool_t zc_pool_tbl[ODP_CONFIG_POOLS];
+static odp_ticketlock_t zc_lock;
+
+static inline struct rte_mbuf *pkt_hdr_to_mbuf(odp_packet_hdr_t *pkt_hdr)
+{
+	return (struct rte_mbuf *)(void *)pkt_hdr->extra;
+}
+
+static inline odp_packet_hdr_t *mbuf_to_pkt_hdr(struct rte_mbuf *mbuf)
+{
+	return (odp_packet_hdr_t *)(void *)((uint8_t *)mbuf -
+					    offsetof(odp_packet_hdr_t, extra));
+}
+
+static inline odp_packet_t pkt_hdr_to_pkt(odp_packet_hdr_t *pkt_hdr)
+{
+	return _odp_packet_from_buffer(odp_hdr_to_buf(&pkt_hdr->buf_hdr));
+}
+
+/* Describe the first segment of a packet with its mbuf */
+static inline struct rte_mbuf *mbuf_init(zc_pool_t *zc,
+					 odp_packet_hdr_t *pkt_hdr,
+					 uint16_t refcnt)
+{
+	struct rte_mbuf *mbuf = pkt_hdr_to_mbuf(pkt_hdr);
+	uint8_t *addr = pkt_hdr->buf_hdr.addr[0];
+
+	mbuf->buf_addr = addr;
+	mbuf->buf_physaddr = zc->phys_contig ?
+			     zc->phys_base + (addr - zc->base) : 0;
+	mbuf->buf_len = pkt_hdr->buf_hdr.segsize;
+	mbuf->priv_size = 0;
+	mbuf->pool = zc->mp;
+	rte_mbuf_refcnt_set(mbuf, 1);
+	rte_pktmbuf_reset(mbuf);
+	/* Mbufs in a mempool have no references */
+	rte_mbuf_refcnt_set(mbuf, refcnt);
+
+	return mbuf;
+}
+
+static int zc_pool_alloc(struct rte_mempool *mp ODP_UNUSED)
+{
+	return 0;
+}
+
+static void zc_pool_free(struct rte_mempool *mp ODP_UNUSED)
+{
+}
+
+/* Mbufs freed by PMDs are freed into the ODP pool */
+static int zc_pool_enqueue(struct rte_mempool *mp ODP_UNUSED,
+			   void * const *obj_table, unsigned n)
+{
+	unsigned i;
+
+	if (odp_unlikely(n == 0))
+		return 0;
+
+	odp_packet_t pkt[n];
+
+	for (i = 0; i < n; i++)
+		pkt[i] = pkt_hdr_to_pkt(mbuf_to_pkt_hdr(obj_table[i]));
+
+	odp_packet_free_multi(pkt, n);
+
+	return 0;
+}
+
+/* PMDs allocate mbufs for packet input from the ODP pool. Either all
+ * requested mbufs are returned or none. */
+static int zc_pool_dequeue(struct rte_mempool *mp, void **obj_table,
+			   unsigned n)
+{
+	zc_pool_t *zc = mp->pool_config;
+	unsigned i;
+	int num;
+
+	if (odp_unlikely(n == 0))
+		return 0;
+
+	odp_packet_t pkt[n];
+
+	num = packet_alloc_multi(zc->pool, zc->alloc_len, pkt, n);
+	if (odp_unlikely((unsigned)num != n)) {
+		if (num > 0)
+			odp_packet_free_multi(pkt, num);
+		return -ENOENT;
+	}
+
+	for (i = 0; i < n; i++)
+		obj_table[i] = mbuf_init(zc, odp_packet_hdr(pkt[i]), 0);
+
+	return 0;
+}
+
+static unsigned zc_pool_get_count(const struct rte_mempool *mp)
+{
+	const zc_pool_t *zc = mp->pool_config;
+	pool_entry_t *pool = odp_pool_to_entry(zc->pool);
+
+	return odp_atomic_load_u32(&pool->s.bufcount);
+}
+
+static struct rte_mempool_ops zc_pool_ops = {
+	.name = "odp_pool",
+	.alloc = zc_pool_alloc,
+	.free = zc_pool_free,
+	.enqueue = zc_pool_enqueue,
+	.dequeue = zc_pool_dequeue,
+	.get_count = zc_pool_get_count
+};
+
+MEMPOOL_REGISTER_OPS(zc_pool_ops);
+
+/* Devices doing DMA need physical addresses. Pool memory must be in huge
+ * pages, which stay in place, and physically contiguous. */
+static int zc_pool_phys_init(zc_pool_t *zc)
+{
+	pool_entry_t *pool = odp_pool_to_entry(zc->pool);
+	odp_shm_info_t info;
+	uint64_t offset;
+	phys_addr_t phys;
+	uint8_t *addr;
+
+	if (zc->phys_contig)
+		return 0;
+
+	if (odp_shm_info(pool->s.pool_shm, &info) ||
+	    info.page_size <= ODP_PAGE_SIZE)
+		return -1;
+
+	for (offset = 0; offset < info.size; offset += info.page_size) {
+		addr = (uint8_t *)info.addr + offset;
+
+		/* Pages of a pool are touched on first use */
+		(void)__atomic_load_n(addr, __ATOMIC_RELAXED);
+
+		phys = rte_mem_virt2phy(addr);
+		if (phys == RTE_BAD_PHYS_ADDR)
+			return -1;
+
+		if (offset == 0)
+			zc->phys_base = phys;
+		else if (phys != zc->phys_base + offset)
+			return -1;
+	}
+
+	zc->base = info.addr;
+	zc->phys_contig = 1;
+
+	return 0;
+}
+
+/* Get the DPDK mempool of an ODP packet pool, create it on first use.
+ * Returns NULL if the pool cannot be used without copying packets. */
+static zc_pool_t *zc_pool_get(odp_pool_t pool, uint32_t data_room,
+			      odp_bool_t phys)
+{
+	pool_entry_t *entry = odp_pool_to_entry(pool);
+	uint32_t pool_id = pool_handle_to_index(pool);
+	zc_pool_t *zc = &zc_pool_tbl[pool_id];
+	struct rte_pktmbuf_pool_private *mbp_priv;
+	struct rte_mempool *mp;
+	char name[RTE_MEMPOOL_NAMESIZE];
+	uint32_t seg_size = entry->s.seg_size;
+
+	/* Packets are received into a single segment, after DPDK headroom */
+	if (seg_size < RTE_PKTMBUF_HEADROOM + data_room ||
+	    seg_size > UINT16_MAX)
+		return NULL;
+
+	odp_ticketlock_lock(&zc_lock);
+
+	if (zc->mp == NULL) {
+		snprintf(name, sizeof(name), "odp_pool_%" PRIu32, pool_id);
+		mp = rte_mempool_create_empty(name, entry->s.buf_num,
+					      sizeof(struct rte_mbuf), 0,
+					      sizeof(*mbp_priv),
+					      rte_socket_id(), 0);
+		if (mp == NULL) {
+			odp_ticketlock_unlock(&zc_lock);
+			ODP_ERR("Cannot create mempool of pool %s\n",
+				entry->s.name);
+			return NULL;
+		}
+
+		if (rte_mempool_set_ops_byname(mp, zc_pool_ops.name, zc)) {
+			rte_mempool_free(mp);
+			odp_ticketlock_unlock(&zc_lock);
+			ODP_ERR("Cannot set mempool ops\n");
+			return NULL;
+		}
+
+		mbp_priv = rte_mempool_get_priv(mp);
+		mbp_priv->mbuf_data_room_size = seg_size;
+		mbp_priv->mbuf_priv_size = 0;
+
+		zc->mp = mp;
+		zc->pool = pool;
+		zc->alloc_len = seg_size - entry->s.headroom -
+				entry->s.tailroom;
+		zc->refs = 0;
+		zc->phys_contig = 0;
+	}
+
+	if (phys && zc_pool_phys_init(zc)) {
+		if (zc->refs == 0) {
+			rte_mempool_free(zc->mp);
+			zc->mp = NULL;
+		}
+		odp_ticketlock_unlock(&zc_lock);
+		ODP_DBG("Pool %s memory not usable for DMA\n", entry->s.name);
+		return NULL;
+	}
+
+	zc->refs++;
+	odp_ticketlock_unlock(&zc_lock);
+
+	return zc;
+}
+
+static void zc_pool_put(zc_pool_t *zc)
+{
+	odp_ticketlock_lock(&zc_lock);
+
+	if (--zc->refs == 0) {
+		rte_mempool_free(zc->mp);
+		zc->mp = NULL;
+	}
+
+	odp_ticketlock_unlock(&zc_lock);
+}
+#endif /* ODP_DPDK_ZERO_COPY */
+
 static int dpdk_close(pktio_entry_t *pktio_entry)
 {
 	pkt_dpdk_t *pkt_dpdk = &pktio_entry->s.pkt_dpdk;
@@ -392,6 +651,12 @@ static int dpdk_close(pktio_entry_t *pktio_entry)
 
 	rte_mempool_free(pkt_dpdk->pkt_pool);
 
+#ifdef ODP_DPDK_ZERO_COPY
+	/* Device is closed, so it holds no mbufs of the pool anymore */
+	if (pkt_dpdk->zc_pool != NULL)
+		zc_pool_put(pkt_dpdk->zc_pool->pool_config);
+#endif
+
 	return 0;
 }
 
@@ -495,6 +760,10 @@ static int dpdk_pktio_init(void)
 /* Placeholder for DPDK global init */
 static int dpdk_pktio_init_global(void)
 {
+#ifdef ODP_DPDK_ZERO_COPY
+	odp_ticketlock_init(&zc_lock);
+#endif
+
 	if (getenv("ODP_PKTIO_DISABLE_DPDK")) {
 		ODP_PRINT("PKTIO: dpdk pktio skipped,"
 			  " enabled export ODP_PKTIO_DISABLE_DPDK=1.\n");
@@ -593,6 +862,9 @@ static int dpdk_open(odp_pktio_t id ODP_UNUSED,
 	uint16_t data_room;
 	uint32_t mtu;
 	int i;
+#ifdef ODP_DPDK_ZERO_COPY
+	zc_pool_t *zc;
+#endif
 
 	if (disable_pktio)
 		return -1;
@@ -633,6 +905,9 @@ static int dpdk_open(odp_pktio_t id ODP_UNUSED,
 
 	dpdk_init_capability(pktio_entry);
 
+	memset(&dev_info, 0, sizeof(struct rte_eth_dev_info));
+	rte_eth_dev_info_get(pkt_dpdk->port_id, &dev_info);
+
 	mtu = dpdk_mtu_get(pktio_entry);
 	if (mtu == 0) {
 		ODP_ERR("Failed to read interface MTU\n");
@@ -668,6 +943,15 @@ static int dpdk_open(odp_pktio_t id ODP_UNUSED,
 	/* Mbuf chaining not yet supported */
 	 pkt_dpdk->mtu = RTE_MIN(pkt_dpdk->mtu, pkt_dpdk->data_room);
 
+#ifdef ODP_DPDK_ZERO_COPY
+	/* PCI devices need physical addresses of packet data */
+	zc = zc_pool_get(pool, pkt_dpdk->data_room, dev_info.pci_dev != NULL);
+	if (zc != NULL)
+		pkt_dpdk->zc_pool = zc->mp;
+	else
+		ODP_DBG("Zero-copy not possible, copying packets\n");
+#endif
+
 	for (i = 0; i < PKTIO_MAX_QUEUES; i++) {
 		odp_ticketlock_init(&pkt_dpdk->rx_lock[i]);
 		odp_ticketlock_init(&pkt_dpdk->tx_lock[i]);
@@ -682,9 +966,14 @@ static int dpdk_start(pktio_entry_t *pktio_entry)
 {
 	pkt_dpdk_t *pkt_dpdk = &pktio_entry->s.pkt_dpdk;
 	uint8_t port_id = pkt_dpdk->port_id;
+	struct rte_mempool *rx_pool = pkt_dpdk->pkt_pool;
 	int ret;
 	unsigned i;
 
+	/* Zero-copy PMDs receive directly into ODP packets */
+	if (pkt_dpdk->zc_pool != NULL)
+		rx_pool = pkt_dpdk->zc_pool;
+
 	/* DPDK doesn't support nb_rx_q/nb_tx_q being 0 */
 	if (!pktio_entry->s.num_in_queue)
 		pktio_entry->s.num_in_queue = 1;
@@ -711,7 +1000,7 @@ static int dpdk_start(pktio_entry_t *pktio_entry)
 	for (i = 0; i < pktio_entry->s.num_in_queue; i++) {
 		ret = rte_eth_rx_queue_setup(port_id, i, DPDK_NM_RX_DESC,
 					     rte_eth_dev_socket_id(port_id),
-					     NULL, pkt_dpdk->pkt_pool);
+					     NULL, rx_pool);
 		if (ret < 0) {
 			ODP_ERR("Queue setup failed: err=%d, port=%" PRIu8 "\n",
 				ret, port_id);
@@ -797,8 +1086,6 @@ static inline int mbuf_to_pkt(pktio_entry_t *pktio_entry,
 
 		if (pktio_cls_enabled(pktio_entry))
 			copy_packet_cls_metadata(&parsed_hdr, pkt_hdr);
-		else
-			packet_parse_l2(&pkt_hdr->p, pkt_len);
 
 		if (mbuf->ol_flags & PKT_RX_RSS_HASH)
 			odp_packet_flow_hash_set(pkt, mbuf->hash.rss);
@@ -810,6 +1097,10 @@ static inline int mbuf_to_pkt(pktio_entry_t *pktio_entry,
 		rte_pktmbuf_free(mbuf);
 	}
 
+	if (!pktio_cls_enabled(pktio_entry))
+		packet_parse_multi(pkt_table, nb_pkts,
+				   pktio_entry->s.parse_layer);
+
 	return nb_pkts;
 
 fail:
@@ -818,6 +1109,9 @@ fail:
 	for (j = i; j < num; j++)
 		rte_pktmbuf_free(mbuf_table[j]);
 
+	if (!pktio_cls_enabled(pktio_entry))
+		packet_parse_multi(pkt_table, i, pktio_entry->s.parse_layer);
+
 	return (i > 0 ? i : -1);
 }
 
@@ -858,6 +1152,162 @@ fail:
 	return i;
 }
 
+#ifdef ODP_DPDK_ZERO_COPY
+/* Received mbufs are ODP packets. Packet metadata is updated to match the
+ * data written by the PMD. */
+static inline int mbuf_to_pkt_zero(pktio_entry_t *pktio_entry,
+				   odp_packet_t pkt_table[],
+				   struct rte_mbuf *mbuf_table[],
+				   uint16_t mbuf_num, odp_time_t *ts)
+{
+	odp_packet_t pkt;
+	odp_packet_hdr_t *pkt_hdr;
+	uint16_t pkt_len;
+	struct rte_mbuf *mbuf;
+	void *buf;
+	int i;
+	int nb_pkts = 0;
+	odp_pool_t pool = pktio_entry->s.pkt_dpdk.pool;
+
+	for (i = 0; i < mbuf_num; i++) {
+		odp_packet_hdr_t parsed_hdr;
+
+		mbuf = mbuf_table[i];
+		if (odp_unlikely(mbuf->nb_segs != 1)) {
+			ODP_ERR("Segmented buffers not supported\n");
+			rte_pktmbuf_free(mbuf);
+			continue;
+		}
+
+		buf = rte_pktmbuf_mtod(mbuf, char *);
+		odp_prefetch(buf);
+
+		pkt_len = rte_pktmbuf_pkt_len(mbuf);
+		pkt_hdr = mbuf_to_pkt_hdr(mbuf);
+		pkt     = pkt_hdr_to_pkt(pkt_hdr);
+
+		if (pktio_cls_enabled(pktio_entry)) {
+			if (cls_classify_packet(pktio_entry,
+						(const uint8_t *)buf,
+						pkt_len, pkt_len, &pool,
+						&parsed_hdr)) {
+				odp_packet_free(pkt);
+				continue;
+			}
+		}
+
+		pkt_hdr->headroom  = mbuf->data_off;
+		pkt_hdr->frame_len = pkt_len;
+		pkt_hdr->tailroom  = pkt_hdr->buf_hdr.size - mbuf->data_off -
+				     pkt_len;
+
+		pkt_hdr->input = pktio_entry->s.handle;
+
+		if (pktio_cls_enabled(pktio_entry))
+			copy_packet_cls_metadata(&parsed_hdr, pkt_hdr);
+
+		if (mbuf->ol_flags & PKT_RX_RSS_HASH)
+			odp_packet_flow_hash_set(pkt, mbuf->hash.rss);
+
+		packet_set_ts(pkt_hdr, ts);
+
+		pkt_table[nb_pkts++] = pkt;
+	}
+
+	if (!pktio_cls_enabled(pktio_entry))
+		packet_parse_multi(pkt_table, nb_pkts,
+				   pktio_entry->s.parse_layer);
+
+	return nb_pkts;
+}
+
+static inline int pkt_is_zero_copy(zc_pool_t *zc, odp_packet_hdr_t *pkt_hdr)
+{
+#ifdef MV_NETMAP_BUF_ZERO_COPY
+	if (is_ext_buffer(&pkt_hdr->buf_hdr))
+		return 0;
+#endif
+	return pkt_hdr->buf_hdr.pool_hdl == zc->pool &&
+	       pkt_hdr->buf_hdr.segcount == 1;
+}
+
+/* Single segment packets of the zero-copy pool are passed to the PMD as
+ * such, other packets are copied. The PMD frees the mbufs of transmitted
+ * packets, which frees the packets into the ODP pool. */
+static inline int pkt_to_mbuf_zero(pktio_entry_t *pktio_entry,
+				   struct rte_mbuf *mbuf_table[],
+				   const odp_packet_t pkt_table[],
+				   uint16_t num, uint8_t copied[])
+{
+	pkt_dpdk_t *pkt_dpdk = &pktio_entry->s.pkt_dpdk;
+	zc_pool_t *zc = pkt_dpdk->zc_pool->pool_config;
+	odp_packet_hdr_t *pkt_hdr;
+	struct rte_mbuf *mbuf;
+	uint32_t pkt_len;
+	char *data;
+	int i;
+
+	for (i = 0; i < num; i++) {
+		pkt_hdr = odp_packet_hdr(pkt_table[i]);
+		pkt_len = packet_len(pkt_hdr);
+
+		if (pkt_len > pkt_dpdk->mtu) {
+			if (i == 0)
+				__odp_errno = EMSGSIZE;
+			break;
+		}
+
+		if (odp_likely(pkt_is_zero_copy(zc, pkt_hdr))) {
+			mbuf = mbuf_init(zc, pkt_hdr, 1);
+			mbuf->data_off = pkt_hdr->headroom;
+			mbuf->data_len = pkt_len;
+			mbuf->pkt_len  = pkt_len;
+			copied[i] = 0;
+		} else {
+			mbuf = rte_pktmbuf_alloc(pkt_dpdk->pkt_pool);
+			if (odp_unlikely(mbuf == NULL)) {
+				ODP_ERR("Failed to alloc mbuf\n");
+				break;
+			}
+
+			/* Packet always fits in mbuf */
+			data = rte_pktmbuf_append(mbuf, pkt_len);
+			odp_packet_copy_to_mem(pkt_table[i], 0, pkt_len, data);
+			copied[i] = 1;
+		}
+
+		mbuf_table[i] = mbuf;
+	}
+
+	return i;
+}
+
+/* Free sent copied packets and mbufs of copied packets not sent. Packets
+ * passed to the PMD as such are freed by the PMD, or stay with the caller
+ * when not sent. */
+static inline int tx_done_zero(const odp_packet_t pkt_table[],
+			       struct rte_mbuf *mbuf_table[],
+			       const uint8_t copied[], int tx_pkts, int mbufs)
+{
+	int i;
+
+	for (i = 0; i < mbufs; i++) {
+		if (!copied[i])
+			continue;
+
+		if (i < tx_pkts)
+			odp_packet_free(pkt_table[i]);
+		else
+			rte_pktmbuf_free(mbuf_table[i]);
+	}
+
+	if (odp_unlikely(tx_pkts == 0 && __odp_errno != 0))
+		return -1;
+
+	return tx_pkts;
+}
+#endif /* ODP_DPDK_ZERO_COPY */
+
 static int dpdk_recv(pktio_entry_t *pktio_entry, int index,
 		     odp_packet_t pkt_table[], int num)
 {
@@ -921,6 +1371,11 @@ static int dpdk_recv(pktio_entry_t *pktio_entry, int index,
 			ts_val = odp_time_global();
 			ts = &ts_val;
 		}
+#ifdef ODP_DPDK_ZERO_COPY
+		if (pkt_dpdk->zc_pool != NULL)
+			return mbuf_to_pkt_zero(pktio_entry, pkt_table,
+						rx_mbufs, nb_rx, ts);
+#endif
 		nb_rx = mbuf_to_pkt(pktio_entry, pkt_table, rx_mbufs, nb_rx,
 				    ts);
 	}
@@ -936,11 +1391,22 @@ static int dpdk_send(pktio_entry_t *pktio_entry, int index,
 	int tx_pkts;
 	int i;
 	int mbufs;
+#ifdef ODP_DPDK_ZERO_COPY
+	uint8_t copied[num];
+#endif
 
 	if (odp_unlikely(pktio_entry->s.state != PKTIO_STATE_STARTED))
 		return 0;
 
+#ifdef ODP_DPDK_ZERO_COPY
+	if (pkt_dpdk->zc_pool != NULL)
+		mbufs = pkt_to_mbuf_zero(pktio_entry, tx_mbufs, pkt_table, num,
+					 copied);
+	else
+		mbufs = pkt_to_mbuf(pktio_entry, tx_mbufs, pkt_table, num);
+#else
 	mbufs = pkt_to_mbuf(pktio_entry, tx_mbufs, pkt_table, num);
+#endif
 
 	if (!pkt_dpdk->lockless_tx)
 		odp_ticketlock_lock(&pkt_dpdk->tx_lock[index]);
@@ -951,6 +1417,12 @@ static int dpdk_send(pktio_entry_t *pktio_entry, int index,
 	if (!pkt_dpdk->lockless_tx)
 		odp_ticketlock_unlock(&pkt_dpdk->tx_lock[index]);
 
+#ifdef ODP_DPDK_ZERO_COPY
+	if (pkt_dpdk->zc_pool != NULL)
+		return tx_done_zero(pkt_table, tx_mbufs, copied, tx_pkts,
+				    mbufs);
+#endif
+
 	if (odp_unlikely(tx_pkts < num)) {
 		for (i = tx_pkts; i < mbufs; i++)
 			rte_pktmbuf_free(tx_mbufs[i]);
@@ -24,6 +24,11 @@ const pktio_if_ops_t * const pktio_if_ops[]  = {
 #ifdef _ODP_PKTIO_IPC
 	&ipc_pktio_ops,
 #endif
+#ifdef ODP_PKTIO_XDP
+	&xdp_pktio_ops,
+#endif
+	&mpcap_pktio_ops,
+	&memif_pktio_ops,
 	&tap_pktio_ops,
 	&sock_mmap_pktio_ops,
 	&sock_mmsg_pktio_ops,
@@ -517,8 +517,8 @@ static int ipc_pktio_recv_lockless(pktio_entry_t *pktio_entry,
 		odp_packet_hdr_t phdr;
 		void *ptr;
 		odp_buffer_bits_t handle;
-		int idx; /* Remote packet has coded pool and index.
-			  * We need only index.*/
+		uintptr_t idx; /* Remote packet has coded pool and index.
+				* We need only index.*/
 		void *pkt_data;
 		void *remote_pkt_data;
 
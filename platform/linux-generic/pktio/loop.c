@@ -22,24 +22,72 @@
 /* MAC address for the "loop" interface */
 static const char pktio_loop_mac[] = {0x02, 0xe9, 0x34, 0x80, 0x73, 0x01};
 
+/* Size of pktin queue rings. Must be a power of two. */
+#define LOOP_RING_SIZE 4096
+
 static int loopback_stats_reset(pktio_entry_t *pktio_entry);
 
-static int loopback_open(odp_pktio_t id, pktio_entry_t *pktio_entry,
+static int loop_ring_create(pktio_entry_t *pktio_entry, unsigned index)
+{
+	char ring_name[_RING_NAMESIZE];
+	struct loop_queue_t *rxq = &pktio_entry->s.pkt_loop.rxq[index].s;
+
+	snprintf(ring_name, sizeof(ring_name), "%" PRIu64 "-loop_rx%u",
+		 odp_pktio_to_u64(pktio_entry->s.handle), index);
+
+	/* Locking serializes consumers, while all pktout queues may
+	 * produce into the ring */
+	rxq->ring = _ring_create(ring_name, LOOP_RING_SIZE,
+				 _RING_F_SC_DEQ | _RING_NO_LIST);
+	if (rxq->ring == NULL) {
+		ODP_ERR("%s: ring create failed\n", ring_name);
+		return -1;
+	}
+
+	return 0;
+}
+
+static void loop_ring_destroy(pktio_entry_t *pktio_entry, unsigned index)
+{
+	struct loop_queue_t *rxq = &pktio_entry->s.pkt_loop.rxq[index].s;
+	odp_packet_t pkt_tbl[QUEUE_MULTI_MAX];
+	int num;
+
+	if (rxq->ring == NULL)
+		return;
+
+	while ((num = _ring_sc_dequeue_burst(rxq->ring, (void **)pkt_tbl,
+					     QUEUE_MULTI_MAX)) > 0)
+		odp_packet_free_multi(pkt_tbl, num);
+
+	_ring_destroy(rxq->ring->name);
+	rxq->ring = NULL;
+}
+
+static int loopback_open(odp_pktio_t id ODP_UNUSED, pktio_entry_t *pktio_entry,
 			 const char *devname, odp_pool_t pool ODP_UNUSED)
 {
+	pkt_loop_t *loop = &pktio_entry->s.pkt_loop;
+	int i;
+
 	if (strcmp(devname, "loop"))
 		return -1;
 
-	char loopq_name[ODP_QUEUE_NAME_LEN];
+	memset(loop, 0, sizeof(pkt_loop_t));
 
-	snprintf(loopq_name, sizeof(loopq_name), "%" PRIu64 "-pktio_loopq",
-		 odp_pktio_to_u64(id));
-	pktio_entry->s.pkt_loop.loopq =
-		odp_queue_create(loopq_name, NULL);
+	for (i = 0; i < LOOP_MAX_QUEUES; i++) {
+		odp_ticketlock_init(&loop->rxq[i].s.lock);
+		odp_ticketlock_init(&loop->txq[i].s.lock);
+	}
 
-	if (pktio_entry->s.pkt_loop.loopq == ODP_QUEUE_INVALID)
+	/* Default to a single queue in each direction, reconfigured by
+	 * pktin/pktout queue config */
+	if (loop_ring_create(pktio_entry, 0))
 		return -1;
 
+	loop->num_in_queues = 1;
+	loop->num_out_queues = 1;
+
 	loopback_stats_reset(pktio_entry);
 
 	return 0;
@@ -47,45 +95,94 @@ static int loopback_open(odp_pktio_t id, pktio_entry_t *pktio_entry,
 
 static int loopback_close(pktio_entry_t *pktio_entry)
 {
-	return odp_queue_destroy(pktio_entry->s.pkt_loop.loopq);
+	pkt_loop_t *loop = &pktio_entry->s.pkt_loop;
+	unsigned i;
+
+	for (i = 0; i < loop->num_in_queues; i++)
+		loop_ring_destroy(pktio_entry, i);
+
+	return 0;
+}
+
+static int loopback_input_queues_config(pktio_entry_t *pktio_entry,
+					const odp_pktin_queue_param_t *p)
+{
+	pkt_loop_t *loop = &pktio_entry->s.pkt_loop;
+	unsigned num_queues = p->num_queues;
+
+	/* Scheduler synchronizes input queue polls. Only single thread
+	 * at a time polls a queue */
+	if (pktio_entry->s.param.in_mode == ODP_PKTIN_MODE_SCHED)
+		loop->lockless_rx = 1;
+	else
+		loop->lockless_rx = (p->op_mode == ODP_PKTIO_OP_MT_UNSAFE);
+
+	loop->hash = p->hash_enable && num_queues > 1;
+
+	/* Packets still in removed queues are freed */
+	while (loop->num_in_queues > num_queues)
+		loop_ring_destroy(pktio_entry, --loop->num_in_queues);
+
+	while (loop->num_in_queues < num_queues) {
+		if (loop_ring_create(pktio_entry, loop->num_in_queues))
+			return -1;
+		loop->num_in_queues++;
+	}
+
+	return 0;
 }
 
-static int loopback_recv(pktio_entry_t *pktio_entry, int index ODP_UNUSED,
+static int loopback_output_queues_config(pktio_entry_t *pktio_entry,
+					 const odp_pktout_queue_param_t *p)
+{
+	pkt_loop_t *loop = &pktio_entry->s.pkt_loop;
+
+	loop->lockless_tx = (p->op_mode == ODP_PKTIO_OP_MT_UNSAFE);
+	loop->num_out_queues = p->num_queues;
+
+	return 0;
+}
+
+static int loopback_recv(pktio_entry_t *pktio_entry, int index,
 			 odp_packet_t pkts[], int len)
 {
-	int nbr, i;
-	odp_buffer_hdr_t *hdr_tbl[QUEUE_MULTI_MAX];
-	queue_entry_t *qentry;
+	pkt_loop_t *loop = &pktio_entry->s.pkt_loop;
+	struct loop_queue_t *rxq = &loop->rxq[index].s;
+	odp_packet_t pkt_tbl[QUEUE_MULTI_MAX];
+	odp_packet_t drop_tbl[QUEUE_MULTI_MAX];
 	odp_packet_hdr_t *pkt_hdr;
 	odp_packet_hdr_t parsed_hdr;
 	odp_packet_t pkt;
 	odp_time_t ts_val;
 	odp_time_t *ts = NULL;
+	int cls_enabled = pktio_cls_enabled(pktio_entry);
+	int nbr, i;
 	int num_rx = 0;
 	int failed = 0;
+	uint64_t octets = 0;
 
 	if (odp_unlikely(len > QUEUE_MULTI_MAX))
 		len = QUEUE_MULTI_MAX;
 
-	odp_ticketlock_lock(&pktio_entry->s.rxl);
+	if (!loop->lockless_rx)
+		odp_ticketlock_lock(&rxq->lock);
 
-	qentry = queue_to_qentry(pktio_entry->s.pkt_loop.loopq);
-	nbr = queue_deq_multi(qentry, hdr_tbl, len);
+	nbr = _ring_sc_dequeue_burst(rxq->ring, (void **)pkt_tbl, len);
 
-	if (pktio_entry->s.config.pktin.bit.ts_all ||
-	    pktio_entry->s.config.pktin.bit.ts_ptp) {
+	if (nbr > 0 && (pktio_entry->s.config.pktin.bit.ts_all ||
+			pktio_entry->s.config.pktin.bit.ts_ptp)) {
 		ts_val = odp_time_global();
 		ts = &ts_val;
 	}
 
 	for (i = 0; i < nbr; i++) {
-		uint32_t pkt_len;
+		uint32_t pkt_len, hash;
+		int has_hash;
 
-		pkt = _odp_packet_from_buffer(odp_hdr_to_buf(hdr_tbl[i]));
+		pkt = pkt_tbl[i];
 		pkt_len = odp_packet_len(pkt);
 
-
-		if (pktio_cls_enabled(pktio_entry)) {
+		if (cls_enabled) {
 			odp_packet_t new_pkt;
 			odp_pool_t new_pool;
 			uint8_t *pkt_addr;
@@ -109,19 +206,17 @@ static int loopback_recv(pktio_entry_t *pktio_entry, int index ODP_UNUSED,
 						  pkt_len, seg_len,
 						  &new_pool, &parsed_hdr);
 			if (ret) {
-				failed++;
-				odp_packet_free(pkt);
+				drop_tbl[failed++] = pkt;
 				continue;
 			}
 			if (new_pool != odp_packet_pool(pkt)) {
 				new_pkt = odp_packet_copy(pkt, new_pool);
 
-				odp_packet_free(pkt);
-
 				if (new_pkt == ODP_PACKET_INVALID) {
-					failed++;
+					drop_tbl[failed++] = pkt;
 					continue;
 				}
+				odp_packet_free(pkt);
 				pkt = new_pkt;
 			}
 		}
@@ -129,57 +224,153 @@ static int loopback_recv(pktio_entry_t *pktio_entry, int index ODP_UNUSED,
 
 		pkt_hdr->input = pktio_entry->s.handle;
 
-		if (pktio_cls_enabled(pktio_entry))
+		/* Transmitted packets carry the metadata of the sender. Only
+		 * the flow hash of the send side is kept. */
+		has_hash = loop->hash && pkt_hdr->p.input_flags.flow_hash;
+		hash = pkt_hdr->flow_hash;
+
+		if (cls_enabled)
 			copy_packet_cls_metadata(&parsed_hdr, pkt_hdr);
 		else
-			packet_parse_l2(&pkt_hdr->p, pkt_len);
+			packet_parse_reset(pkt_hdr);
+
+		if (has_hash) {
+			pkt_hdr->flow_hash = hash;
+			pkt_hdr->p.input_flags.flow_hash = 1;
+		}
 
 		packet_set_ts(pkt_hdr, ts);
 
-		pktio_entry->s.stats.in_octets += pkt_len;
+		octets += pkt_len;
 
 		pkts[num_rx++] = pkt;
 	}
 
-	pktio_entry->s.stats.in_errors += failed;
-	pktio_entry->s.stats.in_ucast_pkts += num_rx - failed;
+	rxq->octets += octets;
+	rxq->errors += failed;
+	rxq->ucast_pkts += num_rx;
 
-	odp_ticketlock_unlock(&pktio_entry->s.rxl);
+	if (!loop->lockless_rx)
+		odp_ticketlock_unlock(&rxq->lock);
+
+	if (odp_unlikely(failed))
+		odp_packet_free_multi(drop_tbl, failed);
+
+	if (!cls_enabled)
+		packet_parse_multi(pkts, num_rx, pktio_entry->s.parse_layer);
 
 	return num_rx;
 }
 
-static int loopback_send(pktio_entry_t *pktio_entry, int index ODP_UNUSED,
+/* Enqueue packets to pktin queue rings. Returns number of packets
+ * enqueued. */
+static inline int loop_enq(pkt_loop_t *loop, unsigned index,
+			   const odp_packet_t pkt_tbl[], int num)
+{
+	_ring_t *ring = loop->rxq[index].s.ring;
+	int ret;
+
+	/* Single pktout queue is either used by one thread or locked */
+	if (loop->num_out_queues == 1)
+		ret = _ring_sp_enqueue_burst(ring, (void * const *)pkt_tbl,
+					     num);
+	else
+		ret = _ring_mp_enqueue_burst(ring, (void * const *)pkt_tbl,
+					     num);
+
+	return ret & _RING_SZ_MASK;
+}
+
+/* Spread packets over pktin queues by flow hash, as NIC RSS would. Packets
+ * not fitting into a queue are dropped. */
+static int loop_enq_hash(pkt_loop_t *loop, const odp_packet_t pkt_tbl[],
+			 int len)
+{
+	odp_packet_t sorted[QUEUE_MULTI_MAX];
+	uint16_t offset[LOOP_MAX_QUEUES + 1];
+	uint8_t qidx[QUEUE_MULTI_MAX];
+	unsigned num_queues = loop->num_in_queues;
+	unsigned q;
+	int i, ret;
+	int dropped = 0;
+
+	/* Sent packets may carry any parser metadata, e.g. packets from
+	 * odp_packet_alloc() count as parsed. Parse the headers again. */
+	for (i = 0; i < len; i++)
+		packet_parse_reset(odp_packet_hdr(pkt_tbl[i]));
+
+	packet_parse_multi(pkt_tbl, len, LAYER_L4);
+	odp_packet_flow_hash_calc_multi(pkt_tbl, len, NULL, 0);
+
+	memset(offset, 0, sizeof(offset));
+
+	/* Non-IP packets have no hash and go to the first queue */
+	for (i = 0; i < len; i++) {
+		qidx[i] = 0;
+		if (odp_packet_has_flow_hash(pkt_tbl[i]))
+			qidx[i] = odp_packet_flow_hash(pkt_tbl[i]) %
+				  num_queues;
+		offset[qidx[i] + 1]++;
+	}
+
+	for (q = 0; q < num_queues; q++)
+		offset[q + 1] += offset[q];
+
+	/* Stable sort by queue keeps packet order within each flow */
+	for (i = 0; i < len; i++)
+		sorted[offset[qidx[i]]++] = pkt_tbl[i];
+
+	for (q = 0; q < num_queues; q++) {
+		int first = q ? offset[q - 1] : 0;
+		int num = offset[q] - first;
+
+		if (num == 0)
+			continue;
+
+		ret = loop_enq(loop, q, &sorted[first], num);
+		if (odp_unlikely(ret < num)) {
+			odp_packet_free_multi(&sorted[first + ret], num - ret);
+			dropped += num - ret;
+		}
+	}
+
+	return dropped;
+}
+
+static int loopback_send(pktio_entry_t *pktio_entry, int index,
 			 const odp_packet_t pkt_tbl[], int len)
 {
-	odp_buffer_hdr_t *hdr_tbl[QUEUE_MULTI_MAX];
-	queue_entry_t *qentry;
+	pkt_loop_t *loop = &pktio_entry->s.pkt_loop;
+	struct loop_queue_t *txq = &loop->txq[index].s;
 	int i;
 	int ret;
-	uint32_t bytes = 0;
+	int dropped = 0;
+	uint64_t bytes = 0;
 
 	if (odp_unlikely(len > QUEUE_MULTI_MAX))
 		len = QUEUE_MULTI_MAX;
 
-	for (i = 0; i < len; ++i) {
-		hdr_tbl[i] = odp_buf_to_hdr(_odp_packet_to_buffer(pkt_tbl[i]));
+	for (i = 0; i < len; ++i)
 		bytes += odp_packet_len(pkt_tbl[i]);
-	}
-
-	odp_ticketlock_lock(&pktio_entry->s.txl);
 
-	qentry = queue_to_qentry(pktio_entry->s.pkt_loop.loopq);
-	ret = queue_enq_multi(qentry, hdr_tbl, len, 0);
+	if (!loop->lockless_tx)
+		odp_ticketlock_lock(&txq->lock);
 
-	if (ret > 0) {
-		pktio_entry->s.stats.out_ucast_pkts += ret;
-		pktio_entry->s.stats.out_octets += bytes;
+	if (loop->hash) {
+		dropped = loop_enq_hash(loop, pkt_tbl, len);
+		ret = len;
 	} else {
-		ODP_DBG("queue enqueue failed %i\n", ret);
-		return -1;
+		ret = loop_enq(loop, 0, pkt_tbl, len);
+		for (i = ret; i < len; i++)
+			bytes -= odp_packet_len(pkt_tbl[i]);
 	}
 
-	odp_ticketlock_unlock(&pktio_entry->s.txl);
+	txq->ucast_pkts += ret;
+	txq->octets += bytes;
+	txq->errors += dropped;
+
+	if (!loop->lockless_tx)
+		odp_ticketlock_unlock(&txq->lock);
 
 	return ret;
 }
@@ -208,13 +399,18 @@ static int loopback_capability(pktio_entry_t *pktio_entry ODP_UNUSED,
 {
 	memset(capa, 0, sizeof(odp_pktio_capability_t));
 
-	capa->max_input_queues  = 1;
-	capa->max_output_queues = 1;
+	capa->max_input_queues  = LOOP_MAX_QUEUES;
+	capa->max_output_queues = LOOP_MAX_QUEUES;
 	capa->set_op.op.promisc_mode = 1;
 
 	odp_pktio_config_init(&capa->config);
 	capa->config.pktin.bit.ts_all = 1;
 	capa->config.pktin.bit.ts_ptp = 1;
+	capa->config.pktin.bit.tcp_coalesce = 1;
+	/* Time is read once per dequeued burst */
+	capa->config.pktin.bit.ts_batch = 1;
+	capa->config.pktout.bit.tcp_seg = 1;
+	capa->config.pktout.bit.udp_seg = 1;
 	return 0;
 }
 
@@ -233,18 +429,45 @@ static int loopback_promisc_mode_get(pktio_entry_t *pktio_entry)
 static int loopback_stats(pktio_entry_t *pktio_entry,
 			  odp_pktio_stats_t *stats)
 {
-	memcpy(stats, &pktio_entry->s.stats, sizeof(odp_pktio_stats_t));
+	pkt_loop_t *loop = &pktio_entry->s.pkt_loop;
+	int i;
+
+	memset(stats, 0, sizeof(odp_pktio_stats_t));
+
+	/* Counters are updated per queue without a common lock */
+	for (i = 0; i < LOOP_MAX_QUEUES; i++) {
+		stats->in_octets += loop->rxq[i].s.octets;
+		stats->in_ucast_pkts += loop->rxq[i].s.ucast_pkts;
+		stats->in_errors += loop->rxq[i].s.errors;
+		stats->out_octets += loop->txq[i].s.octets;
+		stats->out_ucast_pkts += loop->txq[i].s.ucast_pkts;
+		stats->out_discards += loop->txq[i].s.errors;
+	}
+
 	return 0;
 }
 
-static int loopback_stats_reset(pktio_entry_t *pktio_entry ODP_UNUSED)
+static int loopback_stats_reset(pktio_entry_t *pktio_entry)
 {
-	memset(&pktio_entry->s.stats, 0, sizeof(odp_pktio_stats_t));
+	pkt_loop_t *loop = &pktio_entry->s.pkt_loop;
+	int i;
+
+	for (i = 0; i < LOOP_MAX_QUEUES; i++) {
+		loop->rxq[i].s.octets = 0;
+		loop->rxq[i].s.ucast_pkts = 0;
+		loop->rxq[i].s.errors = 0;
+		loop->txq[i].s.octets = 0;
+		loop->txq[i].s.ucast_pkts = 0;
+		loop->txq[i].s.errors = 0;
+	}
+
 	return 0;
 }
 
 static int loop_init_global(void)
 {
+	/* Ring library is shared with ipc, which may not be built in */
+	_ring_tailq_init();
 	ODP_PRINT("PKTIO: initialized loop interface.\n");
 	return 0;
 }
@@ -272,6 +495,6 @@ const pktio_if_ops_t loopback_pktio_ops = {
 	.pktin_ts_res = NULL,
 	.pktin_ts_from_ns = NULL,
 	.config = NULL,
-	.input_queues_config = NULL,
-	.output_queues_config = NULL,
+	.input_queues_config = loopback_input_queues_config,
+	.output_queues_config = loopback_output_queues_config,
 };
@@ -0,0 +1,1714 @@
+/* Copyright (c) 2017, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+/**
+ * @file
+ *
+ * Shared memory packet interface (memif) pktio
+ *
+ * Interface name is "memif:" followed by optional ':' separated options:
+ *   socket=<path>	control socket, default MEMIF_DEFAULT_SOCKET. One
+ *			master interface listens on a socket.
+ *   role=master|slave	role of the interface, default master
+ *   id=<n>		interface id, must match on both ends
+ *   secret=<string>	secret the slave presents to the master
+ *   rsize=<n>		log2 of ring size, default 10 (slave)
+ *   bsize=<n>		ring buffer size, default 2048 (slave)
+ *   irq=0		odp_pktin_recv_tmo() polls instead of sleeping on
+ *			the interrupt eventfd of the rings
+ *
+ * The master listens on a unix socket and the slave connects to it, from the
+ * same or from another process. The slave owns the shared memory: a single
+ * memfd region holds the descriptor rings and their buffers. Its file
+ * descriptor, and one interrupt eventfd per ring, are passed to the master
+ * with SCM_RIGHTS. Slave to master (S2M) rings carry the output of the slave,
+ * master to slave (M2S) rings its input. The slave posts empty buffers on M2S
+ * rings, which the master fills. Descriptors are handed over in place, larger
+ * frames are chained over several buffers.
+ *
+ * Frames are copied once on each side, between ODP packets and ring buffers,
+ * as ODP packets come from ODP pools. The slave asks for as many rings as it
+ * has pktin and pktout queues, and reconnects at start when the queue
+ * configuration has changed. Pktin queue i receives from the rings of index i
+ * modulo the number of pktin queues, pktout queue i sends to the ring of index
+ * i modulo the number of rings.
+ *
+ * Control messages are processed on open, start and link status reads, and
+ * periodically by recv and send. Link of the master is up while it listens,
+ * link of the slave while it is connected. Frames sent without a connection
+ * are dropped. A slave that lost its master retries every
+ * MEMIF_CONNECT_RETRY_NS.
+ */
+
+#include <odp_posix_extensions.h>
+
+#include <odp_packet_io_internal.h>
+#include <odp_packet_memif.h>
+#include <odp_packet_internal.h>
+#include <odp_debug_internal.h>
+#include <odp_classification_internal.h>
+#include <odp_align_internal.h>
+
+#include <odp/api/spinlock.h>
+#include <odp/api/sync.h>
+#include <odp/api/time.h>
+
+#include <errno.h>
+#include <inttypes.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <sys/un.h>
+
+#ifndef MFD_CLOEXEC
+#define MFD_CLOEXEC 0x0001U
+#endif
+
+/** Control socket used when none is given */
+#define MEMIF_DEFAULT_SOCKET "/run/odp_memif.sock"
+
+/** Default and largest log2 of ring size */
+#define MEMIF_DEFAULT_LOG2_RING_SIZE 10
+#define MEMIF_MAX_LOG2_RING_SIZE 14
+
+/** Default, smallest and largest ring buffer size */
+#define MEMIF_DEFAULT_BUFFER_SIZE 2048
+#define MEMIF_MIN_BUFFER_SIZE 256
+#define MEMIF_MAX_BUFFER_SIZE 65536
+
+/** Largest frame, chained over buffers when needed */
+#define MEMIF_MTU 9216
+
+/** Most descriptors in a chain */
+#define MEMIF_MAX_CHAIN 64
+
+/** Slave connection retry interval */
+#define MEMIF_CONNECT_RETRY_NS (100 * ODP_TIME_MSEC_IN_NS)
+
+/** Empty recv calls between control message polls */
+#define MEMIF_CTRL_POLL 256
+
+/** Longest sleep on ring interrupts, before checking the connection */
+#define MEMIF_IRQ_SLEEP_NS (10 * ODP_TIME_MSEC_IN_NS)
+
+/** Sleep between polls when not sleeping on ring interrupts */
+#define MEMIF_POLL_SLEEP_NS 1000
+
+/** Connection states */
+#define MEMIF_STATE_DISCONNECTED 0
+#define MEMIF_STATE_CONNECTING   1
+#define MEMIF_STATE_CONNECTED    2
+
+/** Data of a descriptor */
+typedef struct {
+	uint8_t *data;
+	uint32_t len;
+} memif_seg_t;
+
+static int disable_pktio; /** !0 this pktio disabled, 0 enabled */
+
+/* Open memif interfaces. Control messages of all of them are processed
+ * together, so that a master and a slave in the same process connect. */
+static odp_spinlock_t memif_lock;
+static pktio_entry_t *memif_tbl[ODP_CONFIG_PKTIO_ENTRIES];
+
+static inline uint16_t ring_load_acquire(uint16_t *idx)
+{
+	return __atomic_load_n(idx, __ATOMIC_ACQUIRE);
+}
+
+static inline void ring_store_release(uint16_t *idx, uint16_t val)
+{
+	__atomic_store_n(idx, val, __ATOMIC_RELEASE);
+}
+
+static inline unsigned memif_num_rx_rings(pkt_memif_t *memif)
+{
+	return memif->is_master ? memif->num_s2m : memif->num_m2s;
+}
+
+static inline unsigned memif_num_tx_rings(pkt_memif_t *memif)
+{
+	return memif->is_master ? memif->num_m2s : memif->num_s2m;
+}
+
+static inline int memif_connected(pkt_memif_t *memif)
+{
+	return odp_atomic_load_acq_u32(&memif->state) == MEMIF_STATE_CONNECTED;
+}
+
+static void memif_app_name(uint8_t name[_ODP_MEMIF_NAME_LEN])
+{
+	snprintf((char *)name, _ODP_MEMIF_NAME_LEN, "odp-%d", (int)getpid());
+}
+
+/* Interface name in a message, not terminated when it fills the field */
+static void memif_if_name(uint8_t name[_ODP_MEMIF_NAME_LEN], const char *str)
+{
+	memcpy(name, str, strnlen(str, _ODP_MEMIF_NAME_LEN));
+}
+
+static int memif_msg_send(int sock, _odp_memif_msg_t *msg, int fd)
+{
+	char ctl[CMSG_SPACE(sizeof(int))];
+	struct msghdr mh;
+	struct iovec iov;
+	ssize_t ret;
+
+	memset(&mh, 0, sizeof(mh));
+	iov.iov_base = msg;
+	iov.iov_len = sizeof(*msg);
+	mh.msg_iov = &iov;
+	mh.msg_iovlen = 1;
+
+	if (fd >= 0) {
+		struct cmsghdr *cmsg;
+
+		memset(ctl, 0, sizeof(ctl));
+		mh.msg_control = ctl;
+		mh.msg_controllen = sizeof(ctl);
+		cmsg = CMSG_FIRSTHDR(&mh);
+		cmsg->cmsg_level = SOL_SOCKET;
+		cmsg->cmsg_type = SCM_RIGHTS;
+		cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+		memcpy(CMSG_DATA(cmsg), &fd, sizeof(int));
+	}
+
+	do {
+		ret = sendmsg(sock, &mh, MSG_NOSIGNAL);
+	} while (ret < 0 && errno == EINTR);
+
+	if (ret != (ssize_t)sizeof(*msg)) {
+		ODP_DBG("memif: sendmsg(): %s\n", strerror(errno));
+		return -1;
+	}
+
+	return 0;
+}
+
+static int memif_msg_send_type(int sock, uint16_t type)
+{
+	_odp_memif_msg_t msg;
+
+	memset(&msg, 0, sizeof(msg));
+	msg.type = type;
+
+	return memif_msg_send(sock, &msg, -1);
+}
+
+/**
+ * Receive a control message
+ *
+ * A file descriptor passed with the message is stored to 'fd', otherwise -1.
+ * Returns 1 when a message was received, 0 when there is none and -1 when
+ * the connection is down.
+ */
+static int memif_msg_recv(int sock, _odp_memif_msg_t *msg, int *fd)
+{
+	char ctl[CMSG_SPACE(sizeof(int))];
+	struct cmsghdr *cmsg;
+	struct msghdr mh;
+	struct iovec iov;
+	ssize_t ret;
+
+	*fd = -1;
+
+	memset(&mh, 0, sizeof(mh));
+	iov.iov_base = msg;
+	iov.iov_len = sizeof(*msg);
+	mh.msg_iov = &iov;
+	mh.msg_iovlen = 1;
+	mh.msg_control = ctl;
+	mh.msg_controllen = sizeof(ctl);
+
+	do {
+		ret = recvmsg(sock, &mh, MSG_CMSG_CLOEXEC);
+	} while (ret < 0 && errno == EINTR);
+
+	if (ret < 0)
+		return (errno == EAGAIN || errno == EWOULDBLOCK) ? 0 : -1;
+
+	for (cmsg = CMSG_FIRSTHDR(&mh); cmsg != NULL;
+	     cmsg = CMSG_NXTHDR(&mh, cmsg)) {
+		if (cmsg->cmsg_level == SOL_SOCKET &&
+		    cmsg->cmsg_type == SCM_RIGHTS &&
+		    cmsg->cmsg_len == CMSG_LEN(sizeof(int)))
+			memcpy(fd, CMSG_DATA(cmsg), sizeof(int));
+	}
+
+	if (ret != (ssize_t)sizeof(*msg)) {
+		if (ret)
+			ODP_ERR("memif: bad message length %zd\n", ret);
+		if (*fd >= 0)
+			close(*fd);
+		*fd = -1;
+		return -1;
+	}
+
+	return 1;
+}
+
+static void memif_ring_reset(struct memif_ring_t *mr)
+{
+	if (mr->int_fd >= 0)
+		close(mr->int_fd);
+
+	mr->ring = NULL;
+	mr->buf = NULL;
+	mr->mask = 0;
+	mr->last = 0;
+	mr->int_fd = -1;
+}
+
+/**
+ * Take the connection down
+ *
+ * A disconnect message is sent to the peer when 'reason' is not NULL. Data
+ * path calls on the rings are waited for before the shared memory is
+ * unmapped. Caller holds memif_lock.
+ */
+static void memif_disconnect(pktio_entry_t *pktio_entry, const char *reason)
+{
+	pkt_memif_t *memif = &pktio_entry->s.pkt_memif;
+	unsigned i;
+
+	if (memif->ctrl_fd >= 0 && reason != NULL) {
+		_odp_memif_msg_t msg;
+
+		memset(&msg, 0, sizeof(msg));
+		msg.type = _ODP_MEMIF_MSG_DISCONNECT;
+		snprintf((char *)msg.disconnect.string,
+			 sizeof(msg.disconnect.string), "%s", reason);
+		memif_msg_send(memif->ctrl_fd, &msg, -1);
+	}
+
+	if (memif_connected(memif))
+		ODP_DBG("%s: disconnected: %s\n", pktio_entry->s.name,
+			reason != NULL ? reason : "by peer");
+
+	odp_atomic_store_rel_u32(&memif->state, MEMIF_STATE_DISCONNECTED);
+
+	for (i = 0; i < MEMIF_MAX_QUEUES; i++) {
+		odp_ticketlock_lock(&memif->rxq[i].s.lock);
+		odp_ticketlock_unlock(&memif->rxq[i].s.lock);
+		odp_ticketlock_lock(&memif->txq[i].s.lock);
+		odp_ticketlock_unlock(&memif->txq[i].s.lock);
+	}
+
+	if (memif->ctrl_fd >= 0)
+		close(memif->ctrl_fd);
+	memif->ctrl_fd = -1;
+
+	for (i = 0; i < MEMIF_MAX_QUEUES; i++) {
+		memif_ring_reset(&memif->rx_ring[i].s);
+		memif_ring_reset(&memif->tx_ring[i].s);
+	}
+
+	for (i = 0; i < memif->num_region; i++) {
+		munmap(memif->region[i].addr, memif->region[i].size);
+		close(memif->region[i].fd);
+	}
+
+	memif->num_region = 0;
+	memif->num_s2m = 0;
+	memif->num_m2s = 0;
+	memif->step = 0;
+	memif->next_connect =
+		odp_time_sum(odp_time_local(),
+			     odp_time_local_from_ns(MEMIF_CONNECT_RETRY_NS));
+}
+
+/* Number of rings the slave asks for in each direction */
+static void memif_slave_rings(pktio_entry_t *pktio_entry, unsigned *num_s2m,
+			      unsigned *num_m2s)
+{
+	pkt_memif_t *memif = &pktio_entry->s.pkt_memif;
+	unsigned num_out = pktio_entry->s.num_out_queue;
+	unsigned num_in = pktio_entry->s.num_in_queue;
+
+	if (num_out == 0)
+		num_out = 1;
+	if (num_in == 0)
+		num_in = 1;
+
+	*num_s2m = num_out < memif->peer_max_s2m + 1u ?
+		   num_out : memif->peer_max_s2m + 1u;
+	*num_m2s = num_in < memif->peer_max_m2s + 1u ?
+		   num_in : memif->peer_max_m2s + 1u;
+
+	if (*num_s2m > MEMIF_MAX_QUEUES)
+		*num_s2m = MEMIF_MAX_QUEUES;
+	if (*num_m2s > MEMIF_MAX_QUEUES)
+		*num_m2s = MEMIF_MAX_QUEUES;
+}
+
+/* Create the shared region, rings and interrupt eventfds of the slave */
+static int memif_slave_region_create(pkt_memif_t *memif)
+{
+	unsigned num_rings = memif->num_s2m + memif->num_m2s;
+	uint32_t ring_size = 1 << memif->log2_ring_size;
+	uint64_t ring_len = sizeof(_odp_memif_ring_t) +
+			    ring_size * sizeof(_odp_memif_desc_t);
+	uint64_t buf_offset = ODP_PAGE_SIZE_ROUNDUP(num_rings * ring_len);
+	uint64_t size = buf_offset +
+			(uint64_t)num_rings * ring_size * memif->buffer_size;
+	uint8_t *addr;
+	unsigned r, i;
+	int fd;
+
+	/* Descriptors address buffers with 32 bit offsets */
+	if (size > UINT32_MAX) {
+		ODP_ERR("memif: region of %" PRIu64 " bytes too large\n", size);
+		return -1;
+	}
+
+	fd = syscall(__NR_memfd_create, "odp_memif", MFD_CLOEXEC);
+	if (fd < 0) {
+		ODP_ERR("memfd_create(): %s\n", strerror(errno));
+		return -1;
+	}
+
+	if (ftruncate(fd, size)) {
+		ODP_ERR("ftruncate(): %s\n", strerror(errno));
+		close(fd);
+		return -1;
+	}
+
+	addr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	if (addr == MAP_FAILED) {
+		ODP_ERR("mmap(): %s\n", strerror(errno));
+		close(fd);
+		return -1;
+	}
+
+	memif->region[0].addr = addr;
+	memif->region[0].size = size;
+	memif->region[0].fd = fd;
+	memif->num_region = 1;
+
+	/* S2M rings first, then M2S rings. Buffers of ring r start at
+	 * buf_offset + r * ring_size * buffer_size. */
+	for (r = 0; r < num_rings; r++) {
+		_odp_memif_ring_t *ring = (void *)(addr + r * ring_len);
+		uint8_t *buf = addr + buf_offset +
+			       (uint64_t)r * ring_size * memif->buffer_size;
+		int s2m = r < memif->num_s2m;
+		struct memif_ring_t *mr = s2m ? &memif->tx_ring[r].s :
+					  &memif->rx_ring[r - memif->num_s2m].s;
+
+		ring->cookie = _ODP_MEMIF_COOKIE;
+		ring->flags = _ODP_MEMIF_RING_FLAG_MASK_INT;
+		ring->tail = 0;
+
+		for (i = 0; i < ring_size; i++) {
+			ring->desc[i].flags = 0;
+			ring->desc[i].region = 0;
+			ring->desc[i].length = memif->buffer_size;
+			ring->desc[i].offset = buf + i * memif->buffer_size -
+					       addr;
+			ring->desc[i].metadata = 0;
+		}
+
+		/* All input buffers are posted to the master */
+		ring->head = s2m ? 0 : ring_size;
+
+		mr->ring = ring;
+		mr->buf = buf;
+		mr->mask = ring_size - 1;
+		mr->last = 0;
+		mr->int_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+		if (mr->int_fd < 0) {
+			ODP_ERR("eventfd(): %s\n", strerror(errno));
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+/* Send the next handshake message of the slave: init, add region, add ring
+ * for each ring, and connect. Each is acked by the master. */
+static int memif_slave_send_next(pktio_entry_t *pktio_entry)
+{
+	pkt_memif_t *memif = &pktio_entry->s.pkt_memif;
+	unsigned num_rings = memif->num_s2m + memif->num_m2s;
+	unsigned step = memif->step++;
+	_odp_memif_msg_t msg;
+	int fd = -1;
+
+	memset(&msg, 0, sizeof(msg));
+
+	if (step == 0) {
+		msg.type = _ODP_MEMIF_MSG_INIT;
+		msg.init.version = _ODP_MEMIF_VERSION;
+		msg.init.id = memif->id;
+		msg.init.mode = _ODP_MEMIF_MODE_ETHERNET;
+		memcpy(msg.init.secret, memif->secret, _ODP_MEMIF_SECRET_LEN);
+		memif_app_name(msg.init.name);
+	} else if (step == 1) {
+		msg.type = _ODP_MEMIF_MSG_ADD_REGION;
+		msg.add_region.index = 0;
+		msg.add_region.size = memif->region[0].size;
+		fd = memif->region[0].fd;
+	} else if (step < 2 + num_rings) {
+		unsigned r = step - 2;
+		int s2m = r < memif->num_s2m;
+		struct memif_ring_t *mr = s2m ? &memif->tx_ring[r].s :
+					  &memif->rx_ring[r - memif->num_s2m].s;
+
+		msg.type = _ODP_MEMIF_MSG_ADD_RING;
+		msg.add_ring.flags = s2m ? _ODP_MEMIF_RING_FLAG_S2M : 0;
+		msg.add_ring.index = s2m ? r : r - memif->num_s2m;
+		msg.add_ring.region = 0;
+		msg.add_ring.offset = (uint8_t *)mr->ring -
+				      memif->region[0].addr;
+		msg.add_ring.log2_ring_size = memif->log2_ring_size;
+		msg.add_ring.private_hdr_size = 0;
+		fd = mr->int_fd;
+	} else if (step == 2 + num_rings) {
+		msg.type = _ODP_MEMIF_MSG_CONNECT;
+		memif_if_name(msg.connect.if_name, pktio_entry->s.name);
+	} else {
+		return -1;
+	}
+
+	return memif_msg_send(memif->ctrl_fd, &msg, fd);
+}
+
+static int memif_slave_msg(pktio_entry_t *pktio_entry,
+			   const _odp_memif_msg_t *msg, const char **reason)
+{
+	pkt_memif_t *memif = &pktio_entry->s.pkt_memif;
+	unsigned num_rings = memif->num_s2m + memif->num_m2s;
+
+	switch (msg->type) {
+	case _ODP_MEMIF_MSG_HELLO:
+		if (memif->step != 0 || memif->num_region) {
+			*reason = "unexpected hello";
+			return -1;
+		}
+		if (msg->hello.min_version > _ODP_MEMIF_VERSION ||
+		    msg->hello.max_version < _ODP_MEMIF_VERSION) {
+			*reason = "unsupported version";
+			return -1;
+		}
+		memif->peer_max_s2m = msg->hello.max_s2m_ring;
+		memif->peer_max_m2s = msg->hello.max_m2s_ring;
+		if (memif->log2_ring_size > msg->hello.max_log2_ring_size)
+			memif->log2_ring_size = msg->hello.max_log2_ring_size;
+		memcpy(memif->peer_name, msg->hello.name, _ODP_MEMIF_NAME_LEN);
+
+		memif_slave_rings(pktio_entry, &memif->num_s2m,
+				  &memif->num_m2s);
+		if (memif_slave_region_create(memif)) {
+			*reason = "shared memory allocation failed";
+			return -1;
+		}
+		return memif_slave_send_next(pktio_entry);
+
+	case _ODP_MEMIF_MSG_ACK:
+		if (memif->step == 0 || memif->step > 2 + num_rings) {
+			*reason = "unexpected ack";
+			return -1;
+		}
+		return memif_slave_send_next(pktio_entry);
+
+	case _ODP_MEMIF_MSG_CONNECTED:
+		if (memif->step != 3 + num_rings) {
+			*reason = "unexpected connected";
+			return -1;
+		}
+		odp_atomic_store_rel_u32(&memif->state, MEMIF_STATE_CONNECTED);
+		ODP_DBG("%s: connected to %s, %u s2m %u m2s rings\n",
+			pktio_entry->s.name, memif->peer_name, memif->num_s2m,
+			memif->num_m2s);
+		return 0;
+
+	case _ODP_MEMIF_MSG_DISCONNECT:
+		ODP_DBG("%s: disconnect: %.*s\n", pktio_entry->s.name,
+			_ODP_MEMIF_ERR_LEN,
+			(const char *)msg->disconnect.string);
+		return -1;
+
+	default:
+		*reason = "unexpected message";
+		return -1;
+	}
+}
+
+static int memif_master_add_ring(pkt_memif_t *memif,
+				 const _odp_memif_msg_add_ring_t *add_ring,
+				 int *fd, const char **reason)
+{
+	struct memif_ring_t *mr;
+	uint64_t ring_len;
+	uint8_t *addr;
+
+	if (add_ring->index >= MEMIF_MAX_QUEUES ||
+	    add_ring->region >= memif->num_region ||
+	    add_ring->log2_ring_size > MEMIF_MAX_LOG2_RING_SIZE ||
+	    *fd < 0) {
+		*reason = "bad ring";
+		return -1;
+	}
+
+	ring_len = sizeof(_odp_memif_ring_t) +
+		   (1 << add_ring->log2_ring_size) * sizeof(_odp_memif_desc_t);
+	if (add_ring->offset + ring_len >
+	    memif->region[add_ring->region].size) {
+		*reason = "ring out of region";
+		return -1;
+	}
+
+	if (add_ring->flags & _ODP_MEMIF_RING_FLAG_S2M)
+		mr = &memif->rx_ring[add_ring->index].s;
+	else
+		mr = &memif->tx_ring[add_ring->index].s;
+
+	if (mr->ring != NULL) {
+		*reason = "ring added twice";
+		return -1;
+	}
+
+	addr = memif->region[add_ring->region].addr + add_ring->offset;
+	mr->ring = (_odp_memif_ring_t *)(void *)addr;
+	mr->mask = (1 << add_ring->log2_ring_size) - 1;
+	mr->int_fd = *fd;
+	*fd = -1;
+
+	if (add_ring->flags & _ODP_MEMIF_RING_FLAG_S2M) {
+		if (add_ring->index >= memif->num_s2m)
+			memif->num_s2m = add_ring->index + 1;
+	} else {
+		if (add_ring->index >= memif->num_m2s)
+			memif->num_m2s = add_ring->index + 1;
+	}
+
+	return 0;
+}
+
+/* Check that the rings of the slave are complete before connecting */
+static int memif_master_rings_ready(pkt_memif_t *memif)
+{
+	unsigned i;
+
+	if (memif->num_s2m == 0 || memif->num_m2s == 0)
+		return 0;
+
+	for (i = 0; i < memif->num_s2m; i++) {
+		struct memif_ring_t *mr = &memif->rx_ring[i].s;
+
+		if (mr->ring == NULL || mr->ring->cookie != _ODP_MEMIF_COOKIE)
+			return 0;
+		mr->last = mr->ring->tail;
+	}
+
+	for (i = 0; i < memif->num_m2s; i++) {
+		struct memif_ring_t *mr = &memif->tx_ring[i].s;
+
+		if (mr->ring == NULL || mr->ring->cookie != _ODP_MEMIF_COOKIE)
+			return 0;
+	}
+
+	return 1;
+}
+
+static int memif_master_msg(pktio_entry_t *pktio_entry,
+			    const _odp_memif_msg_t *msg, int *fd,
+			    const char **reason)
+{
+	pkt_memif_t *memif = &pktio_entry->s.pkt_memif;
+	_odp_memif_msg_t reply;
+	memif_region_t *region;
+	void *addr;
+
+	switch (msg->type) {
+	case _ODP_MEMIF_MSG_INIT:
+		if (memif->step != 0) {
+			*reason = "unexpected init";
+			return -1;
+		}
+		if ((msg->init.version >> 8) != _ODP_MEMIF_VERSION_MAJOR) {
+			*reason = "unsupported version";
+			return -1;
+		}
+		if (msg->init.id != memif->id) {
+			*reason = "unknown interface id";
+			return -1;
+		}
+		if (msg->init.mode != _ODP_MEMIF_MODE_ETHERNET) {
+			*reason = "unsupported mode";
+			return -1;
+		}
+		if (memcmp(msg->init.secret, memif->secret,
+			   _ODP_MEMIF_SECRET_LEN)) {
+			*reason = "incorrect secret";
+			return -1;
+		}
+		memcpy(memif->peer_name, msg->init.name, _ODP_MEMIF_NAME_LEN);
+		memif->step = 1;
+		return memif_msg_send_type(memif->ctrl_fd, _ODP_MEMIF_MSG_ACK);
+
+	case _ODP_MEMIF_MSG_ADD_REGION:
+		if (memif->step == 0 ||
+		    msg->add_region.index != memif->num_region ||
+		    memif->num_region == MEMIF_MAX_REGIONS || *fd < 0 ||
+		    msg->add_region.size == 0) {
+			*reason = "bad region";
+			return -1;
+		}
+		addr = mmap(NULL, msg->add_region.size, PROT_READ | PROT_WRITE,
+			    MAP_SHARED, *fd, 0);
+		if (addr == MAP_FAILED) {
+			*reason = "region mmap failed";
+			return -1;
+		}
+		region = &memif->region[memif->num_region++];
+		region->addr = addr;
+		region->size = msg->add_region.size;
+		region->fd = *fd;
+		*fd = -1;
+		return memif_msg_send_type(memif->ctrl_fd, _ODP_MEMIF_MSG_ACK);
+
+	case _ODP_MEMIF_MSG_ADD_RING:
+		if (memif->step == 0 ||
+		    memif_master_add_ring(memif, &msg->add_ring, fd, reason))
+			return -1;
+		return memif_msg_send_type(memif->ctrl_fd, _ODP_MEMIF_MSG_ACK);
+
+	case _ODP_MEMIF_MSG_CONNECT:
+		if (memif->step == 0 || !memif_master_rings_ready(memif)) {
+			*reason = "rings incomplete";
+			return -1;
+		}
+		memset(&reply, 0, sizeof(reply));
+		reply.type = _ODP_MEMIF_MSG_CONNECTED;
+		memif_if_name(reply.connected.if_name, pktio_entry->s.name);
+		if (memif_msg_send(memif->ctrl_fd, &reply, -1))
+			return -1;
+		odp_atomic_store_rel_u32(&memif->state, MEMIF_STATE_CONNECTED);
+		ODP_DBG("%s: connected to %s, %u s2m %u m2s rings\n",
+			pktio_entry->s.name, memif->peer_name, memif->num_s2m,
+			memif->num_m2s);
+		return 0;
+
+	case _ODP_MEMIF_MSG_DISCONNECT:
+		ODP_DBG("%s: disconnect: %.*s\n", pktio_entry->s.name,
+			_ODP_MEMIF_ERR_LEN,
+			(const char *)msg->disconnect.string);
+		return -1;
+
+	default:
+		*reason = "unexpected message";
+		return -1;
+	}
+}
+
+/* Accept a slave connection and greet it. Returns 1 when a connection was
+ * accepted. */
+static int memif_master_accept(pktio_entry_t *pktio_entry)
+{
+	pkt_memif_t *memif = &pktio_entry->s.pkt_memif;
+	_odp_memif_msg_t msg;
+	int fd;
+
+	fd = accept4(memif->listen_fd, NULL, NULL,
+		     SOCK_NONBLOCK | SOCK_CLOEXEC);
+	if (fd < 0)
+		return 0;
+
+	if (memif->ctrl_fd >= 0) {
+		memset(&msg, 0, sizeof(msg));
+		msg.type = _ODP_MEMIF_MSG_DISCONNECT;
+		snprintf((char *)msg.disconnect.string,
+			 sizeof(msg.disconnect.string), "%s",
+			 "interface already connected");
+		memif_msg_send(fd, &msg, -1);
+		close(fd);
+		return 1;
+	}
+
+	memif->ctrl_fd = fd;
+	memif->step = 0;
+	odp_atomic_store_u32(&memif->state, MEMIF_STATE_CONNECTING);
+
+	memset(&msg, 0, sizeof(msg));
+	msg.type = _ODP_MEMIF_MSG_HELLO;
+	memif_app_name(msg.hello.name);
+	msg.hello.min_version = _ODP_MEMIF_VERSION;
+	msg.hello.max_version = _ODP_MEMIF_VERSION;
+	msg.hello.max_region = MEMIF_MAX_REGIONS - 1;
+	msg.hello.max_m2s_ring = MEMIF_MAX_QUEUES - 1;
+	msg.hello.max_s2m_ring = MEMIF_MAX_QUEUES - 1;
+	msg.hello.max_log2_ring_size = MEMIF_MAX_LOG2_RING_SIZE;
+
+	if (memif_msg_send(fd, &msg, -1))
+		memif_disconnect(pktio_entry, NULL);
+
+	return 1;
+}
+
+/* Connect to the master when the retry interval has passed. Returns 1 when
+ * connected. */
+static int memif_slave_connect(pktio_entry_t *pktio_entry)
+{
+	pkt_memif_t *memif = &pktio_entry->s.pkt_memif;
+	struct sockaddr_un addr;
+	odp_time_t now = odp_time_local();
+	int fd;
+
+	if (odp_time_cmp(memif->next_connect, now) > 0)
+		return 0;
+
+	memif->next_connect = odp_time_sum(now, odp_time_local_from_ns(
+						   MEMIF_CONNECT_RETRY_NS));
+
+	fd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+	if (fd < 0) {
+		ODP_ERR("socket(): %s\n", strerror(errno));
+		return 0;
+	}
+
+	memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	memcpy(addr.sun_path, memif->socket, sizeof(addr.sun_path));
+
+	if (connect(fd, (struct sockaddr *)&addr, sizeof(addr))) {
+		close(fd);
+		return 0;
+	}
+
+	memif->ctrl_fd = fd;
+	memif->step = 0;
+	odp_atomic_store_u32(&memif->state, MEMIF_STATE_CONNECTING);
+
+	return 1;
+}
+
+/* Process control events of an interface. Returns nonzero when something
+ * progressed. Caller holds memif_lock. */
+static int memif_ctrl_poll(pktio_entry_t *pktio_entry)
+{
+	pkt_memif_t *memif = &pktio_entry->s.pkt_memif;
+	_odp_memif_msg_t msg;
+	const char *reason;
+	int progress;
+	int fd, ret;
+
+	if (memif->is_master)
+		progress = memif_master_accept(pktio_entry);
+	else if (memif->ctrl_fd < 0)
+		progress = memif_slave_connect(pktio_entry);
+	else
+		progress = 0;
+
+	while (memif->ctrl_fd >= 0) {
+		ret = memif_msg_recv(memif->ctrl_fd, &msg, &fd);
+		if (ret == 0)
+			break;
+
+		progress = 1;
+		reason = NULL;
+
+		if (ret > 0) {
+			if (memif->is_master)
+				ret = memif_master_msg(pktio_entry, &msg, &fd,
+						       &reason);
+			else
+				ret = memif_slave_msg(pktio_entry, &msg,
+						      &reason);
+		}
+
+		if (fd >= 0)
+			close(fd);
+
+		if (ret < 0) {
+			if (reason != NULL)
+				ODP_ERR("%s: %s\n", pktio_entry->s.name,
+					reason);
+			memif_disconnect(pktio_entry, reason);
+		}
+	}
+
+	return progress;
+}
+
+/* Process control events of all interfaces until none is left. Without
+ * 'wait' nothing is done when another thread is already at it. */
+static void memif_ctrl_poll_all(int wait)
+{
+	int progress = 1;
+	int i;
+
+	if (wait)
+		odp_spinlock_lock(&memif_lock);
+	else if (!odp_spinlock_trylock(&memif_lock))
+		return;
+
+	while (progress) {
+		progress = 0;
+
+		for (i = 0; i < ODP_CONFIG_PKTIO_ENTRIES; i++) {
+			if (memif_tbl[i] != NULL)
+				progress |= memif_ctrl_poll(memif_tbl[i]);
+		}
+	}
+
+	odp_spinlock_unlock(&memif_lock);
+}
+
+/* Returns 1 when the path is bound to a socket nobody listens on */
+static int memif_socket_stale(const struct sockaddr_un *addr)
+{
+	int fd, stale;
+
+	fd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+	if (fd < 0)
+		return 0;
+
+	stale = connect(fd, (const struct sockaddr *)addr, sizeof(*addr)) &&
+		errno == ECONNREFUSED;
+	close(fd);
+
+	return stale;
+}
+
+static int memif_listen(pkt_memif_t *memif)
+{
+	struct sockaddr_un addr;
+	int fd;
+
+	memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	memcpy(addr.sun_path, memif->socket, sizeof(addr.sun_path));
+
+	fd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+	if (fd < 0) {
+		ODP_ERR("socket(): %s\n", strerror(errno));
+		return -1;
+	}
+
+	if (bind(fd, (struct sockaddr *)&addr, sizeof(addr))) {
+		/* Socket file left behind by a process that is gone */
+		if (errno != EADDRINUSE || !memif_socket_stale(&addr) ||
+		    unlink(memif->socket) ||
+		    bind(fd, (struct sockaddr *)&addr, sizeof(addr))) {
+			ODP_ERR("memif: bind(%s): %s\n", memif->socket,
+				strerror(errno));
+			close(fd);
+			return -1;
+		}
+	}
+
+	if (listen(fd, 1)) {
+		ODP_ERR("listen(): %s\n", strerror(errno));
+		close(fd);
+		unlink(memif->socket);
+		return -1;
+	}
+
+	memif->listen_fd = fd;
+
+	return 0;
+}
+
+static int memif_parse_opts(pkt_memif_t *memif, const char *devname)
+{
+	char buf[PKTIO_NAME_LEN];
+	char *tok, *save = NULL;
+
+	snprintf(buf, sizeof(buf), "%s", devname);
+
+	for (tok = strtok_r(buf, ":", &save); tok != NULL;
+	     tok = strtok_r(NULL, ":", &save)) {
+		if (strncmp(tok, "socket=", 7) == 0) {
+			if (strlen(tok + 7) == 0 ||
+			    strlen(tok + 7) >= sizeof(memif->socket)) {
+				ODP_ERR("memif: bad socket path %s\n", tok + 7);
+				return -1;
+			}
+			strcpy(memif->socket, tok + 7);
+		} else if (strcmp(tok, "role=master") == 0) {
+			memif->is_master = 1;
+		} else if (strcmp(tok, "role=slave") == 0) {
+			memif->is_master = 0;
+		} else if (strncmp(tok, "id=", 3) == 0) {
+			memif->id = strtoul(tok + 3, NULL, 0);
+		} else if (strncmp(tok, "secret=", 7) == 0) {
+			if (strlen(tok + 7) > _ODP_MEMIF_SECRET_LEN) {
+				ODP_ERR("memif: secret too long\n");
+				return -1;
+			}
+			memcpy(memif->secret, tok + 7, strlen(tok + 7));
+		} else if (strncmp(tok, "rsize=", 6) == 0) {
+			memif->log2_ring_size = atoi(tok + 6);
+		} else if (strncmp(tok, "bsize=", 6) == 0) {
+			memif->buffer_size = atoi(tok + 6);
+		} else if (strncmp(tok, "irq=", 4) == 0) {
+			memif->irq = atoi(tok + 4) != 0;
+		} else {
+			ODP_ERR("memif: unknown option %s\n", tok);
+			return -1;
+		}
+	}
+
+	if (memif->log2_ring_size < 1 ||
+	    memif->log2_ring_size > MEMIF_MAX_LOG2_RING_SIZE) {
+		ODP_ERR("memif: rsize must be 1 to %d\n",
+			MEMIF_MAX_LOG2_RING_SIZE);
+		return -1;
+	}
+
+	if (memif->buffer_size < MEMIF_MIN_BUFFER_SIZE ||
+	    memif->buffer_size > MEMIF_MAX_BUFFER_SIZE) {
+		ODP_ERR("memif: bsize must be %d to %d\n",
+			MEMIF_MIN_BUFFER_SIZE, MEMIF_MAX_BUFFER_SIZE);
+		return -1;
+	}
+
+	return 0;
+}
+
+static int memif_open(odp_pktio_t id ODP_UNUSED, pktio_entry_t *pktio_entry,
+		      const char *devname, odp_pool_t pool)
+{
+	pkt_memif_t *memif = &pktio_entry->s.pkt_memif;
+	pid_t pid = getpid();
+	int i;
+
+	if (disable_pktio)
+		return -1;
+
+	if (strncmp(devname, "memif:", 6) != 0)
+		return -1;
+
+	if (pool == ODP_POOL_INVALID)
+		return -1;
+
+	memset(memif, 0, sizeof(*memif));
+	memif->pool = pool;
+	memif->is_master = 1;
+	memif->irq = 1;
+	memif->log2_ring_size = MEMIF_DEFAULT_LOG2_RING_SIZE;
+	memif->buffer_size = MEMIF_DEFAULT_BUFFER_SIZE;
+	memif->mtu = MEMIF_MTU;
+	memif->listen_fd = -1;
+	memif->ctrl_fd = -1;
+	memif->next_connect = ODP_TIME_NULL;
+	snprintf(memif->socket, sizeof(memif->socket), "%s",
+		 MEMIF_DEFAULT_SOCKET);
+	odp_atomic_init_u32(&memif->state, MEMIF_STATE_DISCONNECTED);
+
+	for (i = 0; i < MEMIF_MAX_QUEUES; i++) {
+		memif->rx_ring[i].s.int_fd = -1;
+		memif->tx_ring[i].s.int_fd = -1;
+		odp_ticketlock_init(&memif->rxq[i].s.lock);
+		odp_ticketlock_init(&memif->txq[i].s.lock);
+	}
+
+	if (memif_parse_opts(memif, devname + 6))
+		return -1;
+
+	/* Locally administered address, unique per process and role */
+	memif->if_mac[0] = 0x02;
+	memif->if_mac[1] = 0xfe;
+	memif->if_mac[2] = pid >> 8;
+	memif->if_mac[3] = pid;
+	memif->if_mac[4] = memif->id;
+	memif->if_mac[5] = memif->is_master;
+
+	if (memif->is_master && memif_listen(memif))
+		return -1;
+
+	odp_spinlock_lock(&memif_lock);
+
+	for (i = 0; i < ODP_CONFIG_PKTIO_ENTRIES; i++) {
+		if (memif_tbl[i] == NULL) {
+			memif_tbl[i] = pktio_entry;
+			break;
+		}
+	}
+
+	odp_spinlock_unlock(&memif_lock);
+
+	memif_ctrl_poll_all(1);
+
+	return 0;
+}
+
+static int memif_close(pktio_entry_t *pktio_entry)
+{
+	pkt_memif_t *memif = &pktio_entry->s.pkt_memif;
+	int i;
+
+	odp_spinlock_lock(&memif_lock);
+
+	for (i = 0; i < ODP_CONFIG_PKTIO_ENTRIES; i++) {
+		if (memif_tbl[i] == pktio_entry)
+			memif_tbl[i] = NULL;
+	}
+
+	memif_disconnect(pktio_entry, "interface closed");
+
+	if (memif->listen_fd >= 0) {
+		close(memif->listen_fd);
+		unlink(memif->socket);
+		memif->listen_fd = -1;
+	}
+
+	odp_spinlock_unlock(&memif_lock);
+
+	return 0;
+}
+
+static int memif_start(pktio_entry_t *pktio_entry)
+{
+	pkt_memif_t *memif = &pktio_entry->s.pkt_memif;
+	unsigned num_s2m, num_m2s;
+
+	odp_spinlock_lock(&memif_lock);
+
+	/* Rings follow the queue configuration of the slave */
+	if (!memif->is_master && memif->num_region) {
+		memif_slave_rings(pktio_entry, &num_s2m, &num_m2s);
+
+		if (num_s2m != memif->num_s2m || num_m2s != memif->num_m2s) {
+			memif_disconnect(pktio_entry,
+					 "queue configuration changed");
+			memif->next_connect = ODP_TIME_NULL;
+		}
+	}
+
+	odp_spinlock_unlock(&memif_lock);
+
+	memif_ctrl_poll_all(1);
+
+	return 0;
+}
+
+/* Data of a received descriptor, or NULL when it is not within the shared
+ * memory */
+static inline uint8_t *memif_rx_data(pkt_memif_t *memif,
+				     struct memif_ring_t *mr, uint16_t slot,
+				     const _odp_memif_desc_t *desc,
+				     uint32_t *len)
+{
+	uint32_t length = desc->length;
+	uint32_t offset;
+	uint16_t region;
+
+	/* Slave buffers are at fixed places, only length is from the
+	 * master */
+	if (!memif->is_master) {
+		if (odp_unlikely(length > memif->buffer_size))
+			return NULL;
+		*len = length;
+		return mr->buf + (uint32_t)(slot & mr->mask) *
+				 memif->buffer_size;
+	}
+
+	region = desc->region;
+	offset = desc->offset;
+
+	if (odp_unlikely(region >= memif->num_region ||
+			 (uint64_t)offset + length >
+			 memif->region[region].size))
+		return NULL;
+
+	*len = length;
+	return memif->region[region].addr + offset;
+}
+
+/* Receive from a ring. Caller holds the queue lock. */
+static int memif_ring_recv(pktio_entry_t *pktio_entry,
+			   struct memif_queue_t *rxq, struct memif_ring_t *mr,
+			   odp_packet_t pkt_table[], int num)
+{
+	pkt_memif_t *memif = &pktio_entry->s.pkt_memif;
+	_odp_memif_ring_t *ring = mr->ring;
+	int cls_enabled = pktio_cls_enabled(pktio_entry);
+	uint16_t cur = mr->last;
+	uint16_t end, i;
+	odp_time_t ts_val;
+	odp_time_t *ts = NULL;
+	uint64_t octets = 0;
+	int nb_rx = 0;
+
+	if (memif->is_master)
+		end = ring_load_acquire(&ring->head);
+	else
+		end = ring_load_acquire(&ring->tail);
+
+	if (cur == end)
+		return 0;
+
+	if (pktio_entry->s.config.pktin.bit.ts_all ||
+	    pktio_entry->s.config.pktin.bit.ts_ptp) {
+		ts_val = odp_time_global();
+		ts = &ts_val;
+	}
+
+	while (cur != end && nb_rx < num) {
+		memif_seg_t seg[MEMIF_MAX_CHAIN];
+		odp_packet_hdr_t parsed_hdr;
+		odp_packet_hdr_t *pkt_hdr;
+		odp_pool_t pool = memif->pool;
+		odp_packet_t pkt;
+		uint16_t first = cur;
+		uint16_t flags;
+		uint32_t pkt_len = 0;
+		uint32_t offset = 0;
+		unsigned nseg = 0;
+		int bad = 0;
+
+		do {
+			const _odp_memif_desc_t *desc =
+				&ring->desc[cur & mr->mask];
+			uint32_t len;
+			uint8_t *data = memif_rx_data(memif, mr, cur, desc,
+						      &len);
+
+			flags = desc->flags;
+			cur++;
+
+			if (odp_unlikely(data == NULL ||
+					 nseg == MEMIF_MAX_CHAIN)) {
+				bad = 1;
+				continue;
+			}
+
+			seg[nseg].data = data;
+			seg[nseg].len = len;
+			nseg++;
+			pkt_len += len;
+		} while ((flags & _ODP_MEMIF_DESC_FLAG_NEXT) && cur != end);
+
+		if (odp_unlikely(bad || (flags & _ODP_MEMIF_DESC_FLAG_NEXT) ||
+				 pkt_len == 0 || pkt_len > memif->mtu)) {
+			rxq->errors++;
+			continue;
+		}
+
+		if (cls_enabled &&
+		    cls_classify_packet(pktio_entry, seg[0].data, pkt_len,
+					seg[0].len, &pool, &parsed_hdr)) {
+			rxq->discards++;
+			continue;
+		}
+
+		/* Frames stay in the ring until there are packets */
+		if (odp_unlikely(pktio_pkt_alloc(pktio_entry, pool, pkt_len,
+						 &pkt, 1) != 1)) {
+			cur = first;
+			break;
+		}
+
+		for (i = 0; i < nseg; i++) {
+			odp_packet_copy_from_mem(pkt, offset, seg[i].len,
+						 seg[i].data);
+			offset += seg[i].len;
+		}
+
+		pkt_hdr = odp_packet_hdr(pkt);
+		pkt_hdr->input = pktio_entry->s.handle;
+
+		if (cls_enabled)
+			copy_packet_cls_metadata(&parsed_hdr, pkt_hdr);
+
+		packet_set_ts(pkt_hdr, ts);
+
+		octets += pkt_len;
+		pkt_table[nb_rx++] = pkt;
+	}
+
+	if (memif->is_master) {
+		ring_store_release(&ring->tail, cur);
+	} else {
+		/* Post consumed buffers back to the master */
+		for (i = mr->last; i != cur; i++) {
+			_odp_memif_desc_t *desc = &ring->desc[i & mr->mask];
+
+			desc->flags = 0;
+			desc->region = 0;
+			desc->length = memif->buffer_size;
+			desc->offset = mr->buf - memif->region[0].addr +
+				       (uint32_t)(i & mr->mask) *
+				       memif->buffer_size;
+		}
+		ring_store_release(&ring->head, cur + mr->mask + 1);
+	}
+
+	mr->last = cur;
+	rxq->octets += octets;
+	rxq->pkts += nb_rx;
+
+	return nb_rx;
+}
+
+static int memif_recv(pktio_entry_t *pktio_entry, int index,
+		      odp_packet_t pkt_table[], int num)
+{
+	pkt_memif_t *memif = &pktio_entry->s.pkt_memif;
+	struct memif_queue_t *rxq = &memif->rxq[index].s;
+	unsigned num_queues = pktio_entry->s.num_in_queue;
+	unsigned r, num_rings;
+	int ctrl_poll = 0;
+	int nb_rx = 0;
+
+	if (odp_unlikely(pktio_entry->s.state != PKTIO_STATE_STARTED))
+		return 0;
+
+	/* Queue lock also keeps the rings mapped, even with
+	 * ODP_PKTIO_OP_MT_UNSAFE */
+	odp_ticketlock_lock(&rxq->lock);
+
+	if (odp_likely(memif_connected(memif))) {
+		num_rings = memif_num_rx_rings(memif);
+
+		for (r = index; r < num_rings && nb_rx < num; r += num_queues)
+			nb_rx += memif_ring_recv(pktio_entry, rxq,
+						 &memif->rx_ring[r].s,
+						 &pkt_table[nb_rx],
+						 num - nb_rx);
+	}
+
+	if (nb_rx == 0 && ++rxq->ctrl_poll >= MEMIF_CTRL_POLL) {
+		rxq->ctrl_poll = 0;
+		ctrl_poll = 1;
+	}
+
+	odp_ticketlock_unlock(&rxq->lock);
+
+	if (odp_unlikely(ctrl_poll))
+		memif_ctrl_poll_all(0);
+
+	if (!pktio_cls_enabled(pktio_entry))
+		packet_parse_multi(pkt_table, nb_rx,
+				   pktio_entry->s.parse_layer);
+
+	return nb_rx;
+}
+
+/* Buffer of a descriptor to send to, or NULL when it is not within the
+ * shared memory */
+static inline uint8_t *memif_tx_data(pkt_memif_t *memif,
+				     struct memif_ring_t *mr, uint16_t slot,
+				     uint32_t *len)
+{
+	const _odp_memif_desc_t *desc = &mr->ring->desc[slot & mr->mask];
+	uint8_t *data;
+
+	if (!memif->is_master) {
+		*len = memif->buffer_size;
+		return mr->buf + (uint32_t)(slot & mr->mask) *
+				 memif->buffer_size;
+	}
+
+	/* Master fills buffers posted by the slave */
+	data = memif_rx_data(memif, mr, slot, desc, len);
+	if (odp_unlikely(data != NULL && *len == 0))
+		return NULL;
+
+	return data;
+}
+
+/* Send to a ring. Caller holds the queue lock. */
+static int memif_ring_send(pktio_entry_t *pktio_entry,
+			   struct memif_queue_t *txq, struct memif_ring_t *mr,
+			   const odp_packet_t pkt_table[], int num)
+{
+	pkt_memif_t *memif = &pktio_entry->s.pkt_memif;
+	_odp_memif_ring_t *ring = mr->ring;
+	uint16_t cur, end;
+	uint64_t octets = 0;
+	int i;
+
+	if (memif->is_master) {
+		cur = ring->tail;
+		end = ring_load_acquire(&ring->head);
+	} else {
+		cur = ring->head;
+		end = ring_load_acquire(&ring->tail) + mr->mask + 1;
+	}
+
+	for (i = 0; i < num; i++) {
+		memif_seg_t seg[MEMIF_MAX_CHAIN];
+		uint32_t pkt_len = odp_packet_len(pkt_table[i]);
+		uint32_t room = 0;
+		uint32_t offset = 0;
+		uint16_t slot = cur;
+		unsigned nseg = 0;
+		unsigned j;
+
+		/* Descriptors are checked before anything is written */
+		do {
+			if (slot == end || nseg == MEMIF_MAX_CHAIN)
+				goto full;
+
+			seg[nseg].data = memif_tx_data(memif, mr, slot,
+						       &seg[nseg].len);
+			if (odp_unlikely(seg[nseg].data == NULL)) {
+				txq->errors++;
+				goto full;
+			}
+
+			room += seg[nseg].len;
+			nseg++;
+			slot++;
+		} while (room < pkt_len);
+
+		for (j = 0; j < nseg; j++) {
+			_odp_memif_desc_t *desc =
+				&ring->desc[(uint16_t)(cur + j) & mr->mask];
+			uint32_t len = pkt_len - offset;
+
+			if (len > seg[j].len)
+				len = seg[j].len;
+
+			odp_packet_copy_to_mem(pkt_table[i], offset, len,
+					       seg[j].data);
+			offset += len;
+
+			if (!memif->is_master) {
+				desc->region = 0;
+				desc->offset = seg[j].data -
+					       memif->region[0].addr;
+			}
+			desc->length = len;
+			desc->flags = j + 1 < nseg ?
+				      _ODP_MEMIF_DESC_FLAG_NEXT : 0;
+		}
+
+		cur = slot;
+		octets += pkt_len;
+	}
+
+full:
+	if (i == 0)
+		return 0;
+
+	if (memif->is_master)
+		ring_store_release(&ring->tail, cur);
+	else
+		ring_store_release(&ring->head, cur);
+
+	/* Index update is visible before the receiver flags are read */
+	odp_mb_full();
+
+	if (!(__atomic_load_n(&ring->flags, __ATOMIC_RELAXED) &
+	      _ODP_MEMIF_RING_FLAG_MASK_INT)) {
+		uint64_t one = 1;
+
+		if (write(mr->int_fd, &one, sizeof(one)) < 0)
+			ODP_DBG("memif: interrupt: %s\n", strerror(errno));
+	}
+
+	txq->octets += octets;
+	txq->pkts += i;
+
+	pktio_pkt_recycle(pktio_entry, pkt_table, i);
+
+	return i;
+}
+
+static int memif_send(pktio_entry_t *pktio_entry, int index,
+		      const odp_packet_t pkt_table[], int num)
+{
+	pkt_memif_t *memif = &pktio_entry->s.pkt_memif;
+	struct memif_queue_t *txq;
+	unsigned num_rings;
+	unsigned r;
+	int i, ret;
+
+	if (odp_unlikely(pktio_entry->s.state != PKTIO_STATE_STARTED))
+		return 0;
+
+	for (i = 0; i < num; i++) {
+		if (odp_unlikely(odp_packet_len(pkt_table[i]) > memif->mtu))
+			break;
+	}
+
+	if (odp_unlikely(i == 0 && num > 0)) {
+		__odp_errno = EMSGSIZE;
+		return -1;
+	}
+	num = i;
+
+	num_rings = memif_num_tx_rings(memif);
+
+	/* Frames sent while the link is down are lost */
+	if (odp_unlikely(!memif_connected(memif) || num_rings == 0)) {
+		txq = &memif->txq[index].s;
+
+		odp_ticketlock_lock(&txq->lock);
+		txq->discards += num;
+		odp_ticketlock_unlock(&txq->lock);
+
+		pktio_pkt_recycle(pktio_entry, pkt_table, num);
+		memif_ctrl_poll_all(0);
+
+		return num;
+	}
+
+	/* Pktout queues share rings when the slave has fewer of them */
+	r = index % num_rings;
+	txq = &memif->txq[r].s;
+
+	odp_ticketlock_lock(&txq->lock);
+
+	if (odp_likely(memif_connected(memif) &&
+		       r < memif_num_tx_rings(memif)))
+		ret = memif_ring_send(pktio_entry, txq, &memif->tx_ring[r].s,
+				      pkt_table, num);
+	else
+		ret = 0;
+
+	odp_ticketlock_unlock(&txq->lock);
+
+	return ret;
+}
+
+/* Wait for frames on the rings of a pktin queue, sleeping on their interrupt
+ * eventfds */
+static int memif_recv_tmo(pktio_entry_t *pktio_entry, int index,
+			  odp_packet_t pkt_table[], int num, uint64_t wait)
+{
+	pkt_memif_t *memif = &pktio_entry->s.pkt_memif;
+	struct memif_queue_t *rxq = &memif->rxq[index].s;
+	unsigned num_queues = pktio_entry->s.num_in_queue;
+	struct pollfd pfd[MEMIF_MAX_QUEUES];
+	struct memif_ring_t *mr[MEMIF_MAX_QUEUES];
+	odp_time_t start = odp_time_local();
+	struct timespec ts;
+	uint64_t sleep, elapsed;
+	unsigned r, num_rings;
+	int ret, nfd, pending, i;
+
+	while (1) {
+		ret = memif_recv(pktio_entry, index, pkt_table, num);
+		if (ret != 0)
+			return ret;
+
+		sleep = MEMIF_IRQ_SLEEP_NS;
+
+		if (wait != ODP_PKTIN_WAIT) {
+			elapsed = odp_time_to_ns(odp_time_diff(odp_time_local(),
+							      start));
+			if (elapsed >= wait)
+				return 0;
+			if (wait - elapsed < sleep)
+				sleep = wait - elapsed;
+		}
+
+		if (!memif->irq || !memif_connected(memif) ||
+		    pktio_entry->s.state != PKTIO_STATE_STARTED) {
+			ts.tv_sec = 0;
+			ts.tv_nsec = sleep < MEMIF_POLL_SLEEP_NS ?
+				     sleep : MEMIF_POLL_SLEEP_NS;
+			nanosleep(&ts, NULL);
+			continue;
+		}
+
+		odp_ticketlock_lock(&rxq->lock);
+
+		nfd = 0;
+		pending = 0;
+
+		if (memif_connected(memif)) {
+			num_rings = memif_num_rx_rings(memif);
+
+			for (r = index; r < num_rings; r += num_queues) {
+				mr[nfd] = &memif->rx_ring[r].s;
+				__atomic_store_n(&mr[nfd]->ring->flags, 0,
+						 __ATOMIC_RELAXED);
+				pfd[nfd].fd = mr[nfd]->int_fd;
+				pfd[nfd].events = POLLIN;
+				pfd[nfd].revents = 0;
+				nfd++;
+			}
+		}
+
+		/* Interrupts are enabled before the rings are checked again,
+		 * so that a frame sent meanwhile is not missed */
+		odp_mb_full();
+
+		for (i = 0; i < nfd; i++) {
+			uint16_t *idx = memif->is_master ? &mr[i]->ring->head :
+					&mr[i]->ring->tail;
+
+			if (ring_load_acquire(idx) != mr[i]->last)
+				pending = 1;
+		}
+
+		if (nfd && !pending) {
+			ts.tv_sec = sleep / ODP_TIME_SEC_IN_NS;
+			ts.tv_nsec = sleep % ODP_TIME_SEC_IN_NS;
+			ppoll(pfd, nfd, &ts, NULL);
+		}
+
+		for (i = 0; i < nfd; i++) {
+			uint64_t cnt;
+
+			if (pfd[i].revents & POLLIN &&
+			    read(pfd[i].fd, &cnt, sizeof(cnt)) < 0)
+				ODP_DBG("memif: interrupt: %s\n",
+					strerror(errno));
+			__atomic_store_n(&mr[i]->ring->flags,
+					 _ODP_MEMIF_RING_FLAG_MASK_INT,
+					 __ATOMIC_RELAXED);
+		}
+
+		odp_ticketlock_unlock(&rxq->lock);
+
+		if (nfd == 0) {
+			ts.tv_sec = 0;
+			ts.tv_nsec = sleep < MEMIF_POLL_SLEEP_NS ?
+				     sleep : MEMIF_POLL_SLEEP_NS;
+			nanosleep(&ts, NULL);
+		}
+	}
+}
+
+static uint32_t memif_mtu_get(pktio_entry_t *pktio_entry)
+{
+	return pktio_entry->s.pkt_memif.mtu;
+}
+
+static int memif_promisc_mode_get(pktio_entry_t *pktio_entry ODP_UNUSED)
+{
+	return 1;
+}
+
+static int memif_mac_addr_get(pktio_entry_t *pktio_entry, void *mac_addr)
+{
+	memcpy(mac_addr, pktio_entry->s.pkt_memif.if_mac, ETH_ALEN);
+	return ETH_ALEN;
+}
+
+static int memif_link_status(pktio_entry_t *pktio_entry)
+{
+	pkt_memif_t *memif = &pktio_entry->s.pkt_memif;
+
+	memif_ctrl_poll_all(0);
+
+	/* Master is a port that slaves plug into */
+	return memif->is_master || memif_connected(memif);
+}
+
+static int memif_capability(pktio_entry_t *pktio_entry ODP_UNUSED,
+			    odp_pktio_capability_t *capa)
+{
+	memset(capa, 0, sizeof(odp_pktio_capability_t));
+
+	capa->max_input_queues  = MEMIF_MAX_QUEUES;
+	capa->max_output_queues = MEMIF_MAX_QUEUES;
+
+	odp_pktio_config_init(&capa->config);
+	capa->config.pktin.bit.ts_all = 1;
+	capa->config.pktin.bit.ts_ptp = 1;
+	return 0;
+}
+
+static int memif_stats_reset(pktio_entry_t *pktio_entry)
+{
+	pkt_memif_t *memif = &pktio_entry->s.pkt_memif;
+	unsigned i;
+
+	memset(&pktio_entry->s.stats, 0, sizeof(odp_pktio_stats_t));
+
+	for (i = 0; i < MEMIF_MAX_QUEUES; i++) {
+		struct memif_queue_t *rxq = &memif->rxq[i].s;
+		struct memif_queue_t *txq = &memif->txq[i].s;
+
+		rxq->octets = 0;
+		rxq->pkts = 0;
+		rxq->discards = 0;
+		rxq->errors = 0;
+		txq->octets = 0;
+		txq->pkts = 0;
+		txq->discards = 0;
+		txq->errors = 0;
+	}
+
+	return 0;
+}
+
+static int memif_stats(pktio_entry_t *pktio_entry, odp_pktio_stats_t *stats)
+{
+	pkt_memif_t *memif = &pktio_entry->s.pkt_memif;
+	unsigned i;
+
+	memcpy(stats, &pktio_entry->s.stats, sizeof(odp_pktio_stats_t));
+
+	for (i = 0; i < MEMIF_MAX_QUEUES; i++) {
+		struct memif_queue_t *rxq = &memif->rxq[i].s;
+		struct memif_queue_t *txq = &memif->txq[i].s;
+
+		stats->in_octets += rxq->octets;
+		stats->in_ucast_pkts += rxq->pkts;
+		stats->in_discards += rxq->discards;
+		stats->in_errors += rxq->errors;
+		stats->out_octets += txq->octets;
+		stats->out_ucast_pkts += txq->pkts;
+		stats->out_discards += txq->discards;
+		stats->out_errors += txq->errors;
+	}
+
+	return 0;
+}
+
+static int memif_init_global(void)
+{
+	odp_spinlock_init(&memif_lock);
+
+	if (getenv("ODP_PKTIO_DISABLE_MEMIF")) {
+		ODP_PRINT("PKTIO: memif pktio skipped,"
+			  " enabled export ODP_PKTIO_DISABLE_MEMIF=1.\n");
+		disable_pktio = 1;
+	} else  {
+		ODP_PRINT("PKTIO: initialized memif pktio,"
+			  " use export ODP_PKTIO_DISABLE_MEMIF=1 to disable.\n"
+			  " Interface names are memif:[socket=<path>]"
+			  "[:role=master|slave][:id=<n>][:secret=<s>]"
+			  "[:rsize=<log2>][:bsize=<n>][:irq=0].\n");
+	}
+	return 0;
+}
+
+const pktio_if_ops_t memif_pktio_ops = {
+	.name = "memif",
+	.print = NULL,
+	.init_global = memif_init_global,
+	.init_local = NULL,
+	.term = NULL,
+	.open = memif_open,
+	.close = memif_close,
+	.start = memif_start,
+	.stop = NULL,
+	.stats = memif_stats,
+	.stats_reset = memif_stats_reset,
+	.recv = memif_recv,
+	.recv_tmo = memif_recv_tmo,
+	.send = memif_send,
+	.mtu_get = memif_mtu_get,
+	.promisc_mode_set = NULL,
+	.promisc_mode_get = memif_promisc_mode_get,
+	.mac_get = memif_mac_addr_get,
+	.link_status = memif_link_status,
+	.capability = memif_capability,
+	.pktin_ts_res = NULL,
+	.pktin_ts_from_ns = NULL,
+	.config = NULL,
+	.input_queues_config = NULL,
+	.output_queues_config = NULL,
+};
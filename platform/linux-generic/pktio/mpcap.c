@@ -0,0 +1,1122 @@
+/* Copyright (c) 2017, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+/**
+ * @file
+ *
+ * Memory-mapped pcap pktio type
+ *
+ * This file provides a pktio interface for high rate replay of pcap and
+ * pcapng capture files and for capturing into pcap files. Unlike the
+ * libpcap based "pcap" pktio, the input file is memory mapped and indexed
+ * once when the interface is opened, and packets are built from the mapping
+ * in bursts. The output file is written in large chunks.
+ *
+ * To use this interface the name passed to odp_pktio_open() must begin
+ * with "mpcap:" and be in the format;
+ *
+ * mpcap:in=test.pcap:out=test_out.pcap:loops=10:pps=1000000
+ *
+ *   in       the name of the input pcap or pcapng file. Only Ethernet
+ *            link type is supported.
+ *   out      the name of the output pcap file. If the file exists it will
+ *            be overwritten.
+ *   loops    the number of times to iterate through the input file, set
+ *            to 0 to loop indefinitely. The default value is 1.
+ *   pps      replay rate limit in packets per second
+ *   bps      replay rate limit in bits per second
+ *   realtime set to 1 to replay packets at the pace of their capture
+ *            timestamps
+ *   rewrite  set to 1 to add the loop count to IPv4 source addresses, so
+ *            that flows stay distinct between loops. IPv4, TCP and UDP
+ *            checksums are updated.
+ *   wbuf     size of the output buffer in bytes. The default is 1 MB. Set
+ *            to 0 to write out every burst of packets.
+ *   direct   set to 1 to write output with O_DIRECT
+ *   follow   set to 1 to receive also packets appended to the input file
+ *            after it was opened (classic pcap format, single pktin queue)
+ *
+ * Rate limits are shared evenly between pktin queues. Each pktin queue
+ * replays its own contiguous shard of the input file.
+ *
+ * By default, the output is written when the buffer fills up, on stop and
+ * on close.
+ * With O_DIRECT only full blocks are written before close.
+ *
+ * The total length of the string is limited by PKTIO_NAME_LEN.
+ */
+
+#include <odp_posix_extensions.h>
+
+#include <odp_api.h>
+#include <odp_packet_internal.h>
+#include <odp_packet_io_internal.h>
+
+#include <protocols/eth.h>
+#include <protocols/ip.h>
+#include <protocols/tcp.h>
+#include <protocols/udp.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/types.h>
+
+#define PKTIO_MPCAP_MTU (64 * 1024)
+
+/* Classic pcap format */
+#define MPCAP_MAGIC_USEC        0xa1b2c3d4
+#define MPCAP_MAGIC_USEC_SWAP   0xd4c3b2a1
+#define MPCAP_MAGIC_NSEC        0xa1b23c4d
+#define MPCAP_MAGIC_NSEC_SWAP   0x4d3cb2a1
+#define MPCAP_FILE_HDR_LEN      24
+#define MPCAP_REC_HDR_LEN       16
+#define MPCAP_LINKTYPE_ETHERNET 1
+
+/* Pcapng format */
+#define MPCAP_NG_SHB            0x0a0d0d0a
+#define MPCAP_NG_IDB            0x00000001
+#define MPCAP_NG_SPB            0x00000003
+#define MPCAP_NG_EPB            0x00000006
+#define MPCAP_NG_BYTE_ORDER     0x1a2b3c4d
+#define MPCAP_NG_BYTE_ORDER_SWAP 0x4d3c2b1a
+#define MPCAP_NG_OPT_TSRESOL    9
+#define MPCAP_NG_MAX_IF         16
+
+/* Output buffer */
+#define MPCAP_WBUF_SIZE         (1024 * 1024)
+#define MPCAP_WBUF_MIN          (2 * PKTIO_MPCAP_MTU)
+#define MPCAP_DIRECT_ALIGN      4096
+
+static const uint8_t mpcap_mac[] = {0x02, 0xe9, 0x34, 0x80, 0x73, 0x05};
+
+static int mpcapif_stats_reset(pktio_entry_t *pktio_entry);
+static int mpcapif_close(pktio_entry_t *pktio_entry);
+
+static inline uint16_t mpcap_rd16(const uint8_t *p, odp_bool_t swap)
+{
+	uint16_t val;
+
+	memcpy(&val, p, sizeof(val));
+	return swap ? __builtin_bswap16(val) : val;
+}
+
+static inline uint32_t mpcap_rd32(const uint8_t *p, odp_bool_t swap)
+{
+	uint32_t val;
+
+	memcpy(&val, p, sizeof(val));
+	return swap ? __builtin_bswap32(val) : val;
+}
+
+static int _mpcapif_parse_devname(pkt_mpcap_t *pcap, const char *devname)
+{
+	char *tok;
+	char in[PKTIO_NAME_LEN];
+
+	if (strncmp(devname, "mpcap:", 6) != 0)
+		return -1;
+
+	snprintf(in, sizeof(in), "%s", devname);
+
+	for (tok = strtok(in + 6, ":"); tok; tok = strtok(NULL, ":")) {
+		if (strncmp(tok, "in=", 3) == 0 && !pcap->fname_rx) {
+			pcap->fname_rx = strdup(tok + 3);
+		} else if (strncmp(tok, "out=", 4) == 0 && !pcap->fname_tx) {
+			pcap->fname_tx = strdup(tok + 4);
+		} else if (strncmp(tok, "loops=", 6) == 0) {
+			pcap->loops = atoi(tok + 6);
+			if (pcap->loops < 0) {
+				ODP_ERR("invalid loop count\n");
+				return -1;
+			}
+		} else if (strncmp(tok, "pps=", 4) == 0) {
+			pcap->pps = strtoull(tok + 4, NULL, 0);
+		} else if (strncmp(tok, "bps=", 4) == 0) {
+			pcap->bps = strtoull(tok + 4, NULL, 0);
+		} else if (strncmp(tok, "realtime=", 9) == 0) {
+			pcap->realtime = atoi(tok + 9) != 0;
+		} else if (strncmp(tok, "rewrite=", 8) == 0) {
+			pcap->rewrite = atoi(tok + 8) != 0;
+		} else if (strncmp(tok, "wbuf=", 5) == 0) {
+			pcap->wbuf_size = strtoul(tok + 5, NULL, 0);
+			pcap->sync_tx = (pcap->wbuf_size == 0);
+		} else if (strncmp(tok, "direct=", 7) == 0) {
+			pcap->direct = atoi(tok + 7) != 0;
+		} else if (strncmp(tok, "follow=", 7) == 0) {
+			pcap->follow = atoi(tok + 7) != 0;
+		}
+	}
+
+	return 0;
+}
+
+static int _mpcapif_rec_add(pkt_mpcap_t *pcap, uint64_t offset,
+			    uint32_t caplen, uint64_t ts_ns)
+{
+	mpcap_rec_t *rec;
+
+	if (caplen == 0 || caplen > PKTIO_MPCAP_MTU)
+		return 0;
+
+	if (pcap->num_rec == pcap->max_rec) {
+		uint32_t num = pcap->max_rec ? 2 * pcap->max_rec : 1024;
+
+		if (num <= pcap->max_rec) {
+			ODP_ERR("too many packets in %s\n", pcap->fname_rx);
+			return -1;
+		}
+
+		rec = realloc(pcap->rec, (size_t)num * sizeof(mpcap_rec_t));
+		if (rec == NULL) {
+			ODP_ERR("failed to allocate packet index\n");
+			return -1;
+		}
+		pcap->rec = rec;
+		pcap->max_rec = num;
+	}
+
+	rec = &pcap->rec[pcap->num_rec++];
+	rec->offset = offset;
+	rec->caplen = caplen;
+	rec->ts_ns  = ts_ns;
+
+	return 0;
+}
+
+/* Index records of classic pcap file, starting from the first record not
+ * indexed yet */
+static int _mpcapif_index_pcap(pkt_mpcap_t *pcap)
+{
+	const uint8_t *data = pcap->map;
+	uint64_t offset = pcap->idx_offset;
+	odp_bool_t swap = pcap->idx_swap;
+	uint32_t caplen, sec, frac;
+	uint64_t ts;
+
+	while (offset + MPCAP_REC_HDR_LEN <= pcap->map_len) {
+		sec    = mpcap_rd32(data + offset, swap);
+		frac   = mpcap_rd32(data + offset + 4, swap);
+		caplen = mpcap_rd32(data + offset + 8, swap);
+
+		/* Incomplete record is retried when following the file */
+		if (offset + MPCAP_REC_HDR_LEN + caplen > pcap->map_len)
+			break;
+
+		ts = sec * ODP_TIME_SEC_IN_NS;
+		ts += pcap->idx_nsec ? frac : frac * ODP_TIME_USEC_IN_NS;
+
+		if (_mpcapif_rec_add(pcap, offset + MPCAP_REC_HDR_LEN,
+				     caplen, ts))
+			return -1;
+
+		offset += MPCAP_REC_HDR_LEN + caplen;
+	}
+
+	pcap->idx_offset = offset;
+
+	return 0;
+}
+
+static int _mpcapif_open_pcap(pkt_mpcap_t *pcap, uint32_t magic)
+{
+	pcap->idx_swap = (magic == MPCAP_MAGIC_USEC_SWAP ||
+			  magic == MPCAP_MAGIC_NSEC_SWAP);
+	pcap->idx_nsec = (magic == MPCAP_MAGIC_NSEC ||
+			  magic == MPCAP_MAGIC_NSEC_SWAP);
+	pcap->idx_offset = MPCAP_FILE_HDR_LEN;
+
+	if (pcap->map_len < MPCAP_FILE_HDR_LEN) {
+		ODP_ERR("truncated pcap file %s\n", pcap->fname_rx);
+		return -1;
+	}
+
+	if ((mpcap_rd32(pcap->map + 20, pcap->idx_swap) & 0xffff) !=
+	    MPCAP_LINKTYPE_ETHERNET) {
+		ODP_ERR("unsupported datalink type: %u\n",
+			mpcap_rd32(pcap->map + 20, pcap->idx_swap));
+		return -1;
+	}
+
+	return _mpcapif_index_pcap(pcap);
+}
+
+/* Convert pcapng timestamp to nanoseconds. Resolution is 10^-res seconds,
+ * or 2^-res seconds when the most significant bit is set. */
+static uint64_t _mpcapif_ng_ts_ns(uint64_t ts, uint8_t tsresol)
+{
+	uint8_t res = tsresol & 0x7f;
+	uint64_t mul = 1;
+
+	if (tsresol & 0x80) {
+		if (res > 32) {
+			ts >>= res - 32;
+			res = 32;
+		}
+		return (ts >> res) * ODP_TIME_SEC_IN_NS +
+		       (((ts & ((1ULL << res) - 1)) * ODP_TIME_SEC_IN_NS) >>
+			res);
+	}
+
+	if (res <= 9) {
+		for (; res < 9; res++)
+			mul *= 10;
+		return ts * mul;
+	}
+
+	for (; res > 9 && mul < ts; res--)
+		mul *= 10;
+	return res > 9 ? 0 : ts / mul;
+}
+
+static uint8_t _mpcapif_ng_tsresol(const uint8_t *opt, uint32_t len,
+				   odp_bool_t swap)
+{
+	uint16_t code, opt_len;
+
+	while (len >= 4) {
+		code    = mpcap_rd16(opt, swap);
+		opt_len = mpcap_rd16(opt + 2, swap);
+
+		if (code == 0 || 4 + (uint32_t)opt_len > len)
+			break;
+
+		if (code == MPCAP_NG_OPT_TSRESOL && opt_len >= 1)
+			return opt[4];
+
+		opt_len = ODP_ALIGN_ROUNDUP(opt_len, 4);
+		if (4 + (uint32_t)opt_len > len)
+			break;
+		opt += 4 + opt_len;
+		len -= 4 + opt_len;
+	}
+
+	/* Microseconds by default */
+	return 6;
+}
+
+static int _mpcapif_index_pcapng(pkt_mpcap_t *pcap)
+{
+	const uint8_t *data = pcap->map;
+	const uint8_t *body;
+	uint64_t offset = 0;
+	uint32_t num_if = 0;
+	uint32_t type, blk_len, body_len, if_id, caplen, bom;
+	uint64_t ts;
+	odp_bool_t swap = 0;
+	struct {
+		odp_bool_t eth;
+		uint8_t tsresol;
+	} ifs[MPCAP_NG_MAX_IF];
+
+	while (offset + 12 <= pcap->map_len) {
+		type = mpcap_rd32(data + offset, swap);
+
+		if (type == MPCAP_NG_SHB) {
+			/* Sections have own byte order and interfaces */
+			bom = mpcap_rd32(data + offset + 8, 0);
+			if (bom == MPCAP_NG_BYTE_ORDER) {
+				swap = 0;
+			} else if (bom == MPCAP_NG_BYTE_ORDER_SWAP) {
+				swap = 1;
+			} else {
+				ODP_ERR("bad pcapng byte order in %s\n",
+					pcap->fname_rx);
+				return -1;
+			}
+			num_if = 0;
+		}
+
+		blk_len = mpcap_rd32(data + offset + 4, swap);
+		if (blk_len < 12 || (blk_len & 3) ||
+		    offset + blk_len > pcap->map_len) {
+			ODP_DBG("truncated block in %s\n", pcap->fname_rx);
+			break;
+		}
+
+		body     = data + offset + 8;
+		body_len = blk_len - 12;
+
+		switch (type) {
+		case MPCAP_NG_IDB:
+			if (body_len < 8 || num_if == MPCAP_NG_MAX_IF)
+				break;
+			ifs[num_if].eth = mpcap_rd16(body, swap) ==
+					  MPCAP_LINKTYPE_ETHERNET;
+			ifs[num_if].tsresol =
+				_mpcapif_ng_tsresol(body + 8, body_len - 8,
+						    swap);
+			num_if++;
+			break;
+		case MPCAP_NG_EPB:
+			if (body_len < 20)
+				break;
+			if_id  = mpcap_rd32(body, swap);
+			caplen = mpcap_rd32(body + 12, swap);
+			if (if_id >= num_if || !ifs[if_id].eth ||
+			    20 + (uint64_t)caplen > body_len)
+				break;
+			ts = ((uint64_t)mpcap_rd32(body + 4, swap) << 32) |
+			     mpcap_rd32(body + 8, swap);
+			ts = _mpcapif_ng_ts_ns(ts, ifs[if_id].tsresol);
+			if (_mpcapif_rec_add(pcap, offset + 8 + 20, caplen,
+					     ts))
+				return -1;
+			break;
+		case MPCAP_NG_SPB:
+			/* Simple packet blocks have no timestamp */
+			if (body_len < 4 || num_if == 0 || !ifs[0].eth)
+				break;
+			caplen = mpcap_rd32(body, swap);
+			if (caplen > body_len - 4)
+				caplen = body_len - 4;
+			if (_mpcapif_rec_add(pcap, offset + 8 + 4, caplen, 0))
+				return -1;
+			break;
+		default:
+			break;
+		}
+
+		offset += blk_len;
+	}
+
+	return 0;
+}
+
+/* Map input file. Returns 1 when the file has not grown since it was
+ * mapped last time. */
+static int _mpcapif_map(pkt_mpcap_t *pcap)
+{
+	struct stat st;
+	void *map;
+	int fd;
+
+	fd = open(pcap->fname_rx, O_RDONLY);
+	if (fd < 0) {
+		__odp_errno = errno;
+		ODP_ERR("failed to open %s: %s\n", pcap->fname_rx,
+			strerror(errno));
+		return -1;
+	}
+
+	if (fstat(fd, &st) != 0 || st.st_size < 4) {
+		ODP_ERR("not a pcap file: %s\n", pcap->fname_rx);
+		close(fd);
+		return -1;
+	}
+
+	if ((uint64_t)st.st_size <= pcap->map_len) {
+		close(fd);
+		return 1;
+	}
+
+	map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (map == MAP_FAILED) {
+		__odp_errno = errno;
+		ODP_ERR("failed to map %s: %s\n", pcap->fname_rx,
+			strerror(errno));
+		return -1;
+	}
+
+	/* Packets are replayed in file order, possibly many times */
+	(void)madvise(map, st.st_size, MADV_WILLNEED);
+
+	if (pcap->map)
+		munmap((void *)(uintptr_t)pcap->map, pcap->map_len);
+
+	pcap->map = map;
+	pcap->map_len = st.st_size;
+
+	return 0;
+}
+
+static int _mpcapif_init_rx(pkt_mpcap_t *pcap)
+{
+	uint32_t magic;
+	int ret;
+
+	if (_mpcapif_map(pcap))
+		return -1;
+
+	magic = mpcap_rd32(pcap->map, 0);
+
+	switch (magic) {
+	case MPCAP_MAGIC_USEC:
+	case MPCAP_MAGIC_USEC_SWAP:
+	case MPCAP_MAGIC_NSEC:
+	case MPCAP_MAGIC_NSEC_SWAP:
+		ret = _mpcapif_open_pcap(pcap, magic);
+		break;
+	case MPCAP_NG_SHB:
+		ret = _mpcapif_index_pcapng(pcap);
+		if (pcap->follow) {
+			ODP_DBG("pcapng files are not followed\n");
+			pcap->follow = 0;
+		}
+		break;
+	default:
+		ODP_ERR("unknown file format: %s\n", pcap->fname_rx);
+		ret = -1;
+	}
+
+	if (ret == 0)
+		ODP_DBG("%s: %" PRIu32 " packets\n", pcap->fname_rx,
+			pcap->num_rec);
+
+	return ret;
+}
+
+/* Index packets appended to the input file since last time. Returns
+ * non-zero when there are no new packets. */
+static int _mpcapif_follow(pkt_mpcap_t *pcap, struct mpcap_rx_queue_t *rxq)
+{
+	uint32_t num_rec = pcap->num_rec;
+
+	if (_mpcapif_map(pcap) || _mpcapif_index_pcap(pcap) ||
+	    pcap->num_rec == num_rec)
+		return 1;
+
+	rxq->end = pcap->num_rec;
+
+	return 0;
+}
+
+static int _mpcapif_flush(pkt_mpcap_t *pcap, odp_bool_t all)
+{
+	uint32_t len = pcap->wbuf_len;
+	uint32_t done = 0;
+	ssize_t ret;
+	int flags;
+
+	if (pcap->direct) {
+		if (all) {
+			/* Last partial block goes out without O_DIRECT */
+			flags = fcntl(pcap->fd_tx, F_GETFL);
+			if (flags < 0 ||
+			    fcntl(pcap->fd_tx, F_SETFL, flags & ~O_DIRECT)) {
+				__odp_errno = errno;
+				ODP_ERR("fcntl(): %s\n", strerror(errno));
+				return -1;
+			}
+			pcap->direct = 0;
+		} else {
+			len = ODP_ALIGN_ROUNDDOWN_POWER_2(len,
+							  MPCAP_DIRECT_ALIGN);
+		}
+	}
+
+	while (done < len) {
+		ret = write(pcap->fd_tx, pcap->wbuf + done, len - done);
+		if (ret < 0) {
+			if (errno == EINTR)
+				continue;
+			__odp_errno = errno;
+			ODP_ERR("write(%s): %s\n", pcap->fname_tx,
+				strerror(errno));
+			return -1;
+		}
+		done += ret;
+	}
+
+	pcap->wbuf_len -= len;
+	if (pcap->wbuf_len)
+		memmove(pcap->wbuf, pcap->wbuf + len, pcap->wbuf_len);
+
+	return 0;
+}
+
+static int _mpcapif_init_tx(pkt_mpcap_t *pcap)
+{
+	int flags = O_WRONLY | O_CREAT | O_TRUNC;
+	uint32_t hdr[MPCAP_FILE_HDR_LEN / sizeof(uint32_t)];
+	void *buf;
+
+	pcap->fd_tx = -1;
+
+	if (pcap->direct) {
+		pcap->fd_tx = open(pcap->fname_tx, flags | O_DIRECT, 0644);
+		if (pcap->fd_tx < 0 && errno == EINVAL) {
+			ODP_DBG("O_DIRECT not supported for %s\n",
+				pcap->fname_tx);
+			pcap->direct = 0;
+		}
+	}
+
+	if (!pcap->direct)
+		pcap->fd_tx = open(pcap->fname_tx, flags, 0644);
+
+	if (pcap->fd_tx < 0) {
+		__odp_errno = errno;
+		ODP_ERR("failed to open %s: %s\n", pcap->fname_tx,
+			strerror(errno));
+		return -1;
+	}
+
+	if (pcap->wbuf_size < MPCAP_WBUF_MIN)
+		pcap->wbuf_size = MPCAP_WBUF_MIN;
+	pcap->wbuf_size = ODP_ALIGN_ROUNDUP(pcap->wbuf_size,
+					    MPCAP_DIRECT_ALIGN);
+
+	if (posix_memalign(&buf, MPCAP_DIRECT_ALIGN, pcap->wbuf_size)) {
+		ODP_ERR("failed to allocate output buffer\n");
+		return -1;
+	}
+	pcap->wbuf = buf;
+
+	hdr[0] = MPCAP_MAGIC_USEC;
+	hdr[1] = 2 | (4 << 16);		/* version 2.4 */
+	hdr[2] = 0;			/* thiszone */
+	hdr[3] = 0;			/* sigfigs */
+	hdr[4] = PKTIO_MPCAP_MTU;	/* snaplen */
+	hdr[5] = MPCAP_LINKTYPE_ETHERNET;
+	if (odp_unlikely(ODP_BYTE_ORDER == ODP_BIG_ENDIAN))
+		hdr[1] = 4 | (2 << 16);
+
+	memcpy(pcap->wbuf, hdr, MPCAP_FILE_HDR_LEN);
+	pcap->wbuf_len = MPCAP_FILE_HDR_LEN;
+
+	/* Make the file a valid capture right away */
+	return pcap->direct ? 0 : _mpcapif_flush(pcap, 1);
+}
+
+static void _mpcapif_rxq_init(pkt_mpcap_t *pcap, unsigned num_queues)
+{
+	struct mpcap_rx_queue_t *rxq;
+	unsigned i;
+
+	for (i = 0; i < num_queues; i++) {
+		rxq = &pcap->rxq[i].s;
+		rxq->first = ((uint64_t)pcap->num_rec * i) / num_queues;
+		rxq->end = ((uint64_t)pcap->num_rec * (i + 1)) / num_queues;
+		rxq->cur = rxq->first;
+		rxq->loop_cnt = 0;
+	}
+
+	pcap->num_rx_queues = num_queues;
+}
+
+static int mpcapif_init(odp_pktio_t id ODP_UNUSED, pktio_entry_t *pktio_entry,
+			const char *devname, odp_pool_t pool)
+{
+	pkt_mpcap_t *pcap = &pktio_entry->s.pkt_mpcap;
+	unsigned i;
+	int ret;
+
+	memset(pcap, 0, sizeof(pkt_mpcap_t));
+	pcap->loops = 1;
+	pcap->pool = pool;
+	pcap->promisc = 1;
+	pcap->fd_tx = -1;
+	pcap->wbuf_size = MPCAP_WBUF_SIZE;
+
+	for (i = 0; i < MPCAP_MAX_QUEUES; i++)
+		odp_ticketlock_init(&pcap->rxq[i].s.lock);
+
+	ret = _mpcapif_parse_devname(pcap, devname);
+
+	if (ret == 0 && pcap->fname_rx)
+		ret = _mpcapif_init_rx(pcap);
+
+	if (ret == 0 && pcap->fname_tx)
+		ret = _mpcapif_init_tx(pcap);
+
+	if (ret == 0 && !pcap->map && pcap->fd_tx < 0)
+		ret = -1;
+
+	_mpcapif_rxq_init(pcap, 1);
+
+	(void)mpcapif_stats_reset(pktio_entry);
+
+	if (ret != 0)
+		(void)mpcapif_close(pktio_entry);
+
+	return ret;
+}
+
+static int mpcapif_close(pktio_entry_t *pktio_entry)
+{
+	pkt_mpcap_t *pcap = &pktio_entry->s.pkt_mpcap;
+	int ret = 0;
+
+	if (pcap->fd_tx >= 0) {
+		if (pcap->wbuf && _mpcapif_flush(pcap, 1))
+			ret = -1;
+		close(pcap->fd_tx);
+	}
+
+	if (pcap->map)
+		munmap((void *)(uintptr_t)pcap->map, pcap->map_len);
+
+	free(pcap->rec);
+	free(pcap->wbuf);
+	free(pcap->fname_rx);
+	free(pcap->fname_tx);
+
+	return ret;
+}
+
+static int mpcapif_start(pktio_entry_t *pktio_entry)
+{
+	pkt_mpcap_t *pcap = &pktio_entry->s.pkt_mpcap;
+	struct mpcap_rx_queue_t *rxq;
+	odp_time_t now = odp_time_local();
+	unsigned i;
+
+	/* Rate control restarts from the current position */
+	for (i = 0; i < pcap->num_rx_queues; i++) {
+		rxq = &pcap->rxq[i].s;
+		rxq->start = now;
+		rxq->pkts = 0;
+		rxq->bytes = 0;
+		rxq->ts_delta = 0;
+		if (rxq->cur < rxq->end)
+			rxq->ts_delta = -(int64_t)pcap->rec[rxq->cur].ts_ns;
+	}
+
+	return 0;
+}
+
+static int mpcapif_stop(pktio_entry_t *pktio_entry)
+{
+	pkt_mpcap_t *pcap = &pktio_entry->s.pkt_mpcap;
+
+	/* Entry is locked, no sends in progress */
+	if (pcap->fd_tx >= 0)
+		return _mpcapif_flush(pcap, !pcap->direct);
+
+	return 0;
+}
+
+static int mpcapif_input_queues_config(pktio_entry_t *pktio_entry,
+				       const odp_pktin_queue_param_t *p)
+{
+	pkt_mpcap_t *pcap = &pktio_entry->s.pkt_mpcap;
+
+	/* Scheduler synchronizes input queue polls. Only single thread
+	 * at a time polls a queue */
+	if (pktio_entry->s.param.in_mode == ODP_PKTIN_MODE_SCHED)
+		pcap->lockless_rx = 1;
+	else
+		pcap->lockless_rx = (p->op_mode == ODP_PKTIO_OP_MT_UNSAFE);
+
+	if (pcap->follow && p->num_queues > 1) {
+		ODP_ERR("followed file cannot be sharded\n");
+		return -1;
+	}
+
+	_mpcapif_rxq_init(pcap, p->num_queues ? p->num_queues : 1);
+
+	return 0;
+}
+
+/* Start next loop over the shard. Returns non-zero when all loops are
+ * done. */
+static int _mpcapif_rewind(pkt_mpcap_t *pcap, struct mpcap_rx_queue_t *rxq)
+{
+	if (rxq->first == rxq->end)
+		return 1;
+
+	if (pcap->loops != 0 && rxq->loop_cnt + 1 >= (uint32_t)pcap->loops)
+		return 1;
+
+	/* Next loop starts where the previous one ended */
+	rxq->ts_delta += (int64_t)pcap->rec[rxq->end - 1].ts_ns -
+			 (int64_t)pcap->rec[rxq->first].ts_ns;
+	rxq->loop_cnt++;
+	rxq->cur = rxq->first;
+
+	return 0;
+}
+
+static inline int _mpcapif_rate_ok(pkt_mpcap_t *pcap,
+				   struct mpcap_rx_queue_t *rxq,
+				   const mpcap_rec_t *rec, uint64_t elapsed)
+{
+	double num_queues = pcap->num_rx_queues;
+
+	if (pcap->realtime &&
+	    (int64_t)rec->ts_ns + rxq->ts_delta > (int64_t)elapsed)
+		return 0;
+
+	if (pcap->pps && (double)rxq->pkts * ODP_TIME_SEC_IN_NS * num_queues /
+	    pcap->pps > elapsed)
+		return 0;
+
+	if (pcap->bps && (double)rxq->bytes * 8 * ODP_TIME_SEC_IN_NS *
+	    num_queues / pcap->bps > elapsed)
+		return 0;
+
+	return 1;
+}
+
+static inline int _mpcapif_dst_ok(const uint8_t *data, uint32_t len)
+{
+	if (len < _ODP_ETHADDR_LEN)
+		return 0;
+
+	/* Our address, broadcast or multicast */
+	return (data[0] & 1) ||
+	       memcmp(data, mpcap_mac, _ODP_ETHADDR_LEN) == 0;
+}
+
+/* Incremental checksum update for a changed 32-bit word (RFC 1624) */
+static inline uint16_t _mpcapif_chksum_adjust(uint16_t chksum, uint32_t old,
+					      uint32_t new)
+{
+	uint32_t sum = (uint16_t)~chksum;
+
+	sum += (uint16_t)~(old >> 16);
+	sum += (uint16_t)~(old & 0xffff);
+	sum += new >> 16;
+	sum += new & 0xffff;
+	sum = (sum & 0xffff) + (sum >> 16);
+	sum = (sum & 0xffff) + (sum >> 16);
+
+	return (uint16_t)~sum;
+}
+
+/* Add loop count to IPv4 source address of a packet */
+static void _mpcapif_rewrite(odp_packet_t pkt, uint32_t loop_cnt)
+{
+	uint8_t *data = odp_packet_data(pkt);
+	uint32_t seg_len = odp_packet_seg_len(pkt);
+	uint32_t offset = _ODP_ETHHDR_LEN;
+	_odp_ipv4hdr_t *ip;
+	_odp_tcphdr_t *tcp;
+	_odp_udphdr_t *udp;
+	uint32_t old, new, ihl;
+	uint16_t type;
+
+	if (seg_len < _ODP_ETHHDR_LEN + _ODP_VLANHDR_LEN)
+		return;
+
+	type = odp_be_to_cpu_16(((_odp_ethhdr_t *)data)->type);
+	if (type == _ODP_ETHTYPE_VLAN) {
+		type = odp_be_to_cpu_16(((_odp_vlanhdr_t *)
+					 (data + offset))->type);
+		offset += _ODP_VLANHDR_LEN;
+	}
+
+	if (type != _ODP_ETHTYPE_IPV4 || seg_len < offset + _ODP_IPV4HDR_LEN)
+		return;
+
+	ip = (_odp_ipv4hdr_t *)(data + offset);
+	ihl = _ODP_IPV4HDR_IHL(ip->ver_ihl) * 4;
+
+	old = ip->src_addr;
+	new = odp_cpu_to_be_32(odp_be_to_cpu_32(old) + loop_cnt);
+	ip->src_addr = new;
+	ip->chksum = _mpcapif_chksum_adjust(ip->chksum, old, new);
+
+	/* Pseudo header of the first fragment only */
+	if (_ODP_IPV4HDR_FRAG_OFFSET(odp_be_to_cpu_16(ip->frag_offset)))
+		return;
+
+	offset += ihl;
+
+	if (ip->proto == _ODP_IPPROTO_TCP &&
+	    seg_len >= offset + _ODP_TCPHDR_LEN) {
+		tcp = (_odp_tcphdr_t *)(data + offset);
+		tcp->cksm = _mpcapif_chksum_adjust(tcp->cksm, old, new);
+	} else if (ip->proto == _ODP_IPPROTO_UDP &&
+		   seg_len >= offset + _ODP_UDPHDR_LEN) {
+		udp = (_odp_udphdr_t *)(data + offset);
+		/* Zero checksum means no checksum */
+		if (udp->chksum == 0)
+			return;
+		udp->chksum = _mpcapif_chksum_adjust(udp->chksum, old, new);
+		if (udp->chksum == 0)
+			udp->chksum = 0xffff;
+	}
+}
+
+static int mpcapif_recv_pkt(pktio_entry_t *pktio_entry, int index,
+			    odp_packet_t pkts[], int len)
+{
+	pkt_mpcap_t *pcap = &pktio_entry->s.pkt_mpcap;
+	struct mpcap_rx_queue_t *rxq = &pcap->rxq[index].s;
+	uint32_t rec_idx[QUEUE_MULTI_MAX];
+	uint32_t rec_loop[QUEUE_MULTI_MAX];
+	const mpcap_rec_t *rec;
+	odp_packet_hdr_t *pkt_hdr;
+	odp_bool_t rate;
+	uint64_t elapsed = 0;
+	uint32_t max_len = 0;
+	odp_time_t ts_val;
+	odp_time_t *ts = NULL;
+	int i, n, num = 0;
+
+	if (odp_unlikely(len > QUEUE_MULTI_MAX))
+		len = QUEUE_MULTI_MAX;
+
+	if (!pcap->lockless_rx)
+		odp_ticketlock_lock(&rxq->lock);
+
+	if (pktio_entry->s.state != PKTIO_STATE_STARTED || !pcap->map)
+		goto out;
+
+	if (pktio_entry->s.config.pktin.bit.ts_all ||
+	    pktio_entry->s.config.pktin.bit.ts_ptp)
+		ts = &ts_val;
+
+	rate = pcap->pps || pcap->bps || pcap->realtime;
+	if (rate)
+		elapsed = odp_time_to_ns(odp_time_diff(odp_time_local(),
+						       rxq->start));
+
+	/* Pick records of the burst */
+	for (n = 0; n < len; ) {
+		if (rxq->cur == rxq->end &&
+		    (!pcap->follow || _mpcapif_follow(pcap, rxq)) &&
+		    _mpcapif_rewind(pcap, rxq))
+			break;
+
+		rec = &pcap->rec[rxq->cur];
+
+		if (rate && !_mpcapif_rate_ok(pcap, rxq, rec, elapsed))
+			break;
+
+		rxq->cur++;
+
+		if (!pcap->promisc &&
+		    !_mpcapif_dst_ok(pcap->map + rec->offset, rec->caplen))
+			continue;
+
+		rxq->pkts++;
+		rxq->bytes += rec->caplen;
+		if (rec->caplen > max_len)
+			max_len = rec->caplen;
+
+		rec_idx[n] = rec - pcap->rec;
+		rec_loop[n] = rxq->loop_cnt;
+		n++;
+	}
+
+	if (n == 0)
+		goto out;
+
+	num = packet_alloc_multi(pcap->pool, max_len, pkts, n);
+	if (odp_unlikely(num < 0))
+		num = 0;
+
+	/* Like a NIC out of buffers, drop what cannot be received */
+	rxq->in_discards += n - num;
+
+	if (ts != NULL)
+		ts_val = odp_time_global();
+
+	for (i = 0; i < num; i++) {
+		rec = &pcap->rec[rec_idx[i]];
+
+		if (rec->caplen < max_len)
+			(void)odp_packet_trunc_tail(&pkts[i],
+						    max_len - rec->caplen,
+						    NULL, NULL);
+
+		(void)odp_packet_copy_from_mem(pkts[i], 0, rec->caplen,
+					       pcap->map + rec->offset);
+
+		if (pcap->rewrite && rec_loop[i])
+			_mpcapif_rewrite(pkts[i], rec_loop[i]);
+
+		pkt_hdr = odp_packet_hdr(pkts[i]);
+		packet_set_ts(pkt_hdr, ts);
+		pkt_hdr->input = pktio_entry->s.handle;
+
+		rxq->in_octets += rec->caplen;
+	}
+	rxq->in_ucast_pkts += num;
+
+out:
+	if (!pcap->lockless_rx)
+		odp_ticketlock_unlock(&rxq->lock);
+
+	packet_parse_multi(pkts, num, pktio_entry->s.parse_layer);
+
+	return num;
+}
+
+static int _mpcapif_dump_pkt(pkt_mpcap_t *pcap, odp_packet_t pkt,
+			     const struct timeval *tv)
+{
+	uint32_t hdr[MPCAP_REC_HDR_LEN / sizeof(uint32_t)];
+	uint32_t pkt_len = odp_packet_len(pkt);
+
+	if (pcap->wbuf_size - pcap->wbuf_len < MPCAP_REC_HDR_LEN + pkt_len &&
+	    _mpcapif_flush(pcap, 0))
+		return -1;
+
+	hdr[0] = tv->tv_sec;
+	hdr[1] = tv->tv_usec;
+	hdr[2] = pkt_len;
+	hdr[3] = pkt_len;
+	memcpy(pcap->wbuf + pcap->wbuf_len, hdr, MPCAP_REC_HDR_LEN);
+
+	if (odp_packet_copy_to_mem(pkt, 0, pkt_len, pcap->wbuf +
+				   pcap->wbuf_len + MPCAP_REC_HDR_LEN) != 0)
+		return -1;
+
+	pcap->wbuf_len += MPCAP_REC_HDR_LEN + pkt_len;
+
+	return 0;
+}
+
+static int mpcapif_send_pkt(pktio_entry_t *pktio_entry, int index ODP_UNUSED,
+			    const odp_packet_t pkts[], int len)
+{
+	pkt_mpcap_t *pcap = &pktio_entry->s.pkt_mpcap;
+	struct timeval tv;
+	int i;
+
+	odp_ticketlock_lock(&pktio_entry->s.txl);
+
+	if (pktio_entry->s.state != PKTIO_STATE_STARTED) {
+		odp_ticketlock_unlock(&pktio_entry->s.txl);
+		return 0;
+	}
+
+	(void)gettimeofday(&tv, NULL);
+
+	for (i = 0; i < len; ++i) {
+		uint32_t pkt_len = odp_packet_len(pkts[i]);
+
+		if (pkt_len > PKTIO_MPCAP_MTU) {
+			if (i == 0) {
+				__odp_errno = EMSGSIZE;
+				odp_ticketlock_unlock(&pktio_entry->s.txl);
+				return -1;
+			}
+			break;
+		}
+
+		if (pcap->fd_tx >= 0 && _mpcapif_dump_pkt(pcap, pkts[i], &tv))
+			break;
+
+		pktio_entry->s.stats.out_octets += pkt_len;
+		odp_packet_free(pkts[i]);
+	}
+
+	pktio_entry->s.stats.out_ucast_pkts += i;
+
+	if (pcap->sync_tx && pcap->fd_tx >= 0)
+		(void)_mpcapif_flush(pcap, !pcap->direct);
+
+	odp_ticketlock_unlock(&pktio_entry->s.txl);
+
+	return i;
+}
+
+static uint32_t mpcapif_mtu_get(pktio_entry_t *pktio_entry ODP_UNUSED)
+{
+	return PKTIO_MPCAP_MTU;
+}
+
+static int mpcapif_mac_addr_get(pktio_entry_t *pktio_entry ODP_UNUSED,
+				void *mac_addr)
+{
+	memcpy(mac_addr, mpcap_mac, _ODP_ETHADDR_LEN);
+
+	return _ODP_ETHADDR_LEN;
+}
+
+static int mpcapif_capability(pktio_entry_t *pktio_entry,
+			      odp_pktio_capability_t *capa)
+{
+	memset(capa, 0, sizeof(odp_pktio_capability_t));
+
+	/* Appended packets are not sharded */
+	capa->max_input_queues  = pktio_entry->s.pkt_mpcap.follow ?
+				  1 : MPCAP_MAX_QUEUES;
+	capa->max_output_queues = 1;
+	capa->set_op.op.promisc_mode = 1;
+
+	odp_pktio_config_init(&capa->config);
+	capa->config.pktin.bit.ts_all = 1;
+	capa->config.pktin.bit.ts_ptp = 1;
+	return 0;
+}
+
+static int mpcapif_promisc_mode_set(pktio_entry_t *pktio_entry,
+				    odp_bool_t enable)
+{
+	pktio_entry->s.pkt_mpcap.promisc = enable;
+	return 0;
+}
+
+static int mpcapif_promisc_mode_get(pktio_entry_t *pktio_entry)
+{
+	return pktio_entry->s.pkt_mpcap.promisc;
+}
+
+static int mpcapif_stats_reset(pktio_entry_t *pktio_entry)
+{
+	pkt_mpcap_t *pcap = &pktio_entry->s.pkt_mpcap;
+	unsigned i;
+
+	memset(&pktio_entry->s.stats, 0, sizeof(odp_pktio_stats_t));
+
+	for (i = 0; i < MPCAP_MAX_QUEUES; i++) {
+		pcap->rxq[i].s.in_octets = 0;
+		pcap->rxq[i].s.in_ucast_pkts = 0;
+		pcap->rxq[i].s.in_discards = 0;
+	}
+
+	return 0;
+}
+
+static int mpcapif_stats(pktio_entry_t *pktio_entry,
+			 odp_pktio_stats_t *stats)
+{
+	pkt_mpcap_t *pcap = &pktio_entry->s.pkt_mpcap;
+	unsigned i;
+
+	memcpy(stats, &pktio_entry->s.stats, sizeof(odp_pktio_stats_t));
+
+	for (i = 0; i < MPCAP_MAX_QUEUES; i++) {
+		stats->in_octets += pcap->rxq[i].s.in_octets;
+		stats->in_ucast_pkts += pcap->rxq[i].s.in_ucast_pkts;
+		stats->in_discards += pcap->rxq[i].s.in_discards;
+	}
+
+	return 0;
+}
+
+static int mpcapif_init_global(void)
+{
+	ODP_PRINT("PKTIO: initialized mpcap interface.\n");
+	return 0;
+}
+
+const pktio_if_ops_t mpcap_pktio_ops = {
+	.name = "mpcap",
+	.print = NULL,
+	.init_global = mpcapif_init_global,
+	.init_local = NULL,
+	.open = mpcapif_init,
+	.close = mpcapif_close,
+	.start = mpcapif_start,
+	.stop = mpcapif_stop,
+	.stats = mpcapif_stats,
+	.stats_reset = mpcapif_stats_reset,
+	.recv = mpcapif_recv_pkt,
+	.send = mpcapif_send_pkt,
+	.mtu_get = mpcapif_mtu_get,
+	.promisc_mode_set = mpcapif_promisc_mode_set,
+	.promisc_mode_get = mpcapif_promisc_mode_get,
+	.mac_get = mpcapif_mac_addr_get,
+	.capability = mpcapif_capability,
+	.pktin_ts_res = NULL,
+	.pktin_ts_from_ns = NULL,
+	.config = NULL,
+	.input_queues_config = mpcapif_input_queues_config,
+	.output_queues_config = NULL,
+};
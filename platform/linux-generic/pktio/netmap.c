@@ -720,16 +720,17 @@ static inline int netmap_pkt_to_odp(pktio_entry_t *pktio_entry,
 
 		if (pktio_cls_enabled(pktio_entry))
 			copy_packet_cls_metadata(&parsed_hdr, pkt_hdr);
-		else
-			packet_parse_l2(&pkt_hdr->p, len);
 
 		packet_set_ts(pkt_hdr, ts);
 	}
 
-	return i;
-
 fail:
-	odp_packet_free_multi(&pkt_tbl[i], num - i);
+	if (odp_unlikely(i < num))
+		odp_packet_free_multi(&pkt_tbl[i], num - i);
+
+	if (!pktio_cls_enabled(pktio_entry))
+		packet_parse_multi(pkt_tbl, i, pktio_entry->s.parse_layer);
+
 	return i;
 }
 
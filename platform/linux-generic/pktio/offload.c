@@ -0,0 +1,664 @@
+/* Copyright (c) 2017, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+/*
+ * Software segmentation offload on packet output and TCP segment coalescing
+ * on packet input. Interfaces which send and receive one MTU sized frame per
+ * packet (socket, socket_mmap, tap) are driven through these when enabled in
+ * odp_pktio_config_t, so that applications can handle large TCP/UDP packets.
+ */
+
+#include <odp_packet_io_internal.h>
+#include <odp_packet_internal.h>
+#include <odp_debug_internal.h>
+#include <protocols/eth.h>
+#include <protocols/ip.h>
+#include <protocols/tcp.h>
+#include <protocols/udp.h>
+
+#include <string.h>
+
+/* Maximum number of segments created and sent at a time */
+#define SEG_BURST 32
+
+/* Maximum number of TCP flows coalesced in parallel within a burst */
+#define COALESCE_MAX_FLOWS 8
+
+/* Maximum IP packet length of a coalesced packet */
+#define COALESCE_MAX_IP_LEN 0xffff
+
+/* TCP flags, byte 13 of the TCP header */
+#define TCP_FLAGS_OFFSET 13
+#define TCP_FLAG_FIN 0x01
+#define TCP_FLAG_PSH 0x08
+#define TCP_FLAG_ACK 0x10
+#define TCP_FLAG_CWR 0x80
+
+/* L3/L4 header layout of a TCP or UDP packet */
+typedef struct {
+	uint32_t l3_offset;
+	uint32_t l4_offset;
+	uint32_t hdr_len;	/* L2, L3 and L4 headers */
+	uint32_t ip_len;	/* IP packet length from the IP header */
+	int ipv4;
+	int tcp;
+} l4_info_t;
+
+static int l4_info_get(odp_packet_hdr_t *pkt_hdr, l4_info_t *info)
+{
+	uint32_t seg_len;
+	const uint8_t *ip;
+
+	if (packet_parse_not_complete(pkt_hdr))
+		packet_parse_layer(pkt_hdr, LAYER_ALL);
+
+	if (pkt_hdr->p.error_flags.all ||
+	    !(pkt_hdr->p.input_flags.tcp || pkt_hdr->p.input_flags.udp) ||
+	    pkt_hdr->p.input_flags.ipfrag)
+		return -1;
+
+	info->l3_offset = pkt_hdr->p.l3_offset;
+	info->l4_offset = pkt_hdr->p.l4_offset;
+	info->ipv4 = pkt_hdr->p.input_flags.ipv4;
+	info->tcp = pkt_hdr->p.input_flags.tcp;
+
+	/* IPv6 extension headers are not updated */
+	if (!info->ipv4 && (!pkt_hdr->p.input_flags.ipv6 ||
+			    info->l4_offset - info->l3_offset !=
+			    _ODP_IPV6HDR_LEN))
+		return -1;
+
+	/* Headers are accessed in place */
+	ip = packet_map(pkt_hdr, info->l3_offset, &seg_len);
+	if (ip == NULL || seg_len < info->l4_offset - info->l3_offset +
+	    _ODP_TCPHDR_LEN)
+		return -1;
+
+	if (info->tcp) {
+		const _odp_tcphdr_t *tcp = (const _odp_tcphdr_t *)
+					   (ip + info->l4_offset -
+					    info->l3_offset);
+
+		info->hdr_len = info->l4_offset + tcp->hl * 4;
+		if (tcp->hl * 4 < _ODP_TCPHDR_LEN)
+			return -1;
+	} else {
+		info->hdr_len = info->l4_offset + _ODP_UDPHDR_LEN;
+	}
+
+	if (info->hdr_len > pkt_hdr->frame_len ||
+	    info->hdr_len - info->l3_offset > seg_len)
+		return -1;
+
+	if (info->ipv4)
+		info->ip_len = odp_be_to_cpu_16(((const _odp_ipv4hdr_t *)
+						 (const void *)ip)->tot_len);
+	else
+		info->ip_len = odp_be_to_cpu_16(((const _odp_ipv6hdr_t *)
+						 (const void *)ip)->payload_len)
+			       + _ODP_IPV6HDR_LEN;
+
+	return 0;
+}
+
+/* Sum of big endian 16 bit words of packet data, for the Internet checksum */
+static uint64_t chksum_add_pkt(odp_packet_hdr_t *pkt_hdr, uint32_t offset,
+			       uint32_t len, uint64_t sum)
+{
+	int odd = 0;
+
+	while (len) {
+		uint32_t seg_len = 0, i = 0;
+		const uint8_t *data = packet_map(pkt_hdr, offset, &seg_len);
+
+		if (seg_len > len)
+			seg_len = len;
+
+		offset += seg_len;
+		len    -= seg_len;
+
+		/* Second byte of a word split between segments */
+		if (odd) {
+			sum += data[0];
+			i = 1;
+		}
+
+		for (; i + 1 < seg_len; i += 2)
+			sum += (data[i] << 8) | data[i + 1];
+
+		odd = i < seg_len;
+		if (odd)
+			sum += data[i] << 8;
+	}
+
+	return sum;
+}
+
+static uint64_t chksum_add_mem(const uint8_t *data, uint32_t len,
+			       uint64_t sum)
+{
+	uint32_t i;
+
+	for (i = 0; i < len; i += 2)
+		sum += (data[i] << 8) | data[i + 1];
+
+	return sum;
+}
+
+static uint16_t chksum_fold(uint64_t sum)
+{
+	while (sum >> 16)
+		sum = (sum & 0xffff) + (sum >> 16);
+
+	return ~sum & 0xffff;
+}
+
+/* Pseudo header sum of the L4 checksum */
+static uint64_t chksum_pseudo(const l4_info_t *info, const uint8_t *ip,
+			      uint32_t l4_len)
+{
+	uint64_t sum;
+
+	if (info->ipv4)
+		sum = chksum_add_mem(ip + 12, 2 * _ODP_IPV4ADDR_LEN, 0);
+	else
+		sum = chksum_add_mem(ip + 8, 2 * _ODP_IPV6ADDR_LEN, 0);
+
+	sum += (l4_len >> 16) + (l4_len & 0xffff);
+	return sum + (info->tcp ? _ODP_IPPROTO_TCP : _ODP_IPPROTO_UDP);
+}
+
+/* Update IP length, IPv4 header checksum and L4 checksum */
+static void l4_hdr_finish(odp_packet_hdr_t *pkt_hdr, const l4_info_t *info,
+			  uint8_t *ip)
+{
+	uint8_t *l4 = ip + info->l4_offset - info->l3_offset;
+	uint32_t ip_len = pkt_hdr->frame_len - info->l3_offset;
+	uint32_t l4_len = pkt_hdr->frame_len - info->l4_offset;
+	uint64_t sum;
+	uint16_t chksum;
+
+	if (info->ipv4) {
+		_odp_ipv4hdr_t *ipv4 = (_odp_ipv4hdr_t *)(void *)ip;
+
+		ipv4->tot_len = odp_cpu_to_be_16(ip_len);
+		ipv4->chksum = 0;
+		chksum = chksum_fold(chksum_add_mem(ip, info->l4_offset -
+						    info->l3_offset, 0));
+		ipv4->chksum = odp_cpu_to_be_16(chksum);
+	} else {
+		_odp_ipv6hdr_t *ipv6 = (_odp_ipv6hdr_t *)(void *)ip;
+
+		ipv6->payload_len = odp_cpu_to_be_16(ip_len -
+						     _ODP_IPV6HDR_LEN);
+	}
+
+	sum = chksum_pseudo(info, ip, l4_len);
+
+	if (info->tcp) {
+		_odp_tcphdr_t *tcp = (_odp_tcphdr_t *)(void *)l4;
+
+		tcp->cksm = 0;
+		chksum = chksum_fold(chksum_add_pkt(pkt_hdr, info->l4_offset,
+						    l4_len, sum));
+		tcp->cksm = odp_cpu_to_be_16(chksum);
+	} else {
+		_odp_udphdr_t *udp = (_odp_udphdr_t *)(void *)l4;
+
+		udp->length = odp_cpu_to_be_16(l4_len);
+
+		/* Checksum disabled by the sender */
+		if (info->ipv4 && udp->chksum == 0)
+			return;
+
+		udp->chksum = 0;
+		chksum = chksum_fold(chksum_add_pkt(pkt_hdr, info->l4_offset,
+						    l4_len, sum));
+		udp->chksum = odp_cpu_to_be_16(chksum ? chksum : 0xffff);
+	}
+}
+
+/*
+ * Segmentation offload
+ */
+
+/* Payload length of segments, or zero when the packet is sent as is */
+static uint32_t seg_len_get(pktio_entry_t *entry, odp_packet_hdr_t *pkt_hdr,
+			    l4_info_t *info)
+{
+	uint32_t seg_len;
+
+	if (l4_info_get(pkt_hdr, info))
+		return 0;
+
+	if (info->tcp ? !entry->s.config.pktout.bit.tcp_seg :
+			!entry->s.config.pktout.bit.udp_seg)
+		return 0;
+
+	if (entry->s.seg_mtu <= info->hdr_len - info->l3_offset)
+		return 0;
+
+	seg_len = entry->s.seg_mtu - (info->hdr_len - info->l3_offset);
+	if (entry->s.config.pktout_seg_len &&
+	    entry->s.config.pktout_seg_len < seg_len)
+		seg_len = entry->s.config.pktout_seg_len;
+
+	if (pkt_hdr->frame_len - info->hdr_len <= seg_len)
+		return 0;
+
+	return seg_len;
+}
+
+/* Create segments first ... first + num - 1 of a packet */
+static int seg_create(odp_packet_t pkt, const l4_info_t *info,
+		      uint32_t seg_len, uint32_t first, odp_packet_t seg[],
+		      int num)
+{
+	odp_packet_hdr_t *pkt_hdr = odp_packet_hdr(pkt);
+	uint32_t hdr_len = info->hdr_len;
+	uint32_t payload_len = pkt_hdr->frame_len - hdr_len;
+	const uint8_t *ip = packet_map(pkt_hdr, info->l3_offset, NULL);
+	const uint8_t *l4 = ip + info->l4_offset - info->l3_offset;
+	uint16_t ip_id = 0;
+	uint32_t tcp_seq = 0;
+	uint8_t tcp_flags = 0;
+	uint32_t last = (payload_len - 1) / seg_len;
+	int i, ret;
+
+	if (info->ipv4)
+		ip_id = odp_be_to_cpu_16(((const _odp_ipv4hdr_t *)
+					  (const void *)ip)->id);
+
+	if (info->tcp) {
+		tcp_seq = odp_be_to_cpu_32(((const _odp_tcphdr_t *)
+					    (const void *)l4)->seq_no);
+		tcp_flags = l4[TCP_FLAGS_OFFSET];
+	}
+
+	ret = packet_alloc_multi(odp_packet_pool(pkt), hdr_len + seg_len, seg,
+				 num);
+	if (ret != num) {
+		if (ret > 0)
+			odp_packet_free_multi(seg, ret);
+		return -1;
+	}
+
+	for (i = 0; i < num; i++) {
+		odp_packet_hdr_t *seg_hdr = odp_packet_hdr(seg[i]);
+		uint32_t idx = first + i;
+		uint32_t offset = idx * seg_len;
+		uint32_t len = payload_len - offset;
+		uint32_t map_len = 0;
+		uint8_t *seg_ip, *seg_l4;
+
+		if (len > seg_len)
+			len = seg_len;
+		else
+			pull_tail(seg_hdr, seg_len - len);
+
+		(void)odp_packet_copy_from_pkt(seg[i], 0, pkt, 0, hdr_len);
+		(void)odp_packet_copy_from_pkt(seg[i], hdr_len, pkt,
+					       hdr_len + offset, len);
+		_odp_packet_copy_md_to_packet(pkt, seg[i]);
+
+		seg_ip = packet_map(seg_hdr, info->l3_offset, &map_len);
+		if (odp_unlikely(map_len < hdr_len - info->l3_offset)) {
+			odp_packet_free_multi(seg, num);
+			return -1;
+		}
+
+		seg_l4 = seg_ip + info->l4_offset - info->l3_offset;
+
+		if (info->ipv4)
+			((_odp_ipv4hdr_t *)(void *)seg_ip)->id =
+				odp_cpu_to_be_16((uint16_t)(ip_id + idx));
+
+		if (info->tcp) {
+			uint8_t flags = tcp_flags;
+
+			((_odp_tcphdr_t *)(void *)seg_l4)->seq_no =
+				odp_cpu_to_be_32(tcp_seq + offset);
+
+			/* FIN and PSH on the last, CWR on the first segment */
+			if (idx != last)
+				flags &= ~(TCP_FLAG_FIN | TCP_FLAG_PSH);
+			if (idx != 0)
+				flags &= ~TCP_FLAG_CWR;
+
+			seg_l4[TCP_FLAGS_OFFSET] = flags;
+		}
+
+		l4_hdr_finish(seg_hdr, info, seg_ip);
+	}
+
+	return num;
+}
+
+static int seg_send_burst(pktio_entry_t *entry, int index,
+			  const odp_packet_t seg[], int num)
+{
+	int sent = 0;
+
+	while (sent < num) {
+		int ret = entry->s.ops->send(entry, index, &seg[sent],
+					     num - sent);
+
+		if (ret <= 0)
+			return sent ? sent : ret;
+
+		sent += ret;
+	}
+
+	return sent;
+}
+
+/* Segment and send a packet. Returns 1 when the packet was consumed, zero
+ * or a negative send error when no segment was sent. Segments which do not
+ * fit into the output queue after the first one has been sent are dropped,
+ * as if lost on the link. */
+static int seg_send(pktio_entry_t *entry, int index, odp_packet_t pkt,
+		    const l4_info_t *info, uint32_t seg_len)
+{
+	odp_packet_t seg[SEG_BURST];
+	uint32_t payload_len = odp_packet_len(pkt) - info->hdr_len;
+	uint32_t num_seg = (payload_len + seg_len - 1) / seg_len;
+	uint32_t first;
+
+	for (first = 0; first < num_seg; first += SEG_BURST) {
+		int num = num_seg - first < SEG_BURST ?
+			  num_seg - first : SEG_BURST;
+		int sent;
+
+		if (seg_create(pkt, info, seg_len, first, seg, num) < 0) {
+			if (first == 0)
+				return 0;
+			break;
+		}
+
+		sent = seg_send_burst(entry, index, seg, num);
+		if (sent < num) {
+			odp_packet_free_multi(&seg[sent > 0 ? sent : 0],
+					      num - (sent > 0 ? sent : 0));
+			if (first == 0 && sent <= 0)
+				return sent;
+			break;
+		}
+	}
+
+	odp_packet_free(pkt);
+	return 1;
+}
+
+static inline int send_result(int sent, int ret)
+{
+	if (ret < 0)
+		return sent ? sent : ret;
+
+	return sent + ret;
+}
+
+int pktout_seg_send(pktio_entry_t *entry, int index,
+		    const odp_packet_t packets[], int num)
+{
+	int first = 0;
+	int i, ret;
+
+	for (i = 0; i < num; i++) {
+		odp_packet_hdr_t *pkt_hdr = odp_packet_hdr(packets[i]);
+		l4_info_t info;
+		uint32_t seg_len;
+
+		if (odp_likely(pkt_hdr->frame_len <= entry->s.seg_min_len))
+			continue;
+
+		seg_len = seg_len_get(entry, pkt_hdr, &info);
+		if (seg_len == 0)
+			continue;
+
+		/* Packets in front of the segmented one are sent as is */
+		if (i > first) {
+			ret = entry->s.ops->send(entry, index, &packets[first],
+						 i - first);
+			if (ret < i - first)
+				return send_result(first, ret);
+		}
+
+		ret = seg_send(entry, index, packets[i], &info, seg_len);
+		if (ret <= 0)
+			return send_result(i, ret);
+
+		first = i + 1;
+	}
+
+	if (first == num)
+		return num;
+
+	ret = entry->s.ops->send(entry, index, &packets[first], num - first);
+
+	return send_result(first, ret);
+}
+
+/*
+ * TCP segment coalescing
+ */
+
+typedef struct {
+	int idx;		/* Index of the coalesced packet */
+	int merged;		/* Segments have been appended */
+	uint32_t next_seq;	/* Sequence number of the next segment */
+	l4_info_t info;
+} coalesce_flow_t;
+
+/* IPv4 header and TCP checksums of a received segment are correct */
+static int coalesce_chksum_ok(odp_packet_hdr_t *pkt_hdr,
+			      const l4_info_t *info, const uint8_t *ip)
+{
+	uint32_t l4_len = info->l3_offset + info->ip_len - info->l4_offset;
+	uint64_t sum;
+
+	if (info->ipv4 && chksum_fold(chksum_add_mem(ip, info->l4_offset -
+						     info->l3_offset, 0)))
+		return 0;
+
+	sum = chksum_add_pkt(pkt_hdr, info->l4_offset, l4_len,
+			     chksum_pseudo(info, ip, l4_len));
+	return chksum_fold(sum) == 0;
+}
+
+/* Returns 0 for TCP segments which may be coalesced, 1 for other TCP
+ * packets and -1 for other packets. Checksums of a coalesced packet are
+ * recalculated, so segments with a bad checksum are passed as they are. */
+static int coalesce_info_get(odp_packet_hdr_t *pkt_hdr, l4_info_t *info,
+			     const uint8_t **ip)
+{
+	const uint8_t *tcp;
+
+	if (l4_info_get(pkt_hdr, info) || !info->tcp)
+		return -1;
+
+	*ip = packet_map(pkt_hdr, info->l3_offset, NULL);
+	tcp = *ip + info->l4_offset - info->l3_offset;
+
+	if (info->l3_offset + info->ip_len != pkt_hdr->frame_len ||
+	    info->l3_offset + info->ip_len <= info->hdr_len ||
+	    (tcp[TCP_FLAGS_OFFSET] & ~TCP_FLAG_PSH) != TCP_FLAG_ACK ||
+	    !coalesce_chksum_ok(pkt_hdr, info, *ip))
+		return 1;
+
+	return 0;
+}
+
+/* Same L2, IP and TCP headers apart from lengths, IPv4 ID, sequence number,
+ * flags, window and checksums */
+static int coalesce_flow_match(const l4_info_t *a, const uint8_t *ip_a,
+			       const l4_info_t *b, const uint8_t *ip_b)
+{
+	uint32_t l3_len = a->l4_offset - a->l3_offset;
+	const uint8_t *tcp_a = ip_a + l3_len;
+	const uint8_t *tcp_b = ip_b + l3_len;
+
+	if (a->l3_offset != b->l3_offset || a->l4_offset != b->l4_offset ||
+	    a->hdr_len != b->hdr_len || a->ipv4 != b->ipv4)
+		return 0;
+
+	if (a->ipv4) {
+		if (memcmp(ip_a, ip_b, 2) || memcmp(ip_a + 6, ip_b + 6, 4) ||
+		    memcmp(ip_a + 12, ip_b + 12, l3_len - 12))
+			return 0;
+	} else {
+		if (memcmp(ip_a, ip_b, 4) ||
+		    memcmp(ip_a + 6, ip_b + 6, _ODP_IPV6HDR_LEN - 6))
+			return 0;
+	}
+
+	/* Ports, acknowledgment number, header length and options */
+	if (memcmp(tcp_a, tcp_b, 4) || memcmp(tcp_a + 8, tcp_b + 8, 5) ||
+	    memcmp(tcp_a + _ODP_TCPHDR_LEN, tcp_b + _ODP_TCPHDR_LEN,
+		   a->hdr_len - a->l4_offset - _ODP_TCPHDR_LEN))
+		return 0;
+
+	return 1;
+}
+
+/* Match L2 headers, which are not updated by coalescing */
+static int coalesce_l2_match(odp_packet_hdr_t *a, odp_packet_hdr_t *b,
+			     uint32_t len)
+{
+	uint32_t seg_len_a, seg_len_b;
+	const uint8_t *l2_a = packet_map(a, 0, &seg_len_a);
+	const uint8_t *l2_b = packet_map(b, 0, &seg_len_b);
+
+	return seg_len_a >= len && seg_len_b >= len &&
+	       memcmp(l2_a, l2_b, len) == 0;
+}
+
+static int coalesce_append(odp_packet_t *head, coalesce_flow_t *flow,
+			   odp_packet_t pkt, const l4_info_t *info,
+			   const uint8_t *ip)
+{
+	odp_packet_hdr_t *head_hdr = odp_packet_hdr(*head);
+	uint32_t head_len = head_hdr->frame_len;
+	uint32_t len = info->l3_offset + info->ip_len - info->hdr_len;
+	const uint8_t *tcp = ip + info->l4_offset - info->l3_offset;
+	uint8_t *head_tcp = packet_map(head_hdr, info->l4_offset, NULL);
+
+	/* PSH ends a flow */
+	if ((head_tcp[TCP_FLAGS_OFFSET] & TCP_FLAG_PSH) ||
+	    head_len - info->l3_offset + len > COALESCE_MAX_IP_LEN)
+		return -1;
+
+	if (odp_packet_extend_tail(head, len, NULL, NULL) < 0)
+		return -1;
+
+	head_hdr = odp_packet_hdr(*head);
+	(void)odp_packet_copy_from_pkt(*head, head_len, pkt, info->hdr_len,
+				       len);
+
+	/* Latest window and PSH flag */
+	head_tcp = packet_map(head_hdr, info->l4_offset, NULL);
+	memcpy(head_tcp + 14, tcp + 14, 2);
+	head_tcp[TCP_FLAGS_OFFSET] |= tcp[TCP_FLAGS_OFFSET] & TCP_FLAG_PSH;
+
+	flow->next_seq += len;
+	flow->merged = 1;
+
+	odp_packet_free(pkt);
+	return 0;
+}
+
+static void coalesce_flow_finish(odp_packet_t packets[],
+				 const coalesce_flow_t *flow)
+{
+	odp_packet_hdr_t *pkt_hdr;
+
+	if (!flow->merged)
+		return;
+
+	pkt_hdr = odp_packet_hdr(packets[flow->idx]);
+	l4_hdr_finish(pkt_hdr, &flow->info,
+		      packet_map(pkt_hdr, flow->info.l3_offset, NULL));
+}
+
+int pktin_tcp_coalesce(pktio_entry_t *entry ODP_UNUSED,
+		       odp_packet_t packets[], int num)
+{
+	coalesce_flow_t flow[COALESCE_MAX_FLOWS];
+	int num_flow = 0;
+	int num_out = 0;
+	int i, f;
+
+	for (i = 0; i < num; i++) {
+		odp_packet_t pkt = packets[i];
+		odp_packet_hdr_t *pkt_hdr = odp_packet_hdr(pkt);
+		l4_info_t info;
+		const uint8_t *ip = NULL;
+		uint32_t seq;
+		int ret;
+
+		packets[num_out] = pkt;
+
+		ret = coalesce_info_get(pkt_hdr, &info, &ip);
+		if (ret < 0) {
+			num_out++;
+			continue;
+		}
+
+		for (f = 0; f < num_flow; f++) {
+			odp_packet_hdr_t *head_hdr =
+				odp_packet_hdr(packets[flow[f].idx]);
+			const uint8_t *head_ip =
+				packet_map(head_hdr, info.l3_offset, NULL);
+
+			if (coalesce_flow_match(&flow[f].info, head_ip,
+						&info, ip) &&
+			    coalesce_l2_match(head_hdr, pkt_hdr,
+					      info.l3_offset))
+				break;
+		}
+
+		/* Other TCP packets end coalescing of their flow */
+		if (ret > 0) {
+			if (f < num_flow) {
+				coalesce_flow_finish(packets, &flow[f]);
+				flow[f] = flow[--num_flow];
+			}
+			num_out++;
+			continue;
+		}
+
+		seq = odp_be_to_cpu_32(((const _odp_tcphdr_t *)(const void *)
+					(ip + info.l4_offset -
+					 info.l3_offset))->seq_no);
+
+		if (f < num_flow && seq == flow[f].next_seq &&
+		    coalesce_append(&packets[flow[f].idx], &flow[f], pkt,
+				    &info, ip) == 0)
+			continue;
+
+		/* Start a new flow, or restart a flow which could not be
+		 * continued. When the table is full, the flow to replace is
+		 * picked round robin by packet index. */
+		if (f == num_flow && num_flow < COALESCE_MAX_FLOWS) {
+			num_flow++;
+		} else {
+			if (f == num_flow)
+				f = i % COALESCE_MAX_FLOWS;
+			coalesce_flow_finish(packets, &flow[f]);
+		}
+
+		flow[f].idx = num_out;
+		flow[f].merged = 0;
+		flow[f].info = info;
+		flow[f].next_seq = seq + info.l3_offset + info.ip_len -
+				   info.hdr_len;
+		num_out++;
+	}
+
+	for (f = 0; f < num_flow; f++)
+		coalesce_flow_finish(packets, &flow[f]);
+
+	return num_out;
+}
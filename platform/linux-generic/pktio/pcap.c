@@ -252,7 +252,6 @@ static int pcapif_recv_pkt(pktio_entry_t *pktio_entry, int index ODP_UNUSED,
 			break;
 		}
 
-		packet_parse_l2(&pkt_hdr->p, pkt_len);
 		pktio_entry->s.stats.in_octets += pkt_hdr->frame_len;
 
 		packet_set_ts(pkt_hdr, ts);
@@ -266,6 +265,8 @@ static int pcapif_recv_pkt(pktio_entry_t *pktio_entry, int index ODP_UNUSED,
 
 	odp_ticketlock_unlock(&pktio_entry->s.rxl);
 
+	packet_parse_multi(pkts, i, pktio_entry->s.parse_layer);
+
 	return i;
 }
 
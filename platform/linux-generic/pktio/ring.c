@@ -83,62 +83,46 @@ static TAILQ_HEAD(, _ring) odp_ring_list;
 #define RING_VAL_IS_POWER_2(x) ((((x) - 1) & (x)) == 0)
 
 /*
- * the enqueue of pointers on the ring.
- */
-#define ENQUEUE_PTRS() do { \
-	const uint32_t size = r->prod.size; \
-	uint32_t idx = prod_head & mask; \
-	if (odp_likely(idx + n < size)) { \
-		for (i = 0; i < (n & ((~(unsigned)0x3))); i += 4, idx += 4) { \
-			r->ring[idx] = obj_table[i]; \
-			r->ring[idx + 1] = obj_table[i + 1]; \
-			r->ring[idx + 2] = obj_table[i + 2]; \
-			r->ring[idx + 3] = obj_table[i + 3]; \
-		} \
-		switch (n & 0x3) { \
-		case 3: \
-		r->ring[idx++] = obj_table[i++]; \
-		case 2: \
-		r->ring[idx++] = obj_table[i++]; \
-		case 1: \
-		r->ring[idx++] = obj_table[i++]; \
-		} \
-	} else { \
-		for (i = 0; idx < size; i++, idx++)\
-			r->ring[idx] = obj_table[i]; \
-		for (idx = 0; i < n; i++, idx++) \
-			r->ring[idx] = obj_table[i]; \
-	} \
-} while (0)
+ * Copy pointers into the ring. Contiguous runs are moved with memcpy(), which
+ * is vectorized by the C library, and a wrap-around is handled by splitting
+ * the copy in two.
+ */
+static inline void ring_copy_in(_ring_t *r, uint32_t prod_head,
+				void * const *obj_table, unsigned n)
+{
+	const uint32_t size = r->prod.size;
+	uint32_t idx = prod_head & r->prod.mask;
+
+	if (odp_likely(idx + n <= size)) {
+		memcpy(&r->ring[idx], obj_table, n * sizeof(void *));
+	} else {
+		unsigned first = size - idx;
+
+		memcpy(&r->ring[idx], obj_table, first * sizeof(void *));
+		memcpy(&r->ring[0], &obj_table[first],
+		       (n - first) * sizeof(void *));
+	}
+}
 
 /*
- * the actual copy of pointers on the ring to obj_table.
- */
-#define DEQUEUE_PTRS() do { \
-	uint32_t idx = cons_head & mask; \
-	const uint32_t size = r->cons.size; \
-	if (odp_likely(idx + n < size)) { \
-		for (i = 0; i < (n & (~(unsigned)0x3)); i += 4, idx += 4) {\
-			obj_table[i] = r->ring[idx]; \
-			obj_table[i + 1] = r->ring[idx + 1]; \
-			obj_table[i + 2] = r->ring[idx + 2]; \
-			obj_table[i + 3] = r->ring[idx + 3]; \
-		} \
-		switch (n & 0x3) { \
-		case 3: \
-		obj_table[i++] = r->ring[idx++]; \
-		case 2: \
-		obj_table[i++] = r->ring[idx++]; \
-		case 1: \
-		obj_table[i++] = r->ring[idx++]; \
-		} \
-	} else { \
-		for (i = 0; idx < size; i++, idx++) \
-			obj_table[i] = r->ring[idx]; \
-		for (idx = 0; i < n; i++, idx++) \
-			obj_table[i] = r->ring[idx]; \
-	} \
-} while (0)
+ * Copy pointers from the ring to obj_table.
+ */
+static inline void ring_copy_out(_ring_t *r, uint32_t cons_head,
+				 void **obj_table, unsigned n)
+{
+	const uint32_t size = r->cons.size;
+	uint32_t idx = cons_head & r->cons.mask;
+
+	if (odp_likely(idx + n <= size)) {
+		memcpy(obj_table, &r->ring[idx], n * sizeof(void *));
+	} else {
+		unsigned first = size - idx;
+
+		memcpy(obj_table, &r->ring[idx], first * sizeof(void *));
+		memcpy(&obj_table[first], &r->ring[0],
+		       (n - first) * sizeof(void *));
+	}
+}
 
 static odp_rwlock_t	qlock;	/* rings tailq lock */
 
@@ -164,6 +148,14 @@ _ring_create(const char *name, unsigned count, unsigned flags)
 	else
 		shm_flag = 0;
 
+	/* single and head/tail sync modes are exclusive */
+	if (((flags & _RING_F_SP_ENQ) && (flags & _RING_F_MP_HTS_ENQ)) ||
+	    ((flags & _RING_F_SC_DEQ) && (flags & _RING_F_MC_HTS_DEQ))) {
+		ODP_ERR("Conflicting ring sync mode flags 0x%x\n", flags);
+		__odp_errno = EINVAL;
+		return NULL;
+	}
+
 	/* count must be a power of 2 */
 	if (!RING_VAL_IS_POWER_2(count) || (count > _RING_SZ_MASK)) {
 		ODP_ERR("Requested size is invalid, must be power of 2,"
@@ -190,6 +182,8 @@ _ring_create(const char *name, unsigned count, unsigned flags)
 		r->prod.watermark = count;
 		r->prod.sp_enqueue = !!(flags & _RING_F_SP_ENQ);
 		r->cons.sc_dequeue = !!(flags & _RING_F_SC_DEQ);
+		r->prod.hts_enqueue = !!(flags & _RING_F_MP_HTS_ENQ);
+		r->cons.hts_dequeue = !!(flags & _RING_F_MC_HTS_DEQ);
 		r->prod.size = count;
 		r->cons.size = count;
 		r->prod.mask = count - 1;
@@ -198,6 +192,8 @@ _ring_create(const char *name, unsigned count, unsigned flags)
 		r->cons.head = 0;
 		r->prod.tail = 0;
 		r->cons.tail = 0;
+		r->prod.cons_tail = 0;
+		r->cons.prod_tail = 0;
 
 		if (!(flags & _RING_NO_LIST))
 			TAILQ_INSERT_TAIL(&odp_ring_list, r, next);
@@ -244,6 +240,24 @@ int _ring_set_water_mark(_ring_t *r, unsigned count)
 	return 0;
 }
 
+/*
+ * Compute the return value of an enqueue from the number of free entries
+ * seen before it and the number of objects actually enqueued.
+ */
+static inline int ring_enqueue_ret(_ring_t *r, uint32_t free_entries,
+				   unsigned n,
+				   enum _ring_queue_behavior behavior)
+{
+	uint32_t mask = r->prod.mask;
+
+	/* if we exceed the watermark */
+	if (odp_unlikely(((mask + 1) - free_entries + n) > r->prod.watermark))
+		return (behavior == _RING_QUEUE_FIXED) ? -EDQUOT :
+			(int)(n | _RING_QUOT_EXCEED);
+
+	return (behavior == _RING_QUEUE_FIXED) ? 0 : (int)n;
+}
+
 /**
  * Enqueue several objects on the ring (multi-producers safe).
  */
@@ -254,7 +268,6 @@ int ___ring_mp_do_enqueue(_ring_t *r, void * const *obj_table,
 	uint32_t cons_tail, free_entries;
 	const unsigned max = n;
 	int success;
-	unsigned i;
 	uint32_t mask = r->prod.mask;
 	int ret;
 
@@ -292,15 +305,9 @@ int ___ring_mp_do_enqueue(_ring_t *r, void * const *obj_table,
 	} while (odp_unlikely(success == 0));
 
 	/* write entries in ring */
-	ENQUEUE_PTRS();
+	ring_copy_in(r, prod_head, obj_table, n);
 
-	/* if we exceed the watermark */
-	if (odp_unlikely(((mask + 1) - free_entries + n) > r->prod.watermark)) {
-		ret = (behavior == _RING_QUEUE_FIXED) ? -EDQUOT :
-				(int)(n | _RING_QUOT_EXCEED);
-	} else {
-		ret = (behavior == _RING_QUEUE_FIXED) ? 0 : n;
-	}
+	ret = ring_enqueue_ret(r, free_entries, n, behavior);
 
 	/*
 	 * If there are other enqueues in progress that preceded us,
@@ -317,23 +324,33 @@ int ___ring_mp_do_enqueue(_ring_t *r, void * const *obj_table,
 
 /**
  * Enqueue several objects on a ring (NOT multi-producers safe).
+ *
+ * The producer works against its cached copy of the consumer tail and reads
+ * the real one (a cache line owned by the consumer) only when the cached
+ * value makes the ring look full.
  */
 int ___ring_sp_do_enqueue(_ring_t *r, void * const *obj_table,
 			  unsigned n, enum _ring_queue_behavior behavior)
 {
-	uint32_t prod_head, cons_tail;
+	uint32_t prod_head;
 	uint32_t prod_next, free_entries;
-	unsigned i;
 	uint32_t mask = r->prod.mask;
-	int ret;
 
 	prod_head = r->prod.head;
-	cons_tail = r->cons.tail;
 	/* The subtraction is done between two unsigned 32bits value
 	 * (the result is always modulo 32 bits even if we have
 	 * prod_head > cons_tail). So 'free_entries' is always between 0
-	 * and size(ring)-1. */
-	free_entries = mask + cons_tail - prod_head;
+	 * and size(ring)-1, unless the cached tail is stale. */
+	free_entries = mask + r->prod.cons_tail - prod_head;
+
+	/* Refresh the cache also when it would trip the watermark, so that
+	 * -EDQUOT is not reported because of a stale tail */
+	if (odp_unlikely(n > free_entries || free_entries > mask ||
+			 (mask + 1) - free_entries + n > r->prod.watermark)) {
+		r->prod.cons_tail = __atomic_load_n(&r->cons.tail,
+						    __ATOMIC_ACQUIRE);
+		free_entries = mask + r->prod.cons_tail - prod_head;
+	}
 
 	/* check that we have enough room in ring */
 	if (odp_unlikely(n > free_entries)) {
@@ -350,19 +367,71 @@ int ___ring_sp_do_enqueue(_ring_t *r, void * const *obj_table,
 	r->prod.head = prod_next;
 
 	/* write entries in ring */
-	ENQUEUE_PTRS();
-
-	/* if we exceed the watermark */
-	if (odp_unlikely(((mask + 1) - free_entries + n) > r->prod.watermark)) {
-		ret = (behavior == _RING_QUEUE_FIXED) ? -EDQUOT :
-			(int)(n | _RING_QUOT_EXCEED);
-	} else {
-		ret = (behavior == _RING_QUEUE_FIXED) ? 0 : n;
-	}
+	ring_copy_in(r, prod_head, obj_table, n);
 
 	/* Release our entries and the memory they refer to */
 	__atomic_thread_fence(__ATOMIC_RELEASE);
 	r->prod.tail = prod_next;
+	return ring_enqueue_ret(r, free_entries, n, behavior);
+}
+
+/**
+ * Enqueue several objects on the ring (multi-producers safe, head/tail
+ * sync mode).
+ */
+int ___ring_hts_do_enqueue(_ring_t *r, void * const *obj_table,
+			   unsigned n, enum _ring_queue_behavior behavior)
+{
+	_ring_ht_t old, new;
+	uint32_t cons_tail, free_entries;
+	const unsigned max = n;
+	uint32_t mask = r->prod.mask;
+	int ret;
+
+	old.raw = __atomic_load_n(&r->prod.ht, __ATOMIC_ACQUIRE);
+
+	/* move prod.head atomically, only when no other enqueue is in
+	 * progress (head == tail) */
+	do {
+		/* Reset n to the initial burst count */
+		n = max;
+
+		while (odp_unlikely(old.head != old.tail)) {
+			odp_cpu_pause();
+			old.raw = __atomic_load_n(&r->prod.ht,
+						  __ATOMIC_ACQUIRE);
+		}
+
+		cons_tail = __atomic_load_n(&r->cons.tail, __ATOMIC_ACQUIRE);
+		free_entries = mask + cons_tail - old.head;
+
+		/* check that we have enough room in ring */
+		if (odp_unlikely(n > free_entries)) {
+			if (behavior == _RING_QUEUE_FIXED)
+				return -ENOBUFS;
+			/* No free entry available */
+			if (odp_unlikely(free_entries == 0))
+				return 0;
+
+			n = free_entries;
+		}
+
+		new.head = old.head + n;
+		new.tail = old.tail;
+	} while (odp_unlikely(!__atomic_compare_exchange_n(&r->prod.ht,
+							   &old.raw, new.raw,
+							   false,
+							   __ATOMIC_ACQUIRE,
+							   __ATOMIC_ACQUIRE)));
+
+	/* write entries in ring */
+	ring_copy_in(r, old.head, obj_table, n);
+
+	ret = ring_enqueue_ret(r, free_entries, n, behavior);
+
+	/* We own the producer side until the tail is moved, no need to
+	 * wait for preceding enqueues */
+	__atomic_store_n(&r->prod.tail, new.head, __ATOMIC_RELEASE);
 	return ret;
 }
 
@@ -377,8 +446,6 @@ int ___ring_mc_do_dequeue(_ring_t *r, void **obj_table,
 	uint32_t cons_next, entries;
 	const unsigned max = n;
 	int success;
-	unsigned i;
-	uint32_t mask = r->prod.mask;
 
 	/* move cons.head atomically */
 	do {
@@ -413,7 +480,7 @@ int ___ring_mc_do_dequeue(_ring_t *r, void **obj_table,
 	} while (odp_unlikely(success == 0));
 
 	/* copy in table */
-	DEQUEUE_PTRS();
+	ring_copy_out(r, cons_head, obj_table, n);
 
 	/*
 	 * If there are other dequeues in progress that preceded us,
@@ -431,22 +498,29 @@ int ___ring_mc_do_dequeue(_ring_t *r, void **obj_table,
 
 /**
  * Dequeue several objects from a ring (NOT multi-consumers safe).
+ *
+ * The consumer works against its cached copy of the producer tail and reads
+ * the real one only when the cached value makes the ring look empty.
  */
 int ___ring_sc_do_dequeue(_ring_t *r, void **obj_table,
 			  unsigned n, enum _ring_queue_behavior behavior)
 {
-	uint32_t cons_head, prod_tail;
+	uint32_t cons_head;
 	uint32_t cons_next, entries;
-	unsigned i;
-	uint32_t mask = r->prod.mask;
+	uint32_t mask = r->cons.mask;
 
 	cons_head = r->cons.head;
-	prod_tail = r->prod.tail;
 	/* The subtraction is done between two unsigned 32bits value
 	 * (the result is always modulo 32 bits even if we have
 	 * cons_head > prod_tail). So 'entries' is always between 0
-	 * and size(ring)-1. */
-	entries = prod_tail - cons_head;
+	 * and size(ring)-1, unless the cached tail is stale. */
+	entries = r->cons.prod_tail - cons_head;
+
+	if (odp_unlikely(n > entries || entries > mask)) {
+		r->cons.prod_tail = __atomic_load_n(&r->prod.tail,
+						    __ATOMIC_ACQUIRE);
+		entries = r->cons.prod_tail - cons_head;
+	}
 
 	if (n > entries) {
 		if (behavior == _RING_QUEUE_FIXED)
@@ -463,9 +537,64 @@ int ___ring_sc_do_dequeue(_ring_t *r, void **obj_table,
 	/* Acquire the pointers and the memory they refer to */
 	__atomic_thread_fence(__ATOMIC_ACQUIRE);
 	/* copy in table */
-	DEQUEUE_PTRS();
+	ring_copy_out(r, cons_head, obj_table, n);
+
+	/* Release the slots back to the producer */
+	__atomic_store_n(&r->cons.tail, cons_next, __ATOMIC_RELEASE);
+	return behavior == _RING_QUEUE_FIXED ? 0 : n;
+}
+
+/**
+ * Dequeue several objects from a ring (multi-consumers safe, head/tail
+ * sync mode).
+ */
+int ___ring_hts_do_dequeue(_ring_t *r, void **obj_table,
+			   unsigned n, enum _ring_queue_behavior behavior)
+{
+	_ring_ht_t old, new;
+	uint32_t prod_tail, entries;
+	const unsigned max = n;
+
+	old.raw = __atomic_load_n(&r->cons.ht, __ATOMIC_ACQUIRE);
+
+	/* move cons.head atomically, only when no other dequeue is in
+	 * progress (head == tail) */
+	do {
+		/* Restore n as it may change every loop */
+		n = max;
+
+		while (odp_unlikely(old.head != old.tail)) {
+			odp_cpu_pause();
+			old.raw = __atomic_load_n(&r->cons.ht,
+						  __ATOMIC_ACQUIRE);
+		}
+
+		prod_tail = __atomic_load_n(&r->prod.tail, __ATOMIC_ACQUIRE);
+		entries = prod_tail - old.head;
+
+		if (n > entries) {
+			if (behavior == _RING_QUEUE_FIXED)
+				return -ENOENT;
+			if (odp_unlikely(entries == 0))
+				return 0;
+
+			n = entries;
+		}
+
+		new.head = old.head + n;
+		new.tail = old.tail;
+	} while (odp_unlikely(!__atomic_compare_exchange_n(&r->cons.ht,
+							   &old.raw, new.raw,
+							   false,
+							   __ATOMIC_ACQUIRE,
+							   __ATOMIC_ACQUIRE)));
+
+	/* copy in table */
+	ring_copy_out(r, old.head, obj_table, n);
+
+	/* Release the slots back to the producers */
+	__atomic_store_n(&r->cons.tail, new.head, __ATOMIC_RELEASE);
 
-	r->cons.tail = cons_next;
 	return behavior == _RING_QUEUE_FIXED ? 0 : n;
 }
 
@@ -507,6 +636,52 @@ int _ring_sc_dequeue_bulk(_ring_t *r, void **obj_table, unsigned n)
 					 _RING_QUEUE_FIXED);
 }
 
+/**
+ * Enqueue several objects on the ring (head/tail sync mode).
+ */
+int _ring_hts_enqueue_bulk(_ring_t *r, void * const *obj_table,
+			   unsigned n)
+{
+	return ___ring_hts_do_enqueue(r, obj_table, n,
+				      _RING_QUEUE_FIXED);
+}
+
+/**
+ * Dequeue several objects from a ring (head/tail sync mode).
+ */
+int _ring_hts_dequeue_bulk(_ring_t *r, void **obj_table, unsigned n)
+{
+	return ___ring_hts_do_dequeue(r, obj_table, n,
+				      _RING_QUEUE_FIXED);
+}
+
+/**
+ * Enqueue several objects on a ring.
+ */
+int _ring_enqueue_bulk(_ring_t *r, void * const *obj_table,
+		       unsigned n)
+{
+	if (r->prod.sp_enqueue)
+		return _ring_sp_enqueue_bulk(r, obj_table, n);
+	else if (r->prod.hts_enqueue)
+		return _ring_hts_enqueue_bulk(r, obj_table, n);
+	else
+		return _ring_mp_enqueue_bulk(r, obj_table, n);
+}
+
+/**
+ * Dequeue several objects from a ring.
+ */
+int _ring_dequeue_bulk(_ring_t *r, void **obj_table, unsigned n)
+{
+	if (r->cons.sc_dequeue)
+		return _ring_sc_dequeue_bulk(r, obj_table, n);
+	else if (r->cons.hts_dequeue)
+		return _ring_hts_dequeue_bulk(r, obj_table, n);
+	else
+		return _ring_mc_dequeue_bulk(r, obj_table, n);
+}
+
 /**
  * Test if a ring is full.
  */
@@ -618,6 +793,16 @@ int _ring_sp_enqueue_burst(_ring_t *r, void * const *obj_table,
 					_RING_QUEUE_VARIABLE);
 }
 
+/**
+ * Enqueue several objects on the ring (head/tail sync mode).
+ */
+int _ring_hts_enqueue_burst(_ring_t *r, void * const *obj_table,
+			    unsigned n)
+{
+	return ___ring_hts_do_enqueue(r, obj_table, n,
+				      _RING_QUEUE_VARIABLE);
+}
+
 /**
  * Enqueue several objects on a ring.
  */
@@ -626,6 +811,8 @@ int _ring_enqueue_burst(_ring_t *r, void * const *obj_table,
 {
 	if (r->prod.sp_enqueue)
 		return _ring_sp_enqueue_burst(r, obj_table, n);
+	else if (r->prod.hts_enqueue)
+		return _ring_hts_enqueue_burst(r, obj_table, n);
 	else
 		return _ring_mp_enqueue_burst(r, obj_table, n);
 }
@@ -648,6 +835,15 @@ int _ring_sc_dequeue_burst(_ring_t *r, void **obj_table, unsigned n)
 					 _RING_QUEUE_VARIABLE);
 }
 
+/**
+ * Dequeue several objects from a ring (head/tail sync mode).
+ */
+int _ring_hts_dequeue_burst(_ring_t *r, void **obj_table, unsigned n)
+{
+	return ___ring_hts_do_dequeue(r, obj_table, n,
+				      _RING_QUEUE_VARIABLE);
+}
+
 /**
  * Dequeue multiple objects from a ring up to a maximum number.
  */
@@ -655,6 +851,8 @@ int _ring_dequeue_burst(_ring_t *r, void **obj_table, unsigned n)
 {
 	if (r->cons.sc_dequeue)
 		return _ring_sc_dequeue_burst(r, obj_table, n);
+	else if (r->cons.hts_dequeue)
+		return _ring_hts_dequeue_burst(r, obj_table, n);
 	else
 		return _ring_mc_dequeue_burst(r, obj_table, n);
 }
@@ -694,25 +694,19 @@ static int sock_mmsg_recv(pktio_entry_t *pktio_entry, int index ODP_UNUSED,
 		struct iovec iovecs[ODP_PACKET_SOCKET_MAX_BURST_RX]
 				   [ODP_BUFFER_MAX_SEG];
 
-		for (i = 0; i < (int)len; i++) {
-			int num;
-
-			num = packet_alloc_multi(pkt_sock->pool, pkt_sock->mtu,
-						 &pkt_table[i], 1);
-			if (odp_unlikely(num != 1)) {
-				pkt_table[i] = ODP_PACKET_INVALID;
-				break;
-			}
+		/* number of successfully allocated pkt buffers */
+		msgvec_len = pktio_pkt_alloc(pktio_entry, pkt_sock->pool,
+					     pkt_sock->mtu, pkt_table, len);
+		if (odp_unlikely(msgvec_len < 0))
+			msgvec_len = 0;
 
+		for (i = 0; i < msgvec_len; i++) {
 			msgvec[i].msg_hdr.msg_iovlen =
 				_rx_pkt_to_iovec(pkt_table[i], iovecs[i]);
 
 			msgvec[i].msg_hdr.msg_iov = iovecs[i];
 		}
 
-		/* number of successfully allocated pkt buffers */
-		msgvec_len = i;
-
 		recv_msgs = recvmmsg(sockfd, msgvec, msgvec_len,
 				     MSG_DONTWAIT, NULL);
 
@@ -727,7 +721,8 @@ static int sock_mmsg_recv(pktio_entry_t *pktio_entry, int index ODP_UNUSED,
 			/* Don't receive packets sent by ourselves */
 			if (odp_unlikely(ethaddrs_equal(pkt_sock->if_mac,
 							eth_hdr->h_source))) {
-				odp_packet_free(pkt_table[i]);
+				pktio_pkt_recycle(pktio_entry,
+						  &pkt_table[i], 1);
 				continue;
 			}
 			pkt_hdr = odp_packet_hdr(pkt_table[i]);
@@ -735,7 +730,6 @@ static int sock_mmsg_recv(pktio_entry_t *pktio_entry, int index ODP_UNUSED,
 			odp_packet_pull_tail(pkt_table[i],
 					     odp_packet_len(pkt_table[i]) -
 					     msgvec[i].msg_len);
-			packet_parse_l2(&pkt_hdr->p, pkt_hdr->frame_len);
 			packet_set_ts(pkt_hdr, ts);
 			pkt_hdr->input = pktio_entry->s.handle;
 
@@ -744,8 +738,12 @@ static int sock_mmsg_recv(pktio_entry_t *pktio_entry, int index ODP_UNUSED,
 		}
 
 		/* Free unused pkt buffers */
-		for (; i < msgvec_len; i++)
-			odp_packet_free(pkt_table[i]);
+		if (i < msgvec_len)
+			pktio_pkt_recycle(pktio_entry, &pkt_table[i],
+					  msgvec_len - i);
+
+		packet_parse_multi(pkt_table, nb_rx,
+				   pktio_entry->s.parse_layer);
 	}
 
 	odp_ticketlock_unlock(&pktio_entry->s.rxl);
@@ -783,7 +781,7 @@ static int sock_mmsg_send(pktio_entry_t *pktio_entry, int index ODP_UNUSED,
 	struct iovec iovecs[ODP_PACKET_SOCKET_MAX_BURST_TX][ODP_BUFFER_MAX_SEG];
 	int ret;
 	int sockfd;
-	int n, i;
+	int i;
 
 	if (odp_unlikely(len > ODP_PACKET_SOCKET_MAX_BURST_TX))
 		return -1;
@@ -816,8 +814,7 @@ static int sock_mmsg_send(pktio_entry_t *pktio_entry, int index ODP_UNUSED,
 
 	odp_ticketlock_unlock(&pktio_entry->s.txl);
 
-	for (n = 0; n < i; ++n)
-		odp_packet_free(pkt_table[n]);
+	pktio_pkt_recycle(pktio_entry, pkt_table, i);
 
 	return i;
 }
@@ -877,6 +874,11 @@ static int sock_capability(pktio_entry_t *pktio_entry ODP_UNUSED,
 	odp_pktio_config_init(&capa->config);
 	capa->config.pktin.bit.ts_all = 1;
 	capa->config.pktin.bit.ts_ptp = 1;
+	capa->config.pktin.bit.tcp_coalesce = 1;
+	/* Time is read once per recvmmsg() call */
+	capa->config.pktin.bit.ts_batch = 1;
+	capa->config.pktout.bit.tcp_seg = 1;
+	capa->config.pktout.bit.udp_seg = 1;
 	return 0;
 }
 
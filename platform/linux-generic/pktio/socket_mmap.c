@@ -143,6 +143,71 @@ static uint8_t *pkt_mmap_vlan_insert(uint8_t *l2_hdr_ptr,
 	return l2_hdr_ptr;
 }
 
+static inline uint64_t pkt_mmap_kernel_ns(struct tpacket2_hdr *tp_h)
+{
+	return (uint64_t)tp_h->tp_sec * ODP_TIME_SEC_IN_NS + tp_h->tp_nsec;
+}
+
+/*
+ * Kernel timestamp of the newest frame ready in the ring, when scanning at
+ * most len frames from frame_num. The first frame must be ready.
+ */
+static inline uint64_t pkt_mmap_rx_last_ns(struct ring *ring,
+					   unsigned frame_num, unsigned len)
+{
+	struct tpacket2_hdr *last = ring->rd[frame_num].iov_base;
+	struct tpacket2_hdr *hdr;
+	unsigned i;
+
+	for (i = 1; i < len; i++) {
+		frame_num = (frame_num + 1) % ring->rd_num;
+		hdr = ring->rd[frame_num].iov_base;
+
+		if (!mmap_rx_kernel_ready(hdr))
+			break;
+
+		last = hdr;
+	}
+
+	return pkt_mmap_kernel_ns(last);
+}
+
+/*
+ * Receive timestamp of a frame. In batch mode time is read only for the first
+ * frame of a burst. Interpolation places frames before the time read by their
+ * kernel stamped distance from the newest frame of the burst, in nanoseconds
+ * without any division. Frames arriving during the burst get the time read.
+ */
+static inline odp_time_t pkt_mmap_rx_ts(odp_pktin_config_opt_t pktin,
+					struct ring *ring, unsigned frame_num,
+					unsigned len, int first,
+					odp_time_t *ts_burst, uint64_t *kts_last)
+{
+	struct tpacket2_hdr *tp_h = ring->rd[frame_num].iov_base;
+	uint64_t kts;
+
+	if (!pktin.bit.ts_batch)
+		return odp_time_global();
+
+	if (first) {
+		*ts_burst = odp_time_global();
+		if (pktin.bit.ts_interp)
+			*kts_last = pkt_mmap_rx_last_ns(ring, frame_num, len);
+	}
+
+	if (!pktin.bit.ts_interp)
+		return *ts_burst;
+
+	kts = pkt_mmap_kernel_ns(tp_h);
+
+	if (kts >= *kts_last ||
+	    *kts_last - kts > odp_time_to_ns(*ts_burst))
+		return *ts_burst;
+
+	return odp_time_diff(*ts_burst,
+			     odp_time_global_from_ns(*kts_last - kts));
+}
+
 static inline unsigned pkt_mmap_v2_rx(pktio_entry_t *pktio_entry,
 				      pkt_sock_mmap_t *pkt_sock,
 				      odp_packet_t pkt_table[], unsigned len,
@@ -150,7 +215,11 @@ static inline unsigned pkt_mmap_v2_rx(pktio_entry_t *pktio_entry,
 {
 	union frame_map ppd;
 	odp_time_t ts_val;
+	odp_time_t ts_burst = ODP_TIME_NULL;
 	odp_time_t *ts = NULL;
+	odp_pktin_config_opt_t pktin = pktio_entry->s.config.pktin;
+	uint64_t kts_last = 0;
+	int ts_first = 1;
 	unsigned frame_num, next_frame_num;
 	uint8_t *pkt_buf;
 	int pkt_len;
@@ -160,8 +229,7 @@ static inline unsigned pkt_mmap_v2_rx(pktio_entry_t *pktio_entry,
 	struct ring *ring;
 	int ret;
 
-	if (pktio_entry->s.config.pktin.bit.ts_all ||
-	    pktio_entry->s.config.pktin.bit.ts_ptp)
+	if (pktin.bit.ts_all || pktin.bit.ts_ptp)
 		ts = &ts_val;
 
 	ring  = &pkt_sock->rx_ring;
@@ -176,12 +244,16 @@ static inline unsigned pkt_mmap_v2_rx(pktio_entry_t *pktio_entry,
 		if (!mmap_rx_kernel_ready(ring->rd[frame_num].iov_base))
 			break;
 
-		if (ts != NULL)
-			ts_val = odp_time_global();
-
 		ppd.raw = ring->rd[frame_num].iov_base;
 		next_frame_num = (frame_num + 1) % ring->rd_num;
 
+		if (ts != NULL) {
+			ts_val = pkt_mmap_rx_ts(pktin, ring, frame_num,
+						len - i, ts_first, &ts_burst,
+						&kts_last);
+			ts_first = 0;
+		}
+
 		pkt_buf = (uint8_t *)ppd.raw + ppd.v2->tp_h.tp_mac;
 		pkt_len = ppd.v2->tp_h.tp_snaplen;
 
@@ -209,7 +281,8 @@ static inline unsigned pkt_mmap_v2_rx(pktio_entry_t *pktio_entry,
 			}
 		}
 
-		num = packet_alloc_multi(pool, pkt_len, &pkt_table[nb_rx], 1);
+		num = pktio_pkt_alloc(pktio_entry, pool, pkt_len,
+				      &pkt_table[nb_rx], 1);
 
 		if (odp_unlikely(num != 1)) {
 			pkt_table[nb_rx] = ODP_PACKET_INVALID;
@@ -230,8 +303,6 @@ static inline unsigned pkt_mmap_v2_rx(pktio_entry_t *pktio_entry,
 
 		if (pktio_cls_enabled(pktio_entry))
 			copy_packet_cls_metadata(&parsed_hdr, hdr);
-		else
-			packet_parse_l2(&hdr->p, pkt_len);
 
 		packet_set_ts(hdr, ts);
 
@@ -242,6 +313,11 @@ static inline unsigned pkt_mmap_v2_rx(pktio_entry_t *pktio_entry,
 	}
 
 	ring->frame_num = frame_num;
+
+	if (!pktio_cls_enabled(pktio_entry))
+		packet_parse_multi(pkt_table, nb_rx,
+				   pktio_entry->s.parse_layer);
+
 	return nb_rx;
 }
 
@@ -337,9 +413,6 @@ static inline unsigned pkt_mmap_v2_tx(int sock, struct ring *ring,
 		ring->frame_num = (first_frame_num + nb_tx) % frame_count;
 	}
 
-	for (i = 0; i < nb_tx; ++i)
-		odp_packet_free(pkt_table[i]);
-
 	return nb_tx;
 }
 
@@ -618,6 +691,10 @@ static int sock_mmap_send(pktio_entry_t *pktio_entry, int index ODP_UNUSED,
 			     pkt_table, len);
 	odp_ticketlock_unlock(&pktio_entry->s.txl);
 
+	/* Packet data was copied into the ring */
+	if (ret > 0)
+		pktio_pkt_recycle(pktio_entry, pkt_table, ret);
+
 	return ret;
 }
 
@@ -664,6 +741,11 @@ static int sock_mmap_capability(pktio_entry_t *pktio_entry ODP_UNUSED,
 	odp_pktio_config_init(&capa->config);
 	capa->config.pktin.bit.ts_all = 1;
 	capa->config.pktin.bit.ts_ptp = 1;
+	capa->config.pktin.bit.tcp_coalesce = 1;
+	capa->config.pktin.bit.ts_batch = 1;
+	capa->config.pktin.bit.ts_interp = 1;
+	capa->config.pktout.bit.tcp_seg = 1;
+	capa->config.pktout.bit.udp_seg = 1;
 	return 0;
 }
 
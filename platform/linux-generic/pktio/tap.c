@@ -22,6 +22,11 @@
  *
  *   iface   the name of TAP device to be created.
  *
+ * The device is created with IFF_MULTI_QUEUE when the kernel supports it.
+ * Each pktin queue then owns a tap queue (file descriptor) and the kernel
+ * spreads received flows over them. Frames are read and written directly
+ * from packet segments with readv()/writev().
+ *
  * TUN/TAP kernel module should be loaded to use this pktio.
  * There should be no device named 'iface' in the system.
  * The total length of the 'iface' is limited by IF_NAMESIZE.
@@ -37,6 +42,7 @@
 #include <sys/ioctl.h>
 #include <sys/socket.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <linux/if_tun.h>
 
 #include <odp_api.h>
@@ -44,8 +50,7 @@
 #include <odp_packet_internal.h>
 #include <odp_packet_io_internal.h>
 #include <odp_classification_internal.h>
-
-#define BUF_SIZE 65536
+#include <protocols/eth.h>
 
 static int gen_random_mac(unsigned char *mac)
 {
@@ -57,25 +62,16 @@ static int gen_random_mac(unsigned char *mac)
 	return 0;
 }
 
-static int tap_pktio_open(odp_pktio_t id ODP_UNUSED,
-			  pktio_entry_t *pktio_entry,
-			  const char *devname, odp_pool_t pool)
+/**
+ * Open a queue of tap device
+ *
+ * Creates the tap device when it does not exist yet, otherwise attaches
+ * a new queue to it. Returns nonblocking file descriptor or -1 on failure.
+ */
+static int tap_queue_open(const char *name, short tun_flags)
 {
-	int fd, skfd, flags;
-	uint32_t mtu;
+	int fd, flags;
 	struct ifreq ifr;
-	pkt_tap_t *tap = &pktio_entry->s.pkt_tap;
-
-	if (strncmp(devname, "tap:", 4) != 0)
-		return -1;
-
-	/* Init pktio entry */
-	memset(tap, 0, sizeof(*tap));
-	tap->fd = -1;
-	tap->skfd = -1;
-
-	if (pool == ODP_POOL_INVALID)
-		return -1;
 
 	fd = open("/dev/net/tun", O_RDWR);
 	if (fd < 0) {
@@ -85,19 +81,13 @@ static int tap_pktio_open(odp_pktio_t id ODP_UNUSED,
 	}
 
 	memset(&ifr, 0, sizeof(ifr));
-	/* Flags: IFF_TUN   - TUN device (no Ethernet headers)
-	 *        IFF_TAP   - TAP device
-	 *
-	 *        IFF_NO_PI - Do not provide packet information
-	 */
-	ifr.ifr_flags = IFF_TAP | IFF_NO_PI;
-	snprintf(ifr.ifr_name, IF_NAMESIZE, "%s", devname + 4);
+	ifr.ifr_flags = tun_flags;
+	snprintf(ifr.ifr_name, IF_NAMESIZE, "%s", name);
 
 	if (ioctl(fd, TUNSETIFF, (void *)&ifr) < 0) {
 		__odp_errno = errno;
-		ODP_ERR("%s: creating tap device failed: %s\n",
-			ifr.ifr_name, strerror(errno));
-		goto tap_err;
+		close(fd);
+		return -1;
 	}
 
 	/* Set nonblocking mode on interface. */
@@ -105,15 +95,70 @@ static int tap_pktio_open(odp_pktio_t id ODP_UNUSED,
 	if (flags < 0) {
 		__odp_errno = errno;
 		ODP_ERR("fcntl(F_GETFL) failed: %s\n", strerror(errno));
-		goto tap_err;
+		close(fd);
+		return -1;
 	}
 
 	if (fcntl(fd, F_SETFL, flags | O_NONBLOCK) < 0) {
 		__odp_errno = errno;
 		ODP_ERR("fcntl(F_SETFL) failed: %s\n", strerror(errno));
+		close(fd);
+		return -1;
+	}
+
+	return fd;
+}
+
+static int tap_pktio_open(odp_pktio_t id ODP_UNUSED,
+			  pktio_entry_t *pktio_entry,
+			  const char *devname, odp_pool_t pool)
+{
+	int fd, skfd;
+	uint32_t mtu;
+	unsigned i;
+	struct ifreq ifr;
+	pkt_tap_t *tap = &pktio_entry->s.pkt_tap;
+
+	if (strncmp(devname, "tap:", 4) != 0)
+		return -1;
+
+	/* Init pktio entry */
+	memset(tap, 0, sizeof(*tap));
+	for (i = 0; i < TAP_MAX_QUEUES; i++) {
+		tap->fd[i] = -1;
+		tap->rx_spare[i] = ODP_PACKET_INVALID;
+		odp_ticketlock_init(&tap->rx_lock[i]);
+		odp_ticketlock_init(&tap->tx_lock[i]);
+	}
+	tap->skfd = -1;
+
+	if (pool == ODP_POOL_INVALID)
+		return -1;
+
+	/* Flags: IFF_TUN   - TUN device (no Ethernet headers)
+	 *        IFF_TAP   - TAP device
+	 *
+	 *        IFF_NO_PI - Do not provide packet information
+	 *        IFF_MULTI_QUEUE - One file descriptor per queue
+	 *
+	 * Fall back to a single queue device on kernels without multi-queue
+	 * support.
+	 */
+	fd = tap_queue_open(devname + 4, IFF_TAP | IFF_NO_PI | IFF_MULTI_QUEUE);
+	if (fd >= 0)
+		tap->multi_queue = 1;
+	else if (__odp_errno == EINVAL)
+		fd = tap_queue_open(devname + 4, IFF_TAP | IFF_NO_PI);
+
+	if (fd < 0) {
+		ODP_ERR("%s: creating tap device failed: %s\n",
+			devname + 4, strerror(__odp_errno));
 		goto tap_err;
 	}
 
+	tap->fd[0] = fd;
+	tap->num_fds = 1;
+
 	if (gen_random_mac(tap->if_mac) < 0)
 		goto tap_err;
 
@@ -133,6 +178,9 @@ static int tap_pktio_open(odp_pktio_t id ODP_UNUSED,
 	}
 
 	/* Up interface by default. */
+	memset(&ifr, 0, sizeof(ifr));
+	snprintf(ifr.ifr_name, IF_NAMESIZE, "%s", devname + 4);
+
 	if (ioctl(skfd, SIOCGIFFLAGS, &ifr) < 0) {
 		__odp_errno = errno;
 		ODP_ERR("ioctl(SIOCGIFFLAGS) failed: %s\n", strerror(errno));
@@ -148,7 +196,6 @@ static int tap_pktio_open(odp_pktio_t id ODP_UNUSED,
 		goto sock_err;
 	}
 
-	tap->fd = fd;
 	tap->skfd = skfd;
 	tap->mtu = mtu;
 	tap->pool = pool;
@@ -156,7 +203,10 @@ static int tap_pktio_open(odp_pktio_t id ODP_UNUSED,
 sock_err:
 	close(skfd);
 tap_err:
-	close(fd);
+	if (fd >= 0)
+		close(fd);
+	tap->fd[0] = -1;
+	tap->num_fds = 0;
 	ODP_ERR("Tap device alloc failed.\n");
 	return -1;
 }
@@ -164,12 +214,23 @@ tap_err:
 static int tap_pktio_close(pktio_entry_t *pktio_entry)
 {
 	int ret = 0;
+	unsigned i;
 	pkt_tap_t *tap = &pktio_entry->s.pkt_tap;
 
-	if (tap->fd != -1 && close(tap->fd) != 0) {
-		__odp_errno = errno;
-		ODP_ERR("close(tap->fd): %s\n", strerror(errno));
-		ret = -1;
+	for (i = 0; i < tap->num_fds; i++) {
+		if (tap->fd[i] != -1 && close(tap->fd[i]) != 0) {
+			__odp_errno = errno;
+			ODP_ERR("close(tap->fd[%u]): %s\n", i, strerror(errno));
+			ret = -1;
+		}
+		tap->fd[i] = -1;
+	}
+	tap->num_fds = 0;
+
+	for (i = 0; i < TAP_MAX_QUEUES; i++) {
+		if (tap->rx_spare[i] != ODP_PACKET_INVALID)
+			odp_packet_free(tap->rx_spare[i]);
+		tap->rx_spare[i] = ODP_PACKET_INVALID;
 	}
 
 	if (tap->skfd != -1 && close(tap->skfd) != 0) {
@@ -181,39 +242,118 @@ static int tap_pktio_close(pktio_entry_t *pktio_entry)
 	return ret;
 }
 
-static odp_packet_t pack_odp_pkt(pktio_entry_t *pktio_entry, const void *data,
-				 unsigned int len, odp_time_t *ts)
+static int tap_input_queues_config(pktio_entry_t *pktio_entry,
+				   const odp_pktin_queue_param_t *p)
+{
+	pkt_tap_t *tap = &pktio_entry->s.pkt_tap;
+	unsigned num_queues = p->num_queues ? p->num_queues : 1;
+	int fd;
+
+	/* Scheduler synchronizes input queue polls. Only single thread
+	 * at a time polls a queue */
+	if (pktio_entry->s.param.in_mode == ODP_PKTIN_MODE_SCHED)
+		tap->lockless_rx = 1;
+	else
+		tap->lockless_rx = (p->op_mode == ODP_PKTIO_OP_MT_UNSAFE);
+
+	/* Kernel spreads received flows over all attached queues. Keep
+	 * exactly one attached queue per pktin queue, so that no packets are
+	 * steered to a descriptor nobody polls. */
+	while (tap->num_fds > num_queues) {
+		tap->num_fds--;
+		close(tap->fd[tap->num_fds]);
+		tap->fd[tap->num_fds] = -1;
+	}
+
+	while (tap->num_fds < num_queues) {
+		fd = tap_queue_open(pktio_entry->s.name + 4,
+				    IFF_TAP | IFF_NO_PI | IFF_MULTI_QUEUE);
+		if (fd < 0) {
+			ODP_ERR("%s: attaching tap queue failed: %s\n",
+				pktio_entry->s.name + 4,
+				strerror(__odp_errno));
+			return -1;
+		}
+		tap->fd[tap->num_fds++] = fd;
+	}
+
+	return 0;
+}
+
+static int tap_output_queues_config(pktio_entry_t *pktio_entry,
+				    const odp_pktout_queue_param_t *p)
+{
+	pkt_tap_t *tap = &pktio_entry->s.pkt_tap;
+
+	tap->lockless_tx = (p->op_mode == ODP_PKTIO_OP_MT_UNSAFE);
+
+	return 0;
+}
+
+/**
+ * Fill I/O vector with packet segments
+ *
+ * Returns number of I/O vector entries used.
+ */
+static int tap_pkt_to_iovec(odp_packet_t pkt,
+			    struct iovec iovecs[ODP_BUFFER_MAX_SEG])
+{
+	uint32_t pkt_len = odp_packet_len(pkt);
+	uint32_t offset = 0;
+	uint32_t seg_len;
+	int iov_count = 0;
+
+	while (offset < pkt_len && iov_count < ODP_BUFFER_MAX_SEG) {
+		iovecs[iov_count].iov_base = odp_packet_offset(pkt, offset,
+							       &seg_len, NULL);
+		iovecs[iov_count].iov_len = seg_len;
+		iov_count++;
+		offset += seg_len;
+	}
+
+	return iov_count;
+}
+
+/**
+ * Finish a packet received directly into its segments
+ *
+ * Returns packet to be passed to application, or ODP_PACKET_INVALID when
+ * the packet was dropped.
+ */
+static odp_packet_t tap_pkt_finish(pktio_entry_t *pktio_entry,
+				   odp_packet_t pkt, uint32_t len,
+				   odp_time_t *ts)
 {
-	odp_packet_t pkt;
 	odp_packet_hdr_t *pkt_hdr;
 	odp_packet_hdr_t parsed_hdr;
-	int num;
+	odp_packet_t new_pkt;
+	odp_pool_t pool = pktio_entry->s.pkt_tap.pool;
+
+	odp_packet_pull_tail(pkt, odp_packet_len(pkt) - len);
 
 	if (pktio_cls_enabled(pktio_entry)) {
-		if (cls_classify_packet(pktio_entry, data, len, len,
-					&pktio_entry->s.pkt_tap.pool,
+		if (cls_classify_packet(pktio_entry, odp_packet_data(pkt),
+					len, odp_packet_seg_len(pkt), &pool,
 					&parsed_hdr)) {
+			odp_packet_free(pkt);
 			return ODP_PACKET_INVALID;
 		}
-	}
-
-	num = packet_alloc_multi(pktio_entry->s.pkt_tap.pool, len, &pkt, 1);
 
-	if (num != 1)
-		return ODP_PACKET_INVALID;
-
-	if (odp_packet_copy_from_mem(pkt, 0, len, data) < 0) {
-		ODP_ERR("failed to copy packet data\n");
-		odp_packet_free(pkt);
-		return ODP_PACKET_INVALID;
+		/* Classifier selected another pool, the only case
+		 * where data is copied */
+		if (pool != pktio_entry->s.pkt_tap.pool) {
+			new_pkt = odp_packet_copy(pkt, pool);
+			odp_packet_free(pkt);
+			if (new_pkt == ODP_PACKET_INVALID)
+				return ODP_PACKET_INVALID;
+			pkt = new_pkt;
+		}
 	}
 
 	pkt_hdr = odp_packet_hdr(pkt);
 
 	if (pktio_cls_enabled(pktio_entry))
 		copy_packet_cls_metadata(&parsed_hdr, pkt_hdr);
-	else
-		packet_parse_l2(&pkt_hdr->p, len);
 
 	packet_set_ts(pkt_hdr, ts);
 	pkt_hdr->input = pktio_entry->s.handle;
@@ -221,52 +361,99 @@ static odp_packet_t pack_odp_pkt(pktio_entry_t *pktio_entry, const void *data,
 	return pkt;
 }
 
-static int tap_pktio_recv(pktio_entry_t *pktio_entry, int index ODP_UNUSED,
+static int tap_pktio_recv(pktio_entry_t *pktio_entry, int index,
 			  odp_packet_t pkts[], int len)
 {
 	ssize_t retval;
-	int i;
-	uint8_t buf[BUF_SIZE];
+	int i, ret, num = 0, nb_rx = 0;
+	int iov_count;
+	struct iovec iovecs[ODP_BUFFER_MAX_SEG];
+	odp_packet_t pkt_table[QUEUE_MULTI_MAX];
 	pkt_tap_t *tap = &pktio_entry->s.pkt_tap;
+	uint32_t alloc_len = tap->mtu + _ODP_ETHHDR_LEN + _ODP_VLANHDR_LEN;
 	odp_time_t ts_val;
 	odp_time_t *ts = NULL;
+	int fd;
 
-	odp_ticketlock_lock(&pktio_entry->s.rxl);
+	if (odp_unlikely(len > QUEUE_MULTI_MAX))
+		len = QUEUE_MULTI_MAX;
+
+	if (!tap->lockless_rx)
+		odp_ticketlock_lock(&tap->rx_lock[index]);
+
+	fd = tap->fd[index];
 
 	if (pktio_entry->s.config.pktin.bit.ts_all ||
 	    pktio_entry->s.config.pktin.bit.ts_ptp)
 		ts = &ts_val;
 
-	for (i = 0; i < len; i++) {
+	/* Frames are read directly into packet segments. The first frame
+	 * goes into the spare packet of the queue, which an idle queue keeps
+	 * across polls. Packets for the rest of the burst are allocated only
+	 * after a frame has arrived. */
+	if (tap->rx_spare[index] == ODP_PACKET_INVALID &&
+	    pktio_pkt_alloc(pktio_entry, tap->pool, alloc_len,
+			    &tap->rx_spare[index], 1) != 1)
+		tap->rx_spare[index] = ODP_PACKET_INVALID;
+
+	if (tap->rx_spare[index] != ODP_PACKET_INVALID) {
+		pkt_table[0] = tap->rx_spare[index];
+		tap->rx_spare[index] = ODP_PACKET_INVALID;
+		num = 1;
+	}
+
+	for (i = 0; i < num; i++) {
+		iov_count = tap_pkt_to_iovec(pkt_table[i], iovecs);
+
 		do {
-			retval = read(tap->fd, buf, BUF_SIZE);
+			retval = readv(fd, iovecs, iov_count);
 		} while (retval < 0 && errno == EINTR);
 
-		if (ts != NULL)
-			ts_val = odp_time_global();
-
 		if (retval < 0) {
 			__odp_errno = errno;
 			break;
 		}
 
-		pkts[i] = pack_odp_pkt(pktio_entry, buf, retval, ts);
-		if (pkts[i] == ODP_PACKET_INVALID)
-			break;
+		if (i == 0 && len > 1) {
+			ret = pktio_pkt_alloc(pktio_entry, tap->pool, alloc_len,
+					      &pkt_table[1], len - 1);
+			if (ret > 0)
+				num += ret;
+		}
+
+		if (ts != NULL)
+			ts_val = odp_time_global();
+
+		pkts[nb_rx] = tap_pkt_finish(pktio_entry, pkt_table[i],
+					     retval, ts);
+		if (pkts[nb_rx] != ODP_PACKET_INVALID)
+			nb_rx++;
 	}
 
-	odp_ticketlock_unlock(&pktio_entry->s.rxl);
+	/* Keep one unused packet for the next poll */
+	if (i < num)
+		tap->rx_spare[index] = pkt_table[i++];
 
-	return i;
+	if (!tap->lockless_rx)
+		odp_ticketlock_unlock(&tap->rx_lock[index]);
+
+	if (i < num)
+		pktio_pkt_recycle(pktio_entry, &pkt_table[i], num - i);
+
+	if (!pktio_cls_enabled(pktio_entry))
+		packet_parse_multi(pkts, nb_rx, pktio_entry->s.parse_layer);
+
+	return nb_rx;
 }
 
-static int tap_pktio_send_lockless(pktio_entry_t *pktio_entry,
+static int tap_pktio_send_lockless(pktio_entry_t *pktio_entry, int fd,
 				   const odp_packet_t pkts[], int len)
 {
 	ssize_t retval;
-	int i, n;
+	int i;
+	int iov_count;
 	uint32_t pkt_len;
-	uint8_t buf[BUF_SIZE];
+	struct iovec iovecs[ODP_BUFFER_MAX_SEG];
 	pkt_tap_t *tap = &pktio_entry->s.pkt_tap;
 
 	for (i = 0; i < len; i++) {
@@ -280,19 +467,17 @@ static int tap_pktio_send_lockless(pktio_entry_t *pktio_entry,
 			break;
 		}
 
-		if (odp_packet_copy_to_mem(pkts[i], 0, pkt_len, buf) < 0) {
-			ODP_ERR("failed to copy packet data\n");
-			break;
-		}
+		/* Segments are written without copying */
+		iov_count = tap_pkt_to_iovec(pkts[i], iovecs);
 
 		do {
-			retval = write(tap->fd, buf, pkt_len);
+			retval = writev(fd, iovecs, iov_count);
 		} while (retval < 0 && errno == EINTR);
 
 		if (retval < 0) {
 			if (i == 0 && SOCK_ERR_REPORT(errno)) {
 				__odp_errno = errno;
-				ODP_ERR("write(): %s\n", strerror(errno));
+				ODP_ERR("writev(): %s\n", strerror(errno));
 				return -1;
 			}
 			break;
@@ -306,22 +491,28 @@ static int tap_pktio_send_lockless(pktio_entry_t *pktio_entry,
 		}
 	}
 
-	for (n = 0; n < i; n++)
-		odp_packet_free(pkts[n]);
+	pktio_pkt_recycle(pktio_entry, pkts, i);
 
 	return i;
 }
 
-static int tap_pktio_send(pktio_entry_t *pktio_entry, int index ODP_UNUSED,
+static int tap_pktio_send(pktio_entry_t *pktio_entry, int index,
 			  const odp_packet_t pkts[], int len)
 {
+	pkt_tap_t *tap = &pktio_entry->s.pkt_tap;
 	int ret;
 
-	odp_ticketlock_lock(&pktio_entry->s.txl);
+	/* A tap queue accepts writes from any number of threads, pktout
+	 * queues beyond the number of pktin queues share descriptors. */
+	if (!tap->lockless_tx)
+		odp_ticketlock_lock(&tap->tx_lock[index]);
 
-	ret = tap_pktio_send_lockless(pktio_entry, pkts, len);
+	ret = tap_pktio_send_lockless(pktio_entry,
+				      tap->fd[index % tap->num_fds],
+				      pkts, len);
 
-	odp_ticketlock_unlock(&pktio_entry->s.txl);
+	if (!tap->lockless_tx)
+		odp_ticketlock_unlock(&tap->tx_lock[index]);
 
 	return ret;
 }
@@ -357,18 +548,23 @@ static int tap_mac_addr_get(pktio_entry_t *pktio_entry, void *mac_addr)
 	return ETH_ALEN;
 }
 
-static int tap_capability(pktio_entry_t *pktio_entry ODP_UNUSED,
+static int tap_capability(pktio_entry_t *pktio_entry,
 			  odp_pktio_capability_t *capa)
 {
+	pkt_tap_t *tap = &pktio_entry->s.pkt_tap;
+
 	memset(capa, 0, sizeof(odp_pktio_capability_t));
 
-	capa->max_input_queues  = 1;
-	capa->max_output_queues = 1;
+	capa->max_input_queues  = tap->multi_queue ? TAP_MAX_QUEUES : 1;
+	capa->max_output_queues = TAP_MAX_QUEUES;
 	capa->set_op.op.promisc_mode = 1;
 
 	odp_pktio_config_init(&capa->config);
 	capa->config.pktin.bit.ts_all = 1;
 	capa->config.pktin.bit.ts_ptp = 1;
+	capa->config.pktin.bit.tcp_coalesce = 1;
+	capa->config.pktout.bit.tcp_seg = 1;
+	capa->config.pktout.bit.udp_seg = 1;
 	return 0;
 }
 
@@ -391,5 +587,7 @@ const pktio_if_ops_t tap_pktio_ops = {
 	.capability = tap_capability,
 	.pktin_ts_res = NULL,
 	.pktin_ts_from_ns = NULL,
-	.config = NULL
+	.config = NULL,
+	.input_queues_config = tap_input_queues_config,
+	.output_queues_config = tap_output_queues_config
 };
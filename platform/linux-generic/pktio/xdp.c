@@ -0,0 +1,1186 @@
+/* Copyright (c) 2017, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+/**
+ * @file
+ *
+ * AF_XDP pktio
+ *
+ * Interface name is "xdp:<ifname>" followed by optional ':' separated
+ * options:
+ *   mode=skb|drv	attach the XDP program in generic (skb) or native (drv)
+ *			mode. By default native mode is tried first.
+ *   zc=1		request zero-copy from the driver. Pool memory should
+ *			be huge page backed, as frames may cross pages.
+ *   steer=<type>	pass only frames of this ethertype to ODP, others go
+ *			to the kernel stack.
+ *   prog=0		do not attach the built-in XDP program. Without a
+ *			program nothing is received, the interface is output
+ *			only.
+ *
+ * The UMEM of each socket is the block memory of the packet pool. Free
+ * packets are posted to the fill ring so that the kernel writes frames
+ * directly into packet segments. Packets of the same pool are transmitted
+ * from their segments and freed on completion, packets of other pools are
+ * copied first. The kernel drops frames when the fill ring runs empty, so a
+ * pool smaller than XDP_ZC_POOL_MIN packets is not used as UMEM. An internal
+ * pool is created instead, and received frames are copied into packets of
+ * the pktio pool. One socket is bound per pktin/pktout queue. The built-in XDP
+ * program redirects each device rx queue to the socket of the same pktin
+ * queue, so input hashing is that of the device.
+ */
+
+#ifdef ODP_PKTIO_XDP
+
+#include <odp_posix_extensions.h>
+
+#include <odp_packet_io_internal.h>
+#include <odp_packet_xdp.h>
+#include <odp_packet_socket.h>
+#include <odp_pool_internal.h>
+#include <odp_debug_internal.h>
+#include <odp_classification_internal.h>
+#include <protocols/eth.h>
+
+#include <odp/api/byteorder.h>
+#include <odp/api/time.h>
+
+#include <errno.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <linux/bpf.h>
+#include <linux/ethtool.h>
+#include <linux/if_link.h>
+#include <linux/if_xdp.h>
+#include <linux/sockios.h>
+
+#ifndef AF_XDP
+#define AF_XDP 44
+#endif
+
+#ifndef SOL_XDP
+#define SOL_XDP 283
+#endif
+
+/** Number of descriptors in each ring of a socket */
+#define XDP_RING_SIZE 2048
+
+/** Smallest UMEM chunk accepted by the kernel */
+#define XDP_CHUNK_SIZE_MIN 2048
+
+/** Packets per fill ring refill and completion ring reap */
+#define XDP_BATCH 64
+
+/** Smallest pool used as UMEM */
+#define XDP_ZC_POOL_MIN 4096
+
+/** Number of packets in the internal UMEM pool */
+#define XDP_UMEM_POOL_NUM XDP_ZC_POOL_MIN
+
+/** Maximum number of tx kicks per send call */
+#define XDP_KICK_RETRIES (XDP_RING_SIZE / 32)
+
+static int disable_pktio; /** !0 this pktio disabled, 0 enabled */
+static int xdp_stats_reset(pktio_entry_t *pktio_entry);
+
+static inline int xdp_bpf(enum bpf_cmd cmd, union bpf_attr *attr)
+{
+	return syscall(__NR_bpf, cmd, attr, sizeof(*attr));
+}
+
+static inline uint32_t ring_load_acquire(uint32_t *idx)
+{
+	return __atomic_load_n(idx, __ATOMIC_ACQUIRE);
+}
+
+static inline void ring_store_release(uint32_t *idx, uint32_t val)
+{
+	__atomic_store_n(idx, val, __ATOMIC_RELEASE);
+}
+
+static int xdp_ring_map(int fd, xdp_ring_t *ring,
+			const struct xdp_ring_offset *off, size_t desc_size,
+			off_t pgoff)
+{
+	uint8_t *map;
+
+	ring->map_len = off->desc + XDP_RING_SIZE * desc_size;
+	map = mmap(NULL, ring->map_len, PROT_READ | PROT_WRITE,
+		   MAP_SHARED | MAP_POPULATE, fd, pgoff);
+	if (map == MAP_FAILED) {
+		__odp_errno = errno;
+		ODP_ERR("mmap(ring): %s\n", strerror(errno));
+		return -1;
+	}
+
+	ring->map = map;
+	ring->producer = (uint32_t *)(map + off->producer);
+	ring->consumer = (uint32_t *)(map + off->consumer);
+	ring->flags = (uint32_t *)(map + off->flags);
+	ring->desc = map + off->desc;
+	ring->mask = XDP_RING_SIZE - 1;
+
+	return 0;
+}
+
+static void xdp_ring_unmap(xdp_ring_t *ring)
+{
+	if (ring->map != NULL)
+		munmap(ring->map, ring->map_len);
+	ring->map = NULL;
+}
+
+/* Number of device rx queues, which AF_XDP sockets may bind to */
+static unsigned xdp_queues_get_fd(int fd, const char *name)
+{
+	struct ethtool_channels channels;
+	struct ifreq ifr;
+	unsigned num;
+
+	memset(&channels, 0, sizeof(channels));
+	channels.cmd = ETHTOOL_GCHANNELS;
+	snprintf(ifr.ifr_name, IF_NAMESIZE, "%s", name);
+	ifr.ifr_data = (void *)&channels;
+
+	if (ioctl(fd, SIOCETHTOOL, &ifr) < 0)
+		return 1;
+
+	num = channels.combined_count > channels.rx_count ?
+		channels.combined_count : channels.rx_count;
+
+	return num ? num : 1;
+}
+
+/*
+ * Place UMEM chunks over pool segments. The kernel writes a frame at
+ * XDP_PACKET_HEADROOM plus UMEM headroom from the chunk start, and at most
+ * up to the chunk end. Chunk size and headroom are selected so that the frame
+ * starts at the pool headroom of a segment and ends at the segment end.
+ * Chunks start before their segment, and unaligned chunk mode lets them
+ * start anywhere.
+ */
+static int xdp_umem_layout(pkt_xdp_t *pkt_xdp, odp_pool_t pool_hdl)
+{
+	pool_entry_t *pool = odp_pool_to_entry(pool_hdl);
+	uint32_t room, chunk_size, headroom;
+	uint64_t blk_len;
+
+	room = pool->s.seg_size - pool->s.headroom;
+
+	if (room + XDP_PACKET_HEADROOM > ODP_PAGE_SIZE) {
+		chunk_size = ODP_PAGE_SIZE;
+		headroom = 0;
+		room = ODP_PAGE_SIZE - XDP_PACKET_HEADROOM;
+	} else if (room + XDP_PACKET_HEADROOM < XDP_CHUNK_SIZE_MIN) {
+		chunk_size = XDP_CHUNK_SIZE_MIN;
+		headroom = XDP_CHUNK_SIZE_MIN - XDP_PACKET_HEADROOM - room;
+	} else {
+		chunk_size = room + XDP_PACKET_HEADROOM;
+		headroom = 0;
+	}
+
+	blk_len = pool->s.pool_mdata_addr - pool->s.pool_base_addr;
+
+	pkt_xdp->umem = pool->s.pool_base_addr;
+	pkt_xdp->umem_len = ODP_PAGE_SIZE_ROUNDUP(blk_len);
+	pkt_xdp->seg_size = pool->s.seg_size;
+	pkt_xdp->chunk_size = chunk_size;
+	pkt_xdp->umem_headroom = headroom;
+	pkt_xdp->frame_len = room;
+	pkt_xdp->fill_offset = (int64_t)pool->s.headroom -
+			       XDP_PACKET_HEADROOM - headroom;
+	pkt_xdp->num_slot = blk_len / pool->s.seg_size;
+
+	return 0;
+}
+
+static inline uint32_t xdp_slot_idx(pkt_xdp_t *pkt_xdp, uint64_t addr)
+{
+	return addr / pkt_xdp->seg_size;
+}
+
+static int xdp_xsk_open(pkt_xdp_t *pkt_xdp, struct xdp_xsk_t *xsk,
+			unsigned queue)
+{
+	struct xdp_umem_reg umem;
+	struct xdp_mmap_offsets off;
+	struct sockaddr_xdp sxdp;
+	socklen_t optlen;
+	int size = XDP_RING_SIZE;
+	int fd;
+
+	fd = socket(AF_XDP, SOCK_RAW, 0);
+	if (fd < 0) {
+		__odp_errno = errno;
+		ODP_ERR("socket(AF_XDP): %s\n", strerror(errno));
+		return -1;
+	}
+	xsk->fd = fd;
+
+	memset(&umem, 0, sizeof(umem));
+	umem.addr = (uintptr_t)pkt_xdp->umem;
+	umem.len = pkt_xdp->umem_len;
+	umem.chunk_size = pkt_xdp->chunk_size;
+	umem.headroom = pkt_xdp->umem_headroom;
+	umem.flags = XDP_UMEM_UNALIGNED_CHUNK_FLAG;
+
+	if (setsockopt(fd, SOL_XDP, XDP_UMEM_REG, &umem, sizeof(umem)) ||
+	    setsockopt(fd, SOL_XDP, XDP_UMEM_FILL_RING, &size, sizeof(size)) ||
+	    setsockopt(fd, SOL_XDP, XDP_UMEM_COMPLETION_RING, &size,
+		       sizeof(size)) ||
+	    setsockopt(fd, SOL_XDP, XDP_RX_RING, &size, sizeof(size)) ||
+	    setsockopt(fd, SOL_XDP, XDP_TX_RING, &size, sizeof(size))) {
+		__odp_errno = errno;
+		ODP_ERR("setsockopt(SOL_XDP): %s\n", strerror(errno));
+		return -1;
+	}
+
+	optlen = sizeof(off);
+	if (getsockopt(fd, SOL_XDP, XDP_MMAP_OFFSETS, &off, &optlen)) {
+		__odp_errno = errno;
+		ODP_ERR("getsockopt(XDP_MMAP_OFFSETS): %s\n", strerror(errno));
+		return -1;
+	}
+
+	if (xdp_ring_map(fd, &xsk->rx, &off.rx, sizeof(struct xdp_desc),
+			 XDP_PGOFF_RX_RING) ||
+	    xdp_ring_map(fd, &xsk->tx, &off.tx, sizeof(struct xdp_desc),
+			 XDP_PGOFF_TX_RING) ||
+	    xdp_ring_map(fd, &xsk->fill, &off.fr, sizeof(uint64_t),
+			 XDP_UMEM_PGOFF_FILL_RING) ||
+	    xdp_ring_map(fd, &xsk->comp, &off.cr, sizeof(uint64_t),
+			 XDP_UMEM_PGOFF_COMPLETION_RING))
+		return -1;
+
+	memset(&sxdp, 0, sizeof(sxdp));
+	sxdp.sxdp_family = AF_XDP;
+	sxdp.sxdp_ifindex = pkt_xdp->if_index;
+	sxdp.sxdp_queue_id = queue;
+	sxdp.sxdp_flags = pkt_xdp->bind_flags;
+
+	if (bind(fd, (struct sockaddr *)&sxdp, sizeof(sxdp))) {
+		__odp_errno = errno;
+		ODP_ERR("bind(AF_XDP) %s queue %u: %s\n", pkt_xdp->if_name,
+			queue, strerror(errno));
+		return -1;
+	}
+
+	xsk->fill_cnt = 0;
+	xsk->tx_cnt = 0;
+
+	return 0;
+}
+
+static void xdp_xsk_close(struct xdp_xsk_t *xsk)
+{
+	if (xsk->fd >= 0)
+		close(xsk->fd);
+	xsk->fd = -1;
+
+	xdp_ring_unmap(&xsk->rx);
+	xdp_ring_unmap(&xsk->tx);
+	xdp_ring_unmap(&xsk->fill);
+	xdp_ring_unmap(&xsk->comp);
+}
+
+/* Post free packets to the fill ring, up to the fill depth of the socket */
+static void xdp_fill(pktio_entry_t *pktio_entry, struct xdp_xsk_t *xsk)
+{
+	pkt_xdp_t *pkt_xdp = &pktio_entry->s.pkt_xdp;
+	odp_packet_t pkt[XDP_BATCH];
+	uint64_t *ring = xsk->fill.desc;
+	uint32_t prod = *xsk->fill.producer;
+	uint32_t fill_cnt = xsk->fill_cnt;
+	int i, num;
+
+	while (fill_cnt < pkt_xdp->fill_num) {
+		num = pkt_xdp->fill_num - fill_cnt;
+		if (num > XDP_BATCH)
+			num = XDP_BATCH;
+
+		num = pktio_pkt_alloc(pktio_entry, pkt_xdp->umem_pool,
+				      pkt_xdp->frame_len, pkt, num);
+		if (odp_unlikely(num <= 0))
+			break;
+
+		for (i = 0; i < num; i++) {
+			odp_packet_hdr_t *hdr = odp_packet_hdr(pkt[i]);
+			uint64_t blk = (uint8_t *)hdr->buf_hdr.addr[0] -
+				       pkt_xdp->umem;
+			int64_t addr = blk + pkt_xdp->fill_offset;
+
+			pkt_xdp->slot[xdp_slot_idx(pkt_xdp, blk)] = pkt[i];
+
+			/* Chunk of the first block would start before the
+			 * UMEM. Keep the packet in the slot table. */
+			if (odp_unlikely(addr < 0))
+				continue;
+
+			ring[prod++ & xsk->fill.mask] = addr;
+			fill_cnt++;
+		}
+	}
+
+	ring_store_release(xsk->fill.producer, prod);
+	xsk->fill_cnt = fill_cnt;
+
+	if (*xsk->fill.flags & XDP_RING_NEED_WAKEUP)
+		(void)recvfrom(xsk->fd, NULL, 0, MSG_DONTWAIT, NULL, NULL);
+}
+
+/* Free transmitted packets */
+static void xdp_complete(pktio_entry_t *pktio_entry, struct xdp_xsk_t *xsk)
+{
+	pkt_xdp_t *pkt_xdp = &pktio_entry->s.pkt_xdp;
+	odp_packet_t pkt[XDP_BATCH];
+	uint64_t *ring = xsk->comp.desc;
+	uint32_t prod = ring_load_acquire(xsk->comp.producer);
+	uint32_t cons = *xsk->comp.consumer;
+	uint32_t idx;
+	int i, num;
+
+	while (cons != prod) {
+		num = prod - cons;
+		if (num > XDP_BATCH)
+			num = XDP_BATCH;
+
+		for (i = 0; i < num; i++) {
+			idx = xdp_slot_idx(pkt_xdp, ring[cons++ &
+							 xsk->comp.mask]);
+			pkt[i] = pkt_xdp->slot[idx];
+			pkt_xdp->slot[idx] = ODP_PACKET_INVALID;
+		}
+
+		ring_store_release(xsk->comp.consumer, cons);
+		xsk->tx_cnt -= num;
+
+		pktio_pkt_recycle(pktio_entry, pkt, num);
+	}
+}
+
+/* Kick transmit until the kernel has consumed the tx ring. In copy mode
+ * each kick transmits a limited number of frames. */
+static void xdp_kick(struct xdp_xsk_t *xsk)
+{
+	int i;
+
+	for (i = 0; i < XDP_KICK_RETRIES; i++) {
+		if (!(__atomic_load_n(xsk->tx.flags, __ATOMIC_RELAXED) &
+		      XDP_RING_NEED_WAKEUP))
+			return;
+
+		if (ring_load_acquire(xsk->tx.consumer) == *xsk->tx.producer)
+			return;
+
+		if (sendto(xsk->fd, NULL, 0, MSG_DONTWAIT, NULL, 0) < 0 &&
+		    errno != EAGAIN && errno != EBUSY && errno != ENOBUFS)
+			return;
+	}
+}
+
+static int xdp_prog_attach(pkt_xdp_t *pkt_xdp, unsigned num_queues)
+{
+	struct bpf_insn insn[16];
+	union bpf_attr attr;
+	int jmp[2];
+	int i, n = 0, num_jmp = 0;
+	uint32_t queue;
+
+	memset(&attr, 0, sizeof(attr));
+	attr.map_type = BPF_MAP_TYPE_XSKMAP;
+	attr.key_size = sizeof(uint32_t);
+	attr.value_size = sizeof(uint32_t);
+	attr.max_entries = num_queues;
+	snprintf(attr.map_name, sizeof(attr.map_name), "odp_xsks");
+
+	pkt_xdp->map_fd = xdp_bpf(BPF_MAP_CREATE, &attr);
+	if (pkt_xdp->map_fd < 0) {
+		__odp_errno = errno;
+		ODP_ERR("bpf(BPF_MAP_CREATE): %s\n", strerror(errno));
+		return -1;
+	}
+
+	for (queue = 0; queue < num_queues; queue++) {
+		memset(&attr, 0, sizeof(attr));
+		attr.map_fd = pkt_xdp->map_fd;
+		attr.key = (uintptr_t)&queue;
+		attr.value = (uintptr_t)&pkt_xdp->xsk[queue].s.fd;
+
+		if (xdp_bpf(BPF_MAP_UPDATE_ELEM, &attr)) {
+			__odp_errno = errno;
+			ODP_ERR("bpf(BPF_MAP_UPDATE_ELEM): %s\n",
+				strerror(errno));
+			return -1;
+		}
+	}
+
+	memset(insn, 0, sizeof(insn));
+
+#define XDP_INSN(c, d, s, o, i) \
+	((struct bpf_insn){ .code = (c), .dst_reg = (d), .src_reg = (s), \
+			    .off = (o), .imm = (i) })
+
+	/* r6 = ctx */
+	insn[n++] = XDP_INSN(BPF_ALU64 | BPF_MOV | BPF_X, BPF_REG_6, BPF_REG_1,
+			     0, 0);
+
+	if (pkt_xdp->steer_type) {
+		/* if (data + ETH_HLEN > data_end) return XDP_PASS */
+		insn[n++] = XDP_INSN(BPF_LDX | BPF_MEM | BPF_W, BPF_REG_2,
+				     BPF_REG_6, offsetof(struct xdp_md, data),
+				     0);
+		insn[n++] = XDP_INSN(BPF_LDX | BPF_MEM | BPF_W, BPF_REG_3,
+				     BPF_REG_6,
+				     offsetof(struct xdp_md, data_end), 0);
+		insn[n++] = XDP_INSN(BPF_ALU64 | BPF_MOV | BPF_X, BPF_REG_4,
+				     BPF_REG_2, 0, 0);
+		insn[n++] = XDP_INSN(BPF_ALU64 | BPF_ADD | BPF_K, BPF_REG_4,
+				     0, 0, _ODP_ETHHDR_LEN);
+		jmp[num_jmp++] = n;
+		insn[n++] = XDP_INSN(BPF_JMP | BPF_JGT | BPF_X, BPF_REG_4,
+				     BPF_REG_3, 0, 0);
+
+		/* if (eth->type != steer_type) return XDP_PASS */
+		insn[n++] = XDP_INSN(BPF_LDX | BPF_MEM | BPF_H, BPF_REG_4,
+				     BPF_REG_2, offsetof(_odp_ethhdr_t, type),
+				     0);
+		jmp[num_jmp++] = n;
+		insn[n++] = XDP_INSN(BPF_JMP | BPF_JNE | BPF_K, BPF_REG_4, 0,
+				     0, odp_cpu_to_be_16(pkt_xdp->steer_type));
+	}
+
+	/* return bpf_redirect_map(xsks, rx_queue_index, XDP_PASS) */
+	insn[n++] = XDP_INSN(BPF_LDX | BPF_MEM | BPF_W, BPF_REG_2, BPF_REG_6,
+			     offsetof(struct xdp_md, rx_queue_index), 0);
+	insn[n++] = XDP_INSN(BPF_LD | BPF_DW | BPF_IMM, BPF_REG_1,
+			     BPF_PSEUDO_MAP_FD, 0, pkt_xdp->map_fd);
+	insn[n++] = XDP_INSN(0, 0, 0, 0, 0);
+	insn[n++] = XDP_INSN(BPF_ALU64 | BPF_MOV | BPF_K, BPF_REG_3, 0, 0,
+			     XDP_PASS);
+	insn[n++] = XDP_INSN(BPF_JMP | BPF_CALL, 0, 0, 0,
+			     BPF_FUNC_redirect_map);
+	insn[n++] = XDP_INSN(BPF_JMP | BPF_EXIT, 0, 0, 0, 0);
+
+	/* pass: return XDP_PASS. The verifier rejects unreachable code. */
+	if (num_jmp) {
+		for (i = 0; i < num_jmp; i++)
+			insn[jmp[i]].off = n - jmp[i] - 1;
+		insn[n++] = XDP_INSN(BPF_ALU64 | BPF_MOV | BPF_K, BPF_REG_0,
+				     0, 0, XDP_PASS);
+		insn[n++] = XDP_INSN(BPF_JMP | BPF_EXIT, 0, 0, 0, 0);
+	}
+
+#undef XDP_INSN
+
+	memset(&attr, 0, sizeof(attr));
+	attr.prog_type = BPF_PROG_TYPE_XDP;
+	attr.insns = (uintptr_t)insn;
+	attr.insn_cnt = n;
+	attr.license = (uintptr_t)"Dual BSD/GPL";
+	attr.expected_attach_type = BPF_XDP;
+	snprintf(attr.prog_name, sizeof(attr.prog_name), "odp_xsk");
+
+	pkt_xdp->prog_fd = xdp_bpf(BPF_PROG_LOAD, &attr);
+	if (pkt_xdp->prog_fd < 0) {
+		__odp_errno = errno;
+		ODP_ERR("bpf(BPF_PROG_LOAD): %s\n", strerror(errno));
+		return -1;
+	}
+
+	/* The program is detached when the link is closed */
+	memset(&attr, 0, sizeof(attr));
+	attr.link_create.prog_fd = pkt_xdp->prog_fd;
+	attr.link_create.target_ifindex = pkt_xdp->if_index;
+	attr.link_create.attach_type = BPF_XDP;
+	attr.link_create.flags = pkt_xdp->xdp_flags;
+
+	pkt_xdp->link_fd = xdp_bpf(BPF_LINK_CREATE, &attr);
+	if (pkt_xdp->link_fd < 0 && pkt_xdp->xdp_flags == 0) {
+		ODP_DBG("%s: native XDP failed, using generic XDP\n",
+			pkt_xdp->if_name);
+		attr.link_create.flags = XDP_FLAGS_SKB_MODE;
+		pkt_xdp->link_fd = xdp_bpf(BPF_LINK_CREATE, &attr);
+	}
+	if (pkt_xdp->link_fd < 0) {
+		__odp_errno = errno;
+		ODP_ERR("bpf(BPF_LINK_CREATE) %s: %s\n", pkt_xdp->if_name,
+			strerror(errno));
+		return -1;
+	}
+
+	return 0;
+}
+
+/* Close sockets and detach the program. Packets left in the kernel rings
+ * are freed. */
+static void xdp_close_sockets(pkt_xdp_t *pkt_xdp)
+{
+	unsigned i;
+
+	if (pkt_xdp->link_fd >= 0)
+		close(pkt_xdp->link_fd);
+	if (pkt_xdp->prog_fd >= 0)
+		close(pkt_xdp->prog_fd);
+	if (pkt_xdp->map_fd >= 0)
+		close(pkt_xdp->map_fd);
+	pkt_xdp->link_fd = -1;
+	pkt_xdp->prog_fd = -1;
+	pkt_xdp->map_fd = -1;
+
+	for (i = 0; i < PKTIO_MAX_QUEUES; i++)
+		xdp_xsk_close(&pkt_xdp->xsk[i].s);
+	pkt_xdp->num_xsk = 0;
+
+	if (pkt_xdp->slot == NULL)
+		return;
+
+	for (i = 0; i < pkt_xdp->num_slot; i++) {
+		if (pkt_xdp->slot[i] != ODP_PACKET_INVALID) {
+			odp_packet_free(pkt_xdp->slot[i]);
+			pkt_xdp->slot[i] = ODP_PACKET_INVALID;
+		}
+	}
+}
+
+static int xdp_close(pktio_entry_t *pktio_entry)
+{
+	pkt_xdp_t *pkt_xdp = &pktio_entry->s.pkt_xdp;
+
+	xdp_close_sockets(pkt_xdp);
+
+	if (pkt_xdp->slot_shm != ODP_SHM_INVALID &&
+	    odp_shm_free(pkt_xdp->slot_shm))
+		ODP_ERR("xdp: slot table free failed\n");
+	pkt_xdp->slot_shm = ODP_SHM_INVALID;
+	pkt_xdp->slot = NULL;
+
+	if (pkt_xdp->umem_pool != ODP_POOL_INVALID &&
+	    pkt_xdp->umem_pool != pkt_xdp->pool &&
+	    odp_pool_destroy(pkt_xdp->umem_pool))
+		ODP_ERR("xdp: UMEM pool destroy failed\n");
+	pkt_xdp->umem_pool = ODP_POOL_INVALID;
+
+	if (pkt_xdp->sockfd != -1 && close(pkt_xdp->sockfd) != 0) {
+		__odp_errno = errno;
+		ODP_ERR("close(sockfd): %s\n", strerror(errno));
+		return -1;
+	}
+	pkt_xdp->sockfd = -1;
+
+	return 0;
+}
+
+static int xdp_parse_opts(pkt_xdp_t *pkt_xdp, const char *devname)
+{
+	char buf[PKTIO_NAME_LEN];
+	char *tok, *save = NULL;
+
+	snprintf(buf, sizeof(buf), "%s", devname);
+
+	tok = strtok_r(buf, ":", &save);
+	if (tok == NULL || strlen(tok) >= IF_NAMESIZE) {
+		ODP_ERR("xdp: bad interface name %s\n", devname);
+		return -1;
+	}
+	snprintf(pkt_xdp->if_name, sizeof(pkt_xdp->if_name), "%s", tok);
+
+	while ((tok = strtok_r(NULL, ":", &save)) != NULL) {
+		if (strcmp(tok, "mode=skb") == 0) {
+			pkt_xdp->xdp_flags = XDP_FLAGS_SKB_MODE;
+		} else if (strcmp(tok, "mode=drv") == 0) {
+			pkt_xdp->xdp_flags = XDP_FLAGS_DRV_MODE;
+		} else if (strncmp(tok, "zc=", 3) == 0) {
+			pkt_xdp->bind_flags &= ~(XDP_COPY | XDP_ZEROCOPY);
+			pkt_xdp->bind_flags |= atoi(tok + 3) ?
+					       XDP_ZEROCOPY : XDP_COPY;
+		} else if (strncmp(tok, "steer=", 6) == 0) {
+			pkt_xdp->steer_type = strtoul(tok + 6, NULL, 0);
+		} else if (strncmp(tok, "prog=", 5) == 0) {
+			pkt_xdp->builtin_prog = atoi(tok + 5) != 0;
+		} else {
+			ODP_ERR("xdp: unknown option %s\n", tok);
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+/* Select the pool under the UMEM */
+static int xdp_umem_pool_create(pkt_xdp_t *pkt_xdp)
+{
+	pool_entry_t *pool = odp_pool_to_entry(pkt_xdp->pool);
+	char pool_name[ODP_POOL_NAME_LEN];
+	odp_pool_param_t params;
+
+	if (pool->s.params.type != ODP_POOL_PACKET) {
+		ODP_ERR("xdp: not a packet pool\n");
+		return -1;
+	}
+
+	if (pool->s.params.pkt.num >= XDP_ZC_POOL_MIN) {
+		pkt_xdp->umem_pool = pkt_xdp->pool;
+		return 0;
+	}
+
+	params = pool->s.params;
+	params.pkt.num = XDP_UMEM_POOL_NUM;
+
+	snprintf(pool_name, sizeof(pool_name), "%s-%s", "xdp",
+		 pkt_xdp->if_name);
+	pkt_xdp->umem_pool = odp_pool_create(pool_name, &params);
+	if (pkt_xdp->umem_pool == ODP_POOL_INVALID) {
+		ODP_ERR("xdp: UMEM pool create failed\n");
+		return -1;
+	}
+
+	return 0;
+}
+
+static int xdp_open(odp_pktio_t id ODP_UNUSED, pktio_entry_t *pktio_entry,
+		    const char *devname, odp_pool_t pool)
+{
+	pkt_xdp_t *pkt_xdp = &pktio_entry->s.pkt_xdp;
+	char shm_name[ODP_SHM_NAME_LEN];
+	uint32_t mtu, i;
+
+	if (disable_pktio)
+		return -1;
+
+	if (strncmp(devname, "xdp:", 4) != 0)
+		return -1;
+
+	if (pool == ODP_POOL_INVALID)
+		return -1;
+
+	/* Init pktio entry */
+	memset(pkt_xdp, 0, sizeof(*pkt_xdp));
+	pkt_xdp->sockfd = -1;
+	pkt_xdp->map_fd = -1;
+	pkt_xdp->prog_fd = -1;
+	pkt_xdp->link_fd = -1;
+	pkt_xdp->slot_shm = ODP_SHM_INVALID;
+	pkt_xdp->pool = pool;
+	pkt_xdp->umem_pool = ODP_POOL_INVALID;
+	pkt_xdp->bind_flags = XDP_USE_NEED_WAKEUP | XDP_COPY;
+	pkt_xdp->builtin_prog = 1;
+
+	for (i = 0; i < PKTIO_MAX_QUEUES; i++) {
+		pkt_xdp->xsk[i].s.fd = -1;
+		odp_ticketlock_init(&pkt_xdp->xsk[i].s.rx_lock);
+		odp_ticketlock_init(&pkt_xdp->xsk[i].s.tx_lock);
+	}
+
+	if (xdp_parse_opts(pkt_xdp, devname + 4))
+		return -1;
+
+	pkt_xdp->if_index = if_nametoindex(pkt_xdp->if_name);
+	if (pkt_xdp->if_index == 0) {
+		__odp_errno = errno;
+		ODP_ERR("if_nametoindex(%s): %s\n", pkt_xdp->if_name,
+			strerror(errno));
+		return -1;
+	}
+
+	if (xdp_umem_pool_create(pkt_xdp) ||
+	    xdp_umem_layout(pkt_xdp, pkt_xdp->umem_pool))
+		goto error;
+
+	pkt_xdp->sockfd = socket(AF_INET, SOCK_DGRAM, 0);
+	if (pkt_xdp->sockfd == -1) {
+		ODP_ERR("Cannot get device control socket\n");
+		goto error;
+	}
+
+	if (mac_addr_get_fd(pkt_xdp->sockfd, pkt_xdp->if_name,
+			    pkt_xdp->if_mac))
+		goto error;
+
+	mtu = mtu_get_fd(pkt_xdp->sockfd, pkt_xdp->if_name);
+	if (mtu == 0) {
+		ODP_ERR("Unable to read interface MTU\n");
+		goto error;
+	}
+	mtu += _ODP_ETHHDR_LEN;
+	pkt_xdp->mtu = mtu < pkt_xdp->frame_len ? mtu : pkt_xdp->frame_len;
+
+	pkt_xdp->max_queues = xdp_queues_get_fd(pkt_xdp->sockfd,
+						pkt_xdp->if_name);
+	if (pkt_xdp->max_queues > PKTIO_MAX_QUEUES)
+		pkt_xdp->max_queues = PKTIO_MAX_QUEUES;
+
+	snprintf(shm_name, ODP_SHM_NAME_LEN, "%s-%s", "xdp_slot",
+		 pkt_xdp->if_name);
+	pkt_xdp->slot_shm = odp_shm_reserve(shm_name, pkt_xdp->num_slot *
+					    sizeof(odp_packet_t),
+					    ODP_CACHE_LINE_SIZE, 0);
+	if (pkt_xdp->slot_shm == ODP_SHM_INVALID) {
+		ODP_ERR("xdp: slot table reserve failed\n");
+		goto error;
+	}
+	pkt_xdp->slot = odp_shm_addr(pkt_xdp->slot_shm);
+
+	for (i = 0; i < pkt_xdp->num_slot; i++)
+		pkt_xdp->slot[i] = ODP_PACKET_INVALID;
+
+	(void)xdp_stats_reset(pktio_entry);
+
+	return 0;
+
+error:
+	xdp_close(pktio_entry);
+	return -1;
+}
+
+static int xdp_start(pktio_entry_t *pktio_entry)
+{
+	pkt_xdp_t *pkt_xdp = &pktio_entry->s.pkt_xdp;
+	pool_entry_t *pool = odp_pool_to_entry(pkt_xdp->umem_pool);
+	odp_pktin_mode_t in_mode = pktio_entry->s.param.in_mode;
+	odp_pktout_mode_t out_mode = pktio_entry->s.param.out_mode;
+	unsigned num_in, num_xsk, i;
+
+	/* If no pktin/pktout queues have been configured. Configure one for
+	 * each direction. */
+	if (!pktio_entry->s.num_in_queue &&
+	    in_mode != ODP_PKTIN_MODE_DISABLED) {
+		odp_pktin_queue_param_t param;
+
+		odp_pktin_queue_param_init(&param);
+		param.num_queues = 1;
+		if (odp_pktin_queue_config(pktio_entry->s.handle, &param))
+			return -1;
+	}
+	if (!pktio_entry->s.num_out_queue &&
+	    out_mode == ODP_PKTOUT_MODE_DIRECT) {
+		odp_pktout_queue_param_t param;
+
+		odp_pktout_queue_param_init(&param);
+		param.num_queues = 1;
+		if (odp_pktout_queue_config(pktio_entry->s.handle, &param))
+			return -1;
+	}
+
+	num_in = pkt_xdp->builtin_prog ? pktio_entry->s.num_in_queue : 0;
+	num_xsk = pktio_entry->s.num_in_queue > pktio_entry->s.num_out_queue ?
+		  pktio_entry->s.num_in_queue : pktio_entry->s.num_out_queue;
+
+	if (pkt_xdp->num_xsk == num_xsk)
+		return 0;
+
+	xdp_close_sockets(pkt_xdp);
+
+	/* Leave most of the pool to the application */
+	pkt_xdp->fill_num = pool->s.params.pkt.num / (4 * num_xsk);
+	if (pkt_xdp->fill_num > XDP_RING_SIZE)
+		pkt_xdp->fill_num = XDP_RING_SIZE;
+	if (pkt_xdp->fill_num == 0)
+		pkt_xdp->fill_num = 1;
+
+	for (i = 0; i < num_xsk; i++) {
+		if (xdp_xsk_open(pkt_xdp, &pkt_xdp->xsk[i].s, i))
+			goto error;
+		pkt_xdp->num_xsk++;
+
+		if (i < num_in)
+			xdp_fill(pktio_entry, &pkt_xdp->xsk[i].s);
+	}
+
+	if (num_in && xdp_prog_attach(pkt_xdp, num_in))
+		goto error;
+
+	return 0;
+
+error:
+	xdp_close_sockets(pkt_xdp);
+	return -1;
+}
+
+static int xdp_stop(pktio_entry_t *pktio_entry ODP_UNUSED)
+{
+	return 0;
+}
+
+static int xdp_recv(pktio_entry_t *pktio_entry, int index,
+		    odp_packet_t pkt_table[], int num)
+{
+	pkt_xdp_t *pkt_xdp = &pktio_entry->s.pkt_xdp;
+	struct xdp_xsk_t *xsk = &pkt_xdp->xsk[index].s;
+	const struct xdp_desc *ring = xsk->rx.desc;
+	odp_time_t ts_val;
+	odp_time_t *ts = NULL;
+	uint32_t prod, cons, avail, i;
+	uint64_t octets = 0;
+	int nb_rx = 0;
+
+	if (odp_unlikely(pktio_entry->s.state != PKTIO_STATE_STARTED))
+		return 0;
+
+	if (pktio_entry->s.config.pktin.bit.ts_all ||
+	    pktio_entry->s.config.pktin.bit.ts_ptp)
+		ts = &ts_val;
+
+	if (!pkt_xdp->lockless_rx)
+		odp_ticketlock_lock(&xsk->rx_lock);
+
+	prod = ring_load_acquire(xsk->rx.producer);
+	cons = *xsk->rx.consumer;
+	avail = prod - cons;
+	if (avail > (uint32_t)num)
+		avail = num;
+
+	/* All frames of the burst arrived before the ring was read */
+	if (avail && ts != NULL)
+		ts_val = odp_time_global();
+
+	for (i = 0; i < avail; i++) {
+		const struct xdp_desc *desc = &ring[cons++ & xsk->rx.mask];
+		uint64_t addr = (desc->addr & XSK_UNALIGNED_BUF_ADDR_MASK) +
+				(desc->addr >> XSK_UNALIGNED_BUF_OFFSET_SHIFT);
+		uint32_t idx = xdp_slot_idx(pkt_xdp, addr);
+		uint32_t len = desc->len;
+		odp_packet_t pkt = pkt_xdp->slot[idx];
+		odp_packet_hdr_t *hdr = odp_packet_hdr(pkt);
+		odp_packet_hdr_t parsed_hdr;
+		odp_pool_t pool = pkt_xdp->pool;
+
+		pkt_xdp->slot[idx] = ODP_PACKET_INVALID;
+
+		/* Frame is in the first segment of the packet */
+		hdr->headroom = addr - (uint64_t)idx * pkt_xdp->seg_size;
+		hdr->frame_len = len;
+		hdr->tailroom = hdr->buf_hdr.segsize * hdr->buf_hdr.segcount -
+				hdr->headroom - len;
+
+		if (pktio_cls_enabled(pktio_entry) &&
+		    cls_classify_packet(pktio_entry, pkt_xdp->umem + addr,
+					len, len, &pool, &parsed_hdr)) {
+			pktio_pkt_recycle(pktio_entry, &pkt, 1);
+			xsk->in_discards++;
+			continue;
+		}
+
+		/* Frame is not in the destination pool */
+		if (pool != pkt_xdp->umem_pool) {
+			odp_packet_t new_pkt;
+
+			if (pktio_pkt_alloc(pktio_entry, pool, len,
+					    &new_pkt, 1) != 1 ||
+			    odp_packet_copy_from_mem(new_pkt, 0, len,
+						     pkt_xdp->umem + addr)) {
+				pktio_pkt_recycle(pktio_entry, &pkt, 1);
+				xsk->in_discards++;
+				continue;
+			}
+			pktio_pkt_recycle(pktio_entry, &pkt, 1);
+			pkt = new_pkt;
+			hdr = odp_packet_hdr(pkt);
+		}
+
+		if (pktio_cls_enabled(pktio_entry))
+			copy_packet_cls_metadata(&parsed_hdr, hdr);
+
+		hdr->input = pktio_entry->s.handle;
+		packet_set_ts(hdr, ts);
+
+		octets += len;
+		pkt_table[nb_rx++] = pkt;
+	}
+
+	ring_store_release(xsk->rx.consumer, cons);
+	xsk->fill_cnt -= avail;
+	xsk->in_octets += octets;
+	xsk->in_ucast_pkts += nb_rx;
+
+	xdp_fill(pktio_entry, xsk);
+
+	if (!pkt_xdp->lockless_rx)
+		odp_ticketlock_unlock(&xsk->rx_lock);
+
+	if (!pktio_cls_enabled(pktio_entry))
+		packet_parse_multi(pkt_table, nb_rx,
+				   pktio_entry->s.parse_layer);
+
+	return nb_rx;
+}
+
+static int xdp_send(pktio_entry_t *pktio_entry, int index,
+		    const odp_packet_t pkt_table[], int num)
+{
+	pkt_xdp_t *pkt_xdp = &pktio_entry->s.pkt_xdp;
+	struct xdp_xsk_t *xsk = &pkt_xdp->xsk[index].s;
+	struct xdp_desc *ring = xsk->tx.desc;
+	odp_packet_t copied[num];
+	uint32_t prod, free_num;
+	uint64_t octets = 0;
+	int i, num_copied = 0;
+
+	if (odp_unlikely(pktio_entry->s.state != PKTIO_STATE_STARTED))
+		return 0;
+
+	if (!pkt_xdp->lockless_tx)
+		odp_ticketlock_lock(&xsk->tx_lock);
+
+	xdp_complete(pktio_entry, xsk);
+
+	free_num = XDP_RING_SIZE - xsk->tx_cnt;
+	if ((uint32_t)num > free_num)
+		num = free_num;
+
+	prod = *xsk->tx.producer;
+
+	for (i = 0; i < num; i++) {
+		odp_packet_t pkt = pkt_table[i];
+		odp_packet_hdr_t *hdr = odp_packet_hdr(pkt);
+		uint32_t len = packet_len(hdr);
+		uint64_t addr;
+
+		if (odp_unlikely(len > pkt_xdp->mtu)) {
+			if (i == 0) {
+				__odp_errno = EMSGSIZE;
+				num = -1;
+			}
+			break;
+		}
+
+		addr = (uint8_t *)odp_packet_data(pkt) - pkt_xdp->umem;
+
+		/* Packets out of the UMEM, or not in one segment, are copied
+		 * into a packet of the UMEM pool. So are packets that share
+		 * their segment with another packet: the frame has a single
+		 * completion slot, which the other packet may already hold. */
+		if (odp_unlikely(hdr->buf_hdr.pool_hdl != pkt_xdp->umem_pool ||
+				 hdr->buf_hdr.segcount != 1 ||
+				 hdr->buf_hdr.flags.sharedseg ||
+				 addr >= pkt_xdp->umem_len ||
+				 pkt_xdp->slot[xdp_slot_idx(pkt_xdp, addr)] !=
+				 ODP_PACKET_INVALID)) {
+			odp_packet_t new_pkt;
+
+			if (pktio_pkt_alloc(pktio_entry, pkt_xdp->umem_pool,
+					    len, &new_pkt, 1) != 1)
+				break;
+
+			odp_packet_copy_to_mem(pkt, 0, len,
+					       odp_packet_data(new_pkt));
+			copied[num_copied++] = pkt;
+			pkt = new_pkt;
+			addr = (uint8_t *)odp_packet_data(pkt) - pkt_xdp->umem;
+		}
+
+		pkt_xdp->slot[xdp_slot_idx(pkt_xdp, addr)] = pkt;
+
+		ring[prod & xsk->tx.mask].addr = addr;
+		ring[prod & xsk->tx.mask].len = len;
+		ring[prod & xsk->tx.mask].options = 0;
+		prod++;
+
+		octets += len;
+	}
+
+	if (i) {
+		ring_store_release(xsk->tx.producer, prod);
+		xsk->tx_cnt += i;
+		xsk->out_octets += octets;
+		xsk->out_ucast_pkts += i;
+
+		xdp_kick(xsk);
+		xdp_complete(pktio_entry, xsk);
+	}
+
+	if (!pkt_xdp->lockless_tx)
+		odp_ticketlock_unlock(&xsk->tx_lock);
+
+	if (num_copied)
+		odp_packet_free_multi(copied, num_copied);
+
+	return num < 0 ? num : i;
+}
+
+static uint32_t xdp_mtu_get(pktio_entry_t *pktio_entry)
+{
+	return pktio_entry->s.pkt_xdp.mtu;
+}
+
+static int xdp_mac_addr_get(pktio_entry_t *pktio_entry, void *mac_addr)
+{
+	memcpy(mac_addr, pktio_entry->s.pkt_xdp.if_mac, ETH_ALEN);
+	return ETH_ALEN;
+}
+
+static int xdp_promisc_mode_set(pktio_entry_t *pktio_entry,
+				odp_bool_t enable)
+{
+	return promisc_mode_set_fd(pktio_entry->s.pkt_xdp.sockfd,
+				   pktio_entry->s.pkt_xdp.if_name, enable);
+}
+
+static int xdp_promisc_mode_get(pktio_entry_t *pktio_entry)
+{
+	return promisc_mode_get_fd(pktio_entry->s.pkt_xdp.sockfd,
+				   pktio_entry->s.pkt_xdp.if_name);
+}
+
+static int xdp_link_status(pktio_entry_t *pktio_entry)
+{
+	return link_status_fd(pktio_entry->s.pkt_xdp.sockfd,
+			      pktio_entry->s.pkt_xdp.if_name);
+}
+
+static int xdp_capability(pktio_entry_t *pktio_entry,
+			  odp_pktio_capability_t *capa)
+{
+	pkt_xdp_t *pkt_xdp = &pktio_entry->s.pkt_xdp;
+
+	memset(capa, 0, sizeof(odp_pktio_capability_t));
+
+	capa->max_input_queues  = pkt_xdp->max_queues;
+	capa->max_output_queues = pkt_xdp->max_queues;
+	capa->set_op.op.promisc_mode = 1;
+
+	odp_pktio_config_init(&capa->config);
+	capa->config.pktin.bit.ts_all = 1;
+	capa->config.pktin.bit.ts_ptp = 1;
+	return 0;
+}
+
+static int xdp_input_queues_config(pktio_entry_t *pktio_entry,
+				   const odp_pktin_queue_param_t *p)
+{
+	pkt_xdp_t *pkt_xdp = &pktio_entry->s.pkt_xdp;
+
+	/* Scheduler synchronizes input queue polls. Only single thread
+	 * at a time polls a queue */
+	if (pktio_entry->s.param.in_mode == ODP_PKTIN_MODE_SCHED)
+		pkt_xdp->lockless_rx = 1;
+	else
+		pkt_xdp->lockless_rx = (p->op_mode == ODP_PKTIO_OP_MT_UNSAFE);
+
+	/* Devices without configurable hashing (e.g. veth) still spread
+	 * flows over their rx queues */
+	if (p->hash_enable && p->num_queues > 1 &&
+	    rss_conf_set_fd(pkt_xdp->sockfd, pkt_xdp->if_name,
+			    &p->hash_proto))
+		ODP_DBG("%s: input hash not configured\n", pkt_xdp->if_name);
+
+	return 0;
+}
+
+static int xdp_output_queues_config(pktio_entry_t *pktio_entry,
+				    const odp_pktout_queue_param_t *p)
+{
+	pkt_xdp_t *pkt_xdp = &pktio_entry->s.pkt_xdp;
+
+	pkt_xdp->lockless_tx = (p->op_mode == ODP_PKTIO_OP_MT_UNSAFE);
+
+	return 0;
+}
+
+/* Frames dropped by the kernel for lack of fill or rx ring space */
+static uint64_t xdp_kernel_discards(struct xdp_xsk_t *xsk)
+{
+	struct xdp_statistics stats;
+	socklen_t optlen = sizeof(stats);
+
+	if (xsk->fd < 0 ||
+	    getsockopt(xsk->fd, SOL_XDP, XDP_STATISTICS, &stats, &optlen))
+		return 0;
+
+	return stats.rx_dropped + stats.rx_ring_full;
+}
+
+static int xdp_stats_reset(pktio_entry_t *pktio_entry)
+{
+	pkt_xdp_t *pkt_xdp = &pktio_entry->s.pkt_xdp;
+	unsigned i;
+
+	memset(&pktio_entry->s.stats, 0, sizeof(odp_pktio_stats_t));
+
+	for (i = 0; i < PKTIO_MAX_QUEUES; i++) {
+		struct xdp_xsk_t *xsk = &pkt_xdp->xsk[i].s;
+
+		xsk->in_octets = 0;
+		xsk->in_ucast_pkts = 0;
+		xsk->in_discards = 0;
+		xsk->out_octets = 0;
+		xsk->out_ucast_pkts = 0;
+		xsk->kernel_discards = xdp_kernel_discards(xsk);
+	}
+
+	return 0;
+}
+
+static int xdp_stats(pktio_entry_t *pktio_entry, odp_pktio_stats_t *stats)
+{
+	pkt_xdp_t *pkt_xdp = &pktio_entry->s.pkt_xdp;
+	unsigned i;
+
+	memcpy(stats, &pktio_entry->s.stats, sizeof(odp_pktio_stats_t));
+
+	for (i = 0; i < pkt_xdp->num_xsk; i++) {
+		struct xdp_xsk_t *xsk = &pkt_xdp->xsk[i].s;
+
+		stats->in_octets += xsk->in_octets;
+		stats->in_ucast_pkts += xsk->in_ucast_pkts;
+		stats->in_discards += xsk->in_discards +
+				      xdp_kernel_discards(xsk) -
+				      xsk->kernel_discards;
+		stats->out_octets += xsk->out_octets;
+		stats->out_ucast_pkts += xsk->out_ucast_pkts;
+	}
+
+	return 0;
+}
+
+static int xdp_init_global(void)
+{
+	if (getenv("ODP_PKTIO_DISABLE_XDP")) {
+		ODP_PRINT("PKTIO: AF_XDP pktio skipped,"
+			  " enabled export ODP_PKTIO_DISABLE_XDP=1.\n");
+		disable_pktio = 1;
+	} else  {
+		ODP_PRINT("PKTIO: initialized AF_XDP pktio,"
+			  " use export ODP_PKTIO_DISABLE_XDP=1 to disable.\n"
+			  " Interface names are xdp:eth0[:mode=skb|drv]"
+			  "[:zc=1][:steer=<ethertype>][:prog=0].\n");
+	}
+	return 0;
+}
+
+const pktio_if_ops_t xdp_pktio_ops = {
+	.name = "xdp",
+	.print = NULL,
+	.init_global = xdp_init_global,
+	.init_local = NULL,
+	.term = NULL,
+	.open = xdp_open,
+	.close = xdp_close,
+	.start = xdp_start,
+	.stop = xdp_stop,
+	.stats = xdp_stats,
+	.stats_reset = xdp_stats_reset,
+	.recv = xdp_recv,
+	.send = xdp_send,
+	.mtu_get = xdp_mtu_get,
+	.promisc_mode_set = xdp_promisc_mode_set,
+	.promisc_mode_get = xdp_promisc_mode_get,
+	.mac_get = xdp_mac_addr_get,
+	.link_status = xdp_link_status,
+	.capability = xdp_capability,
+	.pktin_ts_res = NULL,
+	.pktin_ts_from_ns = NULL,
+	.config = NULL,
+	.input_queues_config = xdp_input_queues_config,
+	.output_queues_config = xdp_output_queues_config,
+};
+
+#endif /* ODP_PKTIO_XDP */
@@ -20,6 +20,7 @@ extern "C" {
 
 #include <odp/api/spinlock.h>
 #include <odp/api/ticketlock.h>
+#include <odp/api/thread.h>
 #include <odp_classification_datamodel.h>
 #include <odp_align_internal.h>
 #include <odp_debug_internal.h>
@@ -33,6 +34,9 @@ extern "C" {
 #include <odp_packet_socket.h>
 #include <odp_packet_netmap.h>
 #include <odp_packet_tap.h>
+#include <odp_packet_mpcap.h>
+#include <odp_packet_xdp.h>
+#include <odp_packet_memif.h>
 #include <odp_packet_dpdk.h>
 /* MUSDK - start */
 #include <odp_packet_musdk.h>
@@ -53,9 +57,32 @@ extern "C" {
 /* Forward declaration */
 struct pktio_if_ops;
 
+/** Maximum number of "loop" device pktin/pktout queues */
+#define LOOP_MAX_QUEUES 16
+
+/** "loop" device queue */
+struct loop_queue_t {
+	_ring_t *ring;			/**< looped back packets (pktin) */
+	uint64_t octets;		/**< received/sent octets */
+	uint64_t ucast_pkts;		/**< received/sent packets */
+	uint64_t errors;		/**< dropped packets */
+	odp_ticketlock_t lock;		/**< queue lock */
+};
+
+typedef union {
+	struct loop_queue_t s;
+	uint8_t pad[ODP_CACHE_LINE_SIZE_ROUNDUP(sizeof(struct loop_queue_t))];
+} loop_queue_t ODP_ALIGNED_CACHE;
+
 typedef struct {
-	odp_queue_t loopq;		/**< loopback queue for "loop" device */
 	odp_bool_t promisc;		/**< promiscuous mode state */
+	odp_bool_t hash;		/**< spread packets by flow hash */
+	odp_bool_t lockless_rx;		/**< no locking for rx */
+	odp_bool_t lockless_tx;		/**< no locking for tx */
+	unsigned num_in_queues;		/**< number of pktin queues */
+	unsigned num_out_queues;	/**< number of pktout queues */
+	loop_queue_t rxq[LOOP_MAX_QUEUES];	/**< pktin queues */
+	loop_queue_t txq[LOOP_MAX_QUEUES];	/**< pktout queues */
 } pkt_loop_t;
 
 #ifdef HAVE_PCAP
@@ -137,6 +164,9 @@ struct pktio_entry {
 		pkt_pcap_t pkt_pcap;		/**< Using pcap for IO */
 #endif
 		pkt_tap_t pkt_tap;		/**< using TAP for IO */
+		pkt_mpcap_t pkt_mpcap;		/**< using mmapped pcap for IO */
+		pkt_xdp_t pkt_xdp;		/**< using AF_XDP for IO */
+		pkt_memif_t pkt_memif;		/**< using memif for IO */
 		_ipc_pktio_t ipc;		/**< IPC pktio data */
 	};
 	enum {
@@ -160,6 +190,11 @@ struct pktio_entry {
 		PKTIO_STATE_STOPPED
 	} state;
 	odp_pktio_config_t config;	/**< Device configuration */
+	layer_t parse_layer;		/**< Parse depth on packet input */
+	uint32_t seg_mtu;		/**< MTU of output segmentation */
+	uint32_t seg_min_len;		/**< Shortest packet which may need
+					 *   output segmentation
+					 */
 	classifier_t cls;		/**< classifier linked with this pktio*/
 	odp_pktio_stats_t stats;	/**< statistic counters for pktio */
 	enum {
@@ -189,6 +224,9 @@ struct pktio_entry {
 		odp_queue_t        queue;
 		odp_pktout_queue_t pktout;
 	} out_queue[PKTIO_MAX_QUEUES];
+
+	/* Per thread caches of transmitted buffers for packet input */
+	pool_recycle_t recycle[ODP_THREAD_COUNT_MAX];
 };
 
 typedef union {
@@ -218,6 +256,8 @@ typedef struct pktio_if_ops {
 	odp_time_t (*pktin_ts_from_ns)(pktio_entry_t *pktio_entry, uint64_t ns);
 	int (*recv)(pktio_entry_t *entry, int index, odp_packet_t packets[],
 		    int num);
+	int (*recv_tmo)(pktio_entry_t *entry, int index,
+			odp_packet_t packets[], int num, uint64_t wait);
 	int (*send)(pktio_entry_t *entry, int index,
 		    const odp_packet_t packets[], int num);
 	uint32_t (*mtu_get)(pktio_entry_t *pktio_entry);
@@ -266,6 +306,27 @@ static inline void pktio_cls_enabled_set(pktio_entry_t *entry, int ena)
 	entry->s.cls_enabled = ena;
 }
 
+/* Allocate packets for input, reusing buffers transmitted on the same
+ * pktio by this thread when allocating from the pktio pool */
+static inline int pktio_pkt_alloc(pktio_entry_t *entry, odp_pool_t pool,
+				  uint32_t len, odp_packet_t pkt[], int num)
+{
+	if (odp_unlikely(pool != entry->s.pool))
+		return packet_alloc_multi(pool, len, pkt, num);
+
+	return packet_alloc_recycle(&entry->s.recycle[odp_thread_id()], pool,
+				    len, pkt, num);
+}
+
+/* Free transmitted or unused input packets, keeping buffers of the pktio
+ * pool for packet input */
+static inline void pktio_pkt_recycle(pktio_entry_t *entry,
+				     const odp_packet_t pkt[], int num)
+{
+	packet_free_recycle(&entry->s.recycle[odp_thread_id()],
+			    entry->s.pool, pkt, num);
+}
+
 /*
  * Dummy single queue implementations of multi-queue API
  */
@@ -291,6 +352,9 @@ extern const pktio_if_ops_t loopback_pktio_ops;
 extern const pktio_if_ops_t pcap_pktio_ops;
 #endif
 extern const pktio_if_ops_t tap_pktio_ops;
+extern const pktio_if_ops_t mpcap_pktio_ops;
+extern const pktio_if_ops_t xdp_pktio_ops;
+extern const pktio_if_ops_t memif_pktio_ops;
 extern const pktio_if_ops_t ipc_pktio_ops;
 extern const pktio_if_ops_t * const pktio_if_ops[];
 
@@ -301,6 +365,11 @@ int sock_stats_fd(pktio_entry_t *pktio_entry,
 		  int fd);
 int sock_stats_reset_fd(pktio_entry_t *pktio_entry, int fd);
 
+/* Software TCP/UDP segmentation on output and TCP coalescing on input */
+int pktout_seg_send(pktio_entry_t *entry, int index,
+		    const odp_packet_t packets[], int num);
+int pktin_tcp_coalesce(pktio_entry_t *entry, odp_packet_t packets[], int num);
+
 #ifdef __cplusplus
 }
 #endif
@@ -32,6 +32,7 @@ m4_include([platform/linux-musdk/m4/odp_pthread.m4])
 m4_include([platform/linux-musdk/m4/odp_openssl.m4])
 m4_include([platform/linux-musdk/m4/odp_pcap.m4])
 m4_include([platform/linux-musdk/m4/odp_dpdk.m4])
+m4_include([platform/linux-musdk/m4/odp_xdp.m4])
 m4_include([platform/linux-musdk/m4/odp_mvpp2.m4])
 m4_include([platform/linux-musdk/m4/odp_mvsam.m4])
 m4_include([platform/linux-musdk/m4/odp_ipc.m4])
@@ -8,6 +8,16 @@ AC_ARG_ENABLE([dpdk_support],
         pktio_dpdk_support=yes
     fi])
 
+##########################################################################
+# Enable zero-copy DPDK pktio
+##########################################################################
+zero_copy=0
+AC_ARG_ENABLE([dpdk_zero_copy],
+    [  --enable-dpdk-zero-copy  enable zero-copy dpdk pktio mode],
+    [if test x$enableval = xyes; then
+        zero_copy=1
+    fi])
+
 ##########################################################################
 # Set optional DPDK path
 ##########################################################################
@@ -34,6 +44,10 @@ then
     AC_CHECK_HEADERS([rte_config.h], [],
         [AC_MSG_FAILURE(["can't find DPDK header"])])
     ODP_CFLAGS="$ODP_CFLAGS -DODP_PKTIO_DPDK"
+    if test x$zero_copy = x1
+    then
+        ODP_CFLAGS="$ODP_CFLAGS -DODP_DPDK_ZERO_COPY"
+    fi
 else
     pktio_dpdk_support=no
 fi
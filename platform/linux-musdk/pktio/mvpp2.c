@@ -711,11 +711,16 @@ static int mvpp2_recv(pktio_entry_t *pktio_entry,
 
 			odp_packet_reset(pkt, len);
 			/* TODO: set appropriate headroom */
-			packet_parse_l2(&pkt_hdr->p, len);
+			packet_parse_reset(pkt_hdr);
 
 #if defined(MVPP2_PKT_PARSE_SUPPORT) && (MVPP2_PKT_PARSE_SUPPORT == 1)
-			odp_packet_l3_offset_set(pkt, l3_offset);
-			if (odp_likely(l3_type)) {
+			/* Use HW parse results, other packets are parsed
+			 * in SW below */
+			if (odp_likely(l3_type) &&
+			    pktio_entry->s.parse_layer >= LAYER_L3) {
+				pkt_hdr->p.parsed_layers = LAYER_ALL;
+				packet_parse_l2(&pkt_hdr->p, len);
+				odp_packet_l3_offset_set(pkt, l3_offset);
 				if (l3_type < PP2_INQ_L3_TYPE_IPV4_TTL_ZERO)
 					odp_packet_has_ipv4_set(pkt, 1);
 				else
@@ -746,6 +751,8 @@ static int mvpp2_recv(pktio_entry_t *pktio_entry,
 	if (!inqs[rxq_id].lockless)
 		odp_ticketlock_unlock(&inqs[rxq_id].lock);
 
+	packet_parse_multi(pkt_table, total_got, pktio_entry->s.parse_layer);
+
 	return total_got;
 }
 
@@ -0,0 +1,298 @@
+/* Copyright (c) 2017, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:	BSD-3-Clause
+ */
+
+/**
+ * @file
+ *
+ * @example odp_cuckoo_perf.c  Cuckoo hash table insert and lookup rate
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif /* _GNU_SOURCE */
+
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+#include <stdio.h>
+#include <inttypes.h>
+
+#include <odp_api.h>
+#include <odp/helper/linux.h>
+#include <odph_cuckootable.h>
+
+#define app_err(fmt, ...) \
+	fprintf(stderr, "%s:%d:%s(): Error: " fmt, __FILE__, \
+		__LINE__, __func__, ##__VA_ARGS__)
+
+/** Keys per odph_cuckoo_table_get_value_bulk() call */
+#define BULK_SIZE 32
+
+/** Parsed command line arguments */
+typedef struct {
+	/** Number of inserted keys */
+	int num_keys;
+
+	/** Table capacity in MB */
+	int capacity;
+
+	/** Number of lookup rounds over all keys */
+	int rounds;
+} cuckoo_args_t;
+
+/** Flow table key: IPv4 5-tuple */
+typedef struct {
+	uint32_t src_ip;
+	uint32_t dst_ip;
+	uint16_t src_port;
+	uint16_t dst_port;
+	uint8_t  proto;
+	uint8_t  pad[3];
+} flow_key_t;
+
+static void parse_args(int argc, char *argv[], cuckoo_args_t *args);
+static void usage(char *progname);
+
+/* Prevent the compiler from dropping unused lookup results */
+static volatile uint64_t sink;
+
+static uint32_t rnd_state = 1;
+
+static uint32_t rnd(void)
+{
+	rnd_state ^= rnd_state << 13;
+	rnd_state ^= rnd_state >> 17;
+	rnd_state ^= rnd_state << 5;
+	return rnd_state;
+}
+
+static double ns_per(odp_time_t t1, odp_time_t t2, uint64_t num)
+{
+	return (double)odp_time_to_ns(odp_time_diff(t2, t1)) / num;
+}
+
+static int bench_cuckoo(const cuckoo_args_t *args)
+{
+	flow_key_t *keys;
+	uint32_t *order;
+	void *key[BULK_SIZE];
+	void *buf[BULK_SIZE];
+	uint64_t value[BULK_SIZE];
+	uint64_t val, hit_mask, sum = 0;
+	odph_table_t table;
+	odp_time_t t1, t2;
+	int i, j, r, tmp, num_ok = 0, num_hit = 0;
+
+	keys = malloc(args->num_keys * sizeof(flow_key_t));
+	order = malloc(args->num_keys * sizeof(uint32_t));
+	if (!keys || !order) {
+		app_err("malloc failed\n");
+		return -1;
+	}
+
+	table = odph_cuckoo_table_create("cuckoo_perf", args->capacity,
+					 sizeof(flow_key_t), sizeof(uint64_t));
+	if (table == NULL) {
+		app_err("table create failed\n");
+		return -1;
+	}
+
+	memset(keys, 0, args->num_keys * sizeof(flow_key_t));
+	for (i = 0; i < args->num_keys; i++) {
+		keys[i].src_ip = rnd();
+		keys[i].dst_ip = rnd();
+		keys[i].src_port = rnd();
+		keys[i].dst_port = 80;
+		keys[i].proto = 17;
+		order[i] = i;
+	}
+
+	t1 = odp_time_local();
+	for (i = 0; i < args->num_keys; i++) {
+		val = i;
+		num_ok += odph_cuckoo_table_put_value(table, &keys[i],
+						      &val) == 0;
+	}
+	t2 = odp_time_local();
+
+	printf("%8i keys inserted      %10.1f ns/key\n", num_ok,
+	       ns_per(t1, t2, args->num_keys));
+
+	/* Look up in random order, not in the insert order */
+	for (i = args->num_keys - 1; i > 0; i--) {
+		j = rnd() % (i + 1);
+		tmp = order[i];
+		order[i] = order[j];
+		order[j] = tmp;
+	}
+
+	t1 = odp_time_local();
+	for (r = 0; r < args->rounds; r++) {
+		for (i = 0; i < args->num_keys; i++) {
+			if (odph_cuckoo_table_get_value(table,
+							&keys[order[i]], &val,
+							sizeof(val)) == 0)
+				sum += val;
+		}
+	}
+	t2 = odp_time_local();
+	sink = sum;
+
+	printf("get_value                  %10.1f ns/key\n",
+	       ns_per(t1, t2, (uint64_t)args->rounds * args->num_keys));
+
+	for (j = 0; j < BULK_SIZE; j++)
+		buf[j] = &value[j];
+
+	t1 = odp_time_local();
+	for (r = 0; r < args->rounds; r++) {
+		for (i = 0; i + BULK_SIZE <= args->num_keys; i += BULK_SIZE) {
+			for (j = 0; j < BULK_SIZE; j++)
+				key[j] = &keys[order[i + j]];
+
+			num_hit += odph_cuckoo_table_get_value_bulk(table, key,
+								    buf,
+								    sizeof(val),
+								    BULK_SIZE,
+								    &hit_mask);
+		}
+	}
+	t2 = odp_time_local();
+	sink = value[0] + num_hit;
+
+	printf("get_value_bulk (%2i)        %10.1f ns/key\n", BULK_SIZE,
+	       ns_per(t1, t2, (uint64_t)args->rounds *
+		      (args->num_keys - args->num_keys % BULK_SIZE)));
+
+	t1 = odp_time_local();
+	for (i = 0; i < args->num_keys; i++)
+		odph_cuckoo_table_remove_value(table, &keys[i]);
+	t2 = odp_time_local();
+
+	printf("keys removed               %10.1f ns/key\n\n",
+	       ns_per(t1, t2, args->num_keys));
+
+	free(keys);
+	free(order);
+
+	return odph_cuckoo_table_destroy(table);
+}
+
+int main(int argc, char *argv[])
+{
+	cuckoo_args_t args;
+	odp_instance_t instance;
+	int ret = 0;
+
+	memset(&args, 0, sizeof(args));
+
+	/* Parse and store the application arguments */
+	parse_args(argc, argv, &args);
+
+	/* Init ODP before calling anything else */
+	if (odp_init_global(&instance, NULL, NULL)) {
+		app_err("ODP global init failed.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	/* Init this thread */
+	if (odp_init_local(instance, ODP_THREAD_CONTROL)) {
+		app_err("ODP local init failed.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	printf("\nCuckoo table performance, %i MB table, %i lookup rounds\n\n",
+	       args.capacity, args.rounds);
+
+	if (bench_cuckoo(&args))
+		ret = -1;
+
+	if (odp_term_local()) {
+		app_err("Error: term local\n");
+		exit(EXIT_FAILURE);
+	}
+
+	if (odp_term_global(instance)) {
+		app_err("Error: term global\n");
+		exit(EXIT_FAILURE);
+	}
+
+	return ret ? EXIT_FAILURE : 0;
+}
+
+static void parse_args(int argc, char *argv[], cuckoo_args_t *args)
+{
+	int opt;
+	int long_index;
+	static const struct option longopts[] = {
+		{"keys", required_argument, NULL, 'k'},
+		{"capacity", required_argument, NULL, 'c'},
+		{"rounds", required_argument, NULL, 'n'},
+		{"help", no_argument, NULL, 'h'},
+		{NULL, 0, NULL, 0}
+	};
+
+	static const char *shortopts = "+k:c:n:h";
+
+	/* let helper collect its own arguments (e.g. --odph_proc) */
+	odph_parse_options(argc, argv, shortopts, longopts);
+
+	args->num_keys = 100000;
+	args->capacity = 8;
+	args->rounds = 20;
+
+	opterr = 0; /* do not issue errors on helper options */
+
+	while (1) {
+		opt = getopt_long(argc, argv, shortopts, longopts, &long_index);
+
+		if (opt == -1)
+			break;	/* No more options */
+
+		switch (opt) {
+		case 'k':
+			args->num_keys = atoi(optarg);
+			break;
+		case 'c':
+			args->capacity = atoi(optarg);
+			break;
+		case 'n':
+			args->rounds = atoi(optarg);
+			break;
+		case 'h':
+			usage(argv[0]);
+			exit(EXIT_SUCCESS);
+			break;
+		default:
+			break;
+		}
+	}
+
+	optind = 1;		/* reset 'extern optind' from the getopt lib */
+
+	if (args->num_keys <= 0 || args->capacity <= 0 || args->rounds <= 0) {
+		usage(argv[0]);
+		exit(EXIT_FAILURE);
+	}
+}
+
+/**
+ * Print usage information
+ */
+static void usage(char *progname)
+{
+	printf("\n"
+	       "Usage: %s OPTIONS\n"
+	       "  E.g. %s -k 500000 -c 32\n"
+	       "\n"
+	       "OpenDataPlane cuckoo hash table measurement.\n"
+	       "Optional OPTIONS\n"
+	       "  -k, --keys <number>      Number of keys (default 100000)\n"
+	       "  -c, --capacity <number>  Table capacity in MB (default 8)\n"
+	       "  -n, --rounds <number>    Lookup rounds (default 20)\n"
+	       "  -h, --help               Display help and exit.\n"
+	       "\n", progname, progname);
+}
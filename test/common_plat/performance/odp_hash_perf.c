@@ -0,0 +1,332 @@
+/* Copyright (c) 2017, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:	BSD-3-Clause
+ */
+
+/**
+ * @file
+ *
+ * @example odp_hash_perf.c  Hash function throughput measurement
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif /* _GNU_SOURCE */
+
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+#include <stdio.h>
+#include <inttypes.h>
+
+#include <odp_api.h>
+#include <odp/helper/linux.h>
+
+#define app_err(fmt, ...) \
+	fprintf(stderr, "%s:%d:%s(): Error: " fmt, __FILE__, \
+		__LINE__, __func__, ##__VA_ARGS__)
+
+/** Maximum data length tested */
+#define MAX_DATA_LEN  (64 * 1024)
+
+/** Number of elements in an array */
+#define ARRAY_SIZE(x) (sizeof(x) / sizeof((x)[0]))
+
+/** Number of keys hashed per odp_hash_crc32c_multi() call */
+#define KEYS_PER_CALL 32
+
+/** Parsed command line arguments */
+typedef struct {
+	/** Number of iterations per measurement */
+	int iterations;
+
+	/** Data length to test. If 0, a set of predefined lengths is used. */
+	int data_len;
+} hash_args_t;
+
+/** Data lengths tested by default */
+static const uint32_t data_lens[] = {
+	4, 8, 12, 16, 32, 40, 64, 128, 256, 1024, 4096, 8192, 65536
+};
+
+/** Key lengths tested with the multi-key call */
+static const uint32_t key_lens[] = { 4, 8, 12, 16, 32, 40, 64 };
+
+static uint8_t data[MAX_DATA_LEN];
+
+static void parse_args(int argc, char *argv[], hash_args_t *args);
+static void usage(char *progname);
+
+/* Prevent the compiler from dropping unused hash results */
+static volatile uint32_t sink;
+
+static uint64_t iterations_for(const hash_args_t *args, uint32_t len)
+{
+	uint64_t num = (uint64_t)args->iterations * 64 / (len + 64);
+
+	return num ? num : 1;
+}
+
+static uint32_t hash_crc32c(const void *data, uint32_t len, uint32_t init)
+{
+	return odp_hash_crc32c(data, len, init);
+}
+
+static uint32_t hash_xxh32(const void *data, uint32_t len, uint32_t init)
+{
+	return odp_hash_xxh32(data, len, init);
+}
+
+static uint32_t hash_xxh64(const void *data, uint32_t len, uint32_t init)
+{
+	return (uint32_t)odp_hash_xxh64(data, len, init);
+}
+
+static uint32_t hash_jhash(const void *data, uint32_t len, uint32_t init)
+{
+	return odp_hash_jhash(data, len, init);
+}
+
+static uint32_t hash_toeplitz(const void *data, uint32_t len, uint32_t init)
+{
+	return odp_hash_toeplitz(data, len, NULL, 0) ^ init;
+}
+
+/** Single buffer hash functions under test */
+static const struct {
+	const char *name;
+	uint32_t (*fn)(const void *data, uint32_t len, uint32_t init);
+	/* Longest input measured, 0 for unlimited */
+	uint32_t max_len;
+} hash_fns[] = {
+	{"crc32c", hash_crc32c, 0},
+	{"xxh32", hash_xxh32, 0},
+	{"xxh64", hash_xxh64, 0},
+	{"jhash", hash_jhash, 0},
+	/* Toeplitz hashes packet tuples, IPv6 5-tuple is 36 bytes */
+	{"toeplitz", hash_toeplitz, 40},
+};
+
+static void measure_single(const hash_args_t *args, int fn, uint32_t len)
+{
+	uint64_t i, num, cycles, ns;
+	odp_time_t t1, t2;
+	uint64_t c1, c2;
+	uint32_t hash = 0;
+
+	if (hash_fns[fn].max_len && len > hash_fns[fn].max_len)
+		return;
+
+	num = iterations_for(args, len);
+
+	t1 = odp_time_local();
+	c1 = odp_cpu_cycles();
+
+	/* Chain results so that calls can not be overlapped or hoisted */
+	for (i = 0; i < num; i++)
+		hash = hash_fns[fn].fn(data, len, hash);
+
+	c2 = odp_cpu_cycles();
+	t2 = odp_time_local();
+
+	sink = hash;
+	cycles = odp_cpu_cycles_diff(c2, c1);
+	ns = odp_time_to_ns(odp_time_diff(t2, t1));
+
+	printf("%-13s %6" PRIu32 " B  %10.1f ns/call  %8.3f cycles/B"
+	       "  %9.1f MB/s\n", hash_fns[fn].name, len, (double)ns / num,
+	       (double)cycles / (num * len),
+	       ns ? (double)num * len * 1000 / ns : 0.0);
+}
+
+/** Multi-key hash functions under test, with single key equivalents */
+static const struct {
+	const char *name;
+	void (*multi)(const void *data[], uint32_t len, uint32_t init,
+		      uint32_t hash[], int num);
+	uint32_t (*single)(const void *data, uint32_t len, uint32_t init);
+} multi_fns[] = {
+	{"crc32c_multi", odp_hash_crc32c_multi, hash_crc32c},
+	{"xxh32_multi", odp_hash_xxh32_multi, hash_xxh32},
+};
+
+static void measure_multi(const hash_args_t *args, int fn, uint32_t len)
+{
+	const void *key[KEYS_PER_CALL];
+	uint32_t hash[KEYS_PER_CALL];
+	uint64_t i, num, ns_single, ns_multi;
+	odp_time_t t1, t2;
+	int j;
+
+	for (j = 0; j < KEYS_PER_CALL; j++) {
+		key[j] = &data[j * len];
+		hash[j] = 0;
+	}
+
+	num = iterations_for(args, len * KEYS_PER_CALL);
+
+	t1 = odp_time_local();
+
+	for (i = 0; i < num; i++) {
+		for (j = 0; j < KEYS_PER_CALL; j++)
+			hash[j] = multi_fns[fn].single(key[j], len, hash[j]);
+	}
+
+	t2 = odp_time_local();
+	ns_single = odp_time_to_ns(odp_time_diff(t2, t1));
+	sink = hash[0];
+
+	t1 = odp_time_local();
+
+	for (i = 0; i < num; i++) {
+		multi_fns[fn].multi(key, len, (uint32_t)i, hash,
+				    KEYS_PER_CALL);
+		sink = hash[KEYS_PER_CALL - 1];
+	}
+
+	t2 = odp_time_local();
+	ns_multi = odp_time_to_ns(odp_time_diff(t2, t1));
+
+	printf("%-13s %6" PRIu32 " B  %10.2f ns/key (loop)"
+	       "  %10.2f ns/key (multi)\n", multi_fns[fn].name, len,
+	       (double)ns_single / (num * KEYS_PER_CALL),
+	       (double)ns_multi / (num * KEYS_PER_CALL));
+}
+
+int main(int argc, char *argv[])
+{
+	hash_args_t args;
+	odp_instance_t instance;
+	unsigned int i, fn;
+
+	memset(&args, 0, sizeof(args));
+
+	/* Parse and store the application arguments */
+	parse_args(argc, argv, &args);
+
+	/* Init ODP before calling anything else */
+	if (odp_init_global(&instance, NULL, NULL)) {
+		app_err("ODP global init failed.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	/* Init this thread */
+	if (odp_init_local(instance, ODP_THREAD_CONTROL)) {
+		app_err("ODP local init failed.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	for (i = 0; i < sizeof(data); i++)
+		data[i] = (uint8_t)(i * 31 + (i >> 8));
+
+	printf("\nHash performance, %i iterations (scaled by length)\n\n",
+	       args.iterations);
+
+	for (fn = 0; fn < ARRAY_SIZE(hash_fns); fn++) {
+		if (args.data_len) {
+			measure_single(&args, fn, args.data_len);
+			continue;
+		}
+
+		for (i = 0; i < ARRAY_SIZE(data_lens); i++)
+			measure_single(&args, fn, data_lens[i]);
+
+		printf("\n");
+	}
+
+	for (fn = 0; fn < ARRAY_SIZE(multi_fns); fn++) {
+		if (args.data_len) {
+			if (args.data_len * KEYS_PER_CALL <= MAX_DATA_LEN)
+				measure_multi(&args, fn, args.data_len);
+			continue;
+		}
+
+		for (i = 0; i < ARRAY_SIZE(key_lens); i++)
+			measure_multi(&args, fn, key_lens[i]);
+
+		printf("\n");
+	}
+
+	if (odp_term_local()) {
+		app_err("Error: term local\n");
+		exit(EXIT_FAILURE);
+	}
+
+	if (odp_term_global(instance)) {
+		app_err("Error: term global\n");
+		exit(EXIT_FAILURE);
+	}
+
+	return 0;
+}
+
+static void parse_args(int argc, char *argv[], hash_args_t *args)
+{
+	int opt;
+	int long_index;
+	static const struct option longopts[] = {
+		{"iterations", required_argument, NULL, 'i'},
+		{"length", required_argument, NULL, 'l'},
+		{"help", no_argument, NULL, 'h'},
+		{NULL, 0, NULL, 0}
+	};
+
+	static const char *shortopts = "+i:l:h";
+
+	/* let helper collect its own arguments (e.g. --odph_proc) */
+	odph_parse_options(argc, argv, shortopts, longopts);
+
+	args->iterations = 100000;
+	args->data_len = 0;
+
+	opterr = 0; /* do not issue errors on helper options */
+
+	while (1) {
+		opt = getopt_long(argc, argv, shortopts, longopts, &long_index);
+
+		if (opt == -1)
+			break;	/* No more options */
+
+		switch (opt) {
+		case 'i':
+			args->iterations = atoi(optarg);
+			break;
+		case 'l':
+			args->data_len = atoi(optarg);
+			break;
+		case 'h':
+			usage(argv[0]);
+			exit(EXIT_SUCCESS);
+			break;
+		default:
+			break;
+		}
+	}
+
+	optind = 1;		/* reset 'extern optind' from the getopt lib */
+
+	if (args->iterations <= 0 || args->data_len < 0 ||
+	    args->data_len > MAX_DATA_LEN) {
+		usage(argv[0]);
+		exit(EXIT_FAILURE);
+	}
+}
+
+/**
+ * Print usage information
+ */
+static void usage(char *progname)
+{
+	printf("\n"
+	       "Usage: %s OPTIONS\n"
+	       "  E.g. %s -i 1000000\n"
+	       "\n"
+	       "OpenDataPlane hash function speed measure.\n"
+	       "Optional OPTIONS\n"
+	       "  -i, --iterations <number> Number of iterations (default 100000)\n"
+	       "  -l, --length <bytes>      Data length (default: a set of lengths,\n"
+	       "                            max %i)\n"
+	       "  -h, --help                Display help and exit.\n"
+	       "\n", progname, progname, MAX_DATA_LEN);
+}
@@ -0,0 +1,298 @@
+/* Copyright (c) 2017, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:	BSD-3-Clause
+ */
+
+/**
+ * @file
+ *
+ * @example odp_init_perf.c  ODP startup time measurement
+ *
+ * Measures the time taken by odp_init_global() and by the creation of
+ * packet pools of increasing size. After each pool is created, all of its
+ * packets are allocated and freed twice: the first round includes the cost
+ * of touching pool memory for the first time, the second round is the
+ * steady state. During the second round, the average cost of a handle to
+ * metadata lookup is measured over all packets of the pool.
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif /* _GNU_SOURCE */
+
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+#include <stdio.h>
+#include <inttypes.h>
+#include <time.h>
+
+#include <odp_api.h>
+#include <odp/helper/linux.h>
+
+#define app_err(fmt, ...) \
+	fprintf(stderr, "%s:%d:%s(): Error: " fmt, __FILE__, \
+		__LINE__, __func__, ##__VA_ARGS__)
+
+/** Packets per alloc and free call */
+#define BURST_SIZE 64
+
+/** Smallest pool size */
+#define MIN_POOL_SIZE 1024
+
+/** Parsed command line arguments */
+typedef struct {
+	/** Largest pool size in packets */
+	uint32_t max_num;
+	/** Packet length */
+	uint32_t pkt_len;
+} perf_args_t;
+
+static void parse_args(int argc, char *argv[], perf_args_t *args);
+static void usage(char *progname);
+
+/* odp_time is not available before odp_init_global() */
+static uint64_t time_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (uint64_t)ts.tv_sec * ODP_TIME_SEC_IN_NS + ts.tv_nsec;
+}
+
+/* Read metadata of all packets through their handles. Returns the average
+ * time per packet in nsec. */
+static double lookup_all(odp_packet_t pkt[], uint32_t num, uint32_t len)
+{
+	uint64_t start, sum = 0;
+	uint32_t i;
+
+	start = time_ns();
+	for (i = 0; i < num; i++)
+		sum += odp_packet_len(pkt[i]);
+
+	if (sum != (uint64_t)num * len)
+		app_err("bad packet length sum %" PRIu64 "\n", sum);
+
+	return (double)(time_ns() - start) / num;
+}
+
+/* Allocate all packets of the pool and free them. Returns the time taken,
+ * and optionally the average handle lookup time. */
+static int alloc_all(odp_pool_t pool, odp_packet_t pkt[], uint32_t num,
+		     uint32_t len, uint64_t *nsec, double *lookup_ns)
+{
+	uint64_t start = time_ns();
+	uint64_t lookup_start;
+	uint32_t i = 0, j;
+	int ret;
+
+	while (i < num) {
+		int burst = num - i < BURST_SIZE ? num - i : BURST_SIZE;
+
+		ret = odp_packet_alloc_multi(pool, len, &pkt[i], burst);
+		if (ret <= 0)
+			break;
+		i += ret;
+	}
+
+	if (lookup_ns != NULL && i == num) {
+		lookup_start = time_ns();
+		*lookup_ns = lookup_all(pkt, num, len);
+		/* Lookup is reported separately from alloc and free */
+		start += time_ns() - lookup_start;
+	}
+
+	/* Free in bursts, as a large burst would not fit in the stack */
+	for (j = 0; j < i; j += BURST_SIZE)
+		odp_packet_free_multi(&pkt[j], i - j < BURST_SIZE ?
+				      i - j : BURST_SIZE);
+	*nsec = time_ns() - start;
+
+	if (i != num) {
+		app_err("allocated %" PRIu32 " of %" PRIu32 " packets\n",
+			i, num);
+		return -1;
+	}
+
+	return 0;
+}
+
+static int run_pool(uint32_t num, uint32_t len)
+{
+	odp_pool_param_t params;
+	odp_pool_t pool;
+	odp_packet_t *pkt;
+	uint64_t create_ns, first_ns, second_ns, destroy_ns, start;
+	double lookup_ns = 0;
+	int ret;
+
+	pkt = malloc(num * sizeof(odp_packet_t));
+	if (pkt == NULL) {
+		app_err("malloc failed\n");
+		return -1;
+	}
+
+	odp_pool_param_init(&params);
+	params.type        = ODP_POOL_PACKET;
+	params.pkt.num     = num;
+	params.pkt.len     = len;
+	params.pkt.seg_len = len;
+
+	start = time_ns();
+	pool = odp_pool_create("init_perf", &params);
+	create_ns = time_ns() - start;
+
+	if (pool == ODP_POOL_INVALID) {
+		app_err("pool create failed, %" PRIu32 " packets\n", num);
+		free(pkt);
+		return -1;
+	}
+
+	ret = alloc_all(pool, pkt, num, len, &first_ns, NULL);
+	if (!ret)
+		ret = alloc_all(pool, pkt, num, len, &second_ns, &lookup_ns);
+
+	start = time_ns();
+	if (odp_pool_destroy(pool)) {
+		app_err("pool destroy failed\n");
+		ret = -1;
+	}
+	destroy_ns = time_ns() - start;
+
+	free(pkt);
+
+	if (ret)
+		return ret;
+
+	printf("%9" PRIu32 " %12.3f %12.3f %12.3f %12.3f %12.2f\n", num,
+	       create_ns / 1000000.0, first_ns / 1000000.0,
+	       second_ns / 1000000.0, destroy_ns / 1000000.0, lookup_ns);
+
+	return 0;
+}
+
+int main(int argc, char *argv[])
+{
+	perf_args_t args;
+	odp_instance_t instance;
+	uint64_t start, init_ns;
+	uint32_t num;
+	int ret = 0;
+
+	memset(&args, 0, sizeof(args));
+
+	/* Parse and store the application arguments */
+	parse_args(argc, argv, &args);
+
+	start = time_ns();
+
+	/* Init ODP before calling anything else */
+	if (odp_init_global(&instance, NULL, NULL)) {
+		app_err("ODP global init failed.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	init_ns = time_ns() - start;
+
+	/* Init this thread */
+	if (odp_init_local(instance, ODP_THREAD_CONTROL)) {
+		app_err("ODP local init failed.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	printf("\nODP startup time, %" PRIu32 " byte packets\n\n",
+	       args.pkt_len);
+	printf("odp_init_global: %.3f msec\n\n", init_ns / 1000000.0);
+	printf("%9s %12s %12s %12s %12s %12s\n", "packets", "create ms",
+	       "1st alloc ms", "2nd alloc ms", "destroy ms", "lookup ns");
+
+	for (num = MIN_POOL_SIZE; num <= args.max_num && !ret; num *= 4)
+		ret = run_pool(num, args.pkt_len);
+	printf("\n");
+
+	if (odp_term_local()) {
+		app_err("Error: term local\n");
+		exit(EXIT_FAILURE);
+	}
+
+	if (odp_term_global(instance)) {
+		app_err("Error: term global\n");
+		exit(EXIT_FAILURE);
+	}
+
+	return ret ? EXIT_FAILURE : 0;
+}
+
+static void parse_args(int argc, char *argv[], perf_args_t *args)
+{
+	int opt;
+	int long_index;
+	static const struct option longopts[] = {
+		{"num", required_argument, NULL, 'n'},
+		{"len", required_argument, NULL, 'l'},
+		{"help", no_argument, NULL, 'h'},
+		{NULL, 0, NULL, 0}
+	};
+
+	static const char *shortopts = "+n:l:h";
+
+	/* let helper collect its own arguments (e.g. --odph_proc) */
+	odph_parse_options(argc, argv, shortopts, longopts);
+
+	args->max_num = 65536;
+	args->pkt_len = 1518;
+
+	opterr = 0; /* do not issue errors on helper options */
+
+	while (1) {
+		opt = getopt_long(argc, argv, shortopts, longopts, &long_index);
+
+		if (opt == -1)
+			break;	/* No more options */
+
+		switch (opt) {
+		case 'n':
+			args->max_num = atoi(optarg);
+			break;
+		case 'l':
+			args->pkt_len = atoi(optarg);
+			break;
+		case 'h':
+			usage(argv[0]);
+			exit(EXIT_SUCCESS);
+			break;
+		default:
+			break;
+		}
+	}
+
+	optind = 1;		/* reset 'extern optind' from the getopt lib */
+
+	if (args->max_num < MIN_POOL_SIZE || args->pkt_len == 0) {
+		usage(argv[0]);
+		exit(EXIT_FAILURE);
+	}
+}
+
+/**
+ * Print usage information
+ */
+static void usage(char *progname)
+{
+	printf("\n"
+	       "Usage: %s OPTIONS\n"
+	       "  E.g. %s -n 4194304\n"
+	       "\n"
+	       "OpenDataPlane startup time measurement. Measures global init\n"
+	       "and the creation of packet pools from %i packets up to the\n"
+	       "given size, in steps of 4x, and the handle lookup cost in\n"
+	       "each pool.\n"
+	       "Optional OPTIONS\n"
+	       "  -n, --num <number>  Largest pool size (default 65536)\n"
+	       "  -l, --len <number>  Packet length (default 1518)\n"
+	       "  -h, --help          Display help and exit.\n"
+	       "\n", progname, progname, MIN_POOL_SIZE);
+}
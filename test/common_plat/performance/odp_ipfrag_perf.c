@@ -0,0 +1,595 @@
+/* Copyright (c) 2017, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:	BSD-3-Clause
+ */
+
+/**
+ * @file
+ *
+ * @example odp_ipfrag_perf.c  IP fragmentation and reassembly rate measurement
+ *
+ * Measures the rate of odph_ipfrag_fragment() and odph_ipfrag_reassemble()
+ * on generated UDP datagrams. Fragments of a number of datagrams are
+ * interleaved before reassembly, as on a link carrying many fragmented
+ * flows. Fragments can also be written into a capture file (-o) and
+ * reassembled from a capture file replay (-i), e.g. with the mpcap pktio.
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif /* _GNU_SOURCE */
+
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+#include <stdio.h>
+#include <inttypes.h>
+
+#include <odp_api.h>
+#include <odp/helper/eth.h>
+#include <odp/helper/ip.h>
+#include <odp/helper/ipfrag.h>
+#include <odp/helper/udp.h>
+#include <odp/helper/linux.h>
+
+#define app_err(fmt, ...) \
+	fprintf(stderr, "%s:%d:%s(): Error: " fmt, __FILE__, \
+		__LINE__, __func__, ##__VA_ARGS__)
+
+/** Packets per burst */
+#define BURST_SIZE 32
+
+/** Largest datagram */
+#define MAX_PKT_LEN 9000
+
+/** Maximum number of fragments of a datagram */
+#define MAX_FRAGS ODPH_IPFRAG_MAX_FRAGS
+
+/** Receive gives up after this long without packets */
+#define IDLE_TIME_NS (200 * ODP_TIME_MSEC_IN_NS)
+
+/** Parsed command line arguments */
+typedef struct {
+	/** Pktio name of the fragment capture, NULL to skip */
+	const char *out_name;
+
+	/** Pktio name of the fragment replay, NULL to skip */
+	const char *in_name;
+
+	/** Number of datagrams */
+	int num_pkts;
+
+	/** Length of datagrams */
+	int pkt_len;
+
+	/** Fragment MTU */
+	int mtu;
+
+	/** Number of datagrams with interleaved fragments */
+	int num_flows;
+
+	/** Generate IPv6 datagrams */
+	int ipv6;
+
+	/** Reassemble fragments in reverse order */
+	int reverse;
+} perf_args_t;
+
+static void parse_args(int argc, char *argv[], perf_args_t *args);
+static void usage(char *progname);
+
+static void print_rate(const char *name, uint64_t pkts, odp_time_t t)
+{
+	double ns = (double)odp_time_to_ns(t);
+
+	if (ns <= 0)
+		ns = 1;
+
+	printf("  %-12s %10" PRIu64 " packets %8.3f s %8.3f Mpps %8.1f ns\n",
+	       name, pkts, ns / ODP_TIME_SEC_IN_NS, pkts * 1e3 / ns,
+	       pkts ? ns / pkts : 0);
+}
+
+static void print_stats(odph_ipfrag_tbl_t tbl)
+{
+	odph_ipfrag_stats_t stats;
+
+	odph_ipfrag_stats(tbl, &stats);
+	printf("  table: %" PRIu64 " fragments, %" PRIu64 " reassembled, %"
+	       PRIu64 " expired, %" PRIu64 " dropped\n", stats.frags,
+	       stats.reassembled, stats.expired, stats.dropped);
+}
+
+/* UDP datagram with source port varying per datagram */
+static odp_packet_t alloc_datagram(const perf_args_t *args, odp_pool_t pool,
+				   uint32_t seq)
+{
+	uint32_t len = args->pkt_len;
+	uint32_t l4_off;
+	odp_packet_t pkt;
+	odph_ethhdr_t *eth;
+	odph_udphdr_t *udp;
+
+	pkt = odp_packet_alloc(pool, len);
+	if (pkt == ODP_PACKET_INVALID)
+		return pkt;
+
+	eth = odp_packet_data(pkt);
+	memset(eth, 0, ODPH_ETHHDR_LEN);
+	eth->dst.addr[0] = 0x02;
+	eth->dst.addr[5] = 0x01;
+	eth->src.addr[0] = 0x02;
+	eth->src.addr[5] = 0x02;
+
+	if (args->ipv6) {
+		odph_ipv6hdr_t ip;
+
+		memset(&ip, 0, sizeof(ip));
+		eth->type = odp_cpu_to_be_16(ODPH_ETHTYPE_IPV6);
+		ip.ver_tc_flow = odp_cpu_to_be_32(ODPH_IPV6 <<
+						  ODPH_IPV6HDR_VERSION_SHIFT);
+		ip.payload_len = odp_cpu_to_be_16(len - ODPH_ETHHDR_LEN -
+						  ODPH_IPV6HDR_LEN);
+		ip.next_hdr = ODPH_IPPROTO_UDP;
+		ip.hop_limit = 64;
+		ip.src_addr[0] = 0xfd;
+		ip.src_addr[15] = 1;
+		ip.dst_addr[0] = 0xfd;
+		ip.dst_addr[15] = 2;
+		odp_packet_copy_from_mem(pkt, ODPH_ETHHDR_LEN, sizeof(ip), &ip);
+		l4_off = ODPH_ETHHDR_LEN + ODPH_IPV6HDR_LEN;
+	} else {
+		odph_ipv4hdr_t ip;
+
+		memset(&ip, 0, sizeof(ip));
+		eth->type = odp_cpu_to_be_16(ODPH_ETHTYPE_IPV4);
+		ip.ver_ihl = ODPH_IPV4 << 4 | ODPH_IPV4HDR_IHL_MIN;
+		ip.tot_len = odp_cpu_to_be_16(len - ODPH_ETHHDR_LEN);
+		ip.id = odp_cpu_to_be_16(seq);
+		ip.ttl = 64;
+		ip.proto = ODPH_IPPROTO_UDP;
+		ip.src_addr = odp_cpu_to_be_32(0x0a000001);
+		ip.dst_addr = odp_cpu_to_be_32(0x0a010001);
+		ip.chksum = odph_chksum(&ip, ODPH_IPV4HDR_LEN);
+		odp_packet_copy_from_mem(pkt, ODPH_ETHHDR_LEN, sizeof(ip), &ip);
+		l4_off = ODPH_ETHHDR_LEN + ODPH_IPV4HDR_LEN;
+	}
+
+	udp = odp_packet_offset(pkt, l4_off, NULL, NULL);
+	udp->src_port = odp_cpu_to_be_16(seq);
+	udp->dst_port = odp_cpu_to_be_16(1025);
+	udp->length = odp_cpu_to_be_16(len - l4_off);
+	udp->chksum = 0;
+
+	odp_packet_l2_offset_set(pkt, 0);
+	odp_packet_l3_offset_set(pkt, ODPH_ETHHDR_LEN);
+	odp_packet_l4_offset_set(pkt, l4_off);
+	return pkt;
+}
+
+/* Fragment a round of datagrams. Fragments are stored interleaved: first
+ * fragments of all datagrams, then second fragments, and so on. */
+static int fragment_round(const perf_args_t *args, odp_pool_t pool,
+			  uint32_t seq, odp_packet_t frag[], int num_dgrams,
+			  odp_time_t *t)
+{
+	odp_packet_t tmp[MAX_FRAGS];
+	odp_packet_t pkt;
+	odp_time_t t1, t2;
+	int i, j, num, max_num = 0;
+
+	for (i = 0; i < num_dgrams * MAX_FRAGS; i++)
+		frag[i] = ODP_PACKET_INVALID;
+
+	for (i = 0; i < num_dgrams; i++) {
+		pkt = alloc_datagram(args, pool, seq + i);
+		if (pkt == ODP_PACKET_INVALID) {
+			app_err("packet alloc failed\n");
+			return -1;
+		}
+
+		t1 = odp_time_local();
+		num = odph_ipfrag_fragment(pkt, args->mtu, tmp, MAX_FRAGS);
+		t2 = odp_time_local();
+		*t = odp_time_sum(*t, odp_time_diff(t2, t1));
+
+		if (num < 0) {
+			app_err("fragmentation failed\n");
+			odp_packet_free(pkt);
+			return -1;
+		}
+
+		for (j = 0; j < num; j++)
+			frag[j * num_dgrams + i] = tmp[j];
+
+		if (num > max_num)
+			max_num = num;
+	}
+
+	return max_num * num_dgrams;
+}
+
+static int run_synthetic(const perf_args_t *args, odp_pool_t pool)
+{
+	odph_ipfrag_param_t param;
+	odph_ipfrag_tbl_t tbl;
+	odp_packet_t *frag;
+	odp_time_t t1, t2, t_frag, t_reass;
+	uint64_t num_frags = 0, num_dgrams = 0, num_gen = 0;
+	int num, i, j;
+
+	odph_ipfrag_param_init(&param);
+	param.max_flows = 2 * args->num_flows;
+	param.max_frags = MAX_FRAGS;
+	param.lockless = 1;
+
+	tbl = odph_ipfrag_tbl_create("ipfrag_perf_tbl", &param);
+	frag = malloc(args->num_flows * MAX_FRAGS * sizeof(odp_packet_t));
+	if (tbl == ODPH_IPFRAG_TBL_INVALID || frag == NULL) {
+		app_err("table create failed\n");
+		return -1;
+	}
+
+	t_frag = ODP_TIME_NULL;
+	t_reass = ODP_TIME_NULL;
+
+	for (i = 0; i < args->num_pkts; i += args->num_flows) {
+		num = fragment_round(args, pool, i, frag, args->num_flows,
+				     &t_frag);
+		if (num < 0)
+			break;
+		num_gen += args->num_flows;
+
+		t1 = odp_time_local();
+		for (j = 0; j < num; j++) {
+			odp_packet_t *pkt = &frag[args->reverse ?
+						  num - 1 - j : j];
+
+			if (*pkt == ODP_PACKET_INVALID)
+				continue;
+
+			num_frags++;
+			if (odph_ipfrag_reassemble(tbl, pkt) == 0) {
+				odp_packet_free(*pkt);
+				num_dgrams++;
+			}
+		}
+		t2 = odp_time_local();
+		t_reass = odp_time_sum(t_reass, odp_time_diff(t2, t1));
+	}
+
+	print_rate("fragment", num_frags, t_frag);
+	print_rate("reassemble", num_frags, t_reass);
+	printf("  %" PRIu64 " datagrams reassembled\n", num_dgrams);
+	print_stats(tbl);
+
+	free(frag);
+	odph_ipfrag_tbl_destroy(tbl);
+	return num_dgrams == num_gen && num_gen ? 0 : -1;
+}
+
+static odp_pktio_t open_pktio(const char *name, odp_pool_t pool)
+{
+	odp_pktio_param_t pktio_param;
+	odp_pktin_queue_param_t pktin_param;
+	odp_pktio_t pktio;
+
+	odp_pktio_param_init(&pktio_param);
+	pktio_param.in_mode = ODP_PKTIN_MODE_DIRECT;
+	pktio_param.out_mode = ODP_PKTOUT_MODE_DIRECT;
+
+	pktio = odp_pktio_open(name, pool, &pktio_param);
+	if (pktio == ODP_PKTIO_INVALID) {
+		app_err("failed to open %s\n", name);
+		return ODP_PKTIO_INVALID;
+	}
+
+	odp_pktin_queue_param_init(&pktin_param);
+	pktin_param.op_mode = ODP_PKTIO_OP_MT_UNSAFE;
+
+	if (odp_pktin_queue_config(pktio, &pktin_param) ||
+	    odp_pktout_queue_config(pktio, NULL) ||
+	    odp_pktio_start(pktio)) {
+		app_err("failed to configure %s\n", name);
+		odp_pktio_close(pktio);
+		return ODP_PKTIO_INVALID;
+	}
+
+	return pktio;
+}
+
+static void close_pktio(odp_pktio_t pktio)
+{
+	odp_pktio_stop(pktio);
+	odp_pktio_close(pktio);
+}
+
+static int run_capture(const perf_args_t *args, odp_pool_t pool)
+{
+	odp_pktout_queue_t pktout;
+	odp_packet_t *frag;
+	odp_pktio_t pktio;
+	odp_time_t t_frag = ODP_TIME_NULL;
+	uint64_t sent = 0;
+	int i, j, num, ret;
+
+	pktio = open_pktio(args->out_name, pool);
+	if (pktio == ODP_PKTIO_INVALID)
+		return -1;
+
+	frag = malloc(args->num_flows * MAX_FRAGS * sizeof(odp_packet_t));
+	if (frag == NULL || odp_pktout_queue(pktio, &pktout, 1) != 1) {
+		app_err("no pktout queue\n");
+		close_pktio(pktio);
+		free(frag);
+		return -1;
+	}
+
+	for (i = 0; i < args->num_pkts; i += args->num_flows) {
+		num = fragment_round(args, pool, i, frag, args->num_flows,
+				     &t_frag);
+		if (num < 0)
+			break;
+
+		for (j = 0; j < num; j++) {
+			if (frag[j] == ODP_PACKET_INVALID)
+				continue;
+
+			ret = odp_pktout_send(pktout, &frag[j], 1);
+			if (ret == 1)
+				sent++;
+			else
+				odp_packet_free(frag[j]);
+		}
+	}
+
+	close_pktio(pktio);
+	free(frag);
+	print_rate("fragment", sent, t_frag);
+	return 0;
+}
+
+static int run_replay(const perf_args_t *args, odp_pool_t pool)
+{
+	odph_ipfrag_param_t param;
+	odph_ipfrag_tbl_t tbl;
+	odp_pktin_queue_t pktin;
+	odp_packet_t pkt[BURST_SIZE];
+	odp_pktio_t pktio;
+	odp_time_t t1, t2, last, t_reass = ODP_TIME_NULL;
+	uint64_t num_pkts = 0, num_dgrams = 0;
+	int i, num;
+
+	odph_ipfrag_param_init(&param);
+	param.max_flows = 2 * args->num_flows;
+	param.max_frags = MAX_FRAGS;
+	param.lockless = 1;
+
+	tbl = odph_ipfrag_tbl_create("ipfrag_perf_tbl", &param);
+	if (tbl == ODPH_IPFRAG_TBL_INVALID) {
+		app_err("table create failed\n");
+		return -1;
+	}
+
+	pktio = open_pktio(args->in_name, pool);
+	if (pktio == ODP_PKTIO_INVALID ||
+	    odp_pktin_queue(pktio, &pktin, 1) != 1) {
+		app_err("no pktin queue\n");
+		odph_ipfrag_tbl_destroy(tbl);
+		return -1;
+	}
+
+	last = odp_time_local();
+	while (odp_time_to_ns(odp_time_diff(odp_time_local(), last)) <
+	       IDLE_TIME_NS) {
+		num = odp_pktin_recv(pktin, pkt, BURST_SIZE);
+		if (num <= 0)
+			continue;
+
+		t1 = odp_time_local();
+		for (i = 0; i < num; i++) {
+			if (odph_ipfrag_reassemble(tbl, &pkt[i]) == 0) {
+				odp_packet_free(pkt[i]);
+				num_dgrams++;
+			}
+		}
+		t2 = odp_time_local();
+		t_reass = odp_time_sum(t_reass, odp_time_diff(t2, t1));
+
+		num_pkts += num;
+		last = t2;
+	}
+
+	close_pktio(pktio);
+	print_rate("reassemble", num_pkts, t_reass);
+	printf("  %" PRIu64 " datagrams out\n", num_dgrams);
+	print_stats(tbl);
+	odph_ipfrag_tbl_destroy(tbl);
+	return 0;
+}
+
+int main(int argc, char *argv[])
+{
+	perf_args_t args;
+	odp_instance_t instance;
+	odp_pool_param_t params;
+	odp_pool_t pool;
+	int ret = 0;
+
+	memset(&args, 0, sizeof(args));
+
+	/* Parse and store the application arguments */
+	parse_args(argc, argv, &args);
+
+	/* Init ODP before calling anything else */
+	if (odp_init_global(&instance, NULL, NULL)) {
+		app_err("ODP global init failed.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	/* Init this thread */
+	if (odp_init_local(instance, ODP_THREAD_CONTROL)) {
+		app_err("ODP local init failed.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	/* Datagrams of a round, their fragments and the table contents */
+	odp_pool_param_init(&params);
+	params.type    = ODP_POOL_PACKET;
+	params.pkt.num = 2 * args.num_flows * (args.pkt_len / 512 + 2) +
+			 BURST_SIZE;
+	params.pkt.len = args.pkt_len;
+
+	pool = odp_pool_create("ipfrag_perf", &params);
+	if (pool == ODP_POOL_INVALID) {
+		app_err("pool create failed\n");
+		exit(EXIT_FAILURE);
+	}
+
+	printf("\nIP fragmentation and reassembly performance\n");
+	printf("  %s datagrams of %i bytes, MTU %i, %i interleaved\n",
+	       args.ipv6 ? "IPv6" : "IPv4", args.pkt_len, args.mtu,
+	       args.num_flows);
+
+	if (args.out_name) {
+		printf("  out: %s\n", args.out_name);
+		if (run_capture(&args, pool))
+			ret = -1;
+	}
+
+	if (args.in_name && !ret) {
+		printf("  in:  %s\n", args.in_name);
+		if (run_replay(&args, pool))
+			ret = -1;
+	}
+
+	if (!args.out_name && !args.in_name && run_synthetic(&args, pool))
+		ret = -1;
+
+	printf("\n");
+
+	if (odp_pool_destroy(pool)) {
+		app_err("Error: pool destroy\n");
+		exit(EXIT_FAILURE);
+	}
+
+	if (odp_term_local()) {
+		app_err("Error: term local\n");
+		exit(EXIT_FAILURE);
+	}
+
+	if (odp_term_global(instance)) {
+		app_err("Error: term global\n");
+		exit(EXIT_FAILURE);
+	}
+
+	return ret ? EXIT_FAILURE : 0;
+}
+
+static void parse_args(int argc, char *argv[], perf_args_t *args)
+{
+	int opt;
+	int long_index;
+	static const struct option longopts[] = {
+		{"out", required_argument, NULL, 'o'},
+		{"in", required_argument, NULL, 'i'},
+		{"num", required_argument, NULL, 'n'},
+		{"len", required_argument, NULL, 'l'},
+		{"mtu", required_argument, NULL, 'm'},
+		{"flows", required_argument, NULL, 'f'},
+		{"ipv6", no_argument, NULL, '6'},
+		{"reverse", no_argument, NULL, 'r'},
+		{"help", no_argument, NULL, 'h'},
+		{NULL, 0, NULL, 0}
+	};
+
+	static const char *shortopts = "+o:i:n:l:m:f:6rh";
+
+	/* let helper collect its own arguments (e.g. --odph_proc) */
+	odph_parse_options(argc, argv, shortopts, longopts);
+
+	args->num_pkts = 100000;
+	args->pkt_len = 8000;
+	args->mtu = 1500;
+	args->num_flows = 64;
+
+	opterr = 0; /* do not issue errors on helper options */
+
+	while (1) {
+		opt = getopt_long(argc, argv, shortopts, longopts, &long_index);
+
+		if (opt == -1)
+			break;	/* No more options */
+
+		switch (opt) {
+		case 'o':
+			args->out_name = optarg;
+			break;
+		case 'i':
+			args->in_name = optarg;
+			break;
+		case 'n':
+			args->num_pkts = atoi(optarg);
+			break;
+		case 'l':
+			args->pkt_len = atoi(optarg);
+			break;
+		case 'm':
+			args->mtu = atoi(optarg);
+			break;
+		case 'f':
+			args->num_flows = atoi(optarg);
+			break;
+		case '6':
+			args->ipv6 = 1;
+			break;
+		case 'r':
+			args->reverse = 1;
+			break;
+		case 'h':
+			usage(argv[0]);
+			exit(EXIT_SUCCESS);
+			break;
+		default:
+			break;
+		}
+	}
+
+	optind = 1;		/* reset 'extern optind' from the getopt lib */
+
+	if (args->num_pkts <= 0 || args->num_flows <= 0 ||
+	    args->num_flows > 4096 || args->mtu < 576 ||
+	    args->pkt_len < ODPH_ETHHDR_LEN + ODPH_IPV6HDR_LEN +
+	    ODPH_UDPHDR_LEN || args->pkt_len > MAX_PKT_LEN) {
+		usage(argv[0]);
+		exit(EXIT_FAILURE);
+	}
+}
+
+/**
+ * Print usage information
+ */
+static void usage(char *progname)
+{
+	printf("\n"
+	       "Usage: %s OPTIONS\n"
+	       "  E.g. %s -l 8000 -m 1500 -f 256\n"
+	       "       %s -o mpcap:out=frags.pcap -n 100000\n"
+	       "       %s -i mpcap:in=frags.pcap:loops=10\n"
+	       "\n"
+	       "OpenDataPlane IP fragmentation and reassembly measurement.\n"
+	       "Without -o or -i fragments and reassembles in memory.\n"
+	       "Optional OPTIONS\n"
+	       "  -o, --out <name>     Write fragments into pktio <name>\n"
+	       "  -i, --in <name>      Reassemble fragments from pktio <name>\n"
+	       "  -n, --num <number>   Number of datagrams (default 100000)\n"
+	       "  -l, --len <bytes>    Length of datagrams (default 8000)\n"
+	       "  -m, --mtu <bytes>    Fragment MTU (default 1500)\n"
+	       "  -f, --flows <num>    Datagrams with interleaved fragments\n"
+	       "                       (default 64)\n"
+	       "  -6, --ipv6           IPv6 datagrams\n"
+	       "  -r, --reverse        Reassemble fragments in reverse order\n"
+	       "  -h, --help           Display help and exit.\n"
+	       "\n", progname, progname, progname, progname);
+}
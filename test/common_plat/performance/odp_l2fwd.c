@@ -101,6 +101,7 @@ typedef struct {
 	int dst_change;		/**< Change destination eth addresses */
 	int src_change;		/**< Change source eth addresses */
 	int error_check;        /**< Check packet errors */
+	int parse_depth;	/**< Packet input parse depth */
 } appl_args_t;
 
 static int exit_threads;	/**< Break workers loop if set to 1 */
@@ -612,6 +613,7 @@ static int create_pktio(const char *dev, int idx, int num_rx, int num_tx,
 	odp_pktio_param_t pktio_param;
 	odp_schedule_sync_t  sync_mode;
 	odp_pktio_capability_t capa;
+	odp_pktio_config_t config;
 	odp_pktin_queue_param_t pktin_param;
 	odp_pktout_queue_param_t pktout_param;
 	odp_pktio_op_mode_t mode_rx;
@@ -643,6 +645,14 @@ static int create_pktio(const char *dev, int idx, int num_rx, int num_tx,
 		return -1;
 	}
 
+	odp_pktio_config_init(&config);
+	config.parse_depth = gbl_args->appl.parse_depth;
+
+	if (odp_pktio_config(pktio, &config)) {
+		LOG_ERR("Error: pktio config failed %s\n", dev);
+		return -1;
+	}
+
 	odp_pktin_queue_param_init(&pktin_param);
 	odp_pktout_queue_param_init(&pktout_param);
 
@@ -1028,6 +1038,11 @@ static void usage(char *progname)
 	       "                    Requires also the -d flag to be set\n"
 	       "  -e, --error_check 0: Don't check packet errors (default)\n"
 	       "                    1: Check packet errors\n"
+	       "  -p, --parse_depth Packet input parse depth\n"
+	       "                    0: None, headers are parsed on demand\n"
+	       "                    1: L2 (default)\n"
+	       "                    2: L3\n"
+	       "                    3: L4\n"
 	       "  -h, --help           Display help and exit.\n\n"
 	       "\n", NO_PATH(progname), NO_PATH(progname), MAX_PKTIOS
 	    );
@@ -1059,11 +1074,12 @@ static void parse_args(int argc, char *argv[], appl_args_t *appl_args)
 		{"dst_change", required_argument, NULL, 'd'},
 		{"src_change", required_argument, NULL, 's'},
 		{"error_check", required_argument, NULL, 'e'},
+		{"parse_depth", required_argument, NULL, 'p'},
 		{"help", no_argument, NULL, 'h'},
 		{NULL, 0, NULL, 0}
 	};
 
-	static const char *shortopts =  "+c:+t:+a:i:m:o:r:d:s:e:h";
+	static const char *shortopts =  "+c:+t:+a:i:m:o:r:d:s:e:p:h";
 
 	/* let helper collect its own arguments (e.g. --odph_proc) */
 	odph_parse_options(argc, argv, shortopts, longopts);
@@ -1073,6 +1089,7 @@ static void parse_args(int argc, char *argv[], appl_args_t *appl_args)
 	appl_args->dst_change = 1; /* change eth dst address by default */
 	appl_args->src_change = 1; /* change eth src address by default */
 	appl_args->error_check = 0; /* don't check packet errors by default */
+	appl_args->parse_depth = ODP_PKTIO_PARSE_L2;
 
 	opterr = 0; /* do not issue errors on helper options */
 
@@ -1197,6 +1214,14 @@ static void parse_args(int argc, char *argv[], appl_args_t *appl_args)
 		case 'e':
 			appl_args->error_check = atoi(optarg);
 			break;
+		case 'p':
+			i = atoi(optarg);
+			if (i < 0 || i > ODP_PKTIO_PARSE_L4) {
+				usage(argv[0]);
+				exit(EXIT_FAILURE);
+			}
+			appl_args->parse_depth = i;
+			break;
 		case 'h':
 			usage(argv[0]);
 			exit(EXIT_SUCCESS);
@@ -1267,7 +1292,8 @@ static void print_info(char *progname, appl_args_t *appl_args)
 	else
 		printf("PKTOUT_DIRECT");
 
-	printf("\n\n");
+	printf("\n"
+	       "Parse depth:     %i\n\n", appl_args->parse_depth);
 	fflush(NULL);
 }
 
@@ -0,0 +1,375 @@
+/* Copyright (c) 2017, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:	BSD-3-Clause
+ */
+
+/**
+ * @file
+ *
+ * @example odp_lpm_perf.c  Route table scale and lookup rate measurement
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif /* _GNU_SOURCE */
+
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+#include <stdio.h>
+#include <inttypes.h>
+
+#include <odp_api.h>
+#include <odp/helper/linux.h>
+#include <odp/helper/lpm.h>
+
+#define app_err(fmt, ...) \
+	fprintf(stderr, "%s:%d:%s(): Error: " fmt, __FILE__, \
+		__LINE__, __func__, ##__VA_ARGS__)
+
+/** Addresses per odph_lpm_lookup_multi() call */
+#define BURST_SIZE 32
+
+/** Number of looked up addresses */
+#define NUM_ADDRS (64 * 1024)
+
+/** Parsed command line arguments */
+typedef struct {
+	/** Number of IPv4 routes */
+	int num_routes;
+
+	/** Number of IPv6 routes */
+	int num_routes6;
+
+	/** Number of lookup rounds over all addresses */
+	int rounds;
+} lpm_args_t;
+
+static void parse_args(int argc, char *argv[], lpm_args_t *args);
+static void usage(char *progname);
+
+/* Prevent the compiler from dropping unused lookup results */
+static volatile uint32_t sink;
+
+static uint32_t rnd_state = 1;
+
+static uint32_t rnd(void)
+{
+	rnd_state ^= rnd_state << 13;
+	rnd_state ^= rnd_state >> 17;
+	rnd_state ^= rnd_state << 5;
+	return rnd_state;
+}
+
+/* Prefix length distribution resembling an Internet routing table:
+ * about half /24, most of the rest /16 ... /23 and a few longer */
+static uint8_t random_depth4(void)
+{
+	uint32_t r = rnd() % 100;
+
+	if (r < 55)
+		return 24;
+	if (r < 95)
+		return 16 + rnd() % 8;
+	if (r < 98)
+		return 8 + rnd() % 8;
+	return 25 + rnd() % 8;
+}
+
+static double ns_per(odp_time_t t1, odp_time_t t2, uint64_t num)
+{
+	return (double)odp_time_to_ns(odp_time_diff(t2, t1)) / num;
+}
+
+static int bench_ipv4(const lpm_args_t *args)
+{
+	uint32_t *prefix, *addr, *nh;
+	uint8_t *depth;
+	odph_lpm_t lpm;
+	odp_time_t t1, t2;
+	uint32_t next_hop, sum = 0;
+	int i, j, r, num_ok = 0;
+
+	prefix = malloc(args->num_routes * sizeof(uint32_t));
+	depth = malloc(args->num_routes);
+	addr = malloc(NUM_ADDRS * sizeof(uint32_t));
+	nh = malloc(NUM_ADDRS * sizeof(uint32_t));
+	if (!prefix || !depth || !addr || !nh) {
+		app_err("malloc failed\n");
+		return -1;
+	}
+
+	lpm = odph_lpm_create("lpm_perf4", args->num_routes,
+			      args->num_routes / 16 + 256);
+	if (lpm == ODPH_LPM_INVALID) {
+		app_err("IPv4 table create failed\n");
+		return -1;
+	}
+
+	for (i = 0; i < args->num_routes; i++) {
+		depth[i] = random_depth4();
+		prefix[i] = rnd() & ~(0xffffffffu >> depth[i]);
+	}
+
+	t1 = odp_time_local();
+	for (i = 0; i < args->num_routes; i++)
+		num_ok += odph_lpm_add(lpm, prefix[i], depth[i], i &
+				       ODPH_LPM_NEXT_HOP_MAX) == 0;
+	t2 = odp_time_local();
+
+	printf("IPv4 %8i routes added  %10.1f ns/route\n", num_ok,
+	       ns_per(t1, t2, args->num_routes));
+
+	/* Addresses inside the routes, in random order */
+	for (i = 0; i < NUM_ADDRS; i++) {
+		j = rnd() % args->num_routes;
+		addr[i] = prefix[j] | (rnd() & (0xffffffffu >> depth[j]));
+	}
+
+	t1 = odp_time_local();
+	for (r = 0; r < args->rounds; r++) {
+		for (i = 0; i < NUM_ADDRS; i++) {
+			if (odph_lpm_lookup(lpm, addr[i], &next_hop) == 0)
+				sum += next_hop;
+		}
+	}
+	t2 = odp_time_local();
+	sink = sum;
+
+	printf("IPv4 lookup                    %10.1f ns/addr\n",
+	       ns_per(t1, t2, (uint64_t)args->rounds * NUM_ADDRS));
+
+	t1 = odp_time_local();
+	for (r = 0; r < args->rounds; r++) {
+		for (i = 0; i < NUM_ADDRS; i += BURST_SIZE)
+			odph_lpm_lookup_multi(lpm, &addr[i], &nh[i],
+					      BURST_SIZE);
+	}
+	t2 = odp_time_local();
+	sink = nh[0];
+
+	printf("IPv4 lookup_multi (%2i)         %10.1f ns/addr\n", BURST_SIZE,
+	       ns_per(t1, t2, (uint64_t)args->rounds * NUM_ADDRS));
+
+	t1 = odp_time_local();
+	for (i = 0; i < args->num_routes; i++)
+		odph_lpm_delete(lpm, prefix[i], depth[i]);
+	t2 = odp_time_local();
+
+	printf("IPv4 routes deleted            %10.1f ns/route\n\n",
+	       ns_per(t1, t2, args->num_routes));
+
+	free(prefix);
+	free(depth);
+	free(addr);
+	free(nh);
+
+	return odph_lpm_destroy(lpm);
+}
+
+static int bench_ipv6(const lpm_args_t *args)
+{
+	uint8_t (*prefix)[ODPH_LPM6_ADDR_LEN];
+	uint8_t (*addr)[ODPH_LPM6_ADDR_LEN];
+	uint32_t *nh;
+	uint8_t *depth;
+	odph_lpm_t lpm;
+	odp_time_t t1, t2;
+	int i, j, k, r, num_ok = 0;
+
+	prefix = malloc(args->num_routes6 * sizeof(*prefix));
+	depth = malloc(args->num_routes6);
+	addr = malloc(NUM_ADDRS * sizeof(*addr));
+	nh = malloc(NUM_ADDRS * sizeof(uint32_t));
+	if (!prefix || !depth || !addr || !nh) {
+		app_err("malloc failed\n");
+		return -1;
+	}
+
+	lpm = odph_lpm6_create("lpm_perf6", args->num_routes6,
+			       args->num_routes6 * 4 + 256);
+	if (lpm == ODPH_LPM_INVALID) {
+		app_err("IPv6 table create failed\n");
+		return -1;
+	}
+
+	/* Global unicast /32 ... /48 prefixes */
+	for (i = 0; i < args->num_routes6; i++) {
+		depth[i] = (rnd() % 4) ? 48 : 32 + rnd() % 16;
+		memset(prefix[i], 0, ODPH_LPM6_ADDR_LEN);
+		prefix[i][0] = 0x20;
+		prefix[i][1] = 0x01 + rnd() % 4;
+		for (k = 2; k < depth[i] / 8; k++)
+			prefix[i][k] = rnd();
+		if (depth[i] % 8)
+			prefix[i][k] = rnd() & (0xff00 >> (depth[i] % 8));
+	}
+
+	t1 = odp_time_local();
+	for (i = 0; i < args->num_routes6; i++)
+		num_ok += odph_lpm6_add(lpm, prefix[i], depth[i], i &
+					ODPH_LPM_NEXT_HOP_MAX) == 0;
+	t2 = odp_time_local();
+
+	printf("IPv6 %8i routes added  %10.1f ns/route\n", num_ok,
+	       ns_per(t1, t2, args->num_routes6));
+
+	for (i = 0; i < NUM_ADDRS; i++) {
+		j = rnd() % args->num_routes6;
+		memcpy(addr[i], prefix[j], ODPH_LPM6_ADDR_LEN);
+		for (k = 6; k < ODPH_LPM6_ADDR_LEN; k++)
+			addr[i][k] = rnd();
+	}
+
+	t1 = odp_time_local();
+	for (r = 0; r < args->rounds; r++) {
+		for (i = 0; i < NUM_ADDRS; i++)
+			odph_lpm6_lookup(lpm, addr[i], &nh[i]);
+	}
+	t2 = odp_time_local();
+	sink = nh[0];
+
+	printf("IPv6 lookup                    %10.1f ns/addr\n",
+	       ns_per(t1, t2, (uint64_t)args->rounds * NUM_ADDRS));
+
+	t1 = odp_time_local();
+	for (r = 0; r < args->rounds; r++) {
+		for (i = 0; i < NUM_ADDRS; i += BURST_SIZE)
+			odph_lpm6_lookup_multi(lpm,
+					       (const uint8_t (*)[16])&addr[i],
+					       &nh[i], BURST_SIZE);
+	}
+	t2 = odp_time_local();
+	sink = nh[0];
+
+	printf("IPv6 lookup_multi (%2i)         %10.1f ns/addr\n\n",
+	       BURST_SIZE, ns_per(t1, t2, (uint64_t)args->rounds * NUM_ADDRS));
+
+	free(prefix);
+	free(depth);
+	free(addr);
+	free(nh);
+
+	return odph_lpm_destroy(lpm);
+}
+
+int main(int argc, char *argv[])
+{
+	lpm_args_t args;
+	odp_instance_t instance;
+	int ret = 0;
+
+	memset(&args, 0, sizeof(args));
+
+	/* Parse and store the application arguments */
+	parse_args(argc, argv, &args);
+
+	/* Init ODP before calling anything else */
+	if (odp_init_global(&instance, NULL, NULL)) {
+		app_err("ODP global init failed.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	/* Init this thread */
+	if (odp_init_local(instance, ODP_THREAD_CONTROL)) {
+		app_err("ODP local init failed.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	printf("\nLPM performance, %i lookup rounds of %i addresses\n\n",
+	       args.rounds, NUM_ADDRS);
+
+	if (args.num_routes && bench_ipv4(&args))
+		ret = -1;
+
+	if (args.num_routes6 && bench_ipv6(&args))
+		ret = -1;
+
+	if (odp_term_local()) {
+		app_err("Error: term local\n");
+		exit(EXIT_FAILURE);
+	}
+
+	if (odp_term_global(instance)) {
+		app_err("Error: term global\n");
+		exit(EXIT_FAILURE);
+	}
+
+	return ret ? EXIT_FAILURE : 0;
+}
+
+static void parse_args(int argc, char *argv[], lpm_args_t *args)
+{
+	int opt;
+	int long_index;
+	static const struct option longopts[] = {
+		{"routes", required_argument, NULL, 'r'},
+		{"routes6", required_argument, NULL, '6'},
+		{"rounds", required_argument, NULL, 'n'},
+		{"help", no_argument, NULL, 'h'},
+		{NULL, 0, NULL, 0}
+	};
+
+	static const char *shortopts = "+r:6:n:h";
+
+	/* let helper collect its own arguments (e.g. --odph_proc) */
+	odph_parse_options(argc, argv, shortopts, longopts);
+
+	args->num_routes = 1000000;
+	args->num_routes6 = 20000;
+	args->rounds = 20;
+
+	opterr = 0; /* do not issue errors on helper options */
+
+	while (1) {
+		opt = getopt_long(argc, argv, shortopts, longopts, &long_index);
+
+		if (opt == -1)
+			break;	/* No more options */
+
+		switch (opt) {
+		case 'r':
+			args->num_routes = atoi(optarg);
+			break;
+		case '6':
+			args->num_routes6 = atoi(optarg);
+			break;
+		case 'n':
+			args->rounds = atoi(optarg);
+			break;
+		case 'h':
+			usage(argv[0]);
+			exit(EXIT_SUCCESS);
+			break;
+		default:
+			break;
+		}
+	}
+
+	optind = 1;		/* reset 'extern optind' from the getopt lib */
+
+	if (args->num_routes < 0 || args->num_routes6 < 0 ||
+	    args->rounds <= 0) {
+		usage(argv[0]);
+		exit(EXIT_FAILURE);
+	}
+}
+
+/**
+ * Print usage information
+ */
+static void usage(char *progname)
+{
+	printf("\n"
+	       "Usage: %s OPTIONS\n"
+	       "  E.g. %s -r 500000\n"
+	       "\n"
+	       "OpenDataPlane longest prefix match table measurement.\n"
+	       "Optional OPTIONS\n"
+	       "  -r, --routes <number>   Number of IPv4 routes (default 1000000)\n"
+	       "  -6, --routes6 <number>  Number of IPv6 routes (default 20000)\n"
+	       "  -n, --rounds <number>   Lookup rounds (default 20)\n"
+	       "  -h, --help              Display help and exit.\n"
+	       "\n", progname, progname);
+}
@@ -0,0 +1,311 @@
+/* Copyright (c) 2017, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:	BSD-3-Clause
+ */
+
+/**
+ * @file
+ *
+ * @example odp_packet_perf.c  Packet manipulation function measurement
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif /* _GNU_SOURCE */
+
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+#include <stdio.h>
+#include <inttypes.h>
+
+#include <odp_api.h>
+#include <odp/helper/linux.h>
+
+/** Number of elements in an array */
+#define ARRAY_SIZE(x) (sizeof(x) / sizeof((x)[0]))
+
+#define app_err(fmt, ...) \
+	fprintf(stderr, "%s:%d:%s(): Error: " fmt, __FILE__, \
+		__LINE__, __func__, ##__VA_ARGS__)
+
+/** Packets manipulated per round */
+#define NUM_PKTS 32
+
+/** Bytes inserted and removed, e.g. a tunnel header or an ESP trailer */
+#define ADD_LEN 16
+
+/** Offset of inserted headers, after an Ethernet header */
+#define HDR_OFFSET 14
+
+/** Measured packet lengths */
+static const uint32_t pkt_len_tbl[] = {64, 1518, 9000};
+
+#define NUM_LENS ARRAY_SIZE(pkt_len_tbl)
+
+/** Parsed command line arguments */
+typedef struct {
+	/** Number of rounds over all packets */
+	int rounds;
+} pkt_args_t;
+
+/** Manipulation of packets, done and undone once per call */
+typedef int (*bench_fn_t)(odp_packet_t *pkt, uint32_t len);
+
+static void parse_args(int argc, char *argv[], pkt_args_t *args);
+static void usage(char *progname);
+
+static int bench_add_rem_head(odp_packet_t *pkt, uint32_t len)
+{
+	(void)len;
+
+	if (odp_packet_add_data(pkt, HDR_OFFSET, ADD_LEN) < 0)
+		return -1;
+
+	return odp_packet_rem_data(pkt, HDR_OFFSET, ADD_LEN);
+}
+
+static int bench_add_rem_tail(odp_packet_t *pkt, uint32_t len)
+{
+	if (odp_packet_add_data(pkt, len - 4, ADD_LEN) < 0)
+		return -1;
+
+	return odp_packet_rem_data(pkt, len - 4, ADD_LEN);
+}
+
+static int bench_add_rem_mid(odp_packet_t *pkt, uint32_t len)
+{
+	if (odp_packet_add_data(pkt, len / 2, ADD_LEN) < 0)
+		return -1;
+
+	return odp_packet_rem_data(pkt, len / 2, ADD_LEN);
+}
+
+static int bench_extend_trunc_head(odp_packet_t *pkt, uint32_t len)
+{
+	(void)len;
+
+	if (odp_packet_extend_head(pkt, ADD_LEN, NULL, NULL) < 0)
+		return -1;
+
+	return odp_packet_trunc_head(pkt, ADD_LEN, NULL, NULL);
+}
+
+static int bench_split_concat(odp_packet_t *pkt, uint32_t len)
+{
+	odp_packet_t tail;
+
+	if (odp_packet_split(pkt, len / 2, &tail) < 0)
+		return -1;
+
+	return odp_packet_concat(pkt, tail);
+}
+
+static int bench_split_concat_hdr(odp_packet_t *pkt, uint32_t len)
+{
+	odp_packet_t tail;
+
+	(void)len;
+
+	if (odp_packet_split(pkt, HDR_OFFSET, &tail) < 0)
+		return -1;
+
+	return odp_packet_concat(pkt, tail);
+}
+
+static const struct {
+	const char *name;
+	bench_fn_t fn;
+} bench_tbl[] = {
+	{"add/rem_data at offset 14", bench_add_rem_head},
+	{"add/rem_data at tail - 4", bench_add_rem_tail},
+	{"add/rem_data at middle", bench_add_rem_mid},
+	{"extend/trunc_head", bench_extend_trunc_head},
+	{"split/concat at middle", bench_split_concat},
+	{"split/concat at offset 14", bench_split_concat_hdr},
+};
+
+#define NUM_BENCH ARRAY_SIZE(bench_tbl)
+
+static int run_bench(odp_pool_t pool, const pkt_args_t *args, uint32_t len,
+		     int b)
+{
+	odp_packet_t pkt[NUM_PKTS];
+	odp_time_t t1, t2;
+	int i, r, num;
+	int ret = 0;
+
+	num = odp_packet_alloc_multi(pool, len, pkt, NUM_PKTS);
+	if (num != NUM_PKTS) {
+		app_err("packet alloc failed\n");
+		if (num > 0)
+			odp_packet_free_multi(pkt, num);
+		return -1;
+	}
+
+	t1 = odp_time_local();
+	for (r = 0; r < args->rounds && !ret; r++) {
+		for (i = 0; i < NUM_PKTS; i++) {
+			if (bench_tbl[b].fn(&pkt[i], len) < 0) {
+				app_err("%s failed\n", bench_tbl[b].name);
+				ret = -1;
+				break;
+			}
+		}
+	}
+	t2 = odp_time_local();
+
+	if (!ret)
+		printf("  %-28s %6" PRIu32 " B %10.1f ns\n", bench_tbl[b].name,
+		       len, (double)odp_time_to_ns(odp_time_diff(t2, t1)) /
+		       ((uint64_t)args->rounds * NUM_PKTS));
+
+	odp_packet_free_multi(pkt, NUM_PKTS);
+	return ret;
+}
+
+int main(int argc, char *argv[])
+{
+	pkt_args_t args;
+	odp_instance_t instance;
+	odp_pool_capability_t capa;
+	odp_pool_param_t params;
+	odp_pool_t pool;
+	uint32_t max_len;
+	unsigned int b, l;
+	int ret = 0;
+
+	memset(&args, 0, sizeof(args));
+
+	/* Parse and store the application arguments */
+	parse_args(argc, argv, &args);
+
+	/* Init ODP before calling anything else */
+	if (odp_init_global(&instance, NULL, NULL)) {
+		app_err("ODP global init failed.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	/* Init this thread */
+	if (odp_init_local(instance, ODP_THREAD_CONTROL)) {
+		app_err("ODP local init failed.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	if (odp_pool_capability(&capa)) {
+		app_err("pool capability failed\n");
+		exit(EXIT_FAILURE);
+	}
+
+	max_len = pkt_len_tbl[NUM_LENS - 1];
+	if (capa.pkt.max_len && capa.pkt.max_len < max_len)
+		max_len = capa.pkt.max_len;
+
+	/* Room for packets split in two and one extra segment per packet */
+	odp_pool_param_init(&params);
+	params.type        = ODP_POOL_PACKET;
+	params.pkt.num     = 4 * NUM_PKTS;
+	params.pkt.len     = max_len + ADD_LEN;
+	params.pkt.seg_len = 0;
+
+	pool = odp_pool_create("packet_perf", &params);
+	if (pool == ODP_POOL_INVALID) {
+		app_err("pool create failed\n");
+		exit(EXIT_FAILURE);
+	}
+
+	printf("\nPacket manipulation performance, %i rounds of %i packets\n"
+	       "Time per manipulation and its reversal\n\n",
+	       args.rounds, NUM_PKTS);
+
+	for (b = 0; b < NUM_BENCH; b++) {
+		for (l = 0; l < NUM_LENS; l++) {
+			if (pkt_len_tbl[l] > max_len)
+				continue;
+
+			if (run_bench(pool, &args, pkt_len_tbl[l], b))
+				ret = -1;
+		}
+	}
+	printf("\n");
+
+	if (odp_pool_destroy(pool)) {
+		app_err("Error: pool destroy\n");
+		exit(EXIT_FAILURE);
+	}
+
+	if (odp_term_local()) {
+		app_err("Error: term local\n");
+		exit(EXIT_FAILURE);
+	}
+
+	if (odp_term_global(instance)) {
+		app_err("Error: term global\n");
+		exit(EXIT_FAILURE);
+	}
+
+	return ret ? EXIT_FAILURE : 0;
+}
+
+static void parse_args(int argc, char *argv[], pkt_args_t *args)
+{
+	int opt;
+	int long_index;
+	static const struct option longopts[] = {
+		{"rounds", required_argument, NULL, 'n'},
+		{"help", no_argument, NULL, 'h'},
+		{NULL, 0, NULL, 0}
+	};
+
+	static const char *shortopts = "+n:h";
+
+	/* let helper collect its own arguments (e.g. --odph_proc) */
+	odph_parse_options(argc, argv, shortopts, longopts);
+
+	args->rounds = 10000;
+
+	opterr = 0; /* do not issue errors on helper options */
+
+	while (1) {
+		opt = getopt_long(argc, argv, shortopts, longopts, &long_index);
+
+		if (opt == -1)
+			break;	/* No more options */
+
+		switch (opt) {
+		case 'n':
+			args->rounds = atoi(optarg);
+			break;
+		case 'h':
+			usage(argv[0]);
+			exit(EXIT_SUCCESS);
+			break;
+		default:
+			break;
+		}
+	}
+
+	optind = 1;		/* reset 'extern optind' from the getopt lib */
+
+	if (args->rounds <= 0) {
+		usage(argv[0]);
+		exit(EXIT_FAILURE);
+	}
+}
+
+/**
+ * Print usage information
+ */
+static void usage(char *progname)
+{
+	printf("\n"
+	       "Usage: %s OPTIONS\n"
+	       "  E.g. %s -n 1000\n"
+	       "\n"
+	       "OpenDataPlane packet manipulation function measurement.\n"
+	       "Optional OPTIONS\n"
+	       "  -n, --rounds <number>  Rounds over all packets (default 10000)\n"
+	       "  -h, --help             Display help and exit.\n"
+	       "\n", progname, progname);
+}
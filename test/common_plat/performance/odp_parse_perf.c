@@ -0,0 +1,470 @@
+/* Copyright (c) 2017, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:	BSD-3-Clause
+ */
+
+/**
+ * @file
+ *
+ * @example odp_parse_perf.c  Packet input parse rate measurement
+ *
+ * Measures the rate at which packets of a traffic mix are received and
+ * parsed. A set of packets is sent into a loopback pktio and received again
+ * in bursts, and the layer 3 and 4 metadata of each received packet is read.
+ * The IMIX mix has 64, 576 and 1500 byte packets in 7:4:1 ratio, mostly
+ * TCP and UDP over IPv4 and IPv6, with VLAN tagged, ICMP and ARP packets
+ * among them.
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif /* _GNU_SOURCE */
+
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+#include <stdio.h>
+#include <inttypes.h>
+
+#include <odp_api.h>
+#include <odp/helper/eth.h>
+#include <odp/helper/ip.h>
+#include <odp/helper/tcp.h>
+#include <odp/helper/udp.h>
+#include <odp/helper/linux.h>
+
+/** Number of elements in an array */
+#define ARRAY_SIZE(x) (sizeof(x) / sizeof((x)[0]))
+
+#define app_err(fmt, ...) \
+	fprintf(stderr, "%s:%d:%s(): Error: " fmt, __FILE__, \
+		__LINE__, __func__, ##__VA_ARGS__)
+
+/** Packets per burst */
+#define BURST_SIZE 32
+
+/** Packets in flight */
+#define NUM_PKTS (8 * BURST_SIZE)
+
+/** Packet types */
+typedef enum {
+	PKT_IPV4_UDP = 0,
+	PKT_IPV4_TCP,
+	PKT_IPV6_UDP,
+	PKT_IPV6_TCP,
+	PKT_VLAN_IPV4_UDP,
+	PKT_IPV4_ICMP,
+	PKT_ARP
+} pkt_type_t;
+
+/** Packet type and length */
+typedef struct {
+	pkt_type_t type;
+	uint32_t len;
+} pkt_desc_t;
+
+/** Traffic mix, repeated over the packets */
+typedef struct {
+	const char *name;
+	const pkt_desc_t *desc;
+	int num;
+} pkt_mix_t;
+
+static const pkt_desc_t mix_ipv4_udp[] = {
+	{ PKT_IPV4_UDP, 64 }
+};
+
+static const pkt_desc_t mix_ipv6_tcp[] = {
+	{ PKT_IPV6_TCP, 78 }
+};
+
+static const pkt_desc_t mix_vlan[] = {
+	{ PKT_VLAN_IPV4_UDP, 64 }
+};
+
+/* 7:4:1 sizes (IPv6 TCP needs 78 bytes), 10 of 12 packets are TCP or UDP */
+static const pkt_desc_t mix_imix[] = {
+	{ PKT_IPV4_TCP, 64 },
+	{ PKT_IPV4_UDP, 64 },
+	{ PKT_IPV6_TCP, 78 },
+	{ PKT_IPV4_TCP, 64 },
+	{ PKT_ARP, 64 },
+	{ PKT_VLAN_IPV4_UDP, 64 },
+	{ PKT_IPV4_TCP, 64 },
+	{ PKT_IPV4_TCP, 576 },
+	{ PKT_IPV6_UDP, 576 },
+	{ PKT_IPV4_UDP, 576 },
+	{ PKT_IPV4_ICMP, 576 },
+	{ PKT_IPV4_TCP, 1500 }
+};
+
+static const pkt_mix_t mix_tbl[] = {
+	{ "ipv4-udp", mix_ipv4_udp, ARRAY_SIZE(mix_ipv4_udp) },
+	{ "ipv6-tcp", mix_ipv6_tcp, ARRAY_SIZE(mix_ipv6_tcp) },
+	{ "vlan", mix_vlan, ARRAY_SIZE(mix_vlan) },
+	{ "imix", mix_imix, ARRAY_SIZE(mix_imix) }
+};
+
+#define NUM_MIXES ARRAY_SIZE(mix_tbl)
+
+/** Parsed command line arguments */
+typedef struct {
+	/** Pktio name */
+	const char *if_name;
+	/** Number of rounds over all packets */
+	int rounds;
+} perf_args_t;
+
+static void parse_args(int argc, char *argv[], perf_args_t *args);
+static void usage(char *progname);
+
+static void init_l4(uint8_t *l4, uint8_t proto, uint32_t len)
+{
+	odph_udphdr_t *udp = (odph_udphdr_t *)(void *)l4;
+	odph_tcphdr_t *tcp = (odph_tcphdr_t *)(void *)l4;
+
+	if (proto == ODPH_IPPROTO_UDP) {
+		udp->src_port = odp_cpu_to_be_16(1024);
+		udp->dst_port = odp_cpu_to_be_16(1025);
+		udp->length = odp_cpu_to_be_16(len);
+	} else if (proto == ODPH_IPPROTO_TCP) {
+		tcp->src_port = odp_cpu_to_be_16(1024);
+		tcp->dst_port = odp_cpu_to_be_16(1025);
+		tcp->hl = ODPH_TCPHDR_LEN / 4;
+	}
+}
+
+static odp_packet_t build_packet(odp_pool_t pool, const pkt_desc_t *desc,
+				 uint32_t seq)
+{
+	odp_packet_t pkt;
+	odph_ethhdr_t *eth;
+	odph_vlanhdr_t *vlan;
+	odph_ipv4hdr_t *ip;
+	odph_ipv6hdr_t *ip6;
+	uint8_t *l3, *l4;
+	uint16_t ethtype;
+	uint8_t proto;
+	uint32_t l3_len;
+
+	pkt = odp_packet_alloc(pool, desc->len);
+	if (pkt == ODP_PACKET_INVALID)
+		return ODP_PACKET_INVALID;
+
+	eth = odp_packet_data(pkt);
+	memset(eth, 0, desc->len);
+	eth->dst.addr[0] = 0x02;
+	eth->dst.addr[5] = 0x01;
+	eth->src.addr[0] = 0x02;
+	eth->src.addr[5] = 0x02;
+	l3 = (uint8_t *)(eth + 1);
+
+	switch (desc->type) {
+	case PKT_IPV6_UDP:
+	case PKT_IPV6_TCP:
+		ethtype = ODPH_ETHTYPE_IPV6;
+		break;
+	case PKT_ARP:
+		ethtype = ODPH_ETHTYPE_ARP;
+		break;
+	default:
+		ethtype = ODPH_ETHTYPE_IPV4;
+	}
+
+	if (desc->type == PKT_VLAN_IPV4_UDP) {
+		eth->type = odp_cpu_to_be_16(ODPH_ETHTYPE_VLAN);
+		vlan = (odph_vlanhdr_t *)(void *)l3;
+		vlan->tci = odp_cpu_to_be_16(seq & 0xfff);
+		vlan->type = odp_cpu_to_be_16(ethtype);
+		l3 += ODPH_VLANHDR_LEN;
+	} else {
+		eth->type = odp_cpu_to_be_16(ethtype);
+	}
+
+	switch (desc->type) {
+	case PKT_IPV4_TCP:
+	case PKT_IPV6_TCP:
+		proto = ODPH_IPPROTO_TCP;
+		break;
+	case PKT_IPV4_ICMP:
+		proto = ODPH_IPPROTO_ICMP;
+		break;
+	default:
+		proto = ODPH_IPPROTO_UDP;
+	}
+
+	l3_len = desc->len - (l3 - (uint8_t *)eth);
+
+	if (ethtype == ODPH_ETHTYPE_IPV4) {
+		ip = (odph_ipv4hdr_t *)(void *)l3;
+		ip->ver_ihl = ODPH_IPV4 << 4 | ODPH_IPV4HDR_IHL_MIN;
+		ip->tot_len = odp_cpu_to_be_16(l3_len);
+		ip->ttl = 64;
+		ip->proto = proto;
+		ip->src_addr = odp_cpu_to_be_32(0x0a000000 | (seq & 0xffff));
+		ip->dst_addr = odp_cpu_to_be_32(0x0a010001);
+		l4 = l3 + ODPH_IPV4HDR_LEN;
+		init_l4(l4, proto, l3_len - ODPH_IPV4HDR_LEN);
+	} else if (ethtype == ODPH_ETHTYPE_IPV6) {
+		ip6 = (odph_ipv6hdr_t *)(void *)l3;
+		ip6->ver_tc_flow = odp_cpu_to_be_32(ODPH_IPV6 << 28);
+		ip6->payload_len = odp_cpu_to_be_16(l3_len - ODPH_IPV6HDR_LEN);
+		ip6->next_hdr = proto;
+		ip6->hop_limit = 64;
+		ip6->src_addr[0] = 0xfd;
+		ip6->src_addr[15] = seq & 0xff;
+		ip6->dst_addr[0] = 0xfd;
+		ip6->dst_addr[15] = 1;
+		l4 = l3 + ODPH_IPV6HDR_LEN;
+		init_l4(l4, proto, l3_len - ODPH_IPV6HDR_LEN);
+	}
+
+	return pkt;
+}
+
+static odp_pktio_t open_pktio(const char *name, odp_pool_t pool)
+{
+	odp_pktio_param_t pktio_param;
+	odp_pktio_t pktio;
+
+	odp_pktio_param_init(&pktio_param);
+	pktio_param.in_mode = ODP_PKTIN_MODE_DIRECT;
+	pktio_param.out_mode = ODP_PKTOUT_MODE_DIRECT;
+
+	pktio = odp_pktio_open(name, pool, &pktio_param);
+	if (pktio == ODP_PKTIO_INVALID) {
+		app_err("failed to open %s\n", name);
+		return ODP_PKTIO_INVALID;
+	}
+
+	if (odp_pktin_queue_config(pktio, NULL) ||
+	    odp_pktout_queue_config(pktio, NULL) ||
+	    odp_pktio_start(pktio)) {
+		app_err("failed to configure %s\n", name);
+		odp_pktio_close(pktio);
+		return ODP_PKTIO_INVALID;
+	}
+
+	return pktio;
+}
+
+/* Read the metadata that a parser fills in. Returns 1 for TCP and UDP. */
+static inline int read_metadata(odp_packet_t pkt)
+{
+	uint32_t l3_offset = odp_packet_l3_offset(pkt);
+	uint32_t l4_offset = odp_packet_l4_offset(pkt);
+
+	if (odp_packet_has_error(pkt) ||
+	    l3_offset == ODP_PACKET_OFFSET_INVALID ||
+	    l4_offset == ODP_PACKET_OFFSET_INVALID)
+		return 0;
+
+	return (odp_packet_has_ipv4(pkt) || odp_packet_has_ipv6(pkt)) &&
+	       (odp_packet_has_udp(pkt) || odp_packet_has_tcp(pkt));
+}
+
+static int run_mix(odp_pktio_t pktio, odp_pool_t pool, const pkt_mix_t *mix,
+		   int rounds)
+{
+	odp_packet_t pkt[NUM_PKTS];
+	odp_pktin_queue_t pktin;
+	odp_pktout_queue_t pktout;
+	odp_time_t t1, t2;
+	uint64_t pkts = 0, bytes = 0;
+	uint64_t l4_pkts = 0;
+	double sec;
+	int i, r, num, sent, ret = 0;
+
+	if (odp_pktin_queue(pktio, &pktin, 1) != 1 ||
+	    odp_pktout_queue(pktio, &pktout, 1) != 1) {
+		app_err("no pktio queues\n");
+		return -1;
+	}
+
+	for (i = 0; i < NUM_PKTS; i++) {
+		pkt[i] = build_packet(pool, &mix->desc[i % mix->num], i);
+		if (pkt[i] == ODP_PACKET_INVALID) {
+			app_err("packet alloc failed\n");
+			odp_packet_free_multi(pkt, i);
+			return -1;
+		}
+	}
+
+	t1 = odp_time_local();
+	for (r = 0; r < rounds; r++) {
+		for (i = 0; i < NUM_PKTS; i += BURST_SIZE) {
+			sent = odp_pktout_send(pktout, &pkt[i], BURST_SIZE);
+			if (sent < 0)
+				sent = 0;
+
+			num = odp_pktin_recv(pktin, &pkt[i], sent);
+			if (num != BURST_SIZE) {
+				app_err("lost packets\n");
+				ret = -1;
+				goto out;
+			}
+
+			for (num = i; num < i + BURST_SIZE; num++) {
+				l4_pkts += read_metadata(pkt[num]);
+				bytes += odp_packet_len(pkt[num]);
+			}
+			pkts += BURST_SIZE;
+		}
+	}
+	t2 = odp_time_local();
+
+	sec = (double)odp_time_to_ns(odp_time_diff(t2, t1)) /
+	      ODP_TIME_SEC_IN_NS;
+	if (sec <= 0)
+		sec = 1e-9;
+
+	printf("  %-10s %10" PRIu64 " packets %8.3f Mpps %8.3f Gbps "
+	       "%7.1f ns/pkt, %5.1f %% TCP/UDP\n", mix->name, pkts,
+	       pkts / sec / 1e6, bytes * 8 / sec / 1e9, sec * 1e9 / pkts,
+	       100.0 * l4_pkts / pkts);
+
+out:
+	odp_packet_free_multi(pkt, NUM_PKTS);
+	return ret;
+}
+
+int main(int argc, char *argv[])
+{
+	perf_args_t args;
+	odp_instance_t instance;
+	odp_pool_param_t params;
+	odp_pool_t pool;
+	odp_pktio_t pktio;
+	unsigned i;
+	int ret = 0;
+
+	memset(&args, 0, sizeof(args));
+
+	/* Parse and store the application arguments */
+	parse_args(argc, argv, &args);
+
+	/* Init ODP before calling anything else */
+	if (odp_init_global(&instance, NULL, NULL)) {
+		app_err("ODP global init failed.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	/* Init this thread */
+	if (odp_init_local(instance, ODP_THREAD_CONTROL)) {
+		app_err("ODP local init failed.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	odp_pool_param_init(&params);
+	params.type        = ODP_POOL_PACKET;
+	params.pkt.num     = 2 * NUM_PKTS;
+	params.pkt.len     = 1518;
+	params.pkt.seg_len = 1518;
+
+	pool = odp_pool_create("parse_perf", &params);
+	if (pool == ODP_POOL_INVALID) {
+		app_err("pool create failed\n");
+		exit(EXIT_FAILURE);
+	}
+
+	pktio = open_pktio(args.if_name, pool);
+	if (pktio == ODP_PKTIO_INVALID)
+		exit(EXIT_FAILURE);
+
+	printf("\nPacket input parse performance, %s\n", args.if_name);
+
+	for (i = 0; i < NUM_MIXES && !ret; i++)
+		ret = run_mix(pktio, pool, &mix_tbl[i], args.rounds);
+	printf("\n");
+
+	odp_pktio_stop(pktio);
+	odp_pktio_close(pktio);
+
+	if (odp_pool_destroy(pool)) {
+		app_err("Error: pool destroy\n");
+		exit(EXIT_FAILURE);
+	}
+
+	if (odp_term_local()) {
+		app_err("Error: term local\n");
+		exit(EXIT_FAILURE);
+	}
+
+	if (odp_term_global(instance)) {
+		app_err("Error: term global\n");
+		exit(EXIT_FAILURE);
+	}
+
+	return ret ? EXIT_FAILURE : 0;
+}
+
+static void parse_args(int argc, char *argv[], perf_args_t *args)
+{
+	int opt;
+	int long_index;
+	static const struct option longopts[] = {
+		{"interface", required_argument, NULL, 'i'},
+		{"rounds", required_argument, NULL, 'r'},
+		{"help", no_argument, NULL, 'h'},
+		{NULL, 0, NULL, 0}
+	};
+
+	static const char *shortopts = "+i:r:h";
+
+	/* let helper collect its own arguments (e.g. --odph_proc) */
+	odph_parse_options(argc, argv, shortopts, longopts);
+
+	args->if_name = "loop";
+	args->rounds = 10000;
+
+	opterr = 0; /* do not issue errors on helper options */
+
+	while (1) {
+		opt = getopt_long(argc, argv, shortopts, longopts, &long_index);
+
+		if (opt == -1)
+			break;	/* No more options */
+
+		switch (opt) {
+		case 'i':
+			args->if_name = optarg;
+			break;
+		case 'r':
+			args->rounds = atoi(optarg);
+			break;
+		case 'h':
+			usage(argv[0]);
+			exit(EXIT_SUCCESS);
+			break;
+		default:
+			break;
+		}
+	}
+
+	optind = 1;		/* reset 'extern optind' from the getopt lib */
+
+	if (args->rounds <= 0) {
+		usage(argv[0]);
+		exit(EXIT_FAILURE);
+	}
+}
+
+/**
+ * Print usage information
+ */
+static void usage(char *progname)
+{
+	printf("\n"
+	       "Usage: %s OPTIONS\n"
+	       "  E.g. %s -r 100000\n"
+	       "\n"
+	       "OpenDataPlane packet input parse measurement. Packets of\n"
+	       "each traffic mix are sent into and received from a loopback\n"
+	       "pktio, and their L3 and L4 metadata is read.\n"
+	       "Optional OPTIONS\n"
+	       "  -i, --interface <name>  Loopback pktio (default loop)\n"
+	       "  -r, --rounds <number>   Rounds over %i packets (default 10000)\n"
+	       "  -h, --help              Display help and exit.\n"
+	       "\n", progname, progname, NUM_PKTS);
+}
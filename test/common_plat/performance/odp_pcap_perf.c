@@ -0,0 +1,431 @@
+/* Copyright (c) 2017, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:	BSD-3-Clause
+ */
+
+/**
+ * @file
+ *
+ * @example odp_pcap_perf.c  Capture file replay and capture rate measurement
+ *
+ * Measures the rate at which a file based pktio (e.g. "pcap" or "mpcap")
+ * writes generated packets into a capture file, and the rate at which it
+ * replays a capture file. By default, packets are captured into a temporary
+ * file with the mpcap pktio and the file is then replayed.
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif /* _GNU_SOURCE */
+
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <inttypes.h>
+
+#include <odp_api.h>
+#include <odp/helper/eth.h>
+#include <odp/helper/ip.h>
+#include <odp/helper/udp.h>
+#include <odp/helper/linux.h>
+
+#define app_err(fmt, ...) \
+	fprintf(stderr, "%s:%d:%s(): Error: " fmt, __FILE__, \
+		__LINE__, __func__, ##__VA_ARGS__)
+
+/** Packets per burst */
+#define BURST_SIZE 32
+
+/** Maximum number of pktin queues polled */
+#define MAX_QUEUES 8
+
+/** Receive gives up after this long without packets */
+#define IDLE_TIME_NS (200 * ODP_TIME_MSEC_IN_NS)
+
+/** Default capture file */
+#define DEFAULT_FILE "odp_pcap_perf.pcap"
+
+/** Parsed command line arguments */
+typedef struct {
+	/** Pktio name of the capture, NULL to skip */
+	const char *out_name;
+	/** Pktio name of the replay, NULL to skip */
+	const char *in_name;
+	/** Number of captured packets */
+	int num_pkts;
+	/** Length of captured packets */
+	int pkt_len;
+	/** Number of pktin queues on replay */
+	int num_queues;
+	/** Remove default capture file at exit */
+	int remove_file;
+} perf_args_t;
+
+static void parse_args(int argc, char *argv[], perf_args_t *args);
+static void usage(char *progname);
+
+static void print_rate(const char *name, uint64_t pkts, uint64_t bytes,
+		       odp_time_t t)
+{
+	double sec = (double)odp_time_to_ns(t) / ODP_TIME_SEC_IN_NS;
+
+	if (sec <= 0)
+		sec = 1e-9;
+
+	printf("  %-8s %10" PRIu64 " packets %8.3f s %8.3f Mpps %8.3f Gbps\n",
+	       name, pkts, sec, pkts / sec / 1e6, bytes * 8 / sec / 1e9);
+}
+
+static odp_pktio_t open_pktio(const char *name, odp_pool_t pool,
+			      int num_queues)
+{
+	odp_pktio_param_t pktio_param;
+	odp_pktin_queue_param_t pktin_param;
+	odp_pktio_t pktio;
+
+	odp_pktio_param_init(&pktio_param);
+	pktio_param.in_mode = ODP_PKTIN_MODE_DIRECT;
+	pktio_param.out_mode = ODP_PKTOUT_MODE_DIRECT;
+
+	pktio = odp_pktio_open(name, pool, &pktio_param);
+	if (pktio == ODP_PKTIO_INVALID) {
+		app_err("failed to open %s\n", name);
+		return ODP_PKTIO_INVALID;
+	}
+
+	odp_pktin_queue_param_init(&pktin_param);
+	pktin_param.op_mode = ODP_PKTIO_OP_MT_UNSAFE;
+	pktin_param.num_queues = num_queues;
+
+	if (odp_pktin_queue_config(pktio, &pktin_param) ||
+	    odp_pktout_queue_config(pktio, NULL) ||
+	    odp_pktio_start(pktio)) {
+		app_err("failed to configure %s\n", name);
+		odp_pktio_close(pktio);
+		return ODP_PKTIO_INVALID;
+	}
+
+	return pktio;
+}
+
+static void close_pktio(odp_pktio_t pktio)
+{
+	odp_pktio_stop(pktio);
+	odp_pktio_close(pktio);
+}
+
+/* UDP packet with source address varying per packet */
+static int init_packet(odp_packet_t pkt, uint32_t seq)
+{
+	uint32_t len = odp_packet_len(pkt);
+	odph_ethhdr_t *eth;
+	odph_ipv4hdr_t *ip;
+	odph_udphdr_t *udp;
+
+	eth = odp_packet_data(pkt);
+	memset(eth, 0, ODPH_ETHHDR_LEN + ODPH_IPV4HDR_LEN + ODPH_UDPHDR_LEN);
+	eth->dst.addr[0] = 0x02;
+	eth->dst.addr[5] = 0x01;
+	eth->src.addr[0] = 0x02;
+	eth->src.addr[5] = 0x02;
+	eth->type = odp_cpu_to_be_16(ODPH_ETHTYPE_IPV4);
+
+	ip = (odph_ipv4hdr_t *)(eth + 1);
+	ip->ver_ihl = ODPH_IPV4 << 4 | ODPH_IPV4HDR_IHL_MIN;
+	ip->tot_len = odp_cpu_to_be_16(len - ODPH_ETHHDR_LEN);
+	ip->ttl = 64;
+	ip->proto = ODPH_IPPROTO_UDP;
+	ip->src_addr = odp_cpu_to_be_32(0x0a000000 | (seq & 0xffff));
+	ip->dst_addr = odp_cpu_to_be_32(0x0a010001);
+
+	udp = (odph_udphdr_t *)(ip + 1);
+	udp->src_port = odp_cpu_to_be_16(1024);
+	udp->dst_port = odp_cpu_to_be_16(1025);
+	udp->length = odp_cpu_to_be_16(len - ODPH_ETHHDR_LEN -
+				       ODPH_IPV4HDR_LEN);
+
+	odp_packet_l2_offset_set(pkt, 0);
+	odp_packet_l3_offset_set(pkt, ODPH_ETHHDR_LEN);
+	odp_packet_has_eth_set(pkt, 1);
+	odp_packet_has_ipv4_set(pkt, 1);
+
+	return odph_ipv4_csum_update(pkt);
+}
+
+static int run_capture(const perf_args_t *args, odp_pool_t pool)
+{
+	odp_pktout_queue_t pktout;
+	odp_packet_t pkt[BURST_SIZE];
+	odp_pktio_t pktio;
+	odp_time_t t1, t2;
+	uint64_t sent = 0;
+	int i, num, ret;
+
+	pktio = open_pktio(args->out_name, pool, 1);
+	if (pktio == ODP_PKTIO_INVALID)
+		return -1;
+
+	if (odp_pktout_queue(pktio, &pktout, 1) != 1) {
+		app_err("no pktout queue\n");
+		close_pktio(pktio);
+		return -1;
+	}
+
+	t1 = odp_time_local();
+	while (sent < (uint64_t)args->num_pkts) {
+		num = odp_packet_alloc_multi(pool, args->pkt_len, pkt,
+					     BURST_SIZE);
+		if (num <= 0) {
+			app_err("packet alloc failed\n");
+			break;
+		}
+
+		for (i = 0; i < num; i++)
+			init_packet(pkt[i], sent + i);
+
+		ret = odp_pktout_send(pktout, pkt, num);
+		if (ret < 0)
+			ret = 0;
+		if (ret < num)
+			odp_packet_free_multi(&pkt[ret], num - ret);
+		sent += ret;
+	}
+
+	/* Stop writes out buffered data */
+	odp_pktio_stop(pktio);
+	t2 = odp_time_local();
+	odp_pktio_close(pktio);
+
+	print_rate("capture", sent, sent * args->pkt_len,
+		   odp_time_diff(t2, t1));
+	return 0;
+}
+
+static int run_replay(const perf_args_t *args, odp_pool_t pool)
+{
+	odp_pktin_queue_t pktin[MAX_QUEUES];
+	odp_packet_t pkt[BURST_SIZE];
+	odp_pktio_capability_t capa;
+	odp_pktio_t pktio;
+	odp_time_t t1, t2, last;
+	uint64_t pkts = 0, bytes = 0;
+	int num_queues = args->num_queues;
+	int q, i, num;
+
+	pktio = open_pktio(args->in_name, pool, 1);
+	if (pktio == ODP_PKTIO_INVALID)
+		return -1;
+
+	if (num_queues > 1) {
+		/* Reopen with the number of queues supported */
+		if (odp_pktio_capability(pktio, &capa) == 0 &&
+		    capa.max_input_queues < (unsigned)num_queues)
+			num_queues = capa.max_input_queues;
+		close_pktio(pktio);
+		pktio = open_pktio(args->in_name, pool, num_queues);
+		if (pktio == ODP_PKTIO_INVALID)
+			return -1;
+	}
+
+	if (odp_pktin_queue(pktio, pktin, num_queues) != num_queues) {
+		app_err("no pktin queues\n");
+		close_pktio(pktio);
+		return -1;
+	}
+
+	t1 = odp_time_local();
+	last = t1;
+	while (odp_time_to_ns(odp_time_diff(odp_time_local(), last)) <
+	       IDLE_TIME_NS) {
+		for (q = 0; q < num_queues; q++) {
+			num = odp_pktin_recv(pktin[q], pkt, BURST_SIZE);
+			if (num <= 0)
+				continue;
+
+			for (i = 0; i < num; i++)
+				bytes += odp_packet_len(pkt[i]);
+			odp_packet_free_multi(pkt, num);
+			pkts += num;
+			last = odp_time_local();
+		}
+	}
+	t2 = last;
+
+	close_pktio(pktio);
+
+	print_rate("replay", pkts, bytes, odp_time_diff(t2, t1));
+	return 0;
+}
+
+int main(int argc, char *argv[])
+{
+	perf_args_t args;
+	odp_instance_t instance;
+	odp_pool_param_t params;
+	odp_pool_t pool;
+	int ret = 0;
+
+	memset(&args, 0, sizeof(args));
+
+	/* Parse and store the application arguments */
+	parse_args(argc, argv, &args);
+
+	/* Init ODP before calling anything else */
+	if (odp_init_global(&instance, NULL, NULL)) {
+		app_err("ODP global init failed.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	/* Init this thread */
+	if (odp_init_local(instance, ODP_THREAD_CONTROL)) {
+		app_err("ODP local init failed.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	odp_pool_param_init(&params);
+	params.type        = ODP_POOL_PACKET;
+	params.pkt.num     = 8 * BURST_SIZE * MAX_QUEUES;
+	params.pkt.len     = 1518;
+	params.pkt.seg_len = 1518;
+
+	pool = odp_pool_create("pcap_perf", &params);
+	if (pool == ODP_POOL_INVALID) {
+		app_err("pool create failed\n");
+		exit(EXIT_FAILURE);
+	}
+
+	printf("\nCapture file pktio performance\n");
+
+	if (args.out_name) {
+		printf("  out: %s\n", args.out_name);
+		if (run_capture(&args, pool))
+			ret = -1;
+	}
+
+	if (args.in_name && !ret) {
+		printf("  in:  %s, %i queue(s)\n", args.in_name,
+		       args.num_queues);
+		if (run_replay(&args, pool))
+			ret = -1;
+	}
+	printf("\n");
+
+	if (args.remove_file)
+		unlink(DEFAULT_FILE);
+
+	if (odp_pool_destroy(pool)) {
+		app_err("Error: pool destroy\n");
+		exit(EXIT_FAILURE);
+	}
+
+	if (odp_term_local()) {
+		app_err("Error: term local\n");
+		exit(EXIT_FAILURE);
+	}
+
+	if (odp_term_global(instance)) {
+		app_err("Error: term global\n");
+		exit(EXIT_FAILURE);
+	}
+
+	return ret ? EXIT_FAILURE : 0;
+}
+
+static void parse_args(int argc, char *argv[], perf_args_t *args)
+{
+	int opt;
+	int long_index;
+	static const struct option longopts[] = {
+		{"out", required_argument, NULL, 'o'},
+		{"in", required_argument, NULL, 'i'},
+		{"num", required_argument, NULL, 'n'},
+		{"len", required_argument, NULL, 'l'},
+		{"queues", required_argument, NULL, 'q'},
+		{"help", no_argument, NULL, 'h'},
+		{NULL, 0, NULL, 0}
+	};
+
+	static const char *shortopts = "+o:i:n:l:q:h";
+
+	/* let helper collect its own arguments (e.g. --odph_proc) */
+	odph_parse_options(argc, argv, shortopts, longopts);
+
+	args->num_pkts = 1000000;
+	args->pkt_len = 64;
+	args->num_queues = 1;
+
+	opterr = 0; /* do not issue errors on helper options */
+
+	while (1) {
+		opt = getopt_long(argc, argv, shortopts, longopts, &long_index);
+
+		if (opt == -1)
+			break;	/* No more options */
+
+		switch (opt) {
+		case 'o':
+			args->out_name = optarg;
+			break;
+		case 'i':
+			args->in_name = optarg;
+			break;
+		case 'n':
+			args->num_pkts = atoi(optarg);
+			break;
+		case 'l':
+			args->pkt_len = atoi(optarg);
+			break;
+		case 'q':
+			args->num_queues = atoi(optarg);
+			break;
+		case 'h':
+			usage(argv[0]);
+			exit(EXIT_SUCCESS);
+			break;
+		default:
+			break;
+		}
+	}
+
+	optind = 1;		/* reset 'extern optind' from the getopt lib */
+
+	if (!args->out_name && !args->in_name) {
+		args->out_name = "mpcap:out=" DEFAULT_FILE;
+		args->in_name = "mpcap:in=" DEFAULT_FILE;
+		args->remove_file = 1;
+	}
+
+	if (args->num_pkts <= 0 || args->num_queues <= 0 ||
+	    args->num_queues > MAX_QUEUES ||
+	    args->pkt_len < ODPH_ETHHDR_LEN + ODPH_IPV4HDR_LEN +
+	    ODPH_UDPHDR_LEN || args->pkt_len > 1518) {
+		usage(argv[0]);
+		exit(EXIT_FAILURE);
+	}
+}
+
+/**
+ * Print usage information
+ */
+static void usage(char *progname)
+{
+	printf("\n"
+	       "Usage: %s OPTIONS\n"
+	       "  E.g. %s -o mpcap:out=test.pcap -n 1000000\n"
+	       "       %s -i mpcap:in=test.pcap:loops=10 -q 4\n"
+	       "       %s -i pcap:in=test.pcap:loops=10\n"
+	       "\n"
+	       "OpenDataPlane capture file pktio measurement. Without options\n"
+	       "captures to and replays from a temporary file with mpcap.\n"
+	       "Optional OPTIONS\n"
+	       "  -o, --out <name>     Capture into pktio <name>\n"
+	       "  -i, --in <name>      Replay from pktio <name>\n"
+	       "  -n, --num <number>   Packets to capture (default 1000000)\n"
+	       "  -l, --len <bytes>    Length of captured packets (default 64)\n"
+	       "  -q, --queues <num>   Pktin queues on replay (default 1, max %i)\n"
+	       "  -h, --help           Display help and exit.\n"
+	       "\n", progname, progname, progname, progname, MAX_QUEUES);
+}
@@ -40,6 +40,7 @@
 #define MAX_NUM_IFACES    2
 #define TEST_HDR_MAGIC    0x92749451
 #define MAX_WORKERS       32
+#define MAX_NUM_QUEUES    MAX_WORKERS
 #define BATCH_LEN_MAX     32
 
 /* Packet rate at which to start when using binary search */
@@ -85,10 +86,15 @@ typedef struct {
 				   thread statistics */
 	unsigned pkt_len;	/* Packet payload length in bytes (not
 				   including headers) */
+	int      num_queues;	/* Number of pktin and pktout queues. Flows
+				   are spread over pktin queues by hash. */
 	int      search;	/* Set implicitly when pps is not configured.
 				   Perform a search at different packet rates
 				   to determine the maximum rate at which no
 				   packet loss occurs. */
+	int      ts_mode;	/* Packet input timestamping: 0 off,
+				   1 per packet, 2 per burst, 3 per burst
+				   with interpolation */
 
 	char     *if_str;
 	const char *ifaces[MAX_NUM_IFACES];
@@ -125,6 +131,8 @@ typedef struct {
 	odp_barrier_t tx_barrier;
 	odp_pktio_t pktio_tx;
 	odp_pktio_t pktio_rx;
+	int num_tx_queues;
+	int num_rx_queues;
 	pkt_rx_stats_t *rx_stats;
 	pkt_tx_stats_t *tx_stats;
 	uint8_t src_mac[ODPH_ETHADDR_LEN];
@@ -218,7 +226,9 @@ static odp_packet_t pktio_create_packet(void)
 	offset += ODPH_IPV4HDR_LEN;
 	odp_packet_l4_offset_set(pkt, offset);
 	udp = (odph_udphdr_t *)(buf + offset);
-	udp->src_port = odp_cpu_to_be_16(0);
+	/* Vary flows to spread packets over multiple pktin queues */
+	udp->src_port = odp_cpu_to_be_16(gbl_args->args.num_queues > 1 ?
+					 seq : 0);
 	udp->dst_port = odp_cpu_to_be_16(0);
 	udp->length = odp_cpu_to_be_16(payload_len + ODPH_UDPHDR_LEN);
 	udp->chksum = 0;
@@ -309,7 +319,7 @@ static int run_thread_tx(void *arg)
 {
 	test_globals_t *globals;
 	int thr_id;
-	odp_pktout_queue_t pktout;
+	odp_pktout_queue_t pktout[MAX_NUM_QUEUES];
 	pkt_tx_stats_t *stats;
 	odp_time_t cur_time, send_time_end, send_duration;
 	odp_time_t burst_gap_end, burst_gap;
@@ -330,7 +340,8 @@ static int run_thread_tx(void *arg)
 	globals = odp_shm_addr(odp_shm_lookup("test_globals"));
 	stats = &globals->tx_stats[thr_id];
 
-	if (odp_pktout_queue(globals->pktio_tx, &pktout, 1) != 1)
+	if (odp_pktout_queue(globals->pktio_tx, pktout, MAX_NUM_QUEUES) !=
+	    globals->num_tx_queues)
 		LOG_ABORT("Failed to get output queue for thread %d\n", thr_id);
 
 	burst_gap = odp_time_local_from_ns(
@@ -368,7 +379,8 @@ static int run_thread_tx(void *arg)
 		if (alloc_cnt != batch_len)
 			stats->s.alloc_failures++;
 
-		tx_cnt = send_packets(pktout, tx_packet, alloc_cnt);
+		tx_cnt = send_packets(pktout[thr_id % globals->num_tx_queues],
+				      tx_packet, alloc_cnt);
 		unsent_pkts = alloc_cnt - tx_cnt;
 		stats->s.enq_failures += unsent_pkts;
 		stats->s.tx_cnt += tx_cnt;
@@ -418,7 +430,11 @@ static int run_thread_rx(void *arg)
 	test_globals_t *globals;
 	int thr_id, batch_len;
 	odp_queue_t queue = ODP_QUEUE_INVALID;
+	odp_queue_t queues[MAX_NUM_QUEUES];
 	odp_packet_t pkt;
+	int num_queues = 0;
+	int poll = 0;
+	int empty = 0;
 
 	thread_args_t *targs = arg;
 
@@ -434,7 +450,9 @@ static int run_thread_rx(void *arg)
 	pkt_rx_stats_t *stats = &globals->rx_stats[thr_id];
 
 	if (gbl_args->args.schedule == 0) {
-		if (odp_pktin_event_queue(globals->pktio_rx, &queue, 1) != 1)
+		num_queues = odp_pktin_event_queue(globals->pktio_rx, queues,
+						   MAX_NUM_QUEUES);
+		if (num_queues != globals->num_rx_queues)
 			LOG_ABORT("No input queue.\n");
 	}
 
@@ -443,6 +461,11 @@ static int run_thread_rx(void *arg)
 		odp_event_t ev[BATCH_LEN_MAX];
 		int i, n_ev;
 
+		/* Every thread polls all plain queues, starting from
+		 * a different one */
+		if (num_queues)
+			queue = queues[(thr_id + poll++) % num_queues];
+
 		n_ev = receive_packets(queue, ev, batch_len);
 
 		for (i = 0; i < n_ev; ++i) {
@@ -455,7 +478,10 @@ static int run_thread_rx(void *arg)
 			}
 			odp_event_free(ev[i]);
 		}
-		if (n_ev == 0 && odp_atomic_load_u32(&shutdown))
+		/* Exit once every queue has been seen empty after
+		 * shutdown */
+		empty = n_ev ? 0 : empty + 1;
+		if (empty >= num_queues && odp_atomic_load_u32(&shutdown))
 			break;
 	}
 
@@ -685,6 +711,8 @@ static int run_test(void)
 	       gbl_args->args.rx_batch_len);
 	printf("\tPacket receive method:\t%s\n",
 	       gbl_args->args.schedule ? "schedule" : "plain");
+	printf("\tQueues (tx/rx):       \t%d/%d\n",
+	       gbl_args->num_tx_queues, gbl_args->num_rx_queues);
 	printf("\tInterface(s):         \t");
 	for (i = 0; i < gbl_args->args.num_ifaces; ++i)
 		printf("%s ", gbl_args->args.ifaces[i]);
@@ -734,6 +762,69 @@ static odp_pktio_t create_pktio(const char *iface, int schedule)
 	return pktio;
 }
 
+/*
+ * Enable packet input timestamps in the requested mode
+ */
+static int config_ts(odp_pktio_t pktio, odp_pktio_capability_t *capa)
+{
+	odp_pktio_config_t config;
+	int mode = gbl_args->args.ts_mode;
+
+	if (mode == 0)
+		return 0;
+
+	odp_pktio_config_init(&config);
+	config.pktin.bit.ts_all    = 1;
+	config.pktin.bit.ts_batch  = mode >= 2;
+	config.pktin.bit.ts_interp = mode == 3;
+
+	if (config.pktin.all_bits & ~capa->config.pktin.all_bits) {
+		LOG_ERR("timestamp mode %d not supported\n", mode);
+		return -1;
+	}
+
+	return odp_pktio_config(pktio, &config);
+}
+
+/*
+ * Configure pktin and pktout queues. Multiple pktin queues spread flows by
+ * hash. Returns number of queues or -1 on failure.
+ */
+static int config_queues(odp_pktio_t pktio)
+{
+	odp_pktio_capability_t capa;
+	odp_pktin_queue_param_t pktin_param;
+	odp_pktout_queue_param_t pktout_param;
+	unsigned num_queues = gbl_args->args.num_queues;
+
+	if (odp_pktio_capability(pktio, &capa))
+		return -1;
+
+	if (config_ts(pktio, &capa))
+		return -1;
+
+	if (num_queues > capa.max_input_queues)
+		num_queues = capa.max_input_queues;
+	if (num_queues > capa.max_output_queues)
+		num_queues = capa.max_output_queues;
+
+	odp_pktout_queue_param_init(&pktout_param);
+	pktout_param.num_queues = num_queues;
+
+	if (odp_pktout_queue_config(pktio, &pktout_param))
+		return -1;
+
+	odp_pktin_queue_param_init(&pktin_param);
+	pktin_param.num_queues = num_queues;
+	pktin_param.hash_enable = num_queues > 1;
+	pktin_param.hash_proto.proto.ipv4_udp = 1;
+
+	if (odp_pktin_queue_config(pktio, &pktin_param))
+		return -1;
+
+	return num_queues;
+}
+
 static int test_init(void)
 {
 	odp_pool_param_t params;
@@ -776,25 +867,17 @@ static int test_init(void)
 		return -1;
 	}
 
-	/* Create single queue with default parameters */
-	if (odp_pktout_queue_config(gbl_args->pktio_tx, NULL)) {
-		LOG_ERR("failed to configure pktio_tx queue\n");
-		return -1;
-	}
-
-	/* Configure also input side (with defaults) */
-	if (odp_pktin_queue_config(gbl_args->pktio_tx, NULL)) {
+	/* Create single queue (or the requested number of queues) */
+	gbl_args->num_tx_queues = config_queues(gbl_args->pktio_tx);
+	if (gbl_args->num_tx_queues < 0) {
 		LOG_ERR("failed to configure pktio_tx queue\n");
 		return -1;
 	}
+	gbl_args->num_rx_queues = gbl_args->num_tx_queues;
 
 	if (gbl_args->args.num_ifaces > 1) {
-		if (odp_pktout_queue_config(gbl_args->pktio_rx, NULL)) {
-			LOG_ERR("failed to configure pktio_rx queue\n");
-			return -1;
-		}
-
-		if (odp_pktin_queue_config(gbl_args->pktio_rx, NULL)) {
+		gbl_args->num_rx_queues = config_queues(gbl_args->pktio_rx);
+		if (gbl_args->num_rx_queues < 0) {
 			LOG_ERR("failed to configure pktio_rx queue\n");
 			return -1;
 		}
@@ -811,26 +894,30 @@ static int test_init(void)
 
 static int empty_inq(odp_pktio_t pktio)
 {
-	odp_queue_t queue;
+	odp_queue_t queue[MAX_NUM_QUEUES];
 	odp_event_t ev;
 	odp_queue_type_t q_type;
+	int i, num;
 
-	if (odp_pktin_event_queue(pktio, &queue, 1) != 1)
+	num = odp_pktin_event_queue(pktio, queue, MAX_NUM_QUEUES);
+	if (num < 1)
 		return -1;
 
-	q_type = odp_queue_type(queue);
+	q_type = odp_queue_type(queue[0]);
 
 	/* flush any pending events */
-	while (1) {
-		if (q_type == ODP_QUEUE_TYPE_PLAIN)
-			ev = odp_queue_deq(queue);
-		else
-			ev = odp_schedule(NULL, ODP_SCHED_NO_WAIT);
-
-		if (ev != ODP_EVENT_INVALID)
-			odp_event_free(ev);
-		else
-			break;
+	for (i = 0; i < num; i++) {
+		while (1) {
+			if (q_type == ODP_QUEUE_TYPE_PLAIN)
+				ev = odp_queue_deq(queue[i]);
+			else
+				ev = odp_schedule(NULL, ODP_SCHED_NO_WAIT);
+
+			if (ev != ODP_EVENT_INVALID)
+				odp_event_free(ev);
+			else
+				break;
+		}
 	}
 
 	return 0;
@@ -913,6 +1000,12 @@ static void usage(void)
 	printf("  -r, --rate <number>    Attempted packet rate in PPS\n");
 	printf("  -i, --interface <list> List of interface names to use\n");
 	printf("  -d, --duration <secs>  Duration of each test iteration\n");
+	printf("  -q, --queues <number>  Number of pktin/pktout queues\n");
+	printf("                         default: 1, e.g. multi-core loop\n");
+	printf("  -T, --timestamp <mode> Packet input timestamps\n");
+	printf("                         0: off (default), 1: per packet,\n");
+	printf("                         2: per burst, 3: per burst with\n");
+	printf("                         interpolation\n");
 	printf("  -v, --verbose          Print verbose information\n");
 	printf("  -h, --help             This help\n");
 	printf("\n");
@@ -933,12 +1026,14 @@ static void parse_args(int argc, char *argv[], test_args_t *args)
 		{"rate",      required_argument, NULL, 'r'},
 		{"interface", required_argument, NULL, 'i'},
 		{"duration",  required_argument, NULL, 'd'},
+		{"queues",    required_argument, NULL, 'q'},
+		{"timestamp", required_argument, NULL, 'T'},
 		{"verbose",   no_argument,       NULL, 'v'},
 		{"help",      no_argument,       NULL, 'h'},
 		{NULL, 0, NULL, 0}
 	};
 
-	static const char *shortopts = "+c:t:b:pR:l:r:i:d:vh";
+	static const char *shortopts = "+c:t:b:pR:l:r:i:d:q:T:vh";
 
 	/* let helper collect its own arguments (e.g. --odph_proc) */
 	odph_parse_options(argc, argv, shortopts, longopts);
@@ -952,6 +1047,8 @@ static void parse_args(int argc, char *argv[], test_args_t *args)
 	args->search         = 1;
 	args->schedule       = 1;
 	args->verbose        = 0;
+	args->num_queues     = 1;
+	args->ts_mode        = 0;
 
 	opterr = 0; /* do not issue errors on helper options */
 
@@ -1011,9 +1108,21 @@ static void parse_args(int argc, char *argv[], test_args_t *args)
 		case 'l':
 			args->pkt_len = atoi(optarg);
 			break;
+		case 'q':
+			args->num_queues = atoi(optarg);
+			break;
+		case 'T':
+			args->ts_mode = atoi(optarg);
+			break;
 		}
 	}
 
+	if (args->num_queues < 1 || args->num_queues > MAX_NUM_QUEUES)
+		LOG_ABORT("Invalid number of queues\n");
+
+	if (args->ts_mode < 0 || args->ts_mode > 3)
+		LOG_ABORT("Invalid timestamp mode\n");
+
 	if (args->num_ifaces == 0) {
 		args->ifaces[0] = "loop";
 		args->num_ifaces = 1;
@@ -0,0 +1,368 @@
+/* Copyright (c) 2017, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:	BSD-3-Clause
+ */
+
+/**
+ * @file
+ *
+ * @example odp_time_perf.c  Time API function measurement and a check of
+ *			     global time monotonicity across worker threads
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif /* _GNU_SOURCE */
+
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+#include <stdio.h>
+#include <inttypes.h>
+#include <time.h>
+
+#include <odp_api.h>
+#include <odp/helper/linux.h>
+
+/** Number of elements in an array */
+#define ARRAY_SIZE(x) (sizeof(x) / sizeof((x)[0]))
+
+#define app_err(fmt, ...) \
+	fprintf(stderr, "%s:%d:%s(): Error: " fmt, __FILE__, \
+		__LINE__, __func__, ##__VA_ARGS__)
+
+/** Calls per measurement round */
+#define NUM_CALLS 1000
+
+/** Parsed command line arguments */
+typedef struct {
+	/** Number of measurement rounds */
+	int rounds;
+	/** Number of worker threads in the monotonicity check */
+	int workers;
+	/** Duration of the monotonicity check in milliseconds */
+	int check_ms;
+} time_args_t;
+
+/** Shared data of the monotonicity check */
+typedef struct {
+	/** Latest time read by any thread */
+	odp_atomic_u64_t latest;
+	/** Reads earlier than a read of another thread, or the thread itself */
+	odp_atomic_u64_t errors;
+	/** Total number of reads */
+	odp_atomic_u64_t reads;
+	/** Workers start together */
+	odp_barrier_t barrier;
+	/** Duration of the check in nanoseconds */
+	uint64_t check_ns;
+} check_globals_t;
+
+/** Measured function, returns a value which depends on the call */
+typedef uint64_t (*bench_fn_t)(void);
+
+static void parse_args(int argc, char *argv[], time_args_t *args);
+static void usage(char *progname);
+
+static uint64_t bench_time_local(void)
+{
+	return odp_time_to_u64(odp_time_local());
+}
+
+static uint64_t bench_time_global(void)
+{
+	return odp_time_to_u64(odp_time_global());
+}
+
+static uint64_t bench_time_diff_ns(void)
+{
+	static odp_time_t prev;
+	odp_time_t cur = odp_time_local();
+	uint64_t ns = odp_time_to_ns(odp_time_diff(cur, prev));
+
+	prev = cur;
+	return ns;
+}
+
+static uint64_t bench_time_cmp_sum(void)
+{
+	odp_time_t cur = odp_time_local();
+	odp_time_t end = odp_time_sum(cur, odp_time_local_from_ns(1000));
+
+	return odp_time_cmp(end, cur);
+}
+
+static uint64_t bench_cpu_cycles(void)
+{
+	return odp_cpu_cycles();
+}
+
+static uint64_t bench_clock_gettime(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+	return ts.tv_nsec;
+}
+
+static const struct {
+	const char *name;
+	bench_fn_t fn;
+} bench_tbl[] = {
+	{"odp_time_local", bench_time_local},
+	{"odp_time_global", bench_time_global},
+	{"odp_time_local + diff + to_ns", bench_time_diff_ns},
+	{"odp_time_local + sum + cmp", bench_time_cmp_sum},
+	{"odp_cpu_cycles", bench_cpu_cycles},
+	{"clock_gettime (MONOTONIC_RAW)", bench_clock_gettime},
+};
+
+#define NUM_BENCH ARRAY_SIZE(bench_tbl)
+
+/* Sink of results, so that calls are not optimized away */
+uint64_t bench_sink;
+
+static void run_bench(const time_args_t *args, unsigned int b)
+{
+	odp_time_t t1, t2;
+	uint64_t ns, min_ns = UINT64_MAX, sum_ns = 0;
+	uint64_t sum = 0;
+	int i, r;
+
+	for (r = 0; r < args->rounds; r++) {
+		t1 = odp_time_local();
+		for (i = 0; i < NUM_CALLS; i++)
+			sum += bench_tbl[b].fn();
+		t2 = odp_time_local();
+
+		ns = odp_time_to_ns(odp_time_diff(t2, t1));
+		sum_ns += ns;
+		if (ns < min_ns)
+			min_ns = ns;
+	}
+
+	bench_sink = sum;
+
+	printf("  %-32s %8.1f ns %8.1f ns\n", bench_tbl[b].name,
+	       (double)min_ns / NUM_CALLS,
+	       (double)sum_ns / ((uint64_t)args->rounds * NUM_CALLS));
+}
+
+static check_globals_t *check_globals(void)
+{
+	return odp_shm_addr(odp_shm_lookup("time_perf_check"));
+}
+
+/*
+ * Every thread reads the latest time of all threads before reading its own
+ * time. The read may not be earlier than the latest time, which was read
+ * before it.
+ */
+static int run_check(void *arg ODP_UNUSED)
+{
+	check_globals_t *globals = check_globals();
+	odp_time_t start, end;
+	uint64_t latest, cur, prev = 0;
+	uint64_t reads = 0, errors = 0;
+
+	odp_barrier_wait(&globals->barrier);
+
+	start = odp_time_global();
+	end = odp_time_sum(start, odp_time_global_from_ns(globals->check_ns));
+
+	do {
+		latest = odp_atomic_load_acq_u64(&globals->latest);
+		cur = odp_time_to_ns(odp_time_global());
+
+		if (cur < latest || cur < prev)
+			errors++;
+
+		odp_atomic_max_u64(&globals->latest, cur);
+		prev = cur;
+		reads++;
+	} while (odp_time_cmp(end, odp_time_global_from_ns(cur)) > 0);
+
+	odp_atomic_add_u64(&globals->reads, reads);
+	odp_atomic_add_u64(&globals->errors, errors);
+
+	return 0;
+}
+
+static int check_monotonic(odp_instance_t instance, const time_args_t *args)
+{
+	odph_odpthread_t thread_tbl[ODP_THREAD_COUNT_MAX];
+	odph_odpthread_params_t thr_params;
+	odp_cpumask_t cpumask;
+	char cpumaskstr[ODP_CPUMASK_STR_SIZE];
+	check_globals_t *globals;
+	odp_shm_t shm;
+	uint64_t errors;
+	int num_workers;
+
+	shm = odp_shm_reserve("time_perf_check", sizeof(check_globals_t),
+			      ODP_CACHE_LINE_SIZE, 0);
+	if (shm == ODP_SHM_INVALID) {
+		app_err("shm reserve failed\n");
+		return -1;
+	}
+
+	globals = odp_shm_addr(shm);
+	memset(globals, 0, sizeof(*globals));
+
+	num_workers = odp_cpumask_default_worker(&cpumask, args->workers);
+	(void)odp_cpumask_to_str(&cpumask, cpumaskstr, sizeof(cpumaskstr));
+
+	odp_atomic_init_u64(&globals->latest, 0);
+	odp_atomic_init_u64(&globals->errors, 0);
+	odp_atomic_init_u64(&globals->reads, 0);
+	odp_barrier_init(&globals->barrier, num_workers);
+	globals->check_ns = (uint64_t)args->check_ms * ODP_TIME_MSEC_IN_NS;
+
+	printf("Global time monotonicity, %i workers (CPU mask %s), %i ms\n",
+	       num_workers, cpumaskstr, args->check_ms);
+
+	memset(&thr_params, 0, sizeof(thr_params));
+	thr_params.thr_type = ODP_THREAD_WORKER;
+	thr_params.instance = instance;
+	thr_params.start = run_check;
+	thr_params.arg = NULL;
+
+	odph_odpthreads_create(thread_tbl, &cpumask, &thr_params);
+	odph_odpthreads_join(thread_tbl);
+
+	errors = odp_atomic_load_u64(&globals->errors);
+	printf("  %" PRIu64 " reads, %" PRIu64 " went backwards\n\n",
+	       odp_atomic_load_u64(&globals->reads), errors);
+
+	if (odp_shm_free(shm)) {
+		app_err("shm free failed\n");
+		return -1;
+	}
+
+	return errors ? -1 : 0;
+}
+
+int main(int argc, char *argv[])
+{
+	time_args_t args;
+	odp_instance_t instance;
+	unsigned int b;
+	int ret = 0;
+
+	memset(&args, 0, sizeof(args));
+
+	/* Parse and store the application arguments */
+	parse_args(argc, argv, &args);
+
+	/* Init ODP before calling anything else */
+	if (odp_init_global(&instance, NULL, NULL)) {
+		app_err("ODP global init failed.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	/* Init this thread */
+	if (odp_init_local(instance, ODP_THREAD_CONTROL)) {
+		app_err("ODP local init failed.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	printf("\nTime API performance, %i rounds of %i calls\n"
+	       "Local time resolution %" PRIu64 " Hz\n"
+	       "Time per call, %-19s  minimum  average\n\n",
+	       args.rounds, NUM_CALLS, odp_time_local_res(), "");
+
+	for (b = 0; b < NUM_BENCH; b++)
+		run_bench(&args, b);
+	printf("\n");
+
+	if (check_monotonic(instance, &args))
+		ret = -1;
+
+	if (odp_term_local()) {
+		app_err("Error: term local\n");
+		exit(EXIT_FAILURE);
+	}
+
+	if (odp_term_global(instance)) {
+		app_err("Error: term global\n");
+		exit(EXIT_FAILURE);
+	}
+
+	return ret ? EXIT_FAILURE : 0;
+}
+
+static void parse_args(int argc, char *argv[], time_args_t *args)
+{
+	int opt;
+	int long_index;
+	static const struct option longopts[] = {
+		{"rounds", required_argument, NULL, 'n'},
+		{"workers", required_argument, NULL, 'c'},
+		{"time", required_argument, NULL, 't'},
+		{"help", no_argument, NULL, 'h'},
+		{NULL, 0, NULL, 0}
+	};
+
+	static const char *shortopts = "+n:c:t:h";
+
+	/* let helper collect its own arguments (e.g. --odph_proc) */
+	odph_parse_options(argc, argv, shortopts, longopts);
+
+	args->rounds = 1000;
+	args->workers = 0;
+	args->check_ms = 1000;
+
+	opterr = 0; /* do not issue errors on helper options */
+
+	while (1) {
+		opt = getopt_long(argc, argv, shortopts, longopts, &long_index);
+
+		if (opt == -1)
+			break;	/* No more options */
+
+		switch (opt) {
+		case 'n':
+			args->rounds = atoi(optarg);
+			break;
+		case 'c':
+			args->workers = atoi(optarg);
+			break;
+		case 't':
+			args->check_ms = atoi(optarg);
+			break;
+		case 'h':
+			usage(argv[0]);
+			exit(EXIT_SUCCESS);
+			break;
+		default:
+			break;
+		}
+	}
+
+	optind = 1;		/* reset 'extern optind' from the getopt lib */
+
+	if (args->rounds <= 0 || args->workers < 0 || args->check_ms <= 0) {
+		usage(argv[0]);
+		exit(EXIT_FAILURE);
+	}
+}
+
+/**
+ * Print usage information
+ */
+static void usage(char *progname)
+{
+	printf("\n"
+	       "Usage: %s OPTIONS\n"
+	       "  E.g. %s -n 1000 -c 4\n"
+	       "\n"
+	       "OpenDataPlane time API function measurement.\n"
+	       "Optional OPTIONS\n"
+	       "  -n, --rounds <number>  Measurement rounds (default 1000)\n"
+	       "  -c, --workers <number> Worker threads of the monotonicity\n"
+	       "                         check (default all worker CPUs)\n"
+	       "  -t, --time <ms>        Duration of the check (default 1000)\n"
+	       "  -h, --help             Display help and exit.\n"
+	       "\n", progname, progname);
+}
@@ -0,0 +1,599 @@
+/* Copyright (c) 2017, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:	BSD-3-Clause
+ */
+
+/**
+ * @file
+ *
+ * @example odp_tm_perf.c  Traffic manager CPU use at different shaping rates
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif /* _GNU_SOURCE */
+
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+#include <stdio.h>
+#include <inttypes.h>
+#include <time.h>
+#include <sys/resource.h>
+
+#include <odp_api.h>
+#include <odp/helper/linux.h>
+
+/** Number of elements in an array */
+#define ARRAY_SIZE(x) (sizeof(x) / sizeof((x)[0]))
+
+#define app_err(fmt, ...) \
+	fprintf(stderr, "%s:%d:%s(): Error: " fmt, __FILE__, \
+		__LINE__, __func__, ##__VA_ARGS__)
+
+/** Maximum number of shaping rates */
+#define MAX_RATES 16
+
+/** Packets in the pool */
+#define PKT_NUM 4096
+
+/** Interval of the traffic generator */
+#define GEN_INTERVAL_NS (ODP_TIME_MSEC_IN_NS)
+
+/** Maximum packets enqueued per generator interval */
+#define GEN_MAX_BURST 1024
+
+/** Offered load in percent of the shaping rate */
+#define OFFERED_LOAD 125
+
+/** Maximum wait for the TM system to send out its backlog */
+#define DRAIN_TMO_NS (10 * ODP_TIME_SEC_IN_NS)
+
+/** Queue threshold of the congested configuration */
+#define CONGEST_MAX_PKTS 512
+
+/** Parsed command line arguments */
+typedef struct {
+	/** Shaping rates in kbps */
+	uint64_t rate_kbps[MAX_RATES];
+	/** Number of shaping rates */
+	int num_rates;
+	/** Duration of each rate in milliseconds */
+	int duration_ms;
+	/** Packet length in bytes */
+	uint32_t pkt_len;
+	/** Request a busy polling TM system */
+	int busy_poll;
+	/** Packets per odp_tm_enq_multi() call, 1 uses odp_tm_enq() */
+	int burst;
+	/** Limit the tm_queue with a threshold and WRED profile */
+	int congest;
+	/** Egress interface */
+	const char *if_name;
+} tm_args_t;
+
+/** Test resources */
+typedef struct {
+	odp_pool_t pool;
+	odp_pktio_t pktio;
+	odp_pktin_queue_t pktin;
+	odp_tm_t tm;
+	odp_tm_shaper_t shaper;
+	odp_tm_threshold_t threshold;
+	odp_tm_wred_t wred;
+	odp_tm_queue_t tm_queue;
+	odp_packet_t pkt_tbl[GEN_MAX_BURST];
+} tm_test_t;
+
+/** Results of one shaping rate */
+typedef struct {
+	uint64_t offered;
+	uint64_t enq_fail;
+	uint64_t received;
+	uint64_t enq_ns;
+	uint64_t wall_ns;
+	uint64_t proc_cpu_ns;
+	uint64_t main_cpu_ns;
+} tm_result_t;
+
+static void parse_args(int argc, char *argv[], tm_args_t *args);
+static void usage(char *progname);
+
+static uint64_t thread_cpu_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+	return (uint64_t)ts.tv_sec * ODP_TIME_SEC_IN_NS + ts.tv_nsec;
+}
+
+static uint64_t process_cpu_ns(void)
+{
+	struct rusage usage;
+
+	getrusage(RUSAGE_SELF, &usage);
+	return (uint64_t)(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) *
+	       ODP_TIME_SEC_IN_NS +
+	       (uint64_t)(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) *
+	       ODP_TIME_USEC_IN_NS;
+}
+
+static uint64_t drain_pktin(tm_test_t *test)
+{
+	odp_packet_t pkt_tbl[64];
+	uint64_t received = 0;
+	int num;
+
+	do {
+		num = odp_pktin_recv(test->pktin, pkt_tbl, 64);
+		if (num > 0) {
+			odp_packet_free_multi(pkt_tbl, num);
+			received += num;
+		}
+	} while (num > 0);
+
+	return received;
+}
+
+/*
+ * The backlog is limited to CONGEST_MAX_PKTS packets. WRED starts dropping
+ * at 40 % of that, so the enqueue path runs the drop decision of every
+ * packet while the shaper keeps the queue filled.
+ */
+static int create_congestion_profiles(tm_test_t *test)
+{
+	odp_tm_threshold_params_t threshold_param;
+	odp_tm_wred_params_t wred_param;
+
+	odp_tm_threshold_params_init(&threshold_param);
+	threshold_param.max_pkts = CONGEST_MAX_PKTS;
+	threshold_param.enable_max_pkts = true;
+	test->threshold = odp_tm_threshold_create("tm_perf_threshold",
+						  &threshold_param);
+	if (test->threshold == ODP_TM_INVALID) {
+		app_err("threshold profile create failed\n");
+		return -1;
+	}
+
+	odp_tm_wred_params_init(&wred_param);
+	wred_param.min_threshold = 4000;
+	wred_param.med_threshold = 8000;
+	wred_param.med_drop_prob = 2000;
+	wred_param.max_drop_prob = 8000;
+	wred_param.enable_wred = true;
+	wred_param.use_byte_fullness = false;
+	test->wred = odp_tm_wred_create("tm_perf_wred", &wred_param);
+	if (test->wred == ODP_TM_INVALID) {
+		app_err("WRED profile create failed\n");
+		return -1;
+	}
+
+	return 0;
+}
+
+static int create_tm(const tm_args_t *args, tm_test_t *test)
+{
+	odp_pool_param_t pool_param;
+	odp_pktio_param_t pktio_param;
+	odp_tm_requirements_t req;
+	odp_tm_egress_t egress;
+	odp_tm_shaper_params_t shaper_param;
+	odp_tm_queue_params_t queue_param;
+	int color;
+
+	odp_pool_param_init(&pool_param);
+	pool_param.type = ODP_POOL_PACKET;
+	pool_param.pkt.num = PKT_NUM;
+	pool_param.pkt.len = args->pkt_len;
+	test->pool = odp_pool_create("tm_perf_pool", &pool_param);
+	if (test->pool == ODP_POOL_INVALID) {
+		app_err("pool create failed\n");
+		return -1;
+	}
+
+	odp_pktio_param_init(&pktio_param);
+	test->pktio = odp_pktio_open(args->if_name, test->pool, &pktio_param);
+	if (test->pktio == ODP_PKTIO_INVALID) {
+		app_err("pktio open failed\n");
+		return -1;
+	}
+
+	if (odp_pktin_queue_config(test->pktio, NULL) ||
+	    odp_pktout_queue_config(test->pktio, NULL) ||
+	    odp_pktin_queue(test->pktio, &test->pktin, 1) != 1 ||
+	    odp_pktio_start(test->pktio)) {
+		app_err("pktio config failed\n");
+		return -1;
+	}
+
+	odp_tm_requirements_init(&req);
+	req.max_tm_queues = 16;
+	req.num_levels = 1;
+	req.tm_queue_shaper_needed = true;
+	req.tm_queue_wred_needed = args->congest;
+	req.tm_queue_dual_slope_needed = args->congest;
+	req.busy_poll_needed = args->busy_poll;
+
+	odp_tm_egress_init(&egress);
+	egress.egress_kind = ODP_TM_EGRESS_PKT_IO;
+	egress.pktio = test->pktio;
+
+	test->tm = odp_tm_create("tm_perf", &req, &egress);
+	if (test->tm == ODP_TM_INVALID) {
+		app_err("TM create failed\n");
+		return -1;
+	}
+
+	odp_tm_shaper_params_init(&shaper_param);
+	shaper_param.commit_bps = args->rate_kbps[0] * 1000;
+	shaper_param.commit_burst = 8 * args->pkt_len;
+	test->shaper = odp_tm_shaper_create("tm_perf_shaper", &shaper_param);
+	if (test->shaper == ODP_TM_INVALID) {
+		app_err("shaper create failed\n");
+		return -1;
+	}
+
+	odp_tm_queue_params_init(&queue_param);
+	queue_param.shaper_profile = test->shaper;
+	queue_param.priority = 0;
+
+	if (args->congest) {
+		if (create_congestion_profiles(test))
+			return -1;
+
+		queue_param.threshold_profile = test->threshold;
+		for (color = 0; color < ODP_NUM_PACKET_COLORS; color++)
+			queue_param.wred_profile[color] = test->wred;
+	}
+
+	test->tm_queue = odp_tm_queue_create(test->tm, &queue_param);
+	if (test->tm_queue == ODP_TM_INVALID ||
+	    odp_tm_queue_connect(test->tm_queue, ODP_TM_ROOT)) {
+		app_err("TM queue create failed\n");
+		return -1;
+	}
+
+	return 0;
+}
+
+static void destroy_tm(tm_test_t *test)
+{
+	odp_time_t end;
+
+	/* Let the shaper send out the backlog, so that no packet is left in
+	 * the TM system */
+	end = odp_time_sum(odp_time_local(),
+			   odp_time_local_from_ns(DRAIN_TMO_NS));
+	while (!odp_tm_is_idle(test->tm) &&
+	       odp_time_cmp(end, odp_time_local()) > 0) {
+		drain_pktin(test);
+		odp_time_wait_ns(ODP_TIME_MSEC_IN_NS);
+	}
+
+	drain_pktin(test);
+	odp_tm_queue_disconnect(test->tm_queue);
+	odp_tm_queue_destroy(test->tm_queue);
+	odp_tm_destroy(test->tm);
+	odp_tm_shaper_destroy(test->shaper);
+	if (test->threshold != ODP_TM_INVALID)
+		odp_tm_threshold_destroy(test->threshold);
+	if (test->wred != ODP_TM_INVALID)
+		odp_tm_wred_destroy(test->wred);
+	drain_pktin(test);
+	odp_pktio_stop(test->pktio);
+	odp_pktio_close(test->pktio);
+	odp_pool_destroy(test->pool);
+}
+
+/*
+ * Enqueue packets in bursts of args->burst. A burst call stops at the first
+ * refused packet, which is freed before the rest is offered again. Returns
+ * the number of refused packets.
+ */
+static uint32_t enq_pkts(const tm_args_t *args, tm_test_t *test, uint32_t num)
+{
+	uint32_t i = 0, fail = 0;
+	int burst, ret;
+
+	while (i < num) {
+		if (args->burst > 1) {
+			burst = num - i < (uint32_t)args->burst ?
+				(int)(num - i) : args->burst;
+			ret = odp_tm_enq_multi(test->tm_queue,
+					       &test->pkt_tbl[i], burst);
+		} else {
+			ret = odp_tm_enq(test->tm_queue,
+					 test->pkt_tbl[i]) < 0 ? -1 : 1;
+		}
+
+		if (ret > 0) {
+			i += ret;
+			continue;
+		}
+
+		odp_packet_free(test->pkt_tbl[i]);
+		fail++;
+		i++;
+	}
+
+	return fail;
+}
+
+/*
+ * Offer packets to the TM system at a rate above the shaping rate, so that
+ * the shaper is delaying packets all the time. The generator itself sleeps
+ * between bursts, so that the CPU use of the TM system stands out.
+ */
+static int run_rate(const tm_args_t *args, tm_test_t *test, int idx,
+		    tm_result_t *res)
+{
+	odp_tm_shaper_params_t shaper_param;
+	uint64_t rate_bps = args->rate_kbps[idx] * 1000;
+	uint64_t offered_pps, due, elapsed_ns, duration_ns;
+	uint64_t cpu_start, main_start;
+	odp_time_t start, end, enq_start;
+	struct timespec interval = { 0, GEN_INTERVAL_NS };
+	uint32_t num, i;
+	int ret;
+
+	odp_tm_shaper_params_init(&shaper_param);
+	shaper_param.commit_bps = rate_bps;
+	shaper_param.commit_burst = 8 * args->pkt_len;
+	if (odp_tm_shaper_params_update(test->shaper, &shaper_param)) {
+		app_err("shaper update failed\n");
+		return -1;
+	}
+
+	memset(res, 0, sizeof(*res));
+	offered_pps = (rate_bps * OFFERED_LOAD / 100) / (8 * args->pkt_len);
+	duration_ns = (uint64_t)args->duration_ms * ODP_TIME_MSEC_IN_NS;
+
+	cpu_start = process_cpu_ns();
+	main_start = thread_cpu_ns();
+	start = odp_time_local();
+
+	do {
+		elapsed_ns = odp_time_to_ns(odp_time_diff(odp_time_local(),
+							  start));
+		due = elapsed_ns * offered_pps / ODP_TIME_SEC_IN_NS;
+		num = due > res->offered ? due - res->offered : 0;
+		if (num > GEN_MAX_BURST)
+			num = GEN_MAX_BURST;
+
+		ret = odp_packet_alloc_multi(test->pool, args->pkt_len,
+					     test->pkt_tbl, num);
+		num = ret > 0 ? ret : 0;
+
+		for (i = 0; i < num; i++)
+			odp_packet_drop_eligible_set(test->pkt_tbl[i], 1);
+
+		enq_start = odp_time_local();
+		res->enq_fail += enq_pkts(args, test, num);
+		res->enq_ns += odp_time_to_ns(odp_time_diff(odp_time_local(),
+							    enq_start));
+		res->offered += num;
+
+		res->received += drain_pktin(test);
+		nanosleep(&interval, NULL);
+	} while (elapsed_ns < duration_ns);
+
+	end = odp_time_local();
+	res->wall_ns = odp_time_to_ns(odp_time_diff(end, start));
+	res->proc_cpu_ns = process_cpu_ns() - cpu_start;
+	res->main_cpu_ns = thread_cpu_ns() - main_start;
+
+	return 0;
+}
+
+static void print_result(const tm_args_t *args, int idx,
+			 const tm_result_t *res)
+{
+	double sec = (double)res->wall_ns / ODP_TIME_SEC_IN_NS;
+	uint64_t tm_cpu_ns = res->proc_cpu_ns > res->main_cpu_ns ?
+			     res->proc_cpu_ns - res->main_cpu_ns : 0;
+
+	printf("  %10" PRIu64 " %10.0f %10.0f %10.0f %10.1f %8.1f %% "
+	       "%8.1f %%\n",
+	       args->rate_kbps[idx], res->offered / sec,
+	       (res->offered - res->enq_fail) / sec, res->received / sec,
+	       res->offered ? (double)res->enq_ns / res->offered : 0.0,
+	       100.0 * tm_cpu_ns / res->wall_ns,
+	       100.0 * res->proc_cpu_ns / res->wall_ns);
+}
+
+int main(int argc, char *argv[])
+{
+	tm_args_t args;
+	tm_test_t test;
+	tm_result_t res;
+	odp_instance_t instance;
+	int i, ret = 0;
+
+	memset(&args, 0, sizeof(args));
+	memset(&test, 0, sizeof(test));
+	test.threshold = ODP_TM_INVALID;
+	test.wred = ODP_TM_INVALID;
+
+	/* Parse and store the application arguments */
+	parse_args(argc, argv, &args);
+
+	/* Init ODP before calling anything else */
+	if (odp_init_global(&instance, NULL, NULL)) {
+		app_err("ODP global init failed.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	/* Init this thread */
+	if (odp_init_local(instance, ODP_THREAD_CONTROL)) {
+		app_err("ODP local init failed.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	if (create_tm(&args, &test)) {
+		ret = -1;
+		goto term;
+	}
+
+	printf("\nTraffic manager CPU use, %s, %" PRIu32 " byte packets, "
+	       "%i ms per rate\n"
+	       "Offered load %i %% of the shaping rate, %s TM service\n"
+	       "Enqueue burst %i, %s\n\n"
+	       "  %10s %10s %10s %10s %10s %10s %10s\n",
+	       args.if_name, args.pkt_len, args.duration_ms, OFFERED_LOAD,
+	       args.busy_poll ? "busy polling" : "event driven",
+	       args.burst, args.congest ?
+	       "WRED and threshold limited queue" : "unlimited queue",
+	       "rate kbps", "offer pps", "enq pps", "out pps", "enq ns",
+	       "TM CPU", "total CPU");
+
+	for (i = 0; i < args.num_rates; i++) {
+		if (run_rate(&args, &test, i, &res)) {
+			ret = -1;
+			break;
+		}
+
+		print_result(&args, i, &res);
+	}
+	printf("\n");
+
+	destroy_tm(&test);
+
+term:
+	if (odp_term_local()) {
+		app_err("Error: term local\n");
+		exit(EXIT_FAILURE);
+	}
+
+	if (odp_term_global(instance)) {
+		app_err("Error: term global\n");
+		exit(EXIT_FAILURE);
+	}
+
+	return ret ? EXIT_FAILURE : 0;
+}
+
+static void parse_rates(const char *str, tm_args_t *args)
+{
+	char *buf = strdup(str);
+	char *token;
+
+	args->num_rates = 0;
+	for (token = strtok(buf, ","); token != NULL &&
+	     args->num_rates < MAX_RATES; token = strtok(NULL, ","))
+		args->rate_kbps[args->num_rates++] = strtoull(token, NULL, 0);
+
+	free(buf);
+}
+
+static void parse_args(int argc, char *argv[], tm_args_t *args)
+{
+	int opt;
+	int long_index;
+	int i;
+	static const struct option longopts[] = {
+		{"rates", required_argument, NULL, 'r'},
+		{"time", required_argument, NULL, 't'},
+		{"length", required_argument, NULL, 'l'},
+		{"interface", required_argument, NULL, 'i'},
+		{"poll", no_argument, NULL, 'p'},
+		{"burst", required_argument, NULL, 'b'},
+		{"congest", no_argument, NULL, 'c'},
+		{"help", no_argument, NULL, 'h'},
+		{NULL, 0, NULL, 0}
+	};
+
+	static const char *shortopts = "+r:t:l:i:pb:ch";
+
+	/* let helper collect its own arguments (e.g. --odph_proc) */
+	odph_parse_options(argc, argv, shortopts, longopts);
+
+	parse_rates("1000,10000,100000,1000000", args);
+	args->duration_ms = 1000;
+	args->pkt_len = 1024;
+	args->busy_poll = 0;
+	args->burst = 1;
+	args->congest = 0;
+	args->if_name = "loop";
+
+	opterr = 0; /* do not issue errors on helper options */
+
+	while (1) {
+		opt = getopt_long(argc, argv, shortopts, longopts, &long_index);
+
+		if (opt == -1)
+			break;	/* No more options */
+
+		switch (opt) {
+		case 'r':
+			parse_rates(optarg, args);
+			break;
+		case 't':
+			args->duration_ms = atoi(optarg);
+			break;
+		case 'l':
+			args->pkt_len = atoi(optarg);
+			break;
+		case 'i':
+			args->if_name = optarg;
+			break;
+		case 'p':
+			args->busy_poll = 1;
+			break;
+		case 'b':
+			args->burst = atoi(optarg);
+			break;
+		case 'c':
+			args->congest = 1;
+			break;
+		case 'h':
+			usage(argv[0]);
+			exit(EXIT_SUCCESS);
+			break;
+		default:
+			break;
+		}
+	}
+
+	optind = 1;		/* reset 'extern optind' from the getopt lib */
+
+	for (i = 0; i < args->num_rates; i++) {
+		if (args->rate_kbps[i] == 0)
+			args->num_rates = 0;
+	}
+
+	if (args->num_rates == 0 || args->duration_ms <= 0 ||
+	    args->pkt_len < 64 || args->burst <= 0 ||
+	    args->burst > GEN_MAX_BURST) {
+		usage(argv[0]);
+		exit(EXIT_FAILURE);
+	}
+}
+
+/**
+ * Print usage information
+ */
+static void usage(char *progname)
+{
+	printf("\n"
+	       "Usage: %s OPTIONS\n"
+	       "  E.g. %s -r 1000,100000 -t 2000 -p\n"
+	       "\n"
+	       "OpenDataPlane traffic manager CPU use at different shaping\n"
+	       "rates. The TM CPU use is the process CPU time, excluding the\n"
+	       "traffic generator thread. The enqueue time is per offered\n"
+	       "packet.\n"
+	       "Optional OPTIONS\n"
+	       "  -r, --rates <list>     Shaping rates in kbps\n"
+	       "                         (default 1000,10000,100000,1000000)\n"
+	       "  -t, --time <ms>        Duration of each rate (default 1000)\n"
+	       "  -l, --length <bytes>   Packet length (default 1024)\n"
+	       "  -i, --interface <name> Egress interface (default loop)\n"
+	       "  -p, --poll             Busy polling TM service\n"
+	       "  -b, --burst <number>   Packets per odp_tm_enq_multi() call,\n"
+	       "                         1 uses odp_tm_enq() (default 1)\n"
+	       "  -c, --congest          Limit the queue with a threshold and\n"
+	       "                         a WRED profile\n"
+	       "  -h, --help             Display help and exit.\n"
+	       "\n", progname, progname);
+}
@@ -27,8 +27,120 @@ void hash_test_crc32c(void)
 	CU_ASSERT(ret == 0xe6e910b0);
 }
 
+void hash_test_crc32c_long(void)
+{
+	static uint8_t data[3 * 8192 + 3 * 256 + 13];
+	const uint32_t check = 0xe3069283; /* CRC-32C of "123456789" */
+	uint32_t i, off, len, ret, chunk;
+
+	ret = odp_hash_crc32c("123456789", 9, 0xffffffff) ^ 0xffffffff;
+	CU_ASSERT(ret == check);
+
+	for (i = 0; i < sizeof(data); i++)
+		data[i] = (uint8_t)(i * 7 + (i >> 8));
+
+	/* Hashing in one call must match hashing in short chunks */
+	for (len = sizeof(data) - 2000; len <= sizeof(data); len += 333) {
+		ret = 0x12345678;
+		for (off = 0; off < len; off += chunk) {
+			chunk = len - off < 61 ? len - off : 61;
+			ret = odp_hash_crc32c(&data[off], chunk, ret);
+		}
+
+		CU_ASSERT(odp_hash_crc32c(data, len, 0x12345678) == ret);
+	}
+}
+
+void hash_test_crc32c_multi(void)
+{
+	static uint8_t data[64 * 40];
+	const void *key[64];
+	uint32_t hash[64];
+	uint32_t i, len;
+	int num;
+
+	for (i = 0; i < sizeof(data); i++)
+		data[i] = (uint8_t)(i * 13 + 1);
+
+	for (len = 0; len <= 40; len += 5) {
+		for (num = 0; num < 64; num++)
+			key[num] = &data[num * len];
+
+		for (num = 1; num <= 64; num += 7) {
+			odp_hash_crc32c_multi(key, len, 0xffffffff, hash, num);
+
+			for (i = 0; i < (uint32_t)num; i++)
+				CU_ASSERT(hash[i] ==
+					  odp_hash_crc32c(key[i], len,
+							  0xffffffff));
+		}
+	}
+}
+
+void hash_test_toeplitz(void)
+{
+	/* Microsoft RSS verification suite: default key, source
+	 * 66.9.149.187:2794, destination 161.142.100.80:1766 */
+	const uint8_t tuple[12] = {66, 9, 149, 187, 161, 142, 100, 80,
+				   0x0a, 0xea, 0x06, 0xe6};
+	const uint8_t key[ODP_HASH_TOEPLITZ_KEY_LEN] = {
+		0x6d, 0x5a, 0x56, 0xda, 0x25, 0x5b, 0x0e, 0xc2,
+		0x41, 0x67, 0x25, 0x3d, 0x43, 0xa3, 0x8f, 0xb0,
+		0xd0, 0xca, 0x2b, 0xcb, 0xae, 0x7b, 0x30, 0xb4,
+		0x77, 0xcb, 0x2d, 0xa3, 0x80, 0x30, 0xf2, 0x0c,
+		0x6a, 0x42, 0xb7, 0x3b, 0xbe, 0xac, 0x01, 0xfa
+	};
+
+	CU_ASSERT(odp_hash_toeplitz(tuple, 12, NULL, 0) == 0x51ccc178);
+	CU_ASSERT(odp_hash_toeplitz(tuple, 8, NULL, 0) == 0x323e8fc2);
+	CU_ASSERT(odp_hash_toeplitz(tuple, 12, key, sizeof(key)) ==
+		  0x51ccc178);
+	CU_ASSERT(odp_hash_toeplitz(tuple, 8, key, sizeof(key)) ==
+		  0x323e8fc2);
+}
+
+void hash_test_xxh(void)
+{
+	static uint8_t data[16 * 70];
+	const void *key[16];
+	uint32_t hash[16];
+	uint32_t i, len;
+
+	CU_ASSERT(odp_hash_xxh32("", 0, 0) == 0x02cc5d05);
+	CU_ASSERT(odp_hash_xxh32("abc", 3, 0) == 0x32d153ff);
+	CU_ASSERT(odp_hash_xxh64("", 0, 0) == 0xef46db3751d8e999ULL);
+	CU_ASSERT(odp_hash_xxh64("abc", 3, 0) == 0x44bc2cf5ad770999ULL);
+
+	for (i = 0; i < sizeof(data); i++)
+		data[i] = (uint8_t)(i * 7 + 3);
+
+	for (len = 0; len < 70; len += 3) {
+		for (i = 0; i < 16; i++)
+			key[i] = &data[i * len];
+
+		odp_hash_xxh32_multi(key, len, 77, hash, 15);
+
+		for (i = 0; i < 15; i++)
+			CU_ASSERT(hash[i] == odp_hash_xxh32(key[i], len, 77));
+	}
+}
+
+void hash_test_jhash(void)
+{
+	const char *str = "Four score and seven years ago";
+
+	CU_ASSERT(odp_hash_jhash("", 0, 0) == 0xdeadbeef);
+	CU_ASSERT(odp_hash_jhash(str, 30, 0) == 0x17770551);
+	CU_ASSERT(odp_hash_jhash(str, 30, 1) == 0xcd628161);
+}
+
 odp_testinfo_t hash_suite[] = {
 	ODP_TEST_INFO(hash_test_crc32c),
+	ODP_TEST_INFO(hash_test_crc32c_long),
+	ODP_TEST_INFO(hash_test_crc32c_multi),
+	ODP_TEST_INFO(hash_test_toeplitz),
+	ODP_TEST_INFO(hash_test_xxh),
+	ODP_TEST_INFO(hash_test_jhash),
 	ODP_TEST_INFO_NULL,
 };
 
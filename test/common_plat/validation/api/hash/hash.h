@@ -11,6 +11,11 @@
 
 /* test functions: */
 void hash_test_crc32c(void);
+void hash_test_crc32c_long(void);
+void hash_test_crc32c_multi(void);
+void hash_test_toeplitz(void);
+void hash_test_xxh(void);
+void hash_test_jhash(void);
 
 /* test arrays: */
 extern odp_testinfo_t hash_suite[];
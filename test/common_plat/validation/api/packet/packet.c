@@ -353,6 +353,47 @@ void packet_test_prefetch(void)
 	CU_PASS();
 }
 
+void packet_test_flow_hash_calc(void)
+{
+	/* Ethernet + IPv4 + TCP from 66.9.149.187:2794 to
+	 * 161.142.100.80:1766 (Microsoft RSS verification suite) */
+	const uint8_t hdr[54] = {
+		0x00, 0x01, 0x02, 0x03, 0x04, 0x05,
+		0x00, 0x06, 0x07, 0x08, 0x09, 0x0a,
+		0x08, 0x00,
+		0x45, 0x00, 0x00, 0x28, 0x00, 0x01, 0x00, 0x00,
+		0x40, 0x06, 0x00, 0x00, 66, 9, 149, 187,
+		161, 142, 100, 80,
+		0x0a, 0xea, 0x06, 0xe6, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x50, 0x02, 0x20, 0x00,
+		0x00, 0x00, 0x00, 0x00
+	};
+	odp_packet_t pkt[2];
+
+	pkt[0] = odp_packet_alloc(packet_pool, sizeof(hdr));
+	pkt[1] = odp_packet_alloc(packet_pool, sizeof(hdr));
+	CU_ASSERT_FATAL(pkt[0] != ODP_PACKET_INVALID);
+	CU_ASSERT_FATAL(pkt[1] != ODP_PACKET_INVALID);
+
+	/* Packets allocated by the application carry no parse results,
+	 * so set the layer metadata explicitly. Second packet is not IP. */
+	CU_ASSERT(odp_packet_copy_from_mem(pkt[0], 0, sizeof(hdr), hdr) == 0);
+	CU_ASSERT(odp_packet_l3_offset_set(pkt[0], 14) == 0);
+	CU_ASSERT(odp_packet_l4_offset_set(pkt[0], 34) == 0);
+	odp_packet_has_ipv4_set(pkt[0], 1);
+	odp_packet_has_tcp_set(pkt[0], 1);
+
+	CU_ASSERT(odp_packet_copy_from_mem(pkt[1], 0, sizeof(hdr), hdr) == 0);
+	odp_packet_has_flow_hash_clr(pkt[1]);
+
+	CU_ASSERT(odp_packet_flow_hash_calc_multi(pkt, 2, NULL, 0) == 1);
+	CU_ASSERT(odp_packet_has_flow_hash(pkt[0]));
+	CU_ASSERT(odp_packet_flow_hash(pkt[0]) == 0x51ccc178);
+	CU_ASSERT(!odp_packet_has_flow_hash(pkt[1]));
+
+	odp_packet_free_multi(pkt, 2);
+}
+
 void packet_test_debug(void)
 {
 	CU_ASSERT(odp_packet_is_valid(test_packet) == 1);
@@ -1213,6 +1254,87 @@ void packet_test_concatsplit(void)
 	odp_packet_free(pkt);
 }
 
+void packet_test_ref(void)
+{
+	odp_packet_t pkt, ref, hdr;
+	uint32_t pkt_len, ref_len, i;
+	uint32_t offset[4];
+	uint8_t buf[32];
+
+	memset(buf, 0xaa, sizeof(buf));
+
+	pkt = odp_packet_copy(segmented_test_packet,
+			      odp_packet_pool(segmented_test_packet));
+	CU_ASSERT_FATAL(pkt != ODP_PACKET_INVALID);
+	pkt_len = odp_packet_len(pkt);
+	CU_ASSERT(odp_packet_has_ref(pkt) == 0);
+
+	/* Static reference */
+	ref = odp_packet_ref_static(pkt);
+	CU_ASSERT_FATAL(ref != ODP_PACKET_INVALID);
+	CU_ASSERT(odp_packet_has_ref(pkt) == 1);
+	CU_ASSERT(odp_packet_has_ref(ref) == 1);
+	CU_ASSERT(odp_packet_len(ref) == pkt_len);
+	_packet_compare_data(ref, segmented_test_packet);
+	odp_packet_free(ref);
+	CU_ASSERT(odp_packet_has_ref(pkt) == 0);
+
+	/* Dynamic references at and between segment boundaries */
+	offset[0] = 0;
+	offset[1] = 14;
+	offset[2] = pkt_len / 2;
+	offset[3] = pkt_len - 1;
+
+	for (i = 0; i < 4; i++) {
+		ref = odp_packet_ref(pkt, offset[i]);
+		CU_ASSERT_FATAL(ref != ODP_PACKET_INVALID);
+		ref_len = pkt_len - offset[i];
+		CU_ASSERT(odp_packet_len(ref) == ref_len);
+		CU_ASSERT(odp_packet_has_ref(pkt) == 1);
+		CU_ASSERT(odp_packet_has_ref(ref) == 1);
+		_packet_compare_offset(ref, 0, segmented_test_packet,
+				       offset[i], ref_len);
+
+		/* Unique header in front of the shared data */
+		CU_ASSERT(odp_packet_extend_head(&ref, sizeof(buf),
+						 NULL, NULL) >= 0);
+		CU_ASSERT(odp_packet_copy_from_mem(ref, 0, sizeof(buf),
+						   buf) == 0);
+
+		/* Writes to the shared data are not seen by the packet */
+		CU_ASSERT(odp_packet_copy_from_mem(ref, sizeof(buf), 1,
+						   buf) == 0);
+		CU_ASSERT(odp_packet_extend_tail(&ref, sizeof(buf),
+						 NULL, NULL) >= 0);
+		CU_ASSERT(odp_packet_copy_from_mem(ref, odp_packet_len(ref) -
+						   sizeof(buf), sizeof(buf),
+						   buf) == 0);
+		_packet_compare_offset(ref, sizeof(buf) + 1,
+				       segmented_test_packet, offset[i] + 1,
+				       ref_len - 1);
+		_packet_compare_data(pkt, segmented_test_packet);
+
+		odp_packet_free(ref);
+	}
+
+	CU_ASSERT(odp_packet_has_ref(pkt) == 0);
+
+	/* Reference with a header packet outlives the packet */
+	hdr = odp_packet_alloc(odp_packet_pool(pkt), sizeof(buf));
+	CU_ASSERT_FATAL(hdr != ODP_PACKET_INVALID);
+	CU_ASSERT(odp_packet_copy_from_mem(hdr, 0, sizeof(buf), buf) == 0);
+
+	ref = odp_packet_ref_pkt(pkt, 30, hdr);
+	CU_ASSERT_FATAL(ref != ODP_PACKET_INVALID);
+	CU_ASSERT(odp_packet_len(ref) == sizeof(buf) + pkt_len - 30);
+	odp_packet_free(pkt);
+
+	CU_ASSERT(odp_packet_has_ref(ref) == 0);
+	_packet_compare_offset(ref, sizeof(buf), segmented_test_packet, 30,
+			       pkt_len - 30);
+	odp_packet_free(ref);
+}
+
 void packet_test_align(void)
 {
 	odp_packet_t pkt;
@@ -1322,6 +1444,7 @@ odp_testinfo_t packet_suite[] = {
 	ODP_TEST_INFO(packet_test_alloc_free_multi),
 	ODP_TEST_INFO(packet_test_alloc_segmented),
 	ODP_TEST_INFO(packet_test_basic_metadata),
+	ODP_TEST_INFO(packet_test_flow_hash_calc),
 	ODP_TEST_INFO(packet_test_debug),
 	ODP_TEST_INFO(packet_test_segments),
 	ODP_TEST_INFO(packet_test_length),
@@ -1338,6 +1461,7 @@ odp_testinfo_t packet_suite[] = {
 	ODP_TEST_INFO(packet_test_copy),
 	ODP_TEST_INFO(packet_test_copydata),
 	ODP_TEST_INFO(packet_test_concatsplit),
+	ODP_TEST_INFO(packet_test_ref),
 	ODP_TEST_INFO(packet_test_align),
 	ODP_TEST_INFO(packet_test_offset),
 	ODP_TEST_INFO_NULL,
@@ -15,6 +15,7 @@ void packet_test_alloc_free_multi(void);
 void packet_test_alloc_segmented(void);
 void packet_test_event_conversion(void);
 void packet_test_basic_metadata(void);
+void packet_test_flow_hash_calc(void);
 void packet_test_length(void);
 void packet_test_prefetch(void);
 void packet_test_debug(void);
@@ -30,6 +31,7 @@ void packet_test_add_rem_data(void);
 void packet_test_copy(void);
 void packet_test_copydata(void);
 void packet_test_concatsplit(void);
+void packet_test_ref(void);
 void packet_test_align(void);
 void packet_test_offset(void);
 
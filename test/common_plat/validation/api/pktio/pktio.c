@@ -9,6 +9,8 @@
 #include <odp/helper/eth.h>
 #include <odp/helper/ip.h>
 #include <odp/helper/udp.h>
+#include <odp/helper/tcp.h>
+#include <odp/helper/chksum.h>
 
 #include <stdlib.h>
 #include "pktio.h"
@@ -30,6 +32,10 @@
 #define PKTIN_TS_MIN_RES       1000
 #define PKTIN_TS_MAX_RES       10000000000
 #define PKTIN_TS_CMP_RES       1
+#define TCP_SEG_PAYLOAD_LEN    2500
+#define TCP_SEG_LEN            1000
+#define TCP_SEG_NUM            3
+#define TCP_SEG_PORT           12051
 
 #undef DEBUG_STATS
 
@@ -863,6 +869,22 @@ void pktio_test_recv_queue(void)
 
 	CU_ASSERT(num_rx == TX_BATCH_LEN);
 
+	/* Test packets are one UDP flow. A flow hash is optional, but must
+	 * be the same for all packets of the flow. Loopback hashes packets
+	 * over its input queues and keeps the hash. */
+	for (i = 0; i < num_rx; i++) {
+		if (num_queues > 1 &&
+		    strcmp(iface_name[num_ifaces - 1], "loop") == 0)
+			CU_ASSERT(odp_packet_has_flow_hash(pkt_tbl[i]));
+
+		CU_ASSERT(odp_packet_has_flow_hash(pkt_tbl[i]) ==
+			  odp_packet_has_flow_hash(pkt_tbl[0]));
+		if (odp_packet_has_flow_hash(pkt_tbl[i]) &&
+		    odp_packet_has_flow_hash(pkt_tbl[0]))
+			CU_ASSERT(odp_packet_flow_hash(pkt_tbl[i]) ==
+				  odp_packet_flow_hash(pkt_tbl[0]));
+	}
+
 	for (i = 0; i < num_rx; i++)
 		odp_packet_free(pkt_tbl[i]);
 
@@ -1511,6 +1533,113 @@ void pktio_test_statistics_counters(void)
 	}
 }
 
+/* Forward packets of one leg of the echo test and check they arrive */
+static int pool_stats_echo(pktio_info_t *pktio_tx, pktio_info_t *pktio_rx,
+			   odp_packet_t pkt_tbl[], uint32_t seq_tbl[], int num)
+{
+	int i, num_rx;
+
+	for (i = 0; i < num; i++)
+		pktio_pkt_set_macs(pkt_tbl[i], pktio_tx->id, pktio_rx->id);
+
+	send_packets(pktio_tx->pktout, pkt_tbl, num);
+
+	num_rx = wait_for_packets(pktio_rx, pkt_tbl, seq_tbl, num,
+				  TXRX_MODE_MULTI, ODP_TIME_SEC_IN_NS);
+	CU_ASSERT(num_rx == num);
+
+	return num_rx;
+}
+
+int pktio_check_pool_stats(void)
+{
+	odp_pool_capability_t capa;
+
+	if (odp_pool_capability(&capa) || !capa.stats.bit.recycle_hits ||
+	    !capa.stats.bit.recycle_misses)
+		return ODP_TEST_INACTIVE;
+
+	return ODP_TEST_ACTIVE;
+}
+
+void pktio_test_pool_stats(void)
+{
+	pktio_info_t pktios[MAX_NUM_IFACES];
+	pktio_info_t *pktio_a, *pktio_b;
+	odp_packet_t pkt_tbl[TX_BATCH_LEN];
+	uint32_t seq_tbl[TX_BATCH_LEN];
+	odp_pool_stats_t stats;
+	uint64_t num_alloc = 0;
+	uint64_t num_rc;
+	int i, num;
+
+	for (i = 0; i < num_ifaces; i++) {
+		pktios[i].name = iface_name[i];
+		pktios[i].id = create_pktio(i, ODP_PKTIN_MODE_DIRECT,
+					    ODP_PKTOUT_MODE_DIRECT);
+		CU_ASSERT_FATAL(odp_pktout_queue(pktios[i].id,
+						 &pktios[i].pktout, 1) == 1);
+		pktios[i].queue_out = ODP_QUEUE_INVALID;
+		pktios[i].inq = ODP_QUEUE_INVALID;
+		pktios[i].in_mode = ODP_PKTIN_MODE_DIRECT;
+
+		CU_ASSERT_FATAL(odp_pktio_start(pktios[i].id) == 0);
+		_pktio_wait_linkup(pktios[i].id);
+	}
+	pktio_a = &pktios[0];
+	pktio_b = (num_ifaces > 1) ? &pktios[1] : pktio_a;
+
+	for (i = 0; i < num_ifaces; i++) {
+		CU_ASSERT(odp_pool_stats_reset(pool[i]) == 0);
+		CU_ASSERT(odp_pool_stats(pool[i], &stats) == 0);
+		CU_ASSERT(stats.recycle_hits == 0);
+		CU_ASSERT(stats.recycle_misses == 0);
+	}
+
+	num = create_packets(pkt_tbl, seq_tbl, TX_BATCH_LEN, pktio_a->id,
+			     pktio_b->id);
+	CU_ASSERT_FATAL(num == TX_BATCH_LEN);
+
+	/* Echo the packets a -> b -> a -> b. Packets received on an
+	 * interface are sent out of the same interface on the next leg, so
+	 * the last leg receives into buffers that output freed. */
+	num = pool_stats_echo(pktio_a, pktio_b, pkt_tbl, seq_tbl, num);
+	num_alloc += num;
+	num = pool_stats_echo(pktio_b, pktio_a, pkt_tbl, seq_tbl, num);
+	num_alloc += num;
+	num = pool_stats_echo(pktio_a, pktio_b, pkt_tbl, seq_tbl, num);
+	num_alloc += num;
+
+	for (i = 0; i < num; i++)
+		odp_packet_free(pkt_tbl[i]);
+
+	num_rc = 0;
+	for (i = 0; i < num_ifaces; i++) {
+		CU_ASSERT(odp_pool_stats(pool[i], &stats) == 0);
+		num_rc += stats.recycle_hits + stats.recycle_misses;
+	}
+
+	/* Every input allocation is either a hit or a miss. Interfaces that
+	 * recycle serve the last leg from the buffers freed on the previous
+	 * one. */
+	CU_ASSERT(num_rc == 0 || num_rc >= num_alloc);
+	CU_ASSERT(odp_pool_stats(pool[num_ifaces - 1], &stats) == 0);
+	if (num_rc)
+		CU_ASSERT(stats.recycle_hits > 0);
+
+	for (i = 0; i < num_ifaces; i++) {
+		CU_ASSERT(odp_pool_stats_reset(pool[i]) == 0);
+		CU_ASSERT(odp_pool_stats(pool[i], &stats) == 0);
+		CU_ASSERT(stats.recycle_hits == 0);
+		CU_ASSERT(stats.recycle_misses == 0);
+	}
+
+	for (i = 0; i < num_ifaces; i++) {
+		CU_ASSERT(odp_pktio_stop(pktios[i].id) == 0);
+		CU_ASSERT(odp_pktio_close(pktios[i].id) == 0);
+	}
+}
+
 void pktio_test_start_stop(void)
 {
 	odp_pktio_t pktio[MAX_NUM_IFACES];
@@ -1991,9 +2120,426 @@ void pktio_test_pktin_ts(void)
 	}
 }
 
+int pktio_check_pktin_ts_batch(void)
+{
+	odp_pktio_t pktio;
+	odp_pktio_capability_t capa;
+	odp_pktio_param_t pktio_param;
+	int ret;
+
+	odp_pktio_param_init(&pktio_param);
+	pktio_param.in_mode = ODP_PKTIN_MODE_DIRECT;
+
+	pktio = odp_pktio_open(iface_name[0], pool[0], &pktio_param);
+	if (pktio == ODP_PKTIO_INVALID)
+		return ODP_TEST_INACTIVE;
+
+	ret = odp_pktio_capability(pktio, &capa);
+	(void)odp_pktio_close(pktio);
+
+	if (ret < 0 || !capa.config.pktin.bit.ts_all ||
+	    !capa.config.pktin.bit.ts_batch)
+		return ODP_TEST_INACTIVE;
+
+	return ODP_TEST_ACTIVE;
+}
+
+void pktio_test_pktin_ts_batch(void)
+{
+	odp_pktio_t pktio_tx, pktio_rx;
+	odp_pktio_t pktio[MAX_NUM_IFACES];
+	pktio_info_t pktio_rx_info;
+	odp_pktio_capability_t capa;
+	odp_pktio_config_t config;
+	odp_pktout_queue_t pktout_queue;
+	odp_packet_t pkt_tbl[TX_BATCH_LEN];
+	uint32_t pkt_seq[TX_BATCH_LEN];
+	odp_time_t ts_prev, ts, start, end;
+	int num_rx;
+	int ret;
+	int i;
+
+	CU_ASSERT_FATAL(num_ifaces >= 1);
+
+	/* Open and configure interfaces, interpolate when supported */
+	for (i = 0; i < num_ifaces; ++i) {
+		pktio[i] = create_pktio(i, ODP_PKTIN_MODE_DIRECT,
+					ODP_PKTOUT_MODE_DIRECT);
+		CU_ASSERT_FATAL(pktio[i] != ODP_PKTIO_INVALID);
+
+		CU_ASSERT_FATAL(odp_pktio_capability(pktio[i], &capa) == 0);
+		CU_ASSERT_FATAL(capa.config.pktin.bit.ts_batch);
+
+		odp_pktio_config_init(&config);
+		config.pktin.bit.ts_all = 1;
+		config.pktin.bit.ts_batch = 1;
+		config.pktin.bit.ts_interp = capa.config.pktin.bit.ts_interp;
+		CU_ASSERT_FATAL(odp_pktio_config(pktio[i], &config) == 0);
+
+		CU_ASSERT_FATAL(odp_pktio_start(pktio[i]) == 0);
+	}
+
+	for (i = 0; i < num_ifaces; i++)
+		_pktio_wait_linkup(pktio[i]);
+
+	pktio_tx = pktio[0];
+	pktio_rx = (num_ifaces > 1) ? pktio[1] : pktio_tx;
+	pktio_rx_info.id   = pktio_rx;
+	pktio_rx_info.inq  = ODP_QUEUE_INVALID;
+	pktio_rx_info.in_mode = ODP_PKTIN_MODE_DIRECT;
+
+	ret = create_packets(pkt_tbl, pkt_seq, TX_BATCH_LEN, pktio_tx,
+			     pktio_rx);
+	CU_ASSERT_FATAL(ret == TX_BATCH_LEN);
+
+	ret = odp_pktout_queue(pktio_tx, &pktout_queue, 1);
+	CU_ASSERT_FATAL(ret > 0);
+
+	/* Send all packets at once, so that they are received in bursts */
+	start = odp_time_global();
+	CU_ASSERT_FATAL(odp_pktout_send(pktout_queue, pkt_tbl,
+					TX_BATCH_LEN) == TX_BATCH_LEN);
+	num_rx = wait_for_packets(&pktio_rx_info, pkt_tbl, pkt_seq,
+				  TX_BATCH_LEN, TXRX_MODE_MULTI,
+				  ODP_TIME_SEC_IN_NS);
+	end = odp_time_global();
+	CU_ASSERT(num_rx == TX_BATCH_LEN);
+
+	/* Every packet has a timestamp taken during the receive */
+	ts_prev = start;
+	for (i = 0; i < num_rx; i++) {
+		CU_ASSERT(odp_packet_has_ts(pkt_tbl[i]));
+		ts = odp_packet_ts(pkt_tbl[i]);
+
+		CU_ASSERT(odp_time_cmp(ts, ts_prev) >= 0);
+		CU_ASSERT(odp_time_cmp(end, ts) >= 0);
+
+		ts_prev = ts;
+		odp_packet_free(pkt_tbl[i]);
+	}
+
+	for (i = 0; i < num_ifaces; i++) {
+		CU_ASSERT_FATAL(odp_pktio_stop(pktio[i]) == 0);
+		CU_ASSERT_FATAL(odp_pktio_close(pktio[i]) == 0);
+	}
+}
+
+int pktio_check_tcp_seg(void)
+{
+	odp_pktio_t pktio;
+	odp_pktio_capability_t capa;
+	odp_pktio_param_t pktio_param;
+	int ret;
+
+	odp_pktio_param_init(&pktio_param);
+	pktio_param.in_mode = ODP_PKTIN_MODE_DIRECT;
+
+	pktio = odp_pktio_open(iface_name[0], pool[0], &pktio_param);
+	if (pktio == ODP_PKTIO_INVALID)
+		return ODP_TEST_INACTIVE;
+
+	ret = odp_pktio_capability(pktio, &capa);
+	(void)odp_pktio_close(pktio);
+
+	if (ret < 0 || !capa.config.pktout.bit.tcp_seg ||
+	    !capa.config.pktin.bit.tcp_coalesce)
+		return ODP_TEST_INACTIVE;
+
+	return ODP_TEST_ACTIVE;
+}
+
+/* TCP packet carrying 'len' bytes of the test stream from 'offset' on */
+static odp_packet_t create_tcp_packet(odp_pktio_t pktio_src,
+				      odp_pktio_t pktio_dst,
+				      uint32_t offset, uint32_t len, int psh)
+{
+	odp_packet_t pkt;
+	odph_ipv4hdr_t *ip;
+	odph_tcphdr_t *tcp;
+	uint8_t *buf;
+	uint32_t hdr_len = ODPH_ETHHDR_LEN + ODPH_IPV4HDR_LEN +
+			   ODPH_TCPHDR_LEN;
+	int i;
+
+	pkt = odp_packet_alloc(default_pkt_pool, hdr_len + len);
+	if (pkt == ODP_PACKET_INVALID)
+		return ODP_PACKET_INVALID;
+
+	if (odp_packet_seg_len(pkt) < hdr_len + len) {
+		odp_packet_free(pkt);
+		return ODP_PACKET_INVALID;
+	}
+
+	buf = odp_packet_data(pkt);
+	memset(buf, 0, hdr_len);
+	((odph_ethhdr_t *)buf)->type = odp_cpu_to_be_16(ODPH_ETHTYPE_IPV4);
+
+	ip = (odph_ipv4hdr_t *)(buf + ODPH_ETHHDR_LEN);
+	ip->ver_ihl = ODPH_IPV4 << 4 | ODPH_IPV4HDR_IHL_MIN;
+	ip->tot_len = odp_cpu_to_be_16(odp_packet_len(pkt) - ODPH_ETHHDR_LEN);
+	ip->id = odp_cpu_to_be_16(100);
+	ip->ttl = 64;
+	ip->proto = ODPH_IPPROTO_TCP;
+	ip->src_addr = odp_cpu_to_be_32(0x0a000001);
+	ip->dst_addr = odp_cpu_to_be_32(0x0a000064);
+
+	tcp = (odph_tcphdr_t *)(buf + ODPH_ETHHDR_LEN + ODPH_IPV4HDR_LEN);
+	tcp->src_port = odp_cpu_to_be_16(TCP_SEG_PORT);
+	tcp->dst_port = odp_cpu_to_be_16(TCP_SEG_PORT);
+	tcp->seq_no = odp_cpu_to_be_32(1000 + offset);
+	tcp->ack_no = odp_cpu_to_be_32(1);
+	tcp->hl = ODPH_TCPHDR_LEN / 4;
+	tcp->ack = 1;
+	tcp->psh = psh;
+	tcp->window = odp_cpu_to_be_16(1024);
+
+	for (i = 0; i < (int)len; i++)
+		buf[hdr_len + i] = offset + i;
+
+	odp_packet_l2_offset_set(pkt, 0);
+	odp_packet_l3_offset_set(pkt, ODPH_ETHHDR_LEN);
+	odp_packet_l4_offset_set(pkt, ODPH_ETHHDR_LEN + ODPH_IPV4HDR_LEN);
+	odp_packet_has_eth_set(pkt, 1);
+	odp_packet_has_ipv4_set(pkt, 1);
+	odp_packet_has_tcp_set(pkt, 1);
+	pktio_pkt_set_macs(pkt, pktio_src, pktio_dst);
+
+	odph_ipv4_csum_update(pkt);
+	CU_ASSERT(odph_tcp_chksum_set(pkt) == 0);
+
+	return pkt;
+}
+
+/* Receive TCP test packets, parsed for checksum verification */
+static int recv_tcp_packets(odp_pktio_t pktio, odp_packet_t pkt_tbl[],
+			    int num)
+{
+	odp_pktin_queue_t pktin;
+	odp_packet_t pkt;
+	odp_time_t end;
+	odph_tcphdr_t *tcp;
+	uint32_t len;
+	int num_rx = 0;
+
+	CU_ASSERT_FATAL(odp_pktin_queue(pktio, &pktin, 1) == 1);
+
+	/* Let all segments arrive, to be received in one burst */
+	odp_time_wait_ns(10 * ODP_TIME_MSEC_IN_NS);
+
+	end = odp_time_sum(odp_time_local(),
+			   odp_time_local_from_ns(ODP_TIME_SEC_IN_NS));
+	do {
+		odp_packet_t tmp[TX_BATCH_LEN];
+		int i, n;
+
+		n = odp_pktin_recv(pktin, tmp, TX_BATCH_LEN);
+		for (i = 0; i < n; i++) {
+			pkt = tmp[i];
+			tcp = odp_packet_has_tcp(pkt) ?
+			      (odph_tcphdr_t *)odp_packet_l4_ptr(pkt, &len) :
+			      NULL;
+
+			if (tcp == NULL || num_rx == num ||
+			    tcp->dst_port != odp_cpu_to_be_16(TCP_SEG_PORT))
+				odp_packet_free(pkt);
+			else
+				pkt_tbl[num_rx++] = pkt;
+		}
+	} while (num_rx < num && odp_time_cmp(end, odp_time_local()) > 0);
+
+	return num_rx;
+}
+
+void pktio_test_tcp_seg(void)
+{
+	odp_pktio_t pktio_tx, pktio_rx;
+	odp_pktio_t pktio[MAX_NUM_IFACES];
+	odp_pktio_config_t config;
+	odp_pktout_queue_t pktout;
+	odp_packet_t pkt, orig;
+	odp_packet_t pkt_tbl[TCP_SEG_NUM];
+	uint8_t orig_data[TCP_SEG_PAYLOAD_LEN + 64];
+	uint8_t data[TCP_SEG_PAYLOAD_LEN + 64];
+	uint32_t hdr_len = ODPH_ETHHDR_LEN + ODPH_IPV4HDR_LEN +
+			   ODPH_TCPHDR_LEN;
+	uint32_t orig_len, len;
+	odph_tcphdr_t *tcp;
+	odph_ipv4hdr_t *ip;
+	int coalesce, num, i;
+
+	CU_ASSERT_FATAL(num_ifaces >= 1);
+
+	for (i = 0; i < num_ifaces; ++i) {
+		pktio[i] = create_pktio(i, ODP_PKTIN_MODE_DIRECT,
+					ODP_PKTOUT_MODE_DIRECT);
+		CU_ASSERT_FATAL(pktio[i] != ODP_PKTIO_INVALID);
+	}
+
+	pktio_tx = pktio[0];
+	pktio_rx = (num_ifaces > 1) ? pktio[1] : pktio_tx;
+
+	/* First receive segments, then segments coalesced back to a single
+	 * packet */
+	for (coalesce = 0; coalesce < 2; coalesce++) {
+		for (i = 0; i < num_ifaces; ++i) {
+			odp_pktio_config_init(&config);
+			config.pktout.bit.tcp_seg = 1;
+			config.pktout_seg_len = TCP_SEG_LEN;
+			config.pktin.bit.tcp_coalesce = coalesce;
+			CU_ASSERT_FATAL(odp_pktio_config(pktio[i],
+							 &config) == 0);
+			CU_ASSERT_FATAL(odp_pktio_start(pktio[i]) == 0);
+		}
+
+		for (i = 0; i < num_ifaces; i++)
+			_pktio_wait_linkup(pktio[i]);
+
+		orig = create_tcp_packet(pktio_tx, pktio_rx, 0,
+					 TCP_SEG_PAYLOAD_LEN, 1);
+		CU_ASSERT_FATAL(orig != ODP_PACKET_INVALID);
+		orig_len = odp_packet_len(orig);
+		CU_ASSERT_FATAL(odp_packet_copy_to_mem(orig, 0, orig_len,
+						       orig_data) == 0);
+
+		CU_ASSERT_FATAL(odp_pktout_queue(pktio_tx, &pktout, 1) == 1);
+		CU_ASSERT_FATAL(odp_pktout_send(pktout, &orig, 1) == 1);
+
+		num = recv_tcp_packets(pktio_rx, pkt_tbl,
+				       coalesce ? 1 : TCP_SEG_NUM);
+		CU_ASSERT(num == (coalesce ? 1 : TCP_SEG_NUM));
+
+		for (i = 0; i < num; i++) {
+			pkt = pkt_tbl[i];
+			len = odp_packet_len(pkt);
+			ip = (odph_ipv4hdr_t *)odp_packet_l3_ptr(pkt, NULL);
+			tcp = (odph_tcphdr_t *)odp_packet_l4_ptr(pkt, NULL);
+
+			CU_ASSERT(odph_ipv4_csum_valid(pkt));
+			CU_ASSERT(odph_tcp_chksum_verify(pkt) == 0);
+			CU_ASSERT(odp_be_to_cpu_16(ip->tot_len) ==
+				  len - ODPH_ETHHDR_LEN);
+
+			if (coalesce) {
+				/* Same packet as sent, apart from IP and TCP
+				 * checksums which are recalculated */
+				CU_ASSERT(len == orig_len);
+				CU_ASSERT(tcp->psh);
+				if (len != orig_len)
+					continue;
+				odp_packet_copy_to_mem(pkt, 0, len, data);
+				CU_ASSERT(memcmp(data + hdr_len,
+						 orig_data + hdr_len,
+						 len - hdr_len) == 0);
+				continue;
+			}
+
+			CU_ASSERT(odp_be_to_cpu_32(tcp->seq_no) ==
+				  (uint32_t)(1000 + i * TCP_SEG_LEN));
+			CU_ASSERT(odp_be_to_cpu_16(ip->id) == 100 + i);
+			CU_ASSERT(tcp->psh == (i == TCP_SEG_NUM - 1));
+			CU_ASSERT(len == hdr_len +
+				  (i < TCP_SEG_NUM - 1 ? TCP_SEG_LEN :
+				   TCP_SEG_PAYLOAD_LEN -
+				   (TCP_SEG_NUM - 1) * TCP_SEG_LEN));
+			if (len > sizeof(data))
+				continue;
+			odp_packet_copy_to_mem(pkt, 0, len, data);
+			CU_ASSERT(memcmp(data + hdr_len,
+					 orig_data + hdr_len + i * TCP_SEG_LEN,
+					 len - hdr_len) == 0);
+		}
+
+		for (i = 0; i < num; i++)
+			odp_packet_free(pkt_tbl[i]);
+
+		for (i = 0; i < num_ifaces; i++)
+			CU_ASSERT_FATAL(odp_pktio_stop(pktio[i]) == 0);
+	}
+
+	for (i = 0; i < num_ifaces; i++)
+		CU_ASSERT_FATAL(odp_pktio_close(pktio[i]) == 0);
+}
+
+/* Segments with a bad checksum are not coalesced, since the checksum of a
+ * coalesced packet is recalculated */
+void pktio_test_tcp_coalesce_chksum(void)
+{
+	odp_pktio_t pktio_tx, pktio_rx;
+	odp_pktio_t pktio[MAX_NUM_IFACES];
+	odp_pktio_config_t config;
+	odp_pktout_queue_t pktout;
+	odp_packet_t seg[TCP_SEG_NUM + 1];
+	odp_packet_t pkt_tbl[TCP_SEG_NUM];
+	uint32_t hdr_len = ODPH_ETHHDR_LEN + ODPH_IPV4HDR_LEN +
+			   ODPH_TCPHDR_LEN;
+	odph_tcphdr_t *tcp;
+	uint8_t *payload;
+	int num, i;
+
+	CU_ASSERT_FATAL(num_ifaces >= 1);
+
+	for (i = 0; i < num_ifaces; ++i) {
+		pktio[i] = create_pktio(i, ODP_PKTIN_MODE_DIRECT,
+					ODP_PKTOUT_MODE_DIRECT);
+		CU_ASSERT_FATAL(pktio[i] != ODP_PKTIO_INVALID);
+
+		odp_pktio_config_init(&config);
+		config.pktin.bit.tcp_coalesce = 1;
+		CU_ASSERT_FATAL(odp_pktio_config(pktio[i], &config) == 0);
+		CU_ASSERT_FATAL(odp_pktio_start(pktio[i]) == 0);
+	}
+
+	pktio_tx = pktio[0];
+	pktio_rx = (num_ifaces > 1) ? pktio[1] : pktio_tx;
+
+	for (i = 0; i < num_ifaces; i++)
+		_pktio_wait_linkup(pktio[i]);
+
+	/* Four segments of a flow, the second one is corrupted after its
+	 * checksum was calculated */
+	for (i = 0; i < TCP_SEG_NUM + 1; i++) {
+		seg[i] = create_tcp_packet(pktio_tx, pktio_rx,
+					   i * TCP_SEG_LEN, TCP_SEG_LEN,
+					   i == TCP_SEG_NUM);
+		CU_ASSERT_FATAL(seg[i] != ODP_PACKET_INVALID);
+	}
+
+	payload = (uint8_t *)odp_packet_data(seg[1]) + hdr_len;
+	payload[10] ^= 0x5a;
+
+	CU_ASSERT_FATAL(odp_pktout_queue(pktio_tx, &pktout, 1) == 1);
+	CU_ASSERT_FATAL(odp_pktout_send(pktout, seg, TCP_SEG_NUM + 1) ==
+			TCP_SEG_NUM + 1);
+
+	/* The first segment alone, the corrupted one as it was sent and
+	 * the last two coalesced */
+	num = recv_tcp_packets(pktio_rx, pkt_tbl, TCP_SEG_NUM);
+	CU_ASSERT(num == TCP_SEG_NUM);
+
+	for (i = 0; i < num; i++) {
+		tcp = (odph_tcphdr_t *)odp_packet_l4_ptr(pkt_tbl[i], NULL);
+
+		CU_ASSERT(odp_be_to_cpu_32(tcp->seq_no) ==
+			  (uint32_t)(1000 + i * TCP_SEG_LEN));
+		CU_ASSERT(odp_packet_len(pkt_tbl[i]) == hdr_len +
+			  (i == 2 ? 2 : 1) * TCP_SEG_LEN);
+		CU_ASSERT((odph_tcp_chksum_verify(pkt_tbl[i]) == 0) ==
+			  (i != 1));
+	}
+
+	for (i = 0; i < num; i++)
+		odp_packet_free(pkt_tbl[i]);
+
+	for (i = 0; i < num_ifaces; i++) {
+		CU_ASSERT_FATAL(odp_pktio_stop(pktio[i]) == 0);
+		CU_ASSERT_FATAL(odp_pktio_close(pktio[i]) == 0);
+	}
+}
+
 static int create_pool(const char *iface, int num)
 {
 	char pool_name[ODP_POOL_NAME_LEN];
+	odp_pool_capability_t capa;
 	odp_pool_param_t params;
 
 	memset(&params, 0, sizeof(params));
@@ -2001,6 +2547,13 @@ static int create_pool(const char *iface, int num)
 	params.pkt.num     = PKT_BUF_NUM;
 	params.type        = ODP_POOL_PACKET;
 
+	/* Recycle counters for pktio_test_pool_stats() */
+	if (odp_pool_capability(&capa) == 0) {
+		params.stats.bit.recycle_hits = capa.stats.bit.recycle_hits;
+		params.stats.bit.recycle_misses =
+			capa.stats.bit.recycle_misses;
+	}
+
 	snprintf(pool_name, sizeof(pool_name), "pkt_pool_%s_%d",
 		 iface, pool_segmentation);
 
@@ -2127,8 +2680,16 @@ odp_testinfo_t pktio_suite_unsegmented[] = {
 	ODP_TEST_INFO(pktio_test_recv_multi_event),
 	ODP_TEST_INFO_CONDITIONAL(pktio_test_statistics_counters,
 				  pktio_check_statistics_counters),
+	ODP_TEST_INFO_CONDITIONAL(pktio_test_pool_stats,
+				  pktio_check_pool_stats),
 	ODP_TEST_INFO_CONDITIONAL(pktio_test_pktin_ts,
 				  pktio_check_pktin_ts),
+	ODP_TEST_INFO_CONDITIONAL(pktio_test_pktin_ts_batch,
+				  pktio_check_pktin_ts_batch),
+	ODP_TEST_INFO_CONDITIONAL(pktio_test_tcp_seg,
+				  pktio_check_tcp_seg),
+	ODP_TEST_INFO_CONDITIONAL(pktio_test_tcp_coalesce_chksum,
+				  pktio_check_tcp_seg),
 	ODP_TEST_INFO_NULL
 };
 
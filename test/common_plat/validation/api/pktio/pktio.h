@@ -44,8 +44,15 @@ void pktio_test_sched_multi_event(void);
 void pktio_test_recv_multi_event(void);
 int pktio_check_statistics_counters(void);
 void pktio_test_statistics_counters(void);
+void pktio_test_pool_stats(void);
+int pktio_check_pool_stats(void);
 int pktio_check_pktin_ts(void);
 void pktio_test_pktin_ts(void);
+int pktio_check_pktin_ts_batch(void);
+void pktio_test_pktin_ts_batch(void);
+int pktio_check_tcp_seg(void);
+void pktio_test_tcp_seg(void);
+void pktio_test_tcp_coalesce_chksum(void);
 
 /* test arrays: */
 extern odp_testinfo_t pktio_suite[];
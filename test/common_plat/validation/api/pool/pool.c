@@ -12,6 +12,9 @@ static int pool_name_number = 1;
 static const int default_buffer_size = 1500;
 static const int default_buffer_num = 1000;
 
+/** Buffers in the pool of the statistics test */
+#define STATS_BUF_NUM 100
+
 static void pool_create_destroy(odp_pool_param_t *params)
 {
 	odp_pool_t pool;
@@ -97,6 +100,72 @@ void pool_test_lookup_info_print(void)
 	odp_pool_print(pool);
 
 	CU_ASSERT(odp_pool_destroy(pool) == 0);
+	CU_ASSERT(odp_pool_info(pool, &info) < 0);
+	CU_ASSERT(odp_pool_info(ODP_POOL_INVALID, &info) < 0);
+}
+
+int pool_check_stats(void)
+{
+	odp_pool_capability_t capa;
+
+	if (odp_pool_capability(&capa) || !capa.stats.bit.available ||
+	    !capa.stats.bit.alloc_fails)
+		return ODP_TEST_INACTIVE;
+
+	return ODP_TEST_ACTIVE;
+}
+
+void pool_test_stats(void)
+{
+	odp_buffer_t buf[STATS_BUF_NUM];
+	odp_pool_stats_t stats;
+	odp_pool_param_t params;
+	odp_pool_t pool;
+	int i, num;
+
+	odp_pool_param_init(&params);
+	params.type = ODP_POOL_BUFFER;
+	params.buf.size = default_buffer_size;
+	params.buf.num = STATS_BUF_NUM;
+	params.stats.bit.available = 1;
+	params.stats.bit.alloc_fails = 1;
+
+	pool = odp_pool_create("pool_for_stats_test", &params);
+	CU_ASSERT_FATAL(pool != ODP_POOL_INVALID);
+
+	CU_ASSERT(odp_pool_stats_reset(pool) == 0);
+	CU_ASSERT_FATAL(odp_pool_stats(pool, &stats) == 0);
+	CU_ASSERT(stats.available <= STATS_BUF_NUM);
+	CU_ASSERT(stats.alloc_fails == 0);
+	CU_ASSERT(stats.recycle_hits == 0);
+	CU_ASSERT(stats.recycle_misses == 0);
+
+	for (num = 0; num < STATS_BUF_NUM; num++) {
+		buf[num] = odp_buffer_alloc(pool);
+		if (buf[num] == ODP_BUFFER_INVALID)
+			break;
+	}
+	CU_ASSERT(num > 0);
+
+	/* Allocations fail when the pool is empty */
+	if (num == STATS_BUF_NUM)
+		CU_ASSERT(odp_buffer_alloc(pool) == ODP_BUFFER_INVALID);
+
+	CU_ASSERT_FATAL(odp_pool_stats(pool, &stats) == 0);
+	CU_ASSERT(stats.available <= (uint64_t)(STATS_BUF_NUM - num));
+	CU_ASSERT(stats.alloc_fails > 0);
+
+	for (i = 0; i < num; i++)
+		odp_buffer_free(buf[i]);
+
+	CU_ASSERT(odp_pool_stats_reset(pool) == 0);
+	CU_ASSERT_FATAL(odp_pool_stats(pool, &stats) == 0);
+	CU_ASSERT(stats.alloc_fails == 0);
+
+	CU_ASSERT(odp_pool_destroy(pool) == 0);
+	CU_ASSERT(odp_pool_stats(pool, &stats) < 0);
+	CU_ASSERT(odp_pool_stats(ODP_POOL_INVALID, &stats) < 0);
+	CU_ASSERT(odp_pool_stats_reset(ODP_POOL_INVALID) < 0);
 }
 
 odp_testinfo_t pool_suite[] = {
@@ -104,6 +173,7 @@ odp_testinfo_t pool_suite[] = {
 	ODP_TEST_INFO(pool_test_create_destroy_packet),
 	ODP_TEST_INFO(pool_test_create_destroy_timeout),
 	ODP_TEST_INFO(pool_test_lookup_info_print),
+	ODP_TEST_INFO_CONDITIONAL(pool_test_stats, pool_check_stats),
 	ODP_TEST_INFO_NULL,
 };
 
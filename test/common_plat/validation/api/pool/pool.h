@@ -15,6 +15,10 @@ void pool_test_create_destroy_packet(void);
 void pool_test_create_destroy_timeout(void);
 void pool_test_create_destroy_buffer_shm(void);
 void pool_test_lookup_info_print(void);
+void pool_test_stats(void);
+
+/* check functions: */
+int pool_check_stats(void);
 
 /* test arrays: */
 extern odp_testinfo_t pool_suite[];
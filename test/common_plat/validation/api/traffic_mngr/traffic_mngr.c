@@ -68,6 +68,7 @@
 #define MAX_DROP_PROB            8
 
 #define MAX_PKTS                 1000
+#define ENQ_BURST                8
 #define PKT_BUF_SIZE             1460
 #define MAX_PAYLOAD              1400
 #define USE_IPV4                 false
@@ -3261,6 +3262,132 @@ static int test_query_functions(const char *shaper_name,
 	return 0;
 }
 
+static int test_enq_multi(const char *threshold_name,
+			  const char *wred_name,
+			  const char *shaper_name,
+			  const char *node_name,
+			  uint8_t     priority,
+			  uint32_t    max_pkts)
+{
+	odp_tm_threshold_params_t threshold_params;
+	odp_tm_query_info_t       query_info;
+	xmt_pkt_desc_t           *xmt_pkt_desc;
+	odp_tm_queue_t            tm_queue;
+	odp_packet_t              odp_pkt;
+	pkt_info_t                pkt_info;
+	uint32_t                  num_pkts, pkt_len, idx, burst, i;
+	uint32_t                  pkts_enqueued, pkts_dropped;
+	int                       rc;
+
+	num_pkts = 4 * max_pkts;
+	pkt_len  = 256;
+
+	/* Pick a tm_queue and limit it with a pkt threshold and, when
+	 * supported, a WRED profile that drops some pkts before the queue is
+	 * full. */
+	tm_queue = find_tm_queue(0, node_name, priority);
+	odp_tm_threshold_params_init(&threshold_params);
+	threshold_params.max_pkts        = max_pkts;
+	threshold_params.enable_max_pkts = true;
+	if (set_queue_thresholds(tm_queue, threshold_name,
+				 &threshold_params) != 0) {
+		LOG_ERR("set_queue_thresholds failed\n");
+		return -1;
+	}
+
+	if (tm_capabilities.tm_queue_wred_supported &&
+	    set_queue_wred(tm_queue, wred_name, PKT_GREEN, TM_PERCENT(30),
+			   false, false) != 0) {
+		LOG_ERR("set_queue_wred failed\n");
+		return -1;
+	}
+
+	/* Enable the shaper to be very low bandwidth, so that the pkts stay
+	 * in the queue while the bursts are enqueued. */
+	set_shaper(node_name, shaper_name, 64 * 1000, 8 * pkt_len);
+
+	init_xmt_pkts(&pkt_info);
+	pkt_info.drop_eligible = true;
+	pkt_info.pkt_class     = 1;
+	if (make_pkts(num_pkts, pkt_len, &pkt_info) != 0) {
+		LOG_ERR("make_pkts failed\n");
+		return -1;
+	}
+
+	/* Enqueue the pkts in bursts. A burst is enqueued up to the first pkt
+	 * that is dropped, which together with the rest of the burst is still
+	 * owned by the caller. The rest is offered again in the next burst,
+	 * the dropped pkt is freed. */
+	pkts_enqueued = 0;
+	pkts_dropped  = 0;
+	idx = 0;
+	while (idx < num_pkts) {
+		burst = MIN(ENQ_BURST, num_pkts - idx);
+		rc = odp_tm_enq_multi(tm_queue, &xmt_pkts[idx], burst);
+		CU_ASSERT(rc != 0);
+		CU_ASSERT(rc <= (int)burst);
+
+		if (rc > 0) {
+			for (i = 0; i < (uint32_t)rc; i++) {
+				xmt_pkt_desc = &xmt_pkt_descs[idx + i];
+				xmt_pkt_desc->xmt_idx  = idx + i;
+				xmt_pkt_desc->xmt_time = odp_time_local();
+				xmt_pkt_desc->tm_queue = tm_queue;
+			}
+
+			for (i = rc; i < burst; i++) {
+				odp_pkt = xmt_pkts[idx + i];
+				CU_ASSERT(odp_packet_is_valid(odp_pkt));
+				CU_ASSERT(odp_packet_len(odp_pkt) == pkt_len);
+			}
+
+			idx           += rc;
+			pkts_enqueued += rc;
+			continue;
+		}
+
+		odp_pkt = xmt_pkts[idx];
+		CU_ASSERT(odp_packet_is_valid(odp_pkt));
+		CU_ASSERT(odp_packet_len(odp_pkt) == pkt_len);
+		odp_packet_free(odp_pkt);
+		xmt_pkts[idx] = ODP_PACKET_INVALID;
+		xmt_pkt_descs[idx].xmt_idx = idx;
+		idx++;
+		pkts_dropped++;
+	}
+
+	num_pkts_sent = num_pkts;
+	CU_ASSERT(pkts_enqueued + pkts_dropped == num_pkts);
+	CU_ASSERT(pkts_enqueued != 0);
+	CU_ASSERT(pkts_dropped != 0);
+
+	/* The queue holds the enqueued pkts that the shaper has not yet let
+	 * out, never more than its threshold. */
+	rc = odp_tm_queue_query(tm_queue,
+				ODP_TM_QUERY_PKT_CNT | ODP_TM_QUERY_BYTE_CNT |
+				ODP_TM_QUERY_THRESHOLDS, &query_info);
+	CU_ASSERT(rc == 0);
+	CU_ASSERT(query_info.total_pkt_cnt_valid);
+	CU_ASSERT(query_info.total_pkt_cnt != 0);
+	CU_ASSERT(query_info.total_pkt_cnt <= pkts_enqueued);
+	CU_ASSERT(query_info.total_pkt_cnt <= max_pkts);
+	CU_ASSERT(query_info.total_byte_cnt_valid);
+	CU_ASSERT(query_info.total_byte_cnt % pkt_len == 0);
+	CU_ASSERT(query_info.total_byte_cnt <= max_pkts * pkt_len);
+	CU_ASSERT(query_info.max_pkt_cnt_valid);
+	CU_ASSERT(query_info.max_pkt_cnt == max_pkts);
+
+	/* Disable the shaper, so as to get the pkts out quicker. */
+	set_shaper(node_name, shaper_name, 0, 0);
+	num_rcv_pkts = receive_pkts(odp_tm_systems[0], rcv_pktin,
+				    pkts_enqueued, 64 * 1000);
+	CU_ASSERT(num_rcv_pkts == pkts_enqueued);
+
+	flush_leftover_pkts(odp_tm_systems[0], rcv_pktin);
+	CU_ASSERT(odp_tm_is_idle(odp_tm_systems[0]));
+	return 0;
+}
+
 static int check_vlan_marking_pkts(void)
 {
 	odp_packet_t rcv_pkt;
@@ -3906,6 +4033,12 @@ void traffic_mngr_test_query(void)
 		  == 0);
 }
 
+void traffic_mngr_test_enq_multi(void)
+{
+	CU_ASSERT(test_enq_multi("burst_thresh", "burst_wred", "burst_shaper",
+				 "node_1_3_4", 0, 16) == 0);
+}
+
 void traffic_mngr_test_marking(void)
 {
 	odp_packet_color_t color;
@@ -3982,6 +4115,7 @@ odp_testinfo_t traffic_mngr_suite[] = {
 	ODP_TEST_INFO(traffic_mngr_test_byte_wred),
 	ODP_TEST_INFO(traffic_mngr_test_pkt_wred),
 	ODP_TEST_INFO(traffic_mngr_test_query),
+	ODP_TEST_INFO(traffic_mngr_test_enq_multi),
 	ODP_TEST_INFO(traffic_mngr_test_marking),
 	ODP_TEST_INFO(traffic_mngr_test_fanin_info),
 	ODP_TEST_INFO(traffic_mngr_test_destroy),
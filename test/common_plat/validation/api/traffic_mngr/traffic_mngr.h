@@ -25,6 +25,7 @@ void traffic_mngr_test_thresholds(void);
 void traffic_mngr_test_byte_wred(void);
 void traffic_mngr_test_pkt_wred(void);
 void traffic_mngr_test_query(void);
+void traffic_mngr_test_enq_multi(void);
 void traffic_mngr_test_marking(void);
 void traffic_mngr_test_fanin_info(void);
 void traffic_mngr_test_destroy(void);
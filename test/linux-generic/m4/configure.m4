@@ -5,5 +5,6 @@ AC_CONFIG_FILES([test/linux-generic/Makefile
 		 test/linux-generic/validation/api/pktio/Makefile
 		 test/linux-generic/mmap_vlan_ins/Makefile
 		 test/linux-generic/pktio_ipc/Makefile
+		 test/linux-generic/pktio_memif/Makefile
 		 test/linux-generic/ring/Makefile
 		 test/linux-generic/performance/Makefile])
@@ -0,0 +1,49 @@
+#!/bin/sh
+#
+# Copyright (c) 2017, Linaro Limited
+# All rights reserved.
+#
+# SPDX-License-Identifier:	BSD-3-Clause
+#
+# Script that runs odp_pktio_perf over AF_XDP sockets on a veth pair when
+# launched by 'make check'. Any arguments are passed to odp_pktio_perf.
+
+TEST_DIR="${TEST_DIR:-$(dirname $0)}"
+PERFORMANCE="$TEST_DIR/../../common_plat/performance"
+
+# exit code expected by automake for skipped tests
+TEST_SKIPPED=77
+
+IF0=pktioxdpperf0
+IF1=pktioxdpperf1
+
+xdp_cleanup()
+{
+	ret=$?
+
+	ip link del $IF0 2> /dev/null
+
+	trap - EXIT
+	exit $ret
+}
+
+if [ "$(id -u)" != "0" ]; then
+	echo "odp_pktio_perf: need to be root to setup AF_XDP interfaces."
+	exit $TEST_SKIPPED
+fi
+
+trap xdp_cleanup EXIT
+
+ip link add $IF0 type veth peer name $IF1
+if [ $? -ne 0 ]; then
+	echo "odp_pktio_perf: unable to create veth pair"
+	exit $TEST_SKIPPED
+fi
+
+for iface in $IF0 $IF1; do
+	sysctl -w net.ipv6.conf.${iface}.disable_ipv6=1 > /dev/null
+	ip link set dev $iface up
+done
+
+ODP_WAIT_FOR_NETWORK=yes $PERFORMANCE/odp_pktio_perf${EXEEXT} \
+	-i xdp:$IF0:mode=skb,xdp:$IF1:mode=skb -c 2 -t 1 -d 1 -r 100000 $*
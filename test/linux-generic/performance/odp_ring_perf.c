@@ -0,0 +1,304 @@
+/* Copyright (c) 2017, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:	BSD-3-Clause
+ */
+
+/**
+ * @file
+ *
+ * @example odp_ring_perf.c  Internal ring throughput of one producer and
+ *			     one consumer per sync mode and burst size
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif /* _GNU_SOURCE */
+
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+#include <stdio.h>
+#include <inttypes.h>
+
+#include <odp_api.h>
+#include <odp/helper/linux.h>
+#include <odp_packet_io_ring_internal.h>
+
+/** Number of elements in an array */
+#define ARRAY_SIZE(x) (sizeof(x) / sizeof((x)[0]))
+
+#define app_err(fmt, ...) \
+	fprintf(stderr, "%s:%d:%s(): Error: " fmt, __FILE__, \
+		__LINE__, __func__, ##__VA_ARGS__)
+
+/** Ring size */
+#define RING_SIZE 4096
+
+/** Largest measured burst */
+#define MAX_BURST 128
+
+/** Parsed command line arguments */
+typedef struct {
+	/** Objects the producer moves through the ring per measurement */
+	uint64_t num_obj;
+} ring_args_t;
+
+/** Shared data of the producer and consumer */
+typedef struct {
+	/** Producer and consumer start together */
+	odp_barrier_t barrier;
+	/** Name of the measured ring */
+	char ring_name[32];
+	/** Burst size */
+	unsigned burst;
+	/** Objects to move */
+	uint64_t num_obj;
+	/** Run time of the producer [0] and the consumer [1] */
+	uint64_t ns[2];
+	/** Producer is taken */
+	odp_atomic_u32_t producer;
+} perf_globals_t;
+
+static const struct {
+	const char *name;
+	const char *mode;
+	unsigned flags;
+} ring_tbl[] = {
+	{"ring_perf_mpmc", "mp/mc", 0},
+	{"ring_perf_spsc", "sp/sc", _RING_F_SP_ENQ | _RING_F_SC_DEQ},
+	{"ring_perf_hts", "hts", _RING_F_MP_HTS_ENQ | _RING_F_MC_HTS_DEQ},
+};
+
+static const unsigned burst_tbl[] = {1, 8, 32, MAX_BURST};
+
+static void parse_args(int argc, char *argv[], ring_args_t *args);
+static void usage(char *progname);
+
+static perf_globals_t *perf_globals(void)
+{
+	return odp_shm_addr(odp_shm_lookup("ring_perf_globals"));
+}
+
+/* Moves num_obj objects in burst sized pieces */
+static int run_perf(void *arg ODP_UNUSED)
+{
+	perf_globals_t *globals = perf_globals();
+	void *obj[MAX_BURST];
+	unsigned burst = globals->burst;
+	uint64_t num = 0;
+	odp_time_t t1, t2;
+	int producer;
+	_ring_t *r;
+	unsigned i;
+
+	producer = odp_atomic_fetch_inc_u32(&globals->producer) == 0;
+
+	r = _ring_lookup(globals->ring_name);
+	if (r == NULL) {
+		app_err("ring lookup %s failed\n", globals->ring_name);
+		return -1;
+	}
+
+	for (i = 0; i < burst; i++)
+		obj[i] = (void *)(uintptr_t)i;
+
+	odp_barrier_wait(&globals->barrier);
+
+	t1 = odp_time_local();
+
+	while (num < globals->num_obj) {
+		if (producer)
+			num += _ring_enqueue_burst(r, obj, burst) &
+			       _RING_SZ_MASK;
+		else
+			num += _ring_dequeue_burst(r, obj, burst);
+	}
+
+	t2 = odp_time_local();
+	globals->ns[producer ? 0 : 1] = odp_time_to_ns(odp_time_diff(t2, t1));
+
+	return 0;
+}
+
+static void run_ring(odp_instance_t instance, perf_globals_t *globals,
+		     unsigned idx, unsigned burst)
+{
+	odph_odpthread_t thread_tbl[2];
+	odph_odpthread_params_t thr_params;
+	odp_cpumask_t cpumask;
+	uint64_t ns;
+
+	odp_cpumask_default_worker(&cpumask, 2);
+
+	strcpy(globals->ring_name, ring_tbl[idx].name);
+	globals->burst = burst;
+	globals->ns[0] = 0;
+	globals->ns[1] = 0;
+	odp_atomic_init_u32(&globals->producer, 0);
+	odp_barrier_init(&globals->barrier, 2);
+
+	memset(&thr_params, 0, sizeof(thr_params));
+	thr_params.thr_type = ODP_THREAD_WORKER;
+	thr_params.instance = instance;
+	thr_params.start = run_perf;
+	thr_params.arg = NULL;
+
+	odph_odpthreads_create(thread_tbl, &cpumask, &thr_params);
+	odph_odpthreads_join(thread_tbl);
+
+	ns = globals->ns[0] > globals->ns[1] ? globals->ns[0] : globals->ns[1];
+
+	printf("  %-6s burst %3u: %8.2f Mobj/s, %6.2f ns/obj\n",
+	       ring_tbl[idx].mode, burst,
+	       ns ? (double)globals->num_obj * 1000 / ns : 0.0,
+	       (double)ns / globals->num_obj);
+}
+
+int main(int argc, char *argv[])
+{
+	ring_args_t args;
+	odp_instance_t instance;
+	odp_cpumask_t cpumask;
+	perf_globals_t *globals;
+	odp_shm_t shm;
+	unsigned i, b;
+	int ret = 0;
+
+	memset(&args, 0, sizeof(args));
+
+	/* Parse and store the application arguments */
+	parse_args(argc, argv, &args);
+
+	/* Init ODP before calling anything else */
+	if (odp_init_global(&instance, NULL, NULL)) {
+		app_err("ODP global init failed.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	/* Init this thread */
+	if (odp_init_local(instance, ODP_THREAD_CONTROL)) {
+		app_err("ODP local init failed.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	_ring_tailq_init();
+
+	if (odp_cpumask_default_worker(&cpumask, 2) < 2) {
+		printf("Ring perf needs two worker CPUs, skipped\n");
+		goto term;
+	}
+
+	shm = odp_shm_reserve("ring_perf_globals", sizeof(perf_globals_t),
+			      ODP_CACHE_LINE_SIZE, 0);
+	if (shm == ODP_SHM_INVALID) {
+		app_err("shm reserve failed\n");
+		ret = -1;
+		goto term;
+	}
+
+	globals = odp_shm_addr(shm);
+	memset(globals, 0, sizeof(*globals));
+	globals->num_obj = args.num_obj;
+
+	printf("\nRing throughput, one producer and one consumer, "
+	       "%" PRIu64 " objects\n\n", args.num_obj);
+
+	for (i = 0; i < ARRAY_SIZE(ring_tbl); i++) {
+		if (_ring_create(ring_tbl[i].name, RING_SIZE,
+				 _RING_SHM_PROC | ring_tbl[i].flags) == NULL) {
+			app_err("ring create %s failed\n", ring_tbl[i].name);
+			ret = -1;
+			break;
+		}
+
+		for (b = 0; b < ARRAY_SIZE(burst_tbl); b++)
+			run_ring(instance, globals, i, burst_tbl[b]);
+
+		_ring_destroy(ring_tbl[i].name);
+	}
+	printf("\n");
+
+	if (odp_shm_free(shm)) {
+		app_err("shm free failed\n");
+		ret = -1;
+	}
+
+term:
+	if (odp_term_local()) {
+		app_err("Error: term local\n");
+		exit(EXIT_FAILURE);
+	}
+
+	if (odp_term_global(instance)) {
+		app_err("Error: term global\n");
+		exit(EXIT_FAILURE);
+	}
+
+	return ret ? EXIT_FAILURE : 0;
+}
+
+static void parse_args(int argc, char *argv[], ring_args_t *args)
+{
+	int opt;
+	int long_index;
+	static const struct option longopts[] = {
+		{"num", required_argument, NULL, 'n'},
+		{"help", no_argument, NULL, 'h'},
+		{NULL, 0, NULL, 0}
+	};
+
+	static const char *shortopts = "+n:h";
+
+	/* let helper collect its own arguments (e.g. --odph_proc) */
+	odph_parse_options(argc, argv, shortopts, longopts);
+
+	args->num_obj = 4 * 1024 * 1024;
+
+	opterr = 0; /* do not issue errors on helper options */
+
+	while (1) {
+		opt = getopt_long(argc, argv, shortopts, longopts, &long_index);
+
+		if (opt == -1)
+			break;	/* No more options */
+
+		switch (opt) {
+		case 'n':
+			args->num_obj = strtoull(optarg, NULL, 0);
+			break;
+		case 'h':
+			usage(argv[0]);
+			exit(EXIT_SUCCESS);
+			break;
+		default:
+			break;
+		}
+	}
+
+	optind = 1;		/* reset 'extern optind' from the getopt lib */
+
+	if (args->num_obj == 0) {
+		usage(argv[0]);
+		exit(EXIT_FAILURE);
+	}
+}
+
+/**
+ * Print usage information
+ */
+static void usage(char *progname)
+{
+	printf("\n"
+	       "Usage: %s OPTIONS\n"
+	       "  E.g. %s -n 1000000\n"
+	       "\n"
+	       "OpenDataPlane internal ring throughput of one producer and\n"
+	       "one consumer thread in the mp/mc, sp/sc and head/tail sync\n"
+	       "modes.\n"
+	       "Optional OPTIONS\n"
+	       "  -n, --num <number>     Objects per measurement\n"
+	       "                         (default 4194304)\n"
+	       "  -h, --help             Display help and exit.\n"
+	       "\n", progname, progname);
+}
@@ -0,0 +1,528 @@
+/* Copyright (c) 2017, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+/**
+ * @file
+ *
+ * @example pktio_memif.c  ODP memif pktio test application.
+ *		Run as a master and a slave process on the same control
+ *		socket. The master reflects all frames back to the slave. The
+ *		slave measures either throughput, by keeping a window of frames
+ *		in flight, or round trip latency, by sending one frame at a
+ *		time and waiting for it with odp_pktin_recv_tmo().
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#include <stdlib.h>
+#include <inttypes.h>
+#include <string.h>
+#include <getopt.h>
+#include <unistd.h>
+
+#include <example_debug.h>
+
+#include <odp_api.h>
+#include <odp/helper/eth.h>
+
+/** Number of packets in the pool */
+#define POOL_NUM_PKT    8192
+
+/** Maximum frame length */
+#define MAX_PKT_LEN     1518
+
+/** Maximum number of packets in a burst */
+#define MAX_PKT_BURST   64
+
+/** Maximum number of queue pairs */
+#define MAX_QUEUES      16
+
+/** Frames in flight in throughput mode */
+#define TX_WINDOW       512
+
+/** Seconds to wait for the link of the slave */
+#define LINK_WAIT_SEC   5
+
+/** Ethertype of test frames (local experimental) */
+#define TEST_ETHTYPE    0x88b5
+
+#define TEST_MAGIC      0x6d656d69
+
+/** Get rid of path in filename - only for unix-type paths using '/' */
+#define NO_PATH(file_name) (strrchr((file_name), '/') ? \
+			    strrchr((file_name), '/') + 1 : (file_name))
+
+/** Test frame payload, after the Ethernet header */
+typedef struct ODP_PACKED {
+	odp_u32be_t magic;
+	odp_u32be_t seq;
+	uint64_t ts;		/**< send time (ns), local to the slave */
+} pkt_head_t;
+
+/** Application arguments */
+static struct {
+	const char *socket;	/**< control socket path */
+	int slave;		/**< run as slave */
+	int latency;		/**< measure latency instead of throughput */
+	int run_time_sec;	/**< time to run */
+	int pkt_len;		/**< frame length */
+	int burst;		/**< burst size */
+	int num_queues;		/**< number of queue pairs */
+	int poll;		/**< poll instead of interrupts */
+} args;
+
+static odp_pktio_t create_pktio(odp_pool_t pool)
+{
+	odp_pktio_param_t pktio_param;
+	odp_pktin_queue_param_t pktin_param;
+	odp_pktout_queue_param_t pktout_param;
+	odp_pktio_t pktio;
+	char name[256];
+
+	odp_pktio_param_init(&pktio_param);
+	pktio_param.in_mode = ODP_PKTIN_MODE_DIRECT;
+	pktio_param.out_mode = ODP_PKTOUT_MODE_DIRECT;
+
+	snprintf(name, sizeof(name), "memif:role=%s:socket=%s%s",
+		 args.slave ? "slave" : "master", args.socket,
+		 args.poll ? ":irq=0" : "");
+
+	printf("pid: %d, open %s\n", getpid(), name);
+	pktio = odp_pktio_open(name, pool, &pktio_param);
+	if (pktio == ODP_PKTIO_INVALID)
+		EXAMPLE_ABORT("Error: memif pktio open failed.\n");
+
+	odp_pktin_queue_param_init(&pktin_param);
+	pktin_param.num_queues = args.num_queues;
+	pktin_param.op_mode = ODP_PKTIO_OP_MT_UNSAFE;
+	if (odp_pktin_queue_config(pktio, &pktin_param))
+		EXAMPLE_ABORT("Error: input queue config failed.\n");
+
+	odp_pktout_queue_param_init(&pktout_param);
+	pktout_param.num_queues = args.num_queues;
+	pktout_param.op_mode = ODP_PKTIO_OP_MT_UNSAFE;
+	if (odp_pktout_queue_config(pktio, &pktout_param))
+		EXAMPLE_ABORT("Error: output queue config failed.\n");
+
+	if (odp_pktio_start(pktio))
+		EXAMPLE_ABORT("Error: memif pktio start failed.\n");
+
+	return pktio;
+}
+
+static int send_or_free(odp_pktout_queue_t pktout, odp_packet_t pkt_tbl[],
+			int num)
+{
+	int sent = odp_pktout_send(pktout, pkt_tbl, num);
+
+	if (sent < 0)
+		sent = 0;
+	if (sent < num)
+		odp_packet_free_multi(&pkt_tbl[sent], num - sent);
+
+	return sent;
+}
+
+static odp_packet_t alloc_test_pkt(odp_pool_t pool, uint32_t seq)
+{
+	odp_packet_t pkt;
+	odph_ethhdr_t *eth;
+	pkt_head_t *head;
+
+	pkt = odp_packet_alloc(pool, args.pkt_len);
+	if (pkt == ODP_PACKET_INVALID)
+		return pkt;
+
+	eth = odp_packet_data(pkt);
+	memset(eth, 0, ODPH_ETHHDR_LEN);
+	eth->dst.addr[0] = 0x02;
+	eth->src.addr[0] = 0x02;
+	eth->src.addr[5] = 0x01;
+	eth->type = odp_cpu_to_be_16(TEST_ETHTYPE);
+
+	head = (pkt_head_t *)(eth + 1);
+	head->magic = odp_cpu_to_be_32(TEST_MAGIC);
+	head->seq = odp_cpu_to_be_32(seq);
+	head->ts = odp_time_to_ns(odp_time_local());
+
+	return pkt;
+}
+
+/* Returns the send time of a test frame, or 0 for other frames */
+static uint64_t test_pkt_ts(odp_packet_t pkt)
+{
+	pkt_head_t head;
+
+	if (odp_packet_copy_to_mem(pkt, ODPH_ETHHDR_LEN, sizeof(head), &head))
+		return 0;
+
+	if (odp_be_to_cpu_32(head.magic) != TEST_MAGIC)
+		return 0;
+
+	return head.ts;
+}
+
+static int run_master(odp_pktio_t pktio)
+{
+	odp_pktin_queue_t pktin[MAX_QUEUES];
+	odp_pktout_queue_t pktout[MAX_QUEUES];
+	odp_packet_t pkt_tbl[MAX_PKT_BURST];
+	odp_time_t end;
+	uint64_t wait = odp_pktin_wait_time(100 * ODP_TIME_MSEC_IN_NS);
+	uint64_t pkts = 0;
+	int q = 0;
+	int num;
+
+	if (odp_pktin_queue(pktio, pktin, args.num_queues) != args.num_queues ||
+	    odp_pktout_queue(pktio, pktout, args.num_queues) !=
+	    args.num_queues)
+		EXAMPLE_ABORT("Error: no queues\n");
+
+	end = odp_time_sum(odp_time_local(),
+			   odp_time_local_from_ns(args.run_time_sec *
+						  ODP_TIME_SEC_IN_NS));
+
+	while (odp_time_cmp(end, odp_time_local()) > 0) {
+		num = odp_pktin_recv_tmo(pktin[q], pkt_tbl, MAX_PKT_BURST,
+					 args.num_queues > 1 ?
+					 ODP_PKTIN_NO_WAIT : wait);
+		if (num > 0)
+			pkts += send_or_free(pktout[q], pkt_tbl, num);
+
+		if (++q == args.num_queues)
+			q = 0;
+	}
+
+	printf("master: reflected %" PRIu64 " packets\n", pkts);
+
+	return 0;
+}
+
+static int wait_link(odp_pktio_t pktio)
+{
+	odp_time_t end;
+
+	end = odp_time_sum(odp_time_local(),
+			   odp_time_local_from_ns(LINK_WAIT_SEC *
+						  ODP_TIME_SEC_IN_NS));
+
+	while (odp_pktio_link_status(pktio) != 1) {
+		if (odp_time_cmp(end, odp_time_local()) < 0)
+			return -1;
+		odp_time_wait_ns(ODP_TIME_MSEC_IN_NS);
+	}
+
+	return 0;
+}
+
+static int run_throughput(odp_pktio_t pktio, odp_pool_t pool)
+{
+	odp_pktin_queue_t pktin[MAX_QUEUES];
+	odp_pktout_queue_t pktout[MAX_QUEUES];
+	odp_packet_t pkt_tbl[MAX_PKT_BURST];
+	odp_time_t start, end;
+	uint64_t tx_pkts = 0, rx_pkts = 0, bad = 0;
+	uint64_t ns;
+	uint32_t seq = 0;
+	int q = 0;
+	int num, i;
+
+	if (odp_pktin_queue(pktio, pktin, args.num_queues) != args.num_queues ||
+	    odp_pktout_queue(pktio, pktout, args.num_queues) !=
+	    args.num_queues)
+		EXAMPLE_ABORT("Error: no queues\n");
+
+	start = odp_time_local();
+	end = odp_time_sum(start,
+			   odp_time_local_from_ns(args.run_time_sec *
+						  ODP_TIME_SEC_IN_NS));
+
+	while (odp_time_cmp(end, odp_time_local()) > 0) {
+		num = 0;
+		while (num < args.burst &&
+		       tx_pkts - rx_pkts + num < TX_WINDOW) {
+			pkt_tbl[num] = alloc_test_pkt(pool, seq + num);
+			if (pkt_tbl[num] == ODP_PACKET_INVALID)
+				break;
+			num++;
+		}
+
+		if (num) {
+			num = send_or_free(pktout[q], pkt_tbl, num);
+			tx_pkts += num;
+			seq += num;
+		}
+
+		num = odp_pktin_recv(pktin[q], pkt_tbl, MAX_PKT_BURST);
+		for (i = 0; i < num; i++)
+			if (!test_pkt_ts(pkt_tbl[i]))
+				bad++;
+		if (num > 0) {
+			odp_packet_free_multi(pkt_tbl, num);
+			rx_pkts += num;
+		}
+
+		if (++q == args.num_queues)
+			q = 0;
+	}
+
+	/* Collect frames in flight */
+	end = odp_time_sum(odp_time_local(),
+			   odp_time_local_from_ns(100 * ODP_TIME_MSEC_IN_NS));
+	while (rx_pkts < tx_pkts && odp_time_cmp(end, odp_time_local()) > 0) {
+		for (q = 0; q < args.num_queues; q++) {
+			num = odp_pktin_recv(pktin[q], pkt_tbl, MAX_PKT_BURST);
+			if (num > 0) {
+				odp_packet_free_multi(pkt_tbl, num);
+				rx_pkts += num;
+			}
+		}
+	}
+
+	ns = odp_time_to_ns(odp_time_diff(odp_time_local(), start));
+
+	printf("slave: %d byte frames, %d queue(s), burst %d\n"
+	       "  sent     %" PRIu64 " packets\n"
+	       "  received %" PRIu64 " packets (%" PRIu64 " bad)\n"
+	       "  rate     %.3f Mpps, %.3f Gbps\n",
+	       args.pkt_len, args.num_queues, args.burst, tx_pkts, rx_pkts,
+	       bad, (double)rx_pkts * 1000 / ns,
+	       (double)rx_pkts * args.pkt_len * 8 / ns);
+
+	return rx_pkts && !bad ? 0 : -1;
+}
+
+static int run_latency(odp_pktio_t pktio, odp_pool_t pool)
+{
+	odp_pktin_queue_t pktin;
+	odp_pktout_queue_t pktout;
+	odp_packet_t pkt;
+	odp_time_t end;
+	uint64_t wait = odp_pktin_wait_time(ODP_TIME_SEC_IN_NS);
+	uint64_t min = UINT64_MAX, max = 0, sum = 0, lost = 0, count = 0;
+	uint64_t ts, rtt;
+	uint32_t seq = 0;
+	int num;
+
+	if (odp_pktin_queue(pktio, &pktin, 1) != 1 ||
+	    odp_pktout_queue(pktio, &pktout, 1) != 1)
+		EXAMPLE_ABORT("Error: no queues\n");
+
+	end = odp_time_sum(odp_time_local(),
+			   odp_time_local_from_ns(args.run_time_sec *
+						  ODP_TIME_SEC_IN_NS));
+
+	while (odp_time_cmp(end, odp_time_local()) > 0) {
+		pkt = alloc_test_pkt(pool, seq++);
+		if (pkt == ODP_PACKET_INVALID)
+			EXAMPLE_ABORT("Error: packet alloc failed\n");
+
+		if (send_or_free(pktout, &pkt, 1) != 1) {
+			lost++;
+			continue;
+		}
+
+		num = odp_pktin_recv_tmo(pktin, &pkt, 1, wait);
+		if (num != 1) {
+			lost++;
+			continue;
+		}
+
+		ts = test_pkt_ts(pkt);
+		odp_packet_free(pkt);
+		if (!ts) {
+			lost++;
+			continue;
+		}
+
+		rtt = odp_time_to_ns(odp_time_local()) - ts;
+		if (rtt < min)
+			min = rtt;
+		if (rtt > max)
+			max = rtt;
+		sum += rtt;
+		count++;
+	}
+
+	if (!count) {
+		printf("slave: no frames returned\n");
+		return -1;
+	}
+
+	printf("slave: round trip of %d byte frames (%s)\n"
+	       "  frames   %" PRIu64 " (%" PRIu64 " lost)\n"
+	       "  min      %" PRIu64 " ns\n"
+	       "  avg      %" PRIu64 " ns\n"
+	       "  max      %" PRIu64 " ns\n",
+	       args.pkt_len, args.poll ? "poll" : "interrupt", count, lost,
+	       min, sum / count, max);
+
+	return 0;
+}
+
+static void usage(char *progname)
+{
+	printf("\n"
+	       "Usage: %s OPTIONS\n"
+	       "  E.g. %s -s /tmp/memif.sock -t 10 (master)\n"
+	       "       %s -s /tmp/memif.sock -S -t 5 (slave)\n"
+	       "\n"
+	       "OpenDataPlane memif pktio test application. The master\n"
+	       "reflects frames, the slave measures the round trip.\n"
+	       "\n"
+	       "Mandatory OPTIONS:\n"
+	       "  -s, --socket     Control socket path.\n"
+	       "Optional OPTIONS\n"
+	       "  -S, --slave      Run as slave (default master).\n"
+	       "  -L, --latency    Slave measures latency (default throughput).\n"
+	       "  -t, --time       Time to run in seconds (default 5).\n"
+	       "  -l, --len        Frame length (default 64).\n"
+	       "  -b, --burst      Burst size (default 32).\n"
+	       "  -q, --queues     Number of queue pairs (default 1).\n"
+	       "  -p, --poll       Poll rings instead of sleeping on interrupts.\n"
+	       "  -h, --help       Display help and exit.\n"
+	       "\n", NO_PATH(progname), NO_PATH(progname), NO_PATH(progname));
+}
+
+static void parse_args(int argc, char *argv[])
+{
+	int opt;
+	int long_index;
+	static struct option longopts[] = {
+		{"socket", required_argument, NULL, 's'},
+		{"slave", no_argument, NULL, 'S'},
+		{"latency", no_argument, NULL, 'L'},
+		{"time", required_argument, NULL, 't'},
+		{"len", required_argument, NULL, 'l'},
+		{"burst", required_argument, NULL, 'b'},
+		{"queues", required_argument, NULL, 'q'},
+		{"poll", no_argument, NULL, 'p'},
+		{"help", no_argument, NULL, 'h'},
+		{NULL, 0, NULL, 0}
+	};
+
+	args.run_time_sec = 5;
+	args.pkt_len = 64;
+	args.burst = 32;
+	args.num_queues = 1;
+
+	while (1) {
+		opt = getopt_long(argc, argv, "+s:SLt:l:b:q:ph",
+				  longopts, &long_index);
+
+		if (opt == -1)
+			break;	/* No more options */
+
+		switch (opt) {
+		case 's':
+			args.socket = optarg;
+			break;
+		case 'S':
+			args.slave = 1;
+			break;
+		case 'L':
+			args.latency = 1;
+			break;
+		case 't':
+			args.run_time_sec = atoi(optarg);
+			break;
+		case 'l':
+			args.pkt_len = atoi(optarg);
+			break;
+		case 'b':
+			args.burst = atoi(optarg);
+			break;
+		case 'q':
+			args.num_queues = atoi(optarg);
+			break;
+		case 'p':
+			args.poll = 1;
+			break;
+		case 'h':
+			usage(argv[0]);
+			exit(EXIT_SUCCESS);
+			break;
+		default:
+			break;
+		}
+	}
+
+	if (args.socket == NULL || args.run_time_sec <= 0 ||
+	    args.pkt_len < (int)(ODPH_ETHHDR_LEN + sizeof(pkt_head_t)) ||
+	    args.pkt_len > MAX_PKT_LEN || args.burst < 1 ||
+	    args.burst > MAX_PKT_BURST || args.num_queues < 1 ||
+	    args.num_queues > MAX_QUEUES) {
+		usage(argv[0]);
+		exit(EXIT_FAILURE);
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	odp_instance_t instance;
+	odp_pool_param_t params;
+	odp_pool_t pool;
+	odp_pktio_t pktio;
+	int ret;
+
+	parse_args(argc, argv);
+
+	if (odp_init_global(&instance, NULL, NULL)) {
+		EXAMPLE_ERR("Error: ODP global init failed.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	if (odp_init_local(instance, ODP_THREAD_CONTROL)) {
+		EXAMPLE_ERR("Error: ODP local init failed.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	odp_pool_param_init(&params);
+	params.pkt.seg_len = MAX_PKT_LEN;
+	params.pkt.len     = MAX_PKT_LEN;
+	params.pkt.num     = POOL_NUM_PKT;
+	params.type        = ODP_POOL_PACKET;
+
+	pool = odp_pool_create("memif_pool", &params);
+	if (pool == ODP_POOL_INVALID) {
+		EXAMPLE_ERR("Error: packet pool create failed.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	pktio = create_pktio(pool);
+
+	if (!args.slave) {
+		ret = run_master(pktio);
+	} else if (wait_link(pktio)) {
+		EXAMPLE_ERR("Error: no connection to master.\n");
+		ret = -1;
+	} else if (args.latency) {
+		ret = run_latency(pktio, pool);
+	} else {
+		ret = run_throughput(pktio, pool);
+	}
+
+	if (odp_pktio_stop(pktio) || odp_pktio_close(pktio)) {
+		EXAMPLE_ERR("Error: pktio close failed.\n");
+		ret = -1;
+	}
+
+	if (odp_pool_destroy(pool)) {
+		EXAMPLE_ERR("Error: pool destroy failed.\n");
+		ret = -1;
+	}
+
+	if (odp_term_local()) {
+		EXAMPLE_ERR("Error: term local failed.\n");
+		ret = -1;
+	}
+
+	if (odp_term_global(instance)) {
+		EXAMPLE_ERR("Error: term global failed.\n");
+		ret = -1;
+	}
+
+	return ret ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,58 @@
+#!/bin/sh
+#
+# Copyright (c) 2017, Linaro Limited
+# All rights reserved.
+#
+# SPDX-License-Identifier:	BSD-3-Clause
+#
+
+# directories where test binary can be found:
+# -in the validation dir when running make check (intree or out of tree)
+# -in the script directory, when running after 'make install', or
+# -in the validation when running standalone (./pktio_memif_run) intree.
+# -in the current directory.
+# running stand alone out of tree requires setting PATH
+PATH=./pktio_memif:$PATH
+PATH=$(dirname $0):$PATH
+PATH=$(dirname $0)/../../../../platform/linux-generic/test/pktio_memif:$PATH
+PATH=.:$PATH
+
+# The master reflects frames back to the slave in another process. The slave
+# measures throughput, then round trip latency with and without interrupts.
+run_stage()
+{
+	local ret=0
+	MEMIF_SOCKET=$(mktemp -u /tmp/odp_memif.XXXXXX)
+
+	echo "==== $1 ===="
+	shift
+	pktio_memif${EXEEXT} -s ${MEMIF_SOCKET} -t 30 $@ &
+	MASTER_PID=$!
+
+	pktio_memif${EXEEXT} -s ${MEMIF_SOCKET} -S -t 3 $@
+	ret=$?
+
+	kill ${MASTER_PID} > /dev/null 2>&1
+	wait ${MASTER_PID}
+	rm -f ${MEMIF_SOCKET}
+
+	if [ $ret -ne 0 ]; then
+		echo "!!! FAILED $ret !!!"
+		exit $ret
+	fi
+}
+
+run()
+{
+	run_stage "throughput, 64 byte frames" -l 64
+	run_stage "throughput, 1500 byte frames, 2 queues" -l 1500 -q 2
+	run_stage "latency, interrupt" -L
+	run_stage "latency, poll" -L -p
+
+	echo "!!!PASSED!!!"
+	exit 0
+}
+
+case "$1" in
+	*)       run ;;
+esac
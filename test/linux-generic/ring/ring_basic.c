@@ -29,14 +29,16 @@ static void __do_basic_watermark(_ring_t *r);
 static void **test_enq_data;
 static void **test_deq_data;
 
-/* create two rings: one for single thread usage scenario
- * and another for multiple thread usage scenario.
+/* create three rings: one for single thread usage scenario
+ * and two for multiple thread usage scenario.
  * st - single thread usage scenario
  * mt - multiple thread usage scenario
+ * hts - multiple thread usage scenario, head/tail sync mode
  */
 static const char *st_ring_name = "ST basic ring";
 static const char *mt_ring_name = "MT basic ring";
-static _ring_t *st_ring, *mt_ring;
+static const char *hts_ring_name = "HTS basic ring";
+static _ring_t *st_ring, *mt_ring, *hts_ring;
 
 int ring_test_basic_start(void)
 {
@@ -68,6 +70,7 @@ int ring_test_basic_end(void)
 {
 	_ring_destroy(st_ring_name);
 	_ring_destroy(mt_ring_name);
+	_ring_destroy(hts_ring_name);
 
 	free(test_enq_data);
 	free(test_deq_data);
@@ -95,27 +98,44 @@ void ring_test_basic_create(void)
 
 	CU_ASSERT(NULL != mt_ring);
 	CU_ASSERT(_ring_lookup(mt_ring_name) == mt_ring);
+
+	/* prove conflicting sync modes shall fail */
+	hts_ring = _ring_create(hts_ring_name, RING_SIZE,
+				_RING_F_SP_ENQ | _RING_F_MP_HTS_ENQ);
+	CU_ASSERT(NULL == hts_ring);
+	CU_ASSERT(EINVAL == __odp_errno);
+
+	/* create ring for head/tail sync usage scenario */
+	hts_ring = _ring_create(hts_ring_name, RING_SIZE,
+				_RING_SHM_PROC | _RING_F_MP_HTS_ENQ |
+				_RING_F_MC_HTS_DEQ);
+
+	CU_ASSERT(NULL != hts_ring);
+	CU_ASSERT(_ring_lookup(hts_ring_name) == hts_ring);
 }
 
 void ring_test_basic_burst(void)
 {
-	/* two rounds to cover both single
-	 * thread and multiple thread APIs
+	/* three rounds to cover single thread, multiple
+	 * thread and head/tail sync APIs
 	 */
 	__do_basic_burst(st_ring);
 	__do_basic_burst(mt_ring);
+	__do_basic_burst(hts_ring);
 }
 
 void ring_test_basic_bulk(void)
 {
 	__do_basic_bulk(st_ring);
 	__do_basic_bulk(mt_ring);
+	__do_basic_bulk(hts_ring);
 }
 
 void ring_test_basic_watermark(void)
 {
 	__do_basic_watermark(st_ring);
 	__do_basic_watermark(mt_ring);
+	__do_basic_watermark(hts_ring);
 }
 
 /* labor functions definition */
@@ -199,27 +219,6 @@ static void __do_basic_burst(_ring_t *r)
 	memset(test_deq_data, 0, RING_SIZE * 2 * sizeof(void *));
 }
 
-/* incomplete ring API set: strange!
- * complement _ring_enqueue/dequeue_bulk to improve coverage
- */
-static inline int __ring_enqueue_bulk(
-	_ring_t *r, void * const *objects, unsigned bulk)
-{
-	if (r->prod.sp_enqueue)
-		return _ring_sp_enqueue_bulk(r, objects, bulk);
-	else
-		return _ring_mp_enqueue_bulk(r, objects, bulk);
-}
-
-static inline int __ring_dequeue_bulk(
-	_ring_t *r, void **objects, unsigned bulk)
-{
-	if (r->cons.sc_dequeue)
-		return _ring_sc_dequeue_bulk(r, objects, bulk);
-	else
-		return _ring_mc_dequeue_bulk(r, objects, bulk);
-}
-
 static void __do_basic_bulk(_ring_t *r)
 {
 	int result = 0;
@@ -234,17 +233,17 @@ static void __do_basic_bulk(_ring_t *r)
 	CU_ASSERT(1 == _ring_empty(r));
 
 	/* enqueue 1 object */
-	result = __ring_enqueue_bulk(r, enq, 1);
+	result = _ring_enqueue_bulk(r, enq, 1);
 	enq += 1;
 	CU_ASSERT(0 == result);
 
 	/* enqueue 2 objects */
-	result = __ring_enqueue_bulk(r, enq, 2);
+	result = _ring_enqueue_bulk(r, enq, 2);
 	enq += 2;
 	CU_ASSERT(0 == result);
 
 	/* enqueue HALF_BULK objects */
-	result = __ring_enqueue_bulk(r, enq, HALF_BULK);
+	result = _ring_enqueue_bulk(r, enq, HALF_BULK);
 	enq += HALF_BULK;
 	CU_ASSERT(0 == result);
 
@@ -260,27 +259,27 @@ static void __do_basic_bulk(_ring_t *r)
 	CU_ASSERT(count == _ring_free_count(r));
 
 	/* exceed the size, enquene shall fail with -ENOBUFS */
-	result = __ring_enqueue_bulk(r, enq, HALF_BULK);
+	result = _ring_enqueue_bulk(r, enq, HALF_BULK);
 	CU_ASSERT(-ENOBUFS == result);
 
 	/* fullful the ring */
-	result = __ring_enqueue_bulk(r, enq, count);
+	result = _ring_enqueue_bulk(r, enq, count);
 	enq += count;
 	CU_ASSERT(0 == result);
 	CU_ASSERT(1 == _ring_full(r));
 
 	/* dequeue 1 object */
-	result = __ring_dequeue_bulk(r, deq, 1);
+	result = _ring_dequeue_bulk(r, deq, 1);
 	deq += 1;
 	CU_ASSERT(0 == result);
 
 	/* dequeue 2 objects */
-	result = __ring_dequeue_bulk(r, deq, 2);
+	result = _ring_dequeue_bulk(r, deq, 2);
 	deq += 2;
 	CU_ASSERT(0 == result);
 
 	/* dequeue HALF_BULK objects */
-	result = __ring_dequeue_bulk(r, deq, HALF_BULK);
+	result = _ring_dequeue_bulk(r, deq, HALF_BULK);
 	deq += HALF_BULK;
 	CU_ASSERT(0 == result);
 
@@ -292,11 +291,11 @@ static void __do_basic_bulk(_ring_t *r)
 	CU_ASSERT(count == _ring_count(r));
 
 	/* underrun the size, dequeue shall fail with -ENOENT */
-	result = __ring_dequeue_bulk(r, deq, HALF_BULK);
+	result = _ring_dequeue_bulk(r, deq, HALF_BULK);
 	CU_ASSERT(-ENOENT == result);
 
 	/* empty the queue */
-	result = __ring_dequeue_bulk(r, deq, count);
+	result = _ring_dequeue_bulk(r, deq, count);
 	deq += count;
 	CU_ASSERT(0 == result);
 	CU_ASSERT(1 == _ring_empty(r));
@@ -330,22 +329,22 @@ void __do_basic_watermark(_ring_t *r)
 	CU_ASSERT(0 == result);
 
 	/* 1st enqueue shall succeed */
-	result = __ring_enqueue_bulk(r, enq, bulk);
+	result = _ring_enqueue_bulk(r, enq, bulk);
 	enq += bulk;
 	CU_ASSERT(0 == result);
 
 	/* 2nd enqueue shall succeed but return -EDQUOT */
-	result = __ring_enqueue_bulk(r, enq, bulk);
+	result = _ring_enqueue_bulk(r, enq, bulk);
 	enq += bulk;
 	CU_ASSERT(-EDQUOT == result);
 
 	/* dequeue 1st bulk */
-	result = __ring_dequeue_bulk(r, deq, bulk);
+	result = _ring_dequeue_bulk(r, deq, bulk);
 	deq += bulk;
 	CU_ASSERT(0 == result);
 
 	/* dequeue 2nd bulk */
-	result = __ring_dequeue_bulk(r, deq, bulk);
+	result = _ring_dequeue_bulk(r, deq, bulk);
 	deq += bulk;
 	CU_ASSERT(0 == result);
 
@@ -47,14 +47,18 @@ typedef enum {
 	STRESS_1_1_PRODUCER_CONSUMER,
 	STRESS_1_N_PRODUCER_CONSUMER,
 	STRESS_N_1_PRODUCER_CONSUMER,
-	STRESS_N_M_PRODUCER_CONSUMER
+	STRESS_N_M_PRODUCER_CONSUMER,
+	STRESS_1_1_SPSC_PRODUCER_CONSUMER,
+	STRESS_N_M_HTS_PRODUCER_CONSUMER
 } stress_case_t;
 
 /* worker function declarations */
 static int stress_worker(void *_data);
 
-/* global name for later look up in workers' context */
+/* global names for later look up in workers' context */
 static const char *ring_name = "stress_ring";
+static const char *spsc_ring_name = "stress_ring_spsc";
+static const char *hts_ring_name = "stress_ring_hts";
 
 /* barrier to run threads at the same time */
 static odp_barrier_t barrier;
@@ -70,12 +74,32 @@ int ring_test_stress_start(void)
 		return -1;
 	}
 
+	/* single producer, single consumer scenario */
+	r_stress = _ring_create(spsc_ring_name, RING_SIZE,
+				_RING_SHM_PROC | _RING_F_SP_ENQ |
+				_RING_F_SC_DEQ);
+	if (r_stress == NULL) {
+		LOG_ERR("create spsc ring failed for stress.\n");
+		return -1;
+	}
+
+	/* head/tail sync scenario */
+	r_stress = _ring_create(hts_ring_name, RING_SIZE,
+				_RING_SHM_PROC | _RING_F_MP_HTS_ENQ |
+				_RING_F_MC_HTS_DEQ);
+	if (r_stress == NULL) {
+		LOG_ERR("create hts ring failed for stress.\n");
+		return -1;
+	}
+
 	return 0;
 }
 
 int ring_test_stress_end(void)
 {
 	_ring_destroy(ring_name);
+	_ring_destroy(spsc_ring_name);
+	_ring_destroy(hts_ring_name);
 	return 0;
 }
 
@@ -112,7 +136,40 @@ void ring_test_stress_1_1_producer_consumer(void)
 		CU_ASSERT(0 == worker_results[i]);
 }
 
-void ring_test_stress_N_M_producer_consumer(void)
+void ring_test_stress_1_1_spsc_producer_consumer(void)
+{
+	int i = 0;
+	odp_cpumask_t cpus;
+	pthrd_arg worker_param;
+
+	/* reset results for delayed assertion */
+	memset(worker_results, 0, sizeof(worker_results));
+
+	/* request 2 threads to run 1:1 stress */
+	worker_param.numthrds = odp_cpumask_default_worker(&cpus, 2);
+	worker_param.testcase = STRESS_1_1_SPSC_PRODUCER_CONSUMER;
+
+	/* not failure, insufficient resource */
+	if (worker_param.numthrds < 2) {
+		LOG_ERR("insufficient cpu for 1:1 spsc "
+			"producer/consumer stress.\n");
+		return;
+	}
+
+	odp_barrier_init(&barrier, 2);
+
+	/* kick the workers */
+	odp_cunit_thread_create(stress_worker, &worker_param);
+
+	/* collect the results */
+	odp_cunit_thread_exit(&worker_param);
+
+	/* delayed assertion due to cunit limitation */
+	for (i = 0; i < worker_param.numthrds; i++)
+		CU_ASSERT(0 == worker_results[i]);
+}
+
+static void stress_n_m(stress_case_t testcase)
 {
 	int i = 0;
 	odp_cpumask_t cpus;
@@ -124,7 +181,7 @@ void ring_test_stress_N_M_producer_consumer(void)
 	/* request MAX_WORKERS threads to run N:M stress */
 	worker_param.numthrds =
 		odp_cpumask_default_worker(&cpus, MAX_WORKERS);
-	worker_param.testcase = STRESS_N_M_PRODUCER_CONSUMER;
+	worker_param.testcase = testcase;
 
 	/* not failure, insufficient resource */
 	if (worker_param.numthrds < 3) {
@@ -150,6 +207,16 @@ void ring_test_stress_N_M_producer_consumer(void)
 		CU_ASSERT(0 == worker_results[i]);
 }
 
+void ring_test_stress_N_M_producer_consumer(void)
+{
+	stress_n_m(STRESS_N_M_PRODUCER_CONSUMER);
+}
+
+void ring_test_stress_N_M_hts_producer_consumer(void)
+{
+	stress_n_m(STRESS_N_M_HTS_PRODUCER_CONSUMER);
+}
+
 void ring_test_stress_1_N_producer_consumer(void)
 {
 }
@@ -176,7 +243,7 @@ static int do_producer(_ring_t *r)
 		enq[i] = (void *)(uintptr_t)i;
 
 	while (num)
-		if (_ring_mp_enqueue_bulk(r, enq, PIECE_BULK) == 0)
+		if (_ring_enqueue_bulk(r, enq, PIECE_BULK) == 0)
 			num--;
 
 	return 0;
@@ -190,7 +257,7 @@ static int do_consumer(_ring_t *r)
 	int num = NUM_BULK_OP;
 
 	while (num) {
-		if (_ring_mc_dequeue_bulk(r, deq, PIECE_BULK) == 0) {
+		if (_ring_dequeue_bulk(r, deq, PIECE_BULK) == 0) {
 			num--;
 
 			/* evaluate the data pattern */
@@ -202,20 +269,78 @@ static int do_consumer(_ring_t *r)
 	return 0;
 }
 
+/* worker function for the single producer, enqueues a running sequence
+ * number in bursts of varying size */
+static int do_seq_producer(_ring_t *r)
+{
+	void *enq[PIECE_BULK];
+	uintptr_t seq = 0;
+	unsigned n = 1;
+	unsigned i;
+	int ret;
+
+	while (seq < (uintptr_t)NUM_BULK_OP * PIECE_BULK) {
+		for (i = 0; i < n; i++)
+			enq[i] = (void *)(seq + i);
+
+		ret = _ring_enqueue_burst(r, enq, n) & _RING_SZ_MASK;
+		seq += ret;
+		n = (n % PIECE_BULK) + 1;
+	}
+
+	return 0;
+}
+
+/* worker function for the single consumer, checks that the sequence
+ * comes out in order */
+static int do_seq_consumer(_ring_t *r)
+{
+	void *deq[PIECE_BULK];
+	uintptr_t seq = 0;
+	int i, ret;
+
+	while (seq < (uintptr_t)NUM_BULK_OP * PIECE_BULK) {
+		ret = _ring_dequeue_burst(r, deq, PIECE_BULK);
+
+		for (i = 0; i < ret; i++, seq++) {
+			if (deq[i] != (void *)seq) {
+				LOG_ERR("out of sequence %p, expected %p\n",
+					deq[i], (void *)seq);
+				return -1;
+			}
+		}
+	}
+
+	return 0;
+}
+
 static int stress_worker(void *_data)
 {
 	pthrd_arg *worker_param = (pthrd_arg *)_data;
 	_ring_t *r_stress = NULL;
+	const char *name;
 	int *result = NULL;
 	int worker_id = odp_thread_id();
 
 	/* save the worker result for delayed assertion */
 	result = &worker_results[(worker_id % worker_param->numthrds)];
 
+	switch (worker_param->testcase) {
+	case STRESS_1_1_SPSC_PRODUCER_CONSUMER:
+		name = spsc_ring_name;
+		break;
+	case STRESS_N_M_HTS_PRODUCER_CONSUMER:
+		name = hts_ring_name;
+		break;
+	default:
+		name = ring_name;
+		break;
+	}
+
 	/* verify ring lookup in worker context */
-	r_stress = _ring_lookup(ring_name);
+	r_stress = _ring_lookup(name);
 	if (NULL == r_stress) {
-		LOG_ERR("ring lookup %s not found\n", ring_name);
+		LOG_ERR("ring lookup %s not found\n", name);
 		return (*result = -1);
 	}
 
@@ -224,12 +349,19 @@ static int stress_worker(void *_data)
 	switch (worker_param->testcase) {
 	case STRESS_1_1_PRODUCER_CONSUMER:
 	case STRESS_N_M_PRODUCER_CONSUMER:
+	case STRESS_N_M_HTS_PRODUCER_CONSUMER:
 		/* interleaved producer/consumer */
 		if (0 == (worker_id % 2))
 			*result = do_producer(r_stress);
 		else if (1 == (worker_id % 2))
 			*result = do_consumer(r_stress);
 		break;
+	case STRESS_1_1_SPSC_PRODUCER_CONSUMER:
+		if (0 == (worker_id % 2))
+			*result = do_seq_producer(r_stress);
+		else
+			*result = do_seq_consumer(r_stress);
+		break;
 	case STRESS_1_N_PRODUCER_CONSUMER:
 	case STRESS_N_1_PRODUCER_CONSUMER:
 	default:
@@ -43,6 +43,8 @@ static odp_testinfo_t ring_suite_stress[] = {
 	ODP_TEST_INFO(ring_test_stress_1_N_producer_consumer),
 	ODP_TEST_INFO(ring_test_stress_N_1_producer_consumer),
 	ODP_TEST_INFO(ring_test_stress_N_M_producer_consumer),
+	ODP_TEST_INFO(ring_test_stress_1_1_spsc_producer_consumer),
+	ODP_TEST_INFO(ring_test_stress_N_M_hts_producer_consumer),
 	ODP_TEST_INFO(ring_test_stress_ring_list_dump),
 	ODP_TEST_INFO_NULL,
 };
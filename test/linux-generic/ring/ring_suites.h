@@ -29,6 +29,8 @@ void ring_test_stress_1_1_producer_consumer(void);
 void ring_test_stress_1_N_producer_consumer(void);
 void ring_test_stress_N_1_producer_consumer(void);
 void ring_test_stress_N_M_producer_consumer(void);
+void ring_test_stress_1_1_spsc_producer_consumer(void);
+void ring_test_stress_N_M_hts_producer_consumer(void);
 void ring_test_stress_ring_list_dump(void);
 
 int ring_suites_main(int argc, char *argv[]);
@@ -0,0 +1,38 @@
+#!/bin/sh
+#
+# Copyright (c) 2017, Linaro Limited
+# All rights reserved.
+#
+# SPDX-License-Identifier:	BSD-3-Clause
+#
+
+# any parameter passed as arguments to this script is passed unchanged to
+# the test itself (pktio_main)
+
+# directories where pktio_main binary can be found:
+# -in the validation dir when running make check (intree or out of tree)
+# -in the script directory, when running after 'make install', or
+# -in the validation when running standalone intree.
+# -in the current directory.
+# running stand alone out of tree requires setting PATH
+PATH=${TEST_DIR}/api/pktio:$PATH
+PATH=$(dirname $0):$PATH
+PATH=$(dirname $0)/../../../../common_plat/validation/api/pktio:$PATH
+PATH=.:$PATH
+
+pktio_main_path=$(which pktio_main${EXEEXT})
+if [ -x "$pktio_main_path" ] ; then
+	echo "running with $pktio_main_path"
+else
+	echo "cannot find pktio_main${EXEEXT}: please set you PATH for it."
+fi
+
+# Master and slave end of the same memif connection. The role goes first,
+# as pool names of the test are derived from interface names.
+MEMIF_SOCKET=$(mktemp -u /tmp/vald_memif.XXXXXX)
+export ODP_PKTIO_IF0="memif:role=master:secret=vald:socket=${MEMIF_SOCKET}"
+export ODP_PKTIO_IF1="memif:role=slave:secret=vald:socket=${MEMIF_SOCKET}"
+pktio_main${EXEEXT} $*
+ret=$?
+rm -f ${MEMIF_SOCKET}
+exit $ret
@@ -0,0 +1,92 @@
+#!/bin/sh
+#
+# Copyright (c) 2017, Linaro Limited
+# All rights reserved.
+#
+# SPDX-License-Identifier:	BSD-3-Clause
+#
+
+# any parameter passed as arguments to this script is passed unchanged to
+# the test itself (pktio_main)
+
+# directories where pktio_main binary can be found:
+# -in the validation dir when running make check (intree or out of tree)
+# -in the script directory, when running after 'make install', or
+# -in the validation when running standalone intree.
+# -in the current directory.
+# running stand alone out of tree requires setting PATH
+PATH=${TEST_DIR}/api/pktio:$PATH
+PATH=$(dirname $0):$PATH
+PATH=$(dirname $0)/../../../../common_plat/validation/api/pktio:$PATH
+PATH=.:$PATH
+
+pktio_main_path=$(which pktio_main${EXEEXT})
+if [ -x "$pktio_main_path" ] ; then
+	echo "running with $pktio_main_path"
+else
+	echo "cannot find pktio_main${EXEEXT}: please set you PATH for it."
+fi
+
+# exit code expected by automake for skipped tests
+TEST_SKIPPED=77
+
+IF0=pktioxdp0
+IF1=pktioxdp1
+
+# AF_XDP sockets on a veth pair, with the XDP program in generic mode
+export ODP_PKTIO_IF0="xdp:$IF0:mode=skb"
+export ODP_PKTIO_IF1="xdp:$IF1:mode=skb"
+
+xdp_cleanup()
+{
+	ret=$?
+
+	ip link del $IF0 2> /dev/null
+
+	trap - EXIT
+	exit $ret
+}
+
+xdp_setup()
+{
+	if [ "$(id -u)" != "0" ]; then
+		echo "pktio: need to be root to setup AF_XDP interfaces."
+		return $TEST_SKIPPED
+	fi
+
+	for iface in $IF0 $IF1; do
+		ip link show $iface 2> /dev/null
+		if [ $? -eq 0 ]; then
+			echo "pktio: interface $iface already exist $?"
+			return 2
+		fi
+	done
+
+	trap xdp_cleanup EXIT
+
+	ip link add $IF0 type veth peer name $IF1
+	if [ $? -ne 0 ]; then
+		echo "pktio: error: unable to create veth pair"
+		return 3
+	fi
+
+	for iface in $IF0 $IF1; do
+		ifconfig $iface -arp
+		sysctl -w net.ipv6.conf.${iface}.disable_ipv6=1
+		ip link set dev $iface up
+	done
+
+	return 0
+}
+
+xdp_setup
+ret=$?
+if [ $ret -ne 0 ]; then
+	echo "pktio: xdp_setup() FAILED!"
+	exit $TEST_SKIPPED
+fi
+
+ODP_WAIT_FOR_NETWORK=yes pktio_main${EXEEXT} $*
+ret=$?
+
+exit $ret